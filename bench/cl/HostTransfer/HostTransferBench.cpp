@@ -0,0 +1,198 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+//  Measures how algorithms called with host pointers move their ranges to the device, under each host transfer
+//  policy of the control.  A read only range is reduced, and an in place range is negated by transform; each starts
+//  either on a page boundary or one element past it.  Bandwidth counts the bytes of the host range that have to
+//  cross to the device and, for the in place case, back.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/transform.h"
+
+#define DATA_TYPE int
+const std::streamsize colWidth = 26;
+
+enum transferCase { t_readOnly, t_inPlace, TList };
+static const char* caseNames[ TList ] = { "read only (reduce)", "in place (transform)" };
+
+static const bolt::cl::control::e_HostTransferMode modes[ ] = { bolt::cl::control::ZeroCopyTransfer,
+    bolt::cl::control::StagedTransfer, bolt::cl::control::AutoTransfer };
+static const char* modeNames[ ] = { "zero-copy", "staged", "auto" };
+
+static const size_t pageSize = 4096;
+
+void runCase( bolt::cl::control& ctl, transferCase tCase, DATA_TYPE* first, size_t length )
+{
+    switch( tCase )
+    {
+    case t_readOnly:
+        bolt::cl::reduce( ctl, first, first + length, 0 );
+        break;
+    case t_inPlace:
+        bolt::cl::transform( ctl, first, first + length, first, bolt::cl::negate< DATA_TYPE >( ) );
+        break;
+    default:
+        break;
+    }
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    cl_uint userPlatform = 0;
+    cl_uint userDevice = 0;
+    size_t iterations = 0;
+    size_t length = 0;
+    size_t chunkSize = 0;
+    cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "OpenCL host transfer command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "gpu,g",          "Report only OpenCL GPU devices" )
+            ( "cpu,c",          "Report only OpenCL CPU devices" )
+            ( "all,a",          "Report all OpenCL devices" )
+            ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ),
+                                "Specify the platform under test" )
+            ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ),
+                                "Specify the device under test, relative to -g, -c or -a flags" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 1 << 24 ), "Specify the length of the input" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 100 ), "Number of samples in timing loop" )
+            ( "chunk,k",        po::value< size_t >( &chunkSize )->default_value( 1 << 20 ),
+                                "Bytes moved by one slot of the staging ring" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "gpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_GPU;
+        }
+
+        if( vm.count( "cpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_CPU;
+        }
+
+        if( vm.count( "all" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_ALL;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "Host Transfer Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Initialize platforms and devices                                            *
+    ******************************************************************************/
+    cl_int err = CL_SUCCESS;
+
+    std::vector< cl::Platform > platforms;
+    bolt::cl::V_OPENCL( cl::Platform::get( &platforms ), "Platform::get() failed" );
+
+    std::vector< cl::Device > devices;
+    bolt::cl::V_OPENCL( platforms.at( userPlatform ).getDevices( deviceType, &devices ), "Platform::getDevices() failed" );
+
+    cl::Context myContext( devices.at( userDevice ) );
+    cl::CommandQueue myQueue( myContext, devices.at( userDevice ) );
+    bolt::cl::control::getDefault( ).setCommandQueue( myQueue );
+
+    std::string strDeviceName = bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( &err );
+    bolt::cl::V_OPENCL( err, "Device::getInfo< CL_DEVICE_NAME > failed" );
+    std::cout << "Device under test : " << strDeviceName << std::endl;
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control ctl( bolt::cl::control::getDefault( ) );
+    ctl.setForceRunMode( bolt::cl::control::OpenCL );
+    ctl.setWaitMode( bolt::cl::control::BusyWait );
+    ctl.setStagingChunkSize( chunkSize );
+
+    //  One spare page, so that the range can start on a page boundary or one element past it
+    std::vector< DATA_TYPE > backup( length + 1 + pageSize / sizeof( DATA_TYPE ) );
+    for( size_t i = 0; i < backup.size( ); ++i )
+        backup[ i ] = rand( ) % 1000 - 500;
+    size_t skew = ( pageSize - reinterpret_cast< size_t >( &backup[ 0 ] ) % pageSize ) % pageSize;
+    DATA_TYPE* aligned = &backup[ 0 ] + skew / sizeof( DATA_TYPE );
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( TList * 2 * countOf( modes ), iterations );
+
+    for( int tCase = 0; tCase < TList; ++tCase )
+    {
+        for( int offset = 0; offset < 2; ++offset )
+        {
+            DATA_TYPE* first = aligned + offset;
+            std::cout << caseNames[ tCase ] << ( offset ? ", unaligned" : ", page aligned" ) << " [" << length
+                << " elements]" << std::endl;
+
+            for( size_t m = 0; m < countOf( modes ); ++m )
+            {
+                ctl.setHostTransfer( modes[ m ] );
+                size_t id = myTimer.getUniqueID( _T( "transfer" ),
+                    static_cast< unsigned int >( ( tCase * 2 + offset ) * countOf( modes ) + m ) );
+
+                //  The first call compiles the program; keep it out of the samples
+                runCase( ctl, static_cast< transferCase >( tCase ), first, length );
+
+                ctl.resetHostTransferStats( );
+                for( size_t i = 0; i < iterations; ++i )
+                {
+                    myTimer.Start( id );
+                    runCase( ctl, static_cast< transferCase >( tCase ), first, length );
+                    myTimer.Stop( id );
+                }
+                bolt::cl::control::hostTransferStats stats = ctl.getHostTransferStats( );
+
+                myTimer.pruneOutliers( id, 1.0 );
+                double gigaBytes = ( tCase == t_inPlace ? 2 : 1 ) * length * sizeof( DATA_TYPE ) / 1.0e9;
+
+                bolt::tout << _T( "    " ) << std::setw( 10 ) << modeNames[ m ] << _T( " (GB/s): " )
+                    << std::setw( 10 ) << gigaBytes / myTimer.getAverageTime( id )
+                    << _T( " mapped/call: " ) << std::setw( 12 ) << stats.bytesMapped / iterations
+                    << _T( " copied/call: " ) << std::setw( 12 ) << stats.bytesCopied / iterations
+                    << _T( " chunks/call: " ) << stats.stagedChunks / iterations << std::endl;
+            }
+            bolt::tout << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+/***************************************************************************                                                                                     
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.                                     
+*                                                                                    
+*   Licensed under the Apache License, Version 2.0 (the "License");   
+*   you may not use this file except in compliance with the License.                 
+*   You may obtain a copy of the License at                                          
+*                                                                                    
+*       http://www.apache.org/licenses/LICENSE-2.0                      
+*                                                                                    
+*   Unless required by applicable law or agreed to in writing, software              
+*   distributed under the License is distributed on an "AS IS" BASIS,              
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.         
+*   See the License for the specific language governing permissions and              
+*   limitations under the License.                                                   
+
+***************************************************************************/                                                                                     
+
+// stdafx.h : include file for standard system include files,
+// or project-specific include files used frequently, but
+// changed infrequently.
+//
+
+#pragma once
+
+#define NOMINMAX
+#include "targetver.h"
+
+#include <tchar.h>
+#include <algorithm>
+#include <iomanip>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+
+// TODO: reference additional headers here that your program requires.
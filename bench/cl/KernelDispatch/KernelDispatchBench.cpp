@@ -0,0 +1,190 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Measures the host-side cost of dispatching a small Bolt call, i.e. everything that is not the kernel itself.
+//  Each algorithm is timed twice on the same input: once with control::debug::NoKernelCache, which assembles the
+//  complete kernel string and searches the program map on every call as Bolt always used to, and once through the
+//  kernel lookup fast path.  The difference between the two is the per-call overhead saved.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/scan.h"
+
+#define DATA_TYPE int
+const std::streamsize colWidth = 26;
+
+enum dispatchAlgorithm { d_reduce, d_transform, d_scan, DList };
+static const char* dispatchNames[ DList ] = { "reduce", "transform", "inclusive_scan" };
+
+void runAlgorithm( bolt::cl::control& ctl, dispatchAlgorithm algo,
+    bolt::cl::device_vector< DATA_TYPE >& input, bolt::cl::device_vector< DATA_TYPE >& output )
+{
+    switch( algo )
+    {
+    case d_reduce:
+        bolt::cl::reduce( ctl, input.begin( ), input.end( ), 0, bolt::cl::plus< DATA_TYPE >( ) );
+        break;
+    case d_transform:
+        bolt::cl::transform( ctl, input.begin( ), input.end( ), output.begin( ), bolt::cl::negate< DATA_TYPE >( ) );
+        break;
+    case d_scan:
+        bolt::cl::inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ) );
+        break;
+    default:
+        break;
+    }
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    cl_uint userPlatform = 0;
+    cl_uint userDevice = 0;
+    size_t iterations = 0;
+    size_t length = 0;
+    cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "OpenCL kernel dispatch overhead command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "gpu,g",          "Report only OpenCL GPU devices" )
+            ( "cpu,c",          "Report only OpenCL CPU devices" )
+            ( "all,a",          "Report all OpenCL devices" )
+            ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ),
+                                "Specify the platform under test" )
+            ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ),
+                                "Specify the device under test, relative to -g, -c or -a flags" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 10240 ), "Specify the length of the input" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 1000 ), "Number of samples in timing loop" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "gpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_GPU;
+        }
+
+        if( vm.count( "cpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_CPU;
+        }
+
+        if( vm.count( "all" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_ALL;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "Kernel Dispatch Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Initialize platforms and devices                                            *
+    ******************************************************************************/
+    cl_int err = CL_SUCCESS;
+
+    std::vector< cl::Platform > platforms;
+    bolt::cl::V_OPENCL( cl::Platform::get( &platforms ), "Platform::get() failed" );
+
+    std::vector< cl::Device > devices;
+    bolt::cl::V_OPENCL( platforms.at( userPlatform ).getDevices( deviceType, &devices ), "Platform::getDevices() failed" );
+
+    cl::Context myContext( devices.at( userDevice ) );
+    cl::CommandQueue myQueue( myContext, devices.at( userDevice ) );
+    bolt::cl::control::getDefault( ).setCommandQueue( myQueue );
+
+    std::string strDeviceName = bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( &err );
+    bolt::cl::V_OPENCL( err, "Device::getInfo< CL_DEVICE_NAME > failed" );
+    std::cout << "Device under test : " << strDeviceName << std::endl;
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control slowCtl( bolt::cl::control::getDefault( ) );
+    slowCtl.setForceRunMode( bolt::cl::control::OpenCL );
+    slowCtl.setWaitMode( bolt::cl::control::BusyWait );
+    slowCtl.setDebugMode( bolt::cl::control::debug::NoKernelCache );
+
+    bolt::cl::control fastCtl( slowCtl );
+    fastCtl.setDebugMode( bolt::cl::control::debug::None );
+
+    std::vector< DATA_TYPE > backup( length );
+    std::generate( backup.begin( ), backup.end( ), rand );
+    bolt::cl::device_vector< DATA_TYPE > input( backup.begin( ), backup.end( ), CL_MEM_READ_WRITE );
+    bolt::cl::device_vector< DATA_TYPE > output( length );
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( 2 * DList, iterations );
+
+    bolt::tout << std::left;
+    for( int algo = 0; algo < DList; ++algo )
+    {
+        size_t slowId = myTimer.getUniqueID( _T( "slow" ), algo );
+        size_t fastId = myTimer.getUniqueID( _T( "fast" ), algo );
+
+        //  The first call compiles the program; keep it out of the samples
+        runAlgorithm( fastCtl, static_cast< dispatchAlgorithm >( algo ), input, output );
+
+        for( size_t i = 0; i < iterations; ++i )
+        {
+            myTimer.Start( slowId );
+            runAlgorithm( slowCtl, static_cast< dispatchAlgorithm >( algo ), input, output );
+            myTimer.Stop( slowId );
+
+            myTimer.Start( fastId );
+            runAlgorithm( fastCtl, static_cast< dispatchAlgorithm >( algo ), input, output );
+            myTimer.Stop( fastId );
+        }
+
+        myTimer.pruneOutliers( slowId, 1.0 );
+        myTimer.pruneOutliers( fastId, 1.0 );
+        double slowTime = myTimer.getAverageTime( slowId );
+        double fastTime = myTimer.getAverageTime( fastId );
+
+        std::cout << dispatchNames[ algo ] << " [" << length << " elements]" << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Full lookup (us): " ) << slowTime * 1.0e6 << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Fast path (us): " ) << fastTime * 1.0e6 << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Saved per call (us): " ) << ( slowTime - fastTime ) * 1.0e6 << std::endl;
+        bolt::tout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Measures the fixed cost of a small MultiCoreCpu call.  Each algorithm is timed twice on the same input: once in a
+//  task arena created for the call, which is what constructing a scheduler inside every btbb algorithm used to cost,
+//  and once in the arena Bolt keeps for the life of the process.  The end to end time of the bolt::cl call on the
+//  MultiCoreCpu path is reported alongside.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/scan.h"
+#include "bolt/btbb/arena.h"
+#include "bolt/btbb/scan.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+
+#define DATA_TYPE int
+const std::streamsize colWidth = 26;
+
+enum arenaAlgorithm { a_reduce, a_transform, a_scan, AList };
+static const char* arenaNames[ AList ] = { "reduce", "transform", "inclusive_scan" };
+
+//  The TBB work of one call, without the scheduler around it
+void runTbb( arenaAlgorithm algo, std::vector< DATA_TYPE >& input, std::vector< DATA_TYPE >& output )
+{
+    switch( algo )
+    {
+    case a_reduce:
+        output[ 0 ] = tbb::parallel_reduce( tbb::blocked_range< size_t >( 0, input.size( ) ), DATA_TYPE( 0 ),
+            [ & ]( const tbb::blocked_range< size_t >& r, DATA_TYPE sum )
+            {
+                for( size_t i = r.begin( ); i != r.end( ); ++i )
+                    sum += input[ i ];
+                return sum;
+            }, std::plus< DATA_TYPE >( ) );
+        break;
+    case a_transform:
+        tbb::parallel_for( tbb::blocked_range< size_t >( 0, input.size( ) ),
+            [ & ]( const tbb::blocked_range< size_t >& r )
+            {
+                for( size_t i = r.begin( ); i != r.end( ); ++i )
+                    output[ i ] = -input[ i ];
+            } );
+        break;
+    case a_scan:
+        bolt::btbb::inclusive_scan( input.begin( ), input.end( ), output.begin( ), std::plus< DATA_TYPE >( ) );
+        break;
+    default:
+        break;
+    }
+}
+
+void runBolt( bolt::cl::control& ctl, arenaAlgorithm algo,
+    std::vector< DATA_TYPE >& input, std::vector< DATA_TYPE >& output )
+{
+    switch( algo )
+    {
+    case a_reduce:
+        output[ 0 ] = bolt::cl::reduce( ctl, input.begin( ), input.end( ), 0, bolt::cl::plus< DATA_TYPE >( ) );
+        break;
+    case a_transform:
+        bolt::cl::transform( ctl, input.begin( ), input.end( ), output.begin( ), bolt::cl::negate< DATA_TYPE >( ) );
+        break;
+    case a_scan:
+        bolt::cl::inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ) );
+        break;
+    default:
+        break;
+    }
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    size_t iterations = 0;
+    size_t length = 0;
+    int threads = 0;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "MultiCoreCpu dispatch overhead command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 1024 ), "Specify the length of the input" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 1000 ), "Number of samples in timing loop" )
+            ( "threads,t",      po::value< int >( &threads )->default_value( 0 ),
+                                "Threads Bolt may use; 0 uses every hardware thread" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "MultiCore Dispatch Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control::setMultiCoreThreads( threads );
+
+    bolt::cl::control ctl( bolt::cl::control::getDefault( ) );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< DATA_TYPE > input( length );
+    std::generate( input.begin( ), input.end( ), rand );
+    std::vector< DATA_TYPE > output( length );
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( 3 * AList, iterations );
+
+    bolt::tout << std::left;
+    for( int algo = 0; algo < AList; ++algo )
+    {
+        arenaAlgorithm myAlgo = static_cast< arenaAlgorithm >( algo );
+        size_t freshId = myTimer.getUniqueID( _T( "fresh" ), algo );
+        size_t keptId = myTimer.getUniqueID( _T( "kept" ), algo );
+        size_t boltId = myTimer.getUniqueID( _T( "bolt" ), algo );
+
+        //  The first call starts the worker threads; keep it out of the samples
+        runBolt( ctl, myAlgo, input, output );
+
+        for( size_t i = 0; i < iterations; ++i )
+        {
+            myTimer.Start( freshId );
+            {
+                tbb::task_arena fresh( ( threads > 0 ) ? threads : static_cast< int >( tbb::task_arena::automatic ) );
+                fresh.execute( [ & ]( ) { runTbb( myAlgo, input, output ); } );
+            }
+            myTimer.Stop( freshId );
+
+            myTimer.Start( keptId );
+            bolt::btbb::execute( [ & ]( ) { runTbb( myAlgo, input, output ); } );
+            myTimer.Stop( keptId );
+
+            myTimer.Start( boltId );
+            runBolt( ctl, myAlgo, input, output );
+            myTimer.Stop( boltId );
+        }
+
+        myTimer.pruneOutliers( freshId, 1.0 );
+        myTimer.pruneOutliers( keptId, 1.0 );
+        myTimer.pruneOutliers( boltId, 1.0 );
+        double freshTime = myTimer.getAverageTime( freshId );
+        double keptTime = myTimer.getAverageTime( keptId );
+        double boltTime = myTimer.getAverageTime( boltId );
+
+        std::cout << arenaNames[ algo ] << " [" << length << " elements]" << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Arena per call (us): " ) << freshTime * 1.0e6 << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Bolt arena (us): " ) << keptTime * 1.0e6 << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Saved per call (us): " ) << ( freshTime - keptTime ) * 1.0e6 << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    bolt::cl call (us): " ) << boltTime * 1.0e6 << std::endl;
+        bolt::tout << std::endl;
+    }
+
+    return 0;
+}
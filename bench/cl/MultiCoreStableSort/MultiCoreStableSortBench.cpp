@@ -0,0 +1,176 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Compares the MultiCoreCpu stable sort against the recursive parallel_invoke / std::inplace_merge sort it replaced,
+//  and against a single threaded std::stable_sort.  Every sample sorts the same random input, and the three results
+//  are checked against each other before anything is reported.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/control.h"
+#include "bolt/btbb/arena.h"
+#include "bolt/btbb/stable_sort.h"
+
+#include "tbb/parallel_invoke.h"
+
+#define DATA_TYPE unsigned int
+const std::streamsize colWidth = 26;
+
+enum sortAlgorithm { s_previous, s_bolt, s_stl, SList };
+static const TCHAR* sortNames[ SList ] = { _T( "    Previous btbb (s): " ), _T( "    Merge path btbb (s): " ),
+    _T( "    std::stable_sort (s): " ) };
+
+//  The btbb stable sort as it used to be: split down to single elements, merge every level with std::inplace_merge
+template< typename RandomAccessIterator >
+void previousStableSort( RandomAccessIterator beg, RandomAccessIterator end )
+{
+    if( end - beg > 1 )
+    {
+        RandomAccessIterator mid = beg + ( end - beg ) / 2;
+
+        tbb::parallel_invoke(
+            [ & ] { previousStableSort( beg, mid ); },
+            [ & ] { previousStableSort( mid, end ); }
+        );
+
+        std::inplace_merge( beg, mid, end );
+    }
+}
+
+void runSort( sortAlgorithm algo, std::vector< DATA_TYPE >& input )
+{
+    switch( algo )
+    {
+    case s_previous:
+        bolt::btbb::execute( [ & ]( ) { previousStableSort( input.begin( ), input.end( ) ); } );
+        break;
+    case s_bolt:
+        bolt::btbb::stable_sort( input.begin( ), input.end( ) );
+        break;
+    case s_stl:
+        std::stable_sort( input.begin( ), input.end( ) );
+        break;
+    default:
+        break;
+    }
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    size_t iterations = 0;
+    size_t length = 0;
+    int threads = 0;
+    bool skipPrevious = false;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "MultiCoreCpu stable sort command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 16*1048576 ), "Specify the length of the input" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 10 ), "Number of samples in timing loop" )
+            ( "threads,t",      po::value< int >( &threads )->default_value( 0 ),
+                                "Threads Bolt may use; 0 uses every hardware thread" )
+            ( "skipPrevious,s", "Do not time the previous implementation, which is very slow on large inputs" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "skipPrevious" ) )
+        {
+            skipPrevious = true;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "MultiCore Stable Sort Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control::setMultiCoreThreads( threads );
+
+    std::vector< DATA_TYPE > backup( length );
+    std::generate( backup.begin( ), backup.end( ), rand );
+    std::vector< DATA_TYPE > input( length );
+    std::vector< DATA_TYPE > results[ SList ];
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( SList, iterations );
+
+    size_t testIds[ SList ];
+    for( int algo = 0; algo < SList; ++algo )
+        testIds[ algo ] = myTimer.getUniqueID( _T( "sort" ), algo );
+
+    for( int algo = 0; algo < SList; ++algo )
+    {
+        if( algo == s_previous && skipPrevious )
+            continue;
+
+        for( size_t i = 0; i < iterations; ++i )
+        {
+            input = backup;
+            myTimer.Start( testIds[ algo ] );
+            runSort( static_cast< sortAlgorithm >( algo ), input );
+            myTimer.Stop( testIds[ algo ] );
+        }
+        results[ algo ] = input;
+    }
+
+    if( results[ s_bolt ] != results[ s_stl ] || ( !skipPrevious && results[ s_previous ] != results[ s_stl ] ) )
+    {
+        std::cout << "MultiCore Stable Sort Benchmark: results do not match std::stable_sort" << std::endl;
+        return 1;
+    }
+
+    double MKeys = length / ( 1024.0 * 1024.0 );
+
+    bolt::tout << std::left;
+    bolt::tout << std::setw( colWidth ) << _T( "Test profile: " ) << _T( "[" ) << iterations << _T( "] samples" ) << std::endl;
+    bolt::tout << std::setw( colWidth ) << _T( "    Size (MKeys): " ) << MKeys << std::endl;
+    for( int algo = 0; algo < SList; ++algo )
+    {
+        if( algo == s_previous && skipPrevious )
+            continue;
+
+        myTimer.pruneOutliers( testIds[ algo ], 1.0 );
+        double sortTime = myTimer.getAverageTime( testIds[ algo ] );
+        bolt::tout << std::setw( colWidth ) << sortNames[ algo ] << sortTime
+            << _T( "  (" ) << MKeys / sortTime << _T( " MKeys/s)" ) << std::endl;
+    }
+    bolt::tout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,228 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Measures what fusing a chain of transforms into the algorithm that ends it saves.  Each chain runs twice on the
+//  same input: once as separate Bolt calls, each of which writes its result to a device_vector that the next call
+//  reads back, and once through bolt::cl::pipeline, which composes the transforms into the functor of a single
+//  transform_reduce or transform_inclusive_scan.  The bytes column counts the device memory each version reads and
+//  writes; bandwidth is the bytes of the fused version over the time taken, so it shows the effective rate at
+//  which each version gets through the input.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/pipeline.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/scan.h"
+#include "bolt/cl/transform.h"
+
+#define DATA_TYPE int
+const std::streamsize colWidth = 26;
+
+enum pipelineChain { p_reduce, p_scan, PList };
+static const char* chainNames[ PList ] = { "transform -> transform -> reduce",
+    "transform -> transform -> inclusive_scan" };
+
+//  Bytes of device memory the separate calls move: each transform reads and writes the whole range, then the
+//  last algorithm reads it, and the scan writes it
+size_t separateBytes( pipelineChain chain, size_t length )
+{
+    size_t bytes = ( 2 + 2 + 1 ) * length * sizeof( DATA_TYPE );
+    if( chain == p_scan )
+        bytes += length * sizeof( DATA_TYPE );
+    return bytes;
+}
+
+//  Bytes of device memory the fused call moves: the input once, and the scan output once
+size_t fusedBytes( pipelineChain chain, size_t length )
+{
+    size_t bytes = length * sizeof( DATA_TYPE );
+    if( chain == p_scan )
+        bytes += length * sizeof( DATA_TYPE );
+    return bytes;
+}
+
+DATA_TYPE runSeparate( bolt::cl::control& ctl, pipelineChain chain, bolt::cl::device_vector< DATA_TYPE >& input,
+    bolt::cl::device_vector< DATA_TYPE >& temp, bolt::cl::device_vector< DATA_TYPE >& output )
+{
+    bolt::cl::transform( ctl, input.begin( ), input.end( ), temp.begin( ), bolt::cl::square< DATA_TYPE >( ) );
+    bolt::cl::transform( ctl, temp.begin( ), temp.end( ), temp.begin( ), bolt::cl::negate< DATA_TYPE >( ) );
+
+    if( chain == p_reduce )
+        return bolt::cl::reduce( ctl, temp.begin( ), temp.end( ), 0, bolt::cl::plus< DATA_TYPE >( ) );
+
+    bolt::cl::inclusive_scan( ctl, temp.begin( ), temp.end( ), output.begin( ), bolt::cl::plus< DATA_TYPE >( ) );
+    return 0;
+}
+
+DATA_TYPE runFused( bolt::cl::control& ctl, pipelineChain chain, bolt::cl::device_vector< DATA_TYPE >& input,
+    bolt::cl::device_vector< DATA_TYPE >& output )
+{
+    if( chain == p_reduce )
+        return bolt::cl::make_pipeline( input.begin( ), input.end( ) )
+            .transform( bolt::cl::square< DATA_TYPE >( ) )
+            .transform( bolt::cl::negate< DATA_TYPE >( ) )
+            .reduce( ctl, 0, bolt::cl::plus< DATA_TYPE >( ) );
+
+    bolt::cl::make_pipeline( input.begin( ), input.end( ) )
+        .transform( bolt::cl::square< DATA_TYPE >( ) )
+        .transform( bolt::cl::negate< DATA_TYPE >( ) )
+        .inclusive_scan( ctl, output.begin( ), bolt::cl::plus< DATA_TYPE >( ) );
+    return 0;
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    cl_uint userPlatform = 0;
+    cl_uint userDevice = 0;
+    size_t iterations = 0;
+    size_t length = 0;
+    cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "OpenCL pipeline fusion command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "gpu,g",          "Report only OpenCL GPU devices" )
+            ( "cpu,c",          "Report only OpenCL CPU devices" )
+            ( "all,a",          "Report all OpenCL devices" )
+            ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ),
+                                "Specify the platform under test" )
+            ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ),
+                                "Specify the device under test, relative to -g, -c or -a flags" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 1 << 24 ), "Specify the length of the input" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 100 ), "Number of samples in timing loop" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "gpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_GPU;
+        }
+
+        if( vm.count( "cpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_CPU;
+        }
+
+        if( vm.count( "all" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_ALL;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "Pipeline Fusion Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Initialize platforms and devices                                            *
+    ******************************************************************************/
+    cl_int err = CL_SUCCESS;
+
+    std::vector< cl::Platform > platforms;
+    bolt::cl::V_OPENCL( cl::Platform::get( &platforms ), "Platform::get() failed" );
+
+    std::vector< cl::Device > devices;
+    bolt::cl::V_OPENCL( platforms.at( userPlatform ).getDevices( deviceType, &devices ), "Platform::getDevices() failed" );
+
+    cl::Context myContext( devices.at( userDevice ) );
+    cl::CommandQueue myQueue( myContext, devices.at( userDevice ) );
+    bolt::cl::control::getDefault( ).setCommandQueue( myQueue );
+
+    std::string strDeviceName = bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( &err );
+    bolt::cl::V_OPENCL( err, "Device::getInfo< CL_DEVICE_NAME > failed" );
+    std::cout << "Device under test : " << strDeviceName << std::endl;
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control myCtl( bolt::cl::control::getDefault( ) );
+    myCtl.setForceRunMode( bolt::cl::control::OpenCL );
+    myCtl.setWaitMode( bolt::cl::control::BusyWait );
+
+    std::vector< DATA_TYPE > backup( length );
+    for( size_t i = 0; i < length; ++i )
+        backup[ i ] = rand( ) % 64;
+
+    bolt::cl::device_vector< DATA_TYPE > input( backup.begin( ), backup.end( ), CL_MEM_READ_WRITE );
+    bolt::cl::device_vector< DATA_TYPE > temp( length );
+    bolt::cl::device_vector< DATA_TYPE > output( length );
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( 2 * PList, iterations );
+
+    bolt::tout << std::left;
+    for( int chain = 0; chain < PList; ++chain )
+    {
+        size_t separateId = myTimer.getUniqueID( _T( "separate" ), chain );
+        size_t fusedId = myTimer.getUniqueID( _T( "fused" ), chain );
+
+        //  The first calls compile the programs; keep them out of the samples
+        runSeparate( myCtl, static_cast< pipelineChain >( chain ), input, temp, output );
+        runFused( myCtl, static_cast< pipelineChain >( chain ), input, output );
+
+        for( size_t i = 0; i < iterations; ++i )
+        {
+            myTimer.Start( separateId );
+            runSeparate( myCtl, static_cast< pipelineChain >( chain ), input, temp, output );
+            myTimer.Stop( separateId );
+
+            myTimer.Start( fusedId );
+            runFused( myCtl, static_cast< pipelineChain >( chain ), input, output );
+            myTimer.Stop( fusedId );
+        }
+
+        myTimer.pruneOutliers( separateId, 1.0 );
+        myTimer.pruneOutliers( fusedId, 1.0 );
+        double separateTime = myTimer.getAverageTime( separateId );
+        double fusedTime = myTimer.getAverageTime( fusedId );
+        double separateGB = separateBytes( static_cast< pipelineChain >( chain ), length ) / 1.0e9;
+        double fusedGB = fusedBytes( static_cast< pipelineChain >( chain ), length ) / 1.0e9;
+
+        std::cout << chainNames[ chain ] << " [" << length << " elements]" << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Separate calls (GB): " ) << separateGB << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Fused pipeline (GB): " ) << fusedGB << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Saved (GB): " ) << separateGB - fusedGB << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Separate calls (GB/s): " ) << fusedGB / separateTime << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Fused pipeline (GB/s): " ) << fusedGB / fusedTime << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Speedup: " ) << separateTime / fusedTime << std::endl;
+        bolt::tout << std::endl;
+    }
+
+    return 0;
+}
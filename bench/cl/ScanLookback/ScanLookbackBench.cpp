@@ -0,0 +1,216 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Measures the device bandwidth of the scan family.  Each algorithm is timed twice on the same input: once with
+//  control::debug::MultiPassScan, which runs the three kernel scan (per block sums, a scan of the sums, then a
+//  second pass over the input), and once through the single pass look-back kernel, which reads and writes every
+//  element once.  Bandwidth counts the bytes an ideal scan has to move: the input read once and the output
+//  written once.  On devices that cannot run the single pass kernel both columns time the three kernel path.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/scan.h"
+#include "bolt/cl/scan_by_key.h"
+#include "bolt/cl/transform_scan.h"
+
+#define DATA_TYPE int
+const std::streamsize colWidth = 26;
+
+enum scanAlgorithm { s_inclusive, s_exclusive, s_transform, s_byKey, SList };
+static const char* scanNames[ SList ] = { "inclusive_scan", "exclusive_scan", "transform_inclusive_scan",
+    "inclusive_scan_by_key" };
+
+//  Bytes an ideal implementation moves for one call
+size_t idealBytes( scanAlgorithm algo, size_t length )
+{
+    size_t bytes = 2 * length * sizeof( DATA_TYPE );
+    if( algo == s_byKey )
+        bytes += length * sizeof( DATA_TYPE );
+    return bytes;
+}
+
+void runAlgorithm( bolt::cl::control& ctl, scanAlgorithm algo, bolt::cl::device_vector< DATA_TYPE >& keys,
+    bolt::cl::device_vector< DATA_TYPE >& input, bolt::cl::device_vector< DATA_TYPE >& output )
+{
+    switch( algo )
+    {
+    case s_inclusive:
+        bolt::cl::inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ) );
+        break;
+    case s_exclusive:
+        bolt::cl::exclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ), 0 );
+        break;
+    case s_transform:
+        bolt::cl::transform_inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ),
+            bolt::cl::negate< DATA_TYPE >( ), bolt::cl::plus< DATA_TYPE >( ) );
+        break;
+    case s_byKey:
+        bolt::cl::inclusive_scan_by_key( ctl, keys.begin( ), keys.end( ), input.begin( ), output.begin( ),
+            bolt::cl::equal_to< DATA_TYPE >( ), bolt::cl::plus< DATA_TYPE >( ) );
+        break;
+    default:
+        break;
+    }
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    cl_uint userPlatform = 0;
+    cl_uint userDevice = 0;
+    size_t iterations = 0;
+    size_t length = 0;
+    size_t segmentLength = 0;
+    cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "OpenCL single pass scan command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "gpu,g",          "Report only OpenCL GPU devices" )
+            ( "cpu,c",          "Report only OpenCL CPU devices" )
+            ( "all,a",          "Report all OpenCL devices" )
+            ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ),
+                                "Specify the platform under test" )
+            ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ),
+                                "Specify the device under test, relative to -g, -c or -a flags" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 1 << 24 ), "Specify the length of the input" )
+            ( "segment,s",      po::value< size_t >( &segmentLength )->default_value( 1000 ),
+                                "Specify the length of the scan_by_key segments" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 100 ), "Number of samples in timing loop" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "gpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_GPU;
+        }
+
+        if( vm.count( "cpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_CPU;
+        }
+
+        if( vm.count( "all" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_ALL;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "Scan Lookback Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Initialize platforms and devices                                            *
+    ******************************************************************************/
+    cl_int err = CL_SUCCESS;
+
+    std::vector< cl::Platform > platforms;
+    bolt::cl::V_OPENCL( cl::Platform::get( &platforms ), "Platform::get() failed" );
+
+    std::vector< cl::Device > devices;
+    bolt::cl::V_OPENCL( platforms.at( userPlatform ).getDevices( deviceType, &devices ), "Platform::getDevices() failed" );
+
+    cl::Context myContext( devices.at( userDevice ) );
+    cl::CommandQueue myQueue( myContext, devices.at( userDevice ) );
+    bolt::cl::control::getDefault( ).setCommandQueue( myQueue );
+
+    std::string strDeviceName = bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( &err );
+    bolt::cl::V_OPENCL( err, "Device::getInfo< CL_DEVICE_NAME > failed" );
+    std::cout << "Device under test : " << strDeviceName << std::endl;
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control multiCtl( bolt::cl::control::getDefault( ) );
+    multiCtl.setForceRunMode( bolt::cl::control::OpenCL );
+    multiCtl.setWaitMode( bolt::cl::control::BusyWait );
+    multiCtl.setDebugMode( bolt::cl::control::debug::MultiPassScan );
+
+    bolt::cl::control singleCtl( multiCtl );
+    singleCtl.setDebugMode( bolt::cl::control::debug::None );
+
+    std::vector< DATA_TYPE > backup( length );
+    std::generate( backup.begin( ), backup.end( ), rand );
+    std::vector< DATA_TYPE > backupKeys( length );
+    for( size_t i = 0; i < length; ++i )
+        backupKeys[ i ] = static_cast< DATA_TYPE >( i / segmentLength );
+
+    bolt::cl::device_vector< DATA_TYPE > keys( backupKeys.begin( ), backupKeys.end( ), CL_MEM_READ_WRITE );
+    bolt::cl::device_vector< DATA_TYPE > input( backup.begin( ), backup.end( ), CL_MEM_READ_WRITE );
+    bolt::cl::device_vector< DATA_TYPE > output( length );
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( 2 * SList, iterations );
+
+    bolt::tout << std::left;
+    for( int algo = 0; algo < SList; ++algo )
+    {
+        size_t multiId = myTimer.getUniqueID( _T( "multi" ), algo );
+        size_t singleId = myTimer.getUniqueID( _T( "single" ), algo );
+
+        //  The first calls compile the programs; keep them out of the samples
+        runAlgorithm( multiCtl, static_cast< scanAlgorithm >( algo ), keys, input, output );
+        runAlgorithm( singleCtl, static_cast< scanAlgorithm >( algo ), keys, input, output );
+
+        for( size_t i = 0; i < iterations; ++i )
+        {
+            myTimer.Start( multiId );
+            runAlgorithm( multiCtl, static_cast< scanAlgorithm >( algo ), keys, input, output );
+            myTimer.Stop( multiId );
+
+            myTimer.Start( singleId );
+            runAlgorithm( singleCtl, static_cast< scanAlgorithm >( algo ), keys, input, output );
+            myTimer.Stop( singleId );
+        }
+
+        myTimer.pruneOutliers( multiId, 1.0 );
+        myTimer.pruneOutliers( singleId, 1.0 );
+        double multiTime = myTimer.getAverageTime( multiId );
+        double singleTime = myTimer.getAverageTime( singleId );
+        double gigaBytes = idealBytes( static_cast< scanAlgorithm >( algo ), length ) / 1.0e9;
+
+        std::cout << scanNames[ algo ] << " [" << length << " elements]" << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Three kernel (GB/s): " ) << gigaBytes / multiTime << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Single pass (GB/s): " ) << gigaBytes / singleTime << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Speedup: " ) << multiTime / singleTime << std::endl;
+        bolt::tout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+//  Measures the device bandwidth of the stream compaction family over a sweep of selectivities, the percentage of
+//  the input the predicate keeps.  Bandwidth counts the bytes an ideal compaction has to move: the input read once
+//  and every element written to an output written once.  bolt::cl::copy of the whole input is timed as well, as the
+//  bandwidth a compaction keeping everything could reach.
+
+#include "stdafx.h"
+
+#include "bolt/unicode.h"
+#include "bolt/statisticalTimer.h"
+#include "bolt/countof.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/copy.h"
+#include "bolt/cl/partition.h"
+#include "bolt/cl/remove.h"
+#include "bolt/cl/unique.h"
+
+#define DATA_TYPE int
+const std::streamsize colWidth = 26;
+
+BOLT_FUNCTOR( is_below,
+struct is_below
+{
+    is_below( int limit = 0 ): limit( limit )
+    {}
+
+    bool operator( )( const int &x ) const
+    {
+        return x < limit;
+    }
+
+    int limit;
+};
+);
+
+enum compactAlgorithm { c_copyIf, c_removeCopyIf, c_uniqueCopy, c_partitionCopy, CList };
+static const char* compactNames[ CList ] = { "copy_if", "remove_copy_if", "unique_copy", "partition_copy" };
+static const int selectivities[ ] = { 1, 10, 25, 50, 75, 90, 99 };
+
+//  Bytes an ideal implementation moves for one call keeping kept of length elements
+size_t idealBytes( compactAlgorithm algo, size_t length, size_t kept )
+{
+    size_t written = ( algo == c_partitionCopy ) ? length : kept;
+    return ( length + written ) * sizeof( DATA_TYPE );
+}
+
+//  Returns the number of elements written to output
+size_t runAlgorithm( bolt::cl::control& ctl, compactAlgorithm algo, int selectivity,
+    bolt::cl::device_vector< DATA_TYPE >& input, bolt::cl::device_vector< DATA_TYPE >& runs,
+    bolt::cl::device_vector< DATA_TYPE >& output, bolt::cl::device_vector< DATA_TYPE >& rejected )
+{
+    switch( algo )
+    {
+    case c_copyIf:
+        return bolt::cl::copy_if( ctl, input.begin( ), input.end( ), output.begin( ), is_below( selectivity ) )
+            - output.begin( );
+    case c_removeCopyIf:
+        return bolt::cl::remove_copy_if( ctl, input.begin( ), input.end( ), output.begin( ),
+            is_below( 100 - selectivity ) ) - output.begin( );
+    case c_uniqueCopy:
+        return bolt::cl::unique_copy( ctl, runs.begin( ), runs.end( ), output.begin( ) ) - output.begin( );
+    case c_partitionCopy:
+        return bolt::cl::partition_copy( ctl, input.begin( ), input.end( ), output.begin( ), rejected.begin( ),
+            is_below( selectivity ) ).first - output.begin( );
+    default:
+        return 0;
+    }
+}
+
+int _tmain( int argc, _TCHAR* argv[] )
+{
+    cl_uint userPlatform = 0;
+    cl_uint userDevice = 0;
+    size_t iterations = 0;
+    size_t length = 0;
+    cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
+
+    /******************************************************************************
+    * Parameter parsing                                                           *
+    ******************************************************************************/
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "OpenCL stream compaction command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "gpu,g",          "Report only OpenCL GPU devices" )
+            ( "cpu,c",          "Report only OpenCL CPU devices" )
+            ( "all,a",          "Report all OpenCL devices" )
+            ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ),
+                                "Specify the platform under test" )
+            ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ),
+                                "Specify the device under test, relative to -g, -c or -a flags" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 1 << 24 ), "Specify the length of the input" )
+            ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 100 ), "Number of samples in timing loop" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            //	This needs to be 'cout' as program-options does not support wcout yet
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "gpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_GPU;
+        }
+
+        if( vm.count( "cpu" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_CPU;
+        }
+
+        if( vm.count( "all" ) )
+        {
+            deviceType	= CL_DEVICE_TYPE_ALL;
+        }
+    }
+    catch( std::exception& e )
+    {
+        std::cout << _T( "Stream Compaction Benchmark error condition reported:" ) << std::endl << e.what() << std::endl;
+        return 1;
+    }
+
+    /******************************************************************************
+    * Initialize platforms and devices                                            *
+    ******************************************************************************/
+    cl_int err = CL_SUCCESS;
+
+    std::vector< cl::Platform > platforms;
+    bolt::cl::V_OPENCL( cl::Platform::get( &platforms ), "Platform::get() failed" );
+
+    std::vector< cl::Device > devices;
+    bolt::cl::V_OPENCL( platforms.at( userPlatform ).getDevices( deviceType, &devices ), "Platform::getDevices() failed" );
+
+    cl::Context myContext( devices.at( userDevice ) );
+    cl::CommandQueue myQueue( myContext, devices.at( userDevice ) );
+    bolt::cl::control::getDefault( ).setCommandQueue( myQueue );
+
+    std::string strDeviceName = bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( &err );
+    bolt::cl::V_OPENCL( err, "Device::getInfo< CL_DEVICE_NAME > failed" );
+    std::cout << "Device under test : " << strDeviceName << std::endl;
+
+    /******************************************************************************
+    * Benchmark logic                                                             *
+    ******************************************************************************/
+    bolt::cl::control ctl( bolt::cl::control::getDefault( ) );
+    ctl.setForceRunMode( bolt::cl::control::OpenCL );
+    ctl.setWaitMode( bolt::cl::control::BusyWait );
+
+    //  Values are percentiles, so is_below( s ) keeps about s percent of them
+    std::vector< DATA_TYPE > backup( length );
+    for( size_t i = 0; i < length; ++i )
+        backup[ i ] = rand( ) % 100;
+
+    bolt::cl::device_vector< DATA_TYPE > input( backup.begin( ), backup.end( ), CL_MEM_READ_WRITE );
+    bolt::cl::device_vector< DATA_TYPE > output( length );
+    bolt::cl::device_vector< DATA_TYPE > rejected( length );
+
+    bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
+    myTimer.Reserve( CList * countOf( selectivities ) + 1, iterations );
+
+    //  The bandwidth of a plain copy, for reference
+    size_t copyId = myTimer.getUniqueID( _T( "copy" ), 0 );
+    bolt::cl::copy( ctl, input.begin( ), input.end( ), output.begin( ) );
+    for( size_t i = 0; i < iterations; ++i )
+    {
+        myTimer.Start( copyId );
+        bolt::cl::copy( ctl, input.begin( ), input.end( ), output.begin( ) );
+        myTimer.Stop( copyId );
+    }
+    myTimer.pruneOutliers( copyId, 1.0 );
+
+    bolt::tout << std::left;
+    std::cout << "copy [" << length << " elements]" << std::endl;
+    bolt::tout << std::setw( colWidth ) << _T( "    Bandwidth (GB/s): " )
+        << 2 * length * sizeof( DATA_TYPE ) / 1.0e9 / myTimer.getAverageTime( copyId ) << std::endl << std::endl;
+
+    for( int algo = 0; algo < CList; ++algo )
+    {
+        std::cout << compactNames[ algo ] << " [" << length << " elements]" << std::endl;
+
+        for( size_t s = 0; s < countOf( selectivities ); ++s )
+        {
+            int selectivity = selectivities[ s ];
+
+            //  Runs whose first elements make up selectivity percent of the input, for unique_copy
+            std::vector< DATA_TYPE > backupRuns( length );
+            for( size_t i = 0; i < length; ++i )
+                backupRuns[ i ] = ( i == 0 || backup[ i ] < selectivity ) ? static_cast< DATA_TYPE >( i )
+                                                                          : backupRuns[ i - 1 ];
+            bolt::cl::device_vector< DATA_TYPE > runs( backupRuns.begin( ), backupRuns.end( ), CL_MEM_READ_WRITE );
+
+            size_t id = myTimer.getUniqueID( _T( "compact" ),
+                static_cast< unsigned int >( algo * countOf( selectivities ) + s ) );
+
+            //  The first call compiles the program; keep it out of the samples
+            size_t kept = runAlgorithm( ctl, static_cast< compactAlgorithm >( algo ), selectivity, input, runs,
+                output, rejected );
+
+            for( size_t i = 0; i < iterations; ++i )
+            {
+                myTimer.Start( id );
+                runAlgorithm( ctl, static_cast< compactAlgorithm >( algo ), selectivity, input, runs, output,
+                    rejected );
+                myTimer.Stop( id );
+            }
+
+            myTimer.pruneOutliers( id, 1.0 );
+            double gigaBytes = idealBytes( static_cast< compactAlgorithm >( algo ), length, kept ) / 1.0e9;
+
+            bolt::tout << _T( "    " ) << std::setw( 3 ) << selectivity << _T( "% kept (GB/s): " )
+                << gigaBytes / myTimer.getAverageTime( id ) << std::endl;
+        }
+        bolt::tout << std::endl;
+    }
+
+    return 0;
+}
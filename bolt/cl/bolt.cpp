@@ -26,6 +26,10 @@
 #include <algorithm>
 #include <vector>
 #include <set>
+#include <map>
+#include <cstdio>
+#include <typeinfo>
+#include <boost/thread/tss.hpp>
 
 #include "bolt/cl/bolt.h"
 #include "bolt/unicode.h"
@@ -33,12 +37,14 @@
 //  Include all kernel string objects
 
 #include "bolt/binary_search_kernels.hpp"
+#include "bolt/compact_kernels.hpp"
 #include "bolt/copy_kernels.hpp"
 #include "bolt/count_kernels.hpp"
 #include "bolt/fill_kernels.hpp"
 #include "bolt/gather_kernels.hpp"
 #include "bolt/generate_kernels.hpp"
 #include "bolt/merge_kernels.hpp"
+#include "bolt/merge_path_kernels.hpp"
 #include "bolt/min_element_kernels.hpp"
 #include "bolt/reduce_kernels.hpp"
 #include "bolt/reduce_by_key_kernels.hpp"
@@ -404,6 +410,25 @@ namespace bolt {
         const ::std::string& completeKernelSource,
         cl_int * err = NULL);
 
+    /**********************************************************************
+        * loadProgramBinary / storeProgramBinary
+        * read and write the persistent program binary cache.
+        * Called from acquireProgram; defined in programCache.cpp
+        **********************************************************************/
+    ::cl::Program loadProgramBinary(
+        const ::cl::Context& context,
+        const ::cl::Device&  device,
+        const ::std::string& deviceStr,
+        const ::std::string& compileOptions,
+        const ::std::string& completeKernelSource );
+
+    void storeProgramBinary(
+        const ::cl::Program& program,
+        const ::cl::Device&  device,
+        const ::std::string& deviceStr,
+        const ::std::string& compileOptions,
+        const ::std::string& completeKernelSource );
+
 
     void wait(const bolt::cl::control &ctl, ::cl::Event &e)
     {
@@ -421,9 +446,245 @@ namespace bolt {
             const ::cl::CommandQueue& q = ctl.getCommandQueue();
             cl_int l_Error = q.finish();
             V_OPENCL( l_Error, "clFinish call failed" );
+        } else if (waitMode == bolt::cl::control::NoWait) {
+            // the queue runs in order, so later commands still see the results; only make sure the work starts
+            cl_int l_Error = ctl.getCommandQueue().flush();
+            V_OPENCL( l_Error, "clFlush call failed" );
+        }
+    };
+
+    void wait(const bolt::cl::control &ctl)
+    {
+        const ::cl::CommandQueue& q = ctl.getCommandQueue();
+        if (ctl.getWaitMode() == bolt::cl::control::NoWait) {
+            V_OPENCL( q.flush(), "clFlush call failed" );
+        } else {
+            V_OPENCL( q.finish(), "clFinish call failed" );
         }
     };
 
+    namespace
+    {
+        /**********************************************************************
+         * Kernel lookup fast path
+         * getKernels remembers which program it resolved for a call-site
+         * identity (specializer type, type names, type definitions, options,
+         * kernel source, device), so that later calls with the same identity
+         * neither assemble the complete kernel string nor compare it against
+         * the ProgramMap.
+         **********************************************************************/
+        struct KernelCacheKey
+        {
+            cl_context              context;
+            cl_device_id            device;
+            const std::type_info*   specializer;
+            const std::string*      kernelSource;   // one of the builtin kernel strings, otherwise NULL
+            cl_ulong                hash;           // everything else, including any other kernel source
+        };
+
+        struct KernelCacheKeyComp
+        {
+            bool operator( )( const KernelCacheKey& lhs, const KernelCacheKey& rhs ) const
+            {
+                if( lhs.context != rhs.context )
+                    return lhs.context < rhs.context;
+                if( lhs.device != rhs.device )
+                    return lhs.device < rhs.device;
+                if( *lhs.specializer != *rhs.specializer )
+                    return lhs.specializer->before( *rhs.specializer ) != 0;
+                if( lhs.kernelSource != rhs.kernelSource )
+                    return lhs.kernelSource < rhs.kernelSource;
+                return lhs.hash < rhs.hash;
+            }
+        };
+
+        struct KernelCacheValue
+        {
+            ::cl::Program program;
+            ::std::vector< ::std::string > kernelNames;   // already suffixed with "Instantiated"
+        };
+
+        typedef std::map< KernelCacheKey, KernelCacheValue, KernelCacheKeyComp > KernelCache;
+
+        boost::shared_mutex kernelCacheGuard;
+        KernelCache kernelCache;
+
+        //  The kernel strings compiled into the library never change, so their address identifies them
+        const std::string* const builtinKernelStrings[ ] =
+        {
+            &binary_search_kernels, &compact_kernels, &copy_kernels, &count_kernels, &fill_kernels,
+            &gather_kernels, &generate_kernels, &merge_kernels, &merge_path_kernels, &min_element_kernels,
+            &reduce_kernels, &reduce_by_key_kernels, &scan_kernels, &scan_by_key_kernels, &scatter_kernels,
+            &sort_kernels, &sort_uint_kernels, &sort_int_kernels, &sort_float_kernels, &sort_common_kernels,
+            &sort_by_key_kernels, &sort_by_key_int_kernels, &sort_by_key_uint_kernels, &stablesort_kernels,
+            &stablesort_by_key_kernels, &transform_kernels, &transform_reduce_kernels, &transform_scan_kernels
+        };
+
+        cl_ulong hashAppend( cl_ulong hash, const std::string& str )
+        {
+            // fold the length in first, so that { "ab", "c" } and { "a", "bc" } hash differently
+            return hashString( str, ( hash ^ str.size( ) ) * 1099511628211ULL );
+        }
+
+        KernelCacheKey makeKernelCacheKey(
+            const control&      ctl,
+            const std::vector<std::string>& typeNames,
+            const KernelTemplateSpecializer * const kts,
+            const std::vector<std::string>& typeDefs,
+            const std::string&  kernelString,
+            const std::string&  options )
+        {
+            KernelCacheKey key;
+            ::clGetCommandQueueInfo( ctl.getCommandQueue( )( ), CL_QUEUE_CONTEXT, sizeof( key.context ), &key.context, NULL );
+            ::clGetCommandQueueInfo( ctl.getCommandQueue( )( ), CL_QUEUE_DEVICE, sizeof( key.device ), &key.device, NULL );
+            key.specializer = &typeid( *kts );
+
+            key.kernelSource = NULL;
+            cl_ulong hash = hashString( "" );
+            for( size_t i = 0; i < sizeof( builtinKernelStrings ) / sizeof( builtinKernelStrings[ 0 ] ); ++i )
+            {
+                if( builtinKernelStrings[ i ] == &kernelString )
+                    key.kernelSource = &kernelString;
+            }
+            if( key.kernelSource == NULL )
+                hash = hashAppend( hash, kernelString );
+
+            for( size_t i = 0; i < typeNames.size( ); ++i )
+                hash = hashAppend( hash, typeNames[ i ] );
+            for( size_t i = 0; i < typeDefs.size( ); ++i )
+                hash = hashAppend( hash, typeDefs[ i ] );
+            hash = hashAppend( hash, options );
+            hash = hashAppend( hash, ctl.getCompileOptions( ) );
+            key.hash = hash;
+            return key;
+        }
+
+        /**********************************************************************
+         * Kernel Pool
+         * Every thread keeps the kernel objects it has created, per program
+         * and kernel name, and hands them out again on later calls instead
+         * of paying for clCreateKernel.  Pools are never shared between
+         * threads, so two threads never race on setArg of the same kernel.
+         * A pooled kernel is checked out until the caller drops the
+         * PooledKernels it came in; a nested call that overlaps it gets a
+         * new instance, and only a few idle instances of each are kept.
+         **********************************************************************/
+        struct PooledKernel
+        {
+            ::cl::Kernel kernel;
+            bool inUse;
+        };
+
+        struct KernelPool
+        {
+            typedef ::std::vector< boost::shared_ptr< PooledKernel > > Instances;
+            typedef std::map< ::std::string, Instances > NamedKernels;
+            std::map< cl_program, NamedKernels > programs;
+        };
+
+        //  Idle instances a thread keeps of one kernel; more than one are only needed by overlapping calls
+        const size_t maxIdleKernels = 4;
+
+        /*! \brief Class used with shared_ptr<> as a custom deleter, to return the kernels of a PooledKernels to
+        *   the pool once its last copy is gone
+        */
+        class ReturnKernels
+        {
+        public:
+            void add( const boost::shared_ptr< PooledKernel >& entry )
+            {
+                m_entries.push_back( entry );
+            }
+
+            void operator( )( const void* )
+            {
+                for( size_t i = 0; i < m_entries.size( ); ++i )
+                    m_entries[ i ]->inUse = false;
+            }
+
+        private:
+            ::std::vector< boost::shared_ptr< PooledKernel > > m_entries;
+        };
+
+        boost::thread_specific_ptr< KernelPool > kernelPool;
+
+        boost::mutex kernelCreationMutex;
+        size_t kernelCreationCount = 0;
+
+        boost::shared_ptr< PooledKernel > acquirePooledKernel( const ::cl::Program& program, const ::std::string& name )
+        {
+            KernelPool* pool = kernelPool.get( );
+            if( pool == NULL )
+            {
+                pool = new KernelPool;
+                kernelPool.reset( pool );
+            }
+
+            //  Take the first idle instance, and release the idle ones past maxIdleKernels
+            KernelPool::Instances& instances = pool->programs[ program( ) ][ name ];
+            boost::shared_ptr< PooledKernel > entry;
+            size_t idle = 0;
+            for( KernelPool::Instances::iterator it = instances.begin( ); it != instances.end( ); )
+            {
+                if( ( *it )->inUse )
+                    ++it;
+                else if( !entry )
+                    entry = *it++;
+                else if( ++idle > maxIdleKernels )
+                    it = instances.erase( it );
+                else
+                    ++it;
+            }
+
+            if( !entry )
+            {
+                cl_int l_err;
+                ::cl::Kernel kernel(
+                    program,
+                    name.c_str(),
+                    &l_err);
+                V_OPENCL( l_err, "Kernel::constructor() failed" );
+                entry.reset( new PooledKernel );
+                entry->kernel = kernel;
+                instances.push_back( entry );
+                {
+                    boost::lock_guard< boost::mutex > lock( kernelCreationMutex );
+                    ++kernelCreationCount;
+                }
+            }
+
+            entry->inUse = true;
+            return entry;
+        }
+
+        PooledKernels createKernels(
+            const ::cl::Program& program,
+            const ::std::vector< ::std::string >& kernelNames )
+        {
+            ::std::vector< ::cl::Kernel > kernels;
+            ReturnKernels checkout;
+            for (size_t i = 0; i < kernelNames.size() ; i++)
+            {
+                try
+                {
+                    boost::shared_ptr< PooledKernel > entry = acquirePooledKernel( program, kernelNames[i] );
+                    checkout.add( entry );
+                    kernels.push_back( entry->kernel );
+                }
+                catch( const ::cl::Error& e)
+                {
+                    std::cerr << hr << std::endl;
+                    std::cerr << es << "::cl::Kernel() in bolt::cl::acquireKernels()" << std::endl;
+                    std::cerr << es << "Error Code:   " << clErrorStringA(e.err()) << " (" << e.err() << ")" << std::endl;
+                    std::cerr << es << "File:         " << __FILE__ << ", line " << __LINE__ << std::endl;
+                    std::cerr << es << "Error String: " << e.what() << std::endl;
+                    std::cerr << hr << std::endl;
+                }
+            }
+            return PooledKernels( kernels, boost::shared_ptr< void >( static_cast< void* >( NULL ), checkout ) );
+        }
+    }
+
     /**************************************************************************
      * Compile Kernel from primitive information
      *************************************************************************/
@@ -455,7 +716,7 @@ namespace bolt {
     * - takes into account control
     * - requests program/kernel from ProgramMap
     **************************************************************************/
-    ::std::vector< ::cl::Kernel > getKernels(
+    PooledKernels getKernels(
         const control&      ctl,
         const std::vector<std::string>& typeNames,
         const KernelTemplateSpecializer * const kts,
@@ -463,6 +724,21 @@ namespace bolt {
         const std::string&  kernelString,
         const std::string&  options )
     {
+        // fast path; the debug modes that print or save the kernel string need the slow path on every call
+        const unsigned slowPathModes = control::debug::Compile | control::debug::SaveCompilerTemps |
+            control::debug::NoKernelCache;
+        const bool useKernelCache = ( ctl.getDebugMode( ) & slowPathModes ) == 0;
+        KernelCacheKey kernelCacheKey;
+        if( useKernelCache )
+        {
+            kernelCacheKey = makeKernelCacheKey( ctl, typeNames, kts, typeDefs, kernelString, options );
+
+            boost::shared_lock< boost::shared_mutex > readLock( kernelCacheGuard );
+            KernelCache::iterator iter = kernelCache.find( kernelCacheKey );
+            if( iter != kernelCache.end( ) )
+                return createKernels( iter->second.program, iter->second.kernelNames );
+        }
+
         std::string completeKernelString;
         /* In device vector.h functional.h and bolt.h the defintions of cl_* are given. These cl_* are typedef'd
          * to there corresponding types in cl_platforms.h. To the kernel Actually the cl_* are passed, But the OpenCL
@@ -526,39 +802,66 @@ namespace bolt {
 
         // retrieve kernels from program
         //std::cout << "Getting " << kts->numKernels() << " from program." << std::endl;
-        ::std::vector< ::cl::Kernel > kernels;
+        ::std::vector< ::std::string > kernelNames;
         for (unsigned int i = 0; i < kts->numKernels() ; i++)
         {
-            ::std::string name = kts->name(i);
-            name += "Instantiated";
-            try
+            kernelNames.push_back( kts->name(i) + "Instantiated" );
+        }
+
+        if( useKernelCache )
+        {
+            KernelCacheValue value = { program, kernelNames };
+            boost::unique_lock< boost::shared_mutex > writeLock( kernelCacheGuard );
+            kernelCache.insert( std::make_pair( kernelCacheKey, value ) );
+        }
+
+        return createKernels( program, kernelNames );
+    }
+
+    namespace
+    {
+        // number of programs currently being built by acquireProgram, across all shards
+        boost::mutex buildsInProgressMutex;
+        size_t buildsInProgress = 0;
+
+        struct BuildInProgress
+        {
+            BuildInProgress( )
             {
-                cl_int l_err;
-                ::cl::Kernel kernel(
-                    program,
-                    name.c_str(),
-                    &l_err);
-                V_OPENCL( l_err, "Kernel::constructor() failed" );
-                kernels.push_back(kernel);
+                boost::lock_guard< boost::mutex > lock( buildsInProgressMutex );
+                ++buildsInProgress;
             }
-            catch( const ::cl::Error& e)
+
+            ~BuildInProgress( )
             {
-                std::cerr << hr << std::endl;
-                std::cerr << es << "::cl::Kernel() in bolt::cl::acquireKernels()" << std::endl;
-                std::cerr << es << "Error Code:   " << clErrorStringA(e.err()) << " (" << e.err() << ")" << std::endl;
-                std::cerr << es << "File:         " << __FILE__ << ", line " << __LINE__ << std::endl;
-                std::cerr << es << "Error String: " << e.what() << std::endl;
-                std::cerr << hr << std::endl;
+                boost::lock_guard< boost::mutex > lock( buildsInProgressMutex );
+                --buildsInProgress;
             }
+        };
+
+        std::string deviceString( const ::cl::Device& device )
+        {
+            std::string deviceStr = device.getInfo< CL_DEVICE_NAME >( );
+            deviceStr += "; " + device.getInfo< CL_DEVICE_VERSION >( );
+            deviceStr += "; " + device.getInfo< CL_DEVICE_VENDOR >( );
+            return deviceStr;
         }
 
-        return kernels;
+        ProgramMapShard& programMapShard( const ProgramMapKey& key )
+        {
+            cl_ulong hash = hashString( key.device );
+            hash = hashString( key.compileOptions, hash );
+            hash = hashString( key.kernelSource, hash );
+            return programMap[ hash % programMapShardCount ];
+        }
     }
 
     /**************************************************************************
      * aquireKernels
      * - returns kernels from ProgramMap if exist
      * - otherwise compiles program/kernels, adds to map, then returns
+     * - the first thread to miss on a key builds it outside of any lock;
+     *   other threads wanting the same program wait on its future
      *************************************************************************/
     ::cl::Program acquireProgram(
         const ::cl::Context& context,
@@ -566,33 +869,133 @@ namespace bolt {
         const ::std::string& options,
         const ::std::string& source)
     {
-        // only one threads get to seach and retrieve-or-compile at a time
-        boost::lock_guard< boost::mutex > lock( ::bolt::cl::programMapMutex ); // unlocks upon return
         cl_int l_err;
 
         // Does Program already exist?
-        std::string deviceStr = device.getInfo< CL_DEVICE_NAME >( );
-        deviceStr += "; " + device.getInfo< CL_DEVICE_VERSION >( );
-        deviceStr += "; " + device.getInfo< CL_DEVICE_VENDOR >( );
+        std::string deviceStr = deviceString( device );
         ProgramMapKey key = {context, deviceStr, options, source};
-        ProgramMap::iterator iter = programMap.find( key );
-        ::cl::Program program;
+        ProgramMapShard& shard = programMapShard( key );
+        boost::shared_future< ::cl::Program > future;
+        {
+            boost::shared_lock< boost::shared_mutex > readLock( shard.guard );
+            ProgramMap::iterator iter = shard.programs.find( key );
+            if( iter != shard.programs.end( ) )
+                future = iter->second.program;
+        }
+        if( future.valid( ) ) // map already contains desired program, or another thread is building it
+        {
+            return future.get( );
+        }
 
-        // map does not yet contain desired program
-        if( iter == programMap.end( ) )
+        // map does not yet contain desired program; claim the build unless another thread beat us to it
+        boost::promise< ::cl::Program > promise;
+        bool builder = false;
         {
-            program = ::bolt::cl::compileProgram(context, device, options, source, &l_err);
-            V_OPENCL( l_err, "bolt::cl::compileProgram() failed" );
-            ProgramMapValue value = { program };
-            programMap.insert( std::make_pair( key, value ) );
+            boost::unique_lock< boost::shared_mutex > writeLock( shard.guard );
+            ProgramMap::iterator iter = shard.programs.find( key );
+            if( iter == shard.programs.end( ) )
+            {
+                ProgramMapValue value;
+                value.program = boost::shared_future< ::cl::Program >( promise.get_future( ) );
+                shard.programs.insert( std::make_pair( key, value ) );
+                future = value.program;
+                builder = true;
+            }
+            else
+            {
+                future = iter->second.program;
+            }
         }
-        else // map already contains desired kernel
+
+        if( builder )
         {
-            program = iter->second.program;
+            BuildInProgress building;
+            try
+            {
+                // try the on-disk binary cache before paying for a source compile
+                ::cl::Program program = ::bolt::cl::loadProgramBinary(context, device, deviceStr, options, source);
+                if( program() == NULL )
+                {
+                    program = ::bolt::cl::compileProgram(context, device, options, source, &l_err);
+                    V_OPENCL( l_err, "bolt::cl::compileProgram() failed" );
+                    ::bolt::cl::storeProgramBinary(program, device, deviceStr, options, source);
+                }
+                promise.set_value( program );
+            }
+            catch( const ::cl::Error& e )
+            {
+                // forget the failed build so that a later call may retry, then wake up the waiters with the error
+                {
+                    boost::unique_lock< boost::shared_mutex > writeLock( shard.guard );
+                    shard.programs.erase( key );
+                }
+                promise.set_exception( boost::copy_exception( e ) );
+            }
+            catch( ... )
+            {
+                {
+                    boost::unique_lock< boost::shared_mutex > writeLock( shard.guard );
+                    shard.programs.erase( key );
+                }
+                promise.set_exception( boost::current_exception( ) );
+            }
         }
-        return program;
+
+        return future.get( );
     } // aquireProgram
 
+    size_t programBuildsInProgress( )
+    {
+        boost::lock_guard< boost::mutex > lock( buildsInProgressMutex );
+        return buildsInProgress;
+    }
+
+    bool isProgramBuildPending(
+        const ::cl::Context& context,
+        const ::cl::Device&  device,
+        const ::std::string& options,
+        const ::std::string& source)
+    {
+        ProgramMapKey key = {context, deviceString( device ), options, source};
+        ProgramMapShard& shard = programMapShard( key );
+
+        boost::shared_lock< boost::shared_mutex > readLock( shard.guard );
+        ProgramMap::iterator iter = shard.programs.find( key );
+        return ( iter != shard.programs.end( ) ) && !iter->second.program.is_ready( );
+    }
+
+    size_t getKernelCreationCount( )
+    {
+        boost::lock_guard< boost::mutex > lock( kernelCreationMutex );
+        return kernelCreationCount;
+    }
+
+    void clearKernelPool( )
+    {
+        kernelPool.reset( );
+    }
+
+    void clearProgramMap( )
+    {
+        {
+            boost::unique_lock< boost::shared_mutex > writeLock( kernelCacheGuard );
+            kernelCache.clear( );
+        }
+
+        for( size_t i = 0; i < programMapShardCount; ++i )
+        {
+            boost::unique_lock< boost::shared_mutex > writeLock( programMap[ i ].guard );
+            ProgramMap& programs = programMap[ i ].programs;
+            for( ProgramMap::iterator iter = programs.begin( ); iter != programs.end( ); )
+            {
+                if( iter->second.program.is_ready( ) )
+                    programs.erase( iter++ );
+                else
+                    ++iter;
+            }
+        }
+    }
+
     /**************************************************************************
     * compileProgram
     * - compiles OpenCL kernel string and returns Program object
@@ -642,8 +1045,103 @@ namespace bolt {
 
 
         // externed in bolt.h
-        boost::mutex programMapMutex;
-        ProgramMap programMap;
+        ProgramMapShard programMap[ programMapShardCount ];
+
+        /**************************************************************************
+        * Single pass scan
+        **************************************************************************/
+        namespace
+        {
+            //  Bytes of local memory a single pass tile may take; beyond this too few work groups fit on a compute unit
+            //  for the look-back to hide its latency
+            const size_t singlePassScanTileBytes = 16 * 1024;
+            const cl_uint singlePassScanMaxItems = 8;
+
+            struct ScanDeviceInfo
+            {
+                bool singlePass;        // GPU with OpenCL 1.2 or later
+                cl_ulong localMemSize;
+            };
+
+            boost::mutex scanDeviceInfoMutex;
+            std::map< cl_device_id, ScanDeviceInfo > scanDeviceInfo;
+
+            ScanDeviceInfo getScanDeviceInfo( const ::cl::Device& device )
+            {
+                boost::lock_guard< boost::mutex > lock( scanDeviceInfoMutex );
+                std::map< cl_device_id, ScanDeviceInfo >::iterator iter = scanDeviceInfo.find( device( ) );
+                if( iter != scanDeviceInfo.end( ) )
+                    return iter->second;
+
+                //  CL_DEVICE_VERSION reads "OpenCL <major>.<minor> <vendor specific>"
+                std::string version = device.getInfo< CL_DEVICE_VERSION >( );
+                int major = 0, minor = 0;
+                sscanf( version.c_str( ), "OpenCL %d.%d", &major, &minor );
+
+                ScanDeviceInfo info;
+                info.singlePass = ( device.getInfo< CL_DEVICE_TYPE >( ) & CL_DEVICE_TYPE_GPU ) != 0 &&
+                    ( major > 1 || ( major == 1 && minor >= 2 ) );
+                info.localMemSize = device.getInfo< CL_DEVICE_LOCAL_MEM_SIZE >( );
+                scanDeviceInfo[ device( ) ] = info;
+                return info;
+            }
+        }
+
+        cl_uint singlePassScanItems( const control& ctl, size_t valueBytes, size_t elementBytes, size_t workGroupSize )
+        {
+            if( ( ctl.getDebugMode( ) & control::debug::MultiPassScan ) || valueBytes == 0 || valueBytes % sizeof( cl_uint ) )
+                return 0;
+
+            ScanDeviceInfo info = getScanDeviceInfo( ctl.getDevice( ) );
+            if( !info.singlePass )
+                return 0;
+
+            size_t items = singlePassScanTileBytes / ( workGroupSize * elementBytes );
+            items = std::min< size_t >( std::max< size_t >( items, 1 ), singlePassScanMaxItems );
+
+            //  The tile plus one partial sum per work item, and the carry, have to fit
+            if( ( ( items + 1 ) * workGroupSize + 1 ) * elementBytes > info.localMemSize )
+                return 0;
+
+            return static_cast< cl_uint >( items );
+        }
+
+        control::buffPointer acquireScanTileStatus( control& ctl, cl_uint tileCount )
+        {
+            control::buffPointer status = ctl.acquireBuffer( ( tileCount + 1 ) * sizeof( cl_uint ) );
+            V_OPENCL( ctl.getCommandQueue( ).enqueueFillBuffer( *status, cl_uint( 0 ), 0,
+                ( tileCount + 1 ) * sizeof( cl_uint ) ), "Error clearing the scan tile status" );
+            return status;
+        }
+
+        /**************************************************************************
+        * Asynchronous algorithms
+        **************************************************************************/
+        namespace
+        {
+            typedef std::pair< cl_context, cl_device_id > asyncQueueKey;
+
+            boost::mutex asyncQueueMutex;
+            std::map< asyncQueueKey, ::cl::CommandQueue > asyncQueues; // each queue retains its context
+        }
+
+        ::cl::CommandQueue getAsyncQueue( const control& ctl )
+        {
+            ::cl::Context myContext = ctl.getContext( );
+            ::cl::Device myDevice = ctl.getDevice( );
+
+            boost::lock_guard< boost::mutex > lock( asyncQueueMutex );
+            ::cl::CommandQueue& queue = asyncQueues[ asyncQueueKey( myContext( ), myDevice( ) ) ];
+            if( queue( ) == NULL )
+            {
+                cl_command_queue_properties myProperties = ctl.getCommandQueue( ).getInfo< CL_QUEUE_PROPERTIES >( );
+                cl_int l_Error = CL_SUCCESS;
+                queue = ::cl::CommandQueue( myContext, myDevice,
+                    myProperties & ~CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &l_Error );
+                V_OPENCL( l_Error, "failed to create the queue of the asynchronous algorithms" );
+            }
+            return queue;
+        }
 
 
     }; //namespace bolt::cl
@@ -19,6 +19,8 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <vector>
+#include <cstring>
 // #include <atomic>
 
 #include "bolt/cl/bolt.h"
@@ -442,75 +444,500 @@ namespace cl
 
     }
 
-    size_t control::totalBufferSize( )
+    control::bufferPool::bufferPool( ): m_bufferPoolSize( 0 ), m_bufferClock( 0 ), m_functorNext( 0 ),
+        m_functorQueue( NULL )
     {
-        size_t totalSize = 0;
+        bufferPoolStats zero = { 0, 0, 0, 0 };
+        m_bufferStats = zero;
+    };
 
-        for( mapBufferType::iterator it = mapBuffer.begin( ); it != mapBuffer.end( ); ++it )
+    control::bufferPool::~bufferPool( )
+    {
+        //  A functor write still in flight reads the host copy of its slot.  The default control is destroyed at
+        //  exit, possibly after the OpenCL runtime
+        try
         {
-            totalSize += it->second.buffSize;
+            waitFunctorWrites( );
         }
+        catch( ... )
+        {
+        }
+    };
 
-        return totalSize;
+    size_t control::totalBufferSize( )
+    {
+        boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
+
+        return m_pool->m_bufferPoolSize;
     };
 
-    control::buffPointer control::acquireBuffer( size_t reqSize, cl_mem_flags flags, const void* host_ptr )
+    size_t control::bufferSizeClass( size_t reqSize )
     {
-        boost::lock_guard< boost::mutex > lock( mapGuard );
+        //  Four geometric steps per power of two keeps the worst case waste at 25%, while still letting sizes that
+        //  differ by a few elements share a buffer
+        const size_t minClass = 256;
+        if( reqSize <= minClass )
+            return minClass;
+
+        size_t pow2 = minClass;
+        while( pow2 * 2 < reqSize )
+            pow2 *= 2;
+
+        size_t step = pow2 / 4;
+        return ( ( reqSize + step - 1 ) / step ) * step;
+    }
 
+    control::buffPointer control::acquireBuffer( size_t reqSize, cl_mem_flags flags, const void* host_ptr )
+    {
         ::cl::Context myContext = m_commandQueue.getInfo< CL_QUEUE_CONTEXT >( );
 
-        descBufferKey myDesc = { myContext, flags , host_ptr };
-        mapBufferType::iterator itLowerBound = mapBuffer.find( myDesc );
-        if( itLowerBound == mapBuffer.end( ) || host_ptr != NULL )
+        //  A buffer that aliases host memory belongs to that memory; it can never be handed to another caller
+        if( flags & CL_MEM_USE_HOST_PTR )
         {
-            ::cl::Buffer tmp( myContext, flags, reqSize, const_cast< void*>( host_ptr ) );
-            descBufferValue myValue = { reqSize, true, tmp };
-            mapBufferType::iterator itInserted = mapBuffer.insert( std::make_pair( myDesc, myValue ) );
+            return buffPointer( new ::cl::Buffer( myContext, flags, reqSize, const_cast< void* >( host_ptr ) ) );
+        }
 
-            buffPointer buffPtr( &(itInserted->second.buffBuff), UnlockBuffer( *this, itInserted ) );
-            return buffPtr;
+        //  Pooled buffers are filled explicitly below, so that they can be shared between different host pointers
+        cl_mem_flags poolFlags = flags & ~static_cast< cl_mem_flags >( CL_MEM_COPY_HOST_PTR );
+        size_t classSize = bufferSizeClass( reqSize );
+
+        boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
+
+        //  Best fit: the smallest idle buffer of at least the class size, as long as it is not more than twice as
+        //  big; a larger buffer is better left for a larger request
+        descBufferKey myDesc = { myContext, poolFlags, classSize };
+        descBufferKey maxDesc = { myContext, poolFlags, 2 * classSize };
+        mapBufferType::iterator itBuffer = m_pool->mapBuffer.lower_bound( myDesc );
+        mapBufferType::iterator itLast = m_pool->mapBuffer.upper_bound( maxDesc );
+
+        for( ; itBuffer != itLast; ++itBuffer )
+        {
+            if( itBuffer->second.inUse == false )
+                break;
         }
 
-        for( ; itLowerBound != mapBuffer.upper_bound( myDesc ); ++itLowerBound )
+        if( itBuffer != itLast )
         {
-            //  If the current buffer is already being used, keep searching
-            if( itLowerBound->second.inUse == true )
-                continue;
+            ++m_pool->m_bufferStats.hits;
+        }
+        else
+        {
+            ++m_pool->m_bufferStats.misses;
 
-            if( itLowerBound->second.buffSize >= reqSize )
+            ::cl::Buffer tmp;
+            try
             {
-                itLowerBound->second.inUse = true;
-                buffPointer buffPtr( &(itLowerBound->second.buffBuff), UnlockBuffer( *this, itLowerBound ) );
-				::cl::Buffer &tmp = *buffPtr;
-				if( host_ptr!= NULL)
-					m_commandQueue.enqueueWriteBuffer(tmp,false,0,reqSize,host_ptr);
-                return buffPtr;
+                tmp = ::cl::Buffer( myContext, poolFlags, classSize );
+            }
+            catch( const ::cl::Error& e )
+            {
+                if( e.err( ) != CL_MEM_OBJECT_ALLOCATION_FAILURE && e.err( ) != CL_OUT_OF_RESOURCES )
+                    throw;
+
+                //  Idle buffers may be what is holding the device memory; give it all back and try once more
+                m_pool->trimIdleBuffers( 0 );
+                tmp = ::cl::Buffer( myContext, poolFlags, classSize );
             }
 
-            //  If here, we found a buffer with the appropriate flags, but not big enough.  Delete the old 
-            //  buffer and then create a bigger one to take it's place.
+            descBufferValue myValue = { true, 0, tmp };
+            itBuffer = m_pool->mapBuffer.insert( std::make_pair( myDesc, myValue ) );
 
-            mapBuffer.erase( itLowerBound );
-            break;
+            m_pool->m_bufferPoolSize += classSize;
+            m_pool->m_bufferStats.peakSize = std::max( m_pool->m_bufferStats.peakSize, m_pool->m_bufferPoolSize );
+
+            if( m_bufferHighWaterMark != 0 && m_pool->m_bufferPoolSize > m_bufferHighWaterMark )
+                m_pool->trimIdleBuffers( m_bufferHighWaterMark );
         }
 
-        //  If here, either all available buffers are currently in use, or we need to replace an existing buffer
-        // create a new buffer and add it to the map
-        ::cl::Buffer tmp( myContext, flags, reqSize, const_cast< void* >( host_ptr ) );
-        descBufferValue myValue = { reqSize, true, tmp };
+        itBuffer->second.inUse = true;
+        buffPointer buffPtr( &(itBuffer->second.buffBuff), UnlockBuffer( m_pool, itBuffer, m_bufferHighWaterMark ) );
+
+        //  The caller may hand us a temporary, so the copy has to finish before we return
+        if( host_ptr != NULL )
+            V_OPENCL( m_commandQueue.enqueueWriteBuffer( *buffPtr, CL_TRUE, 0, reqSize, host_ptr ),
+                "enqueueWriteBuffer( ) failed to fill a pooled buffer" );
 
-        mapBufferType::iterator itInserted = mapBuffer.insert( std::make_pair( myDesc, myValue ) );
-        buffPointer buffPtr( &(itInserted->second.buffBuff), UnlockBuffer( *this, itInserted ) );
         return buffPtr;
     };
 
+    void control::bufferPool::trimIdleBuffers( size_t targetSize )
+    {
+        while( m_bufferPoolSize > targetSize )
+        {
+            mapBufferType::iterator itOldest = mapBuffer.end( );
+            for( mapBufferType::iterator it = mapBuffer.begin( ); it != mapBuffer.end( ); ++it )
+            {
+                if( it->second.inUse )
+                    continue;
+                if( itOldest == mapBuffer.end( ) || it->second.lastUse < itOldest->second.lastUse )
+                    itOldest = it;
+            }
+
+            //  Everything left is in use; the pool shrinks further as those buffers come back
+            if( itOldest == mapBuffer.end( ) )
+                break;
+
+            m_bufferPoolSize -= itOldest->first.buffSize;
+            ++m_bufferStats.evictions;
+            mapBuffer.erase( itOldest );
+        }
+    };
+
+    void control::trimBuffers( size_t targetSize )
+    {
+        boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
+
+        m_pool->trimIdleBuffers( targetSize );
+    };
+
+    void control::prewarmBuffers( size_t reqSize, size_t count, cl_mem_flags flags )
+    {
+        //  Hold every buffer until all are created, otherwise each acquire would hand back the previous one
+        std::vector< buffPointer > warm;
+        warm.reserve( count );
+        for( size_t i = 0; i < count; ++i )
+            warm.push_back( acquireBuffer( reqSize, flags ) );
+    };
+
+    control::bufferPoolStats control::getBufferPoolStats( )
+    {
+        boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
+
+        return m_pool->m_bufferStats;
+    };
+
+    control::buffPointer control::acquireFunctorBuffer( const void* functor, size_t size, bool stateless )
+    {
+        if( size > functorSlotSize )
+            return acquireBuffer( size, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, functor );
+
+        boost::unique_lock< boost::mutex > lock( m_pool->mapGuard );
+
+        //  The ring relies on the queue running its commands in order, so it is rebuilt whenever the control is
+        //  given a different queue; that has to wait until no caller holds a slot of the old ring
+        if( m_pool->m_functorQueue != m_commandQueue( ) )
+        {
+            for( size_t i = 0; i < m_pool->m_functorRing.size( ); ++i )
+            {
+                if( m_pool->m_functorRing[ i ].inUse )
+                {
+                    lock.unlock( );
+                    return acquireBuffer( size, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, functor );
+                }
+            }
+
+            ::cl::Context myContext = m_commandQueue.getInfo< CL_QUEUE_CONTEXT >( );
+            cl_command_queue_properties myProperties = m_commandQueue.getInfo< CL_QUEUE_PROPERTIES >( );
+
+            m_pool->waitFunctorWrites( );
+            m_pool->m_functorRing.clear( );
+            if( ( myProperties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE ) == 0 )
+            {
+                m_pool->m_functorRing.resize( functorSlotCount );
+                for( size_t i = 0; i < m_pool->m_functorRing.size( ); ++i )
+                    m_pool->m_functorRing[ i ].inUse = false;
+            }
+            m_pool->m_statelessFunctor = ::cl::Buffer( myContext, CL_MEM_READ_ONLY, functorSlotSize );
+            m_pool->m_functorQueue = m_commandQueue( );
+            m_pool->m_functorNext = 0;
+        }
+
+        //  Nothing is ever read from an empty functor, so there is nothing to upload
+        if( stateless )
+            return buffPointer( new ::cl::Buffer( m_pool->m_statelessFunctor ) );
+
+        for( size_t tries = 0; tries < m_pool->m_functorRing.size( ); ++tries )
+        {
+            size_t slot = m_pool->m_functorNext;
+            m_pool->m_functorNext = ( m_pool->m_functorNext + 1 ) % m_pool->m_functorRing.size( );
+
+            functorSlot& mySlot = m_pool->m_functorRing[ slot ];
+            if( mySlot.inUse )
+                continue;
+
+            if( mySlot.buffBuff( ) == NULL )
+            {
+                mySlot.buffBuff = ::cl::Buffer( m_commandQueue.getInfo< CL_QUEUE_CONTEXT >( ), CL_MEM_READ_ONLY,
+                    functorSlotSize );
+            }
+
+            //  A slot in use keeps the ring from being rebuilt, so the rest runs without holding up other callers
+            mySlot.inUse = true;
+            buffPointer buffPtr( new ::cl::Buffer( mySlot.buffBuff ), ReleaseFunctorSlot( m_pool, slot ) );
+            lock.unlock( );
+
+            //  Kernels that read the previous contents were enqueued before this write, so only the host copy needs
+            //  protecting; by the time the ring comes round, that write has almost always finished
+            if( mySlot.written( ) != NULL )
+                V_OPENCL( mySlot.written.wait( ), "failed to wait for a functor slot" );
+
+            ::memcpy( mySlot.hostCopy, functor, size );
+            V_OPENCL( m_commandQueue.enqueueWriteBuffer( mySlot.buffBuff, CL_FALSE, 0, size, mySlot.hostCopy, NULL,
+                &mySlot.written ), "enqueueWriteBuffer( ) failed to upload a functor" );
+
+            return buffPtr;
+        }
+
+        //  Every slot is held by a caller, or the queue runs out of order
+        lock.unlock( );
+        return acquireBuffer( size, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, functor );
+    };
+
+    void control::bufferPool::waitFunctorWrites( )
+    {
+        for( size_t i = 0; i < m_functorRing.size( ); ++i )
+        {
+            if( m_functorRing[ i ].written( ) != NULL )
+                V_OPENCL( m_functorRing[ i ].written.wait( ), "failed to wait for a functor slot" );
+        }
+    };
+
+    bool control::zeroCopyHostRange( const void* host_ptr ) const
+    {
+        if( m_hostTransfer == ZeroCopyTransfer || m_commandQueue( ) == NULL )
+            return true;
+        if( m_hostTransfer == StagedTransfer )
+            return false;
+
+        //  A device that shares memory with the host can use a range in place when it starts on the device's base
+        //  address alignment; the runtime can only let a discrete device read host memory in place by the page
+        ::cl::Device myDevice = getDevice( );
+        size_t alignment = myDevice.getInfo< CL_DEVICE_MEM_BASE_ADDR_ALIGN >( ) / 8;
+        if( !myDevice.getInfo< CL_DEVICE_HOST_UNIFIED_MEMORY >( ) )
+            alignment = std::max< size_t >( alignment, 4096 );
+
+        return alignment == 0 || ( reinterpret_cast< size_t >( host_ptr ) % alignment ) == 0;
+    };
+
+    control::hostStaging::hostStaging( size_t chunkSize ): m_chunkSize( std::max< size_t >( chunkSize, 4096 ) ),
+        m_inOrder( true ), m_next( 0 )
+    {
+        hostTransferStats zero = { 0, 0, 0 };
+        m_stats = zero;
+    };
+
+    control::hostStaging::~hostStaging( )
+    {
+        //  The default control is destroyed at exit, possibly after the OpenCL runtime
+        try
+        {
+            releaseRing( );
+        }
+        catch( ... )
+        {
+        }
+    };
+
+    void control::hostStaging::bindRing( const ::cl::CommandQueue& queue )
+    {
+        if( !m_ring.empty( ) && m_queue( ) == queue( ) )
+            return;
+
+        releaseRing( );
+
+        ::cl::Context myContext = queue.getInfo< CL_QUEUE_CONTEXT >( );
+        cl_command_queue_properties myProperties = queue.getInfo< CL_QUEUE_PROPERTIES >( );
+
+        m_ring.resize( stagingSlotCount );
+        for( size_t i = 0; i < m_ring.size( ); ++i )
+        {
+            cl_int l_Error = CL_SUCCESS;
+            m_ring[ i ].pinned = ::cl::Buffer( myContext, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, m_chunkSize );
+            m_ring[ i ].host = queue.enqueueMapBuffer( m_ring[ i ].pinned, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0,
+                m_chunkSize, NULL, NULL, &l_Error );
+            V_OPENCL( l_Error, "enqueueMapBuffer( ) failed to map a staging slot" );
+        }
+        m_queue = queue;
+        m_inOrder = ( myProperties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE ) == 0;
+        m_next = 0;
+    };
+
+    void control::hostStaging::releaseRing( )
+    {
+        if( m_ring.empty( ) )
+            return;
+
+        for( size_t i = 0; i < m_ring.size( ); ++i )
+        {
+            if( m_ring[ i ].done( ) != NULL )
+                m_ring[ i ].done.wait( );
+            m_queue.enqueueUnmapMemObject( m_ring[ i ].pinned, m_ring[ i ].host );
+        }
+        m_queue.finish( );
+        m_ring.clear( );
+    };
+
+    void control::hostStaging::toDevice( const ::cl::CommandQueue& queue, const ::cl::Buffer& buffer, size_t offset,
+        const void* src, size_t bytes )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        bindRing( queue );
+
+        const char* from = static_cast< const char* >( src );
+        for( size_t done = 0; done < bytes; done += m_chunkSize )
+        {
+            slot& mySlot = m_ring[ m_next ];
+            m_next = ( m_next + 1 ) % m_ring.size( );
+
+            //  The other slots' writes are still in flight while this one is filled
+            if( mySlot.done( ) != NULL )
+                V_OPENCL( mySlot.done.wait( ), "failed to wait for a staging slot" );
+
+            size_t chunk = std::min( m_chunkSize, bytes - done );
+            ::memcpy( mySlot.host, from + done, chunk );
+            V_OPENCL( m_queue.enqueueWriteBuffer( buffer, m_inOrder ? CL_FALSE : CL_TRUE, offset + done, chunk,
+                mySlot.host, NULL, &mySlot.done ), "enqueueWriteBuffer( ) failed to upload a staged chunk" );
+            V_OPENCL( m_queue.flush( ), "failed to flush the staging queue" );
+            ++m_stats.stagedChunks;
+        }
+        m_stats.bytesCopied += bytes;
+    };
+
+    void control::hostStaging::toHost( const ::cl::CommandQueue& queue, const ::cl::Buffer& buffer, size_t offset,
+        void* dst, size_t bytes )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        bindRing( queue );
+
+        //  The reads are drained in the order they are issued, starting from the first slot
+        for( size_t i = 0; i < m_ring.size( ); ++i )
+        {
+            if( m_ring[ i ].done( ) != NULL )
+                V_OPENCL( m_ring[ i ].done.wait( ), "failed to wait for a staging slot" );
+        }
+
+        char* to = static_cast< char* >( dst );
+        size_t depth = m_ring.size( );
+        size_t chunks = ( bytes + m_chunkSize - 1 ) / m_chunkSize;
+
+        //  Keeps depth reads in flight: chunk k - depth is copied out of its slot as soon as it has landed, and the
+        //  slot is reissued for chunk k
+        for( size_t k = 0; k < chunks + depth; ++k )
+        {
+            if( k >= depth )
+            {
+                size_t j = k - depth;
+                slot& mySlot = m_ring[ j % depth ];
+                V_OPENCL( mySlot.done.wait( ), "failed to wait for a staging slot" );
+                ::memcpy( to + j * m_chunkSize, mySlot.host, std::min( m_chunkSize, bytes - j * m_chunkSize ) );
+            }
+            if( k < chunks )
+            {
+                slot& mySlot = m_ring[ k % depth ];
+                V_OPENCL( m_queue.enqueueReadBuffer( buffer, CL_FALSE, offset + k * m_chunkSize,
+                    std::min( m_chunkSize, bytes - k * m_chunkSize ), mySlot.host, NULL, &mySlot.done ),
+                    "enqueueReadBuffer( ) failed to download a staged chunk" );
+                V_OPENCL( m_queue.flush( ), "failed to flush the staging queue" );
+                ++m_stats.stagedChunks;
+            }
+        }
+        m_next = 0;
+        m_stats.bytesCopied += bytes;
+    };
+
+    void control::hostStaging::mapped( size_t bytes )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        m_stats.bytesMapped += bytes;
+    };
+
+    void control::hostStaging::setChunkSize( size_t bytes )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        bytes = std::max< size_t >( bytes, 4096 );
+        if( bytes == m_chunkSize )
+            return;
+
+        //  The slots are sized to the chunk, so the ring is built again on the next transfer
+        releaseRing( );
+        m_chunkSize = bytes;
+    };
+
+    size_t control::hostStaging::getChunkSize( )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        return m_chunkSize;
+    };
+
+    control::hostTransferStats control::hostStaging::getStats( )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        return m_stats;
+    };
+
+    void control::hostStaging::resetStats( )
+    {
+        boost::lock_guard< boost::mutex > lock( m_guard );
+
+        hostTransferStats zero = { 0, 0, 0 };
+        m_stats = zero;
+    };
+
+    namespace
+    {
+        //  Function statics, so that the settings exist before any control, including the default one
+        boost::mutex& multiCoreGuard( )
+        {
+            static boost::mutex guard;
+            return guard;
+        }
+
+        control::multiCoreSettings& multiCoreState( )
+        {
+            static control::multiCoreSettings settings = { 0, std::vector< int >( ), 0 };
+            return settings;
+        }
+    }
+
+    void control::setMultiCoreThreads( int threads )
+    {
+        boost::lock_guard< boost::mutex > lock( multiCoreGuard( ) );
+
+        multiCoreSettings& settings = multiCoreState( );
+        if( settings.threads == threads )
+            return;
+        settings.threads = threads;
+        ++settings.revision;
+    }
+
+    void control::setMultiCoreAffinity( const std::vector< int >& processors )
+    {
+        boost::lock_guard< boost::mutex > lock( multiCoreGuard( ) );
+
+        multiCoreSettings& settings = multiCoreState( );
+        if( settings.affinity == processors )
+            return;
+        settings.affinity = processors;
+        ++settings.revision;
+    }
+
+    control::multiCoreSettings control::getMultiCoreSettings( )
+    {
+        boost::lock_guard< boost::mutex > lock( multiCoreGuard( ) );
+
+        return multiCoreState( );
+    }
+
+    size_t control::getMultiCoreRevision( )
+    {
+        boost::lock_guard< boost::mutex > lock( multiCoreGuard( ) );
+
+        return multiCoreState( ).revision;
+    }
+
     void control::freeBuffers( )
     {
         //  std::multimap is not thread-safe; lock the map when clearing it out
-        boost::lock_guard< boost::mutex > lock( mapGuard );
+        boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
 
-        mapBuffer.clear( );
+        m_pool->mapBuffer.clear( );
+        m_pool->m_bufferPoolSize = 0;
     };
 
 }
@@ -0,0 +1,481 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+/******************************************************************************
+ * Automatic Dispatch
+ * Every Automatic call is timed, and the times are fitted per device, per
+ * algorithm and value type, and per path to t = fixed + perElement * n.  The
+ * path with the lowest predicted time plus data movement wins; paths with no
+ * measurements are tried on calls small enough that a bad guess is cheap.
+ * Models age by halving their sums once they hold enough samples, so they
+ * follow a machine whose load changes.
+ *****************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+#include <boost/chrono.hpp>
+
+#include "bolt/cl/dispatch.h"
+
+namespace bolt {
+    namespace cl {
+
+    namespace
+    {
+        const size_t    dispatchPathCount = 3;      // SerialCpu, MultiCoreCpu, OpenCL
+        const double    dispatchWarmupSamples = 1;  // the first call of a path pays for compiles and thread start-up
+        const double    dispatchMinSamples = 2;
+        const double    dispatchMaxSamples = 64;
+        const size_t    dispatchDefaultExplorationLimit = 1 << 20;
+        const size_t    transferProbeBytes = 4 * 1024 * 1024;
+
+        //  Running sums for a least squares fit of seconds against elements
+        struct LinearFit
+        {
+            LinearFit( ): warmup( 0 ), count( 0 ), sumN( 0 ), sumT( 0 ), sumNN( 0 ), sumNT( 0 )
+            {}
+
+            void add( double n, double t )
+            {
+                if( warmup < dispatchWarmupSamples )
+                {
+                    ++warmup;
+                    return;
+                }
+
+                if( count >= dispatchMaxSamples )
+                {
+                    count *= 0.5; sumN *= 0.5; sumT *= 0.5; sumNN *= 0.5; sumNT *= 0.5;
+                }
+                count += 1; sumN += n; sumT += t; sumNN += n * n; sumNT += n * t;
+            }
+
+            double predict( double n ) const
+            {
+                if( count < 1 )
+                    return -1.0;
+
+                double meanN = sumN / count;
+                double meanT = sumT / count;
+                double varN = sumNN / count - meanN * meanN;
+
+                //  Two or more distinct sizes give a line; otherwise assume the cost is all per element
+                if( varN > 0.0001 * meanN * meanN )
+                {
+                    double slope = ( sumNT / count - meanN * meanT ) / varN;
+                    if( slope >= 0.0 )
+                        return std::max( 0.0, meanT - slope * meanN ) + slope * n;
+                }
+                return ( meanN > 0.0 ) ? meanT * n / meanN : meanT;
+            }
+
+            double warmup;
+            double count;
+            double sumN;
+            double sumT;
+            double sumNN;
+            double sumNT;
+        };
+
+        struct DispatchModel
+        {
+            LinearFit path[ dispatchPathCount ];
+        };
+
+        size_t pathIndex( control::e_RunMode runMode )
+        {
+            switch( runMode )
+            {
+            case control::SerialCpu:    return 0;
+            case control::MultiCoreCpu: return 1;
+            default:                    return 2;
+            }
+        }
+
+        const control::e_RunMode indexPath[ dispatchPathCount ] =
+            { control::SerialCpu, control::MultiCoreCpu, control::OpenCL };
+
+        struct DispatchState
+        {
+            DispatchState( ): explorationLimit( dispatchDefaultExplorationLimit ), loaded( false )
+            {
+                const char* path = std::getenv( "BOLT_DISPATCH_MODEL" );
+                if( path != NULL )
+                    modelFile = path;
+            }
+
+            ~DispatchState( )
+            {
+                if( !modelFile.empty( ) )
+                    saveDispatchModel( modelFile );
+            }
+
+            boost::mutex                            guard;
+            std::map< std::string, DispatchModel >  models;
+            std::map< std::string, double >         transferCost;   // seconds per byte, by device name
+            std::map< cl_device_id, std::string >   deviceNames;
+            size_t                                  explorationLimit;
+            std::string                             modelFile;
+            bool                                    loaded;
+        };
+
+        DispatchState dispatchState;
+
+        //  Model names carry no spaces, so the model file can be read back with operator>>
+        std::string noSpaces( std::string str )
+        {
+            std::replace( str.begin( ), str.end( ), ' ', '_' );
+            return str;
+        }
+
+        //  Caller holds dispatchState.guard
+        const std::string& deviceName( const control& ctl )
+        {
+            cl_device_id device = NULL;
+            ::clGetCommandQueueInfo( ctl.getCommandQueue( )( ), CL_QUEUE_DEVICE, sizeof( device ), &device, NULL );
+
+            std::map< cl_device_id, std::string >::iterator it = dispatchState.deviceNames.find( device );
+            if( it == dispatchState.deviceNames.end( ) )
+            {
+                std::string name = "unknown";
+                size_t nameSize = 0;
+                if( device != NULL &&
+                    ::clGetDeviceInfo( device, CL_DEVICE_NAME, 0, NULL, &nameSize ) == CL_SUCCESS && nameSize > 1 )
+                {
+                    std::vector< char > buffer( nameSize );
+                    ::clGetDeviceInfo( device, CL_DEVICE_NAME, nameSize, &buffer[ 0 ], NULL );
+                    name = noSpaces( std::string( &buffer[ 0 ] ) );
+                }
+                it = dispatchState.deviceNames.insert( std::make_pair( device, name ) ).first;
+            }
+            return it->second;
+        }
+
+        //  Models in the file replace those of the same name; caller holds dispatchState.guard
+        bool readModelFile( const std::string& path )
+        {
+            std::ifstream in( path.c_str( ) );
+            if( !in )
+                return false;
+
+            std::string kind, key;
+            while( in >> kind >> key )
+            {
+                if( kind == "transfer" )
+                {
+                    in >> dispatchState.transferCost[ key ];
+                }
+                else if( kind == "model" )
+                {
+                    DispatchModel& fileModel = dispatchState.models[ key ];
+                    for( size_t p = 0; p < dispatchPathCount; ++p )
+                    {
+                        LinearFit& fit = fileModel.path[ p ];
+                        in >> fit.warmup >> fit.count >> fit.sumN >> fit.sumT >> fit.sumNN >> fit.sumNT;
+                    }
+                }
+            }
+            return true;
+        }
+
+        //  Caller holds dispatchState.guard
+        void loadOnFirstUse( )
+        {
+            if( dispatchState.loaded )
+                return;
+            dispatchState.loaded = true;
+
+            if( !dispatchState.modelFile.empty( ) )
+                readModelFile( dispatchState.modelFile );
+        }
+
+        //  Times a blocking write and read of a scratch buffer; caller holds dispatchState.guard
+        double probeTransferCost( const control& ctl )
+        {
+            try
+            {
+                std::vector< char > host( transferProbeBytes );
+                ::cl::CommandQueue queue = ctl.getCommandQueue( );
+                ::cl::Buffer probe( ctl.getContext( ), CL_MEM_READ_WRITE, transferProbeBytes );
+
+                //  The first transfer pays for pinning and allocation; time the second
+                queue.enqueueWriteBuffer( probe, CL_TRUE, 0, transferProbeBytes, &host[ 0 ] );
+
+                double start = dispatchClock( );
+                queue.enqueueWriteBuffer( probe, CL_TRUE, 0, transferProbeBytes, &host[ 0 ] );
+                queue.enqueueReadBuffer( probe, CL_TRUE, 0, transferProbeBytes, &host[ 0 ] );
+                return ( dispatchClock( ) - start ) / ( 2.0 * transferProbeBytes );
+            }
+            catch( ::cl::Error& )
+            {
+                return 0.0;
+            }
+        }
+
+        //  Caller holds dispatchState.guard
+        double transferCost( const control& ctl )
+        {
+            const std::string& name = deviceName( ctl );
+            std::map< std::string, double >::iterator it = dispatchState.transferCost.find( name );
+            if( it == dispatchState.transferCost.end( ) )
+                it = dispatchState.transferCost.insert( std::make_pair( name, probeTransferCost( ctl ) ) ).first;
+            return it->second;
+        }
+
+        //  Caller holds dispatchState.guard
+        DispatchModel& model( const control& ctl, const std::string& algorithm )
+        {
+            loadOnFirstUse( );
+            return dispatchState.models[ deviceName( ctl ) + "|" + noSpaces( algorithm ) ];
+        }
+
+        //  A call whose device work is still running when it returns; its time is taken when the work completes
+        struct PendingSample
+        {
+            std::string key;
+            size_t path;
+            double elements;
+            double transfer;    // predicted seconds of data movement, taken off the measured time
+            double start;
+        };
+
+        void CL_CALLBACK recordOnCompletion( cl_event, cl_int status, void* data )
+        {
+            PendingSample* sample = static_cast< PendingSample* >( data );
+
+            //  A command that failed says nothing about how long its path takes
+            try
+            {
+                if( status == CL_COMPLETE )
+                {
+                    double seconds = dispatchClock( ) - sample->start;
+
+                    boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+                    dispatchState.models[ sample->key ].path[ sample->path ].add( sample->elements,
+                        std::max( 0.0, seconds - sample->transfer ) );
+                }
+            }
+            catch( ... )
+            {
+            }
+            delete sample;
+        }
+    }
+
+    double dispatchClock( )
+    {
+        return boost::chrono::duration< double >(
+            boost::chrono::steady_clock::now( ).time_since_epoch( ) ).count( );
+    }
+
+    control::e_RunMode selectRunMode( const control& ctl, const std::string& algorithm, size_t elements,
+        size_t hostBytes, size_t deviceBytes, bool multiCoreAvailable )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        DispatchModel& myModel = model( ctl, algorithm );
+        double perByte = transferCost( ctl );
+
+        //  Try out the least measured path while it is cheap to be wrong
+        if( elements <= dispatchState.explorationLimit )
+        {
+            size_t explore = dispatchPathCount;
+            for( size_t p = 0; p < dispatchPathCount; ++p )
+            {
+                if( p == pathIndex( control::MultiCoreCpu ) && !multiCoreAvailable )
+                    continue;
+                if( myModel.path[ p ].count < dispatchMinSamples &&
+                    ( explore == dispatchPathCount ||
+                      myModel.path[ p ].warmup + myModel.path[ p ].count <
+                      myModel.path[ explore ].warmup + myModel.path[ explore ].count ) )
+                {
+                    explore = p;
+                }
+            }
+            if( explore != dispatchPathCount )
+                return indexPath[ explore ];
+        }
+
+        size_t best = dispatchPathCount;
+        double bestTime = 0.0;
+        for( size_t p = 0; p < dispatchPathCount; ++p )
+        {
+            if( p == pathIndex( control::MultiCoreCpu ) && !multiCoreAvailable )
+                continue;
+
+            double predicted = myModel.path[ p ].predict( static_cast< double >( elements ) );
+            if( predicted < 0.0 )
+                return ctl.getDefaultPathToRun( );
+
+            size_t moved = ( indexPath[ p ] == control::OpenCL ) ? hostBytes : deviceBytes;
+            predicted += perByte * moved;
+            if( best == dispatchPathCount || predicted < bestTime )
+            {
+                best = p;
+                bestTime = predicted;
+            }
+        }
+
+        return indexPath[ best ];
+    }
+
+    void recordDispatchTime( const control& ctl, const std::string& algorithm, control::e_RunMode runMode,
+        size_t elements, size_t transferBytes, double seconds )
+    {
+        try
+        {
+            boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+            //  The fit models the computation only; data movement is predicted separately from the probed rate
+            double compute = std::max( 0.0, seconds - transferCost( ctl ) * transferBytes );
+            model( ctl, algorithm ).path[ pathIndex( runMode ) ].add( static_cast< double >( elements ), compute );
+        }
+        catch( ... )
+        {
+            //  Called from a destructor; a lost sample only slows down learning
+        }
+    }
+
+    void recordDispatchTimeOnCompletion( const control& ctl, const std::string& algorithm,
+        control::e_RunMode runMode, size_t elements, size_t transferBytes, double start )
+    {
+        PendingSample* sample = NULL;
+        try
+        {
+            sample = new PendingSample;
+            {
+                boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+                loadOnFirstUse( );
+                sample->key = deviceName( ctl ) + "|" + noSpaces( algorithm );
+                sample->transfer = transferCost( ctl ) * transferBytes;
+            }
+            sample->path = pathIndex( runMode );
+            sample->elements = static_cast< double >( elements );
+            sample->start = start;
+
+            //  The marker completes once everything the call enqueued has run
+            ::cl::Event marker;
+            V_OPENCL( ctl.getCommandQueue( ).enqueueMarkerWithWaitList( NULL, &marker ),
+                "failed to enqueue the marker of an Automatic call" );
+            V_OPENCL( marker.setCallback( CL_COMPLETE, recordOnCompletion, sample ),
+                "failed to set the callback of an Automatic call" );
+            sample = NULL;  // the callback owns it now
+            V_OPENCL( ctl.getCommandQueue( ).flush( ), "clFlush call failed" );
+        }
+        catch( ... )
+        {
+            //  Called from a destructor; a lost sample only slows down learning
+            delete sample;
+        }
+    }
+
+    double predictDispatchTime( const control& ctl, const std::string& algorithm, control::e_RunMode runMode,
+        size_t elements, size_t transferBytes )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        double predicted = model( ctl, algorithm ).path[ pathIndex( runMode ) ].predict(
+            static_cast< double >( elements ) );
+        if( predicted < 0.0 )
+            return predicted;
+        return predicted + transferCost( ctl ) * transferBytes;
+    }
+
+    double getTransferCost( const control& ctl )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        return transferCost( ctl );
+    }
+
+    void setTransferCost( const control& ctl, double secondsPerByte )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        dispatchState.transferCost[ deviceName( ctl ) ] = secondsPerByte;
+    }
+
+    void setDispatchExplorationLimit( size_t elements )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        dispatchState.explorationLimit = elements;
+    }
+
+    size_t getDispatchExplorationLimit( )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        return dispatchState.explorationLimit;
+    }
+
+    bool saveDispatchModel( const std::string& path )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        std::ofstream out( path.c_str( ) );
+        if( !out )
+            return false;
+
+        out.precision( 17 );
+        for( std::map< std::string, double >::iterator it = dispatchState.transferCost.begin( );
+            it != dispatchState.transferCost.end( ); ++it )
+        {
+            out << "transfer " << it->first << " " << it->second << "\n";
+        }
+
+        for( std::map< std::string, DispatchModel >::iterator it = dispatchState.models.begin( );
+            it != dispatchState.models.end( ); ++it )
+        {
+            out << "model " << it->first;
+            for( size_t p = 0; p < dispatchPathCount; ++p )
+            {
+                const LinearFit& fit = it->second.path[ p ];
+                out << " " << fit.warmup << " " << fit.count << " " << fit.sumN << " " << fit.sumT
+                    << " " << fit.sumNN << " " << fit.sumNT;
+            }
+            out << "\n";
+        }
+
+        return out.good( );
+    }
+
+    bool loadDispatchModel( const std::string& path )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        loadOnFirstUse( );
+        return readModelFile( path );
+    }
+
+    void resetDispatchModel( )
+    {
+        boost::lock_guard< boost::mutex > lock( dispatchState.guard );
+
+        dispatchState.models.clear( );
+        dispatchState.transferCost.clear( );
+        dispatchState.loaded = true;    // a reset model stays empty even if BOLT_DISPATCH_MODEL is set
+    }
+
+    }
+}
@@ -0,0 +1,498 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+/******************************************************************************
+ * Persistent Program Binary Cache
+ * Programs built by acquireProgram are written to disk as CL_PROGRAM_BINARIES
+ * so that later processes can skip the source compile.  Every cache file is
+ * named after a hash of its key and carries the full key plus a checksum of
+ * the binary; anything that does not verify is discarded and rebuilt from
+ * source.  Files are written to a temporary name and renamed into place, and
+ * the directory is trimmed least-recently-used first when it grows past the
+ * configured limit.
+ *****************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include "bolt/cl/bolt.h"
+
+namespace bolt {
+    namespace cl {
+
+    namespace
+    {
+        // file layout: magic | version | key length | key | binary size | binary checksum | binary
+        const char          programCacheMagic[ 8 ] = { 'B', 'O', 'L', 'T', 'P', 'B', 'I', 'N' };
+        const cl_uint       programCacheVersion = 1;
+        const std::string   programCacheExtension = ".boltbin";
+        const size_t        programCacheDefaultMaxSize = 256 * 1024 * 1024;
+
+        struct ProgramCacheState
+        {
+            ProgramCacheState( ): maxSize( programCacheDefaultMaxSize ), writeCount( 0 )
+            {
+                ProgramCacheStats zero = { 0, 0, 0, 0, 0 };
+                stats = zero;
+
+                const char* dir = std::getenv( "BOLT_PROGRAM_CACHE_DIR" );
+                if( dir != NULL )
+                    directory = dir;
+
+                const char* maxMB = std::getenv( "BOLT_PROGRAM_CACHE_MAX_MB" );
+                if( maxMB != NULL )
+                    maxSize = static_cast< size_t >( std::strtoul( maxMB, NULL, 10 ) ) * 1024 * 1024;
+            }
+
+            boost::mutex        guard;
+            std::string         directory;
+            size_t              maxSize;
+            size_t              writeCount;
+            ProgramCacheStats   stats;
+        };
+
+        ProgramCacheState programCache;
+
+        struct CacheFileInfo
+        {
+            std::string name;
+            cl_ulong    size;
+            time_t      lastUse;
+
+            bool operator< ( const CacheFileInfo& rhs ) const { return lastUse < rhs.lastUse; }
+        };
+
+        std::string toHex( cl_ulong value )
+        {
+            std::ostringstream oss;
+            oss << std::hex << std::setw( 16 ) << std::setfill( '0' ) << value;
+            return oss.str( );
+        }
+
+        bool endsWith( const std::string& str, const std::string& suffix )
+        {
+            return str.size( ) >= suffix.size( ) &&
+                str.compare( str.size( ) - suffix.size( ), suffix.size( ), suffix ) == 0;
+        }
+
+        //  The on-disk key is a superset of ProgramMapKey minus the context; the driver and Bolt versions are
+        //  included so that upgrading either silently invalidates stale binaries.
+        std::string makeDiskKey(
+            const ::cl::Device&  device,
+            const ::std::string& deviceStr,
+            const ::std::string& options,
+            const ::std::string& source )
+        {
+            std::ostringstream key;
+            key << deviceStr << "; " << device.getInfo< CL_DRIVER_VERSION >( ) << "\n";
+            key << "Bolt " << BoltVersionMajor << "." << BoltVersionMinor << "." << BoltVersionPatch << "\n";
+            key << options << "\n";
+            key << toHex( hashString( source ) ) << " " << source.size( ) << "\n";
+            return key.str( );
+        }
+
+        void makeDirectory( const std::string& dir )
+        {
+#if defined( _WIN32 )
+            _mkdir( dir.c_str( ) );
+#else
+            mkdir( dir.c_str( ), 0755 );
+#endif
+        }
+
+        void touchFile( const std::string& path )
+        {
+#if defined( _WIN32 )
+            _utime( path.c_str( ), NULL );
+#else
+            utime( path.c_str( ), NULL );
+#endif
+        }
+
+        bool replaceFile( const std::string& from, const std::string& to )
+        {
+#if defined( _WIN32 )
+            return ::MoveFileExA( from.c_str( ), to.c_str( ), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+            return std::rename( from.c_str( ), to.c_str( ) ) == 0;
+#endif
+        }
+
+        int processId( )
+        {
+#if defined( _WIN32 )
+            return _getpid( );
+#else
+            return static_cast< int >( getpid( ) );
+#endif
+        }
+
+        void listCacheFiles( const std::string& dir, std::vector< CacheFileInfo >& files )
+        {
+#if defined( _WIN32 )
+            WIN32_FIND_DATAA findData;
+            HANDLE hFind = ::FindFirstFileA( ( dir + "/*" + programCacheExtension ).c_str( ), &findData );
+            if( hFind == INVALID_HANDLE_VALUE )
+                return;
+            do
+            {
+                CacheFileInfo info;
+                info.name = findData.cFileName;
+                info.size = ( static_cast< cl_ulong >( findData.nFileSizeHigh ) << 32 ) | findData.nFileSizeLow;
+                struct _stat st;
+                info.lastUse = ( _stat( ( dir + "/" + info.name ).c_str( ), &st ) == 0 ) ? st.st_mtime : 0;
+                files.push_back( info );
+            } while( ::FindNextFileA( hFind, &findData ) );
+            ::FindClose( hFind );
+#else
+            DIR* d = opendir( dir.c_str( ) );
+            if( d == NULL )
+                return;
+            while( struct dirent* entry = readdir( d ) )
+            {
+                std::string name = entry->d_name;
+                if( !endsWith( name, programCacheExtension ) )
+                    continue;
+                struct stat st;
+                if( stat( ( dir + "/" + name ).c_str( ), &st ) != 0 )
+                    continue;
+                CacheFileInfo info = { name, static_cast< cl_ulong >( st.st_size ), st.st_mtime };
+                files.push_back( info );
+            }
+            closedir( d );
+#endif
+        }
+
+        // Removes least recently used binaries until the directory fits into maxSize; the caller holds the guard
+        void trimCacheDirectory( const std::string& dir, size_t maxSize )
+        {
+            std::vector< CacheFileInfo > files;
+            listCacheFiles( dir, files );
+
+            cl_ulong total = 0;
+            for( size_t i = 0; i < files.size( ); ++i )
+                total += files[ i ].size;
+            if( total <= maxSize )
+                return;
+
+            std::sort( files.begin( ), files.end( ) );
+            for( size_t i = 0; i < files.size( ) && total > maxSize; ++i )
+            {
+                if( std::remove( ( dir + "/" + files[ i ].name ).c_str( ) ) == 0 )
+                {
+                    total -= files[ i ].size;
+                    ++programCache.stats.evictions;
+                }
+            }
+        }
+
+        template< typename T >
+        void writePod( std::ostream& os, const T& value )
+        {
+            os.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+        }
+
+        template< typename T >
+        bool readPod( std::istream& is, T& value )
+        {
+            is.read( reinterpret_cast< char* >( &value ), sizeof( T ) );
+            return is.good( );
+        }
+
+        //  Reads and verifies a cache file; returns false if the file is missing, truncated, or belongs to a
+        //  different key that happens to share the hash
+        bool readCacheFile( const std::string& path, const std::string& diskKey, std::vector< unsigned char >& binary,
+            bool& corrupt )
+        {
+            corrupt = false;
+            std::ifstream in( path.c_str( ), std::ios::in | std::ios::binary );
+            if( !in.is_open( ) )
+                return false;
+
+            corrupt = true;
+            char magic[ sizeof( programCacheMagic ) ];
+            in.read( magic, sizeof( magic ) );
+            if( !in.good( ) || !std::equal( magic, magic + sizeof( magic ), programCacheMagic ) )
+                return false;
+
+            cl_uint version = 0;
+            cl_ulong keySize = 0;
+            if( !readPod( in, version ) || version != programCacheVersion || !readPod( in, keySize ) ||
+                keySize != diskKey.size( ) )
+                return false;
+
+            std::string storedKey( static_cast< size_t >( keySize ), '\0' );
+            in.read( &storedKey[ 0 ], storedKey.size( ) );
+            if( !in.good( ) || storedKey != diskKey )
+                return false;
+
+            cl_ulong binarySize = 0, checksum = 0;
+            if( !readPod( in, binarySize ) || !readPod( in, checksum ) || binarySize == 0 )
+                return false;
+
+            binary.resize( static_cast< size_t >( binarySize ) );
+            in.read( reinterpret_cast< char* >( &binary[ 0 ] ), binary.size( ) );
+            if( static_cast< cl_ulong >( in.gcount( ) ) != binarySize )
+                return false;
+
+            std::string payload( binary.begin( ), binary.end( ) );
+            if( hashString( payload ) != checksum )
+                return false;
+
+            corrupt = false;
+            return true;
+        }
+    }
+
+    /**************************************************************************
+     * hashString
+     * - 64-bit FNV-1a; cheap, stable across runs and platforms
+     *************************************************************************/
+    cl_ulong hashString( const std::string& str, cl_ulong seed )
+    {
+        cl_ulong hash = seed;
+        for( std::string::const_iterator c = str.begin( ); c != str.end( ); ++c )
+        {
+            hash ^= static_cast< unsigned char >( *c );
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    std::string guardCode( const std::string& code )
+    {
+        if( code.empty( ) )
+            return code;
+
+        std::ostringstream guard;
+        guard << "BOLT_CODE_" << std::hex << hashString( code );
+
+        return "#if !defined( " + guard.str( ) + " )\n#define " + guard.str( ) + "\n" + code + "\n#endif\n";
+    }
+
+    void setProgramCacheDirectory( const std::string& directory )
+    {
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        programCache.directory = directory;
+    }
+
+    std::string getProgramCacheDirectory( )
+    {
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        return programCache.directory;
+    }
+
+    void setProgramCacheMaxSize( size_t bytes )
+    {
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        programCache.maxSize = bytes;
+        if( !programCache.directory.empty( ) )
+            trimCacheDirectory( programCache.directory, programCache.maxSize );
+    }
+
+    size_t getProgramCacheMaxSize( )
+    {
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        return programCache.maxSize;
+    }
+
+    ProgramCacheStats getProgramCacheStats( )
+    {
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        return programCache.stats;
+    }
+
+    void resetProgramCacheStats( )
+    {
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        ProgramCacheStats zero = { 0, 0, 0, 0, 0 };
+        programCache.stats = zero;
+    }
+
+    /**************************************************************************
+    * loadProgramBinary
+    * - rebuilds a program from the binary cache; returns a null Program on
+    *   a miss, or if the runtime refuses the stored binary
+    **************************************************************************/
+    ::cl::Program loadProgramBinary(
+        const ::cl::Context& context,
+        const ::cl::Device&  device,
+        const ::std::string& deviceStr,
+        const ::std::string& options,
+        const ::std::string& source )
+    {
+        ::cl::Program program;
+        std::string dir = getProgramCacheDirectory( );
+        if( dir.empty( ) )
+            return program;
+
+        std::string diskKey = makeDiskKey( device, deviceStr, options, source );
+        std::string path = dir + "/" + toHex( hashString( diskKey ) ) + programCacheExtension;
+
+        std::vector< unsigned char > binary;
+        bool corrupt = false;
+        if( !readCacheFile( path, diskKey, binary, corrupt ) )
+        {
+            boost::lock_guard< boost::mutex > lock( programCache.guard );
+            ++programCache.stats.misses;
+            if( corrupt )
+            {
+                ++programCache.stats.rejects;
+                std::remove( path.c_str( ) );
+            }
+            return program;
+        }
+
+        try
+        {
+            std::vector< ::cl::Device > devices;
+            devices.push_back( device );
+            ::cl::Program::Binaries binaries;
+            binaries.push_back( std::make_pair( static_cast< const void* >( &binary[ 0 ] ), binary.size( ) ) );
+
+            cl_int l_err;
+            std::vector< cl_int > binaryStatus;
+            program = ::cl::Program( context, devices, binaries, &binaryStatus, &l_err );
+            V_OPENCL( l_err, "Program::constructor() from binary failed" );
+            V_OPENCL( program.build( devices, options.c_str( ) ), "Program::build() from binary failed" );
+        }
+        catch( const ::cl::Error& )
+        {
+            //  The driver may refuse a binary it produced itself, e.g. after an upgrade that kept the version string;
+            //  drop it so that the source build below replaces it
+            boost::lock_guard< boost::mutex > lock( programCache.guard );
+            ++programCache.stats.misses;
+            ++programCache.stats.rejects;
+            std::remove( path.c_str( ) );
+            return ::cl::Program( );
+        }
+
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        ++programCache.stats.hits;
+        touchFile( path );
+        return program;
+    }
+
+    /**************************************************************************
+    * storeProgramBinary
+    * - writes the device binary of a freshly compiled program to the cache
+    **************************************************************************/
+    void storeProgramBinary(
+        const ::cl::Program& program,
+        const ::cl::Device&  device,
+        const ::std::string& deviceStr,
+        const ::std::string& options,
+        const ::std::string& source )
+    {
+        std::string dir = getProgramCacheDirectory( );
+        if( dir.empty( ) || program( ) == NULL )
+            return;
+
+        std::vector< unsigned char > binary;
+        try
+        {
+            //  The program was created against the whole context, but only built for one device; find its slot
+            std::vector< ::cl::Device > devices = program.getInfo< CL_PROGRAM_DEVICES >( );
+            std::vector< size_t > sizes = program.getInfo< CL_PROGRAM_BINARY_SIZES >( );
+
+            size_t slot = devices.size( );
+            for( size_t i = 0; i < devices.size( ); ++i )
+                if( devices[ i ]( ) == device( ) )
+                    slot = i;
+            if( slot == devices.size( ) || sizes[ slot ] == 0 )
+                return;
+
+            std::vector< std::vector< unsigned char > > storage( devices.size( ) );
+            std::vector< unsigned char* > pointers( devices.size( ), NULL );
+            for( size_t i = 0; i < devices.size( ); ++i )
+            {
+                storage[ i ].resize( sizes[ i ] + 1 );
+                pointers[ i ] = &storage[ i ][ 0 ];
+            }
+            V_OPENCL( ::clGetProgramInfo( program( ), CL_PROGRAM_BINARIES, pointers.size( ) * sizeof( unsigned char* ),
+                &pointers[ 0 ], NULL ), "clGetProgramInfo( CL_PROGRAM_BINARIES ) failed" );
+
+            binary.assign( storage[ slot ].begin( ), storage[ slot ].begin( ) + sizes[ slot ] );
+        }
+        catch( const ::cl::Error& )
+        {
+            return;
+        }
+
+        std::string diskKey = makeDiskKey( device, deviceStr, options, source );
+        std::string name = toHex( hashString( diskKey ) ) + programCacheExtension;
+
+        boost::lock_guard< boost::mutex > lock( programCache.guard );
+        makeDirectory( dir );
+
+        //  Write to a name private to this process and rename it into place, so concurrent readers either see the
+        //  old file, or the complete new one
+        std::ostringstream tmpName;
+        tmpName << dir << "/" << name << "." << processId( ) << "." << programCache.writeCount++ << ".tmp";
+        {
+            std::ofstream out( tmpName.str( ).c_str( ), std::ios::out | std::ios::binary | std::ios::trunc );
+            if( !out.is_open( ) )
+                return;
+
+            std::string payload( binary.begin( ), binary.end( ) );
+            out.write( programCacheMagic, sizeof( programCacheMagic ) );
+            writePod( out, programCacheVersion );
+            writePod( out, static_cast< cl_ulong >( diskKey.size( ) ) );
+            out.write( diskKey.data( ), diskKey.size( ) );
+            writePod( out, static_cast< cl_ulong >( binary.size( ) ) );
+            writePod( out, hashString( payload ) );
+            out.write( payload.data( ), payload.size( ) );
+            out.close( );
+            if( out.fail( ) )
+            {
+                std::remove( tmpName.str( ).c_str( ) );
+                return;
+            }
+        }
+
+        if( !replaceFile( tmpName.str( ), dir + "/" + name ) )
+        {
+            std::remove( tmpName.str( ).c_str( ) );
+            return;
+        }
+        ++programCache.stats.stores;
+
+        trimCacheDirectory( dir, programCache.maxSize );
+    }
+
+    }; //namespace bolt::cl
+}; // namespace bolt
@@ -0,0 +1,235 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+/******************************************************************************
+ * Work Shape Tuning
+ * Shapes found by sweeping candidates under control::AutoTuneWorkShape, or
+ * ahead of time by bolt-tune, are kept by "device|algorithm|typeSize".  The
+ * database is a text file so that one tuned on a build machine can ship with
+ * an application; BOLT_TUNING_DB names the file to read on first lookup and to
+ * write back at exit.
+ *****************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <cstdlib>
+
+#include <boost/chrono.hpp>
+
+#include "bolt/cl/tuning.h"
+
+namespace bolt {
+    namespace cl {
+
+    namespace
+    {
+        const size_t    tuneWgSizes[ ] = { 64, 128, 256 };
+        const size_t    tuneWgPerComputeUnit[ ] = { 4, 8, 16, 32, 64 };
+        const int       tuneUnroll[ ] = { 1, 2, 4 };
+
+        struct TuningState
+        {
+            TuningState( ): sweeps( 0 ), loaded( false )
+            {
+                const char* path = std::getenv( "BOLT_TUNING_DB" );
+                if( path != NULL )
+                    databaseFile = path;
+            }
+
+            ~TuningState( )
+            {
+                if( !databaseFile.empty( ) && !shapes.empty( ) )
+                    saveTuningDatabase( databaseFile );
+            }
+
+            boost::mutex                            guard;
+            std::map< std::string, WorkShape >      shapes;
+            std::map< cl_device_id, std::string >   deviceNames;
+            size_t                                  sweeps;
+            std::string                             databaseFile;
+            bool                                    loaded;
+        };
+
+        TuningState tuningState;
+
+        //  Caller holds tuningState.guard
+        const std::string& deviceName( const control& ctl )
+        {
+            cl_device_id device = NULL;
+            ::clGetCommandQueueInfo( ctl.getCommandQueue( )( ), CL_QUEUE_DEVICE, sizeof( device ), &device, NULL );
+
+            std::map< cl_device_id, std::string >::iterator it = tuningState.deviceNames.find( device );
+            if( it == tuningState.deviceNames.end( ) )
+            {
+                std::string name = "unknown";
+                size_t nameSize = 0;
+                if( device != NULL &&
+                    ::clGetDeviceInfo( device, CL_DEVICE_NAME, 0, NULL, &nameSize ) == CL_SUCCESS && nameSize > 1 )
+                {
+                    std::vector< char > buffer( nameSize );
+                    ::clGetDeviceInfo( device, CL_DEVICE_NAME, nameSize, &buffer[ 0 ], NULL );
+                    name.assign( &buffer[ 0 ] );
+                    std::replace( name.begin( ), name.end( ), ' ', '_' );
+                }
+                it = tuningState.deviceNames.insert( std::make_pair( device, name ) ).first;
+            }
+            return it->second;
+        }
+
+        //  Caller holds tuningState.guard
+        std::string shapeKey( const control& ctl, const std::string& algorithm, size_t typeSize )
+        {
+            std::ostringstream key;
+            key << deviceName( ctl ) << "|" << algorithm << "|" << typeSize;
+            return key.str( );
+        }
+
+        //  Caller holds tuningState.guard
+        bool readDatabaseFile( const std::string& path )
+        {
+            std::ifstream in( path.c_str( ) );
+            if( !in )
+                return false;
+
+            std::string kind, key;
+            while( in >> kind >> key )
+            {
+                WorkShape shape;
+                if( kind == "shape" && in >> shape.wgSize >> shape.wgPerComputeUnit >> shape.unroll )
+                    tuningState.shapes[ key ] = shape;
+            }
+            return true;
+        }
+
+        //  Caller holds tuningState.guard
+        void loadOnFirstUse( )
+        {
+            if( tuningState.loaded )
+                return;
+            tuningState.loaded = true;
+
+            if( !tuningState.databaseFile.empty( ) )
+                readDatabaseFile( tuningState.databaseFile );
+        }
+    }
+
+    bool findWorkShape( const control& ctl, const std::string& algorithm, size_t typeSize, WorkShape& shape )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        loadOnFirstUse( );
+        std::map< std::string, WorkShape >::const_iterator it =
+            tuningState.shapes.find( shapeKey( ctl, algorithm, typeSize ) );
+        if( it == tuningState.shapes.end( ) )
+            return false;
+
+        shape = it->second;
+        return true;
+    }
+
+    void storeWorkShape( const control& ctl, const std::string& algorithm, size_t typeSize, const WorkShape& shape )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        loadOnFirstUse( );
+        tuningState.shapes[ shapeKey( ctl, algorithm, typeSize ) ] = shape;
+    }
+
+    bool saveTuningDatabase( const std::string& path )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        std::ofstream out( path.c_str( ) );
+        if( !out )
+            return false;
+
+        for( std::map< std::string, WorkShape >::iterator it = tuningState.shapes.begin( );
+            it != tuningState.shapes.end( ); ++it )
+        {
+            out << "shape " << it->first << " " << it->second.wgSize << " " << it->second.wgPerComputeUnit
+                << " " << it->second.unroll << "\n";
+        }
+
+        return out.good( );
+    }
+
+    bool loadTuningDatabase( const std::string& path )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        loadOnFirstUse( );
+        return readDatabaseFile( path );
+    }
+
+    void clearTuningDatabase( )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        tuningState.shapes.clear( );
+        tuningState.loaded = true;      // a cleared database stays empty even if BOLT_TUNING_DB is set
+    }
+
+    size_t getTuningSweepCount( )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        return tuningState.sweeps;
+    }
+
+    namespace detail {
+
+    std::vector< WorkShape > reduceWorkShapes( const control& ctl )
+    {
+        size_t maxWgSize = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_WORK_GROUP_SIZE >( );
+
+        std::vector< WorkShape > candidates;
+        for( size_t w = 0; w < sizeof( tuneWgSizes ) / sizeof( tuneWgSizes[ 0 ] ); ++w )
+        {
+            if( tuneWgSizes[ w ] > maxWgSize )
+                continue;
+
+            for( size_t g = 0; g < sizeof( tuneWgPerComputeUnit ) / sizeof( tuneWgPerComputeUnit[ 0 ] ); ++g )
+            {
+                for( size_t u = 0; u < sizeof( tuneUnroll ) / sizeof( tuneUnroll[ 0 ] ); ++u )
+                {
+                    WorkShape shape = { tuneWgSizes[ w ], tuneWgPerComputeUnit[ g ], tuneUnroll[ u ] };
+                    candidates.push_back( shape );
+                }
+            }
+        }
+        return candidates;
+    }
+
+    void countSweep( )
+    {
+        boost::lock_guard< boost::mutex > lock( tuningState.guard );
+
+        ++tuningState.sweeps;
+    }
+
+    double tuningClock( )
+    {
+        return boost::chrono::duration< double >(
+            boost::chrono::steady_clock::now( ).time_since_epoch( ) ).count( );
+    }
+
+    }
+
+    }
+}
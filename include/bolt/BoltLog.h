@@ -42,20 +42,26 @@ namespace BOLTLOG{
         BOLT_GENERATE,
         BOLT_INNERPRODUCT,
 		BOLT_MERGE,
+        BOLT_MERGEBYKEY,
         BOLT_MAXELEMENT,
         BOLT_MINELEMENT,
+        BOLT_PARTITION,
         BOLT_REDUCE,
         BOLT_REDUCEBYKEY,
+        BOLT_REMOVE,
         BOLT_SCAN,
         BOLT_SCANBYKEY,
 		BOLT_SCATTER,
+        BOLT_SETOPERATIONS,
         BOLT_SORT,
         BOLT_SORTBYKEY,
         BOLT_STABLESORT,
         BOLT_STABLESORTBYKEY,
         BOLT_TRANSFORMREDUCE,
         BOLT_TRANSFORMSCAN,
-        BOLT_TRANSFORM
+        BOLT_TRANSFORM,
+        BOLT_UNIQUE,
+        BOLT_AUTOMATIC      // the path control::Automatic chose, logged before the algorithm logs the path it runs
     };
 
     class FunPaths
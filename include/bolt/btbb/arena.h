@@ -0,0 +1,185 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_ARENA_H )
+#define BOLT_BTBB_ARENA_H
+#pragma once
+
+#include <vector>
+
+#include "tbb/task_arena.h"
+#include "tbb/task_scheduler_observer.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/spin_mutex.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "bolt/cl/control.h"
+
+//  Pinning threads needs arena local observers, and an OS call that takes a set of processors
+#if defined( __TBB_ARENA_OBSERVER ) && __TBB_ARENA_OBSERVER && ( defined( _WIN32 ) || defined( __linux__ ) )
+    #define BOLT_BTBB_AFFINITY
+    #if defined( _WIN32 )
+        #include <windows.h>
+    #else
+        #include <pthread.h>
+        #include <sched.h>
+    #endif
+#endif
+
+/*! \file bolt/btbb/arena.h
+    \brief The task arena every btbb algorithm runs in, sized and placed by control::setMultiCoreThreads and
+    control::setMultiCoreAffinity.
+*/
+
+namespace bolt {
+    namespace btbb {
+        namespace detail {
+
+#if defined( BOLT_BTBB_AFFINITY )
+            //  Pins each thread that joins the arena to the configured processors, and gives it its old affinity back
+            //  when it leaves, because TBB workers move between arenas
+            class AffinityObserver: public tbb::task_scheduler_observer
+            {
+            public:
+#if defined( _WIN32 )
+                typedef DWORD_PTR mask_type;
+#else
+                typedef cpu_set_t mask_type;
+#endif
+
+                AffinityObserver( tbb::task_arena& arena, const std::vector< int >& processors ):
+                    tbb::task_scheduler_observer( arena )
+                {
+#if defined( _WIN32 )
+                    m_mask = 0;
+                    for( size_t p = 0; p < processors.size( ); ++p )
+                        if( processors[ p ] >= 0 && processors[ p ] < static_cast< int >( 8 * sizeof( DWORD_PTR ) ) )
+                            m_mask |= static_cast< DWORD_PTR >( 1 ) << processors[ p ];
+#else
+                    CPU_ZERO( &m_mask );
+                    for( size_t p = 0; p < processors.size( ); ++p )
+                        if( processors[ p ] >= 0 && processors[ p ] < CPU_SETSIZE )
+                            CPU_SET( processors[ p ], &m_mask );
+#endif
+                    observe( true );
+                }
+
+                ~AffinityObserver( )
+                {
+                    observe( false );
+                }
+
+                virtual void on_scheduler_entry( bool )
+                {
+                    mask_type& saved = m_saved.local( );
+#if defined( _WIN32 )
+                    saved = ::SetThreadAffinityMask( ::GetCurrentThread( ), m_mask );
+#else
+                    ::pthread_getaffinity_np( ::pthread_self( ), sizeof( saved ), &saved );
+                    ::pthread_setaffinity_np( ::pthread_self( ), sizeof( m_mask ), &m_mask );
+#endif
+                }
+
+                virtual void on_scheduler_exit( bool )
+                {
+                    mask_type& saved = m_saved.local( );
+#if defined( _WIN32 )
+                    if( saved != 0 )
+                        ::SetThreadAffinityMask( ::GetCurrentThread( ), saved );
+#else
+                    ::pthread_setaffinity_np( ::pthread_self( ), sizeof( saved ), &saved );
+#endif
+                }
+
+            private:
+                mask_type m_mask;
+                tbb::enumerable_thread_specific< mask_type > m_saved;
+            };
+#endif
+
+            struct ArenaHolder
+            {
+                ArenaHolder( const bolt::cl::control::multiCoreSettings& settings ):
+                    arena( ( settings.threads > 0 ) ? settings.threads : static_cast< int >( tbb::task_arena::automatic ) )
+                {
+#if defined( BOLT_BTBB_AFFINITY )
+                    if( !settings.affinity.empty( ) )
+                    {
+                        arena.initialize( );
+                        observer.reset( new AffinityObserver( arena, settings.affinity ) );
+                    }
+#endif
+                }
+
+                tbb::task_arena arena;
+#if defined( BOLT_BTBB_AFFINITY )
+                boost::scoped_ptr< AffinityObserver > observer;     // declared after the arena, so it goes first
+#endif
+            };
+
+            struct ArenaState
+            {
+                ArenaState( ): revision( 0 )
+                {}
+
+                tbb::spin_mutex                     guard;
+                boost::shared_ptr< ArenaHolder >    current;
+                size_t                              revision;
+            };
+
+            inline ArenaState& arenaState( )
+            {
+                static ArenaState state;
+                return state;
+            }
+
+            //  The arena for the current settings; one replaced by a settings change lives on until the calls
+            //  still running in it return
+            inline boost::shared_ptr< ArenaHolder > currentArena( )
+            {
+                size_t revision = bolt::cl::control::getMultiCoreRevision( );
+                ArenaState& state = arenaState( );
+
+                tbb::spin_mutex::scoped_lock lock( state.guard );
+                if( !state.current || state.revision != revision )
+                {
+                    bolt::cl::control::multiCoreSettings settings = bolt::cl::control::getMultiCoreSettings( );
+                    state.current.reset( new ArenaHolder( settings ) );
+                    state.revision = settings.revision;
+                }
+                return state.current;
+            }
+
+        } // namespace detail
+
+        /*! \brief Runs a functor in the task arena Bolt owns
+        *   \details The arena is created on first use and kept for the life of the process, so a call pays neither
+        *   for starting a scheduler nor for creating threads.  Every btbb algorithm puts its TBB work through here.
+        */
+        template< typename Functor >
+        void execute( const Functor& functor )
+        {
+            boost::shared_ptr< detail::ArenaHolder > holder = detail::currentArena( );
+            holder->arena.execute( functor );
+        }
+
+    };
+};
+
+#endif
@@ -32,6 +32,20 @@ namespace bolt {
        
        template<typename ForwardIterator, typename T, typename StrictWeakOrdering>
        bool binary_search( ForwardIterator first, ForwardIterator last, const T & value, StrictWeakOrdering comp);
+
+       //  Batch searches: one result per value in [values_first, values_last), written from result.  lower_bound and
+       //  upper_bound write positions in [first, last); binary_search writes whether the value is present.
+       template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+       OutputIterator lower_bound( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+           InputIterator values_last, OutputIterator result, StrictWeakOrdering comp );
+
+       template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+       OutputIterator upper_bound( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+           InputIterator values_last, OutputIterator result, StrictWeakOrdering comp );
+
+       template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+       OutputIterator binary_search( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+           InputIterator values_last, OutputIterator result, StrictWeakOrdering comp );
        
     };
 };
@@ -30,6 +30,13 @@ namespace bolt {
        template<typename InputIterator, typename Size, typename OutputIterator>
        OutputIterator copy_n(InputIterator first, Size n, OutputIterator result);
 
+       template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+       OutputIterator copy_if(InputIterator1 first, InputIterator1 last, InputIterator2 stencil,
+                              OutputIterator result, Predicate pred);
+
+       template<typename InputIterator, typename OutputIterator, typename Predicate>
+       OutputIterator copy_if(InputIterator first, InputIterator last, OutputIterator result, Predicate pred);
+
     };
 };
 
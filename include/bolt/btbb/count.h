@@ -24,7 +24,6 @@
 
 #include "tbb/parallel_reduce.h"
 #include "tbb/blocked_range.h"
-#include "tbb/task_scheduler_init.h"
 
 /*! \file bolt/tbb/count.h
     \brief Counts the number of elements in the specified range.
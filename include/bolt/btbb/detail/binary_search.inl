@@ -19,132 +19,259 @@
 #define BOLT_BTBB_BINARY_SEARCH_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
+#include "bolt/btbb/scratch.h"
 #include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
 #include "tbb/blocked_range.h"
+#include <algorithm>
+#include <functional>
 #include <iterator>
 
 namespace bolt{
     namespace btbb {
 
-             template<typename ForwardIterator, typename T>
-             struct BS {
+        namespace detail {
 
-                bool result;
+            enum searchMode { searchLowerBound, searchUpperBound, searchBinary };
 
-                BS () {result=false;}
+            //  Queries one task walks down the haystack in lock step.  Every lane halves the same length on every
+            //  step, so the lanes are independent chains of loads and selects the compiler can overlap or vectorize.
+            static const size_t searchLanes = 8;
 
-				void operator()( ForwardIterator first, int n, const T & val)
-                {
+            //  A haystack this long, searched for at least one value per searchEytzingerRatio of its elements, is
+            //  first copied into Eytzinger (breadth first) order, where the top levels of every search share a few
+            //  cache lines and each step down touches one new line.
+            static const size_t searchEytzingerMinElements = 1 << 16;
+            static const size_t searchEytzingerRatio = 8;
 
-                    tbb::parallel_for(  tbb::blocked_range<int>(0, (int) n) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                        {
+            //  Subtrees larger than this are laid out in parallel
+            static const size_t searchEytzingerGrain = 1 << 14;
 
-                              int low=r.begin();
-                              int high=r.end();
-                              int mid;
-                              T midVal, firstVal;
+            //  True when the answer for value lies after element
+            template< typename Element, typename T, typename StrictWeakOrdering >
+            inline bool searchRight( searchMode mode, const Element& element, const T& value,
+                const StrictWeakOrdering& comp )
+            {
+                return ( mode == searchUpperBound ) ? !comp( value, element ) : comp( element, value );
+            }
 
-                              while(low<high)
-                              {
-                                     mid = (low + high) / 2;
+            template< typename ForwardIterator, typename T, typename OutputIterator, typename StrictWeakOrdering >
+            inline void searchStore( searchMode mode, ForwardIterator first, size_t n, size_t position,
+                const T& value, OutputIterator result, const StrictWeakOrdering& comp )
+            {
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
 
-                                     midVal = first[mid];
-                                     firstVal = first[low];
+                if( mode == searchBinary )
+                    *result = static_cast< oType >( position < n && !comp( value, first[ position ] ) );
+                else
+                    *result = static_cast< oType >( position );
+            }
 
-                                     if( midVal == val)
-                                     {
-                                            result = true;
-                                            break;
-                                     }
-                                     else if (midVal < val)
-                                            low = mid + 1;
-                                     else
-                                            high = mid;
-                              }
+            //  Branch free binary search of values [begin, end), searchLanes at a time
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            void searchSorted( searchMode mode, ForwardIterator first, size_t n, InputIterator values_first,
+                size_t begin, size_t end, OutputIterator result, const StrictWeakOrdering& comp )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type vType;
 
-                              //result = std::binary_search(first+r.begin(), first+r.end(), val);
-                          });
-                 }
+                for( size_t lane0 = begin; lane0 < end; lane0 += searchLanes )
+                {
+                    size_t lanes = std::min( searchLanes, end - lane0 );
+                    size_t base[ searchLanes ];
+                    vType value[ searchLanes ];
+                    for( size_t l = 0; l < lanes; ++l )
+                    {
+                        base[ l ] = 0;
+                        value[ l ] = values_first[ lane0 + l ];
+                    }
+
+                    for( size_t length = n; length > 1; )
+                    {
+                        size_t half = length / 2;
+                        for( size_t l = 0; l < lanes; ++l )
+                            base[ l ] += searchRight( mode, first[ base[ l ] + half ], value[ l ], comp ) ? half : 0;
+                        length -= half;
+                    }
+
+                    for( size_t l = 0; l < lanes; ++l )
+                    {
+                        size_t position = base[ l ] + ( searchRight( mode, first[ base[ l ] ], value[ l ], comp ) ? 1 : 0 );
+                        searchStore( mode, first, n, position, value[ l ], result + ( lane0 + l ), comp );
+                    }
+                }
+            }
 
-            };
+            //  Number of nodes in the subtree rooted at k of an n node tree in Eytzinger order
+            inline size_t eytzingerSubtree( size_t k, size_t n )
+            {
+                size_t nodes = 0;
+                for( size_t width = 1; k <= n; k *= 2, width *= 2 )
+                    nodes += std::min( n, k + width - 1 ) - k + 1;
+                return nodes;
+            }
 
-             template<typename ForwardIterator, typename T, typename StrictWeakOrdering>
-             struct BS_comp {
+            //  Fills the subtree rooted at k with the sorted elements starting at offset.  tree and rank are 1 based;
+            //  rank holds the position in the sorted haystack of each node.
+            template< typename ForwardIterator, typename T >
+            void eytzingerLayout( ForwardIterator first, size_t n, T* tree, size_t* rank, size_t k, size_t offset )
+            {
+                if( k > n )
+                    return;
 
-                bool result;
+                size_t leftNodes = eytzingerSubtree( 2 * k, n );
+                if( leftNodes > searchEytzingerGrain )
+                {
+                    tbb::parallel_invoke(
+                        [ & ] { eytzingerLayout( first, n, tree, rank, 2 * k, offset ); },
+                        [ & ] { eytzingerLayout( first, n, tree, rank, 2 * k + 1, offset + leftNodes + 1 ); }
+                    );
+                }
+                else
+                {
+                    eytzingerLayout( first, n, tree, rank, 2 * k, offset );
+                    eytzingerLayout( first, n, tree, rank, 2 * k + 1, offset + leftNodes + 1 );
+                }
 
-                BS_comp () {result=false;}
+                tree[ k ] = first[ offset + leftNodes ];
+                rank[ k ] = offset + leftNodes;
+            }
 
-				void operator()( ForwardIterator first, int n, const T & val, StrictWeakOrdering comp)
-                {
+            template< typename ForwardIterator, typename T, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            void searchEytzinger( searchMode mode, ForwardIterator first, size_t n, const T* tree, const size_t* rank,
+                InputIterator values_first, size_t begin, size_t end, OutputIterator result,
+                const StrictWeakOrdering& comp )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type vType;
 
-                    tbb::parallel_for(  tbb::blocked_range<int>(0, (int) n) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                        {
+                //  Levels every search passes through completely; nodes 1 .. 2^levels - 1 all exist
+                size_t levels = 0;
+                while( ( size_t( 2 ) << levels ) - 1 <= n )
+                    ++levels;
 
-                              int low=r.begin();
-                              int high=r.end();
-                              int mid;
-                              T midVal, firstVal;
+                for( size_t lane0 = begin; lane0 < end; lane0 += searchLanes )
+                {
+                    size_t lanes = std::min( searchLanes, end - lane0 );
+                    size_t k[ searchLanes ];
+                    vType value[ searchLanes ];
+                    for( size_t l = 0; l < lanes; ++l )
+                    {
+                        k[ l ] = 1;
+                        value[ l ] = values_first[ lane0 + l ];
+                    }
+
+                    for( size_t level = 0; level < levels; ++level )
+                        for( size_t l = 0; l < lanes; ++l )
+                            k[ l ] = 2 * k[ l ] + ( searchRight( mode, tree[ k[ l ] ], value[ l ], comp ) ? 1 : 0 );
+
+                    for( size_t l = 0; l < lanes; ++l )
+                    {
+                        size_t node = k[ l ];
+                        if( node <= n )
+                            node = 2 * node + ( searchRight( mode, tree[ node ], value[ l ], comp ) ? 1 : 0 );
+
+                        //  The answer is the last node where the search went left: drop the trailing right turns
+                        //  and that left turn.  No left turn at all means the answer is past the end.
+                        while( node & 1 )
+                            node >>= 1;
+                        node >>= 1;
+
+                        searchStore( mode, first, n, ( node == 0 ) ? n : rank[ node ], value[ l ], result + ( lane0 + l ),
+                            comp );
+                    }
+                }
+            }
 
-                              while(low<high)
-                              {
-                                     mid = (low + high) / 2;
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator search( searchMode mode, ForwardIterator first, ForwardIterator last,
+                InputIterator values_first, InputIterator values_last, OutputIterator result, StrictWeakOrdering comp )
+            {
+                typedef typename std::iterator_traits< ForwardIterator >::value_type T;
+
+                size_t n = static_cast< size_t >( std::distance( first, last ) );
+                size_t m = static_cast< size_t >( std::distance( values_first, values_last ) );
+                if( m == 0 )
+                    return result;
 
-                                     midVal = first[mid];
-                                     firstVal = first[low];
+                if( n == 0 )
+                {
+                    for( size_t i = 0; i < m; ++i )
+                        searchStore( mode, first, n, 0, values_first[ i ], result + i, comp );
+                    return result + m;
+                }
 
-                                     if( (!comp(midVal, val)) && (!comp(val, midVal)) )
-                                     {
-                                            this->result = true;
-                                            break;
-                                     }
-                                     else if ( comp(midVal, val) )
-                                            low = mid + 1;
-                                     else
-                                            high = mid;
-                              }
+                bolt::btbb::execute( [ & ]( )
+                {
+                    if( n >= searchEytzingerMinElements && m >= n / searchEytzingerRatio )
+                    {
+                        ScratchArray< T > tree( n + 1 );
+                        ScratchArray< size_t > rank( n + 1 );
+                        eytzingerLayout( first, n, tree.get( ), rank.get( ), 1, 0 );
+
+                        tbb::parallel_for( tbb::blocked_range< size_t >( 0, m ),
+                            [ & ]( const tbb::blocked_range< size_t >& r )
+                        {
+                            searchEytzinger( mode, first, n, tree.get( ), rank.get( ), values_first, r.begin( ),
+                                r.end( ), result, comp );
+                        } );
+                    }
+                    else
+                    {
+                        tbb::parallel_for( tbb::blocked_range< size_t >( 0, m ),
+                            [ & ]( const tbb::blocked_range< size_t >& r )
+                        {
+                            searchSorted( mode, first, n, values_first, r.begin( ), r.end( ), result, comp );
+                        } );
+                    }
+                } );
 
-                              //result = std::binary_search(first+r.begin(), first+r.end(), val, comp);
-                          });
-                 }
+                return result + m;
+            }
 
-            };
+        } // detail
 
+            //  A single search is O(log n) and touches a handful of cache lines; splitting it across threads only
+            //  adds the cost of waking them
             template<typename ForwardIterator, typename T, typename StrictWeakOrdering>
             bool binary_search( ForwardIterator first, ForwardIterator last, const T & value, StrictWeakOrdering comp)
             {
-
-               //This allows TBB to choose the number of threads to spawn.
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-               int n = (int)std::distance(first, last);
-
-               BS_comp <ForwardIterator, T, StrictWeakOrdering> bs_op;
-               bs_op(first, n, value, comp);
-
-               return bs_op.result;
+               return std::binary_search( first, last, value, comp );
             }
 
             template<typename ForwardIterator, typename T>
             bool binary_search( ForwardIterator first, ForwardIterator last, const T & value)
             {
+               return std::binary_search( first, last, value );
+            }
 
-               //This allows TBB to choose the number of threads to spawn.
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-               int n = (int)std::distance(first, last);
-
-               BS <ForwardIterator, T> bs_op;
-               bs_op(first, n, value);
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator lower_bound( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+                InputIterator values_last, OutputIterator result, StrictWeakOrdering comp )
+            {
+               return detail::search( detail::searchLowerBound, first, last, values_first, values_last, result, comp );
+            }
 
-               return bs_op.result;
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator upper_bound( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+                InputIterator values_last, OutputIterator result, StrictWeakOrdering comp )
+            {
+               return detail::search( detail::searchUpperBound, first, last, values_first, values_last, result, comp );
             }
 
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator binary_search( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+                InputIterator values_last, OutputIterator result, StrictWeakOrdering comp )
+            {
+               return detail::search( detail::searchBinary, first, last, values_first, values_last, result, comp );
+            }
 
     } //tbb
 } // bolt
 
-#endif //BTBB_BINARY_SEARCH__INL
\ No newline at end of file
+#endif //BTBB_BINARY_SEARCH_INL
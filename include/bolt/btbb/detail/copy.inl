@@ -35,7 +35,7 @@
 #define BOLT_BTBB_COPY_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_scan.h"
 #include "tbb/blocked_range.h"
@@ -51,11 +51,11 @@ namespace bolt{
 
 				void operator()( InputIterator first, Size n, OutputIterator result)
                 {
-                    tbb::parallel_for(  tbb::blocked_range<int>(0, (int) n) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
+                    tbb::parallel_for(  tbb::blocked_range<size_t>(0, static_cast< size_t >( n )) ,
+                        [&] (const tbb::blocked_range<size_t> &r) -> void
                         {
                               
-                              for(int i = r.begin(); i!=r.end(); i++)
+                              for(size_t i = r.begin(); i!=r.end(); i++)
                               {
                                  
                                    *(result+i) = *(first+i);
@@ -72,127 +72,196 @@ namespace bolt{
             template<typename InputIterator, typename Size, typename OutputIterator>
             OutputIterator copy_n(InputIterator first, Size n, OutputIterator result)
             {
-               //Gets the number of concurrent threads supported by the underlying platform
-               //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-               //This allows TBB to choose the number of threads to spawn.
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-               //Explicitly setting the number of threads to spawn
-               //tbb::task_scheduler_init((int) concurentThreadsSupported);
 
                Copy_n <InputIterator, Size, OutputIterator> copy_op;
-               copy_op(first, n, result);
+               bolt::btbb::execute( [ & ]( )
+               {
+                   copy_op(first, n, result);
+               } );
 
                return result;
             }
 
 
-		template<typename InputIterator1,
-				 typename InputIterator2,
-				 typename OutputIterator,
-				 typename Predicate,
-				 typename Size>
-		struct body
-		{
-
-		  InputIterator1 first;
-		  InputIterator2 stencil;
-		  OutputIterator result;
-		  Predicate pred;
-		  Size sum;
-
-		  body(InputIterator1 first, InputIterator2 stencil, OutputIterator result, Predicate pred)
-			: first(first), stencil(stencil), result(result), pred(pred), sum(0)
-		  {}
-
-		  body(body& b, tbb::split)
-			: first(b.first), stencil(b.stencil), result(b.result), pred(b.pred), sum(0)
-		  {}
-
-		  void operator()(const tbb::blocked_range<Size>& r, tbb::pre_scan_tag)
-		  {
-			InputIterator2 iter = stencil + r.begin();
-
-			for (Size i = r.begin(); i != r.end(); ++i, ++iter)
-			{
-			  if (pred(*iter))
-				++sum;
-			}
-		  }
-  
-		  void operator()(const tbb::blocked_range<Size>& r, tbb::final_scan_tag)
-		  {
-			InputIterator1  iter1 = first   + r.begin();
-			InputIterator2  iter2 = stencil + r.begin();
-			OutputIterator  iter3 = result  + sum;
-      
-			for (Size i = r.begin(); i != r.end(); ++i, ++iter1, ++iter2)
-			{
-			  if (pred(*iter2))
-			  {
-				*iter3 = *iter1;
-				++sum;
-				++iter3;
-			  }
-			}
-		  }
-
-		  void reverse_join(body& b)
-		  {
-			sum = b.sum + sum;
-		  } 
-
-		  void assign(body& b)
-		  {
-			sum = b.sum;
-		  } 
-		}; // end body
-
-
-		template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
-		struct Copy_If {
-
-				   Copy_If () {}
-		       
-				   OutputIterator operator()( InputIterator1 first, InputIterator1 last,
-								 InputIterator2 stencil, OutputIterator result, Predicate pred)
-				   {  
-		       			   typedef int Size;
-							  typedef  body<InputIterator1,InputIterator2,OutputIterator,Predicate,Size> Body;
-							  Size n = std::distance(first, last);
-	                     
-							  if (n != 0)
-							  {
-								  Body body(first, stencil, result, pred);
-								  tbb::parallel_scan(tbb::blocked_range<Size>(0,n), body);
-		       					  result = result + body.sum;
-		       					  return result;
-							  }
-	                     
-		       			   return result;
-				   }
-
-			};	
-
-
-			template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
-			OutputIterator copy_if(InputIterator1 first, InputIterator1 last,
-						  InputIterator2 stencil, OutputIterator result, Predicate pred)
-			{
-				   //Gets the number of concurrent threads supported by the underlying platform
-				   //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-				   //This allows TBB to choose the number of threads to spawn.
-				   tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-				   //Explicitly setting the number of threads to spawn
-				   //tbb::task_scheduler_init((int) concurentThreadsSupported);
-
-				   Copy_If <InputIterator1, InputIterator2, OutputIterator, Predicate> copy_op;
-				   return copy_op(first, last, stencil, result, pred);
-
-			}
+        //  Stream compaction in one parallel_scan.  The pre-scan counts the elements each range keeps; the final
+        //  scan hands every element to Emit once, with the number of elements kept or rejected before it, so kept
+        //  and rejected elements both come out in their input order.
+        template< typename Size, typename Flags, typename Emit >
+        struct compact_body
+        {
+            Flags flags;
+            Emit emit;
+            Size sum;
+
+            compact_body( const Flags& _flags, const Emit& _emit ): flags( _flags ), emit( _emit ), sum( 0 )
+            {}
+
+            compact_body( compact_body& b, tbb::split ): flags( b.flags ), emit( b.emit ), sum( 0 )
+            {}
+
+            void operator()( const tbb::blocked_range< Size >& r, tbb::pre_scan_tag )
+            {
+                for( Size i = r.begin( ); i != r.end( ); ++i )
+                {
+                    if( flags( i ) )
+                        ++sum;
+                }
+            }
+
+            void operator()( const tbb::blocked_range< Size >& r, tbb::final_scan_tag )
+            {
+                for( Size i = r.begin( ); i != r.end( ); ++i )
+                {
+                    if( flags( i ) )
+                    {
+                        emit.keep( i, sum );
+                        ++sum;
+                    }
+                    else
+                        emit.reject( i, i - sum );
+                }
+            }
+
+            void reverse_join( compact_body& b )
+            {
+                sum = b.sum + sum;
+            }
+
+            void assign( compact_body& b )
+            {
+                sum = b.sum;
+            }
+        };
+
+        //  Returns the number of elements kept
+        template< typename Size, typename Flags, typename Emit >
+        Size compact( Size n, const Flags& flags, const Emit& emit )
+        {
+            compact_body< Size, Flags, Emit > body( flags, emit );
+            if( n != 0 )
+            {
+                bolt::btbb::execute( [ & ]( )
+                {
+                    tbb::parallel_scan( tbb::blocked_range< Size >( 0, n ), body );
+                } );
+            }
+            return body.sum;
+        }
+
+        //  Keeps element i when pred( stencil[ i ] ) differs from reject
+        template< typename Iterator, typename Predicate >
+        struct select_flags
+        {
+            Iterator stencil;
+            Predicate pred;
+            bool reject;
+
+            select_flags( Iterator _stencil, Predicate _pred, bool _reject = false ):
+                stencil( _stencil ), pred( _pred ), reject( _reject )
+            {}
+
+            bool operator()( size_t i )
+            {
+                return pred( *( stencil + i ) ) != reject;
+            }
+        };
+
+        //  Keeps the first element of every group of consecutive equal elements
+        template< typename Iterator, typename BinaryPredicate >
+        struct unique_flags
+        {
+            Iterator first;
+            BinaryPredicate pred;
+
+            unique_flags( Iterator _first, BinaryPredicate _pred ): first( _first ), pred( _pred )
+            {}
+
+            bool operator()( size_t i )
+            {
+                return ( i == 0 ) || !pred( *( first + ( i - 1 ) ), *( first + i ) );
+            }
+        };
+
+        //  Copies kept elements to result
+        template< typename InputIterator, typename OutputIterator >
+        struct copy_emit
+        {
+            InputIterator first;
+            OutputIterator result;
+
+            copy_emit( InputIterator _first, OutputIterator _result ): first( _first ), result( _result )
+            {}
+
+            void keep( size_t i, size_t position )
+            {
+                *( result + position ) = *( first + i );
+            }
+
+            void reject( size_t, size_t )
+            {}
+        };
+
+        //  Copies the keys and the values of kept elements
+        template< typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2 >
+        struct copy_by_key_emit
+        {
+            InputIterator1 keys_first;
+            InputIterator2 values_first;
+            OutputIterator1 keys_result;
+            OutputIterator2 values_result;
+
+            copy_by_key_emit( InputIterator1 _keys_first, InputIterator2 _values_first, OutputIterator1 _keys_result,
+                OutputIterator2 _values_result ): keys_first( _keys_first ), values_first( _values_first ),
+                keys_result( _keys_result ), values_result( _values_result )
+            {}
+
+            void keep( size_t i, size_t position )
+            {
+                *( keys_result + position ) = *( keys_first + i );
+                *( values_result + position ) = *( values_first + i );
+            }
+
+            void reject( size_t, size_t )
+            {}
+        };
+
+        //  Copies kept elements to out_true and rejected elements to out_false
+        template< typename InputIterator, typename OutputIterator1, typename OutputIterator2 >
+        struct partition_emit
+        {
+            InputIterator first;
+            OutputIterator1 out_true;
+            OutputIterator2 out_false;
+
+            partition_emit( InputIterator _first, OutputIterator1 _out_true, OutputIterator2 _out_false ):
+                first( _first ), out_true( _out_true ), out_false( _out_false )
+            {}
+
+            void keep( size_t i, size_t position )
+            {
+                *( out_true + position ) = *( first + i );
+            }
+
+            void reject( size_t i, size_t position )
+            {
+                *( out_false + position ) = *( first + i );
+            }
+        };
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(InputIterator1 first, InputIterator1 last,
+                      InputIterator2 stencil, OutputIterator result, Predicate pred)
+        {
+            size_t n = static_cast< size_t >( std::distance( first, last ) );
+            return result + compact( n, select_flags< InputIterator2, Predicate >( stencil, pred ),
+                copy_emit< InputIterator1, OutputIterator >( first, result ) );
+        }
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(InputIterator first, InputIterator last, OutputIterator result, Predicate pred)
+        {
+            return bolt::btbb::copy_if( first, last, first, result, pred );
+        }
 
 
     } //btbb
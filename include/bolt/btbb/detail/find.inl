@@ -19,7 +19,7 @@
 #define BOLT_BTBB_FIND_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include <iterator>
@@ -33,14 +33,14 @@ namespace bolt{
              struct find
 			 {
                find () {}
-				void operator()( InputIterator& first, int n, unsigned int* result, Predicate& pred)
+				void operator()( InputIterator& first, size_t n, size_t* result, Predicate& pred)
                 {
 				    
-                      tbb::parallel_for(  tbb::blocked_range<int>(0, (int) n) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
+                      tbb::parallel_for(  tbb::blocked_range<size_t>(0, static_cast< size_t >( n )) ,
+                        [&] (const tbb::blocked_range<size_t> &r) -> void
                         {
                               
-                              for(int i = r.begin(); i!=r.end(); i++)
+                              for(size_t i = r.begin(); i!=r.end(); i++)
                               {
 							     if(pred(*(first+i))) 
 									*(result+i) = i;
@@ -60,15 +60,16 @@ namespace bolt{
 							     )
             {
                
-               //This allows TBB to choose the number of threads to spawn.
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-			   int szElements = static_cast< int >( std::distance( first, last ) );
-			   std::vector<unsigned int> index(szElements);
+			   size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+			   std::vector<size_t> index(szElements);
 
                find<InputIterator, Predicate> find_op;
-               find_op(first, szElements, &index[0], pred);
+               bolt::btbb::execute( [ & ]( )
+               {
+                   find_op(first, szElements, &index[0], pred);
+               } );
 
-			   std::vector<unsigned int>::iterator itr = bolt::btbb::min_element( index.begin(), index.end(), bolt::amp::less<unsigned int>());
+			   std::vector<size_t>::iterator itr = bolt::btbb::min_element( index.begin(), index.end(), bolt::amp::less<size_t>());
 			   return first + itr[0];
             }
 
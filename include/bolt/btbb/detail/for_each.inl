@@ -23,7 +23,7 @@
 #define BOLT_BTBB_FOR_EACH_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 
@@ -56,11 +56,11 @@ namespace bolt{
 
 				void operator()( InputIterator first, Size n, UnaryFunction f)
                 {
-                    tbb::parallel_for(  tbb::blocked_range<int>(0, (int) n) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
+                    tbb::parallel_for(  tbb::blocked_range<size_t>(0, static_cast< size_t >( n )) ,
+                        [&] (const tbb::blocked_range<size_t> &r) -> void
                         {
                               
-                              for(int i = r.begin(); i!=r.end(); i++)
+                              for(size_t i = r.begin(); i!=r.end(); i++)
                               {
                                  
                                    f(*(first+i));
@@ -77,22 +77,23 @@ namespace bolt{
 		    template<typename InputIterator , typename UnaryFunction >   
             void for_each (InputIterator first, InputIterator last, UnaryFunction f)
 		    {
-		    	 //This allows TBB to choose the number of threads to spawn.
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
 		    
                  ForEach <InputIterator, UnaryFunction> for_each_op;
-                 for_each_op(first, last, f);
+                 bolt::btbb::execute( [ & ]( )
+                 {
+                     for_each_op(first, last, f);
+                 } );
 		    }
 		    
 		    template<typename InputIterator , typename Size , typename UnaryFunction >  
             void for_each_n  ( InputIterator  first,  Size  n,  UnaryFunction  f)
 		    {
 
-				//This allows TBB to choose the number of threads to spawn.
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-		    
                  ForEach_n <InputIterator, Size, UnaryFunction> for_each_op;
-                 for_each_op(first,  n, f);
+                 bolt::btbb::execute( [ & ]( )
+                 {
+                     for_each_op(first,  n, f);
+                 } );
 		    }
        
     } //tbb
@@ -22,7 +22,7 @@
 #if !defined( BOLT_BTBB_GATHER_INL )
 #define BOLT_BTBB_GATHER_INL
 #pragma once
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 
@@ -41,14 +41,15 @@ void gather(InputIterator1 mapfirst,
              OutputIterator result)
              { 
                 // std::cout<<"TBB code path...\n";
-                 size_t numElements = static_cast< unsigned int >( std::distance( mapfirst, maplast ) );
-                //This allows TBB to choose the number of threads to spawn.               
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);       
-                 tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
-                  {
-                    for(size_t iter = r.begin(); iter!=r.end(); iter++)
-                        *(result + (int)iter) = * (input + (int)mapfirst[(int)iter]); 
-                  });
+                 size_t numElements = static_cast< size_t >( std::distance( mapfirst, maplast ) );
+                 bolt::btbb::execute( [ & ]( )
+                 {
+                     tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                      {
+                        for(size_t iter = r.begin(); iter!=r.end(); iter++)
+                            *(result + iter) = * (input + mapfirst[iter]); 
+                      });
+                 } );
              }
 
 template<typename InputIterator1,
@@ -63,17 +64,18 @@ template<typename InputIterator1,
                   OutputIterator result)
         {
                  //std::cout<<"TBB code path...\n";
-                 size_t numElements = static_cast< unsigned int >( std::distance( mapfirst, maplast ) );
-                 //This allows TBB to choose the number of threads to spawn.               
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-                 tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                 size_t numElements = static_cast< size_t >( std::distance( mapfirst, maplast ) );
+                 bolt::btbb::execute( [ & ]( )
                  {
-                    for(size_t iter = r.begin(); iter!=r.end(); iter++)
-                    {
-                         if(stencil[(int)iter]== 1)	   
-                                 result[(int)iter] = input[mapfirst[(int)iter]];       
-                    }					
-                });
+                     tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                     {
+                        for(size_t iter = r.begin(); iter!=r.end(); iter++)
+                        {
+                             if(stencil[iter]== 1)	   
+                                     result[iter] = input[mapfirst[iter]];       
+                        }					
+                    });
+                 } );
         }
 
 
@@ -91,17 +93,18 @@ template<typename InputIterator1,
                   BinaryPredicate pred)
         {
                  //std::cout<<"TBB code path...\n";
-                 size_t numElements = static_cast< unsigned int >( std::distance( mapfirst, maplast) );
-                 //This allows TBB to choose the number of threads to spawn.               
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-                 tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                 size_t numElements = static_cast< size_t >( std::distance( mapfirst, maplast) );
+                 bolt::btbb::execute( [ & ]( )
                  {
-                    for(size_t iter = r.begin(); iter!=r.end(); iter++)
-                    {
-                         if(pred(stencil[(int)iter]))   
-                                  result[(int)iter] = input[mapfirst[(int)iter]]; 						            
-                    }					
-                });
+                     tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                     {
+                        for(size_t iter = r.begin(); iter!=r.end(); iter++)
+                        {
+                             if(pred(stencil[iter]))   
+                                      result[iter] = input[mapfirst[iter]]; 						            
+                        }					
+                    });
+                 } );
         }
 
     }
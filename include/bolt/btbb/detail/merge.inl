@@ -22,7 +22,7 @@
 
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_invoke.h"
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 
 namespace bolt{
     namespace btbb {
@@ -99,15 +99,16 @@ namespace bolt{
             InputIterator2 end2, OutputIterator out,StrictWeakCompare comp ) 
         {
 
-            tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-                parallel_for(     
-                   btbb::ParallelMerge<InputIterator1,InputIterator2,OutputIterator,
-            StrictWeakCompare>(begin1,end1,begin2,end2,out,comp),
-                   btbb::ParallelMergeCode<InputIterator1,InputIterator2,OutputIterator,
-            StrictWeakCompare> (),
-                   simple_partitioner() 
-                );
+                bolt::btbb::execute( [ & ]( )
+                {
+                    parallel_for(     
+                       btbb::ParallelMerge<InputIterator1,InputIterator2,OutputIterator,
+                StrictWeakCompare>(begin1,end1,begin2,end2,out,comp),
+                       btbb::ParallelMergeCode<InputIterator1,InputIterator2,OutputIterator,
+                StrictWeakCompare> (),
+                       simple_partitioner() 
+                    );
+                } );
 
             }
 
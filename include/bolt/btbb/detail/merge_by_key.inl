@@ -0,0 +1,61 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MERGE_BY_KEY_INL )
+#define BOLT_BTBB_MERGE_BY_KEY_INL
+#pragma once
+
+#include "bolt/btbb/detail/merge_path.inl"
+
+namespace bolt {
+    namespace btbb {
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+                 typename OutputIterator1, typename OutputIterator2, typename StrictWeakCompare>
+        std::pair<OutputIterator1, OutputIterator2> merge_by_key(InputIterator1 keys_first1,
+            InputIterator1 keys_last1, InputIterator2 keys_first2, InputIterator2 keys_last2,
+            InputIterator3 values_first1, InputIterator4 values_first2, OutputIterator1 keys_result,
+            OutputIterator2 values_result, StrictWeakCompare comp)
+        {
+            size_t aCount = static_cast< size_t >( std::distance( keys_first1, keys_last1 ) );
+            size_t bCount = static_cast< size_t >( std::distance( keys_first2, keys_last2 ) );
+            size_t total = aCount + bCount;
+            size_t numTiles = ( total + detail::mergePathTileSize - 1 ) / detail::mergePathTileSize;
+
+            bolt::btbb::execute( [ & ]( )
+            {
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numTiles ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                    {
+                        for( size_t t = r.begin( ); t != r.end( ); ++t )
+                        {
+                            size_t diag = t * detail::mergePathTileSize;
+                            size_t i = detail::merge_path( keys_first1, aCount, keys_first2, bCount, diag, comp );
+                            detail::merge_by_key_tile( keys_first1, aCount, keys_first2, bCount, values_first1,
+                                values_first2, keys_result, values_result, i, diag - i,
+                                std::min( detail::mergePathTileSize, total - diag ), comp );
+                        }
+                    } );
+            } );
+
+            return std::make_pair( keys_result + total, values_result + total );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_MERGE_BY_KEY_INL
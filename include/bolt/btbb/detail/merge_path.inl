@@ -0,0 +1,205 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MERGE_PATH_INL )
+#define BOLT_BTBB_MERGE_PATH_INL
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "bolt/btbb/arena.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+//  Merge-path partitioning.  The merge of two sorted ranges is a monotone path through the a/b grid; cutting it
+//  every mergePathTileSize steps splits the work into tiles of exactly the same size whatever the keys look like.  Ties
+//  are taken from a first, as std::merge does.
+
+namespace bolt {
+    namespace btbb {
+        namespace detail {
+
+            static const size_t mergePathTileSize = 1 << 14;
+
+            enum set_operation_type
+            {
+                set_union_op,
+                set_intersection_op,
+                set_difference_op,
+                set_symmetric_difference_op
+            };
+
+            //  Returns how many elements of a come before the diag'th element of the merge
+            template< typename Iterator1, typename Iterator2, typename Compare >
+            size_t merge_path( Iterator1 a, size_t aCount, Iterator2 b, size_t bCount, size_t diag, Compare comp )
+            {
+                size_t begin = diag > bCount ? diag - bCount : 0;
+                size_t end = std::min( diag, aCount );
+
+                while( begin < end )
+                {
+                    size_t mid = ( begin + end ) / 2;
+                    if( comp( *( b + ( diag - 1 - mid ) ), *( a + mid ) ) )
+                        end = mid;
+                    else
+                        begin = mid + 1;
+                }
+                return begin;
+            }
+
+            //  Walks count steps of the merge from (i, j) and applies op to every element it passes.  An element
+            //  of a with rank r among its equals in a, which has n equals in b, belongs to the intersection when
+            //  r < n and to the difference when r >= n; an element of b with rank s among its equals, which has m
+            //  equals in a, belongs to the union when s >= m.  The ranks carry over inside the tile, so searching
+            //  is only needed at the start of a tile and at the start of each new key.  Returns the number of
+            //  elements written, or that would be written when write is false.
+            template< typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare >
+            size_t set_operation_tile( Iterator1 a, size_t aCount, Iterator2 b, size_t bCount, size_t i, size_t j,
+                size_t count, set_operation_type op, Compare comp, OutputIterator result, bool write )
+            {
+                size_t written = 0;
+                size_t aRank = 0, aOther = 0, bRank = 0, bOther = 0;
+                bool aStarted = false, bStarted = false;
+
+                for( size_t step = 0; step < count; ++step )
+                {
+                    if( j >= bCount || ( i < aCount && !comp( *( b + j ), *( a + i ) ) ) )
+                    {
+                        if( aStarted && !comp( *( a + ( i - 1 ) ), *( a + i ) ) )
+                            ++aRank;
+                        else
+                        {
+                            aRank = i - static_cast< size_t >( std::lower_bound( a, a + i, *( a + i ), comp ) - a );
+                            aOther = static_cast< size_t >(
+                                std::upper_bound( b + j, b + bCount, *( a + i ), comp ) - ( b + j ) );
+                            aStarted = true;
+                        }
+
+                        bool keep = ( op == set_union_op ) ||
+                            ( ( op == set_intersection_op ) ? ( aRank < aOther ) : ( aRank >= aOther ) );
+                        if( keep )
+                        {
+                            if( write )
+                                *( result + written ) = *( a + i );
+                            ++written;
+                        }
+                        ++i;
+                    }
+                    else
+                    {
+                        if( bStarted && !comp( *( b + ( j - 1 ) ), *( b + j ) ) )
+                            ++bRank;
+                        else
+                        {
+                            bRank = j - static_cast< size_t >( std::lower_bound( b, b + j, *( b + j ), comp ) - b );
+                            bOther = i - static_cast< size_t >( std::lower_bound( a, a + i, *( b + j ), comp ) - a );
+                            bStarted = true;
+                        }
+
+                        bool keep = ( op == set_union_op || op == set_symmetric_difference_op ) &&
+                            ( bRank >= bOther );
+                        if( keep )
+                        {
+                            if( write )
+                                *( result + written ) = *( b + j );
+                            ++written;
+                        }
+                        ++j;
+                    }
+                }
+                return written;
+            }
+
+            //  Walks count steps of the merge from (i, j) and writes every key and its value at its place in the
+            //  merged output
+            template< typename KeyIterator1, typename KeyIterator2, typename ValueIterator1, typename ValueIterator2,
+                      typename KeyOutputIterator, typename ValueOutputIterator, typename Compare >
+            void merge_by_key_tile( KeyIterator1 keys1, size_t aCount, KeyIterator2 keys2, size_t bCount,
+                ValueIterator1 values1, ValueIterator2 values2, KeyOutputIterator keys_result,
+                ValueOutputIterator values_result, size_t i, size_t j, size_t count, Compare comp )
+            {
+                for( size_t step = 0; step < count; ++step )
+                {
+                    size_t out = i + j;
+                    if( j >= bCount || ( i < aCount && !comp( *( keys2 + j ), *( keys1 + i ) ) ) )
+                    {
+                        *( keys_result + out ) = *( keys1 + i );
+                        *( values_result + out ) = *( values1 + i );
+                        ++i;
+                    }
+                    else
+                    {
+                        *( keys_result + out ) = *( keys2 + j );
+                        *( values_result + out ) = *( values2 + j );
+                        ++j;
+                    }
+                }
+            }
+
+            //  Counts what every tile keeps, scans the counts, then writes every tile at its offset
+            template< typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare >
+            OutputIterator set_operation( Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2,
+                OutputIterator result, Compare comp, set_operation_type op )
+            {
+                size_t aCount = static_cast< size_t >( std::distance( first1, last1 ) );
+                size_t bCount = static_cast< size_t >( std::distance( first2, last2 ) );
+                size_t total = aCount + bCount;
+                if( total == 0 )
+                    return result;
+
+                size_t numTiles = ( total + mergePathTileSize - 1 ) / mergePathTileSize;
+                std::vector< size_t > offsets( numTiles + 1, 0 );
+
+                bolt::btbb::execute( [ & ]( )
+                {
+                    tbb::parallel_for( tbb::blocked_range< size_t >( 0, numTiles ),
+                        [ & ]( const tbb::blocked_range< size_t >& r )
+                        {
+                            for( size_t t = r.begin( ); t != r.end( ); ++t )
+                            {
+                                size_t diag = t * mergePathTileSize;
+                                size_t i = merge_path( first1, aCount, first2, bCount, diag, comp );
+                                offsets[ t + 1 ] = set_operation_tile( first1, aCount, first2, bCount, i, diag - i,
+                                    std::min( mergePathTileSize, total - diag ), op, comp, result, false );
+                            }
+                        } );
+
+                    for( size_t t = 0; t < numTiles; ++t )
+                        offsets[ t + 1 ] += offsets[ t ];
+
+                    tbb::parallel_for( tbb::blocked_range< size_t >( 0, numTiles ),
+                        [ & ]( const tbb::blocked_range< size_t >& r )
+                        {
+                            for( size_t t = r.begin( ); t != r.end( ); ++t )
+                            {
+                                size_t diag = t * mergePathTileSize;
+                                size_t i = merge_path( first1, aCount, first2, bCount, diag, comp );
+                                set_operation_tile( first1, aCount, first2, bCount, i, diag - i,
+                                    std::min( mergePathTileSize, total - diag ), op, comp, result + offsets[ t ],
+                                    true );
+                            }
+                        } );
+                } );
+
+                return result + offsets[ numTiles ];
+            }
+
+        } // namespace detail
+    } // namespace btbb
+} // namespace bolt
+
+#endif
@@ -0,0 +1,65 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_PARTITION_INL )
+#define BOLT_BTBB_PARTITION_INL
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "bolt/btbb/copy.h"
+
+namespace bolt {
+    namespace btbb {
+
+        template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+        std::pair<OutputIterator1, OutputIterator2> partition_copy(InputIterator first, InputIterator last,
+            OutputIterator1 out_true, OutputIterator2 out_false, Predicate pred)
+        {
+            size_t n = static_cast< size_t >( std::distance( first, last ) );
+            size_t kept = compact( n, select_flags< InputIterator, Predicate >( first, pred ),
+                partition_emit< InputIterator, OutputIterator1, OutputIterator2 >( first, out_true, out_false ) );
+            return std::make_pair( out_true + kept, out_false + ( n - kept ) );
+        }
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(ForwardIterator first, ForwardIterator last, Predicate pred)
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type vType;
+            std::vector< vType > source( first, last );
+            size_t n = static_cast< size_t >( source.size( ) );
+
+            //  The number of kept elements is only known at the end, so rejected elements are written backwards
+            //  from the end of the range and turned around afterwards
+            std::reverse_iterator< ForwardIterator > rejected( last );
+            size_t kept = compact( n, select_flags< typename std::vector< vType >::iterator, Predicate >(
+                source.begin( ), pred ), partition_emit< typename std::vector< vType >::iterator, ForwardIterator,
+                    std::reverse_iterator< ForwardIterator > >( source.begin( ), first, rejected ) );
+            std::reverse( first + kept, last );
+            return first + kept;
+        }
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(ForwardIterator first, ForwardIterator last, Predicate pred)
+        {
+            return bolt::btbb::stable_partition( first, last, pred );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_PARTITION_INL
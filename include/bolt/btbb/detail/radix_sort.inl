@@ -0,0 +1,370 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_RADIX_SORT_INL )
+#define BOLT_BTBB_RADIX_SORT_INL
+#pragma once
+
+#include "bolt/btbb/arena.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "bolt/btbb/scratch.h"
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace bolt {
+    namespace btbb {
+
+        namespace detail {
+
+            //  Bits sorted per pass; the 256 counters of a block stay in L1 while it is read
+            static const int radixSortBits = 8;
+            static const size_t radixSortBuckets = size_t( 1 ) << radixSortBits;
+
+            //  Ranges at or below this length are sorted serially with std::stable_sort
+            static const std::ptrdiff_t radixSortSerialCutoff = 4096;
+
+            //  Fewest elements a block is given; the number of blocks is also capped at a few per thread
+            static const size_t radixSortMinBlock = 64 * 1024;
+
+            //  Bytes each bucket gathers before it is written out
+            static const size_t radixSortLineBytes = 64;
+
+            template< size_t Bytes > struct RadixWord;
+            template< > struct RadixWord< 1 > { typedef unsigned char type; };
+            template< > struct RadixWord< 2 > { typedef unsigned short type; };
+            template< > struct RadixWord< 4 > { typedef unsigned int type; };
+            template< > struct RadixWord< 8 > { typedef unsigned long long type; };
+
+            //  Maps a key onto an unsigned word of the same width whose unsigned order is the order of less<>.
+            //  Signed integers have their sign bit flipped.  Floating point keys have every bit flipped when they
+            //  are negative and the sign bit set otherwise, after negative zero is folded onto positive zero.
+            template< typename T >
+            struct RadixKey
+            {
+                typedef typename RadixWord< sizeof( T ) >::type word;
+
+                static word get( const T& value )
+                {
+                    const word signBit = word( word( 1 ) << ( sizeof( T ) * 8 - 1 ) );
+
+                    word bits;
+                    std::memcpy( &bits, &value, sizeof( T ) );
+
+                    if( std::is_floating_point< T >::value )
+                    {
+                        if( bits == signBit )
+                            bits = 0;
+                        return ( bits & signBit ) ? word( ~bits ) : word( bits | signBit );
+                    }
+                    if( std::is_signed< T >::value )
+                        return word( bits ^ signBit );
+                    return bits;
+                }
+
+                static size_t digit( const T& value, int shift )
+                {
+                    return static_cast< size_t >( get( value ) >> shift ) & ( radixSortBuckets - 1 );
+                }
+            };
+
+            //  Software write combining for the scatter of one block.  Each bucket gathers a cache line of keys
+            //  before they are copied to its next free position, so the block writes whole lines to at most 256
+            //  streams instead of touching a destination line for every element.  The values travelling with the
+            //  keys, if any, are gathered alongside and flushed with them.
+            template< typename T, typename OutputIterator >
+            class RadixScatter
+            {
+            public:
+                RadixScatter( size_t* offsets, OutputIterator out ): m_offsets( offsets ), m_out( out )
+                {
+                    std::fill( m_fill, m_fill + radixSortBuckets, size_t( 0 ) );
+                }
+
+                void push( size_t bucket, const T& value )
+                {
+                    m_lines[ bucket ][ m_fill[ bucket ]++ ] = value;
+                    if( m_fill[ bucket ] == lineElements )
+                        flush( bucket );
+                }
+
+                void flush( )
+                {
+                    for( size_t bucket = 0; bucket < radixSortBuckets; ++bucket )
+                        flush( bucket );
+                }
+
+            protected:
+                enum { lineElements = ( radixSortLineBytes > sizeof( T ) ) ? radixSortLineBytes / sizeof( T ) : 1 };
+
+                void flush( size_t bucket )
+                {
+                    std::copy( m_lines[ bucket ], m_lines[ bucket ] + m_fill[ bucket ], m_out + m_offsets[ bucket ] );
+                    m_offsets[ bucket ] += m_fill[ bucket ];
+                    m_fill[ bucket ] = 0;
+                }
+
+                T m_lines[ radixSortBuckets ][ lineElements ];
+                size_t m_fill[ radixSortBuckets ];
+                size_t* m_offsets;
+                OutputIterator m_out;
+            };
+
+            template< typename T, typename OutputIterator, typename V, typename ValueOutputIterator >
+            class RadixPairScatter: public RadixScatter< T, OutputIterator >
+            {
+                typedef RadixScatter< T, OutputIterator > base;
+
+            public:
+                RadixPairScatter( size_t* offsets, OutputIterator out, ValueOutputIterator valueOut ):
+                    base( offsets, out ), m_valueOut( valueOut )
+                {}
+
+                void push( size_t bucket, const T& key, const V& value )
+                {
+                    m_values[ bucket ][ base::m_fill[ bucket ] ] = value;
+                    base::m_lines[ bucket ][ base::m_fill[ bucket ]++ ] = key;
+                    if( base::m_fill[ bucket ] == base::lineElements )
+                        flush( bucket );
+                }
+
+                void flush( )
+                {
+                    for( size_t bucket = 0; bucket < radixSortBuckets; ++bucket )
+                        flush( bucket );
+                }
+
+            private:
+                void flush( size_t bucket )
+                {
+                    std::copy( m_values[ bucket ], m_values[ bucket ] + base::m_fill[ bucket ],
+                        m_valueOut + base::m_offsets[ bucket ] );
+                    base::flush( bucket );
+                }
+
+                V m_values[ radixSortBuckets ][ base::lineElements ];
+                ValueOutputIterator m_valueOut;
+            };
+
+            //  Splits n keys into blocks: at least radixSortMinBlock keys each, and no more than a few per thread
+            inline void radixBlocks( size_t n, size_t& blocks, size_t& blockLength )
+            {
+                size_t maxBlocks = 4 * static_cast< size_t >( tbb::this_task_arena::max_concurrency( ) );
+                blocks = std::max< size_t >( 1, std::min( maxBlocks, n / radixSortMinBlock ) );
+                blockLength = ( n + blocks - 1 ) / blocks;
+            }
+
+            //  Counts the digit at shift per block and turns the counts into each block's offsets in digit major
+            //  order.  Returns false when all the keys share the digit, so the pass would move nothing.
+            template< typename InputIterator >
+            bool radixCount( InputIterator src, size_t n, int shift, size_t blocks, size_t blockLength,
+                std::vector< size_t >& counts )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type T;
+
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, blocks, 1 ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                {
+                    for( size_t b = r.begin( ); b != r.end( ); ++b )
+                    {
+                        size_t* histogram = &counts[ b * radixSortBuckets ];
+                        std::fill( histogram, histogram + radixSortBuckets, size_t( 0 ) );
+
+                        size_t end = std::min( n, ( b + 1 ) * blockLength );
+                        for( size_t i = b * blockLength; i < end; ++i )
+                            ++histogram[ RadixKey< T >::digit( src[ i ], shift ) ];
+                    }
+                } );
+
+                size_t offset = 0;
+                for( size_t bucket = 0; bucket < radixSortBuckets; ++bucket )
+                {
+                    size_t total = 0;
+                    for( size_t b = 0; b < blocks; ++b )
+                    {
+                        size_t count = counts[ b * radixSortBuckets + bucket ];
+                        counts[ b * radixSortBuckets + bucket ] = offset;
+                        offset += count;
+                        total += count;
+                    }
+                    if( total == n )
+                        return false;
+                }
+
+                return true;
+            }
+
+            //  One pass over the digit at shift.  Returns false, having moved nothing, when all the keys share it.
+            template< typename InputIterator, typename OutputIterator >
+            bool radixPass( InputIterator src, OutputIterator dst, size_t n, int shift,
+                size_t blocks, size_t blockLength, std::vector< size_t >& counts )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type T;
+
+                if( !radixCount( src, n, shift, blocks, blockLength, counts ) )
+                    return false;
+
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, blocks, 1 ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                {
+                    for( size_t b = r.begin( ); b != r.end( ); ++b )
+                    {
+                        RadixScatter< T, OutputIterator > scatter( &counts[ b * radixSortBuckets ], dst );
+
+                        size_t end = std::min( n, ( b + 1 ) * blockLength );
+                        for( size_t i = b * blockLength; i < end; ++i )
+                            scatter.push( RadixKey< T >::digit( src[ i ], shift ), src[ i ] );
+                        scatter.flush( );
+                    }
+                } );
+
+                return true;
+            }
+
+            //  As radixPass, moving the value at the same position along with each key
+            template< typename InputIterator, typename ValueInputIterator, typename OutputIterator,
+                typename ValueOutputIterator >
+            bool radixPairPass( InputIterator src, ValueInputIterator valueSrc, OutputIterator dst,
+                ValueOutputIterator valueDst, size_t n, int shift, size_t blocks, size_t blockLength,
+                std::vector< size_t >& counts )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type T;
+                typedef typename std::iterator_traits< ValueInputIterator >::value_type V;
+                typedef RadixPairScatter< T, OutputIterator, V, ValueOutputIterator > Scatter;
+
+                if( !radixCount( src, n, shift, blocks, blockLength, counts ) )
+                    return false;
+
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, blocks, 1 ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                {
+                    for( size_t b = r.begin( ); b != r.end( ); ++b )
+                    {
+                        //  The value lines grow with the value type, so they live on the heap
+                        boost::scoped_ptr< Scatter > scatter(
+                            new Scatter( &counts[ b * radixSortBuckets ], dst, valueDst ) );
+
+                        size_t end = std::min( n, ( b + 1 ) * blockLength );
+                        for( size_t i = b * blockLength; i < end; ++i )
+                            scatter->push( RadixKey< T >::digit( src[ i ], shift ), src[ i ], valueSrc[ i ] );
+                        scatter->flush( );
+                    }
+                } );
+
+                return true;
+            }
+
+            template< typename InputIterator, typename OutputIterator >
+            void parallelCopy( InputIterator src, size_t n, OutputIterator dst )
+            {
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, n ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                {
+                    std::copy( src + r.begin( ), src + r.end( ), dst + r.begin( ) );
+                } );
+            }
+
+        } // detail
+
+        template< typename RandomAccessIterator >
+        void radix_sort( RandomAccessIterator first, RandomAccessIterator last )
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+            static_assert( detail::radix_sortable< T >::value, "radix_sort only sorts integral and floating point keys" );
+
+            std::ptrdiff_t length = std::distance( first, last );
+            if( length <= detail::radixSortSerialCutoff )
+            {
+                std::stable_sort( first, last );
+                return;
+            }
+
+            size_t n = static_cast< size_t >( length );
+            detail::ScratchArray< T > buffer( n );
+
+            bolt::btbb::execute( [ & ]( )
+            {
+                size_t blocks, blockLength;
+                detail::radixBlocks( n, blocks, blockLength );
+                std::vector< size_t > counts( blocks * detail::radixSortBuckets );
+
+                //  Each pass that moves the keys moves them to the other array
+                bool inBuffer = false;
+                for( int shift = 0; shift < static_cast< int >( sizeof( T ) * 8 ); shift += detail::radixSortBits )
+                {
+                    bool moved = inBuffer ?
+                        detail::radixPass( buffer.get( ), first, n, shift, blocks, blockLength, counts ) :
+                        detail::radixPass( first, buffer.get( ), n, shift, blocks, blockLength, counts );
+                    if( moved )
+                        inBuffer = !inBuffer;
+                }
+
+                if( inBuffer )
+                    detail::parallelCopy( buffer.get( ), n, first );
+            } );
+        }
+
+        template< typename RandomAccessIterator1, typename RandomAccessIterator2 >
+        void radix_sort_by_key( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+            RandomAccessIterator2 values_first )
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type T;
+            typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type V;
+            static_assert( detail::radix_sortable< T >::value,
+                "radix_sort_by_key only sorts integral and floating point keys" );
+
+            std::ptrdiff_t length = std::distance( keys_first, keys_last );
+            if( length < 2 )
+                return;
+
+            size_t n = static_cast< size_t >( length );
+            detail::ScratchArray< T > keyBuffer( n );
+            detail::ScratchArray< V > valueBuffer( n );
+
+            bolt::btbb::execute( [ & ]( )
+            {
+                size_t blocks, blockLength;
+                detail::radixBlocks( n, blocks, blockLength );
+                std::vector< size_t > counts( blocks * detail::radixSortBuckets );
+
+                bool inBuffer = false;
+                for( int shift = 0; shift < static_cast< int >( sizeof( T ) * 8 ); shift += detail::radixSortBits )
+                {
+                    bool moved = inBuffer ?
+                        detail::radixPairPass( keyBuffer.get( ), valueBuffer.get( ), keys_first, values_first,
+                            n, shift, blocks, blockLength, counts ) :
+                        detail::radixPairPass( keys_first, values_first, keyBuffer.get( ), valueBuffer.get( ),
+                            n, shift, blocks, blockLength, counts );
+                    if( moved )
+                        inBuffer = !inBuffer;
+                }
+
+                if( inBuffer )
+                {
+                    detail::parallelCopy( keyBuffer.get( ), n, keys_first );
+                    detail::parallelCopy( valueBuffer.get( ), n, values_first );
+                }
+            } );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_RADIX_SORT_INL
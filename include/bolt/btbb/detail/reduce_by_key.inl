@@ -19,7 +19,7 @@
 #define BOLT_BTBB_REDUCE_BY_KEY_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 #include <iterator>
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
@@ -54,36 +54,36 @@ namespace bolt
 		  InputIterator2& first_value;
           OutputIterator1& key_result;
 		  OutputIterator2& result;
-		  unsigned int numElements, strt_indx, end_indx;
+		  size_t numElements, strt_indx, end_indx;
 		  const BinaryFunction binary_op;
 		  const BinaryPredicate binary_pred;
 		  bool flag, pre_flag, next_flag;
-          std::vector<int> & t_key_array;
+          std::vector<size_t> & t_key_array;
 		  public:
 		  reduce_by_key_tbb() : sum(0), sum_key(0){}
 		  reduce_by_key_tbb( InputIterator1&  _first,
 			InputIterator2& first_val,
             OutputIterator1& _key_result,
 			OutputIterator2& _result,
-		    unsigned int _numElements,
+		    size_t _numElements,
 			const BinaryPredicate &_pred,
             const BinaryFunction &_opr,
-            std::vector<int> & _t_key_array) : first_key(_first), first_value(first_val), key_result(_key_result), result(_result), numElements(_numElements), binary_op(_opr), binary_pred(_pred),
+            std::vector<size_t> & _t_key_array) : first_key(_first), first_value(first_val), key_result(_key_result), result(_result), numElements(_numElements), binary_op(_opr), binary_pred(_pred),
 							 flag(false), pre_flag(true),next_flag(false), t_key_array(_t_key_array){}
 		  oType get_sum() const {return sum;}
           key_oType get_sum_key() const {return sum_key;}
 		  template<typename Tag>
-		  void operator()( const tbb::blocked_range<unsigned int>& r, Tag ) 
+		  void operator()( const tbb::blocked_range<size_t>& r, Tag ) 
           {
 
 			  oType temp = sum;
               key_oType temp_key = sum_key;
              
 			  next_flag = flag = false;
-              unsigned int i;
+              size_t i;
 			  strt_indx = r.begin();
               end_indx = r.end();
-			  unsigned int rend = r.end();
+			  size_t rend = r.end();
 
 
 			  for( i=r.begin(); i<rend; ++i ) 
@@ -181,7 +181,7 @@ template<
            typename BinaryPredicate,
            typename BinaryFunction>
 
-           unsigned int reduce_by_key( 
+           size_t reduce_by_key( 
                             InputIterator1  keys_first,
 	                        InputIterator1  keys_last,
 	                        InputIterator2  vals_first,
@@ -191,42 +191,37 @@ template<
                             BinaryFunction binary_op )
 
 	{
-		unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+		size_t numElements = static_cast< size_t >( std::distance( keys_first, keys_last ) );
 		typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
 
-		//tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
+        std::vector<size_t> t_key_array(numElements);
 
-		//Gets the number of concurrent threads supported by the underlying platform
-        //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-		unsigned int concurentThreadsSupported = tbb::task_scheduler_init::default_num_threads();
-	    //Explicitly setting the number of threads to spawn
-        tbb::task_scheduler_init((int) concurentThreadsSupported);
 
-        std::vector<int> t_key_array(numElements);
-
-
-		tbb::parallel_for (tbb::blocked_range<int>(0,numElements),[&](const tbb::blocked_range<int>& r)
-        {
-					int rend = r.end();
-                    for(int iter = r.begin(); iter!=rend; iter++)
-                    {   
-						    if(iter == 0)
-                            {  
-                                t_key_array[iter] = 0;
-
-                            }
-                            else if(binary_pred( keys_first[iter], keys_first[iter-1]))
+		bolt::btbb::execute( [ & ]( )
+		{
+			tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+            {
+						size_t rend = r.end();
+                        for(size_t iter = r.begin(); iter!=rend; iter++)
+                        {   
+							    if(iter == 0)
+                                {  
+                                    t_key_array[iter] = 0;
+
+                                }
+                                else if(binary_pred( keys_first[iter], keys_first[iter-1]))
                             
-                                t_key_array[iter] = 0;
-                            else 
-                                t_key_array[iter] = 1;
-                    }
-       }); 
+                                    t_key_array[iter] = 0;
+                                else 
+                                    t_key_array[iter] = 1;
+                        }
+           }); 
+		} );
                     
-	   std::vector<int>::iterator it;
+	   std::vector<size_t>::iterator it;
 	   it = t_key_array.begin();
 
-       bolt::btbb::inclusive_scan(it,  it + numElements , it, std::plus<int>() );
+       bolt::btbb::inclusive_scan(it,  it + numElements , it, std::plus<size_t>() );
 
         /*int val = 0;
         for( unsigned int i=0; i<numElements; ++i ) 
@@ -245,7 +240,10 @@ template<
 
 		reduce_by_key_tbb<InputIterator1, InputIterator2, OutputIterator1, OutputIterator2, BinaryPredicate, BinaryFunction> tbbkey_scan((InputIterator1 &) keys_first,
 			(InputIterator2&) vals_first, (OutputIterator1 &)keys_result, (OutputIterator2 &)vals_result, numElements,  binary_pred, binary_op, t_key_array);
-		tbb::parallel_scan( tbb::blocked_range<unsigned int>(  0, numElements, 6250), tbbkey_scan, tbb::simple_partitioner());
+		bolt::btbb::execute( [ & ]( )
+		{
+			tbb::parallel_scan( tbb::blocked_range<size_t>(  0, numElements, 6250), tbbkey_scan, tbb::simple_partitioner());
+		} );
 
 		return numElements;
 
@@ -259,7 +257,7 @@ template<
 	typename OutputIterator1,
 	typename OutputIterator2,
 	typename BinaryPredicate>
-unsigned int
+size_t
 reduce_by_key(
 	InputIterator1  keys_first,
 	InputIterator1  keys_last,
@@ -279,7 +277,7 @@ template<
 	typename InputIterator2,
     typename OutputIterator1,
 	typename OutputIterator2>
-unsigned int
+size_t
 reduce_by_key(
 	InputIterator1  keys_first,
 	InputIterator1  keys_last,
@@ -0,0 +1,48 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_REMOVE_INL )
+#define BOLT_BTBB_REMOVE_INL
+#pragma once
+
+#include <vector>
+#include "bolt/btbb/copy.h"
+
+namespace bolt {
+    namespace btbb {
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(InputIterator first, InputIterator last, OutputIterator result, Predicate pred)
+        {
+            size_t n = static_cast< size_t >( std::distance( first, last ) );
+            return result + compact( n, select_flags< InputIterator, Predicate >( first, pred, true ),
+                copy_emit< InputIterator, OutputIterator >( first, result ) );
+        }
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(ForwardIterator first, ForwardIterator last, Predicate pred)
+        {
+            //  Elements move towards the front from other threads' ranges, so compact a copy back into the range
+            typedef typename std::iterator_traits< ForwardIterator >::value_type vType;
+            std::vector< vType > source( first, last );
+            return bolt::btbb::remove_copy_if( source.begin( ), source.end( ), first, pred );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_REMOVE_INL
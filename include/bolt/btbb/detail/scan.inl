@@ -25,6 +25,7 @@
 
 //#include <thread>
 #include "tbb/partitioner.h"
+#include "bolt/btbb/arena.h"
 
 namespace bolt {
 namespace   btbb {
@@ -45,10 +46,10 @@ namespace   btbb {
                     const bool &_incl ,const T &init) : x(_x), y(_y), scan_op(_opr),inclusive(_incl),start(init),flag(true){}
           T get_sum() const {return sum;}
           template<typename Tag>
-          void operator()( const tbb::blocked_range<int>& r, Tag ) {
+          void operator()( const tbb::blocked_range<size_t>& r, Tag ) {
              T temp = sum, temp1;
-			 int rend = r.end();
-             for(int i=r.begin(); i<rend; ++i ) {
+			 size_t rend = r.end();
+             for(size_t i=r.begin(); i<rend; ++i ) {
                  if(Tag::is_final_scan()){
                      if(!inclusive){
                         if(i==0 ) {
@@ -104,21 +105,16 @@ inclusive_scan(
     BinaryFunction binary_op)
     {
 
-               unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
+               size_t numElements = static_cast< size_t >( std::distance( first, last ) );
 			   typedef typename std::iterator_traits< OutputIterator >::value_type oType;
-               //tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-			   //Gets the number of concurrent threads supported by the underlying platform
-               //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-			   unsigned int concurentThreadsSupported = tbb::task_scheduler_init::default_num_threads();
-
-			   //Explicitly setting the number of threads to spawn
-               tbb::task_scheduler_init((int) concurentThreadsSupported);
 
                Scan_tbb<InputIterator, OutputIterator, BinaryFunction, oType> tbb_scan((InputIterator &)first,(OutputIterator &)
                                                                          result,binary_op,true, oType());
 
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last )), 12500), tbb_scan, tbb::simple_partitioner() );
+               bolt::btbb::execute( [ & ]( )
+               {
+                   tbb::parallel_scan( tbb::blocked_range<size_t>(  0, numElements, 12500), tbb_scan, tbb::simple_partitioner() );
+               } );
                return result + numElements;
     }
 
@@ -139,21 +135,16 @@ OutputIterator
     exclusive_scan( InputIterator first, InputIterator last, OutputIterator result, T init, BinaryFunction binary_op)
     {
 
-               unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
+               size_t numElements = static_cast< size_t >( std::distance( first, last ) );
 			   typedef typename std::iterator_traits< OutputIterator >::value_type oType;
-               //tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-			   //Gets the number of concurrent threads supported by the underlying platform
-               //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-			   unsigned int concurentThreadsSupported = tbb::task_scheduler_init::default_num_threads();
 
-			   //Explicitly setting the number of threads to spawn
-               tbb::task_scheduler_init((int) concurentThreadsSupported);
-			   
                Scan_tbb<InputIterator, OutputIterator, BinaryFunction, oType> tbb_scan((InputIterator &)first,(OutputIterator &)
                                                                          result,binary_op,false,init);
 
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last )), 12500), tbb_scan, tbb::simple_partitioner() );
+               bolt::btbb::execute( [ & ]( )
+               {
+                   tbb::parallel_scan( tbb::blocked_range<size_t>(  0, numElements, 12500), tbb_scan, tbb::simple_partitioner() );
+               } );
                return result + numElements;
     }
 
@@ -21,6 +21,7 @@
 
 //#include <thread>
 #include "tbb/partitioner.h"
+#include "bolt/btbb/arena.h"
 
 namespace bolt
 {
@@ -37,7 +38,7 @@ namespace bolt
 		  InputIterator1& first_key;
 		  InputIterator2& first_value;
 		  OutputIterator& result;
-		  unsigned int numElements, strt_indx, end_indx;
+		  size_t numElements, strt_indx, end_indx;
 		  const BinaryFunction binary_op;
 		  const BinaryPredicate binary_pred;
 		  const bool inclusive;
@@ -47,7 +48,7 @@ namespace bolt
 		  ScanKey_tbb( InputIterator1&  _first,
 			InputIterator2& first_val,
 			OutputIterator& _result,
-		    unsigned int _numElements,
+		    size_t _numElements,
 			const BinaryFunction &_opr,
 			const BinaryPredicate &_pred,
 			const bool& _incl,
@@ -55,13 +56,13 @@ namespace bolt
 							 inclusive(_incl), start(init), flag(false), pre_flag(true),next_flag(false){}
 		  oType get_sum() const {return sum;}
 		  template<typename Tag>
-		  void operator()( const tbb::blocked_range<unsigned int>& r, Tag ) {
+		  void operator()( const tbb::blocked_range<size_t>& r, Tag ) {
 			  oType temp = sum, temp1;
 			  next_flag = flag = false;
-              unsigned int i;
+              size_t i;
 			  strt_indx = r.begin();
               end_indx = r.end();
-			  unsigned int rend = r.end();
+			  size_t rend = r.end();
 			  for( i=r.begin(); i<rend; ++i ) {
 				 if( Tag::is_final_scan() ) {
 					 if(!inclusive){
@@ -156,20 +157,15 @@ inclusive_scan_by_key(
 	BinaryPredicate binary_pred,
 	BinaryFunction  binary_funct)
 	{
-		unsigned int numElements = static_cast< unsigned int >( std::distance( first1, last1 ) );
+		size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
 		typedef typename std::iterator_traits< OutputIterator >::value_type oType;
 
-		//tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-		//Gets the number of concurrent threads supported by the underlying platform
-        //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-		unsigned int concurentThreadsSupported = tbb::task_scheduler_init::default_num_threads();
-	    //Explicitly setting the number of threads to spawn
-        tbb::task_scheduler_init((int) concurentThreadsSupported);
-
 		ScanKey_tbb<InputIterator1, InputIterator2, OutputIterator, BinaryFunction, BinaryPredicate,oType> tbbkey_scan((InputIterator1 &)first1,
 			(InputIterator2&) first2,(OutputIterator &)result, numElements, binary_funct, binary_pred, true, oType());
-		tbb::parallel_scan( tbb::blocked_range<unsigned int>(  0, static_cast< unsigned int >( std::distance( first1, last1 )), 6250), tbbkey_scan, tbb::simple_partitioner());
+		bolt::btbb::execute( [ & ]( )
+		{
+			tbb::parallel_scan( tbb::blocked_range<size_t>(  0, numElements, 6250), tbbkey_scan, tbb::simple_partitioner());
+		} );
 
 		return result + numElements;
 
@@ -229,19 +225,14 @@ exclusive_scan_by_key(
 	BinaryPredicate binary_pred,
 	BinaryFunction  binary_funct)
 	{
-		unsigned int numElements = static_cast< unsigned int >( std::distance( first1, last1 ) );
-
-		//tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-		//Gets the number of concurrent threads supported by the underlying platform
-        //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-		unsigned int concurentThreadsSupported = tbb::task_scheduler_init::default_num_threads();
-	    //Explicitly setting the number of threads to spawn
-        tbb::task_scheduler_init((int) concurentThreadsSupported);
+		size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
 
 		ScanKey_tbb<InputIterator1, InputIterator2, OutputIterator, BinaryFunction, BinaryPredicate,T> tbbkey_scan((InputIterator1 &)first1,
 			(InputIterator2&) first2,(OutputIterator &)result, numElements, binary_funct, binary_pred, false, init);
-		tbb::parallel_scan( tbb::blocked_range<unsigned int>(  0, static_cast< unsigned int >( std::distance( first1, last1 )), 6250), tbbkey_scan, tbb::simple_partitioner());
+		bolt::btbb::execute( [ & ]( )
+		{
+			tbb::parallel_scan( tbb::blocked_range<size_t>(  0, numElements, 6250), tbbkey_scan, tbb::simple_partitioner());
+		} );
 		return result + numElements;
 
 	}
@@ -23,7 +23,7 @@
 #define BOLT_BTBB_SCATTER_INL
 
 #pragma once
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 namespace bolt 
@@ -40,14 +40,15 @@ void scatter(InputIterator1 first1,
              InputIterator2 map, 
              OutputIterator result)
              { 
-                 int numElements = static_cast< int >( std::distance( first1, last1 ) );
-                 //This allows TBB to choose the number of threads to spawn.               
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);  
-                 tbb::parallel_for (tbb::blocked_range<int>(0,numElements),[&](const tbb::blocked_range<int>& r)
+                 size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
+                 bolt::btbb::execute( [ & ]( )
                  {
-                    for(int iter = r.begin(); iter!=r.end(); iter++)
-                             result[*(map+(int)iter)] = first1[(int)iter];
-                 });
+                     tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                     {
+                        for(size_t iter = r.begin(); iter!=r.end(); iter++)
+                                 result[*(map+iter)] = first1[iter];
+                     });
+                 } );
              }
 
 template<typename InputIterator1,
@@ -61,17 +62,18 @@ template<typename InputIterator1,
                   InputIterator3 stencil,
                   OutputIterator result)
             {
-                 int numElements = static_cast< int >( std::distance( first1, last1 ) );
-                //This allows TBB to choose the number of threads to spawn.               
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);  
-                 tbb::parallel_for (tbb::blocked_range<int>(0,numElements),[&](const tbb::blocked_range<int>& r)
+                 size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
+                 bolt::btbb::execute( [ & ]( )
                  {
-                    for(int iter = r.begin(); iter!=r.end(); iter++)
-                    {
-                        if(stencil[iter] == 1)
-                            result[*(map+(int)iter)] = first1[(int)iter];
-                    }                            
-                 });
+                     tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                     {
+                        for(size_t iter = r.begin(); iter!=r.end(); iter++)
+                        {
+                            if(stencil[iter] == 1)
+                                result[*(map+iter)] = first1[iter];
+                        }                            
+                     });
+                 } );
            }
 
 
@@ -88,17 +90,18 @@ template<typename InputIterator1,
                   OutputIterator result,
                   BinaryPredicate pred)
            {
-			     int numElements = static_cast< int >( std::distance( first1, last1 ) );
-                //This allows TBB to choose the number of threads to spawn.               
-                 tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);  
-                 tbb::parallel_for (tbb::blocked_range<int>(0,numElements),[&](const tbb::blocked_range<int>& r)
+			     size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
+                 bolt::btbb::execute( [ & ]( )
                  {
-                    for(int iter = r.begin(); iter!=r.end(); iter++)
-                    {
-                       if(pred(stencil[(int)iter]))
-                            result[*(map+((int)iter))] = first1[(int)iter];
-                    }                            
-                 });
+                     tbb::parallel_for (tbb::blocked_range<size_t>(0,numElements),[&](const tbb::blocked_range<size_t>& r)
+                     {
+                        for(size_t iter = r.begin(); iter!=r.end(); iter++)
+                        {
+                           if(pred(stencil[iter]))
+                                result[*(map+iter)] = first1[iter];
+                        }                            
+                     });
+                 } );
             }
 
     }
@@ -0,0 +1,58 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SET_OPERATIONS_INL )
+#define BOLT_BTBB_SET_OPERATIONS_INL
+#pragma once
+
+#include "bolt/btbb/detail/merge_path.inl"
+
+namespace bolt {
+    namespace btbb {
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_union(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp)
+        {
+            return detail::set_operation( first1, last1, first2, last2, result, comp, detail::set_union_op );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_intersection(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp)
+        {
+            return detail::set_operation( first1, last1, first2, last2, result, comp, detail::set_intersection_op );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp)
+        {
+            return detail::set_operation( first1, last1, first2, last2, result, comp, detail::set_difference_op );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_symmetric_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp)
+        {
+            return detail::set_operation( first1, last1, first2, last2, result, comp, detail::set_symmetric_difference_op );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_SET_OPERATIONS_INL
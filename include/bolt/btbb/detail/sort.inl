@@ -19,29 +19,52 @@
 #define BOLT_BTBB_SORT_INL
 #pragma once
 
+#include "bolt/btbb/arena.h"
+#include "bolt/btbb/radix_sort.h"
+#include <iterator>
+
 
 namespace bolt {
     namespace btbb {
 
+        namespace detail {
+
+            template<typename RandomAccessIterator, typename StrictWeakOrdering>
+            void sort(RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering,
+                std::true_type )
+            {
+                bolt::btbb::radix_sort(first, last);
+            }
+
+            template<typename RandomAccessIterator, typename StrictWeakOrdering>
+            void sort(RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp,
+                std::false_type )
+            {
+                bolt::btbb::execute( [ & ]( )
+                {
+                    tbb::parallel_sort(first,last, comp);
+                } );
+            }
+
+        }
 
         template<typename RandomAccessIterator>
         void sort(RandomAccessIterator first,
             RandomAccessIterator last)
         {
-
-        tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-        tbb::parallel_sort(first,last);
+            typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+            bolt::btbb::sort(first, last, std::less< T >( ));
         }
 
+        //  Ascending sorts of arithmetic keys are radix sorted; every other ordering is compared
         template<typename RandomAccessIterator, typename StrictWeakOrdering>
         void sort(RandomAccessIterator first,
             RandomAccessIterator last,
             StrictWeakOrdering comp)
         {
-
-        tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-        tbb::parallel_sort(first,last, comp);
-
+            typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+            detail::sort(first, last, comp,
+                typename detail::radix_sort_ordering< T, StrictWeakOrdering >::type( ));
         }
 
     }
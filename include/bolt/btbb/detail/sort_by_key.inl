@@ -19,200 +19,167 @@
 #define BOLT_BTBB_SORT_BY_KEY_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
-//#include <thread>
+#include "bolt/btbb/arena.h"
+#include <climits>
 #include <iterator>
 
-#include "bolt/btbb/sort.h"
+#include "bolt/btbb/radix_sort.h"
+#include "bolt/btbb/stable_sort.h"
+#include "bolt/btbb/scratch.h"
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
 
 namespace bolt{
     namespace btbb {
-       
-              template <typename keyType, typename valueType>
-              class tbb_sort
-              {
-                  public:
-                    keyType   key;
-                    valueType value;
-              };
-
-              //This is the functor which will sort the tbb_sort vector. 
-              template <typename keyType, typename valueType, typename StrictWeakOrdering>
-              class tbb_sort_comp
-              {
-                  public:
-                     typedef tbb_sort<keyType, valueType> KeyValueType;
-                     tbb_sort_comp(const StrictWeakOrdering &_swo):swo(_swo) {}
-                     StrictWeakOrdering swo;
-                     bool operator() (const KeyValueType &lhs, const KeyValueType &rhs) const
-                     {
-                       return swo(lhs.key, rhs.key);
-                     }
-              };
-
-              template< typename RandomAccessIterator1, typename RandomAccessIterator2>
-              void Parallel_sort_by_key(const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last, 
-                                      const RandomAccessIterator2 values_first)
-              {
-                     typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
-                     typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valType;
-                     typedef tbb_sort<keyType, valType> KeyValuePair;
-       
-                     size_t vecSize = std::distance( keys_first, keys_last ); 
-                     std::vector<KeyValuePair> KeyValuePairVector(vecSize);
-
-                     //Zip the key and values iterators into a tbb_sort vector.
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   KeyValuePairVector[i].key   = *(keys_first + i);
-                                   KeyValuePairVector[i].value = *(values_first + i);
-                              }   
-                          
-                     });
-
-                     //Sort the tbb_sort vector using TBB sort
-                     bolt::btbb::sort(KeyValuePairVector.begin(), KeyValuePairVector.end());
-
-                     //Extract the keys and values from the KeyValuePair and fill the respective iterators. 
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   *(keys_first + i)   = KeyValuePairVector[i].key;
-                                   *(values_first + i) = KeyValuePairVector[i].value;
-                              }   
-                          
-                     });
-              }
-
-              template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
-              void Parallel_sort_by_key_comp(const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last, 
-                                      const RandomAccessIterator2 values_first, StrictWeakOrdering comp )
-              {
-                     typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
-                     typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valType;
-                     typedef tbb_sort<keyType, valType> KeyValuePair;
-                     typedef tbb_sort_comp<keyType, valType, StrictWeakOrdering> KeyValuePairFunctor;
-       
-                     size_t vecSize = std::distance( keys_first, keys_last ); 
-                     std::vector<KeyValuePair> KeyValuePairVector(vecSize);
-                     KeyValuePairFunctor functor(comp);
-
-                     //Zip the key and values iterators into a tbb_sort vector.
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   KeyValuePairVector[i].key   = *(keys_first + i);
-                                   KeyValuePairVector[i].value = *(values_first + i);
-                              }   
-                          
-                     });
-
-                     //Sort the tbb_sort vector using TBB sort
-                     bolt::btbb::sort(KeyValuePairVector.begin(), KeyValuePairVector.end(), functor);
-
-                     //Extract the keys and values from the KeyValuePair and fill the respective iterators.
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   *(keys_first + i)   = KeyValuePairVector[i].key;
-                                   *(values_first + i) = KeyValuePairVector[i].value;
-                              }   
-                          
-                     });
-             }
-
-             template< typename RandomAccessIterator1, typename RandomAccessIterator2 > 
-             struct SortByKey
-             {
-
-               SortByKey () {}  
-
-               void operator() ( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first)
-               {
-                    int n = (int) std::distance(keys_first, keys_last);
-
-                    if(n == 1)  // Only one element
-                         return; // Nothing to Sort!
-                    else
-                         Parallel_sort_by_key(keys_first, keys_last, values_first);
-                    
-               }          
-
-           };
-
-           template<typename RandomAccessIterator1,typename RandomAccessIterator2, typename StrictWeakOrdering>
-           struct SortByKey_comp
-           {
-
-               SortByKey_comp () {}  
-
-               void operator() (RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first, StrictWeakOrdering comp )
-               {
-                    int n = (int) std::distance(keys_first, keys_last);
-
-                    if(n == 1)  // Only one element
-                         return; // Nothing to Sort!
-                    else   
-                         Parallel_sort_by_key_comp(keys_first, keys_last, values_first,comp);
-                    
-               }    
 
-           };
+        //  The keys and the values are sorted where they are, never zipped into pairs.  Arithmetic keys in
+        //  ascending order are radix sorted with their values riding along; values larger than
+        //  radixByKeyValueBytes ride along as 32 bit positions instead and are permuted once at the end.  Any other
+        //  ordering merge sorts the positions by key and permutes keys and values through them.  Every path is
+        //  stable, so sort_by_key and stable_sort_by_key share it.
+        namespace detail {
+
+            static const size_t radixByKeyValueBytes = 8;
+
+            //  Orders positions by the keys they refer to
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            struct KeyIndexOrdering
+            {
+                KeyIndexOrdering( RandomAccessIterator keys, StrictWeakOrdering comp ): keys( keys ), comp( comp )
+                {}
+
+                template< typename Index >
+                bool operator( )( Index lhs, Index rhs ) const
+                {
+                    return comp( keys[ lhs ], keys[ rhs ] );
+                }
+
+                RandomAccessIterator keys;
+                StrictWeakOrdering comp;
+            };
+
+            template< typename Index >
+            void iotaIndex( Index* index, size_t n )
+            {
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, n ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                {
+                    for( size_t i = r.begin( ); i != r.end( ); ++i )
+                        index[ i ] = static_cast< Index >( i );
+                } );
+            }
+
+            //  data[ i ] becomes the old data[ index[ i ] ].  The elements are gathered into one buffer of their own
+            //  type and copied back, so each is read and written once and the work splits freely across threads.
+            template< typename RandomAccessIterator, typename Index >
+            void permute( RandomAccessIterator data, const Index* index, size_t n )
+            {
+                typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+
+                ScratchArray< T > gathered( n );
+                T* out = gathered.get( );
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, n ),
+                    [ & ]( const tbb::blocked_range< size_t >& r )
+                {
+                    for( size_t i = r.begin( ); i != r.end( ); ++i )
+                        out[ i ] = data[ index[ i ] ];
+                } );
+                parallelCopy( out, n, data );
+            }
+
+            template< typename Index, typename RandomAccessIterator1, typename RandomAccessIterator2,
+                typename StrictWeakOrdering >
+            void sortByKeyIndexed( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+                RandomAccessIterator2 values_first, StrictWeakOrdering, std::true_type )
+            {
+                size_t n = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+
+                ScratchArray< Index > index( n );
+                iotaIndex( index.get( ), n );
+                bolt::btbb::radix_sort_by_key( keys_first, keys_last, index.get( ) );
+                permute( values_first, index.get( ), n );
+            }
+
+            template< typename Index, typename RandomAccessIterator1, typename RandomAccessIterator2,
+                typename StrictWeakOrdering >
+            void sortByKeyIndexed( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+                RandomAccessIterator2 values_first, StrictWeakOrdering comp, std::false_type )
+            {
+                size_t n = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+
+                ScratchArray< Index > index( n );
+                iotaIndex( index.get( ), n );
+                detail::stable_sort( index.get( ), index.get( ) + n,
+                    KeyIndexOrdering< RandomAccessIterator1, StrictWeakOrdering >( keys_first, comp ),
+                    std::false_type( ) );
+                permute( keys_first, index.get( ), n );
+                permute( values_first, index.get( ), n );
+            }
+
+            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering,
+                typename RadixSortable >
+            void sortByKeyIndex( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+                RandomAccessIterator2 values_first, StrictWeakOrdering comp, RadixSortable radix )
+            {
+                if( static_cast< size_t >( std::distance( keys_first, keys_last ) ) <= UINT_MAX )
+                    sortByKeyIndexed< unsigned int >( keys_first, keys_last, values_first, comp, radix );
+                else
+                    sortByKeyIndexed< size_t >( keys_first, keys_last, values_first, comp, radix );
+            }
+
+            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+            void sortByKey( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+                RandomAccessIterator2 values_first, StrictWeakOrdering comp, std::true_type radix )
+            {
+                typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valType;
+
+                if( sizeof( valType ) <= radixByKeyValueBytes )
+                    bolt::btbb::radix_sort_by_key( keys_first, keys_last, values_first );
+                else
+                    sortByKeyIndex( keys_first, keys_last, values_first, comp, radix );
+            }
+
+            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+            void sortByKey( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+                RandomAccessIterator2 values_first, StrictWeakOrdering comp, std::false_type radix )
+            {
+                sortByKeyIndex( keys_first, keys_last, values_first, comp, radix );
+            }
+
+            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+            void sortByKey( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+                RandomAccessIterator2 values_first, StrictWeakOrdering comp )
+            {
+                typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
+
+                if( std::distance( keys_first, keys_last ) < 2 )
+                    return;
+
+                bolt::btbb::execute( [ & ]( )
+                {
+                    sortByKey( keys_first, keys_last, values_first, comp,
+                        typename radix_sort_ordering< keyType, StrictWeakOrdering >::type( ) );
+                } );
+            }
+
+        } // detail
 
            template< typename RandomAccessIterator1, typename RandomAccessIterator2 > 
            void sort_by_key( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, 
            RandomAccessIterator2 values_first)
            {
-                //Gets the number of concurrent threads supported by the underlying platform
-                //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-                //This allows TBB to choose the number of threads to spawn.
-                tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-                //Explicitly setting the number of threads to spawn
-                //tbb::task_scheduler_init((int) concurentThreadsSupported);
-
-                SortByKey <RandomAccessIterator1, RandomAccessIterator2 > sort_by_key_op;
-                sort_by_key_op(keys_first, keys_last, values_first);
+                typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
+                detail::sortByKey( keys_first, keys_last, values_first, std::less< keyType >( ) );
            }
 
            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering> 
            void sort_by_key( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first, 
            StrictWeakOrdering comp)
            {
-                //Gets the number of concurrent threads supported by the underlying platform
-                //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-                //This allows TBB to choose the number of threads to spawn.
-                tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-                //Explicitly setting the number of threads to spawn
-                //tbb::task_scheduler_init((int) concurentThreadsSupported);
-
-                SortByKey_comp <RandomAccessIterator1, RandomAccessIterator2, StrictWeakOrdering >sort_by_key_op;
-                sort_by_key_op(keys_first, keys_last, values_first, comp);
-          }
+                detail::sortByKey( keys_first, keys_last, values_first, comp );
+           }
        
     } //tbb
 } // bolt
 
-#endif //BTBB_SORT_BY_KEY_INL
\ No newline at end of file
+#endif //BTBB_SORT_BY_KEY_INL
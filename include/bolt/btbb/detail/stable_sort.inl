@@ -19,105 +19,152 @@
 #define BOLT_BTBB_STABLE_SORT_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
+#include "bolt/btbb/radix_sort.h"
 #include "tbb/parallel_invoke.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "bolt/btbb/scratch.h"
+#include <algorithm>
+#include <functional>
 #include <iterator>
 
 namespace bolt{
     namespace btbb {
-       
-             template<typename RandomAccessIterator>
-             struct StableSort
-             {
-
-               StableSort () {}  
-
-               void operator() (RandomAccessIterator first, RandomAccessIterator last)
-               {
-                    int n = (int) std::distance(first, last);
-
-                    if(n == 1)  // Only one element
-                         return; // Nothing to Sort!
-                    else
-                         Parallel_Merge_Sort(first, last);
-                    
-               }    
-
-               void Parallel_Merge_Sort(RandomAccessIterator beg, RandomAccessIterator end)
-               {
-                       if (end - beg > 1)
-                       {
-                             RandomAccessIterator mid = beg + (end - beg) / 2;
-
-                              tbb::parallel_invoke(
-                                [&] { Parallel_Merge_Sort( beg, mid); }, 
-                                [&] { Parallel_Merge_Sort( mid, end); }  
-                              );
-
-                             std::inplace_merge(beg, mid, end);
-                       }
-                   
-               }
-
-           };
-
- template<typename RandomAccessIterator, typename StrictWeakOrdering>
-        void Parallel_Merge_Sort(RandomAccessIterator beg, RandomAccessIterator end,  StrictWeakOrdering comp)
-       {
-               if (end - beg > 1)
-               {
-                     RandomAccessIterator mid = beg + (end - beg) / 2;
-
-                      tbb::parallel_invoke(
-                        [&] { Parallel_Merge_Sort( beg, mid, comp); }, 
-                        [&] { Parallel_Merge_Sort( mid, end, comp); }  
-                      );
-
-                     std::inplace_merge(beg, mid, end, comp);
-               }
-           
-       }
-
 
-           template<typename RandomAccessIterator, typename StrictWeakOrdering>
-           struct StableSort_comp
-           {
-
-               StableSort_comp () {}  
+        namespace detail {
 
+            //  Ranges at or below this length are sorted serially with std::stable_sort
+            static const std::ptrdiff_t stableSortSerialCutoff = 4096;
 
+            //  Number of output elements each task of a parallel merge produces
+            static const std::ptrdiff_t stableSortMergeGrain = 8192;
 
-               void operator() (RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp )
-               {
-                    int n = (int) std::distance(first, last);
+            //  Co-rank of diagonal k in the merge of a[0,n1) and b[0,n2): the number of elements taken from a among
+            //  the first k elements of the stable merge, where a wins ties.  Found by binary search along the merge
+            //  path, so any output position can be split off without looking at the elements before it.
+            template< typename InputIterator1, typename InputIterator2, typename StrictWeakOrdering >
+            std::ptrdiff_t coRank( std::ptrdiff_t k, InputIterator1 a, std::ptrdiff_t n1,
+                InputIterator2 b, std::ptrdiff_t n2, StrictWeakOrdering comp )
+            {
+                std::ptrdiff_t low = std::max< std::ptrdiff_t >( 0, k - n2 );
+                std::ptrdiff_t high = std::min( k, n1 );
 
-                    if(n == 1)  // Only one element
-                         return; // Nothing to Sort!
-                    else   
-                         Parallel_Merge_Sort(first, last, comp);
-                    
-               }    
+                while( low < high )
+                {
+                    std::ptrdiff_t i = low + ( high - low ) / 2;
+                    std::ptrdiff_t j = k - i;
 
-
-
-           };
+                    //  a[ i ] would still be emitted before b[ j - 1 ], so more of a belongs in the first k
+                    if( j > 0 && !comp( b[ j - 1 ], a[ i ] ) )
+                        low = i + 1;
+                    else
+                        high = i;
+                }
+
+                return low;
+            }
+
+            //  Stable merge of a[0,n1) and b[0,n2) into out.  The output is cut into fixed size pieces, the inputs
+            //  are split at the co-rank of each cut and every piece is merged independently.
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                typename StrictWeakOrdering >
+            void parallelMerge( InputIterator1 a, std::ptrdiff_t n1, InputIterator2 b, std::ptrdiff_t n2,
+                OutputIterator out, StrictWeakOrdering comp )
+            {
+                std::ptrdiff_t n = n1 + n2;
+                if( n <= stableSortMergeGrain )
+                {
+                    std::merge( std::make_move_iterator( a ), std::make_move_iterator( a + n1 ),
+                        std::make_move_iterator( b ), std::make_move_iterator( b + n2 ), out, comp );
+                    return;
+                }
+
+                std::ptrdiff_t pieces = ( n + stableSortMergeGrain - 1 ) / stableSortMergeGrain;
+                tbb::parallel_for( tbb::blocked_range< std::ptrdiff_t >( 0, pieces ),
+                    [ & ]( const tbb::blocked_range< std::ptrdiff_t >& r )
+                {
+                    std::ptrdiff_t k0 = r.begin( ) * stableSortMergeGrain;
+                    std::ptrdiff_t k1 = std::min( r.end( ) * stableSortMergeGrain, n );
+                    std::ptrdiff_t i0 = coRank( k0, a, n1, b, n2, comp );
+                    std::ptrdiff_t i1 = coRank( k1, a, n1, b, n2, comp );
+
+                    std::merge( std::make_move_iterator( a + i0 ), std::make_move_iterator( a + i1 ),
+                        std::make_move_iterator( b + ( k0 - i0 ) ), std::make_move_iterator( b + ( k1 - i1 ) ),
+                        out + k0, comp );
+                } );
+            }
+
+            //  Sorts the n elements at first.  The two halves are sorted into the opposite array from the one the
+            //  result is wanted in, and then merged across, so one buffer the size of the input serves every level.
+            //  With toBuffer the result is left in buffer, otherwise back in first.
+            template< typename RandomAccessIterator, typename BufferIterator, typename StrictWeakOrdering >
+            void mergeSort( RandomAccessIterator first, BufferIterator buffer, std::ptrdiff_t n, bool toBuffer,
+                StrictWeakOrdering comp )
+            {
+                if( n <= stableSortSerialCutoff )
+                {
+                    std::stable_sort( first, first + n, comp );
+                    if( toBuffer )
+                        std::move( first, first + n, buffer );
+                    return;
+                }
+
+                std::ptrdiff_t half = n / 2;
+                tbb::parallel_invoke(
+                    [ & ] { mergeSort( first, buffer, half, !toBuffer, comp ); },
+                    [ & ] { mergeSort( first + half, buffer + half, n - half, !toBuffer, comp ); }
+                );
+
+                if( toBuffer )
+                    parallelMerge( first, half, first + half, n - half, buffer, comp );
+                else
+                    parallelMerge( buffer, half, buffer + half, n - half, first, comp );
+            }
+
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            void stable_sort( RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering,
+                std::true_type )
+            {
+                bolt::btbb::radix_sort( first, last );
+            }
+
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            void stable_sort( RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp,
+                std::false_type )
+            {
+                typedef typename std::iterator_traits< RandomAccessIterator >::value_type valueType;
+
+                std::ptrdiff_t n = std::distance( first, last );
+                if( n <= stableSortSerialCutoff )
+                {
+                    std::stable_sort( first, last, comp );
+                    return;
+                }
+
+                ScratchArray< valueType > buffer( n );
+                bolt::btbb::execute( [ & ]( )
+                {
+                    mergeSort( first, buffer.get( ), n, false, comp );
+                } );
+            }
+
+        } // detail
 
            template<typename RandomAccessIterator>
            void stable_sort(RandomAccessIterator first, RandomAccessIterator last)
            {
-                //This allows TBB to choose the number of threads to spawn.
-                tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-                StableSort <RandomAccessIterator > stable_sort_op;
-                stable_sort_op(first, last);
+                typedef typename std::iterator_traits< RandomAccessIterator >::value_type valueType;
+                bolt::btbb::stable_sort( first, last, std::less< valueType >( ) );
            }
 
+           //  Ascending sorts of arithmetic keys are radix sorted, which is stable; every other ordering is merged
            template<typename RandomAccessIterator, typename StrictWeakOrdering>
            void stable_sort(RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp)
            {
-               //This allows TBB to choose the number of threads to spawn.
-                tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic); 			   
-                StableSort_comp <RandomAccessIterator, StrictWeakOrdering > stable_sort_op;
-                stable_sort_op(first, last, comp);
+                typedef typename std::iterator_traits< RandomAccessIterator >::value_type valueType;
+                detail::stable_sort( first, last, comp,
+                    typename detail::radix_sort_ordering< valueType, StrictWeakOrdering >::type( ) );
            }
        
     } //tbb
@@ -19,203 +19,30 @@
 #define BOLT_BTBB_STABLE_SORT_BY_KEY_INL
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
-#include "tbb/parallel_invoke.h"
-//#include <thread>
 #include <iterator>
 
-#include "bolt/btbb/stable_sort.h"
-#include "tbb/blocked_range.h"
-#include "tbb/parallel_for.h"
+//  sort_by_key is stable on the MultiCoreCpu path, so both share its implementation
+#include "bolt/btbb/sort_by_key.h"
 
 namespace bolt{
     namespace btbb {
-       
-              template <typename keyType, typename valueType>
-              class tbb_stable_sort
-              {
-                  public:
-                    keyType   key;
-                    valueType value;
-              };
-
-              //This is the functor which will sort the tbb_stable_sort vector. 
-              template <typename keyType, typename valueType, typename StrictWeakOrdering>
-              class tbb_stable_sort_comp
-              {
-                  public:
-                     typedef tbb_stable_sort<keyType, valueType> KeyValueType;
-                     tbb_stable_sort_comp(const StrictWeakOrdering &_swo):swo(_swo) {}
-                     StrictWeakOrdering swo;
-                     bool operator() (const KeyValueType &lhs, const KeyValueType &rhs) const
-                     {
-                       return swo(lhs.key, rhs.key);
-                     }
-              };
-
-              template< typename RandomAccessIterator1, typename RandomAccessIterator2>
-              void Parallel_stable_sort_by_key(const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last, 
-                                      const RandomAccessIterator2 values_first)
-              {
-                     typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
-                     typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valType;
-                     typedef tbb_stable_sort<keyType, valType> KeyValuePair;
-       
-                     size_t vecSize = std::distance( keys_first, keys_last ); 
-                     std::vector<KeyValuePair> KeyValuePairVector(vecSize);
-
-                     //Zip the key and values iterators into a tbb_stable_sort vector.
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   KeyValuePairVector[i].key   = *(keys_first + i);
-                                   KeyValuePairVector[i].value = *(values_first + i);
-                              }   
-                          
-                     });
-
-                     //Sort the tbb_stable_sort vector using TBB stable_sort
-                     bolt::btbb::stable_sort(KeyValuePairVector.begin(), KeyValuePairVector.end());
-
-                     //Extract the keys and values from the KeyValuePair and fill the respective iterators. 
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   *(keys_first + i)   = KeyValuePairVector[i].key;
-                                   *(values_first + i) = KeyValuePairVector[i].value;
-                              }   
-                          
-                     });
-              }
-
-              template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
-              void Parallel_stable_sort_by_key_comp(const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last, 
-                                      const RandomAccessIterator2 values_first, StrictWeakOrdering comp )
-              {
-                     typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
-                     typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valType;
-                     typedef tbb_stable_sort<keyType, valType> KeyValuePair;
-                     typedef tbb_stable_sort_comp<keyType, valType, StrictWeakOrdering> KeyValuePairFunctor;
-       
-                     size_t vecSize = std::distance( keys_first, keys_last ); 
-                     std::vector<KeyValuePair> KeyValuePairVector(vecSize);
-                     KeyValuePairFunctor functor(comp);
-
-                     //Zip the key and values iterators into a tbb_stable_sort vector.
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   KeyValuePairVector[i].key   = *(keys_first + i);
-                                   KeyValuePairVector[i].value = *(values_first + i);
-                              }   
-                          
-                     });
-
-                     //Sort the tbb_stable_sort vector using TBB stable_sort
-                     bolt::btbb::stable_sort(KeyValuePairVector.begin(), KeyValuePairVector.end(), functor);
-
-                     //Extract the keys and values from the KeyValuePair and fill the respective iterators.
-                     tbb::parallel_for(  tbb::blocked_range<int>(0, (int) vecSize) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
-                     {
-                              
-                              for(int i = r.begin(); i!=r.end(); i++)
-                              {
-                                 
-                                   *(keys_first + i)   = KeyValuePairVector[i].key;
-                                   *(values_first + i) = KeyValuePairVector[i].value;
-                              }   
-                          
-                     });
-             }
-
-             template< typename RandomAccessIterator1, typename RandomAccessIterator2 > 
-             struct StableSortByKey
-             {
-
-               StableSortByKey () {}  
-
-               void operator() ( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first)
-               {
-                    int n = (int) std::distance(keys_first, keys_last);
-
-                    if(n == 1)  // Only one element
-                         return; // Nothing to Sort!
-                    else
-                         Parallel_stable_sort_by_key(keys_first, keys_last, values_first);
-                    
-               }          
-
-           };
-
-           template<typename RandomAccessIterator1,typename RandomAccessIterator2, typename StrictWeakOrdering>
-           struct StableSortByKey_comp
-           {
-
-               StableSortByKey_comp () {}  
-
-               void operator() (RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first, StrictWeakOrdering comp )
-               {
-                    int n = (int) std::distance(keys_first, keys_last);
-
-                    if(n == 1)  // Only one element
-                         return; // Nothing to Sort!
-                    else   
-                         Parallel_stable_sort_by_key_comp(keys_first, keys_last, values_first,comp);
-                    
-               }    
-
-              
-
-           };
 
            template< typename RandomAccessIterator1, typename RandomAccessIterator2 > 
            void stable_sort_by_key( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, 
            RandomAccessIterator2 values_first)
            {
-                //Gets the number of concurrent threads supported by the underlying platform
-                //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-                //This allows TBB to choose the number of threads to spawn.
-                tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-                //Explicitly setting the number of threads to spawn
-                //tbb::task_scheduler_init((int) concurentThreadsSupported);
-
-                StableSortByKey <RandomAccessIterator1, RandomAccessIterator2 > stable_sort_by_key_op;
-                stable_sort_by_key_op(keys_first, keys_last, values_first);
+                typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
+                detail::sortByKey( keys_first, keys_last, values_first, std::less< keyType >( ) );
            }
 
            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering> 
            void stable_sort_by_key( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first, 
            StrictWeakOrdering comp)
            {
-                //Gets the number of concurrent threads supported by the underlying platform
-                //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-                //This allows TBB to choose the number of threads to spawn.
-                tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-                //Explicitly setting the number of threads to spawn
-                //tbb::task_scheduler_init((int) concurentThreadsSupported);
-
-                StableSortByKey_comp <RandomAccessIterator1, RandomAccessIterator2, StrictWeakOrdering > stable_sort_by_key_op;
-                stable_sort_by_key_op(keys_first, keys_last, values_first, comp);
+                detail::sortByKey( keys_first, keys_last, values_first, comp );
           }
        
     } //tbb
 } // bolt
 
-#endif //BTBB_STABLE_SORT_BY_KEY_INL
\ No newline at end of file
+#endif //BTBB_STABLE_SORT_BY_KEY_INL
@@ -18,7 +18,7 @@
 /*! \file bolt/amp/transform.h
 	\brief  Applies a specific function object to each element pair in the specified input ranges.
 */
-#include "tbb/task_scheduler_init.h"
+#include "bolt/btbb/arena.h"
 
 #pragma once
 #if !defined( BOLT_BTBB_TRANSFORM_INL )
@@ -59,7 +59,8 @@ namespace bolt
 		transformBinaryRange( transformBinaryRange& r, tbb::split ): first1( r.first1 ), last1( r.last1 ), first2( r.first2 ),
 			result( r.result ), func( r.func )
 		{
-			int halfSize = static_cast<int>(std::distance( r.first1, r.last1 ) >> 1);
+			typename std::iterator_traits< tbbInputIterator1 >::difference_type halfSize =
+				std::distance( r.first1, r.last1 ) >> 1;
 			r.last1 = r.first1 + halfSize;
 
 			first1 = r.last1;
@@ -93,7 +94,8 @@ namespace bolt
 		transformUnaryRange( transformUnaryRange& r, tbb::split ): first1( r.first1 ), last1( r.last1 ),
 			 result( r.result ), func( r.func )
 		{
-			int halfSize = static_cast<int>(std::distance( r.first1, r.last1 ) >> 1);
+			typename std::iterator_traits< tbbInputIterator1 >::difference_type halfSize =
+				std::distance( r.first1, r.last1 ) >> 1;
 			r.last1 = r.first1 + halfSize;
 
 			first1 = r.last1;
@@ -111,7 +113,7 @@ namespace bolt
             if (sz == 0)
                 return;
             //std::transform( first, last, result, f );
-            for(int index=0; index < (int)(sz); index++)
+            for(size_t index=0; index < sz; index++)
             {
                 *(r.result + index) = r.func( *(r.first1+index), *(r.first2+index) );
             }
@@ -124,7 +126,7 @@ namespace bolt
 		void operator( )( transformUnaryRange< tbbInputIterator1, tbbOutputIterator, tbbFunctor >& r ) const
 		{
 			size_t sz = std::distance( r.first1, r.last1 );
-            for(int index=0; index < (int)(sz); index++)
+            for(size_t index=0; index < sz; index++)
             {
                 *(r.result + index) = r.func( *(r.first1+index) );
             }
@@ -142,11 +144,11 @@ namespace bolt
                 {
 					typename std::iterator_traits<InputIterator1>::difference_type n = (last - first);
 
-                    tbb::parallel_for(  tbb::blocked_range<int>(0, (int) n) ,
-                        [&] (const tbb::blocked_range<int> &r) -> void
+                    tbb::parallel_for(  tbb::blocked_range<size_t>(0, static_cast< size_t >( n )) ,
+                        [&] (const tbb::blocked_range<size_t> &r) -> void
                         {
                               
-                              for(int i = r.begin(); i!=r.end(); i++)
+                              for(size_t i = r.begin(); i!=r.end(); i++)
                               {
                                  
 								  if(p(s[i]))
@@ -170,10 +172,13 @@ namespace bolt
 					   UnaryFunction op)
 		{
 
-			tbb::parallel_for(
-				transformUnaryRange< InputIterator, OutputIterator, UnaryFunction >( first, last, result, op ),
-				transformUnaryRangeBody< InputIterator, OutputIterator, UnaryFunction >( ),
-				tbb::simple_partitioner( ) );
+			bolt::btbb::execute( [ & ]( )
+			{
+				tbb::parallel_for(
+					transformUnaryRange< InputIterator, OutputIterator, UnaryFunction >( first, last, result, op ),
+					transformUnaryRangeBody< InputIterator, OutputIterator, UnaryFunction >( ),
+					tbb::simple_partitioner( ) );
+			} );
 
 		}
 
@@ -184,11 +189,14 @@ namespace bolt
 					   OutputIterator result,
 					   BinaryFunction op)
 		{
-				tbb::parallel_for(
-					transformBinaryRange< InputIterator1, InputIterator2, OutputIterator, BinaryFunction >(
-						first1, last1, first2, result, op ),
-					transformBinaryRangeBody< InputIterator1, InputIterator2, OutputIterator, BinaryFunction >( ),
-					tbb::simple_partitioner( ) );
+				bolt::btbb::execute( [ & ]( )
+				{
+					tbb::parallel_for(
+						transformBinaryRange< InputIterator1, InputIterator2, OutputIterator, BinaryFunction >(
+							first1, last1, first2, result, op ),
+						transformBinaryRangeBody< InputIterator1, InputIterator2, OutputIterator, BinaryFunction >( ),
+						tbb::simple_partitioner( ) );
+				} );
 
 		}
 
@@ -198,17 +206,11 @@ namespace bolt
                         InputIterator2 first2,  Stencil& s, OutputIterator result, BinaryFunction f, Predicate p)
 		{
 
-			   //Gets the number of concurrent threads supported by the underlying platform
-               //unsigned int concurentThreadsSupported = std::thread::hardware_concurrency();
-
-               //This allows TBB to choose the number of threads to spawn.
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-
-               //Explicitly setting the number of threads to spawn
-               //tbb::task_scheduler_init((int) concurentThreadsSupported);
-
                Transform_If <InputIterator1, InputIterator2, Stencil, OutputIterator, BinaryFunction, Predicate> transform_if;
-               transform_if(first1, last1, first2, s, result, f, p);
+               bolt::btbb::execute( [ & ]( )
+               {
+                   transform_if(first1, last1, first2, s, result, f, p);
+               } );
 		}
 
 
@@ -24,6 +24,8 @@
 #define BOLT_BTBB_TRANSFORM_REDUCE_INL
 #pragma once
 
+#include "bolt/btbb/arena.h"
+
 namespace bolt {
 	namespace btbb {
 			/*For documentation on the reduce object see below link
@@ -76,9 +78,11 @@ namespace bolt {
 		{
 
 				  typedef typename std::iterator_traits< InputIterator >::value_type iType;
-					tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
 					Transform_Reduce<InputIterator, UnaryFunction, BinaryFunction,T> transform_reduce_op(transform_op, reduce_op, init);
-					tbb::parallel_reduce( tbb::blocked_range<InputIterator>( first, last), transform_reduce_op );
+					bolt::btbb::execute( [ & ]( )
+					{
+						tbb::parallel_reduce( tbb::blocked_range<InputIterator>( first, last), transform_reduce_op );
+					} );
 					return transform_reduce_op.value;
 
 		}
@@ -0,0 +1,73 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_UNIQUE_INL )
+#define BOLT_BTBB_UNIQUE_INL
+#pragma once
+
+#include <vector>
+#include "bolt/btbb/copy.h"
+
+namespace bolt {
+    namespace btbb {
+
+        template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+        OutputIterator unique_copy(InputIterator first, InputIterator last, OutputIterator result,
+                                   BinaryPredicate pred)
+        {
+            size_t n = static_cast< size_t >( std::distance( first, last ) );
+            return result + compact( n, unique_flags< InputIterator, BinaryPredicate >( first, pred ),
+                copy_emit< InputIterator, OutputIterator >( first, result ) );
+        }
+
+        template<typename ForwardIterator, typename BinaryPredicate>
+        ForwardIterator unique(ForwardIterator first, ForwardIterator last, BinaryPredicate pred)
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type vType;
+            std::vector< vType > source( first, last );
+            return bolt::btbb::unique_copy( source.begin( ), source.end( ), first, pred );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename BinaryPredicate>
+        std::pair<OutputIterator1, OutputIterator2> unique_by_key_copy(InputIterator1 keys_first,
+            InputIterator1 keys_last, InputIterator2 values_first, OutputIterator1 keys_result,
+            OutputIterator2 values_result, BinaryPredicate pred)
+        {
+            size_t n = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+            size_t kept = compact( n, unique_flags< InputIterator1, BinaryPredicate >( keys_first, pred ),
+                copy_by_key_emit< InputIterator1, InputIterator2, OutputIterator1, OutputIterator2 >( keys_first,
+                    values_first, keys_result, values_result ) );
+            return std::make_pair( keys_result + kept, values_result + kept );
+        }
+
+        template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+        std::pair<ForwardIterator1, ForwardIterator2> unique_by_key(ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last, ForwardIterator2 values_first, BinaryPredicate pred)
+        {
+            typedef typename std::iterator_traits< ForwardIterator1 >::value_type kType;
+            typedef typename std::iterator_traits< ForwardIterator2 >::value_type vType;
+            std::vector< kType > keys( keys_first, keys_last );
+            std::vector< vType > values( values_first, values_first + keys.size( ) );
+            return bolt::btbb::unique_by_key_copy( keys.begin( ), keys.end( ), values.begin( ), keys_first,
+                values_first, pred );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_UNIQUE_INL
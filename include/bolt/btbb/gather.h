@@ -20,7 +20,6 @@
 #pragma once
 
 #include "tbb/blocked_range.h"
-#include "tbb/task_scheduler_init.h"
 #include "tbb/tbb.h"
 #include "tbb/parallel_for.h"
 
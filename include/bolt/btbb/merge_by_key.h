@@ -0,0 +1,56 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MERGE_BY_KEY_H )
+#define BOLT_BTBB_MERGE_BY_KEY_H
+#pragma once
+
+#include <utility>
+
+/*! \file bolt/btbb/merge_by_key.h
+    \brief Merges two ranges sorted by key, carrying a value along with every key.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup TBB-merge_by_key
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! \brief merge_by_key merges the sorted keys [keys_first1, keys_last1) and [keys_first2, keys_last2) to
+         *  keys_result and moves the value of every key to the same place in values_result.  Equal keys keep
+         *  their order, those of the first range first.  Returns the ends of both outputs.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+                 typename OutputIterator1, typename OutputIterator2, typename StrictWeakCompare>
+        std::pair<OutputIterator1, OutputIterator2> merge_by_key(InputIterator1 keys_first1,
+            InputIterator1 keys_last1, InputIterator2 keys_first2, InputIterator2 keys_last2,
+            InputIterator3 values_first1, InputIterator4 values_first2, OutputIterator1 keys_result,
+            OutputIterator2 values_result, StrictWeakCompare comp);
+
+        /*!   \}  */
+
+    };
+};
+
+
+#include <bolt/btbb/detail/merge_by_key.inl>
+
+#endif
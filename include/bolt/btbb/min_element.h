@@ -21,7 +21,6 @@
 
 #include "tbb/parallel_reduce.h"
 #include "tbb/blocked_range.h"
-#include "tbb/task_scheduler_init.h"
 
 /*! \file bolt/tbb/min_element.h
     \brief finds the minimum element in the given input vector
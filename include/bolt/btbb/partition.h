@@ -0,0 +1,64 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_PARTITION_H )
+#define BOLT_BTBB_PARTITION_H
+#pragma once
+
+#include <utility>
+
+/*! \file bolt/btbb/partition.h
+    \brief Moves the elements that satisfy a predicate in front of the ones that do not.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup TBB-partition
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! \brief partition_copy copies the elements of [first, last) for which pred is true to out_true and the
+         *  others to out_false, both in their input order, and returns the ends of both outputs.
+         */
+        template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+        std::pair<OutputIterator1, OutputIterator2> partition_copy(InputIterator first, InputIterator last,
+            OutputIterator1 out_true, OutputIterator2 out_false, Predicate pred);
+
+        /*! \brief stable_partition moves the elements of [first, last) for which pred is true in front of the
+         *  others, keeping the order within both groups, and returns the start of the second group.
+         */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(ForwardIterator first, ForwardIterator last, Predicate pred);
+
+        /*! \brief partition moves the elements of [first, last) for which pred is true in front of the others,
+         *  and returns the start of the second group.  It runs stable_partition.
+         */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(ForwardIterator first, ForwardIterator last, Predicate pred);
+
+        /*!   \}  */
+
+    };
+};
+
+
+#include <bolt/btbb/detail/partition.inl>
+
+#endif
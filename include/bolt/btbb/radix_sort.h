@@ -0,0 +1,120 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_RADIX_SORT_H )
+#define BOLT_BTBB_RADIX_SORT_H
+#pragma once
+
+#include <functional>
+#include <type_traits>
+
+/*! \file bolt/btbb/radix_sort.h
+    \brief Sorts arithmetic keys in ascending order with a parallel LSD radix sort.
+*/
+
+namespace bolt {
+    namespace cl {
+        template< typename T > struct less;
+    }
+
+    namespace btbb {
+
+        namespace detail {
+
+            //  Value types the radix sort can order: every integral type but bool, float and double
+            template< typename T >
+            struct radix_sortable: std::integral_constant< bool,
+                std::is_arithmetic< T >::value && !std::is_same< T, bool >::value &&
+                ( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 || sizeof( T ) == 8 ) >
+            {};
+
+            //  Orderings the radix sort reproduces exactly, so a comparison sort may be replaced by it
+            template< typename T, typename StrictWeakOrdering >
+            struct radix_sort_ordering: std::false_type
+            {};
+
+            template< typename T >
+            struct radix_sort_ordering< T, std::less< T > >: radix_sortable< T >
+            {};
+
+            template< typename T >
+            struct radix_sort_ordering< T, bolt::cl::less< T > >: radix_sortable< T >
+            {};
+
+        }
+
+        /*! \addtogroup sorting
+        *   \{
+        */
+
+        /*! \brief \p radix_sort arranges the elements between \p first and \p last in ascending order, without
+        * comparing them.  The keys are taken 8 bits at a time from the least significant digit up; every pass counts
+        * the digits of each block of the input in parallel and scatters the blocks to their offsets.  The sort is
+        * stable, and orders the keys exactly as \p less<> does; negative zero and positive zero compare equal.  NaNs,
+        * which \p less<> cannot order, go after positive infinity, or before negative infinity if their sign is set.
+        *
+        * \p sort and \p stable_sort use it for arithmetic types sorted with \p less<>.
+        *
+        *  \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, \n
+        *          \p RandomAccessIterator is mutable, \n
+        *          \p RandomAccessIterator's \c value_type is an integral type other than bool, or float, or double.
+
+        * \param first The first position in the sequence to be sorted.
+        * \param last  The last position in the sequence to be sorted.
+        * \return The sorted data that is available in place.
+        *
+        * \code
+        * #include <bolt/btbb/radix_sort.h>
+        *
+        * double a[8] = {2.5, -9.0, 3.0, 7.0, -0.5, 6.0, 3.0, 8.0};
+        *
+        * bolt::btbb::radix_sort( a, a+8 );
+        *
+        *  \endcode
+        */
+
+        template< typename RandomAccessIterator >
+        void radix_sort( RandomAccessIterator first, RandomAccessIterator last );
+
+        /*! \brief \p radix_sort_by_key arranges the keys between \p keys_first and \p keys_last in ascending order
+        * in the same way as \p radix_sort, and moves the value at \p values_first with each key.  The keys and the
+        * values stay in their own ranges; a buffer of each is the only extra memory.
+        *
+        *  \tparam RandomAccessIterator1 Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, \n
+        *          \p RandomAccessIterator1 is mutable, \n
+        *          \p RandomAccessIterator1's \c value_type is an integral type other than bool, or float, or double.
+        *  \tparam RandomAccessIterator2 Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, \n
+        *          \p RandomAccessIterator2 is mutable.
+
+        * \param keys_first The first position in the sequence of keys.
+        * \param keys_last  The last position in the sequence of keys.
+        * \param values_first The first position in the sequence of values.
+        * \return The sorted keys and values, available in place.
+        */
+
+        template< typename RandomAccessIterator1, typename RandomAccessIterator2 >
+        void radix_sort_by_key( RandomAccessIterator1 keys_first, RandomAccessIterator1 keys_last,
+            RandomAccessIterator2 values_first );
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/radix_sort.inl>
+
+#endif
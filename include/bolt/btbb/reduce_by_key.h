@@ -21,7 +21,6 @@
 
 #include "tbb/parallel_scan.h"
 #include "tbb/blocked_range.h"
-#include "tbb/task_scheduler_init.h"
 
 
 
@@ -37,7 +36,7 @@ namespace bolt {
                 typename InputIterator2,
                 typename OutputIterator1,
                 typename OutputIterator2>
-                unsigned int
+                size_t
                 reduce_by_key(
                 InputIterator1  keys_first,
                 InputIterator1  keys_last,
@@ -51,7 +50,7 @@ namespace bolt {
                 typename OutputIterator1,
                 typename OutputIterator2,
                 typename BinaryPredicate>
-                unsigned int
+                size_t
                 reduce_by_key(
                 InputIterator1  keys_first,
                 InputIterator1  keys_last,
@@ -68,7 +67,7 @@ namespace bolt {
                 typename OutputIterator2,
                 typename BinaryPredicate,
                 typename BinaryFunction>
-                unsigned int reduce_by_key(  InputIterator1  keys_first,
+                size_t reduce_by_key(  InputIterator1  keys_first,
                                              InputIterator1  keys_last,
                                              InputIterator2  values_first,
                                              OutputIterator1  keys_output,
@@ -0,0 +1,55 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_REMOVE_H )
+#define BOLT_BTBB_REMOVE_H
+#pragma once
+
+/*! \file bolt/btbb/remove.h
+    \brief Removes the elements of a range that satisfy a predicate.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup TBB-remove
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! \brief remove_copy_if copies the elements of [first, last) for which pred is false to result, keeping
+         *  their order, and returns the end of the output.
+         */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(InputIterator first, InputIterator last, OutputIterator result, Predicate pred);
+
+        /*! \brief remove_if removes the elements of [first, last) for which pred is true, keeping the order of the
+         *  others, and returns the new end of the range.
+         */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(ForwardIterator first, ForwardIterator last, Predicate pred);
+
+        /*!   \}  */
+
+    };
+};
+
+
+#include <bolt/btbb/detail/remove.inl>
+
+#endif
@@ -0,0 +1,130 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SCRATCH_H )
+#define BOLT_BTBB_SCRATCH_H
+#pragma once
+
+#include "tbb/spin_mutex.h"
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+
+/*! \file bolt/btbb/scratch.h
+    \brief Temporary memory held by the MultiCoreCpu sorts, and its high-water mark.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        //! Bytes of temporary storage the btbb sorts hold, now and at most
+        struct scratchMemory
+        {
+            size_t current;
+            size_t highWater;
+        };
+
+        namespace detail {
+
+            struct ScratchState
+            {
+                ScratchState( ): current( 0 ), highWater( 0 )
+                {}
+
+                tbb::spin_mutex lock;
+                size_t current;
+                size_t highWater;
+            };
+
+            inline ScratchState& scratchState( )
+            {
+                static ScratchState state;
+                return state;
+            }
+
+            //  An uninitialized array whose bytes count against the scratch high-water mark for as long as it is held
+            template< typename T >
+            class ScratchArray: boost::noncopyable
+            {
+            public:
+                explicit ScratchArray( size_t n ): m_data( new T[ n ] ), m_bytes( n * sizeof( T ) )
+                {
+                    ScratchState& state = scratchState( );
+                    tbb::spin_mutex::scoped_lock guard( state.lock );
+                    state.current += m_bytes;
+                    if( state.current > state.highWater )
+                        state.highWater = state.current;
+                }
+
+                ~ScratchArray( )
+                {
+                    release( );
+                }
+
+                //  Gives the memory back before the array goes out of scope
+                void release( )
+                {
+                    if( !m_data )
+                        return;
+
+                    delete [] m_data;
+                    m_data = NULL;
+
+                    ScratchState& state = scratchState( );
+                    tbb::spin_mutex::scoped_lock guard( state.lock );
+                    state.current -= m_bytes;
+                }
+
+                T* get( ) const
+                {
+                    return m_data;
+                }
+
+            private:
+                T* m_data;
+                size_t m_bytes;
+            };
+
+        }
+
+        /*! \brief Bytes of temporary storage the btbb sorts hold right now, and the most they have held at once
+        *   since the last call to resetScratchHighWater.  Covers stable_sort, radix_sort, sort_by_key and
+        *   stable_sort_by_key.
+        */
+        inline scratchMemory getScratchMemory( )
+        {
+            detail::ScratchState& state = detail::scratchState( );
+            tbb::spin_mutex::scoped_lock guard( state.lock );
+
+            scratchMemory memory;
+            memory.current = state.current;
+            memory.highWater = state.highWater;
+            return memory;
+        }
+
+        /*! \brief Starts a new high-water measurement from the bytes held right now.
+        */
+        inline void resetScratchHighWater( )
+        {
+            detail::ScratchState& state = detail::scratchState( );
+            tbb::spin_mutex::scoped_lock guard( state.lock );
+            state.highWater = state.current;
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
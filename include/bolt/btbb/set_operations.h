@@ -0,0 +1,75 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SET_OPERATIONS_H )
+#define BOLT_BTBB_SET_OPERATIONS_H
+#pragma once
+
+/*! \file bolt/btbb/set_operations.h
+    \brief Set operations on sorted ranges.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup TBB-set_operations
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! \brief set_union copies the elements that are in either sorted range to result and returns the end of the
+         *  output. An element found m times in [first1, last1) and n times in [first2, last2) is copied max(m, n)
+         *  times.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_union(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp);
+
+        /*! \brief set_intersection copies the elements of [first1, last1) that are also in [first2, last2) to result
+         *  and returns the end of the output. An element found m times in the first range and n times in the second
+         *  is copied min(m, n) times.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_intersection(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp);
+
+        /*! \brief set_difference copies the elements of [first1, last1) that are not in [first2, last2) to result and
+         *  returns the end of the output. An element found m times in the first range and n times in the second is
+         *  copied max(m - n, 0) times.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp);
+
+        /*! \brief set_symmetric_difference copies the elements that are in one sorted range but not in the other to
+         *  result and returns the end of the output. An element found m times in [first1, last1) and n times in
+         *  [first2, last2) is copied |m - n| times.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+        OutputIterator set_symmetric_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp);
+
+        /*!   \}  */
+
+    };
+};
+
+
+#include <bolt/btbb/detail/set_operations.inl>
+
+#endif
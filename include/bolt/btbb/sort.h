@@ -20,7 +20,6 @@
 #pragma once
 
 #include "tbb/parallel_sort.h"
-#include "tbb/task_scheduler_init.h"
 
 
 
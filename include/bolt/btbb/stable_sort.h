@@ -19,7 +19,6 @@
 #define BOLT_BTBB_STABLE_SORT_H
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
 
 
 /*! \file bolt/btbb/stable_sort.h
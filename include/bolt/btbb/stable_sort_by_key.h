@@ -19,7 +19,6 @@
 #define BOLT_BTBB_STABLE_SORT_BY_KEY_H
 #pragma once
 
-#include "tbb/task_scheduler_init.h"
 
 
 /*! \file bolt/btbb/stable_sort_by_key.h
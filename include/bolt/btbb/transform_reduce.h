@@ -25,7 +25,6 @@
 
 #include "tbb/parallel_reduce.h"
 #include "tbb/blocked_range.h"
-#include "tbb/task_scheduler_init.h"
 
 
 /*! \file bolt/btbb/transform_reduce.h
@@ -0,0 +1,74 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_UNIQUE_H )
+#define BOLT_BTBB_UNIQUE_H
+#pragma once
+
+#include <utility>
+
+/*! \file bolt/btbb/unique.h
+    \brief Removes all but the first element of every group of consecutive equal elements.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup TBB-unique
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! \brief unique_copy copies the first element of every group of consecutive elements of [first, last)
+         *  that pred finds equal to result, and returns the end of the output.
+         */
+        template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+        OutputIterator unique_copy(InputIterator first, InputIterator last, OutputIterator result,
+                                   BinaryPredicate pred);
+
+        /*! \brief unique keeps the first element of every group of consecutive equal elements of [first, last)
+         *  and returns the new end of the range.
+         */
+        template<typename ForwardIterator, typename BinaryPredicate>
+        ForwardIterator unique(ForwardIterator first, ForwardIterator last, BinaryPredicate pred);
+
+        /*! \brief unique_by_key_copy copies the first key of every group of consecutive equal keys, and the value
+         *  that goes with it, and returns the ends of both outputs.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename BinaryPredicate>
+        std::pair<OutputIterator1, OutputIterator2> unique_by_key_copy(InputIterator1 keys_first,
+            InputIterator1 keys_last, InputIterator2 values_first, OutputIterator1 keys_result,
+            OutputIterator2 values_result, BinaryPredicate pred);
+
+        /*! \brief unique_by_key keeps the first key of every group of consecutive equal keys, and the value that
+         *  goes with it, and returns the new ends of both ranges.
+         */
+        template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+        std::pair<ForwardIterator1, ForwardIterator2> unique_by_key(ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last, ForwardIterator2 values_first, BinaryPredicate pred);
+
+        /*!   \}  */
+
+    };
+};
+
+
+#include <bolt/btbb/detail/unique.inl>
+
+#endif
@@ -0,0 +1,695 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_ASYNC_H )
+#define BOLT_CL_ASYNC_H
+#pragma once
+
+#include <vector>
+#include <iterator>
+#include <type_traits>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/future.hpp>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/iterator/constant_iterator.h"
+#include "bolt/cl/iterator/counting_iterator.h"
+#include "bolt/cl/binary_search.h"
+#include "bolt/cl/copy.h"
+#include "bolt/cl/count.h"
+#include "bolt/cl/fill.h"
+#include "bolt/cl/gather.h"
+#include "bolt/cl/generate.h"
+#include "bolt/cl/inner_product.h"
+#include "bolt/cl/max_element.h"
+#include "bolt/cl/merge.h"
+#include "bolt/cl/min_element.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/reduce_by_key.h"
+#include "bolt/cl/scan.h"
+#include "bolt/cl/scan_by_key.h"
+#include "bolt/cl/scatter.h"
+#include "bolt/cl/sort.h"
+#include "bolt/cl/sort_by_key.h"
+#include "bolt/cl/stablesort.h"
+#include "bolt/cl/stablesort_by_key.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/transform_reduce.h"
+#include "bolt/cl/transform_scan.h"
+
+/*! \file bolt/cl/async.h
+    \brief Variants of the Bolt algorithms that return once their work is enqueued, instead of waiting for it.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \brief Asynchronous Bolt algorithms
+        *   \details Every function here takes the complete argument list of the synchronous algorithm of the same
+        *   name, with the control and every functor spelled out, followed by an optional list of events that must
+        *   complete before the algorithm starts.  It returns a future whose event() completes once the work it
+        *   enqueued has run, so the event can go in the wait list of the next call to chain work on the device.
+        *
+        *   Algorithms on device_vector, constant_iterator and counting_iterator ranges are enqueued and the call
+        *   returns without waiting.  Later calls on the same control run after them, because the queue runs in
+        *   order, so they need no wait list; results are read on the host after future::wait().  Ranges in host
+        *   memory are copied back before the call returns, as they would be by the synchronous algorithm.  The
+        *   wait mode of the control is left as it is.
+        *
+        *   Algorithms that return a value computed on the device (reduce, count, min_element and the like) run
+        *   on a worker thread, on a copy of the control whose queue is getAsyncQueue( ctl ); they start once the
+        *   work already on the control's queue has run, and get() returns the value.  Their work is not ordered
+        *   on the control's queue: a later call that depends on it, including a synchronous one, must wait for
+        *   the future first or, for an asynchronous call, put its event() in the wait list.
+        *
+        *   The control, the containers and the functors must outlive the work.  The control's queue must run in
+        *   order, and must not be replaced while work is pending.
+        *   \code
+        *   bolt::cl::control ctl;
+        *   bolt::cl::device_vector< int > a( n ), b( n );
+        *
+        *   bolt::cl::async::future< void > filled = bolt::cl::async::fill( ctl, a.begin( ), a.end( ), 1 );
+        *   bolt::cl::async::future< int > sum = bolt::cl::async::reduce( ctl, a.begin( ), a.end( ), 0,
+        *       bolt::cl::plus< int >( ), std::vector< ::cl::Event >( 1, filled.event( ) ) );
+        *   // ... host work ...
+        *   int total = sum.get( );
+        *   \endcode
+        */
+        namespace async
+        {
+            /*! \brief Completion handle of an asynchronous Bolt call, and the value the call returns
+            */
+            template< typename T >
+            class future
+            {
+            public:
+                future( )
+                {}
+
+                future( const ::cl::Event& event, const boost::shared_future< T >& value ):
+                    m_event( event ), m_value( value )
+                {}
+
+                //! False for a default constructed future
+                bool valid( ) const { return m_value.valid( ); };
+
+                //! True once the call has completed, or failed
+                bool ready( )
+                {
+                    if( !m_value.is_ready( ) )
+                        return false;
+                    return m_value.has_exception( ) ||
+                        m_event.getInfo< CL_EVENT_COMMAND_EXECUTION_STATUS >( ) <= CL_COMPLETE;
+                };
+
+                //! Blocks until the call has completed
+                void wait( )
+                {
+                    m_value.wait( );
+                    if( !m_value.has_exception( ) )
+                        V_OPENCL( m_event.wait( ), "failed to wait for an asynchronous Bolt call" );
+                };
+
+                //! Blocks until the call has completed, and returns its result or rethrows its exception
+                T get( )
+                {
+                    wait( );
+                    return m_value.get( );
+                };
+
+                //! Completes once the call has; the event can be put in the wait list of any OpenCL command
+                const ::cl::Event& event( ) const { return m_event; };
+
+            private:
+                ::cl::Event m_event;
+                boost::shared_future< T > m_value;
+            };
+
+            /*! \brief Completion handle of an asynchronous Bolt call that returns nothing
+            */
+            template< >
+            class future< void >
+            {
+            public:
+                future( )
+                {}
+
+                explicit future( const ::cl::Event& event ): m_event( event )
+                {}
+
+                bool valid( ) const { return m_event( ) != NULL; };
+
+                bool ready( ) const
+                {
+                    return m_event.getInfo< CL_EVENT_COMMAND_EXECUTION_STATUS >( ) <= CL_COMPLETE;
+                };
+
+                void wait( ) const
+                {
+                    V_OPENCL( m_event.wait( ), "failed to wait for an asynchronous Bolt call" );
+                };
+
+                void get( ) const { wait( ); };
+
+                const ::cl::Event& event( ) const { return m_event; };
+
+            private:
+                ::cl::Event m_event;
+            };
+
+            namespace detail
+            {
+                //  Whether the algorithm can return with its work still on the queue; for a range in host memory it
+                //  maps the result back, and has to wait for that
+                template< typename Iterator >
+                struct deferrable: std::integral_constant< bool,
+                    std::is_same< typename std::iterator_traits< Iterator >::iterator_category,
+                        bolt::cl::device_vector_tag >::value ||
+                    std::is_same< typename std::iterator_traits< Iterator >::iterator_category,
+                        bolt::cl::constant_iterator_tag >::value ||
+                    std::is_same< typename std::iterator_traits< Iterator >::iterator_category,
+                        bolt::cl::counting_iterator_tag >::value >
+                {};
+
+                /*! \brief Runs one synchronous algorithm as an asynchronous call on the caller's thread
+                *   \details Orders the call after the wait list.  When every range is deferrable the algorithm runs
+                *   on a copy of the control in control::NoWait.  The copy shares the caller's queue, buffer pool and
+                *   functor ring, so the work stays in order with the caller's other calls, the pooled buffers and
+                *   functor uploads outlive the copy, and the caller's control is never modified.
+                */
+                class deferWait
+                {
+                public:
+                    deferWait( control& ctl, const std::vector< ::cl::Event >& waitList, bool defer ):
+                        m_deferred( ctl, control::NoWait ), m_control( defer ? m_deferred : ctl )
+                    {
+                        if( !waitList.empty( ) )
+                        {
+                            if( defer )
+                                V_OPENCL( ctl.getCommandQueue( ).enqueueBarrierWithWaitList( &waitList ),
+                                    "failed to enqueue the wait list of an asynchronous Bolt call" );
+                            else
+                                V_OPENCL( ::cl::Event::waitForEvents( waitList ),
+                                    "failed to wait for the wait list of an asynchronous Bolt call" );
+                        }
+                    }
+
+                    //  The control to run the algorithm on
+                    control& getControl( )
+                    {
+                        return m_control;
+                    }
+
+                    //  Completes once everything enqueued so far on the control's queue has run
+                    future< void > done( )
+                    {
+                        ::cl::Event marker;
+                        V_OPENCL( m_control.getCommandQueue( ).enqueueMarkerWithWaitList( NULL, &marker ),
+                            "failed to enqueue the marker of an asynchronous Bolt call" );
+                        return future< void >( marker );
+                    }
+
+                    //  As done( ), for an algorithm whose return value is known without waiting for it
+                    template< typename T >
+                    future< T > done( const T& value )
+                    {
+                        boost::promise< T > result;
+                        result.set_value( value );
+                        return future< T >( done( ).event( ), boost::shared_future< T >( result.get_future( ) ) );
+                    }
+
+                private:
+                    //  m_control may refer to m_deferred, so a copy would refer to the wrong object
+                    deferWait( const deferWait& );
+                    deferWait& operator=( const deferWait& );
+
+                    control m_deferred;
+                    control& m_control;
+                };
+
+                /*! \brief Runs one synchronous algorithm that returns a device result, on a worker thread
+                *   \details The control is a copy on a queue of its own: were it the caller's queue, a command the
+                *   caller enqueued to wait for m_done would be ahead of the work that sets it.  m_done is a user
+                *   event, so that device commands can wait for the call as they would for any other.
+                */
+                template< typename T, typename Task >
+                class hostTask
+                {
+                public:
+                    hostTask( const control& ctl, const std::vector< ::cl::Event >& waitList, const Task& task,
+                        const boost::shared_ptr< boost::promise< T > >& result, const ::cl::UserEvent& done ):
+                        m_control( ctl ), m_waitList( waitList ), m_task( task ), m_result( result ), m_done( done )
+                    {
+                        m_control.setCommandQueue( getAsyncQueue( ctl ) );
+                        if( m_control.getWaitMode( ) == control::NoWait )
+                            m_control.setWaitMode( control::BalancedWait );
+                    }
+
+                    void operator( )( )
+                    {
+                        try
+                        {
+                            if( !m_waitList.empty( ) )
+                                V_OPENCL( ::cl::Event::waitForEvents( m_waitList ),
+                                    "failed to wait for the wait list of an asynchronous Bolt call" );
+
+                            m_result->set_value( m_task( m_control ) );
+                            m_done.setStatus( CL_COMPLETE );
+                        }
+                        catch( const ::cl::Error& e )
+                        {
+                            m_result->set_exception( boost::copy_exception( e ) );
+                            m_done.setStatus( e.err( ) < 0 ? e.err( ) : CL_INVALID_OPERATION );
+                        }
+                        catch( ... )
+                        {
+                            m_result->set_exception( boost::current_exception( ) );
+                            m_done.setStatus( CL_INVALID_OPERATION );
+                        }
+                    }
+
+                private:
+                    control m_control;
+                    std::vector< ::cl::Event > m_waitList;
+                    Task m_task;
+                    boost::shared_ptr< boost::promise< T > > m_result;
+                    ::cl::UserEvent m_done;
+                };
+
+                template< typename T, typename Task >
+                future< T > launch( control& ctl, const std::vector< ::cl::Event >& waitList, const Task& task )
+                {
+                    cl_int l_Error = CL_SUCCESS;
+                    ::cl::UserEvent done( ctl.getContext( ), &l_Error );
+                    V_OPENCL( l_Error, "failed to create the event of an asynchronous Bolt call" );
+
+                    //  The worker's queue does not see what is already on the caller's, so it waits for that as well
+                    std::vector< ::cl::Event > myWaitList( waitList );
+                    myWaitList.push_back( ::cl::Event( ) );
+                    V_OPENCL( ctl.getCommandQueue( ).enqueueMarkerWithWaitList( NULL, &myWaitList.back( ) ),
+                        "failed to enqueue the marker of an asynchronous Bolt call" );
+                    V_OPENCL( ctl.getCommandQueue( ).flush( ), "clFlush call failed" );
+
+                    boost::shared_ptr< boost::promise< T > > result( new boost::promise< T >( ) );
+                    future< T > handle( done, boost::shared_future< T >( result->get_future( ) ) );
+
+                    boost::thread worker( hostTask< T, Task >( ctl, myWaitList, task, result, done ) );
+                    worker.detach( );
+
+                    return handle;
+                }
+            };
+
+            /******************************************************************************
+             * Algorithms that leave their work on the queue
+             *****************************************************************************/
+            template< typename InputIterator, typename OutputIterator >
+            future< OutputIterator > copy( control& ctl, InputIterator first, InputIterator last,
+                OutputIterator result, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::copy( call.getControl( ), first, last, result ) );
+            };
+
+            template< typename InputIterator, typename Size, typename OutputIterator >
+            future< OutputIterator > copy_n( control& ctl, InputIterator first, Size n, OutputIterator result,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::copy_n( call.getControl( ), first, n, result ) );
+            };
+
+            template< typename ForwardIterator, typename T >
+            future< void > fill( control& ctl, ForwardIterator first, ForwardIterator last, const T& value,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< ForwardIterator >::value );
+                bolt::cl::fill( call.getControl( ), first, last, value );
+                return call.done( );
+            };
+
+            template< typename OutputIterator, typename Size, typename T >
+            future< OutputIterator > fill_n( control& ctl, OutputIterator first, Size n, const T& value,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::fill_n( call.getControl( ), first, n, value ) );
+            };
+
+            template< typename ForwardIterator, typename Generator >
+            future< void > generate( control& ctl, ForwardIterator first, ForwardIterator last, Generator gen,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< ForwardIterator >::value );
+                bolt::cl::generate( call.getControl( ), first, last, gen );
+                return call.done( );
+            };
+
+            template< typename OutputIterator, typename Size, typename Generator >
+            future< OutputIterator > generate_n( control& ctl, OutputIterator first, Size n, Generator gen,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::generate_n( call.getControl( ), first, n, gen ) );
+            };
+
+            template< typename InputIterator, typename OutputIterator, typename UnaryFunction >
+            future< void > transform( control& ctl, InputIterator first, InputIterator last, OutputIterator result,
+                UnaryFunction op, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                bolt::cl::transform( call.getControl( ), first, last, result, op );
+                return call.done( );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                typename BinaryFunction >
+            future< void > transform( control& ctl, InputIterator1 first1, InputIterator1 last1,
+                InputIterator2 first2, OutputIterator result, BinaryFunction op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< OutputIterator >::value );
+                bolt::cl::transform( call.getControl( ), first1, last1, first2, result, op );
+                return call.done( );
+            };
+
+            template< typename InputIterator, typename OutputIterator, typename BinaryFunction >
+            future< OutputIterator > inclusive_scan( control& ctl, InputIterator first, InputIterator last,
+                OutputIterator result, BinaryFunction binary_op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::inclusive_scan( call.getControl( ), first, last, result, binary_op ) );
+            };
+
+            template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+            future< OutputIterator > exclusive_scan( control& ctl, InputIterator first, InputIterator last,
+                OutputIterator result, T init, BinaryFunction binary_op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::exclusive_scan( call.getControl( ), first, last, result, init,
+                    binary_op ) );
+            };
+
+            template< typename InputIterator, typename OutputIterator, typename UnaryFunction,
+                typename BinaryFunction >
+            future< OutputIterator > transform_inclusive_scan( control& ctl, InputIterator first,
+                InputIterator last, OutputIterator result, UnaryFunction unary_op, BinaryFunction binary_op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::transform_inclusive_scan( call.getControl( ), first, last, result, unary_op,
+                    binary_op ) );
+            };
+
+            template< typename InputIterator, typename OutputIterator, typename UnaryFunction, typename T,
+                typename BinaryFunction >
+            future< OutputIterator > transform_exclusive_scan( control& ctl, InputIterator first,
+                InputIterator last, OutputIterator result, UnaryFunction unary_op, T init, BinaryFunction binary_op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList,
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::transform_exclusive_scan( call.getControl( ), first, last, result,
+                    unary_op, init, binary_op ) );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                typename BinaryPredicate, typename BinaryFunction >
+            future< OutputIterator > inclusive_scan_by_key( control& ctl, InputIterator1 first1,
+                InputIterator1 last1, InputIterator2 first2, OutputIterator result, BinaryPredicate binary_pred,
+                BinaryFunction binary_funct, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::inclusive_scan_by_key( call.getControl( ), first1, last1, first2,
+                    result, binary_pred, binary_funct ) );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename T,
+                typename BinaryPredicate, typename BinaryFunction >
+            future< OutputIterator > exclusive_scan_by_key( control& ctl, InputIterator1 first1,
+                InputIterator1 last1, InputIterator2 first2, OutputIterator result, T init,
+                BinaryPredicate binary_pred, BinaryFunction binary_funct,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::exclusive_scan_by_key( call.getControl( ), first1, last1, first2,
+                    result, init, binary_pred, binary_funct ) );
+            };
+
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            future< void > sort( control& ctl, RandomAccessIterator first, RandomAccessIterator last,
+                StrictWeakOrdering comp, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< RandomAccessIterator >::value );
+                bolt::cl::sort( call.getControl( ), first, last, comp );
+                return call.done( );
+            };
+
+            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+            future< void > sort_by_key( control& ctl, RandomAccessIterator1 keys_first,
+                RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first, StrictWeakOrdering comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< RandomAccessIterator1 >::value &&
+                    detail::deferrable< RandomAccessIterator2 >::value );
+                bolt::cl::sort_by_key( call.getControl( ), keys_first, keys_last, values_first, comp );
+                return call.done( );
+            };
+
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            future< void > stable_sort( control& ctl, RandomAccessIterator first, RandomAccessIterator last,
+                StrictWeakOrdering comp, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< RandomAccessIterator >::value );
+                bolt::cl::stable_sort( call.getControl( ), first, last, comp );
+                return call.done( );
+            };
+
+            template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+            future< void > stable_sort_by_key( control& ctl, RandomAccessIterator1 keys_first,
+                RandomAccessIterator1 keys_last, RandomAccessIterator2 values_first, StrictWeakOrdering comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< RandomAccessIterator1 >::value &&
+                    detail::deferrable< RandomAccessIterator2 >::value );
+                bolt::cl::stable_sort_by_key( call.getControl( ), keys_first, keys_last, values_first, comp );
+                return call.done( );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator >
+            future< void > gather( control& ctl, InputIterator1 map_first, InputIterator1 map_last,
+                InputIterator2 input_first, OutputIterator result,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< OutputIterator >::value );
+                bolt::cl::gather( call.getControl( ), map_first, map_last, input_first, result );
+                return call.done( );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                typename OutputIterator, typename Predicate >
+            future< void > gather_if( control& ctl, InputIterator1 map_first, InputIterator1 map_last,
+                InputIterator2 stencil, InputIterator3 input_first, OutputIterator result, Predicate pred,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< InputIterator3 >::value &&
+                    detail::deferrable< OutputIterator >::value );
+                bolt::cl::gather_if( call.getControl( ), map_first, map_last, stencil, input_first, result, pred );
+                return call.done( );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator >
+            future< void > scatter( control& ctl, InputIterator1 first, InputIterator1 last, InputIterator2 map,
+                OutputIterator result, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< OutputIterator >::value );
+                bolt::cl::scatter( call.getControl( ), first, last, map, result );
+                return call.done( );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                typename OutputIterator, typename Predicate >
+            future< void > scatter_if( control& ctl, InputIterator1 first, InputIterator1 last, InputIterator2 map,
+                InputIterator3 stencil, OutputIterator result, Predicate pred,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< InputIterator3 >::value &&
+                    detail::deferrable< OutputIterator >::value );
+                bolt::cl::scatter_if( call.getControl( ), first, last, map, stencil, result, pred );
+                return call.done( );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                typename StrictWeakCompare >
+            future< OutputIterator > merge( control& ctl, InputIterator1 first1, InputIterator1 last1,
+                InputIterator2 first2, InputIterator2 last2, OutputIterator result, StrictWeakCompare comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< InputIterator1 >::value &&
+                    detail::deferrable< InputIterator2 >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::merge( call.getControl( ), first1, last1, first2, last2, result, comp ) );
+            };
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            future< OutputIterator > lower_bound( control& ctl, ForwardIterator first, ForwardIterator last,
+                InputIterator values_first, InputIterator values_last, OutputIterator result, StrictWeakOrdering comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< ForwardIterator >::value &&
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::lower_bound( call.getControl( ), first, last, values_first, values_last,
+                    result, comp ) );
+            };
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            future< OutputIterator > upper_bound( control& ctl, ForwardIterator first, ForwardIterator last,
+                InputIterator values_first, InputIterator values_last, OutputIterator result, StrictWeakOrdering comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< ForwardIterator >::value &&
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::upper_bound( call.getControl( ), first, last, values_first, values_last,
+                    result, comp ) );
+            };
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            future< OutputIterator > binary_search( control& ctl, ForwardIterator first, ForwardIterator last,
+                InputIterator values_first, InputIterator values_last, OutputIterator result, StrictWeakOrdering comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                detail::deferWait call( ctl, waitList, detail::deferrable< ForwardIterator >::value &&
+                    detail::deferrable< InputIterator >::value && detail::deferrable< OutputIterator >::value );
+                return call.done( bolt::cl::binary_search( call.getControl( ), first, last, values_first, values_last,
+                    result, comp ) );
+            };
+
+            /******************************************************************************
+             * Algorithms that return a device result, run on a worker thread
+             *****************************************************************************/
+            template< typename InputIterator, typename T, typename BinaryFunction >
+            future< T > reduce( control& ctl, InputIterator first, InputIterator last, T init,
+                BinaryFunction binary_op, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                return detail::launch< T >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::reduce( c, first, last, init, binary_op ); } );
+            };
+
+            template< typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction >
+            future< T > transform_reduce( control& ctl, InputIterator first, InputIterator last,
+                UnaryFunction transform_op, T init, BinaryFunction reduce_op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                return detail::launch< T >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::transform_reduce( c, first, last, transform_op, init, reduce_op ); } );
+            };
+
+            template< typename InputIterator, typename OutputType, typename BinaryFunction1,
+                typename BinaryFunction2 >
+            future< OutputType > inner_product( control& ctl, InputIterator first1, InputIterator last1,
+                InputIterator first2, OutputType init, BinaryFunction1 f1, BinaryFunction2 f2,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                return detail::launch< OutputType >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::inner_product( c, first1, last1, first2, init, f1, f2 ); } );
+            };
+
+            template< typename InputIterator, typename EqualityComparable >
+            future< typename bolt::cl::iterator_traits< InputIterator >::difference_type >
+            count( control& ctl, InputIterator first, InputIterator last, const EqualityComparable& value,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                typedef typename bolt::cl::iterator_traits< InputIterator >::difference_type countType;
+                return detail::launch< countType >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::count( c, first, last, value ); } );
+            };
+
+            template< typename InputIterator, typename Predicate >
+            future< typename bolt::cl::iterator_traits< InputIterator >::difference_type >
+            count_if( control& ctl, InputIterator first, InputIterator last, Predicate predicate,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                typedef typename bolt::cl::iterator_traits< InputIterator >::difference_type countType;
+                return detail::launch< countType >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::count_if( c, first, last, predicate ); } );
+            };
+
+            template< typename ForwardIterator, typename BinaryPredicate >
+            future< ForwardIterator > min_element( control& ctl, ForwardIterator first, ForwardIterator last,
+                BinaryPredicate binary_op, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                return detail::launch< ForwardIterator >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::min_element( c, first, last, binary_op ); } );
+            };
+
+            template< typename ForwardIterator, typename BinaryPredicate >
+            future< ForwardIterator > max_element( control& ctl, ForwardIterator first, ForwardIterator last,
+                BinaryPredicate binary_op, const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                return detail::launch< ForwardIterator >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::max_element( c, first, last, binary_op ); } );
+            };
+
+            template< typename ForwardIterator, typename T, typename StrictWeakOrdering >
+            future< bool > binary_search( control& ctl, ForwardIterator first, ForwardIterator last,
+                const T& value, StrictWeakOrdering comp,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                return detail::launch< bool >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::binary_search( c, first, last, value, comp ); } );
+            };
+
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                typename OutputIterator2, typename BinaryPredicate, typename BinaryFunction >
+            future< bolt::cl::pair< OutputIterator1, OutputIterator2 > >
+            reduce_by_key( control& ctl, InputIterator1 keys_first, InputIterator1 keys_last,
+                InputIterator2 values_first, OutputIterator1 keys_output, OutputIterator2 values_output,
+                BinaryPredicate binary_pred, BinaryFunction binary_op,
+                const std::vector< ::cl::Event >& waitList = std::vector< ::cl::Event >( ) )
+            {
+                typedef bolt::cl::pair< OutputIterator1, OutputIterator2 > pairType;
+                return detail::launch< pairType >( ctl, waitList, [ = ]( control& c )
+                    { return bolt::cl::reduce_by_key( c, keys_first, keys_last, values_first, keys_output,
+                        values_output, binary_pred, binary_op ); } );
+            };
+
+        };
+    };
+};
+
+#endif
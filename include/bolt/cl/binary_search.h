@@ -24,7 +24,8 @@
 #include <string>
 
 /*! \file bolt/cl/binary_search.h
-    \brief Returns true if the search element is found in the given input range and false otherwise.
+    \brief Returns true if the search element is found in the given input range and false otherwise; the batch
+    overloads answer lower_bound, upper_bound or binary_search for a whole range of values at once.
 */
 
 namespace bolt {
@@ -141,6 +142,228 @@ namespace bolt {
             StrictWeakOrdering comp,
             const std::string& cl_code="");
 
+        /*! \brief For every value in [values_first, values_last), writes the position in the sorted range [first, last) of
+        * the first element that does not compare before the value, as std::lower_bound would return it.
+        *
+        * \details Each value is searched independently, so the whole batch is one kernel launch on the OpenCL path
+        * and one parallel loop on the multicore path, rather than one call per value.  The values need not be sorted.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sorted sequence to search.
+        * \param last  The last position in the sorted sequence to search.
+        * \param values_first The first of the values to search for.
+        * \param values_last  The last of the values to search for.
+        * \param result The first position of the output, one element per value.
+        * \param comp  \b Optional The comparison operation the sequence is sorted by; bolt::cl::less by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler. The cl_code is inserted first
+        * in the generated code, before the cl_code traits.
+        * \tparam ForwardIterator A random access iterator over the sorted sequence.
+        * \tparam InputIterator A random access iterator over the values, of the same kind (host or device_vector) as
+        * ForwardIterator.
+        * \tparam OutputIterator A random access iterator of the same kind, whose value_type the answer converts to.
+        * \return The end of the output range, result + (values_last - values_first).
+        *
+        * \details The following code example finds where each of three values would be inserted.
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * int a[8] = {1, 2, 2, 3, 5, 8, 13, 21};
+        * int v[3] = {2, 4, 30};
+        * int r[3];
+        *
+        * bolt::cl::lower_bound( a, a+8, v, v+3, r );
+        * // r is {1, 4, 8}
+        *
+        * \endcode
+        * \sa http://www.sgi.com/tech/stl/lower_bound.html
+        */
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator lower_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator lower_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator lower_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator lower_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief For every value in [values_first, values_last), writes the position in the sorted range [first, last) of
+        * the first element that compares after the value, as std::upper_bound would return it.
+        *
+        * \details Each value is searched independently, so the whole batch is one kernel launch on the OpenCL path
+        * and one parallel loop on the multicore path, rather than one call per value.  The values need not be sorted.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sorted sequence to search.
+        * \param last  The last position in the sorted sequence to search.
+        * \param values_first The first of the values to search for.
+        * \param values_last  The last of the values to search for.
+        * \param result The first position of the output, one element per value.
+        * \param comp  \b Optional The comparison operation the sequence is sorted by; bolt::cl::less by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler. The cl_code is inserted first
+        * in the generated code, before the cl_code traits.
+        * \tparam ForwardIterator A random access iterator over the sorted sequence.
+        * \tparam InputIterator A random access iterator over the values, of the same kind (host or device_vector) as
+        * ForwardIterator.
+        * \tparam OutputIterator A random access iterator of the same kind, whose value_type the answer converts to.
+        * \return The end of the output range, result + (values_last - values_first).
+        *
+        * \details The following code example finds the end of the run of each of three values.
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * int a[8] = {1, 2, 2, 3, 5, 8, 13, 21};
+        * int v[3] = {2, 4, 30};
+        * int r[3];
+        *
+        * bolt::cl::upper_bound( a, a+8, v, v+3, r );
+        * // r is {3, 4, 8}
+        *
+        * \endcode
+        * \sa http://www.sgi.com/tech/stl/upper_bound.html
+        */
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator upper_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator upper_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator upper_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator upper_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief For every value in [values_first, values_last), writes whether the value is present in the sorted range
+        * [first, last), as std::binary_search would return it.
+        *
+        * \details Each value is searched independently, so the whole batch is one kernel launch on the OpenCL path
+        * and one parallel loop on the multicore path, rather than one call per value.  The values need not be sorted.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sorted sequence to search.
+        * \param last  The last position in the sorted sequence to search.
+        * \param values_first The first of the values to search for.
+        * \param values_last  The last of the values to search for.
+        * \param result The first position of the output, one element per value.
+        * \param comp  \b Optional The comparison operation the sequence is sorted by; bolt::cl::less by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler. The cl_code is inserted first
+        * in the generated code, before the cl_code traits.
+        * \tparam ForwardIterator A random access iterator over the sorted sequence.
+        * \tparam InputIterator A random access iterator over the values, of the same kind (host or device_vector) as
+        * ForwardIterator.
+        * \tparam OutputIterator A random access iterator of the same kind, whose value_type the answer converts to.
+        * \return The end of the output range, result + (values_last - values_first).
+        *
+        * \details The following code example tests three values for membership.
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * int a[8] = {1, 2, 2, 3, 5, 8, 13, 21};
+        * int v[3] = {2, 4, 21};
+        * int r[3];
+        *
+        * bolt::cl::binary_search( a, a+8, v, v+3, r );
+        * // r is {1, 0, 1}
+        *
+        * \endcode
+        * \sa http://www.sgi.com/tech/stl/binary_search.html
+        */
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator binary_search( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator binary_search( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator binary_search( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator binary_search( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
     }// end of bolt::cl namespace
 }// end of bolt namespace
 
@@ -60,3 +60,63 @@ __kernel void binarysearch_kernel(
     
     result[resultIndex+gloId] = found;
 };
+
+/* One work item per value.  searchMode 0 writes the lower bound, 1 the upper bound and 2 whether the value is
+   present.  The loop runs a fixed number of halvings for every work item of the haystack, so a wavefront never
+   diverges inside it. */
+template < typename iType, typename iIterType, typename vType, typename vIterType, typename oType, typename oIterType,
+    typename StrictWeakOrdering >
+__kernel void searchbatch_kernel(
+ global iType * src,
+ iIterType input_iter,
+ global vType * values,
+ vIterType values_iter,
+ global oType * dst,
+ oIterType result_iter,
+ const uint numElements,
+ const uint numValues,
+ const int searchMode,
+ global StrictWeakOrdering * comp )
+ {
+    size_t gloId = get_global_id( 0 );
+    if( gloId >= numValues )
+        return;
+
+    input_iter.init( src );
+    values_iter.init( values );
+    result_iter.init( dst );
+
+    vType val = values_iter[ gloId ];
+    uint base = 0;
+    uint length = numElements;
+
+    while( length > 1 )
+    {
+        uint half = length / 2;
+        iType midVal = input_iter[ base + half ];
+        bool right = ( searchMode == 1 ) ? !(*comp)( val, midVal ) : (*comp)( midVal, val );
+        base = right ? base + half : base;
+        length -= half;
+    }
+
+    uint position = base;
+    if( numElements > 0 )
+    {
+        iType baseVal = input_iter[ base ];
+        bool right = ( searchMode == 1 ) ? !(*comp)( val, baseVal ) : (*comp)( baseVal, val );
+        position = right ? base + 1 : base;
+    }
+
+    if( searchMode == 2 )
+    {
+        bool found = false;
+        if( position < numElements )
+        {
+            iType posVal = input_iter[ position ];
+            found = !(*comp)( val, posVal );
+        }
+        result_iter[ gloId ] = (oType)found;
+    }
+    else
+        result_iter[ gloId ] = (oType)position;
+};
@@ -32,9 +32,15 @@
 #include <CL/cl.hpp>
 
 
+#include <climits>
 #include <string>
+#include <vector>
 #include <map>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/future.hpp>
 #include "bolt/BoltVersion.h"
 #include "bolt/cl/control.h"
 #include "bolt/cl/clcode.h"
@@ -69,12 +75,14 @@ namespace bolt {
     namespace cl {
 
         extern const std::string binary_search_kernels;
+        extern const std::string compact_kernels;
         extern const std::string copy_kernels;
         extern const std::string count_kernels;
         extern const std::string fill_kernels;
         extern const std::string gather_kernels;
         extern const std::string generate_kernels;
         extern const std::string merge_kernels;
+        extern const std::string merge_path_kernels;
         extern const std::string min_element_kernels;
         extern const std::string reduce_kernels;
         extern const std::string reduce_by_key_kernels;
@@ -130,14 +138,37 @@ namespace bolt {
 
         extern std::string fileToString(const std::string &fileName);
 
+        /*! \brief The kernels getKernels checked out of the calling thread's kernel pool
+        *  \details No other caller gets these kernel objects while a copy of this object is alive; the last copy
+        *  returns them to the pool, as control::buffPointer does for pooled buffers.  It does not convert to a
+        *  std::vector, so the kernels can not be kept without the checkout.
+        */
+        class PooledKernels
+        {
+            public:
+                PooledKernels( const ::std::vector< ::cl::Kernel >& kernels, const boost::shared_ptr< void >& checkout ):
+                    m_kernels( kernels ), m_checkout( checkout )
+                {}
+
+                ::cl::Kernel& operator[]( size_t kernelIndex ) { return m_kernels[ kernelIndex ]; }
+
+                const ::cl::Kernel& operator[]( size_t kernelIndex ) const { return m_kernels[ kernelIndex ]; }
+
+                size_t size( ) const { return m_kernels.size( ); }
+
+            private:
+                ::std::vector< ::cl::Kernel > m_kernels;
+                boost::shared_ptr< void > m_checkout;
+        };
+
         /**********************************************************************
          * getKernels
-         * returns vector of cl::Kernel objects either by constructing
+         * returns the cl::Kernel objects either by constructing
          * and compiling the kernels, or by returning the kernels if
-         * previously compiled.
+         * previously compiled; they are the caller's until it drops them.
          * see bolt/cl/detail/scan.inl for example usage
          **********************************************************************/
-        ::std::vector< ::cl::Kernel > getKernels(
+        PooledKernels getKernels(
             const control&      ctl,
             const ::std::vector< ::std::string >& typeNames,
             const KernelTemplateSpecializer * const kts,
@@ -196,6 +227,26 @@ namespace bolt {
 
         void wait( const bolt::cl::control &ctl, ::cl::Event &e );
 
+        //! Waits for every command enqueued on the queue of \p ctl; in control::NoWait mode it only flushes the queue
+        void wait( const bolt::cl::control &ctl );
+
+        /*! \brief The most elements one OpenCL pass covers.  device_vector and the device side iterators index in 32
+        *   bits, so the algorithms that take host ranges cut longer ranges into slices of at most this many elements.
+        */
+        static const size_t maxDeviceElements = size_t( 1 ) << 30;
+
+        /*! \brief Returns the element count of a range as the int the OpenCL kernels take.  Ranges the int can not
+        *   count throw, rather than run the kernels on a truncated count.
+        */
+        template< typename Size >
+        int deviceElements( Size count )
+        {
+            if( static_cast< unsigned long long >( count ) > static_cast< unsigned long long >( INT_MAX ) )
+                throw ::cl::Error( CL_INVALID_BUFFER_SIZE,
+                    "The range has more elements than the OpenCL path of this algorithm can count" );
+            return static_cast< int >( count );
+        }
+
         /******************************************************************
          * Program Map - so each kernel is only compiled once
          *****************************************************************/
@@ -211,7 +262,9 @@ namespace bolt {
 
         struct ProgramMapValue
         {
-            ::cl::Program program;
+            //  Becomes ready once the program is built; every caller asking for the same key waits on this one
+            //  build, while callers asking for other programs are not held up
+            boost::shared_future< ::cl::Program > program;
         };
 
         struct ProgramMapKeyComp
@@ -274,9 +327,120 @@ namespace bolt {
         typedef ::std::map< ProgramMapKey, ProgramMapValue, ProgramMapKeyComp > ProgramMap;
         //typedef ::std::map< ::std::string, ProgramMapValue> ProgramMap;
 
+        /*! \brief One slice of the program map; a key always lands in the same shard, picked by a hash of the key.
+        *  \details Lookups take the shard lock shared, so cache hits never serialize behind each other; the lock is
+        *  only taken exclusively to insert or erase an entry, never while a program compiles.
+        */
+        struct ProgramMapShard
+        {
+            boost::shared_mutex guard;
+            ProgramMap programs;
+        };
+
+        static const size_t programMapShardCount = 16;
+
         // declared in bolt.cpp
-        extern boost::mutex programMapMutex;
-        extern ProgramMap programMap;
+        extern ProgramMapShard programMap[ programMapShardCount ];
+
+        /*! \brief Returns the number of programs currently being compiled, or loaded from the binary cache, by any thread
+        */
+        size_t programBuildsInProgress( );
+
+        /*! \brief Returns true if the program for this context, device, options and source is still being built
+        */
+        bool isProgramBuildPending(
+            const ::cl::Context& context,
+            const ::cl::Device&  device,
+            const ::std::string& compileOptions,
+            const ::std::string& completeKernelSource );
+
+        /*! \brief Drops every finished program from the program map; builds that are still in flight are kept
+        */
+        void clearProgramMap( );
+
+        /******************************************************************
+         * Kernel Pool - so each thread only creates a kernel object once
+         *****************************************************************/
+        /*! \brief Returns how many ::cl::Kernel objects getKernels has created, across all threads
+        *  \details Once every kernel a thread uses has been created, further calls on that thread create none;
+        *  a steady count across calls confirms that kernels are being reused.
+        */
+        size_t getKernelCreationCount( );
+
+        /*! \brief Releases the kernel objects pooled by the calling thread
+        */
+        void clearKernelPool( );
+
+        /******************************************************************
+         * Program Binary Cache - so each kernel is only compiled once per machine
+         *****************************************************************/
+        /*! \brief Counters reported by the persistent program binary cache.
+        */
+        struct ProgramCacheStats
+        {
+            size_t hits;        //!< Programs rebuilt from a cached binary
+            size_t misses;      //!< Lookups that had to fall back to a source compile
+            size_t stores;      //!< Binaries written to the cache directory
+            size_t evictions;   //!< Binaries removed to stay under the size limit
+            size_t rejects;     //!< Binaries discarded because they failed verification or were refused by the driver
+        };
+
+        /*! \brief Sets the directory where compiled program binaries are persisted between runs
+        *  \details The cache is disabled while the directory is empty, which is the default unless the
+        *  BOLT_PROGRAM_CACHE_DIR environment variable is set.  The directory is created on first write.
+        *  \param directory Path of the cache directory; an empty string disables the cache
+        */
+        void setProgramCacheDirectory( const std::string& directory );
+        std::string getProgramCacheDirectory( );
+
+        /*! \brief Sets the upper bound on the size of the cache directory
+        *  \details Least recently used binaries are evicted once the limit is exceeded.  Defaults to 256MB, or
+        *  to BOLT_PROGRAM_CACHE_MAX_MB megabytes if that environment variable is set.
+        */
+        void setProgramCacheMaxSize( size_t bytes );
+        size_t getProgramCacheMaxSize( );
+
+        ProgramCacheStats getProgramCacheStats( );
+        void resetProgramCacheStats( );
+
+        /******************************************************************
+         * Single Pass Scan - one kernel that reads and writes each element once
+         *****************************************************************/
+        /*! \brief Elements each work item of a single pass scan tile handles, or 0 if the scan has to take the three
+        *  kernel path instead
+        *  \details The single pass kernels pass tile sums to later tiles through 32-bit global atomics and wait on
+        *  them, which needs an OpenCL 1.2 GPU; a work group only ever waits on tiles that were handed out before its
+        *  own, so it never waits on a work group that has not started.  Tile sums are copied a word at a time, so
+        *  the scanned type has to be a whole number of words.  control::debug::MultiPassScan forces the three kernel
+        *  path.
+        *  \param valueBytes sizeof the scanned type
+        *  \param elementBytes Bytes one element takes in local memory; keys and values together for scan_by_key
+        *  \param workGroupSize Work items per work group
+        */
+        cl_uint singlePassScanItems( const control& ctl, size_t valueBytes, size_t elementBytes, size_t workGroupSize );
+
+        /*! \brief A buffer of tileCount + 1 zeroed words: the tile counter followed by the status of every tile
+        */
+        control::buffPointer acquireScanTileStatus( control& ctl, cl_uint tileCount );
+
+        /******************************************************************
+         * Asynchronous algorithms
+         *****************************************************************/
+        /*! \brief An in-order queue on the context and device of ctl's queue, other than ctl's queue itself
+        *  \details The algorithms of bolt/cl/async.h that finish on a worker thread enqueue their work here, so that
+        *  a command the caller later makes wait for them is never queued ahead of that work.  There is one such
+        *  queue per context and device, shared by every worker.
+        */
+        ::cl::CommandQueue getAsyncQueue( const control& ctl );
+
+        //  64-bit FNV-1a hash of a string; used to key kernel sources
+        cl_ulong hashString( const std::string& str, cl_ulong seed = 14695981039346656037ULL );
+
+        /*! \brief Wraps a code string in an include guard named after its hash
+        *  \details Traits that assemble the ClCode of a type from the code of its parts (compositions, tuples) guard
+        *  each part, so that a part pulled in more than once is defined once in the generated kernel.
+        */
+        std::string guardCode( const std::string& code );
 
     };
 };
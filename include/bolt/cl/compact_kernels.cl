@@ -0,0 +1,178 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+***************************************************************************/                                                                                     
+
+
+//  Stream compaction for copy_if, remove_if, unique and partition.  Every work group owns one contiguous chunk of
+//  the input.  compactCountTemplate counts the elements each chunk keeps; compactWriteTemplate adds up the counts of
+//  the chunks before its own and walks its chunk one tile at a time, so every element is written once, in order.
+//  How an element is flagged is chosen with compile options:
+//      BOLT_COMPACT_UNIQUE     keep element i unless the binary predicate finds it equal to element i - 1
+//      BOLT_COMPACT_INVERT     keep the elements the predicate rejects
+
+template< typename fIterType, typename Predicate >
+bool compactKeep( fIterType flags, uint i, global Predicate* pred )
+{
+#if defined( BOLT_COMPACT_UNIQUE )
+    bool keep = ( i == 0 ) || !( *pred )( flags[ i - 1 ], flags[ i ] );
+#else
+    bool keep = ( *pred )( flags[ i ] );
+#endif
+#if defined( BOLT_COMPACT_INVERT )
+    keep = !keep;
+#endif
+    return keep;
+}
+
+//  Returns the sum of value over the work group to every work item
+uint compactGroupSum( local uint* scratch, uint value )
+{
+    uint lid = get_local_id( 0 );
+    scratch[ lid ] = value;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint offset = get_local_size( 0 ) / 2; offset > 0; offset >>= 1 )
+    {
+        if( lid < offset )
+            scratch[ lid ] += scratch[ lid + offset ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+
+    uint sum = scratch[ 0 ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+    return sum;
+}
+
+template< typename fType, typename fIterType, typename Predicate >
+kernel void compactCountTemplate(
+    global fType* flags_ptr,
+    fIterType flags,
+    const uint length,
+    const uint chunkSize,
+    global Predicate* pred,
+    global uint* chunkCounts,
+    local uint* scratch )
+{
+    flags.init( flags_ptr );
+
+    uint begin = get_group_id( 0 ) * chunkSize;
+    uint end = min( begin + chunkSize, length );
+
+    uint count = 0;
+    for( uint i = begin + get_local_id( 0 ); i < end; i += get_local_size( 0 ) )
+        count += compactKeep( flags, i, pred ) ? 1 : 0;
+
+    count = compactGroupSum( scratch, count );
+    if( get_local_id( 0 ) == 0 )
+        chunkCounts[ get_group_id( 0 ) ] = count;
+}
+
+//  Kept elements of input and values go to output and valuesOutput; rejected elements of input go to rejected,
+//  after all the kept ones when rejectedAfterKept is set.  Outputs nobody asked for are discard_iterators, whose
+//  stores, and the loads feeding them, compile away.
+template< typename fType, typename fIterType,
+          typename iType, typename iIterType,
+          typename oType, typename oIterType,
+          typename rType, typename rIterType,
+          typename vType, typename vIterType,
+          typename voType, typename voIterType,
+          typename Predicate >
+kernel void compactWriteTemplate(
+    global fType* flags_ptr,
+    fIterType flags,
+    global iType* input_ptr,
+    iIterType input,
+    global oType* output_ptr,
+    oIterType output,
+    global rType* rejected_ptr,
+    rIterType rejected,
+    global vType* values_ptr,
+    vIterType values,
+    global voType* valuesOutput_ptr,
+    voIterType valuesOutput,
+    const uint length,
+    const uint chunkSize,
+    const uint numChunks,
+    const int rejectedAfterKept,
+    global Predicate* pred,
+    global uint* chunkCounts,
+    local uint* scratch )
+{
+    flags.init( flags_ptr );
+    input.init( input_ptr );
+    output.init( output_ptr );
+    rejected.init( rejected_ptr );
+    values.init( values_ptr );
+    valuesOutput.init( valuesOutput_ptr );
+
+    uint lid = get_local_id( 0 );
+    uint wgSize = get_local_size( 0 );
+    uint group = get_group_id( 0 );
+
+    //  Where this chunk starts in the output, and how many elements are kept in all
+    uint before = 0;
+    uint total = 0;
+    for( uint c = lid; c < numChunks; c += wgSize )
+    {
+        uint count = chunkCounts[ c ];
+        before += ( c < group ) ? count : 0;
+        total += count;
+    }
+    before = compactGroupSum( scratch, before );
+    total = compactGroupSum( scratch, total );
+
+    //  The host reads the total back from the slot after the chunk counts
+    if( group == 0 && lid == 0 )
+        chunkCounts[ numChunks ] = total;
+
+    uint rejectedBase = rejectedAfterKept ? total : 0;
+    uint begin = group * chunkSize;
+    uint end = min( begin + chunkSize, length );
+
+    for( uint tile = begin; tile < end; tile += wgSize )
+    {
+        uint i = tile + lid;
+        bool keep = ( i < end ) && compactKeep( flags, i, pred );
+
+        //  Inclusive scan of the flags over the tile
+        scratch[ lid ] = keep ? 1 : 0;
+        barrier( CLK_LOCAL_MEM_FENCE );
+        for( uint offset = 1; offset < wgSize; offset <<= 1 )
+        {
+            uint add = ( lid >= offset ) ? scratch[ lid - offset ] : 0;
+            barrier( CLK_LOCAL_MEM_FENCE );
+            scratch[ lid ] += add;
+            barrier( CLK_LOCAL_MEM_FENCE );
+        }
+
+        //  Number of elements kept before element i
+        uint position = before + scratch[ lid ] - ( keep ? 1 : 0 );
+        if( i < end )
+        {
+            if( keep )
+            {
+                output[ position ] = input[ i ];
+                valuesOutput[ position ] = values[ i ];
+            }
+            else
+            {
+                rejected[ rejectedBase + i - position ] = input[ i ];
+            }
+        }
+
+        before += scratch[ wgSize - 1 ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+}
@@ -28,6 +28,8 @@
 #include <bolt/cl/bolt.h>
 #include <string>
 #include <map>
+#include <vector>
+#include <type_traits>
 
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/locks.hpp>
@@ -118,12 +120,20 @@ namespace bolt {
                 static const unsigned SaveCompilerTemps = 0x4;
                 static const unsigned DebugKernelRun = 0x8;
                 static const unsigned AutoTune = 0x10;
+                static const unsigned NoKernelCache = 0x20; // Assemble the kernel string on every call, bypassing the kernel lookup fast path
+                static const unsigned MultiPassScan = 0x40; // Scan with the three kernel path even where the single pass look-back scan is supported
             };
 
             enum e_WaitMode {BalancedWait,	// Balance of Busy and Nice: tries to use Busy for short-running kernels.  \todo: Balanced currently maps to nice.
                              NiceWait,		// Use an OS semaphore to detect completion status.
                              BusyWait,		// Busy a CPU core continuously monitoring results.  Lowest-latency, but requires a dedicated core.
                              ClFinish,      // Call clFinish on the queue.
+                             NoWait,        // Flush the queue and return; the caller waits on an event, see bolt/cl/async.h
+            };
+
+            enum e_HostTransferMode {AutoTransfer,      // Wrap host ranges the device can address in place, stage the rest
+                                     ZeroCopyTransfer,  // Always wrap host ranges with CL_MEM_USE_HOST_PTR
+                                     StagedTransfer,    // Always copy host ranges through the pinned staging ring
             };
 
         public:
@@ -144,8 +154,14 @@ namespace bolt {
                 m_compileOptions(getDefault().m_compileOptions),
                 m_compileForAllDevices(getDefault().m_compileForAllDevices),
                 m_waitMode(getDefault().m_waitMode),
-                m_unroll(getDefault().m_unroll)
-            {};
+                m_unroll(getDefault().m_unroll),
+                m_bufferHighWaterMark(getDefault().m_bufferHighWaterMark),
+                m_hostTransfer(getDefault().m_hostTransfer),
+                m_hostStaging(new hostStaging(getDefault().getStagingChunkSize())),
+                m_streamChunkSize(getDefault().m_streamChunkSize),
+                m_pool(new bufferPool())
+            {
+            };
 
 
             control( const control& ref) :
@@ -159,11 +175,41 @@ namespace bolt {
                 m_compileOptions(ref.m_compileOptions),
                 m_compileForAllDevices(ref.m_compileForAllDevices),
                 m_waitMode(ref.m_waitMode),
-                m_unroll(ref.m_unroll)
+                m_unroll(ref.m_unroll),
+                m_bufferHighWaterMark(ref.m_bufferHighWaterMark),
+                m_hostTransfer(ref.m_hostTransfer),
+                m_hostStaging(new hostStaging(ref.getStagingChunkSize())),
+                m_streamChunkSize(ref.m_streamChunkSize),
+                m_pool(new bufferPool())
             {
                 //printf("control::copy construcor\n");
             };
 
+            /*! \brief Copy a control to run calls on its behalf, waiting for them as waitMode says
+             *  \details Unlike a plain copy, the new control shares the queue, buffer pool, functor ring and host
+             *  staging ring of ref, so that calls made through it keep the pooling and ordering of calls made
+             *  through ref.  Changing ref's settings afterwards does not affect it.
+             */
+            control( const control& ref, e_WaitMode waitMode ) :
+                m_commandQueue(ref.m_commandQueue),
+                m_useHost(ref.m_useHost),
+                m_forceRunMode(ref.m_forceRunMode),
+                m_defaultRunMode(ref.m_defaultRunMode),
+                m_debug(ref.m_debug),
+                m_autoTune(ref.m_autoTune),
+                m_wgPerComputeUnit(ref.m_wgPerComputeUnit),
+                m_compileOptions(ref.m_compileOptions),
+                m_compileForAllDevices(ref.m_compileForAllDevices),
+                m_waitMode(waitMode),
+                m_unroll(ref.m_unroll),
+                m_bufferHighWaterMark(ref.m_bufferHighWaterMark),
+                m_hostTransfer(ref.m_hostTransfer),
+                m_hostStaging(ref.m_hostStaging),
+                m_streamChunkSize(ref.m_streamChunkSize),
+                m_pool(ref.m_pool)
+            {
+            };
+
             //setters:
             //! Set the OpenCL command queue (and associated device) for Bolt algorithms to use.
             //! Only one command-queue can be specified for each call; Bolt does not load-balance across
@@ -209,6 +255,32 @@ namespace bolt {
             /*! unroll assignment */
             void setUnroll(int unroll) { m_unroll = unroll; };
 
+            /*! Choose what Bolt tunes at run time.  AutoTuneDevice lets control::Automatic pick the path from timed
+                calls; AutoTuneWorkShape sweeps work-group shapes the first time reduce, transform_reduce or count
+                runs on a device and stores the winner in the tuning database (see bolt/cl/tuning.h).  Shapes
+                already in the database are used either way.  The default is AutoTuneDevice; it used to be
+                AutoTuneAll, but a sweep compiles several kernels, so an application that wants sweeps at run time
+                has to ask for AutoTuneWorkShape, or fill the database with bolt-tune. */
+            void setAutoTune(e_AutoTuneMode autoTune) { m_autoTune = autoTune; };
+
+            /*! Set the number of bytes the scratch buffer pool may hold before idle buffers are released, least
+                recently used first.  Buffers that are in use are never released, so the pool can temporarily exceed
+                the mark.  Zero, the default, means no limit. */
+            void setBufferHighWaterMark(size_t bytes) { m_bufferHighWaterMark = bytes; };
+
+            /*! Choose how algorithms called with host iterators move the host ranges to the device.  AutoTransfer,
+                the default, wraps a range in place when it starts on a boundary the device can address directly, and
+                stages it otherwise; ZeroCopyTransfer always wraps, as Bolt did before this setting existed. */
+            void setHostTransfer(e_HostTransferMode hostTransfer) { m_hostTransfer = hostTransfer; };
+
+            /*! Set the bytes moved by one slot of the staging ring, at least 4 KB.  The default is 1 MB. */
+            void setStagingChunkSize(size_t bytes) { m_hostStaging->setChunkSize( bytes ); };
+
+            /*! Set the bytes in one buffer of a chunk, for the algorithms of bolt/cl/streaming.h.  Zero, the default,
+                follows the device: no buffer is larger than CL_DEVICE_MAX_MEM_ALLOC_SIZE, and the chunks in flight
+                take at most half of the global memory. */
+            void setStreamChunkSize(size_t bytes) { m_streamChunkSize = bytes; };
+
             //!
             //! Specify the compile options passed to the OpenCL(TM) compiler.
             void setCompileOptions(std::string &compileOptions) { m_compileOptions = compileOptions; };
@@ -227,6 +299,11 @@ namespace bolt {
             e_WaitMode                  getWaitMode() const { return m_waitMode; };
             int                         getUnroll() const { return m_unroll; };
             bool                        getCompileForAllDevices() const { return m_compileForAllDevices; };
+            size_t                      getBufferHighWaterMark() const { return m_bufferHighWaterMark; };
+            e_AutoTuneMode              getAutoTune() const { return m_autoTune; };
+            e_HostTransferMode          getHostTransfer() const { return m_hostTransfer; };
+            size_t                      getStagingChunkSize() const { return m_hostStaging->getChunkSize(); };
+            size_t                      getStreamChunkSize() const { return m_streamChunkSize; };
 
             /*!
               * Return default default \p control structure.  This is used for Bolt API calls when the user
@@ -262,16 +339,147 @@ namespace bolt {
                 */
             static ::cl::CommandQueue getDefaultCommandQueue( );
 
+            /*! \brief Threads and processors used by the MultiCoreCpu path
+             *  \details Every btbb algorithm runs inside one task arena owned by Bolt, so these settings are process
+             *  wide rather than per control.  A change takes effect at the next MultiCoreCpu call; calls already
+             *  running finish in the arena they started in.
+             */
+            struct multiCoreSettings
+            {
+                int threads;                    // arena concurrency, counting the calling thread; 0 uses every hardware thread
+                std::vector< int > affinity;    // logical processors the worker threads are pinned to; empty leaves it to the OS
+                size_t revision;                // bumped by every change, so the arena knows to rebuild itself
+            };
+
+            /*! Bound the threads Bolt runs MultiCoreCpu algorithms on, to share the cores with the rest of the process */
+            static void setMultiCoreThreads( int threads );
+            /*! Pin MultiCoreCpu worker threads to a set of logical processors, such as the cores of one NUMA node */
+            static void setMultiCoreAffinity( const std::vector< int >& processors );
+            static multiCoreSettings getMultiCoreSettings( );
+            static size_t getMultiCoreRevision( );
+
             /*! \brief Buffer pool support functions
+             *  \details Requests are rounded up to a size class (four geometric steps per power of two, from 256
+             *  bytes), and served by the smallest idle buffer of the same context and flags that is no more than
+             *  twice the size class.  Buffers created with CL_MEM_USE_HOST_PTR alias the caller's memory, so they are
+             *  never pooled.
              */
             typedef boost::shared_ptr< ::cl::Buffer > buffPointer;
 
+            struct bufferPoolStats
+            {
+                size_t hits;        // requests served by an idle pooled buffer
+                size_t misses;      // requests that had to create a buffer
+                size_t evictions;   // idle buffers released to honour the high-water mark, or by trimBuffers()
+                size_t peakSize;    // largest number of bytes the pool has held at once
+            };
+
             /*! Return device memory size */
             size_t totalBufferSize( );
             /*! Return a pointer to memory from per allocated memory pool */
             buffPointer acquireBuffer( size_t reqSize, cl_mem_flags flags = CL_MEM_READ_WRITE, const void* host_ptr = NULL );
             /*! Freeing memory*/
             void freeBuffers( );
+            /*! Release idle buffers, least recently used first, until the pool holds at most targetSize bytes */
+            void trimBuffers( size_t targetSize = 0 );
+            /*! Create count idle buffers able to hold reqSize bytes each, so that the first calls do not pay for them */
+            void prewarmBuffers( size_t reqSize, size_t count = 1, cl_mem_flags flags = CL_MEM_READ_WRITE );
+            /*! Return the hit, miss and eviction counters of the buffer pool */
+            bufferPoolStats getBufferPoolStats( );
+
+            /*! Return the size class that a request of reqSize bytes is rounded up to */
+            static size_t bufferSizeClass( size_t reqSize );
+
+            /*! \brief Return a read only buffer holding a copy of a functor, for passing to a kernel
+             *  \details Empty functors carry no state, so they all share one buffer that is never written.  Functors
+             *  of up to functorSlotSize bytes are copied into the next free slot of a ring of persistent buffers, so
+             *  no OpenCL memory object is created per call.  Anything larger is copied into a pooled buffer.
+             */
+            template< typename Functor >
+            buffPointer acquireFunctorBuffer( const Functor& functor )
+            {
+                return acquireFunctorBuffer( &functor, sizeof( Functor ), std::is_empty< Functor >::value );
+            }
+            buffPointer acquireFunctorBuffer( const void* functor, size_t size, bool stateless );
+
+            static const size_t functorSlotSize = 256;
+            static const size_t functorSlotCount = 64;
+
+            /*! \brief Host transfer support
+             *  \details A host range wrapped with CL_MEM_USE_HOST_PTR is only free to use when the runtime can pin it
+             *  where it is; otherwise the runtime copies the whole range, in one blocking pass, every time it is
+             *  mapped.  Ranges the control chooses not to wrap are copied through a small ring of pinned buffers
+             *  instead, so that the copy into one slot overlaps the transfer of the previous one.
+             */
+            struct hostTransferStats
+            {
+                size_t bytesMapped;     // bytes of host ranges wrapped in place
+                size_t bytesCopied;     // bytes copied through the staging ring, in either direction
+                size_t stagedChunks;    // transfers issued from or into a slot of the staging ring
+            };
+
+            static const size_t stagingSlotCount = 4;
+
+            /*! \brief Ring of pinned buffers that host ranges are staged through
+             *  \details The slots stay mapped for the life of the ring, so filling one is a plain memcpy, and a slot
+             *  is only refilled once the transfer that last used it has completed.  The ring belongs to one queue and
+             *  is rebuilt when a transfer names another.  The vectors that stage through a ring share it with their
+             *  control, so that their transfers are counted with the control's.
+             */
+            class hostStaging
+            {
+            public:
+                explicit hostStaging( size_t chunkSize );
+                ~hostStaging( );
+
+                /*! Copy bytes from src into buffer at offset; the writes are ordered on queue before later commands */
+                void toDevice( const ::cl::CommandQueue& queue, const ::cl::Buffer& buffer, size_t offset, const void* src,
+                    size_t bytes );
+                /*! Copy bytes of buffer at offset into dst, returning once all of them have arrived */
+                void toHost( const ::cl::CommandQueue& queue, const ::cl::Buffer& buffer, size_t offset, void* dst,
+                    size_t bytes );
+                /*! Count a host range that was wrapped in place */
+                void mapped( size_t bytes );
+
+                void setChunkSize( size_t bytes );
+                size_t getChunkSize( );
+                hostTransferStats getStats( );
+                void resetStats( );
+
+            private:
+                struct slot
+                {
+                    ::cl::Buffer pinned;
+                    void* host;
+                    ::cl::Event done;
+                };
+
+                // builds the ring on queue unless it is already there; the caller holds m_guard
+                void bindRing( const ::cl::CommandQueue& queue );
+                // waits for every slot and unmaps it; the caller holds m_guard
+                void releaseRing( );
+
+                boost::mutex m_guard;
+                hostTransferStats m_stats;
+                size_t m_chunkSize;
+                ::cl::CommandQueue m_queue;
+                bool m_inOrder;     // an out of order queue does not order later kernels after the writes
+                std::vector< slot > m_ring;
+                size_t m_next;
+
+                hostStaging( const hostStaging& );
+                hostStaging& operator=( const hostStaging& );
+            };
+            typedef boost::shared_ptr< hostStaging > stagingPointer;
+
+            /*! Return true when a host range starting at host_ptr should be wrapped in place rather than staged */
+            bool zeroCopyHostRange( const void* host_ptr ) const;
+            /*! Return the staging ring of this control */
+            stagingPointer getHostStaging( ) const { return m_hostStaging; };
+            /*! Return the bytes of host ranges mapped and copied since the control was created or last reset */
+            hostTransferStats getHostTransferStats( ) const { return m_hostStaging->getStats( ); };
+            /*! Zero the host transfer counters, for instance before a call that is to be measured on its own */
+            void resetHostTransferStats( ) { m_hostStaging->resetStats( ); };
 
         private:
 
@@ -280,11 +488,16 @@ namespace bolt {
                 m_commandQueue( getDefaultCommandQueue( ) ),
                 m_useHost(UseHost),
                 m_debug(debug::None),
-                m_autoTune(AutoTuneAll),
+                m_autoTune(AutoTuneDevice),
                 m_wgPerComputeUnit(8),
                 m_compileForAllDevices(true),
                 m_waitMode(BusyWait),
-                m_unroll(1)
+                m_unroll(1),
+                m_bufferHighWaterMark(0),
+                m_hostTransfer(AutoTransfer),
+                m_hostStaging(new hostStaging(1 << 20)),
+                m_streamChunkSize(0),
+                m_pool(new bufferPool())
             {
                 ::cl_device_type dType = CL_DEVICE_TYPE_CPU;
                 if(m_commandQueue() != NULL)
@@ -323,60 +536,82 @@ namespace bolt {
             bool                m_compileForAllDevices;  // compile for all devices in the context.  False means to only compile for specified device.
             e_WaitMode          m_waitMode;
             int                 m_unroll;
+            size_t              m_bufferHighWaterMark;
+            e_HostTransferMode  m_hostTransfer;
+            stagingPointer      m_hostStaging;  // a copy of a control gets a ring, and counters, of its own
+            size_t              m_streamChunkSize;
 
             struct descBufferKey
             {
                 ::cl::Context buffContext;
                 cl_mem_flags memFlags;
-                const void* host_ptr;
+                size_t buffSize;
             };
 
             struct descBufferValue
             {
-                size_t buffSize;
                 bool inUse;
+                size_t lastUse;
                 ::cl::Buffer buffBuff;
             };
 
+            //  Ordered by flags, then context, then size, so that lower_bound finds the best fitting buffer
             struct descBufferComp
             {
                 bool operator( )( const descBufferKey& lhs, const descBufferKey& rhs ) const
                 {
-                    if( lhs.memFlags < rhs.memFlags )
-                    {
-                        return true;
-                    }
-                    else if( lhs.memFlags == rhs.memFlags )
-                    {
-                        if( lhs.buffContext( ) < rhs.buffContext( ) )
-                        {
-                            return true;
-                        }
-                        else if( lhs.buffContext( ) == rhs.buffContext( ) )
-                        {
-                            if( lhs.host_ptr < rhs.host_ptr )
-                            {
-                                return true;
-                            }
-                            else
-                            {
-                                return false;
-                            }
-                        }
-                        else
-                        {
-                            return false;
-                        }
-                    }
-                    else
-                    {
-                        return false;
-                    }
+                    if( lhs.memFlags != rhs.memFlags )
+                        return lhs.memFlags < rhs.memFlags;
+                    if( lhs.buffContext( ) != rhs.buffContext( ) )
+                        return lhs.buffContext( ) < rhs.buffContext( );
+                    return lhs.buffSize < rhs.buffSize;
                 }
             };
 
             typedef std::multimap< descBufferKey, descBufferValue, descBufferComp > mapBufferType;
 
+            //  One entry of the functor upload ring.  The host copy is the source of a non-blocking write, so it
+            //  may only be overwritten once that write has completed.
+            struct functorSlot
+            {
+                bool inUse;
+                ::cl::Buffer buffBuff;
+                ::cl::Event written;
+                char hostCopy[ functorSlotSize ];
+            };
+
+            /*! \brief The buffer pool and functor ring of a control
+             *  \details A copy of a control gets a pool of its own, while a control made to run calls on behalf of
+             *  another shares that control's.  The buffers handed out hold on to the pool, so it lives until the
+             *  last of them comes back, and it waits for the functor uploads still reading its slots before it goes.
+             */
+            struct bufferPool
+            {
+                bufferPool( );
+                ~bufferPool( );
+
+                // releases idle buffers until the pool holds at most targetSize bytes; the caller holds mapGuard
+                void trimIdleBuffers( size_t targetSize );
+                // waits for the upload of every slot of the functor ring to complete
+                void waitFunctorWrites( );
+
+                mapBufferType mapBuffer;
+                boost::mutex mapGuard;
+                size_t m_bufferPoolSize;
+                size_t m_bufferClock;
+                bufferPoolStats m_bufferStats;
+
+                std::vector< functorSlot > m_functorRing;
+                size_t m_functorNext;
+                cl_command_queue m_functorQueue;    // the ring belongs to one queue, whose ordering makes slot reuse safe
+                ::cl::Buffer m_statelessFunctor;
+
+            private:
+                bufferPool( const bufferPool& );
+                bufferPool& operator=( const bufferPool& );
+            };
+            typedef boost::shared_ptr< bufferPool > poolPointer;
+
             /*! \brief Class used with shared_ptr<> as a custom deleter, to signal to the context object when
              * a buffer is finished being used by a client.  We want to remove the ability to destroy the buffer
              * from the caller; only the context object shall control the lifetime of these scratch
@@ -387,26 +622,49 @@ namespace bolt {
             */
             class UnlockBuffer
             {
+                poolPointer m_pool;
                 mapBufferType::iterator m_iter;
-                control& m_control;
+                size_t m_highWaterMark;
 
             public:
                 //  Basic constructor requires a reference to the container and a positional element
-                UnlockBuffer( control& p_control, mapBufferType::iterator it ): m_iter( it ), m_control( p_control )
+                UnlockBuffer( const poolPointer& p_pool, mapBufferType::iterator it, size_t p_highWaterMark ):
+                    m_pool( p_pool ), m_iter( it ), m_highWaterMark( p_highWaterMark )
                 {}
 
                 void operator( )( const void* pBuff )
                 {
                     //  TODO: I think a general mutex is overkill here; we should try to use an interlocked instruction to modify the
                     //  inUse flag
-                    boost::lock_guard< boost::mutex > lock( m_control.mapGuard );
+                    boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
                     m_iter->second.inUse = false;
+                    m_iter->second.lastUse = ++m_pool->m_bufferClock;
+                    if( m_highWaterMark != 0 )
+                        m_pool->trimIdleBuffers( m_highWaterMark );
+                }
+            };
+
+            /*! \brief Custom deleter for buffers handed out by acquireFunctorBuffer, returning the slot to the ring
+             */
+            class ReleaseFunctorSlot
+            {
+                poolPointer m_pool;
+                size_t m_slot;
+
+            public:
+                ReleaseFunctorSlot( const poolPointer& p_pool, size_t p_slot ): m_pool( p_pool ), m_slot( p_slot )
+                {}
+
+                void operator( )( const ::cl::Buffer* pBuff )
+                {
+                    delete pBuff;
+
+                    boost::lock_guard< boost::mutex > lock( m_pool->mapGuard );
+                    m_pool->m_functorRing[ m_slot ].inUse = false;
                 }
             };
 
-            friend class UnlockBuffer;
-            mapBufferType mapBuffer;
-            boost::mutex mapGuard;
+            poolPointer m_pool;
 
         }; // end class control
 
@@ -420,6 +678,7 @@ namespace bolt {
 //   * Add setter function and getter function, ie "void foo(int fooValue)" and "int foo const { return _foo; }"
 //   * Add the field to the private constructor.  This is used to set the global default "_defaultControl".
 //   * Add the field to the public constructor, copying from the _defaultControl.
+//   * Add the field to the copy constructor, and to the constructor that shares the pools of another control.
 
 // Sample usage:
 // bolt::control c(myCmdQueue);
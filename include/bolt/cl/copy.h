@@ -151,6 +151,97 @@ namespace bolt {
             OutputIterator result,
             const std::string& user_code="");
 
+        /*! copy_if copies the elements of [first, last) for which pred is true to the sequence beginning at result,
+         *  keeping their order.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the source sequence.
+         * \param last  End of the source sequence.
+         * \param result Beginning of the destination sequence.
+         * \param pred Unary predicate deciding which elements are copied.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         * \tparam InputIterator is a model of InputIterator
+         * and \c InputIterator's \c value_type must be convertible to \c OutputIterator's \c value_type.
+         * \tparam OutputIterator is a model of OutputIterator
+         * \tparam Predicate is a model of Predicate
+         *
+         *  \details The OpenCL path counts the copied elements of each work group's chunk in one kernel and writes
+         *  them in a second, so every element of the result is written once.  The following copies the odd values.
+         *
+         *  \code
+         *  #include <bolt/cl/copy.h>
+         *  ...
+         *
+         *  BOLT_FUNCTOR( is_odd,
+         *  struct is_odd
+         *  {
+         *      bool operator( )( const int &x ) const
+         *      {
+         *          return ( x & 1 ) != 0;
+         *      }
+         *  };
+         *  );
+         *
+         *  int input[ 8 ] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+         *  int output[ 8 ];
+         *
+         *  int *end = bolt::cl::copy_if( input, input + 8, output, is_odd( ) );
+         *
+         *  // output is now { 1, 3, 5, 7 } and end - output is 4
+         *  \endcode
+         *
+         *  \sa http://en.cppreference.com/w/cpp/algorithm/copy
+         */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(
+            bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& user_code="");
+
+        /*! This version of copy_if copies the elements of [first, last) whose corresponding element of the stencil
+         *  satisfies pred.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the source sequence.
+         * \param last  End of the source sequence.
+         * \param stencil Beginning of the stencil sequence, as long as the source.
+         * \param result Beginning of the destination sequence.
+         * \param pred Unary predicate applied to the stencil.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(
+            bolt::cl::control &ctl,
+            InputIterator1 first,
+            InputIterator1 last,
+            InputIterator2 stencil,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(
+            InputIterator1 first,
+            InputIterator1 last,
+            InputIterator2 stencil,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& user_code="");
+
         /*!   \}  */
     };
 };
@@ -17,15 +17,25 @@
 
 //#pragma OPENCL EXTENSION cl_amd_printf : enable
 
+//  The host passes the tuned work group size and unroll factor with -D; these are the untuned defaults
+#ifndef REDUCE_WGSIZE
+#define REDUCE_WGSIZE 256
+#endif
+
+#ifndef REDUCE_UNROLL
+#define REDUCE_UNROLL 1
+#endif
+
 #define _REDUCE_STEP(_LENGTH, _IDX, _W) \
     if ((_IDX < _W) && ((_IDX + _W) < _LENGTH)) {\
       scratch_count[_IDX] =  scratch_count[_IDX] + scratch_count[_IDX + _W];\
     }\
     barrier(CLK_LOCAL_MEM_FENCE);
 
-template< typename iTypePtr, typename iTypeIter, typename predicate_function >
-kernel void count_Template(
-    global iTypePtr*    input_ptr, 
+//  The count of an initialized input iterator; count_Template and the zip_iterator kernel that the host generates
+//  share it
+template< typename iTypeIter, typename predicate_function >
+void countRange(
     iTypeIter input_iter,
     const int length,
     global predicate_function* userFunctor,
@@ -38,20 +48,30 @@ kernel void count_Template(
     bool stat;
     int count=0;
 
-    input_iter.init( input_ptr );
-
     //  Initialize the accumulator private variable with data from the input array
     //  This essentially unrolls the loop below at least once
     typename iTypeIter::value_type accumulator;
 
     // Loop sequentially over chunks of input vector, reducing an arbitrary size input
     // length into a length related to the number of workgroups
+    int stride = get_global_size(0);
+#if REDUCE_UNROLL > 1
+    while (gx + (REDUCE_UNROLL - 1) * stride < length)
+    {
+        for (int u = 0; u < REDUCE_UNROLL; ++u)
+        {
+            accumulator = input_iter[gx];
+            count += functor(accumulator) ? 1 : 0;
+            gx += stride;
+        }
+    }
+#endif
     while (gx < length)
     {
         accumulator = input_iter[gx];
         stat =  functor(accumulator);        
         count=  stat?++count:count;
-        gx += get_global_size(0);
+        gx += stride;
     }
 
     //  Initialize local data store
@@ -63,15 +83,11 @@ kernel void count_Template(
     uint tail = length - (get_group_id(0) * get_local_size(0));
 
     // Parallel reduction within a given workgroup using local data store
-    // to share values between workitems
-    _REDUCE_STEP(tail, local_index, 128);
-    _REDUCE_STEP(tail, local_index, 64);
-    _REDUCE_STEP(tail, local_index, 32);
-    _REDUCE_STEP(tail, local_index, 16);
-    _REDUCE_STEP(tail, local_index,  8);
-    _REDUCE_STEP(tail, local_index,  4);
-    _REDUCE_STEP(tail, local_index,  2);
-    _REDUCE_STEP(tail, local_index,  1);
+    // to share values between workitems; the trip count is a compile time constant, so this unrolls
+    for (int w = REDUCE_WGSIZE / 2; w > 0; w >>= 1)
+    {
+        _REDUCE_STEP(tail, local_index, w);
+    }
 
     //  Abort threads that are passed the end of the input vector
     gx = get_global_id (0);
@@ -83,4 +99,18 @@ kernel void count_Template(
     {
         result[get_group_id(0)] = scratch_count[0];        
     }
+}
+
+template< typename iTypePtr, typename iTypeIter, typename predicate_function >
+kernel void count_Template(
+    global iTypePtr*    input_ptr, 
+    iTypeIter input_iter,
+    const int length,
+    global predicate_function* userFunctor,
+    global int*    result,
+    local int*     scratch_count
+)
+{
+    input_iter.init( input_ptr );
+    countRange( input_iter, length, userFunctor, result, scratch_count );
 };
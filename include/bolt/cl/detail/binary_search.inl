@@ -21,6 +21,8 @@
 #define BINARY_SEARCH_WAVEFRONT_SIZE 64
 //#define BINARY_SEARCH_THRESHOLD 16
 
+#include "bolt/cl/iterator/zip_iterator.h"
+
 //TBB Includes
 #if defined(ENABLE_TBB)
 #include "bolt/btbb/binary_search.h"
@@ -68,6 +70,43 @@ namespace bolt {
 
 
 
+        enum searchbatchTypeName { sb_iType, sb_DVForwardIterator, sb_vType, sb_DVInputIterator, sb_oType,
+            sb_DVOutputIterator, sb_StrictWeakOrdering, sb_end };
+
+        //  What the batch search writes for each value; searchbatch_kernel takes the same numbers
+        enum searchBatchMode { sb_lowerBound, sb_upperBound, sb_binarySearch };
+
+        class SearchBatch_KernelTemplateSpecializer : public KernelTemplateSpecializer
+        {
+            public:
+
+            SearchBatch_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+            {
+                addKernelName( "searchbatch_kernel" );
+            }
+
+            const ::std::string operator() ( const ::std::vector< ::std::string>& typeNames ) const
+            {
+                const std::string templateSpecializationString =
+                    "// Dynamic specialization of generic template definition, using user supplied types\n"
+                    "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                    "__kernel void " + name(0) + "(\n"
+                    "global " + typeNames[sb_iType] + " * src,\n"
+                    + typeNames[sb_DVForwardIterator] + " input_iter,\n"
+                    "global " + typeNames[sb_vType] + " * values,\n"
+                    + typeNames[sb_DVInputIterator] + " values_iter,\n"
+                    "global " + typeNames[sb_oType] + " * dst,\n"
+                    + typeNames[sb_DVOutputIterator] + " result_iter,\n"
+                    "const uint numElements,\n"
+                    "const uint numValues,\n"
+                    "const int searchMode,\n"
+                    "global " + typeNames[sb_StrictWeakOrdering] + " * comp\n"
+                    ");\n\n";
+
+                return templateSpecializationString;
+            }
+        };
+
             /*****************************************************************************
              * BS Enqueue
              ****************************************************************************/
@@ -132,7 +171,7 @@ namespace bolt {
                 compileOptions = oss.str();
 
                 BinarySearch_KernelTemplateSpecializer c_kts;
-                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
                     ctl,
                     typeNames,
                     &c_kts,
@@ -145,8 +184,7 @@ namespace bolt {
                                                                 CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
                 ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
 
-                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_comp ),
-                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_comp );
+                control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_comp );
 
                 ::cl::Event kernelEvent, residueKernelEvent;
                 try
@@ -256,8 +294,8 @@ namespace bolt {
             {
 
                 typedef typename std::iterator_traits<ForwardIterator>::value_type Type;
-                int sz = static_cast<int>(last - first);
-                if (sz < 1)
+                size_t length = static_cast< size_t >( last - first );
+                if (length == 0)
                      return false;
 
                 bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode(); // could be dynamic choice some day.
@@ -294,10 +332,17 @@ namespace bolt {
                         dblog->CodePathTaken(BOLTLOG::BOLT_BINARYSEARCH,BOLTLOG::BOLT_OPENCL_GPU,"::Binary_Search::OPENCL_GPU");
                         #endif
                         // Use host pointers memory since these arrays are only write once - no benefit to copying.
-                        // Map the forward iterator to a device_vector
-                        device_vector< Type > range( first, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
-
-                        return binary_search_enqueue( ctl, range.begin( ), range.end( ), value, comp, user_code );
+                        // Map the forward iterator to a device_vector, a slice at a time since device_vector
+                        // indexes in 32 bits; each slice is sorted, so the value is in the range if it is in a slice
+                        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+                        {
+                            int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+                            device_vector< Type > range( first + offset, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
+                                true, ctl );
+                            if( binary_search_enqueue( ctl, range.begin( ), range.end( ), value, comp, user_code ) )
+                                return true;
+                        }
+                        return false;
 
                 }
 
@@ -312,7 +357,7 @@ namespace bolt {
                 bolt::cl::device_vector_tag )
             {
                 typedef typename std::iterator_traits<DVForwardIterator>::value_type iType;
-                int szElements = static_cast<int>(std::distance(first, last) );
+                int szElements = deviceElements( std::distance(first, last) );
                 bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode(); // could be dynamic choice some day.
                 if(runMode == bolt::cl::control::Automatic)
                 {
@@ -362,8 +407,8 @@ namespace bolt {
             {
 
                 typedef typename std::iterator_traits<DVForwardIterator>::value_type iType;
-                int szElements = static_cast<int>(std::distance(first, last) );
-                if (szElements == 0)
+                size_t length = static_cast< size_t >( std::distance( first, last ) );
+                if (length == 0)
                     return false;
 
                 bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode(); // could be dynamic choice some day.
@@ -401,9 +446,271 @@ namespace bolt {
 				    #if defined(BOLT_DEBUG_LOG)
                     dblog->CodePathTaken(BOLTLOG::BOLT_BINARYSEARCH,BOLTLOG::BOLT_OPENCL_GPU,"::Binary_Search::OPENCL_GPU");
                     #endif
-                    return binary_search_enqueue( ctl, first, last, value, comp, user_code );
+                    //  The kernel indexes in 32 bits, so a longer range is searched a slice at a time
+                    for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+                    {
+                        DVForwardIterator sliceFirst = first + offset;
+                        DVForwardIterator sliceLast = sliceFirst + std::min( maxDeviceElements, length - offset );
+                        if( binary_search_enqueue( ctl, sliceFirst, sliceLast, value, comp, user_code ) )
+                            return true;
+                    }
+                    return false;
+                }
+
+            }
+
+            /*****************************************************************************
+             * Batch Search Enqueue
+             ****************************************************************************/
+            template< typename DVForwardIterator, typename DVInputIterator, typename DVOutputIterator,
+                typename StrictWeakOrdering >
+            void search_batch_enqueue( bolt::cl::control &ctl, searchBatchMode mode, const DVForwardIterator &first,
+                const DVForwardIterator &last, const DVInputIterator &values_first, const DVInputIterator &values_last,
+                const DVOutputIterator &result, StrictWeakOrdering comp, const std::string& cl_code )
+            {
+                typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+                typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+                typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+                cl_uint szElements = deviceElements( std::distance( first, last ) );
+                cl_uint szValues = deviceElements( std::distance( values_first, values_last ) );
+
+                std::vector<std::string> typeNames( sb_end );
+                typeNames[ sb_iType ] = TypeName< iType >::get( );
+                typeNames[ sb_DVForwardIterator ] = TypeName< DVForwardIterator >::get( );
+                typeNames[ sb_vType ] = TypeName< vType >::get( );
+                typeNames[ sb_DVInputIterator ] = TypeName< DVInputIterator >::get( );
+                typeNames[ sb_oType ] = TypeName< oType >::get( );
+                typeNames[ sb_DVOutputIterator ] = TypeName< DVOutputIterator >::get( );
+                typeNames[ sb_StrictWeakOrdering ] = TypeName< StrictWeakOrdering >::get( );
+
+                std::vector<std::string> typeDefs;
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< iType >::get() )
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< DVForwardIterator >::get() )
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< vType >::get() )
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< DVInputIterator >::get() )
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< oType >::get() )
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< DVOutputIterator >::get() )
+                PUSH_BACK_UNIQUE( typeDefs, ClCode< StrictWeakOrdering >::get() )
+
+                std::string compileOptions;
+
+                SearchBatch_KernelTemplateSpecializer sb_kts;
+                bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+                    ctl,
+                    typeNames,
+                    &sb_kts,
+                    typeDefs,
+                    binary_search_kernels,
+                    compileOptions);
+
+                size_t localThreads = BINARY_SEARCH_WAVEFRONT_SIZE;
+                size_t globalThreads = ( ( szValues + localThreads - 1 ) / localThreads ) * localThreads;
+
+                ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
+                control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_comp );
+
+                typename DVForwardIterator::Payload input_payload = first.gpuPayload( );
+                typename DVInputIterator::Payload values_payload = values_first.gpuPayload( );
+                typename DVOutputIterator::Payload result_payload = result.gpuPayload( );
+
+                V_OPENCL( kernels[0].setArg( 0, first.getContainer().getBuffer()), "Error setArg kernels[ 0 ]" );
+                V_OPENCL( kernels[0].setArg( 1, first.gpuPayloadSize( ), &input_payload ),
+                    "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg( 2, values_first.getContainer().getBuffer()), "Error setArg kernels[ 0 ]" );
+                V_OPENCL( kernels[0].setArg( 3, values_first.gpuPayloadSize( ), &values_payload ),
+                    "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg( 4, result.getContainer().getBuffer()), "Error setArg kernels[ 0 ]" );
+                V_OPENCL( kernels[0].setArg( 5, result.gpuPayloadSize( ), &result_payload ),
+                    "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg( 6, szElements ), "Error setArg kernels[ 0 ]" );
+                V_OPENCL( kernels[0].setArg( 7, szValues ), "Error setArg kernels[ 0 ]" );
+                V_OPENCL( kernels[0].setArg( 8, static_cast< cl_int >( mode ) ), "Error setArg kernels[ 0 ]" );
+                V_OPENCL( kernels[0].setArg( 9, *userFunctor), "Error setArg kernels[ 0 ]" );
+
+                ::cl::Event kernelEvent;
+                cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+                    kernels[0],
+                    ::cl::NullRange,
+                    ::cl::NDRange( globalThreads ),
+                    ::cl::NDRange( localThreads ),
+                    NULL,
+                    &kernelEvent);
+                V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for searchbatch_kernel" );
+                bolt::cl::wait(ctl, kernelEvent);
+            }
+
+            //  The answer for one value, as std::lower_bound, std::upper_bound or std::binary_search would give it
+            template< typename ForwardIterator, typename T, typename StrictWeakOrdering >
+            size_t search_batch_serial( searchBatchMode mode, ForwardIterator first, ForwardIterator last,
+                const T &value, StrictWeakOrdering comp )
+            {
+                if( mode == sb_lowerBound )
+                    return static_cast< size_t >( std::lower_bound( first, last, value, comp ) - first );
+                if( mode == sb_upperBound )
+                    return static_cast< size_t >( std::upper_bound( first, last, value, comp ) - first );
+                return std::binary_search( first, last, value, comp ) ? 1 : 0;
+            }
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator search_batch_cpu( bolt::cl::control::e_RunMode runMode, searchBatchMode mode,
+                ForwardIterator first, ForwardIterator last, InputIterator values_first, InputIterator values_last,
+                OutputIterator result, StrictWeakOrdering comp )
+            {
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                #if defined(BOLT_DEBUG_LOG)
+                BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+                #endif
+
+                if( runMode == bolt::cl::control::SerialCpu )
+                {
+                    #if defined(BOLT_DEBUG_LOG)
+                    dblog->CodePathTaken(BOLTLOG::BOLT_BINARYSEARCH,BOLTLOG::BOLT_SERIAL_CPU,"::Search_Batch::SERIAL_CPU");
+                    #endif
+                    for( ; values_first != values_last; ++values_first, ++result )
+                        *result = static_cast< oType >( search_batch_serial( mode, first, last, *values_first, comp ) );
+                    return result;
+                }
+
+                #ifdef ENABLE_TBB
+                    #if defined(BOLT_DEBUG_LOG)
+                    dblog->CodePathTaken(BOLTLOG::BOLT_BINARYSEARCH,BOLTLOG::BOLT_MULTICORE_CPU,"::Search_Batch::MULTICORE_CPU");
+                    #endif
+                    if( mode == sb_lowerBound )
+                        return bolt::btbb::lower_bound( first, last, values_first, values_last, result, comp );
+                    if( mode == sb_upperBound )
+                        return bolt::btbb::upper_bound( first, last, values_first, values_last, result, comp );
+                    return bolt::btbb::binary_search( first, last, values_first, values_last, result, comp );
+                #else
+                    throw std::runtime_error("MultiCoreCPU Version of Search Batch not Enabled! \n");
+                #endif
+            }
+
+            /*****************************************************************************
+             * Batch Search Pick Iterator
+             ****************************************************************************/
+
+            //  Host haystack; the values and results are expected to be host ranges too
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator search_batch_pick_iterator( bolt::cl::control &ctl, searchBatchMode mode,
+                const ForwardIterator &first, const ForwardIterator &last, const InputIterator &values_first,
+                const InputIterator &values_last, const OutputIterator &result, StrictWeakOrdering comp,
+                const std::string &user_code, std::random_access_iterator_tag )
+            {
+                typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+                typedef typename std::iterator_traits< InputIterator >::value_type vType;
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                size_t szElements = static_cast< size_t >( last - first );
+                size_t szValues = static_cast< size_t >( values_last - values_first );
+                if( szValues == 0 )
+                    return result;
+
+                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode(); // could be dynamic choice some day.
+                if(runMode == bolt::cl::control::Automatic)
+                {
+                     runMode = ctl.getDefaultPathToRun();
+                }
+
+                //  Nothing to search: every answer is position 0, or not found, and needs no device
+                if( szElements == 0 && runMode != bolt::cl::control::MultiCoreCpu )
+                    runMode = bolt::cl::control::SerialCpu;
+
+                if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+                    return search_batch_cpu( runMode, mode, first, last, values_first, values_last, result, comp );
+
+                #if defined(BOLT_DEBUG_LOG)
+                BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+                dblog->CodePathTaken(BOLTLOG::BOLT_BINARYSEARCH,BOLTLOG::BOLT_OPENCL_GPU,"::Search_Batch::OPENCL_GPU");
+                #endif
+
+                // Use host pointers memory since these arrays are only read or written once - no benefit to copying.
+                device_vector< iType > dvInput( first, szElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true, ctl );
+                device_vector< vType > dvValues( values_first, szValues, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true,
+                    ctl );
+                device_vector< oType > dvResult( result, szValues, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+
+                search_batch_enqueue( ctl, mode, dvInput.begin( ), dvInput.end( ), dvValues.begin( ), dvValues.end( ),
+                    dvResult.begin( ), comp, user_code );
+
+                // This should immediately map/unmap the buffer
+                dvResult.data( );
+                return result + szValues;
+            }
+
+            //  device_vector haystack; the values and results are expected to be device_vector ranges too
+            template< typename DVForwardIterator, typename DVInputIterator, typename DVOutputIterator,
+                typename StrictWeakOrdering >
+            DVOutputIterator search_batch_pick_iterator( bolt::cl::control &ctl, searchBatchMode mode,
+                const DVForwardIterator &first, const DVForwardIterator &last, const DVInputIterator &values_first,
+                const DVInputIterator &values_last, const DVOutputIterator &result, StrictWeakOrdering comp,
+                const std::string &user_code, bolt::cl::device_vector_tag )
+            {
+                typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+                typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+                typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+                size_t szValues = static_cast< size_t >( std::distance( values_first, values_last ) );
+                if( szValues == 0 )
+                    return result;
+
+                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode(); // could be dynamic choice some day.
+                if(runMode == bolt::cl::control::Automatic)
+                {
+                     runMode = ctl.getDefaultPathToRun();
+                }
+
+                if( first == last && runMode != bolt::cl::control::MultiCoreCpu )
+                    runMode = bolt::cl::control::SerialCpu;
+
+                if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+                {
+                    typename bolt::cl::device_vector< iType >::pointer inputBuffer = first.getContainer( ).data( );
+                    typename bolt::cl::device_vector< vType >::pointer valuesBuffer = values_first.getContainer( ).data( );
+                    typename bolt::cl::device_vector< oType >::pointer resultBuffer = result.getContainer( ).data( );
+
+                    //  get( ) rather than operator[ ], which asserts on the empty buffer of an empty haystack
+                    search_batch_cpu( runMode, mode, inputBuffer.get( ) + first.m_Index,
+                        inputBuffer.get( ) + last.m_Index, valuesBuffer.get( ) + values_first.m_Index,
+                        valuesBuffer.get( ) + values_last.m_Index, resultBuffer.get( ) + result.m_Index, comp );
+                    return result + szValues;
                 }
 
+                #if defined(BOLT_DEBUG_LOG)
+                BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+                dblog->CodePathTaken(BOLTLOG::BOLT_BINARYSEARCH,BOLTLOG::BOLT_OPENCL_GPU,"::Search_Batch::OPENCL_GPU");
+                #endif
+
+                search_batch_enqueue( ctl, mode, first, last, values_first, values_last, result, comp, user_code );
+                return result + szValues;
+            }
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator search_batch_detect_random_access( bolt::cl::control &ctl, searchBatchMode mode,
+                ForwardIterator first, ForwardIterator last, InputIterator values_first, InputIterator values_last,
+                OutputIterator result, StrictWeakOrdering comp, const std::string &cl_code,
+                std::random_access_iterator_tag )
+            {
+                static_assert( !is_zip_iterator< ForwardIterator >::value && !is_zip_iterator< InputIterator >::value,
+                               "The batched searches do not take zip_iterator ranges" );
+                return search_batch_pick_iterator( ctl, mode, first, last, values_first, values_last, result, comp,
+                    cl_code, typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+            }
+
+            // No support for non random access iterators
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                typename StrictWeakOrdering >
+            OutputIterator search_batch_detect_random_access( bolt::cl::control &ctl, searchBatchMode mode,
+                ForwardIterator first, ForwardIterator last, InputIterator values_first, InputIterator values_last,
+                OutputIterator result, StrictWeakOrdering comp, const std::string &cl_code,
+                std::forward_iterator_tag )
+            {
+                static_assert( std::is_same< ForwardIterator, std::forward_iterator_tag   >::value, "Bolt only supports random access iterator types" );
+                return result;
             }
 
             /*****************************************************************************
@@ -417,6 +724,8 @@ namespace bolt {
                 ForwardIterator last,
                 const T & value, StrictWeakOrdering comp, const std::string &cl_code, std::random_access_iterator_tag )
             {
+                static_assert( !is_zip_iterator< ForwardIterator >::value,
+                               "binary_search does not take zip_iterator ranges" );
                  return binary_search_pick_iterator(ctl, first, last, value, comp, cl_code,
                  typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
             }
@@ -482,6 +791,181 @@ namespace bolt {
                 typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
         }
 
+        /*****************************************************************************
+         * Batch searches
+         ****************************************************************************/
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator lower_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code )
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+            return detail::search_batch_detect_random_access( ctl, detail::sb_lowerBound, first, last, values_first,
+                values_last, result, bolt::cl::less< iType >( ), cl_code,
+                typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator lower_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code )
+        {
+            return lower_bound( bolt::cl::control::getDefault( ), first, last, values_first, values_last, result,
+                cl_code );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator lower_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code )
+        {
+            return detail::search_batch_detect_random_access( ctl, detail::sb_lowerBound, first, last, values_first,
+                values_last, result, comp, cl_code,
+                typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator lower_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code )
+        {
+            return lower_bound( bolt::cl::control::getDefault( ), first, last, values_first, values_last, result, comp,
+                cl_code );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator upper_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code )
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+            return detail::search_batch_detect_random_access( ctl, detail::sb_upperBound, first, last, values_first,
+                values_last, result, bolt::cl::less< iType >( ), cl_code,
+                typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator upper_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code )
+        {
+            return upper_bound( bolt::cl::control::getDefault( ), first, last, values_first, values_last, result,
+                cl_code );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator upper_bound( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code )
+        {
+            return detail::search_batch_detect_random_access( ctl, detail::sb_upperBound, first, last, values_first,
+                values_last, result, comp, cl_code,
+                typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator upper_bound( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code )
+        {
+            return upper_bound( bolt::cl::control::getDefault( ), first, last, values_first, values_last, result, comp,
+                cl_code );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator binary_search( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code )
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+            return detail::search_batch_detect_random_access( ctl, detail::sb_binarySearch, first, last, values_first,
+                values_last, result, bolt::cl::less< iType >( ), cl_code,
+                typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator >
+        OutputIterator binary_search( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code )
+        {
+            return binary_search( bolt::cl::control::getDefault( ), first, last, values_first, values_last, result,
+                cl_code );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator binary_search( bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code )
+        {
+            return detail::search_batch_detect_random_access( ctl, detail::sb_binarySearch, first, last, values_first,
+                values_last, result, comp, cl_code,
+                typename std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        }
+
+        template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+            typename StrictWeakOrdering >
+        OutputIterator binary_search( ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code )
+        {
+            return binary_search( bolt::cl::control::getDefault( ), first, last, values_first, values_last, result, comp,
+                cl_code );
+        }
+
     }//end of cl namespace
 };//end of bolt namespace
 
@@ -0,0 +1,414 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#pragma once
+#if !defined( BOLT_CL_COMPACT_INL )
+#define BOLT_CL_COMPACT_INL
+#define COMPACT_WGSIZE 256
+
+#include <algorithm>
+#include <sstream>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/iterator/iterator_traits.h"
+#include "bolt/cl/iterator/discard_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
+//  Stream compaction shared by copy_if, remove_if, unique, unique_by_key and partition.  The OpenCL path runs the
+//  two kernels of compact_kernels.cl, which read the flags twice and write every output element once; the CPU paths
+//  of those algorithms run bolt::btbb or the std algorithms directly.  copy.inl includes this file once
+//  bolt::cl::copy is defined; the other algorithms get it through bolt/cl/copy.h.
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+    //  Which elements the kernels keep
+    enum CompactMode { compact_keep_selected, compact_keep_rejected, compact_keep_unique };
+
+namespace cl {
+
+    enum CompactTypes { compact_fType, compact_fIterType,
+                        compact_iType, compact_iIterType,
+                        compact_oType, compact_oIterType,
+                        compact_rType, compact_rIterType,
+                        compact_vType, compact_vIterType,
+                        compact_voType, compact_voIterType,
+                        compact_Predicate, compact_end };
+
+    class Compact_KernelTemplateSpecializer : public KernelTemplateSpecializer
+    {
+    public:
+        Compact_KernelTemplateSpecializer( ) : KernelTemplateSpecializer( )
+        {
+            addKernelName( "compactCountTemplate" );
+            addKernelName( "compactWriteTemplate" );
+        }
+
+        const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+        {
+            const std::string templateSpecializationString =
+                "// Host generates this instantiation string with user-specified value type and functor\n"
+                "template __attribute__((mangled_name(" + name( 0 ) + "Instantiated)))\n"
+                "kernel void " + name( 0 ) + "(\n"
+                "global " + typeNames[ compact_fType ] + "* flags_ptr,\n"
+                + typeNames[ compact_fIterType ] + " flags,\n"
+                "const uint length,\n"
+                "const uint chunkSize,\n"
+                "global " + typeNames[ compact_Predicate ] + "* pred,\n"
+                "global uint* chunkCounts,\n"
+                "local uint* scratch\n"
+                ");\n\n"
+
+                "// Host generates this instantiation string with user-specified value type and functor\n"
+                "template __attribute__((mangled_name(" + name( 1 ) + "Instantiated)))\n"
+                "kernel void " + name( 1 ) + "(\n"
+                "global " + typeNames[ compact_fType ] + "* flags_ptr,\n"
+                + typeNames[ compact_fIterType ] + " flags,\n"
+                "global " + typeNames[ compact_iType ] + "* input_ptr,\n"
+                + typeNames[ compact_iIterType ] + " input,\n"
+                "global " + typeNames[ compact_oType ] + "* output_ptr,\n"
+                + typeNames[ compact_oIterType ] + " output,\n"
+                "global " + typeNames[ compact_rType ] + "* rejected_ptr,\n"
+                + typeNames[ compact_rIterType ] + " rejected,\n"
+                "global " + typeNames[ compact_vType ] + "* values_ptr,\n"
+                + typeNames[ compact_vIterType ] + " values,\n"
+                "global " + typeNames[ compact_voType ] + "* valuesOutput_ptr,\n"
+                + typeNames[ compact_voIterType ] + " valuesOutput,\n"
+                "const uint length,\n"
+                "const uint chunkSize,\n"
+                "const uint numChunks,\n"
+                "const int rejectedAfterKept,\n"
+                "global " + typeNames[ compact_Predicate ] + "* pred,\n"
+                "global uint* chunkCounts,\n"
+                "local uint* scratch\n"
+                ");\n\n";
+
+            return templateSpecializationString;
+        }
+    };
+
+    //  Compacts length elements.  Every iterator must be one the kernels can take: a device_vector iterator, a
+    //  fancy iterator or a discard_iterator.  Kept elements of input and values go to output and valuesOutput,
+    //  rejected elements of input go to rejected, after the kept ones when rejectedAfterKept is set.
+    //  Returns the number of elements kept.
+    template< typename DVFlagsIterator, typename DVInputIterator, typename DVOutputIterator,
+              typename DVRejectedIterator, typename DVValuesIterator, typename DVValuesOutputIterator,
+              typename Predicate >
+    unsigned int compact( control& ctl,
+                          const DVFlagsIterator& flags,
+                          unsigned int length,
+                          const DVInputIterator& input,
+                          const DVOutputIterator& output,
+                          const DVRejectedIterator& rejected,
+                          bool rejectedAfterKept,
+                          const DVValuesIterator& values,
+                          const DVValuesOutputIterator& valuesOutput,
+                          const Predicate& pred,
+                          CompactMode mode,
+                          const std::string& cl_code )
+    {
+        typedef typename std::iterator_traits< DVFlagsIterator >::value_type fType;
+        typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+        typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+        typedef typename std::iterator_traits< DVRejectedIterator >::value_type rType;
+        typedef typename std::iterator_traits< DVValuesIterator >::value_type vType;
+        typedef typename std::iterator_traits< DVValuesOutputIterator >::value_type voType;
+
+        /**********************************************************************************
+         * Type Names - used in KernelTemplateSpecializer
+         *********************************************************************************/
+        std::vector< std::string > typeNames( compact_end );
+        typeNames[ compact_fType ] = TypeName< fType >::get( );
+        typeNames[ compact_fIterType ] = TypeName< DVFlagsIterator >::get( );
+        typeNames[ compact_iType ] = TypeName< iType >::get( );
+        typeNames[ compact_iIterType ] = TypeName< DVInputIterator >::get( );
+        typeNames[ compact_oType ] = TypeName< oType >::get( );
+        typeNames[ compact_oIterType ] = TypeName< DVOutputIterator >::get( );
+        typeNames[ compact_rType ] = TypeName< rType >::get( );
+        typeNames[ compact_rIterType ] = TypeName< DVRejectedIterator >::get( );
+        typeNames[ compact_vType ] = TypeName< vType >::get( );
+        typeNames[ compact_vIterType ] = TypeName< DVValuesIterator >::get( );
+        typeNames[ compact_voType ] = TypeName< voType >::get( );
+        typeNames[ compact_voIterType ] = TypeName< DVValuesOutputIterator >::get( );
+        typeNames[ compact_Predicate ] = TypeName< Predicate >::get( );
+
+        /**********************************************************************************
+         * Type Definitions - directly concatenated into kernel string
+         *********************************************************************************/
+        std::vector< std::string > typeDefinitions;
+        PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< fType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVFlagsIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< rType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVRejectedIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValuesIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< voType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValuesOutputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< Predicate >::get( ) )
+
+        /**********************************************************************************
+         * Compile Options
+         *********************************************************************************/
+        std::string compileOptions;
+        if( mode == compact_keep_unique )
+            compileOptions = " -DBOLT_COMPACT_UNIQUE";
+        else if( mode == compact_keep_rejected )
+            compileOptions = " -DBOLT_COMPACT_INVERT";
+
+        Compact_KernelTemplateSpecializer c_kts;
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+            ctl,
+            typeNames,
+            &c_kts,
+            typeDefinitions,
+            compact_kernels,
+            compileOptions );
+
+        /**********************************************************************************
+         * Chunks - one per work group, a whole number of tiles each
+         *********************************************************************************/
+        const unsigned int wgSize = COMPACT_WGSIZE;
+        unsigned int computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+        unsigned int numChunks = computeUnits * ctl.getWGPerComputeUnit( );
+        unsigned int chunkSize = ( length + numChunks - 1 ) / numChunks;
+        chunkSize = ( ( chunkSize + wgSize - 1 ) / wgSize ) * wgSize;
+        numChunks = ( length + chunkSize - 1 ) / chunkSize;
+
+        ALIGNED( 256 ) Predicate aligned_pred( pred );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_pred );
+        control::buffPointer chunkCounts = ctl.acquireBuffer( ( numChunks + 1 ) * sizeof( cl_uint ) );
+
+        ::cl::LocalSpaceArg scratch;
+        scratch.size_ = wgSize * sizeof( cl_uint );
+
+        typename DVFlagsIterator::Payload flags_payload = flags.gpuPayload( );
+        typename DVInputIterator::Payload input_payload = input.gpuPayload( );
+        typename DVOutputIterator::Payload output_payload = output.gpuPayload( );
+        typename DVRejectedIterator::Payload rejected_payload = rejected.gpuPayload( );
+        typename DVValuesIterator::Payload values_payload = values.gpuPayload( );
+        typename DVValuesOutputIterator::Payload valuesOutput_payload = valuesOutput.gpuPayload( );
+
+        V_OPENCL( kernels[ 0 ].setArg( 0, flags.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 1, flags.gpuPayloadSize( ), &flags_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 2, length ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 3, chunkSize ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 4, *userFunctor ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 5, *chunkCounts ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 6, scratch ), "Error setArg kernels[ 0 ]" );
+
+        V_OPENCL( kernels[ 1 ].setArg( 0, flags.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 1, flags.gpuPayloadSize( ), &flags_payload ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 2, input.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 3, input.gpuPayloadSize( ), &input_payload ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 4, output.getContainer( ).getBuffer( ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 5, output.gpuPayloadSize( ), &output_payload ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 6, rejected.getContainer( ).getBuffer( ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 7, rejected.gpuPayloadSize( ), &rejected_payload ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 8, values.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 9, values.gpuPayloadSize( ), &values_payload ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 10, valuesOutput.getContainer( ).getBuffer( ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 11, valuesOutput.gpuPayloadSize( ), &valuesOutput_payload ),
+            "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 12, length ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 13, chunkSize ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 14, numChunks ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 15, static_cast< cl_int >( rejectedAfterKept ) ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 16, *userFunctor ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 17, *chunkCounts ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[ 1 ].setArg( 18, scratch ), "Error setArg kernels[ 1 ]" );
+
+        cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 0 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numChunks * wgSize ),
+            ::cl::NDRange( wgSize ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for compact count kernel" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 1 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numChunks * wgSize ),
+            ::cl::NDRange( wgSize ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for compact write kernel" );
+
+        //  The write kernel leaves the number of kept elements after the chunk counts
+        cl_uint* total = static_cast< cl_uint* >( ctl.getCommandQueue( ).enqueueMapBuffer( *chunkCounts, true,
+            CL_MAP_READ, numChunks * sizeof( cl_uint ), sizeof( cl_uint ), NULL, NULL, &l_Error ) );
+        V_OPENCL( l_Error, "Error calling map on the compact count buffer" );
+        unsigned int kept = *total;
+
+        ::cl::Event unmapEvent;
+        V_OPENCL( ctl.getCommandQueue( ).enqueueUnmapMemObject( *chunkCounts, total, NULL, &unmapEvent ),
+            "Error calling unmap on the compact count buffer" );
+        V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+
+        return kept;
+    }
+
+} // end of cl namespace
+
+    /*! \brief An output of the compaction kernels
+    *   \details Device ranges and discard_iterators are written as they are.  Host ranges are compacted into a
+    *   temporary device_vector, and copyBack( ) copies the part that was written, so that the host range only
+    *   needs to be as long as the output.
+    */
+    template< typename Iterator, typename Category = typename std::iterator_traits< Iterator >::iterator_category >
+    class compact_output
+    {
+    public:
+        typedef Iterator iterator;
+
+        compact_output( control&, const Iterator& it, unsigned int ): m_it( it )
+        {}
+
+        iterator begin( )
+        {
+            return m_it;
+        }
+
+        void copyBack( unsigned int, unsigned int )
+        {}
+
+    private:
+        Iterator m_it;
+    };
+
+    template< typename Iterator >
+    class compact_output< Iterator, std::random_access_iterator_tag >
+    {
+    public:
+        typedef typename std::iterator_traits< Iterator >::value_type value_type;
+        typedef typename device_vector< value_type >::iterator iterator;
+
+        compact_output( control& ctl, const Iterator& it, unsigned int length ): m_ctl( ctl ), m_it( it ),
+            m_temp( length, value_type( ), CL_MEM_READ_WRITE, false, ctl )
+        {}
+
+        iterator begin( )
+        {
+            return m_temp.begin( );
+        }
+
+        //  Copies elements [first, last) of the output to the host range
+        void copyBack( unsigned int first, unsigned int last )
+        {
+            if( first == last )
+                return;
+
+            host_view< iterator > view( m_ctl, m_temp.begin( ) + first, last - first, CL_MAP_READ );
+            std::copy( view.begin( ), view.begin( ) + ( last - first ), m_it + first );
+        }
+
+    private:
+        control& m_ctl;
+        Iterator m_it;
+        device_vector< value_type > m_temp;
+    };
+
+    /*! \brief The input of an in place compaction
+    *   \details Work groups run in any order, so the kernels cannot compact a device range onto itself; they read
+    *   a copy of it.  Host ranges are read through a buffer of their own and written through compact_output, so
+    *   they need no copy.
+    */
+    template< typename Iterator, typename Category = typename std::iterator_traits< Iterator >::iterator_category >
+    class compact_source
+    {
+    public:
+        typedef Iterator iterator;
+
+        compact_source( control&, const Iterator& it, unsigned int ): m_it( it )
+        {}
+
+        iterator begin( )
+        {
+            return m_it;
+        }
+
+    private:
+        Iterator m_it;
+    };
+
+    template< typename Iterator >
+    class compact_source< Iterator, device_vector_tag >
+    {
+    public:
+        typedef typename std::iterator_traits< Iterator >::value_type value_type;
+        typedef typename device_vector< value_type >::iterator iterator;
+
+        compact_source( control& ctl, const Iterator& it, unsigned int length ):
+            m_copy( length, value_type( ), CL_MEM_READ_WRITE, false, ctl )
+        {
+            bolt::cl::copy( ctl, it, it + length, m_copy.begin( ) );
+        }
+
+        iterator begin( )
+        {
+            return m_copy.begin( );
+        }
+
+    private:
+        device_vector< value_type > m_copy;
+    };
+
+    //  Runs the compaction kernels on any mix of host and device ranges; see cl::compact
+    template< typename FlagsIterator, typename InputIterator, typename OutputIterator, typename RejectedIterator,
+              typename ValuesIterator, typename ValuesOutputIterator, typename Predicate >
+    unsigned int compact( control& ctl,
+                          const FlagsIterator& flags,
+                          unsigned int length,
+                          const InputIterator& input,
+                          const OutputIterator& output,
+                          const RejectedIterator& rejected,
+                          bool rejectedAfterKept,
+                          const ValuesIterator& values,
+                          const ValuesOutputIterator& valuesOutput,
+                          const Predicate& pred,
+                          CompactMode mode,
+                          const std::string& cl_code )
+    {
+        device_view< FlagsIterator > dvFlags( ctl, flags, length, true );
+        device_view< InputIterator > dvInput( ctl, input, length, true );
+        device_view< ValuesIterator > dvValues( ctl, values, length, true );
+        compact_output< OutputIterator > dvOutput( ctl, output, length );
+        compact_output< RejectedIterator > dvRejected( ctl, rejected, length );
+        compact_output< ValuesOutputIterator > dvValuesOutput( ctl, valuesOutput, length );
+
+        unsigned int kept = cl::compact( ctl, dvFlags.begin( ), length, dvInput.begin( ), dvOutput.begin( ),
+            dvRejected.begin( ), rejectedAfterKept, dvValues.begin( ), dvValuesOutput.begin( ), pred, mode, cl_code );
+
+        dvOutput.copyBack( 0, kept );
+        dvValuesOutput.copyBack( 0, kept );
+        if( rejectedAfterKept )
+            dvRejected.copyBack( kept, length );
+        else
+            dvRejected.copyBack( 0, length - kept );
+
+        return kept;
+    }
+
+} // end of detail namespace
+} // end of cl namespace
+} // end of bolt namespace
+
+#endif
@@ -23,6 +23,10 @@
 #define BURST_SIZE 4
 #endif
 
+#include "bolt/cl/functional.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
 #ifdef ENABLE_TBB
 //TBB Includes
 #include "bolt/btbb/copy.h"
@@ -198,7 +202,7 @@ void copy_enqueue(const bolt::cl::control &ctrl, const DVInputIterator& first, c
      * Request Compiled Kernels
      *********************************************************************************/
     Copy_KernelTemplateSpecializer c_kts;
-    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
         ctrl,
         typeNames,
         &c_kts,
@@ -272,7 +276,7 @@ void copy_enqueue(const bolt::cl::control &ctrl, const DVInputIterator& first, c
     cl_command_queue_properties queueProperties;
     l_Error = ctrl.getCommandQueue().getInfo<cl_command_queue_properties>(CL_QUEUE_PROPERTIES, &queueProperties);
     unsigned int profilingEnabled = queueProperties&CL_QUEUE_PROFILING_ENABLE;
-    if ( profilingEnabled ) {
+    if ( profilingEnabled && ctrl.getWaitMode() != control::NoWait ) {
         cl_ulong start_time, stop_time;
 
         V_OPENCL( kernelEvent.getProfilingInfo<cl_ulong>(CL_PROFILING_COMMAND_START, &start_time),
@@ -403,10 +407,16 @@ void copy_pick_iterator(const bolt::cl::control &ctrl,  const InputIterator& fir
         #endif
 		
         // Use host pointers memory since these arrays are only read once - no benefit to copying.
-        // Map the output iterator to a device_vector
-        device_vector< oType > dvOutput( result, n, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctrl );
-        copy_enqueue( ctrl, first, n, dvOutput.begin( ), user_code );
-        dvOutput.data();
+        // Map the output iterator to a device_vector, a slice at a time since device_vector indexes in 32 bits
+        size_t length = static_cast< size_t >( n );
+        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+        {
+            int sliceLength = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+            device_vector< oType > dvOutput( result + offset, sliceLength, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
+                false, ctrl );
+            copy_enqueue( ctrl, first + offset, sliceLength, dvOutput.begin( ), user_code );
+            dvOutput.data();
+        }
      }
 }
 
@@ -667,6 +677,29 @@ void copy_pick_iterator(const bolt::cl::control &ctl,  const DVInputIterator& fi
 }
 
 
+/*! \brief This overload is used when either range is a zip_iterator.
+    \detail The columns are copied in place by a transform through identity: on the OpenCL path its kernel takes
+    one buffer per column, so the tuples are never stored.
+*/
+template<typename InputIterator, typename Size, typename OutputIterator>
+void copy_pick_zip(const bolt::cl::control &ctrl,  const InputIterator& first, const Size& n,
+    const OutputIterator& result, const std::string& user_code, std::true_type )
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type iType;
+
+    //  transform takes a mutable control, for the buffer pools it draws from
+    bolt::cl::control& ctl = const_cast< bolt::cl::control& >( ctrl );
+    unary_transform( ctl, first, first + n, result, bolt::cl::identity< iType >( ), user_code );
+}
+
+template<typename InputIterator, typename Size, typename OutputIterator>
+void copy_pick_zip(const bolt::cl::control &ctrl,  const InputIterator& first, const Size& n,
+    const OutputIterator& result, const std::string& user_code, std::false_type )
+{
+    copy_pick_iterator( ctrl, first, n, result, user_code,
+        typename std::iterator_traits< InputIterator >::iterator_category( ),
+        typename std::iterator_traits< OutputIterator >::iterator_category( ) );
+}
 
 template<typename InputIterator, typename Size, typename OutputIterator >
 OutputIterator copy_detect_random_access( const bolt::cl::control& ctrl, const InputIterator& first, const Size& n,
@@ -678,9 +711,8 @@ OutputIterator copy_detect_random_access( const bolt::cl::control& ctrl, const I
     }
     if (n > 0)
     {
-        copy_pick_iterator( ctrl, first, n, result, user_code,
-            typename std::iterator_traits< InputIterator >::iterator_category( ),
-            typename std::iterator_traits< OutputIterator >::iterator_category( ) );
+        copy_pick_zip( ctrl, first, n, result, user_code, std::integral_constant< bool,
+            is_zip_iterator< InputIterator >::value || is_zip_iterator< OutputIterator >::value >( ) );
     }
     return (result+n);
 };
@@ -695,9 +727,8 @@ OutputIterator copy_detect_random_access( const bolt::cl::control& ctrl, const I
     }
     if (n > 0)
     {
-        copy_pick_iterator( ctrl, first, n, result, user_code,
-             typename std::iterator_traits< InputIterator >::iterator_category( ),
-             typename std::iterator_traits< OutputIterator >::iterator_category( ) );
+        copy_pick_zip( ctrl, first, n, result, user_code, std::integral_constant< bool,
+            is_zip_iterator< InputIterator >::value || is_zip_iterator< OutputIterator >::value >( ) );
     }
     return (result+n);
 };
@@ -720,7 +751,7 @@ template<typename InputIterator, typename OutputIterator>
 OutputIterator copy(const bolt::cl::control &ctrl,  InputIterator first, InputIterator last, OutputIterator result,
             const std::string& user_code)
 {
-    int n = static_cast<int>( std::distance( first, last ) );
+    typename std::iterator_traits< InputIterator >::difference_type n = std::distance( first, last );
     return detail::copy_detect_random_access( ctrl, first, n, result, user_code,
          typename std::iterator_traits< InputIterator >::iterator_category( ) );
 }
@@ -730,7 +761,7 @@ template<typename InputIterator, typename OutputIterator>
 OutputIterator copy( InputIterator first, InputIterator last, OutputIterator result,
             const std::string& user_code)
 {
-    int n = static_cast<int>( std::distance( first, last ) );
+    typename std::iterator_traits< InputIterator >::difference_type n = std::distance( first, last );
             return detail::copy_detect_random_access( control::getDefault(), first, n, result, user_code,
                 typename std::iterator_traits< InputIterator >::iterator_category( ) );
 }
@@ -756,6 +787,124 @@ OutputIterator copy_n(const bolt::cl::control &ctrl, InputIterator first, Size n
 }//end of cl namespace
 };//end of bolt namespace
 
+#include "bolt/cl/detail/compact.inl"
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+OutputIterator copy_if_stencil( bolt::cl::control &ctl, const InputIterator1& first, const InputIterator1& last,
+    const InputIterator2& stencil, const OutputIterator& result, const Predicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator1 >::value && !is_zip_iterator< OutputIterator >::value,
+                   "copy_if does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return result;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_COPY,BOLTLOG::BOLT_SERIAL_CPU,"::Copy_If::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator1 > input( ctl, first, n, CL_MAP_READ );
+        host_view< InputIterator2 > flags( ctl, stencil, n, CL_MAP_READ );
+        host_view< OutputIterator > output( ctl, result, n, CL_MAP_WRITE );
+
+        size_t kept = 0;
+        for( size_t i = 0; i < n; ++i )
+        {
+            if( pred( flags.begin( )[ i ] ) )
+                output.begin( )[ kept++ ] = input.begin( )[ i ];
+        }
+        return result + kept;
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_COPY,BOLTLOG::BOLT_MULTICORE_CPU,"::Copy_If::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator1 > input( ctl, first, n, CL_MAP_READ );
+            host_view< InputIterator2 > flags( ctl, stencil, n, CL_MAP_READ );
+            host_view< OutputIterator > output( ctl, result, n, CL_MAP_WRITE );
+
+            return result + ( bolt::btbb::copy_if( input.begin( ), input.begin( ) + n, flags.begin( ),
+                output.begin( ), pred ) - output.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Copy_If is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_COPY,BOLTLOG::BOLT_OPENCL_GPU,"::Copy_If::OPENCL_GPU");
+        #endif
+
+        //  The compaction indexes in 32 bits, so a longer range is compacted a slice at a time, each slice
+        //  appending what it keeps to what the slices before it kept
+        size_t kept = 0;
+        for( size_t offset = 0; offset < n; offset += maxDeviceElements )
+        {
+            unsigned int length = static_cast< unsigned int >( std::min( maxDeviceElements, n - offset ) );
+            kept += compact( ctl, stencil + offset, length, first + offset, result + kept, make_discard_iterator( ),
+                false, first + offset, make_discard_iterator( ), pred, compact_keep_selected, user_code );
+        }
+        return result + kept;
+    }
+}
+
+}//End OF detail namespace
+
+// user control
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator copy_if( bolt::cl::control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+            Predicate pred, const std::string& user_code )
+{
+    return detail::copy_if_stencil( ctl, first, last, first, result, pred, user_code );
+}
+
+// default control
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator copy_if( InputIterator first, InputIterator last, OutputIterator result, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::copy_if_stencil( control::getDefault( ), first, last, first, result, pred, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+OutputIterator copy_if( bolt::cl::control &ctl, InputIterator1 first, InputIterator1 last, InputIterator2 stencil,
+            OutputIterator result, Predicate pred, const std::string& user_code )
+{
+    return detail::copy_if_stencil( ctl, first, last, stencil, result, pred, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Predicate>
+OutputIterator copy_if( InputIterator1 first, InputIterator1 last, InputIterator2 stencil, OutputIterator result,
+            Predicate pred, const std::string& user_code )
+{
+    return detail::copy_if_stencil( control::getDefault( ), first, last, stencil, result, pred, user_code );
+}
+
+}//end of cl namespace
+};//end of bolt namespace
+
 
 
 
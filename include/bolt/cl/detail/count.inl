@@ -30,7 +30,11 @@
 #include "bolt/cl/distance.h"
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/dispatch.h"
+#include "bolt/cl/tuning.h"
 
 namespace bolt{
 namespace cl{
@@ -110,6 +114,21 @@ namespace serial{
 
 	}
 
+
+	template<typename InputIterator, typename Predicate>
+    typename bolt::cl::iterator_traits<InputIterator>::difference_type
+        count(bolt::cl::control &ctl,
+        const InputIterator& first,
+        const InputIterator& last,
+        const Predicate& predicate,
+        const std::string& cl_code,
+		bolt::cl::zip_iterator_tag)
+    {
+        size_t n = static_cast< size_t >( last - first );
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+		return std::count_if( input.begin( ), input.begin( ) + n, predicate );
+	}
+
 } // end of namespace serial
 
 
@@ -186,6 +205,21 @@ namespace btbb{
 	}
 
 
+	template<typename InputIterator, typename Predicate>
+    typename bolt::cl::iterator_traits<InputIterator>::difference_type
+        count(bolt::cl::control &ctl,
+        const InputIterator& first,
+        const InputIterator& last,
+        const Predicate& predicate,
+        const std::string& cl_code,
+		bolt::cl::zip_iterator_tag)
+    {
+        size_t n = static_cast< size_t >( last - first );
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+		return bolt::btbb::count_if( input.begin( ), input.begin( ) + n, predicate );
+	}
+
+
 }// end of namespace btbb
 #endif
 
@@ -195,23 +229,29 @@ namespace cl{
     ///////////////////////////////////////////////////////////////////////
     //Kernel Template Specializer
     ///////////////////////////////////////////////////////////////////////
+    template< typename InputIterator >
     class Count_KernelTemplateSpecializer : public KernelTemplateSpecializer
     {
+        KernelParameterStrings kps;
         public:
 
         Count_KernelTemplateSpecializer() : KernelTemplateSpecializer()
             {
-                addKernelName( "count_Template" );
+                addKernelName( is_zip_iterator< InputIterator >::value ? "count_ZipTemplate" : "count_Template" );
             }
 
         const ::std::string operator() ( const ::std::vector< ::std::string>& typeNames ) const
         {
+            const std::string inputParams = is_zip_iterator< InputIterator >::value
+                ? kps.getPointerParams< InputIterator >( typeNames[count_iIterType], "input" )
+                : "global " + typeNames[count_iValueType] + "* input_ptr,\n";
+
             const std::string templateSpecializationString =
                     "// Host generates this instantiation string with user-specified value type and functor\n"
                     "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
-                    "__attribute__((reqd_work_group_size(256,1,1)))\n"
+                    "__attribute__((reqd_work_group_size(REDUCE_WGSIZE,1,1)))\n"
                     "kernel void " + name(0) + "(\n"
-                    "global " + typeNames[count_iValueType] + "* input_ptr,\n"
+                     + inputParams
                      + typeNames[count_iIterType] + " output_iter,\n"
                     "const int length,\n"
                     "global " + typeNames[count_predicate] + "* userFunctor,\n"
@@ -221,20 +261,38 @@ namespace cl{
 
             return templateSpecializationString;
         }
+
+        //  A zip_iterator takes one buffer per column, so its kernel is generated here: it hands the column
+        //  pointers to the iterator and runs the countRange of count_kernels
+        const ::std::string getZipKernel( ) const
+        {
+            return
+                "template< typename iTypeIter, typename predicate_function >\n"
+                "kernel void count_ZipTemplate(\n"
+                + kps.getPointerParams< InputIterator >( "typename iTypeIter", "input" ) +
+                "    iTypeIter input_iter,\n"
+                "    const int length,\n"
+                "    global predicate_function* userFunctor,\n"
+                "    global int* result,\n"
+                "    local int* scratch_count)\n"
+                "{\n"
+                + kps.getInitCall< InputIterator >( "input_iter", "input" ) +
+                "    countRange( input_iter, length, userFunctor, result, scratch_count );\n"
+                "}\n";
+        }
     };
 
 
     //----
     // This is the base implementation of reduction that is called by all of the convenience wrappers below.
-    // first and last must be iterators from a DeviceVector
+    // Runs the count kernel over a device range with one launch shape, finishing the sum on the host
     template<typename InputIterator, typename Predicate>
     typename bolt::cl::iterator_traits<InputIterator>::difference_type
-        count(bolt::cl::control &ctl,
+        count_enqueue(bolt::cl::control &ctl,
         const InputIterator& first,
-        const InputIterator& last,
+        cl_uint szElements,
         const Predicate& predicate,
-        const std::string& cl_code,
-		bolt::cl::device_vector_tag)
+        const WorkShape& shape)
     {
         typedef typename std::iterator_traits< InputIterator >::value_type iType;
         typedef typename bolt::cl::iterator_traits<InputIterator>::difference_type rType;
@@ -248,53 +306,51 @@ namespace cl{
         PUSH_BACK_UNIQUE( typeDefinitions, ClCode< InputIterator >::get() )
         PUSH_BACK_UNIQUE( typeDefinitions, ClCode< Predicate  >::get() )
 
-        //bool cpuDevice = ctl.device().getInfo<CL_DEVICE_TYPE>() == CL_DEVICE_TYPE_CPU;
-        /*\TODO - Do CPU specific kernel work group size selection here*/
-        //const size_t kernel0_WgSize = (cpuDevice) ? 1 : WAVESIZE*KERNEL02WAVES;
-        std::string compileOptions;
+        //  The shape is part of the compile options, so every shape gets its own program and kernel cache entry
+        std::ostringstream oss;
+        oss << " -DREDUCE_WGSIZE=" << shape.wgSize << " -DREDUCE_UNROLL=" << shape.unroll;
+        std::string compileOptions = oss.str( );
 
-        Count_KernelTemplateSpecializer ts_kts;
-        std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+        Count_KernelTemplateSpecializer< InputIterator > ts_kts;
+        const std::string zipKernels = is_zip_iterator< InputIterator >::value
+            ? count_kernels + ts_kts.getZipKernel( ) : std::string( );
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
             ctl,
             typeNames,
             &ts_kts,
             typeDefinitions,
-            count_kernels,
+            is_zip_iterator< InputIterator >::value ? zipKernels : count_kernels,
             compileOptions);
 
 
         // Set up shape of launch grid and buffers:
         cl_uint computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
-        int wgPerComputeUnit =  64; //ctl.getWGPerComputeUnit();
-        size_t numWG = computeUnits * wgPerComputeUnit;
+        size_t numWG = computeUnits * shape.wgPerComputeUnit;
 
         cl_int l_Error = CL_SUCCESS;
-        const size_t wgSize  = 256; 
-        V_OPENCL( l_Error, "Error querying kernel for CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE" );
+        const size_t wgSize  = shape.wgSize;
 
         // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
         ALIGNED( 256 ) Predicate aligned_count( predicate );
 
-        control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_count ),
-            CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_count );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_count );
 
 
         control::buffPointer result = ctl.acquireBuffer( sizeof( int ) * numWG,
             CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
 
-        cl_uint szElements = static_cast< cl_uint >( std::distance( first, last ) ); 
          typename InputIterator::Payload  first_payload = first.gpuPayload();
-        V_OPENCL( kernels[0].setArg(0, first.base().getContainer().getBuffer() ), "Error setting kernel argument" );
+        int arg_num = setRangeBuffers( kernels[0], 0, first );
 
-        V_OPENCL( kernels[0].setArg(1, first.gpuPayloadSize( ), &first_payload), "Error setting a kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, first.gpuPayloadSize( ), &first_payload), "Error setting a kernel argument" );
 
-        V_OPENCL( kernels[0].setArg(2, szElements), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg(3, *userFunctor), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg(4, *result), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, szElements), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, *userFunctor), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, *result), "Error setting kernel argument" );
 
         ::cl::LocalSpaceArg loc2;
         loc2.size_ = wgSize*sizeof(int);;
-        V_OPENCL( kernels[0].setArg(5, loc2), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num, loc2), "Error setting kernel argument" );
 
 
         l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
@@ -335,6 +391,32 @@ namespace cl{
 
     }
 
+    /*! \brief Counts over a device range with the OpenCL kernel
+        \detail The launch shape comes from the tuning database, or from a sweep under control::AutoTuneWorkShape;
+        untuned, it is 256 work items, 64 work groups per compute unit and the control's unroll factor.
+    */
+    template<typename InputIterator, typename Predicate>
+    typename bolt::cl::iterator_traits<InputIterator>::difference_type
+        count(bolt::cl::control &ctl,
+        const InputIterator& first,
+        const InputIterator& last,
+        const Predicate& predicate,
+        const std::string& cl_code,
+		bolt::cl::device_vector_tag)
+    {
+        typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+        cl_uint szElements = deviceElements( std::distance( first, last ) );
+        if( szElements == 0 )
+            return 0;
+
+        WorkShape defaults = { 256, 64, ctl.getUnroll( ) };
+        WorkShape shape = detail::tunedWorkShape( ctl, "count", sizeof( iType ), defaults,
+            [ & ]( const WorkShape& candidate ) { count_enqueue( ctl, first, szElements, predicate, candidate ); } );
+
+        return count_enqueue( ctl, first, szElements, predicate, shape );
+    }
+
 
 	template<typename InputIterator, typename Predicate>
     typename bolt::cl::iterator_traits<InputIterator>::difference_type
@@ -346,7 +428,21 @@ namespace cl{
 		std::random_access_iterator_tag)
     {
 
-		 int sz = static_cast<int>(last - first);
+         size_t length = static_cast< size_t >( last - first );
+
+         //  device_vector and the count kernel index in 32 bits, so a longer range is counted a slice at a time
+         if( length > maxDeviceElements )
+         {
+             typename bolt::cl::iterator_traits<InputIterator>::difference_type total = 0;
+             for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+             {
+                 InputIterator sliceFirst = first + offset;
+                 InputIterator sliceLast = sliceFirst + std::min( maxDeviceElements, length - offset );
+                 total += count( ctl, sliceFirst, sliceLast, predicate, cl_code, std::random_access_iterator_tag( ) );
+             }
+             return total;
+         }
+		 int sz = static_cast< int >( length );
 
          typedef typename std::iterator_traits<InputIterator>::value_type  iType;
        	 
@@ -383,6 +479,30 @@ namespace cl{
 		 return count(ctl, first, last, predicate, cl_code, typename bolt::cl::memory_system<InputIterator>::type() );
 
 	}
+
+	// This is called for zip_iterators: the columns are counted in place, one buffer per column
+	template<typename InputIterator, typename Predicate>
+    typename bolt::cl::iterator_traits<InputIterator>::difference_type
+        count(bolt::cl::control &ctl,
+        const InputIterator& first,
+        const InputIterator& last,
+        const Predicate& predicate,
+        const std::string& cl_code,
+		bolt::cl::zip_iterator_tag)
+    {
+        size_t length = static_cast< size_t >( last - first );
+
+        //  Like the random access overload, a range past the 32 bit kernel index is counted a slice at a time
+        typename bolt::cl::iterator_traits<InputIterator>::difference_type total = 0;
+        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+        {
+            int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+            device_view< InputIterator > input( ctl, first + offset, sz, true );
+            total += count( ctl, input.begin( ), input.begin( ) + sz, predicate, cl_code,
+                            bolt::cl::device_vector_tag( ) );
+        }
+        return total;
+	}
 	
 
 } // end of namespace cl
@@ -407,11 +527,11 @@ namespace cl{
         if (szElements == 0)
             return 0;
 	    
-        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-        if(runMode == bolt::cl::control::Automatic)
-        {
-            runMode = ctl.getDefaultPathToRun();
-        }
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< typename std::iterator_traits< InputIterator >::value_type >( "count" ), szElements,
+            detail::hostBytes( first, szElements ),
+            detail::deviceBytes( first, szElements ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
         #if defined(BOLT_DEBUG_LOG)
         BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
         #endif
@@ -20,6 +20,8 @@
 #define BOLT_CL_FILL_INL
 #define WAVEFRONT_SIZE 64
 
+#include "bolt/cl/iterator/zip_iterator.h"
+
 //TBB Includes
 #ifdef ENABLE_TBB
 #include "bolt/btbb/fill.h"
@@ -70,7 +72,7 @@ namespace detail {
                 const DVForwardIterator &last, const T & val, const std::string& cl_code)
             {
                 // how many elements to fill
-                cl_uint sz = static_cast< cl_uint >( std::distance( first, last ) );
+                cl_uint sz = deviceElements( std::distance( first, last ) );
                 if (sz < 1)
                     return;
 
@@ -122,7 +124,7 @@ namespace detail {
                  * Request Compiled Kernels
                  *********************************************************************************/
                 Fill_KernelTemplateSpecializer c_kts;
-                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
                     ctl,
                     typeNames,
                     &c_kts,
@@ -180,7 +182,7 @@ namespace detail {
                 l_Error = ctl.getCommandQueue().getInfo<cl_command_queue_properties>(CL_QUEUE_PROPERTIES,
                     &queueProperties);
                 unsigned int profilingEnabled = queueProperties&CL_QUEUE_PROFILING_ENABLE;
-                if ( profilingEnabled ) {
+                if ( profilingEnabled && ctl.getWaitMode() != control::NoWait ) {
                     cl_ulong start_time, stop_time;
 
                     V_OPENCL( kernelEvent.getProfilingInfo<cl_ulong>(CL_PROFILING_COMMAND_START, &start_time),
@@ -215,8 +217,8 @@ namespace detail {
 
                 typedef typename  std::iterator_traits<ForwardIterator>::value_type Type;
 
-                int sz = static_cast<int>(last - first);
-                if (sz < 1)
+                size_t length = static_cast< size_t >( last - first );
+                if (length == 0)
                     return;
 
                 bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
@@ -254,12 +256,18 @@ namespace detail {
                         dblog->CodePathTaken(BOLTLOG::BOLT_FILL,BOLTLOG::BOLT_OPENCL_GPU,"::Fill::OPENCL_GPU");
                         #endif
                         // Use host pointers memory since these arrays are only write once - no benefit to copying.
-                        // Map the forward iterator to a device_vector
-                        device_vector< Type > range( first, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
-
-                        fill_enqueue( ctl, range.begin( ), range.end( ), value, user_code );
-
-                        range.data( );
+                        // Map the forward iterator to a device_vector, a slice at a time since device_vector
+                        // indexes in 32 bits
+                        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+                        {
+                            int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+                            device_vector< Type > range( first + offset, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
+                                false, ctl );
+
+                            fill_enqueue( ctl, range.begin( ), range.end( ), value, user_code );
+
+                            range.data( );
+                        }
                 }
 
             }
@@ -322,6 +330,37 @@ namespace detail {
                 static_assert( std::is_same< DVForwardIterator, bolt::cl::fancy_iterator_tag  >::value, "It is not possible to fill into fancy iterators. They are not mutable! \n" );
             }
 
+            //  Fills one column of a zip_iterator with its element of the tuple
+            template< unsigned int N, typename Column, typename Tuple >
+            void fill_zip_column( const bolt::cl::control &ctl, const Column &column, size_t sz, const Tuple &value,
+                const std::string& user_code )
+            {
+                fill_pick_iterator( ctl, column, column + sz, bolt::cl::get< N >( value ), user_code,
+                    typename std::iterator_traits< Column >::iterator_category( ) );
+            }
+
+            template< unsigned int N, typename Tuple >
+            void fill_zip_column( const bolt::cl::control &, const null_type &, size_t, const Tuple &,
+                const std::string& )
+            {}
+
+            // This is called for zip_iterators: every column is filled in place with its element of value, which
+            // is a tuple
+            template<typename ZipIterator, typename T>
+            void fill_pick_iterator(const bolt::cl::control &ctl,  const ZipIterator &first,
+                const ZipIterator &last,  const T & value, const std::string& user_code,
+                bolt::cl::zip_iterator_tag )
+            {
+                size_t sz = static_cast< size_t >( last - first );
+                if (sz == 0)
+                    return;
+
+                fill_zip_column< 0 >( ctl, first.column0( ), sz, value, user_code );
+                fill_zip_column< 1 >( ctl, first.column1( ), sz, value, user_code );
+                fill_zip_column< 2 >( ctl, first.column2( ), sz, value, user_code );
+                fill_zip_column< 3 >( ctl, first.column3( ), sz, value, user_code );
+            }
+
 
 
             /*****************************************************************************
@@ -379,9 +418,9 @@ namespace detail {
             const std::string& cl_code )
         {
             detail::fill_detect_random_access( bolt::cl::control::getDefault(),
-                first, first+static_cast< const int >( n ),
+                first, first+n,
                 value, cl_code, typename std::iterator_traits< OutputIterator >::iterator_category( ) );
-            return first+static_cast< const int >( n );
+            return first+n;
         }
 
         // user specified control, start-> +n
@@ -392,9 +431,9 @@ namespace detail {
             const T & value,
             const std::string& cl_code )
         {
-            detail::fill_detect_random_access( ctl, first, first+static_cast< const int >( n ), value, cl_code,
+            detail::fill_detect_random_access( ctl, first, first+n, value, cl_code,
                 typename std::iterator_traits< OutputIterator >::iterator_category( ) );
-            return (first+static_cast< const int >( n ));
+            return (first+n);
         }
 
     }//end of cl namespace
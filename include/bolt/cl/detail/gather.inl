@@ -34,6 +34,7 @@
 #include "bolt/cl/distance.h"
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
 
 
@@ -59,13 +60,13 @@ gather(bolt::cl::control &ctl,
        InputIterator2 input,
        OutputIterator result)
 {
-   int numElements = static_cast< int >( std::distance( mapfirst, maplast ) );
+   size_t numElements = static_cast< size_t >( std::distance( mapfirst, maplast ) );
    typedef typename  std::iterator_traits<InputIterator1>::value_type iType1;
    iType1 temp;
-   for(int iter = 0; iter < numElements; iter++)
+   for(size_t iter = 0; iter < numElements; iter++)
    {
-                   temp = *(mapfirst + (int)iter);
-                  *(result + (int)iter) = *(input + (int)temp);
+                   temp = *(mapfirst + iter);
+                  *(result + iter) = *(input + (int)temp);
    }
 }
 
@@ -148,11 +149,11 @@ gather_if(bolt::cl::control &ctl,
           Predicate pred)
 {
 
-   unsigned int numElements = static_cast< unsigned int >( std::distance( mapfirst, maplast ) );
-   for(unsigned int iter = 0; iter < numElements; iter++)
+   size_t numElements = static_cast< size_t >( std::distance( mapfirst, maplast ) );
+   for(size_t iter = 0; iter < numElements; iter++)
    {
-        if(pred(*(stencil + (int)iter)))
-             result[(int)iter] = input[mapfirst[(int)iter]];
+        if(pred(*(stencil + iter)))
+             result[iter] = input[mapfirst[iter]];
    }
 }
 
@@ -496,7 +497,7 @@ public:
         typedef typename std::iterator_traits<DVInputIterator3>::value_type iType3;
         typedef typename std::iterator_traits<DVOutputIterator>::value_type oType;
 
-        cl_uint distVec = static_cast< cl_uint >( std::distance( map_first, map_last ) );
+        cl_uint distVec = deviceElements( std::distance( map_first, map_last ) );
         if( distVec == 0 )
             return;
 
@@ -574,7 +575,7 @@ public:
           * Request Compiled Kernels
           *********************************************************************************/
          GatherIf_KernelTemplateSpecializer s_if_kts;
-         std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+         bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
              ctl,
              gatherIfKernels,
              &s_if_kts,
@@ -584,9 +585,7 @@ public:
          // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
         ALIGNED( 256 ) Predicate aligned_binary( pred );
-        control::buffPointer userPredicate = ctl.acquireBuffer( sizeof( aligned_binary ),
-                                                                CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY,
-                                                                &aligned_binary );
+        control::buffPointer userPredicate = ctl.acquireFunctorBuffer( aligned_binary );
        typename DVInputIterator1::Payload   map_payload = map_first.gpuPayload( );
        typename DVInputIterator2::Payload   stencil_payload = stencil.gpuPayload( );
        typename DVInputIterator3::Payload   input_payload = input.gpuPayload( );
@@ -641,9 +640,10 @@ public:
 		typedef typename std::iterator_traits<InputIterator3>::value_type iType3;
         typedef typename std::iterator_traits<OutputIterator>::value_type oType;
 
-        int sz = static_cast<int>( std::distance( map_first, map_last ) );
+        int sz = deviceElements( std::distance( map_first, map_last ) );
 
-        device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, false, ctl );
+        //  Elements the map does not reach keep their values, so a staged range is copied in first
+        device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, true, ctl );
 
 		
 	    // Map the input iterator to a device_vector
@@ -704,7 +704,7 @@ public:
         typedef typename std::iterator_traits<DVInputIterator2>::value_type iType2;
         typedef typename std::iterator_traits<DVOutputIterator>::value_type oType;
 
-        cl_uint distVec = static_cast< cl_uint >( std::distance( map_first, map_last ) );
+        cl_uint distVec = deviceElements( std::distance( map_first, map_last ) );
         if( distVec == 0 )
             return;
 
@@ -775,7 +775,7 @@ public:
           * Request Compiled Kernels
           *********************************************************************************/
          GatherKernelTemplateSpecializer s_kts;
-         std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+         bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
              ctl,
              gatherKernels,
              &s_kts,
@@ -830,7 +830,7 @@ public:
         typedef typename std::iterator_traits<InputIterator2>::value_type iType2;
         typedef typename std::iterator_traits<OutputIterator>::value_type oType;
 
-        int sz = static_cast<int>( std::distance( map_first, map_last ) );
+        int sz = deviceElements( std::distance( map_first, map_last ) );
 
         device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, false, ctl );
 
@@ -878,7 +878,8 @@ public:
                              std::input_iterator_tag 
                            >::value ||
                std::is_same< typename std::iterator_traits< OutputIterator>::iterator_category, 
-                             bolt::cl::fancy_iterator_tag >::value ),
+                             bolt::cl::fancy_iterator_tag >::value ||
+               is_zip_iterator< InputIterator3 >::value || is_zip_iterator< OutputIterator >::value ),
                void
                            >::type
     gather_if( bolt::cl::control& ctl,
@@ -891,7 +892,7 @@ public:
                const std::string& user_code )
     {
         
-		int sz = static_cast<int>( std::distance( map_first, map_last ) );
+		size_t sz = static_cast< size_t >( std::distance( map_first, map_last ) );
         if (sz == 0)
             return;
 
@@ -976,7 +977,8 @@ public:
                              std::input_iterator_tag 
                            >::value ||
                std::is_same< typename std::iterator_traits< OutputIterator>::iterator_category, 
-                             bolt::cl::fancy_iterator_tag >::value ),
+                             bolt::cl::fancy_iterator_tag >::value ||
+               is_zip_iterator< InputIterator2 >::value || is_zip_iterator< OutputIterator >::value ),
                void
                            >::type
     gather( bolt::cl::control& ctl,
@@ -987,7 +989,7 @@ public:
             const std::string& user_code)
     {
         
-        int sz = static_cast<int>( std::distance( map_first, map_last ) );
+        size_t sz = static_cast< size_t >( std::distance( map_first, map_last ) );
         if (sz == 0)
             return;
 
@@ -1062,6 +1064,85 @@ public:
     };
 
 
+    //  A zipped input is gathered a column at a time into the matching column of the zipped result; every column
+    //  reads the same map, so the columns stay in step
+    template< typename InputIterator1, typename InputColumn, typename OutputColumn >
+    void gather_zip_column( bolt::cl::control& ctl, const InputIterator1& map_first, const InputIterator1& map_last,
+        const InputColumn& input, const OutputColumn& result, const std::string& user_code )
+    {
+        gather( ctl, map_first, map_last, input, result, user_code );
+    }
+
+    template< typename InputIterator1 >
+    void gather_zip_column( bolt::cl::control&, const InputIterator1&, const InputIterator1&, const null_type&,
+        const null_type&, const std::string& )
+    {
+    }
+
+    template< typename InputIterator1, typename InputIterator2, typename InputColumn, typename OutputColumn,
+        typename Predicate >
+    void gather_if_zip_column( bolt::cl::control& ctl, const InputIterator1& map_first,
+        const InputIterator1& map_last, const InputIterator2& stencil, const InputColumn& input,
+        const OutputColumn& result, const Predicate& pred, const std::string& user_code )
+    {
+        gather_if( ctl, map_first, map_last, stencil, input, result, pred, user_code );
+    }
+
+    template< typename InputIterator1, typename InputIterator2, typename Predicate >
+    void gather_if_zip_column( bolt::cl::control&, const InputIterator1&, const InputIterator1&,
+        const InputIterator2&, const null_type&, const null_type&, const Predicate&, const std::string& )
+    {
+    }
+
+    template< typename InputIterator1,
+              typename InputIterator2,
+              typename OutputIterator >
+    typename std::enable_if< is_zip_iterator< InputIterator2 >::value || is_zip_iterator< OutputIterator >::value
+                           >::type
+    gather( bolt::cl::control& ctl,
+            const InputIterator1& map_first,
+            const InputIterator1& map_last,
+            const InputIterator2& input,
+            const OutputIterator& result,
+            const std::string& user_code)
+    {
+        static_assert( is_zip_iterator< InputIterator2 >::value && is_zip_iterator< OutputIterator >::value,
+                       "gather takes a zip_iterator for both the input and the result, or for neither" );
+        gather_zip_column( ctl, map_first, map_last, input.column0( ), result.column0( ), user_code );
+        gather_zip_column( ctl, map_first, map_last, input.column1( ), result.column1( ), user_code );
+        gather_zip_column( ctl, map_first, map_last, input.column2( ), result.column2( ), user_code );
+        gather_zip_column( ctl, map_first, map_last, input.column3( ), result.column3( ), user_code );
+    }
+
+    template< typename InputIterator1,
+              typename InputIterator2,
+              typename InputIterator3,
+              typename OutputIterator,
+              typename Predicate >
+    typename std::enable_if< is_zip_iterator< InputIterator3 >::value || is_zip_iterator< OutputIterator >::value
+                           >::type
+    gather_if( bolt::cl::control& ctl,
+               const InputIterator1& map_first,
+               const InputIterator1& map_last,
+               const InputIterator2& stencil,
+               const InputIterator3& input,
+               const OutputIterator& result,
+               const Predicate& pred,
+               const std::string& user_code )
+    {
+        static_assert( is_zip_iterator< InputIterator3 >::value && is_zip_iterator< OutputIterator >::value,
+                       "gather_if takes a zip_iterator for both the input and the result, or for neither" );
+        gather_if_zip_column( ctl, map_first, map_last, stencil, input.column0( ), result.column0( ), pred,
+            user_code );
+        gather_if_zip_column( ctl, map_first, map_last, stencil, input.column1( ), result.column1( ), pred,
+            user_code );
+        gather_if_zip_column( ctl, map_first, map_last, stencil, input.column2( ), result.column2( ), pred,
+            user_code );
+        gather_if_zip_column( ctl, map_first, map_last, stencil, input.column3( ), result.column3( ), pred,
+            user_code );
+    }
+
+
 } //End of detail namespace
 
 
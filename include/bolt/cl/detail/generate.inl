@@ -19,6 +19,9 @@
 #define BOLT_CL_GENERATE_INL
 #pragma once
 
+#include "bolt/cl/transform.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
 #ifdef ENABLE_TBB
 //TBB Includes
 #include "bolt/btbb/generate.h"
@@ -35,12 +38,19 @@ enum GenerateTypes { gen_oType, gen_genType, generate_DVInputIterator, generate_
 /**********************************************************************************************************************
  * Kernel Template Specializer
  *********************************************************************************************************************/
+template< typename DVForwardIterator >
 class Generate_KernelTemplateSpecializer : public KernelTemplateSpecializer
 {
+    cl::KernelParameterStrings kps;
     public:
 
     Generate_KernelTemplateSpecializer() : KernelTemplateSpecializer()
     {
+        if( is_zip_iterator< DVForwardIterator >::value )
+        {
+            addKernelName( "generateZipTemplate" );
+            return;
+        }
         addKernelName( "generate_I"   );
         addKernelName( "generate_II"  );
         addKernelName( "generate_III" );
@@ -48,6 +58,16 @@ class Generate_KernelTemplateSpecializer : public KernelTemplateSpecializer
 
     const ::std::string operator() ( const ::std::vector< ::std::string>& typeNames ) const
     {
+        if( is_zip_iterator< DVForwardIterator >::value )
+            return
+                "// Host generates this instantiation string with user-specified value type and generator\n"
+                "template __attribute__((mangled_name("+name(0)+"Instantiated)))\n"
+                "kernel void "+name(0)+"(\n"
+                + kps.getPointerParams< DVForwardIterator >( typeNames[generate_DVInputIterator], "dst" )
+                + typeNames[generate_DVInputIterator] + " input_iter,\n"
+                "const int numElements,\n"
+                "global " + typeNames[gen_genType] + " * restrict genPtr);\n\n";
+
         const std::string templateSpecializationString =
                         "// Host generates this instantiation string with user-specified value type and generator\n"
                 "template __attribute__((mangled_name("+name(0)+"Instantiated)))\n"
@@ -74,6 +94,24 @@ class Generate_KernelTemplateSpecializer : public KernelTemplateSpecializer
 
         return templateSpecializationString;
     }
+
+    //  A zip_iterator takes one buffer per column, so its kernel is generated here; it runs generate_I
+    const ::std::string getZipKernel( ) const
+    {
+        return
+            "template <typename iIterType, typename Generator>\n"
+            "kernel void generateZipTemplate(\n"
+            + kps.getPointerParams< DVForwardIterator >( "typename iIterType", "dst" ) +
+            "    iIterType input_iter,\n"
+            "    const int numElements,\n"
+            "    global Generator * restrict genPtr)\n"
+            "{\n"
+            + kps.getInitCall< DVForwardIterator >( "input_iter", "dst" ) +
+            "    int gloIdx = get_global_id(0);\n"
+            "    if (gloIdx < numElements)\n"
+            "        input_iter[gloIdx] = (*genPtr)();\n"
+            "}\n";
+    }
 };
 
 
@@ -117,7 +155,7 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
     /**********************************************************************************
      * Number of Threads
      *********************************************************************************/
-    const cl_uint numElements = static_cast< cl_uint >( std::distance( first, last ) );
+    const cl_uint numElements = deviceElements( std::distance( first, last ) );
     if (numElements < 1) return;
     const int workGroupSize  = 256;
     const int numComputeUnits = static_cast<int>( ctrl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( ) ); // = 28
@@ -146,13 +184,13 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
     /**********************************************************************************
      * Request Compiled Kernels
      *********************************************************************************/
-    Generate_KernelTemplateSpecializer kts;
-    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+    Generate_KernelTemplateSpecializer< DVForwardIterator > kts;
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
         ctrl,
         typeNames,
         &kts,
         typeDefs,
-        generate_kernels,
+        is_zip_iterator< DVForwardIterator >::value ? kts.getZipKernel( ) : generate_kernels,
         compileOptions);
 
 #ifdef BOLT_ENABLE_PROFILING
@@ -167,8 +205,7 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
                 ALIGNED( 256 ) Generator aligned_generator( gen );
                 // ::cl::Buffer userGenerator(ctl.context(), CL_MEM_READ_ONLY|CL_MEM_USE_HOST_PTR,
                 //  sizeof( aligned_generator ), const_cast< Generator* >( &aligned_generator ) );
-                control::buffPointer userGenerator = ctrl.acquireBuffer( sizeof( aligned_generator ),
-                    CL_MEM_READ_ONLY|CL_MEM_USE_HOST_PTR, &aligned_generator );
+                control::buffPointer userGenerator = ctrl.acquireFunctorBuffer( aligned_generator );
 
 #ifdef BOLT_ENABLE_PROFILING
 aProfiler.nextStep();
@@ -193,11 +230,11 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
     } // switch kernel
 
     typename DVForwardIterator::Payload first_payload = first.gpuPayload( ) ;
-    V_OPENCL( kernels[whichKernel].setArg( 0, first.getContainer().getBuffer()),"Error setArg kernels[0]");//I/P Buffer
-    V_OPENCL( kernels[whichKernel].setArg( 1, first.gpuPayloadSize( ),&first_payload),
+    int arg_num = setRangeBuffers( kernels[whichKernel], 0, first );  // I/P Buffer, one per column of a zip_iterator
+    V_OPENCL( kernels[whichKernel].setArg( arg_num++, first.gpuPayloadSize( ),&first_payload),
         "Error setting a kernel argument" );
-    V_OPENCL( kernels[whichKernel].setArg( 2, numElements),         "Error setArg kernels[ 0 ]" ); // Size of buffer
-    V_OPENCL( kernels[whichKernel].setArg( 3, *userGenerator ),     "Error setArg kernels[ 0 ]" ); // Generator
+    V_OPENCL( kernels[whichKernel].setArg( arg_num++, numElements), "Error setArg kernels[ 0 ]" ); // Size of buffer
+    V_OPENCL( kernels[whichKernel].setArg( arg_num, *userGenerator ), "Error setArg kernels[ 0 ]" ); // Generator
 
 #ifdef BOLT_ENABLE_PROFILING
 aProfiler.nextStep();
@@ -313,8 +350,8 @@ aProfiler.stopTrial();
             {
                 typedef typename std::iterator_traits<ForwardIterator>::value_type Type;
 
-                int sz = static_cast<int>(last - first);
-                if (sz < 1)
+                size_t length = static_cast< size_t >( last - first );
+                if (length == 0)
                     return;
 
                 bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
@@ -352,13 +389,19 @@ aProfiler.stopTrial();
                     #endif
 						
                     // Use host pointers memory since these arrays are only write once - no benefit to copying.
-                    // Map the forward iterator to a device_vector
-                    device_vector< Type > range( first, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
-
-                    generate_enqueue( ctl, range.begin( ), range.end( ), gen, user_code );
-
-                    // This should immediately map/unmap the buffer
-                    range.data( );
+                    // Map the forward iterator to a device_vector, a slice at a time since device_vector indexes
+                    // in 32 bits
+                    for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+                    {
+                        int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+                        device_vector< Type > range( first + offset, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
+                            false, ctl );
+
+                        generate_enqueue( ctl, range.begin( ), range.end( ), gen, user_code );
+
+                        // This should immediately map/unmap the buffer
+                        range.data( );
+                    }
                 }
 }
 
@@ -420,6 +463,61 @@ aProfiler.stopTrial();
                 static_assert( std::is_same< DVForwardIterator, bolt::cl::fancy_iterator_tag  >::value, "It is not possible to generate into fancy iterators. They are not mutable! " );
             }
 
+            // This is called for zip_iterators: the generated tuples are written straight into the columns
+            template<typename ZipIterator, typename Generator>
+            void generate_pick_iterator(bolt::cl::control &ctl,  const ZipIterator &first,
+                const ZipIterator &last,
+                const Generator &gen, const std::string& user_code, bolt::cl::zip_iterator_tag )
+            {
+                size_t length = static_cast< size_t >( last - first );
+                if (length == 0)
+                    return;
+
+                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
+                if(runMode == bolt::cl::control::Automatic)
+                {
+                     runMode = ctl.getDefaultPathToRun();
+                }
+                #if defined(BOLT_DEBUG_LOG)
+                BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+                #endif
+
+                if( runMode == bolt::cl::control::SerialCpu)
+                {
+                    #if defined(BOLT_DEBUG_LOG)
+                    dblog->CodePathTaken(BOLTLOG::BOLT_GENERATE,BOLTLOG::BOLT_SERIAL_CPU,"::Generate::SERIAL_CPU");
+                    #endif
+                    host_view< ZipIterator > range( ctl, first, length, CL_MAP_WRITE );
+                    std::generate( range.begin( ), range.begin( ) + length, gen );
+                }
+                else if(runMode == bolt::cl::control::MultiCoreCpu)
+                {
+                    #ifdef ENABLE_TBB
+                      #if defined(BOLT_DEBUG_LOG)
+                      dblog->CodePathTaken(BOLTLOG::BOLT_GENERATE,BOLTLOG::BOLT_MULTICORE_CPU,"::Generate::MULTICORE_CPU");
+                      #endif
+                      host_view< ZipIterator > range( ctl, first, length, CL_MAP_WRITE );
+                      bolt::btbb::generate( range.begin( ), range.begin( ) + length, gen );
+                    #else
+                        throw std::runtime_error("MultiCoreCPU Version of generate not Enabled! \n");
+                    #endif
+                }
+                else
+                {
+                    #if defined(BOLT_DEBUG_LOG)
+                    dblog->CodePathTaken(BOLTLOG::BOLT_GENERATE,BOLTLOG::BOLT_OPENCL_GPU,"::Generate::OPENCL_GPU");
+                    #endif
+                    //  The columns are wrapped in device_vectors, which index in 32 bits, a slice at a time
+                    for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+                    {
+                        int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+                        device_view< ZipIterator > range( ctl, first + offset, sz, false );
+                        generate_enqueue( ctl, range.begin( ), range.begin( ) + sz, gen, user_code );
+                        range.sync( );
+                    }
+                }
+            }
+
 
 
 
@@ -471,9 +569,9 @@ void generate( bolt::cl::control &ctl, ForwardIterator first, ForwardIterator la
 template<typename OutputIterator, typename Size, typename Generator>
 OutputIterator generate_n( OutputIterator first, Size n, Generator gen, const std::string& cl_code)
 {
-            detail::generate_detect_random_access( bolt::cl::control::getDefault(), first, first+static_cast< const int >( n ), gen, cl_code,
+            detail::generate_detect_random_access( bolt::cl::control::getDefault(), first, first+n, gen, cl_code,
             typename std::iterator_traits< OutputIterator >::iterator_category( ) );
-            return (first+static_cast< const int >( n ));
+            return (first+n);
 }
 
 // user specified control, start-> +n
@@ -481,9 +579,9 @@ template<typename OutputIterator, typename Size, typename Generator>
 OutputIterator generate_n( bolt::cl::control &ctl, OutputIterator first, Size n, Generator gen,
                           const std::string& cl_code)
 {
-            detail::generate_detect_random_access( ctl, first, first+static_cast< const int >( n ), gen, cl_code,
+            detail::generate_detect_random_access( ctl, first, first+n, gen, cl_code,
             typename std::iterator_traits< OutputIterator >::iterator_category( ) );
-            return (first+static_cast< const int >( n ));
+            return (first+n);
 }
 
 }//end of cl namespace
@@ -30,6 +30,8 @@ TODO:
 
 #include <bolt/cl/iterator/iterator_traits.h>
 #include <bolt/cl/iterator/addressof.h>
+#include <bolt/cl/iterator/zip_iterator.h>
+#include "bolt/cl/dispatch.h"
 
 
 //TBB Includes
@@ -109,14 +111,10 @@ namespace serial{
 		OutputType res = init;
 
 		size_t sz = (last1 - first1);
-		std::vector<OutputType> result(sz);
-        for(int index=0; index < (int)(sz); index++)
+        //  Each product is folded in as it is formed, rather than staged in a vector as long as the range
+        for(size_t index=0; index < sz; index++)
         {
-            result[index] = (OutputType)  f2( *(first1+index), *(first2+index) );	
-        }
-		for(int index=0; index < (int)(sz); index++)
-        {
-            res = (OutputType) f1( res, result[index] );	
+            res = (OutputType) f1( res, (OutputType) f2( *(first1+index), *(first2+index) ) );
         }
 		return res;
 	}
@@ -132,19 +130,31 @@ namespace serial{
 		OutputType res = init;
 
 		size_t sz = (last1 - first1);
-		std::vector<OutputType> result(sz);
-        for(int index=0; index < (int)(sz); index++)
+        for(size_t index=0; index < sz; index++)
         {
-            result[index] = (OutputType) f2( *(first1+index), *(first2+index) );	
-        }
-		for(int index=0; index < (int)(sz); index++)
-        {
-            res = (OutputType)  f1( res, result[index] );	
+            res = (OutputType) f1( res, (OutputType) f2( *(first1+index), *(first2+index) ) );
         }
 		return res;
 	}
 
 
+	template<typename InputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+    OutputType inner_product(bolt::cl::control &ctl,  InputIterator& first1,
+                InputIterator& last1, InputIterator& first2, OutputType& init,
+                BinaryFunction1& f1, BinaryFunction2& f2, const std::string& user_code,
+                bolt::cl::zip_iterator_tag )
+    {
+        size_t sz = static_cast< size_t >( last1 - first1 );
+        host_view< InputIterator > input1( ctl, first1, sz, CL_MAP_READ );
+        host_view< InputIterator > input2( ctl, first2, sz, CL_MAP_READ );
+        typename host_view< InputIterator >::iterator mapped_first1 = input1.begin( );
+        typename host_view< InputIterator >::iterator mapped_last1 = mapped_first1 + sz;
+        typename host_view< InputIterator >::iterator mapped_first2 = input2.begin( );
+        return inner_product( ctl, mapped_first1, mapped_last1, mapped_first2, init, f1, f2, user_code,
+            std::random_access_iterator_tag( ) );
+	}
+
+
 }// end of namespace serial
 
 #ifdef ENABLE_TBB
@@ -214,6 +224,19 @@ namespace btbb{
 	}
 
 
+	template<typename InputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+    OutputType inner_product(bolt::cl::control &ctl,  InputIterator& first1,
+                InputIterator& last1, InputIterator& first2, OutputType& init,
+                BinaryFunction1& f1, BinaryFunction2& f2, const std::string& user_code,
+                bolt::cl::zip_iterator_tag )
+    {
+        size_t sz = static_cast< size_t >( last1 - first1 );
+        host_view< InputIterator > input1( ctl, first1, sz, CL_MAP_READ );
+        host_view< InputIterator > input2( ctl, first2, sz, CL_MAP_READ );
+		return  bolt::btbb::inner_product(  input1.begin( ), input1.begin( ) + sz, input2.begin( ), init, f1, f2  );
+	}
+
+
 }// end of namespace btbb
 #endif
 
@@ -259,7 +282,7 @@ namespace cl{
         //Should we directly call transform and reduce routines or launch a separate kernel?
         typedef typename std::iterator_traits<InputIterator>::value_type iType;
 
-        cl_uint distVec = static_cast< cl_uint >( std::distance( first1, last1 ) );
+        cl_uint distVec = deviceElements( std::distance( first1, last1 ) );
         if( distVec == 0 )
             return init;
 
@@ -277,7 +300,24 @@ namespace cl{
                 std::random_access_iterator_tag )
     {
 		
-		int sz = static_cast<int>(last1 - first1);
+        size_t length = static_cast< size_t >( last1 - first1 );
+
+        //  device_vector indexes in 32 bits, so a longer range is folded a slice at a time, each slice starting
+        //  from what the slices before it gave
+        if( length > maxDeviceElements )
+        {
+            OutputType total = init;
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                InputIterator sliceFirst1 = first1 + offset;
+                InputIterator sliceLast1 = sliceFirst1 + std::min( maxDeviceElements, length - offset );
+                InputIterator sliceFirst2 = first2 + offset;
+                total = inner_product( ctl, sliceFirst1, sliceLast1, sliceFirst2, total, f1, f2, user_code,
+                    std::random_access_iterator_tag( ) );
+            }
+            return total;
+        }
+		int sz = static_cast< int >( length );
 
         typedef typename std::iterator_traits<InputIterator>::value_type  iType;
               
@@ -312,6 +352,30 @@ namespace cl{
 		return inner_product( ctl, first1, last1, first2, init, f1, f2, user_code, typename bolt::cl::memory_system<InputIterator>::type()  );
     }
 
+    // This is called for zip_iterators: binary_transform takes one buffer per column, so the tuples are never stored
+    template<typename InputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+    OutputType inner_product(bolt::cl::control &ctl,  InputIterator& first1,
+                InputIterator& last1, InputIterator& first2, OutputType& init,
+                BinaryFunction1& f1, BinaryFunction2& f2, const std::string& user_code,
+                bolt::cl::zip_iterator_tag )
+    {
+        //  The columns are wrapped in device_vectors, which index in 32 bits, a slice at a time
+        size_t length = static_cast< size_t >( last1 - first1 );
+        OutputType total = init;
+        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+        {
+            int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+            device_view< InputIterator > input1( ctl, first1 + offset, sz, true );
+            device_view< InputIterator > input2( ctl, first2 + offset, sz, true );
+            typename device_view< InputIterator >::iterator device_first1 = input1.begin( );
+            typename device_view< InputIterator >::iterator device_last1 = device_first1 + sz;
+            typename device_view< InputIterator >::iterator device_first2 = input2.begin( );
+            total = inner_product( ctl, device_first1, device_last1, device_first2, total, f1, f2, user_code,
+                bolt::cl::device_vector_tag( ) );
+        }
+        return total;
+    }
+
 
 } //end of namespace cl
 
@@ -328,16 +392,16 @@ namespace cl{
                 BinaryFunction1 f1, BinaryFunction2 f2, const std::string& user_code )
     {
         typedef typename std::iterator_traits<InputIterator>::value_type iType;
-        int sz = static_cast<int>( std::distance( first1, last1 ) );
+        size_t sz = static_cast< size_t >( std::distance( first1, last1 ) );
 
         if( sz == 0 )
             return init;
 
-        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-        if(runMode == bolt::cl::control::Automatic)
-        {
-             runMode = ctl.getDefaultPathToRun();
-        }
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< iType >( "inner_product" ), sz,
+            detail::hostBytes( first1, sz ) + detail::hostBytes( first2, sz ),
+            detail::deviceBytes( first1, sz ) + detail::deviceBytes( first2, sz ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
         #if defined(BOLT_DEBUG_LOG)
         BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
         #endif
@@ -20,6 +20,8 @@
 #define BOLT_CL_MERGE_INL
 #pragma once
 
+#include "bolt/cl/iterator/zip_iterator.h"
+
 #ifdef ENABLE_TBB
 //TBB Includes
 #include "bolt/btbb/merge.h"
@@ -125,7 +127,7 @@ namespace bolt {
                 //oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
 
                 Merge_KernelTemplateSpecializer ts_kts;
-                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
                     ctl,
                     typeNames,
                     &ts_kts,
@@ -150,8 +152,7 @@ namespace bolt {
                 ALIGNED( 256 ) StrictWeakCompare aligned_merge( comp );
                 //::cl::Buffer userFunctor(ctl.context(), CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, sizeof(aligned_merge),
                 //  &aligned_merge );
-                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_merge ),
-                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_merge );
+                control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_merge );
 
 
 //                control::buffPointer result = ctl.acquireBuffer( sizeof( T ) * numWG,
@@ -238,7 +239,7 @@ namespace bolt {
 					  #if defined(BOLT_DEBUG_LOG)
                       dblog->CodePathTaken(BOLTLOG::BOLT_MERGE,BOLTLOG::BOLT_OPENCL_GPU,"::Merge::OPENCL_GPU");
                       #endif
-                      int sz = static_cast<int> ( (last1-first1) + (last2-first2) );
+                      int sz = deviceElements( (last1-first1) + (last2-first2) );
                       device_vector< iType1 > dvInput1( first1, last1, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
                       device_vector< iType2 > dvInput2( first2, last2, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
                       device_vector< oType >  dvresult(  result, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
@@ -470,6 +471,10 @@ namespace bolt {
                 const std::string& cl_code,
                 std::random_access_iterator_tag)
             {
+                static_assert( !is_zip_iterator< DVInputIterator1 >::value &&
+                               !is_zip_iterator< DVInputIterator2 >::value &&
+                               !is_zip_iterator< DVOutputIterator >::value,
+                               "merge does not take zip_iterator ranges" );
                 return merge_pick_iterator( ctl, first1, last1, first2, last2,result, comp, cl_code,
                     typename std::iterator_traits< DVInputIterator1 >::iterator_category( ) );
             }
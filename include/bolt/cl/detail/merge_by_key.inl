@@ -0,0 +1,381 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MERGE_BY_KEY_INL )
+#define BOLT_CL_MERGE_BY_KEY_INL
+#pragma once
+#define MERGE_BY_KEY_WGSIZE 256
+#define MERGE_BY_KEY_ITEMS_PER_THREAD 8
+
+#include "bolt/cl/copy.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/merge_by_key.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+namespace cl {
+
+    enum MergeByKeyTypes { mbk_kType1, mbk_kIterType1,
+                           mbk_kType2, mbk_kIterType2,
+                           mbk_vType1, mbk_vIterType1,
+                           mbk_vType2, mbk_vIterType2,
+                           mbk_koType, mbk_koIterType,
+                           mbk_voType, mbk_voIterType,
+                           mbk_Compare, mbk_end };
+
+    class MergeByKey_KernelTemplateSpecializer : public KernelTemplateSpecializer
+    {
+    public:
+        MergeByKey_KernelTemplateSpecializer( ) : KernelTemplateSpecializer( )
+        {
+            addKernelName( "mergeByKeyTemplate" );
+        }
+
+        const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+        {
+            const std::string templateSpecializationString =
+                "// Host generates this instantiation string with user-specified value type and functor\n"
+                "template __attribute__((mangled_name(" + name( 0 ) + "Instantiated)))\n"
+                "kernel void " + name( 0 ) + "(\n"
+                "global " + typeNames[ mbk_kType1 ] + "* keys1_ptr,\n"
+                + typeNames[ mbk_kIterType1 ] + " keys1,\n"
+                "const uint length1,\n"
+                "global " + typeNames[ mbk_kType2 ] + "* keys2_ptr,\n"
+                + typeNames[ mbk_kIterType2 ] + " keys2,\n"
+                "const uint length2,\n"
+                "global " + typeNames[ mbk_vType1 ] + "* values1_ptr,\n"
+                + typeNames[ mbk_vIterType1 ] + " values1,\n"
+                "global " + typeNames[ mbk_vType2 ] + "* values2_ptr,\n"
+                + typeNames[ mbk_vIterType2 ] + " values2,\n"
+                "global " + typeNames[ mbk_koType ] + "* keysOutput_ptr,\n"
+                + typeNames[ mbk_koIterType ] + " keysOutput,\n"
+                "global " + typeNames[ mbk_voType ] + "* valuesOutput_ptr,\n"
+                + typeNames[ mbk_voIterType ] + " valuesOutput,\n"
+                "const uint itemsPerThread,\n"
+                "global " + typeNames[ mbk_Compare ] + "* comp\n"
+                ");\n\n";
+
+            return templateSpecializationString;
+        }
+    };
+
+    //  Merges two device ranges sorted by key.  Every iterator must be one the kernel can take: a device_vector
+    //  iterator or a fancy iterator.  Every work item finds where its piece of the merge starts with one binary
+    //  search and writes it straight to the outputs.
+    template< typename DVKeysIterator1, typename DVKeysIterator2, typename DVValuesIterator1,
+              typename DVValuesIterator2, typename DVKeysOutputIterator, typename DVValuesOutputIterator,
+              typename StrictWeakCompare >
+    void merge_by_key( control& ctl,
+                       const DVKeysIterator1& keys1,
+                       unsigned int length1,
+                       const DVKeysIterator2& keys2,
+                       unsigned int length2,
+                       const DVValuesIterator1& values1,
+                       const DVValuesIterator2& values2,
+                       const DVKeysOutputIterator& keysOutput,
+                       const DVValuesOutputIterator& valuesOutput,
+                       const StrictWeakCompare& comp,
+                       const std::string& cl_code )
+    {
+        typedef typename std::iterator_traits< DVKeysIterator1 >::value_type kType1;
+        typedef typename std::iterator_traits< DVKeysIterator2 >::value_type kType2;
+        typedef typename std::iterator_traits< DVValuesIterator1 >::value_type vType1;
+        typedef typename std::iterator_traits< DVValuesIterator2 >::value_type vType2;
+        typedef typename std::iterator_traits< DVKeysOutputIterator >::value_type koType;
+        typedef typename std::iterator_traits< DVValuesOutputIterator >::value_type voType;
+
+        /**********************************************************************************
+         * Type Names - used in KernelTemplateSpecializer
+         *********************************************************************************/
+        std::vector< std::string > typeNames( mbk_end );
+        typeNames[ mbk_kType1 ] = TypeName< kType1 >::get( );
+        typeNames[ mbk_kIterType1 ] = TypeName< DVKeysIterator1 >::get( );
+        typeNames[ mbk_kType2 ] = TypeName< kType2 >::get( );
+        typeNames[ mbk_kIterType2 ] = TypeName< DVKeysIterator2 >::get( );
+        typeNames[ mbk_vType1 ] = TypeName< vType1 >::get( );
+        typeNames[ mbk_vIterType1 ] = TypeName< DVValuesIterator1 >::get( );
+        typeNames[ mbk_vType2 ] = TypeName< vType2 >::get( );
+        typeNames[ mbk_vIterType2 ] = TypeName< DVValuesIterator2 >::get( );
+        typeNames[ mbk_koType ] = TypeName< koType >::get( );
+        typeNames[ mbk_koIterType ] = TypeName< DVKeysOutputIterator >::get( );
+        typeNames[ mbk_voType ] = TypeName< voType >::get( );
+        typeNames[ mbk_voIterType ] = TypeName< DVValuesOutputIterator >::get( );
+        typeNames[ mbk_Compare ] = TypeName< StrictWeakCompare >::get( );
+
+        /**********************************************************************************
+         * Type Definitions - directly concatenated into kernel string
+         *********************************************************************************/
+        std::vector< std::string > typeDefinitions;
+        PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< kType1 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeysIterator1 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< kType2 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeysIterator2 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType1 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValuesIterator1 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType2 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValuesIterator2 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< koType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeysOutputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< voType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValuesOutputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< StrictWeakCompare >::get( ) )
+
+        MergeByKey_KernelTemplateSpecializer m_kts;
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+            ctl,
+            typeNames,
+            &m_kts,
+            typeDefinitions,
+            merge_path_kernels,
+            "" );
+
+        const unsigned int wgSize = MERGE_BY_KEY_WGSIZE;
+        const unsigned int itemsPerThread = MERGE_BY_KEY_ITEMS_PER_THREAD;
+        unsigned int numItems = ( length1 + length2 + itemsPerThread - 1 ) / itemsPerThread;
+        unsigned int numGroups = ( numItems + wgSize - 1 ) / wgSize;
+
+        ALIGNED( 256 ) StrictWeakCompare aligned_comp( comp );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_comp );
+
+        typename DVKeysIterator1::Payload keys1_payload = keys1.gpuPayload( );
+        typename DVKeysIterator2::Payload keys2_payload = keys2.gpuPayload( );
+        typename DVValuesIterator1::Payload values1_payload = values1.gpuPayload( );
+        typename DVValuesIterator2::Payload values2_payload = values2.gpuPayload( );
+        typename DVKeysOutputIterator::Payload keysOutput_payload = keysOutput.gpuPayload( );
+        typename DVValuesOutputIterator::Payload valuesOutput_payload = valuesOutput.gpuPayload( );
+
+        V_OPENCL( kernels[ 0 ].setArg( 0, keys1.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 1, keys1.gpuPayloadSize( ), &keys1_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 2, length1 ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 3, keys2.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 4, keys2.gpuPayloadSize( ), &keys2_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 5, length2 ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 6, values1.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 7, values1.gpuPayloadSize( ), &values1_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 8, values2.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 9, values2.gpuPayloadSize( ), &values2_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 10, keysOutput.getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 11, keysOutput.gpuPayloadSize( ), &keysOutput_payload ),
+            "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 12, valuesOutput.getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 13, valuesOutput.gpuPayloadSize( ), &valuesOutput_payload ),
+            "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 14, itemsPerThread ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 15, *userFunctor ), "Error setArg kernels[ 0 ]" );
+
+        ::cl::Event kernelEvent;
+        cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 0 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numGroups * wgSize ),
+            ::cl::NDRange( wgSize ),
+            NULL,
+            &kernelEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for merge_by_key kernel" );
+
+        bolt::cl::wait( ctl, kernelEvent );
+    }
+
+} // end of cl namespace
+
+    //  Merges by key on the host; equal keys are taken from the first range first, as std::merge does
+    template<typename KeysIterator1, typename KeysIterator2, typename ValuesIterator1, typename ValuesIterator2,
+             typename KeysOutputIterator, typename ValuesOutputIterator, typename StrictWeakCompare>
+    void serial_merge_by_key( const KeysIterator1& keys1, size_t n1, const KeysIterator2& keys2, size_t n2,
+        const ValuesIterator1& values1, const ValuesIterator2& values2, const KeysOutputIterator& keysOutput,
+        const ValuesOutputIterator& valuesOutput, const StrictWeakCompare& comp )
+    {
+        size_t i = 0, j = 0;
+        for( size_t out = 0; out < n1 + n2; ++out )
+        {
+            if( j >= n2 || ( i < n1 && !comp( keys2[ j ], keys1[ i ] ) ) )
+            {
+                keysOutput[ out ] = keys1[ i ];
+                valuesOutput[ out ] = values1[ i ];
+                ++i;
+            }
+            else
+            {
+                keysOutput[ out ] = keys2[ j ];
+                valuesOutput[ out ] = values2[ j ];
+                ++j;
+            }
+        }
+    }
+
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2, typename StrictWeakCompare>
+bolt::cl::pair<OutputIterator1, OutputIterator2> merge_by_key( bolt::cl::control &ctl,
+    const InputIterator1& keys_first1, const InputIterator1& keys_last1, const InputIterator2& keys_first2,
+    const InputIterator2& keys_last2, const InputIterator3& values_first1, const InputIterator4& values_first2,
+    const OutputIterator1& keys_result, const OutputIterator2& values_result, const StrictWeakCompare& comp,
+    const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator1 >::value && !is_zip_iterator< InputIterator3 >::value &&
+                   !is_zip_iterator< OutputIterator1 >::value && !is_zip_iterator< OutputIterator2 >::value,
+                   "merge_by_key does not take zip_iterator ranges" );
+    size_t n1 = static_cast< size_t >( std::distance( keys_first1, keys_last1 ) );
+    size_t n2 = static_cast< size_t >( std::distance( keys_first2, keys_last2 ) );
+    size_t n = n1 + n2;
+    if( n == 0 )
+        return bolt::cl::make_pair( keys_result, values_result );
+
+    //  With one range empty the merge is a copy of the other
+    if( n1 == 0 )
+        return bolt::cl::make_pair( bolt::cl::copy( ctl, keys_first2, keys_last2, keys_result, user_code ),
+            bolt::cl::copy_n( ctl, values_first2, n2, values_result, user_code ) );
+    if( n2 == 0 )
+        return bolt::cl::make_pair( bolt::cl::copy( ctl, keys_first1, keys_last1, keys_result, user_code ),
+            bolt::cl::copy_n( ctl, values_first1, n1, values_result, user_code ) );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_MERGEBYKEY,BOLTLOG::BOLT_SERIAL_CPU,"::Merge_By_Key::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator1 > keys1( ctl, keys_first1, n1, CL_MAP_READ );
+        host_view< InputIterator2 > keys2( ctl, keys_first2, n2, CL_MAP_READ );
+        host_view< InputIterator3 > values1( ctl, values_first1, n1, CL_MAP_READ );
+        host_view< InputIterator4 > values2( ctl, values_first2, n2, CL_MAP_READ );
+        host_view< OutputIterator1 > keysOutput( ctl, keys_result, n, CL_MAP_WRITE );
+        host_view< OutputIterator2 > valuesOutput( ctl, values_result, n, CL_MAP_WRITE );
+
+        serial_merge_by_key( keys1.begin( ), n1, keys2.begin( ), n2, values1.begin( ), values2.begin( ),
+            keysOutput.begin( ), valuesOutput.begin( ), comp );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_MERGEBYKEY,BOLTLOG::BOLT_MULTICORE_CPU,"::Merge_By_Key::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator1 > keys1( ctl, keys_first1, n1, CL_MAP_READ );
+            host_view< InputIterator2 > keys2( ctl, keys_first2, n2, CL_MAP_READ );
+            host_view< InputIterator3 > values1( ctl, values_first1, n1, CL_MAP_READ );
+            host_view< InputIterator4 > values2( ctl, values_first2, n2, CL_MAP_READ );
+            host_view< OutputIterator1 > keysOutput( ctl, keys_result, n, CL_MAP_WRITE );
+            host_view< OutputIterator2 > valuesOutput( ctl, values_result, n, CL_MAP_WRITE );
+
+            bolt::btbb::merge_by_key( keys1.begin( ), keys1.begin( ) + n1, keys2.begin( ), keys2.begin( ) + n2,
+                values1.begin( ), values2.begin( ), keysOutput.begin( ), valuesOutput.begin( ), comp );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Merge_By_Key is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_MERGEBYKEY,BOLTLOG::BOLT_OPENCL_GPU,"::Merge_By_Key::OPENCL_GPU");
+        #endif
+
+        //  The merge path runs over both ranges at once, so they are not cut into slices
+        int length1 = deviceElements( n1 );
+        int length2 = deviceElements( n2 );
+        int length = deviceElements( n );
+        device_view< InputIterator1 > dvKeys1( ctl, keys_first1, length1, true );
+        device_view< InputIterator2 > dvKeys2( ctl, keys_first2, length2, true );
+        device_view< InputIterator3 > dvValues1( ctl, values_first1, length1, true );
+        device_view< InputIterator4 > dvValues2( ctl, values_first2, length2, true );
+        compact_output< OutputIterator1 > dvKeysOutput( ctl, keys_result, length );
+        compact_output< OutputIterator2 > dvValuesOutput( ctl, values_result, length );
+
+        cl::merge_by_key( ctl, dvKeys1.begin( ), length1, dvKeys2.begin( ), length2, dvValues1.begin( ),
+            dvValues2.begin( ), dvKeysOutput.begin( ), dvValuesOutput.begin( ), comp, user_code );
+
+        dvKeysOutput.copyBack( 0, length );
+        dvValuesOutput.copyBack( 0, length );
+    }
+
+    return bolt::cl::make_pair( keys_result + n, values_result + n );
+}
+
+}//End OF detail namespace
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2> merge_by_key( bolt::cl::control &ctl, InputIterator1 keys_first1,
+            InputIterator1 keys_last1, InputIterator2 keys_first2, InputIterator2 keys_last2,
+            InputIterator3 values_first1, InputIterator4 values_first2, OutputIterator1 keys_result,
+            OutputIterator2 values_result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::merge_by_key( ctl, keys_first1, keys_last1, keys_first2, keys_last2, values_first1,
+        values_first2, keys_result, values_result, bolt::cl::less<T>( ), user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2> merge_by_key( InputIterator1 keys_first1, InputIterator1 keys_last1,
+            InputIterator2 keys_first2, InputIterator2 keys_last2, InputIterator3 values_first1,
+            InputIterator4 values_first2, OutputIterator1 keys_result, OutputIterator2 values_result,
+            const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::merge_by_key( control::getDefault( ), keys_first1, keys_last1, keys_first2, keys_last2,
+        values_first1, values_first2, keys_result, values_result, bolt::cl::less<T>( ), user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2, typename StrictWeakCompare>
+pair<OutputIterator1, OutputIterator2> merge_by_key( bolt::cl::control &ctl, InputIterator1 keys_first1,
+            InputIterator1 keys_last1, InputIterator2 keys_first2, InputIterator2 keys_last2,
+            InputIterator3 values_first1, InputIterator4 values_first2, OutputIterator1 keys_result,
+            OutputIterator2 values_result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::merge_by_key( ctl, keys_first1, keys_last1, keys_first2, keys_last2, values_first1,
+        values_first2, keys_result, values_result, comp, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2, typename StrictWeakCompare>
+pair<OutputIterator1, OutputIterator2> merge_by_key( InputIterator1 keys_first1, InputIterator1 keys_last1,
+            InputIterator2 keys_first2, InputIterator2 keys_last2, InputIterator3 values_first1,
+            InputIterator4 values_first2, OutputIterator1 keys_result, OutputIterator2 values_result,
+            StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::merge_by_key( control::getDefault( ), keys_first1, keys_last1, keys_first2, keys_last2,
+        values_first1, values_first2, keys_result, values_result, comp, user_code );
+}
+
+}//end of cl namespace
+};//end of bolt namespace
+
+#endif
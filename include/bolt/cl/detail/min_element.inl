@@ -21,6 +21,7 @@
 #pragma once
 
 #include "bolt/cl/functional.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 
 #ifdef ENABLE_TBB
 //TBB Includes
@@ -106,7 +107,7 @@ namespace bolt {
                 //oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
 
                 Min_KernelTemplateSpecializer ts_kts;
-                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
                     ctl,
                     typeNames,
                     &ts_kts,
@@ -131,14 +132,13 @@ namespace bolt {
                 ALIGNED( 256 ) BinaryPredicate aligned_reduce( binary_op );
                 //::cl::Buffer userFunctor(ctl.context(), CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY,sizeof(aligned_reduce),
                 //  &aligned_reduce );
-                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_reduce ),
-                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_reduce );
+                control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_reduce );
 
                 // ::cl::Buffer result(ctl.context(), CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY, sizeof( iType )*numWG);
                 control::buffPointer result = ctl.acquireBuffer( sizeof( int ) * numWG,
                     CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
 
-                cl_uint szElements = static_cast< cl_uint >( first.distance_to(last ) );
+                cl_uint szElements = deviceElements( first.distance_to(last ) );
                 typename DVInputIterator::Payload first_payload = first.gpuPayload();
 
                 V_OPENCL( kernels[0].setArg(0, first.getContainer().getBuffer() ), "Error setting kernel argument" );
@@ -515,6 +515,8 @@ namespace bolt {
                 const std::string& cl_code,
                 std::random_access_iterator_tag)
             {
+                static_assert( !is_zip_iterator< ForwardIterator >::value,
+                               "min_element does not take zip_iterator ranges" );
                 const char * str = "MIN_KERNEL";
                 return min_element_pick_iterator( ctl, first, last,  binary_op, cl_code,
                   typename  std::iterator_traits< ForwardIterator >::iterator_category( ), str );
@@ -530,6 +532,8 @@ namespace bolt {
                 const std::string& cl_code,
                 std::random_access_iterator_tag)
             {
+                static_assert( !is_zip_iterator< ForwardIterator >::value,
+                               "max_element does not take zip_iterator ranges" );
                 const char * str = "MAX_KERNEL";
                 return min_element_pick_iterator( ctl, first, last,  binary_op, cl_code,
                    typename std::iterator_traits< ForwardIterator >::iterator_category( ), str);
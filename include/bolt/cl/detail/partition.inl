@@ -0,0 +1,223 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PARTITION_INL )
+#define BOLT_CL_PARTITION_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/copy.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/partition.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+bolt::cl::pair<OutputIterator1, OutputIterator2> partition_copy( bolt::cl::control &ctl, const InputIterator& first,
+    const InputIterator& last, const OutputIterator1& out_true, const OutputIterator2& out_false,
+    const Predicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator >::value && !is_zip_iterator< OutputIterator1 >::value &&
+                   !is_zip_iterator< OutputIterator2 >::value,
+                   "partition_copy does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return bolt::cl::make_pair( out_true, out_false );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_PARTITION,BOLTLOG::BOLT_SERIAL_CPU,"::Partition_Copy::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        host_view< OutputIterator1 > selected( ctl, out_true, n, CL_MAP_WRITE );
+        host_view< OutputIterator2 > rejected( ctl, out_false, n, CL_MAP_WRITE );
+
+        size_t kept = static_cast< size_t >( std::partition_copy( input.begin( ), input.begin( ) + n,
+            selected.begin( ), rejected.begin( ), pred ).first - selected.begin( ) );
+        return bolt::cl::make_pair( out_true + kept, out_false + ( n - kept ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_PARTITION,BOLTLOG::BOLT_MULTICORE_CPU,"::Partition_Copy::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+            host_view< OutputIterator1 > selected( ctl, out_true, n, CL_MAP_WRITE );
+            host_view< OutputIterator2 > rejected( ctl, out_false, n, CL_MAP_WRITE );
+
+            size_t kept = static_cast< size_t >( bolt::btbb::partition_copy( input.begin( ), input.begin( ) + n,
+                selected.begin( ), rejected.begin( ), pred ).first - selected.begin( ) );
+            return bolt::cl::make_pair( out_true + kept, out_false + ( n - kept ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Partition_Copy is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_PARTITION,BOLTLOG::BOLT_OPENCL_GPU,"::Partition_Copy::OPENCL_GPU");
+        #endif
+
+        //  The compaction indexes in 32 bits, so a longer range is partitioned a slice at a time, each slice
+        //  appending to both outputs
+        size_t kept = 0;
+        for( size_t offset = 0; offset < n; offset += maxDeviceElements )
+        {
+            unsigned int length = static_cast< unsigned int >( std::min( maxDeviceElements, n - offset ) );
+            kept += compact( ctl, first + offset, length, first + offset, out_true + kept,
+                out_false + ( offset - kept ), false, first + offset, make_discard_iterator( ), pred,
+                compact_keep_selected, user_code );
+        }
+        return bolt::cl::make_pair( out_true + kept, out_false + ( n - kept ) );
+    }
+}
+
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator stable_partition( bolt::cl::control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+    const Predicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< ForwardIterator >::value,
+                   "stable_partition does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return first;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_PARTITION,BOLTLOG::BOLT_SERIAL_CPU,"::Stable_Partition::SERIAL_CPU");
+        #endif
+
+        host_view< ForwardIterator > range( ctl, first, n, CL_MAP_READ | CL_MAP_WRITE );
+        return first + ( std::stable_partition( range.begin( ), range.begin( ) + n, pred ) - range.begin( ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_PARTITION,BOLTLOG::BOLT_MULTICORE_CPU,"::Stable_Partition::MULTICORE_CPU");
+            #endif
+
+            host_view< ForwardIterator > range( ctl, first, n, CL_MAP_READ | CL_MAP_WRITE );
+            return first + ( bolt::btbb::stable_partition( range.begin( ), range.begin( ) + n, pred )
+                - range.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Stable_Partition is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_PARTITION,BOLTLOG::BOLT_OPENCL_GPU,"::Stable_Partition::OPENCL_GPU");
+        #endif
+
+        //  The rejected elements follow the selected ones in the same range, so unlike partition_copy this can
+        //  not be cut into slices
+        unsigned int length = deviceElements( n );
+        compact_source< ForwardIterator > source( ctl, first, length );
+        return first + compact( ctl, source.begin( ), length, source.begin( ), first, first, true, source.begin( ),
+            make_discard_iterator( ), pred, compact_keep_selected, user_code );
+    }
+}
+
+}//End OF detail namespace
+
+// user control
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator partition( bolt::cl::control &ctl, ForwardIterator first, ForwardIterator last, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::stable_partition( ctl, first, last, pred, user_code );
+}
+
+// default control
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator partition( ForwardIterator first, ForwardIterator last, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::stable_partition( control::getDefault( ), first, last, pred, user_code );
+}
+
+// user control
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator stable_partition( bolt::cl::control &ctl, ForwardIterator first, ForwardIterator last,
+            Predicate pred, const std::string& user_code )
+{
+    return detail::stable_partition( ctl, first, last, pred, user_code );
+}
+
+// default control
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator stable_partition( ForwardIterator first, ForwardIterator last, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::stable_partition( control::getDefault( ), first, last, pred, user_code );
+}
+
+// user control
+template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+pair<OutputIterator1, OutputIterator2> partition_copy( bolt::cl::control &ctl, InputIterator first,
+            InputIterator last, OutputIterator1 out_true, OutputIterator2 out_false, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::partition_copy( ctl, first, last, out_true, out_false, pred, user_code );
+}
+
+// default control
+template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+pair<OutputIterator1, OutputIterator2> partition_copy( InputIterator first, InputIterator last,
+            OutputIterator1 out_true, OutputIterator2 out_false, Predicate pred, const std::string& user_code )
+{
+    return detail::partition_copy( control::getDefault( ), first, last, out_true, out_false, pred, user_code );
+}
+
+}//end of cl namespace
+};//end of bolt namespace
+
+#endif
@@ -21,6 +21,10 @@
 #pragma once
 #include <bolt/cl/iterator/iterator_traits.h>
 #include <bolt/cl/iterator/addressof.h>
+#include <bolt/cl/iterator/zip_iterator.h>
+#include "bolt/cl/transform.h"
+#include "bolt/cl/dispatch.h"
+#include "bolt/cl/tuning.h"
 #ifdef ENABLE_TBB
 //TBB Includes
 #include "bolt/btbb/reduce.h"
@@ -79,7 +83,7 @@ namespace serial{
                                                                             input_sz, NULL, NULL, &map_err);
         auto mapped_ip_itr = create_mapped_iterator(typename std::iterator_traits<InputIterator>::iterator_category(), 
                                                         ctl, first, inputPtr);  
-	    T output = std::accumulate(mapped_ip_itr, mapped_ip_itr + (int) n, init, binary_op);
+	    T output = std::accumulate(mapped_ip_itr, mapped_ip_itr + n, init, binary_op);
 
 	    ::cl::Event unmap_event[1];
         ctl.getCommandQueue().enqueueUnmapMemObject(inputBuffer, inputPtr, NULL, &unmap_event[0] );
@@ -89,6 +93,20 @@ namespace serial{
 		return output;
     }
 
+    //  The columns of a zip_iterator are mapped once each, as for device_vector above
+    template<typename T, typename InputIterator, typename BinaryFunction>
+    T reduce(bolt::cl::control &ctl,
+                const InputIterator& first,
+                const InputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+				bolt::cl::zip_iterator_tag)
+    {
+        size_t n = static_cast< size_t >( last - first );
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        return std::accumulate( input.begin( ), input.begin( ) + n, init, binary_op );
+    }
+
 } // end of namespace serial
 
 #ifdef ENABLE_TBB
@@ -141,7 +159,7 @@ namespace btbb{
                                                                             input_sz, NULL, NULL, &map_err);
         auto mapped_ip_itr = create_mapped_iterator(typename std::iterator_traits<InputIterator>::iterator_category(), 
                                                         ctl, first, inputPtr);  
-	    T output = bolt::btbb::reduce(mapped_ip_itr, mapped_ip_itr + (int) n, init, binary_op);
+	    T output = bolt::btbb::reduce(mapped_ip_itr, mapped_ip_itr + n, init, binary_op);
 
 	    ::cl::Event unmap_event[1];
         ctl.getCommandQueue().enqueueUnmapMemObject(inputBuffer, inputPtr, NULL, &unmap_event[0] );
@@ -150,6 +168,18 @@ namespace btbb{
 			
 		return output;
     }
+    template<typename T, typename InputIterator, typename BinaryFunction>
+    T reduce(bolt::cl::control &ctl,
+                const InputIterator& first,
+                const InputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+				bolt::cl::zip_iterator_tag)
+    {
+        size_t n = static_cast< size_t >( last - first );
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        return bolt::btbb::reduce( input.begin( ), input.begin( ) + n, init, binary_op );
+    }
 } // end of namespace btbb
 #endif
 
@@ -159,24 +189,30 @@ namespace cl{
     ///////////////////////////////////////////////////////////////////////
     //Kernel Template Specializer
     ///////////////////////////////////////////////////////////////////////
+    template< typename InputIterator >
     class Reduce_KernelTemplateSpecializer : public KernelTemplateSpecializer
     {
+        KernelParameterStrings kps;
         public:
 
         Reduce_KernelTemplateSpecializer() : KernelTemplateSpecializer()
             {
-                addKernelName( "reduceTemplate" );
+                addKernelName( is_zip_iterator< InputIterator >::value ? "reduceZipTemplate" : "reduceTemplate" );
             }
 
         const ::std::string operator() ( const ::std::vector< ::std::string>& typeNames ) const
         {
+            const std::string inputParams = is_zip_iterator< InputIterator >::value
+                ? kps.getPointerParams< InputIterator >( typeNames[reduce_iIterType], "input" )
+                : "global " + typeNames[reduce_iValueType] + "* input_ptr,\n";
+
             const std::string templateSpecializationString =
                     "// Host generates this instantiation string with user-specified value type and functor\n"
                     "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
-                    "__attribute__((reqd_work_group_size(256,1,1)))\n"
-                    "kernel void reduceTemplate(\n"
-                    "global " + typeNames[reduce_iValueType] + "* input_ptr,\n"
-                        + typeNames[reduce_iIterType] + " output_iter,\n"
+                    "__attribute__((reqd_work_group_size(REDUCE_WGSIZE,1,1)))\n"
+                    "kernel void " + name(0) + "(\n"
+                    + inputParams
+                    + typeNames[reduce_iIterType] + " output_iter,\n"
                     "const int length,\n"
                     "global " + typeNames[reduce_BinaryFunction] + "* userFunctor,\n"
                     "global " + typeNames[reduce_resType] + "* result,\n"
@@ -185,24 +221,37 @@ namespace cl{
 
             return templateSpecializationString;
         }
+
+        //  A zip_iterator takes one buffer per column, so its kernel is generated here: it hands the column
+        //  pointers to the iterator and runs the reduceRange of reduce_kernels
+        const ::std::string getZipKernel( ) const
+        {
+            return
+                "template< typename iTypeIter, typename binary_function, typename T >\n"
+                "kernel void reduceZipTemplate(\n"
+                + kps.getPointerParams< InputIterator >( "typename iTypeIter", "input" ) +
+                "    iTypeIter input_iter,\n"
+                "    const int length,\n"
+                "    global binary_function* userFunctor,\n"
+                "    global T* result,\n"
+                "    local T* scratch)\n"
+                "{\n"
+                + kps.getInitCall< InputIterator >( "input_iter", "input" ) +
+                "    reduceRange( input_iter, length, userFunctor, result, scratch );\n"
+                "}\n";
+        }
     };
 
-    /*! \brief This template function overload is used strictly std random access vectors and OpenCL implementations. 
-        \detail 
+    /*! \brief Runs the reduce kernel over a device range with one launch shape, finishing the reduction on the host
     */
     template<typename T, typename InputIterator, typename BinaryFunction>
-    T reduce(bolt::cl::control &ctl,
+    T reduce_enqueue(bolt::cl::control &ctl,
                 InputIterator first,
-                InputIterator last,
+                int sz,
                 T init,
                 BinaryFunction binary_op,
-                const std::string& cl_code,
-                bolt::cl::device_vector_tag)
+                const WorkShape& shape)
     {
-
-        int sz = static_cast<int>(last - first);
-        if (sz == 0)
-            return init;
         typedef typename std::iterator_traits< InputIterator >::value_type iType;
 
         std::vector<std::string> typeNames( reduce_end);
@@ -217,59 +266,50 @@ namespace cl{
         PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction  >::get() )
         PUSH_BACK_UNIQUE( typeDefinitions, ClCode< T >::get() )
 
-        //bool cpuDevice = ctl.device().getInfo<CL_DEVICE_TYPE>() == CL_DEVICE_TYPE_CPU;
-        /*\TODO - Do CPU specific kernel work group size selection here*/
-        //const size_t kernel0_WgSize = (cpuDevice) ? 1 : WAVESIZE*KERNEL02WAVES;
-        std::string compileOptions;
-        //std::ostringstream oss;
-        //oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
+        const size_t wgSize  = shape.wgSize;
 
-        Reduce_KernelTemplateSpecializer ts_kts;
-        std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+        //  The shape is part of the compile options, so every shape gets its own program and kernel cache entry
+        std::ostringstream oss;
+        oss << " -DREDUCE_WGSIZE=" << wgSize << " -DREDUCE_UNROLL=" << shape.unroll;
+        std::string compileOptions = oss.str( );
+
+        Reduce_KernelTemplateSpecializer< InputIterator > ts_kts;
+        const std::string zipKernels = is_zip_iterator< InputIterator >::value
+            ? reduce_kernels + ts_kts.getZipKernel( ) : std::string( );
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
             ctl,
             typeNames,
             &ts_kts,
             typeDefinitions,
-            reduce_kernels,
+            is_zip_iterator< InputIterator >::value ? zipKernels : reduce_kernels,
             compileOptions);
 
         // Set up shape of launch grid and buffers:
         cl_uint computeUnits = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
-        int wgPerComputeUnit = 64; 
-        //ctl.getWGPerComputeUnit();  // This boosts up the performance
-        size_t numWG = computeUnits * wgPerComputeUnit;
+        size_t numWG = computeUnits * shape.wgPerComputeUnit;
 
         cl_int l_Error = CL_SUCCESS;
 
-        // Bumped up wgSize to achieve higher ALU usage and occupancy
-        const size_t wgSize  = 256;
-
-        V_OPENCL( l_Error, "Error querying kernel for CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE" );
-
         // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
         ALIGNED( 256 ) BinaryFunction aligned_reduce( binary_op );
-        //::cl::Buffer userFunctor(ctl.context(), CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, sizeof(aligned_reduce),
-        //  &aligned_reduce );
-        control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_reduce ),
-            CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_reduce );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_reduce );
 
-        // ::cl::Buffer result(ctl.context(), CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY, sizeof( iType )*numWG);
         control::buffPointer result = ctl.acquireBuffer( sizeof( T ) * numWG,
             CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
 
         typename InputIterator::Payload first_payload = first.gpuPayload( ) ;
 
-        const ::cl::Buffer &first_buffer = first.base().getContainer().getBuffer();
+        int arg_num = setRangeBuffers( kernels[0], 0, first );
 
-        V_OPENCL( kernels[0].setArg(0, first_buffer ), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg(1, first.gpuPayloadSize( ),&first_payload),"Error setting a kernel argument" );
-        V_OPENCL( kernels[0].setArg(2, sz),   "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg(3, *userFunctor), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg(4, *result),      "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, first.gpuPayloadSize( ),&first_payload),
+            "Error setting a kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, sz),   "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, *userFunctor), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num++, *result),      "Error setting kernel argument" );
 
         ::cl::LocalSpaceArg loc;
         loc.size_ = wgSize*sizeof(T);
-        V_OPENCL( kernels[0].setArg(5, loc), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg(arg_num, loc), "Error setting kernel argument" );
 
         l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
             kernels[0],
@@ -307,6 +347,33 @@ namespace cl{
         return acc;
     }
 
+    /*! \brief This template function overload is used strictly std random access vectors and OpenCL implementations. 
+        \detail The launch shape comes from the tuning database, or from a sweep under control::AutoTuneWorkShape;
+        untuned, it is 256 work items, 64 work groups per compute unit and the control's unroll factor.
+    */
+    template<typename T, typename InputIterator, typename BinaryFunction>
+    T reduce(bolt::cl::control &ctl,
+                InputIterator first,
+                InputIterator last,
+                T init,
+                BinaryFunction binary_op,
+                const std::string& cl_code,
+                bolt::cl::device_vector_tag)
+    {
+
+        int sz = deviceElements( last - first );
+        if (sz == 0)
+            return init;
+        typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+        //  64 work groups per compute unit rather than ctl.getWGPerComputeUnit( ); this boosts up the performance
+        WorkShape defaults = { 256, 64, ctl.getUnroll( ) };
+        WorkShape shape = detail::tunedWorkShape( ctl, "reduce", sizeof( iType ), defaults,
+            [ & ]( const WorkShape& candidate ) { reduce_enqueue( ctl, first, sz, init, binary_op, candidate ); } );
+
+        return reduce_enqueue( ctl, first, sz, init, binary_op, shape );
+    }
+
     /*! \brief This template function overload is used strictly std random access vectors and OpenCL implementations. 
         \detail 
     */
@@ -319,12 +386,28 @@ namespace cl{
                 const std::string& cl_code, 
                 std::random_access_iterator_tag)
     {
-        int sz = static_cast<int>(last - first);
-        if (sz == 0)
+        size_t length = static_cast< size_t >(last - first);
+        if (length == 0)
             return init;
         typedef typename std::iterator_traits<InputIterator>::value_type  iType;
        
         typedef typename std::iterator_traits<InputIterator>::pointer pointer;
+
+        //  device_vector and the reduce kernel index in 32 bits, so a longer range is reduced a slice at a time,
+        //  each slice starting from the result of the ones before it
+        if( length > maxDeviceElements )
+        {
+            T acc = init;
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                InputIterator sliceFirst = first + offset;
+                InputIterator sliceLast = sliceFirst + std::min( maxDeviceElements, length - offset );
+                acc = cl::reduce( ctl, sliceFirst, sliceLast, acc, binary_op, cl_code,
+                    std::random_access_iterator_tag( ) );
+            }
+            return acc;
+        }
+        int sz = static_cast< int >( length );
        
         pointer first_pointer = bolt::cl::addressof(first) ;
 
@@ -353,6 +436,34 @@ namespace cl{
         return reduce(ctl, first, last, init, binary_op, cl_code, typename bolt::cl::memory_system<InputIterator>::type() );
     }
 
+
+    /*! \brief This template function overload is used for zip_iterator and OpenCL implementations.
+        \detail The kernel takes each column as its own buffer and builds the tuples as it reads them; host columns
+        are wrapped in device buffers first.
+    */
+    template<typename T, typename InputIterator, typename BinaryFunction>
+    T reduce(bolt::cl::control &ctl,
+                InputIterator first,
+                InputIterator last,
+                T init,
+                BinaryFunction& binary_op,
+                const std::string& cl_code,
+                bolt::cl::zip_iterator_tag)
+    {
+        size_t length = static_cast< size_t >( last - first );
+
+        //  Sliced like the random access overload, each slice starting from the result of the ones before it
+        T acc = init;
+        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+        {
+            int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+            device_view< InputIterator > input( ctl, first + offset, sz, true );
+            acc = cl::reduce( ctl, input.begin( ), input.begin( ) + sz, acc, binary_op, cl_code,
+                typename bolt::cl::device_vector_tag( ) );
+        }
+        return acc;
+    }
+
 } // end of namespace cl
 
     /*! \brief This template function overload is used strictly for device vectors and std random access vectors. 
@@ -366,15 +477,15 @@ namespace cl{
                 BinaryFunction& binary_op,
                 const std::string& cl_code)
     {
-        int sz = static_cast<int>( std::distance(first, last ) );
+        size_t sz = static_cast< size_t >( std::distance(first, last ) );
         if (sz == 0)
             return init;
 
-        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-        if(runMode == bolt::cl::control::Automatic)
-        {
-           runMode = ctl.getDefaultPathToRun();
-        }
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< typename std::iterator_traits< InputIterator >::value_type >( "reduce" ), sz,
+            detail::hostBytes( first, sz ),
+            detail::deviceBytes( first, sz ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
         #if defined(BOLT_DEBUG_LOG)
         BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
         #endif
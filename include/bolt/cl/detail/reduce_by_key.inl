@@ -33,6 +33,8 @@
 #include "bolt/cl/device_vector.h"
 #include "bolt/cl/distance.h"
 #include "bolt/cl/iterator/transform_iterator.h"
+#include "bolt/cl/iterator/discard_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 
 #ifdef ENABLE_TBB
 //TBB Includes
@@ -54,6 +56,15 @@ namespace detail
 *   \{
 */
 
+//  A discarded keys output goes wherever the values output goes
+template< typename OutputIterator1, typename OutputIterator2 >
+struct keys_output_category
+{
+    typedef typename std::conditional< is_discard_iterator< OutputIterator1 >::value,
+        typename std::iterator_traits< OutputIterator2 >::iterator_category,
+        typename std::iterator_traits< OutputIterator1 >::iterator_category >::type type;
+};
+
 namespace serial{
 
 
@@ -64,12 +75,12 @@ template<
     typename OutputIterator2,
     typename BinaryPredicate,
     typename BinaryFunction>
-typename std::enable_if< (std::is_same< typename std::iterator_traits< OutputIterator1 >::iterator_category ,
+typename std::enable_if< (std::is_same< typename keys_output_category< OutputIterator1, OutputIterator2 >::type ,
                                        std::random_access_iterator_tag
                                      >::value &&
 						  std::is_same< typename std::iterator_traits< OutputIterator2 >::iterator_category ,
                                        std::random_access_iterator_tag
-                                     >::value), unsigned int
+                                     >::value), size_t
                            >::type
 reduce_by_key( ::bolt::cl::control &ctl, 
                InputIterator1 keys_first,
@@ -86,12 +97,12 @@ reduce_by_key( ::bolt::cl::control &ctl,
     typedef typename std::iterator_traits< OutputIterator1 >::value_type koType;
     typedef typename std::iterator_traits< OutputIterator2 >::value_type voType;
 
-    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    size_t numElements = static_cast< size_t >( std::distance( keys_first, keys_last ) );
 
     // do zeroeth element
     *values_output = *values_first;
     *keys_output = *keys_first;
-    unsigned int count = 1;
+    size_t count = 1;
     // rbk oneth element and beyond
 
     values_first++;
@@ -137,13 +148,13 @@ template<
     typename DVOutputIterator2,
     typename BinaryPredicate,
     typename BinaryFunction >
-typename std::enable_if< (std::is_same< typename std::iterator_traits< DVOutputIterator1 >::iterator_category ,
+typename std::enable_if< (std::is_same< typename keys_output_category< DVOutputIterator1, DVOutputIterator2 >::type ,
                                        bolt::cl::device_vector_tag
                                      >::value &&
-                         std::is_same< typename std::iterator_traits< DVOutputIterator1 >::iterator_category ,
+                         std::is_same< typename std::iterator_traits< DVOutputIterator2 >::iterator_category ,
                                        bolt::cl::device_vector_tag
                                      >::value),
-					     unsigned int
+					     size_t
                        >::type
 reduce_by_key(
     ::bolt::cl::control &ctl, 
@@ -161,18 +172,16 @@ reduce_by_key(
     typedef typename std::iterator_traits< DVOutputIterator1 >::value_type koType;
     typedef typename std::iterator_traits< DVOutputIterator2 >::value_type voType;
 
-    unsigned int sz = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    unsigned int sz = deviceElements( std::distance( keys_first, keys_last ) );
 
     /*Get The associated OpenCL buffer for each of the iterators*/
     ::cl::Buffer keyfirstBuffer  = keys_first.base().getContainer( ).getBuffer( );
 	::cl::Buffer valfirstBuffer  = values_first.base().getContainer( ).getBuffer( );
-    ::cl::Buffer keyresultBuffer = keys_output.getContainer( ).getBuffer( );
 	::cl::Buffer valresultBuffer = values_output.getContainer( ).getBuffer( );
 
     /*Get The size of each OpenCL buffer*/
     size_t keyfirst_sz  = keyfirstBuffer.getInfo<CL_MEM_SIZE>();
 	size_t valfirst_sz = valfirstBuffer.getInfo<CL_MEM_SIZE>();
-    size_t keyresult_sz = keyresultBuffer.getInfo<CL_MEM_SIZE>();
 	size_t valresult_sz = valresultBuffer.getInfo<CL_MEM_SIZE>();
 
     cl_int map_err;
@@ -180,8 +189,6 @@ reduce_by_key(
                                                                         keyfirst_sz, NULL, NULL, &map_err);
 	vType *valfirstPtr  = (vType*)ctl.getCommandQueue().enqueueMapBuffer(valfirstBuffer, true, CL_MAP_READ, 0, 
                                                                         valfirst_sz, NULL, NULL, &map_err);
-    koType *keyresultPtr = (koType*)ctl.getCommandQueue().enqueueMapBuffer(keyresultBuffer, true, CL_MAP_WRITE, 0, 
-                                                                        keyresult_sz, NULL, NULL, &map_err);
 	voType *valresultPtr = (voType*)ctl.getCommandQueue().enqueueMapBuffer(valresultBuffer, true, CL_MAP_WRITE, 0, 
                                                                         valresult_sz, NULL, NULL, &map_err);
 
@@ -191,9 +198,9 @@ reduce_by_key(
 	auto mapped_valfirst_itr = create_mapped_iterator(typename std::iterator_traits<DVInputIterator2>::
 	                                          iterator_category(), 
                                                     ctl, values_first,valfirstPtr);
-    auto mapped_keyresult_itr = create_mapped_iterator(typename std::iterator_traits<DVOutputIterator1>::
-	                                          iterator_category(), 
-                                                    ctl, keys_output, keyresultPtr);
+    //  A discard_iterator is used as it is; nothing is mapped for it
+    host_view< DVOutputIterator1 > keysOutput( ctl, keys_output, sz, CL_MAP_WRITE );
+    auto mapped_keyresult_itr = keysOutput.begin( );
 	auto mapped_valresult_itr = create_mapped_iterator(typename std::iterator_traits<DVOutputIterator2>::
 	                                          iterator_category(), 
                                                     ctl, values_output, valresultPtr);
@@ -235,12 +242,11 @@ reduce_by_key(
 		vi++;
     }
 
-    ::cl::Event unmap_event[4];
+    ::cl::Event unmap_event[3];
     ctl.getCommandQueue().enqueueUnmapMemObject(keyfirstBuffer, keyfirstPtr, NULL, &unmap_event[0] );
 	ctl.getCommandQueue().enqueueUnmapMemObject(valfirstBuffer, valfirstPtr, NULL, &unmap_event[1] );
-    ctl.getCommandQueue().enqueueUnmapMemObject(keyresultBuffer, keyresultPtr, NULL, &unmap_event[2] );
-	ctl.getCommandQueue().enqueueUnmapMemObject(valresultBuffer, valresultPtr, NULL, &unmap_event[3] );
-    unmap_event[0].wait(); unmap_event[1].wait(); unmap_event[2].wait(); unmap_event[3].wait(); 
+	ctl.getCommandQueue().enqueueUnmapMemObject(valresultBuffer, valresultPtr, NULL, &unmap_event[2] );
+    unmap_event[0].wait(); unmap_event[1].wait(); unmap_event[2].wait(); 
 
     return count;
 
@@ -260,12 +266,12 @@ template<
     typename OutputIterator2,
     typename BinaryPredicate,
     typename BinaryFunction>
-typename std::enable_if< (std::is_same< typename std::iterator_traits< OutputIterator1 >::iterator_category ,
+typename std::enable_if< (std::is_same< typename keys_output_category< OutputIterator1, OutputIterator2 >::type ,
                                        std::random_access_iterator_tag
                                      >::value &&
 						  std::is_same< typename std::iterator_traits< OutputIterator2 >::iterator_category ,
                                        std::random_access_iterator_tag
-                                     >::value), unsigned int
+                                     >::value), size_t
                            >::type
 reduce_by_key( ::bolt::cl::control &ctl, 
                InputIterator1 keys_first,
@@ -288,13 +294,13 @@ template<
     typename DVOutputIterator2,
     typename BinaryPredicate,
     typename BinaryFunction >
-typename std::enable_if< (std::is_same< typename std::iterator_traits< DVOutputIterator1 >::iterator_category ,
+typename std::enable_if< (std::is_same< typename keys_output_category< DVOutputIterator1, DVOutputIterator2 >::type ,
                                        bolt::cl::device_vector_tag
                                      >::value &&
-                         std::is_same< typename std::iterator_traits< DVOutputIterator1 >::iterator_category ,
+                         std::is_same< typename std::iterator_traits< DVOutputIterator2 >::iterator_category ,
                                        bolt::cl::device_vector_tag
                                      >::value),
-					     unsigned int
+					     size_t
 					  >::type
 reduce_by_key(
     ::bolt::cl::control &ctl, 
@@ -311,18 +317,16 @@ reduce_by_key(
     typedef typename std::iterator_traits< DVOutputIterator1 >::value_type koType;
     typedef typename std::iterator_traits< DVOutputIterator2 >::value_type voType;
 
-    unsigned int sz = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    unsigned int sz = deviceElements( std::distance( keys_first, keys_last ) );
 
     /*Get The associated OpenCL buffer for each of the iterators*/
     ::cl::Buffer keyfirstBuffer  = keys_first.base().getContainer( ).getBuffer( );
 	::cl::Buffer valfirstBuffer  = values_first.base().getContainer( ).getBuffer( );
-    ::cl::Buffer keyresultBuffer = keys_output.getContainer( ).getBuffer( );
 	::cl::Buffer valresultBuffer = values_output.getContainer( ).getBuffer( );
 
     /*Get The size of each OpenCL buffer*/
     size_t keyfirst_sz  = keyfirstBuffer.getInfo<CL_MEM_SIZE>();
 	size_t valfirst_sz = valfirstBuffer.getInfo<CL_MEM_SIZE>();
-    size_t keyresult_sz = keyresultBuffer.getInfo<CL_MEM_SIZE>();
 	size_t valresult_sz = valresultBuffer.getInfo<CL_MEM_SIZE>();
 
     cl_int map_err;
@@ -330,8 +334,6 @@ reduce_by_key(
                                                                         keyfirst_sz, NULL, NULL, &map_err);
 	vType *valfirstPtr  = (vType*)ctl.getCommandQueue().enqueueMapBuffer(valfirstBuffer, true, CL_MAP_READ, 0, 
                                                                         valfirst_sz, NULL, NULL, &map_err);
-    koType *keyresultPtr = (koType*)ctl.getCommandQueue().enqueueMapBuffer(keyresultBuffer, true, CL_MAP_WRITE, 0, 
-                                                                        keyresult_sz, NULL, NULL, &map_err);
 	voType *valresultPtr = (voType*)ctl.getCommandQueue().enqueueMapBuffer(valresultBuffer, true, CL_MAP_WRITE, 0, 
                                                                         valresult_sz, NULL, NULL, &map_err);
 
@@ -341,22 +343,21 @@ reduce_by_key(
 	auto mapped_valfirst_itr = create_mapped_iterator(typename std::iterator_traits<DVInputIterator2>::
 	                                          iterator_category(), 
                                                     ctl, values_first,valfirstPtr);
-    auto mapped_keyresult_itr = create_mapped_iterator(typename std::iterator_traits<DVOutputIterator1>::
-	                                          iterator_category(), 
-                                                    ctl, keys_output, keyresultPtr);
+    //  A discard_iterator is used as it is; nothing is mapped for it
+    host_view< DVOutputIterator1 > keysOutput( ctl, keys_output, sz, CL_MAP_WRITE );
+    auto mapped_keyresult_itr = keysOutput.begin( );
 	auto mapped_valresult_itr = create_mapped_iterator(typename std::iterator_traits<DVOutputIterator2>::
 	                                          iterator_category(), 
                                                     ctl, values_output, valresultPtr);
 
-	unsigned int count = bolt::btbb::reduce_by_key( mapped_keyfirst_itr,  mapped_keyfirst_itr + sz, mapped_valfirst_itr, 
+	size_t count = bolt::btbb::reduce_by_key( mapped_keyfirst_itr,  mapped_keyfirst_itr + sz, mapped_valfirst_itr, 
 		mapped_keyresult_itr, mapped_valresult_itr, binary_pred, binary_op);
 
-    ::cl::Event unmap_event[4];
+    ::cl::Event unmap_event[3];
     ctl.getCommandQueue().enqueueUnmapMemObject(keyfirstBuffer, keyfirstPtr, NULL, &unmap_event[0] );
 	ctl.getCommandQueue().enqueueUnmapMemObject(valfirstBuffer, valfirstPtr, NULL, &unmap_event[1] );
-    ctl.getCommandQueue().enqueueUnmapMemObject(keyresultBuffer, keyresultPtr, NULL, &unmap_event[2] );
-	ctl.getCommandQueue().enqueueUnmapMemObject(valresultBuffer, valresultPtr, NULL, &unmap_event[3] );
-    unmap_event[0].wait(); unmap_event[1].wait(); unmap_event[2].wait(); unmap_event[3].wait(); 
+	ctl.getCommandQueue().enqueueUnmapMemObject(valresultBuffer, valresultPtr, NULL, &unmap_event[2] );
+    unmap_event[0].wait(); unmap_event[1].wait(); unmap_event[2].wait(); 
 
     return count;
 
@@ -476,7 +477,7 @@ template<
     typename DVOutputIterator2,
     typename BinaryPredicate,
     typename BinaryFunction >
-typename std::enable_if< (std::is_same< typename std::iterator_traits< DVOutputIterator1 >::iterator_category ,
+typename std::enable_if< (std::is_same< typename keys_output_category< DVOutputIterator1, DVOutputIterator2 >::type ,
                                        bolt::cl::device_vector_tag
                                      >::value &&
 						  std::is_same< typename std::iterator_traits< DVOutputIterator2 >::iterator_category ,
@@ -551,7 +552,7 @@ reduce_by_key(
      * Request Compiled Kernels
      *********************************************************************************/
     ReduceByKey_KernelTemplateSpecializer ts_kts;
-    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &ts_kts,
@@ -569,7 +570,7 @@ reduce_by_key(
     int resultCnt = computeUnits * wgPerComputeUnit;
 
     //  Ceiling function to bump the size of input to the next whole wavefront size
-    cl_uint numElements = static_cast< cl_uint >( std::distance( keys_first, keys_last ) );
+    cl_uint numElements = deviceElements( std::distance( keys_first, keys_last ) );
     typename device_vector< kType >::size_type sizeInputBuff = numElements;
     int modWgSize = (sizeInputBuff & (kernel0_WgSize-1));
     if( modWgSize )
@@ -591,11 +592,9 @@ reduce_by_key(
     // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
 
     ALIGNED( 256 ) BinaryPredicate aligned_binary_pred( binary_pred );
-    control::buffPointer binaryPredicateBuffer = ctl.acquireBuffer( sizeof( aligned_binary_pred ),
-        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_pred );
+    control::buffPointer binaryPredicateBuffer = ctl.acquireFunctorBuffer( aligned_binary_pred );
      ALIGNED( 256 ) BinaryFunction aligned_binary_op( binary_op );
-    control::buffPointer binaryFunctionBuffer = ctl.acquireBuffer( sizeof( aligned_binary_op ),
-        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_op );
+    control::buffPointer binaryFunctionBuffer = ctl.acquireFunctorBuffer( aligned_binary_op );
 
 
     device_vector< int > tempArray( numElements, 0, CL_MEM_READ_WRITE, false, ctl);
@@ -812,7 +811,7 @@ template<
     typename OutputIterator2,
     typename BinaryPredicate,
     typename BinaryFunction >
- typename std::enable_if< (std::is_same< typename std::iterator_traits< OutputIterator1 >::iterator_category ,
+ typename std::enable_if< (std::is_same< typename keys_output_category< OutputIterator1, OutputIterator2 >::type ,
                                        std::random_access_iterator_tag
                                      >::value &&
 						  std::is_same< typename std::iterator_traits< OutputIterator2 >::iterator_category ,
@@ -831,7 +830,7 @@ reduce_by_key(
     const std::string& user_code)
 {
 
-	int sz = static_cast<int>(keys_last - keys_first);
+	int sz = deviceElements( keys_last - keys_first );
     if (sz == 1)
         return 1;
 
@@ -842,17 +841,14 @@ reduce_by_key(
     
     typedef typename std::iterator_traits<InputIterator1>::pointer key_pointer;
 	typedef typename std::iterator_traits<InputIterator2>::pointer val_pointer;
-	typedef typename std::iterator_traits<OutputIterator1>::pointer key_out_pointer;
 	typedef typename std::iterator_traits<OutputIterator2>::pointer val_out_pointer;
     
     key_pointer keyfirst_pointer = bolt::cl::addressof(keys_first) ;
 	val_pointer valfirst_pointer = bolt::cl::addressof(values_first) ;
-	key_out_pointer keyout_pointer = bolt::cl::addressof(keys_output) ;
 	val_out_pointer valout_pointer = bolt::cl::addressof(values_output) ;
 
     device_vector< kType > dvKeysInput( keyfirst_pointer, sz, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, true, ctl );
 	device_vector< vType > dvValInput( valfirst_pointer, sz, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, true, ctl );
-	device_vector< koType > dvKeysOutput( keyout_pointer, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, true, ctl );
 	device_vector< voType > dvvalOutput( valout_pointer, sz, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, true, ctl );
     
     auto device_iterator_keyfirst  = bolt::cl::create_device_itr(
@@ -864,16 +860,21 @@ reduce_by_key(
     auto device_iterator_valfirst  = bolt::cl::create_device_itr(
                                         typename bolt::cl::iterator_traits< InputIterator2 >::iterator_category( ), 
                                         values_first, dvValInput.begin());
-	auto device_iterator_keyout  = bolt::cl::create_device_itr(
-                                        typename bolt::cl::iterator_traits< OutputIterator1 >::iterator_category( ), 
-                                        keys_output, dvKeysOutput.begin());
+	//  A discard_iterator goes to the kernels as it is, with no buffer behind it
+	device_view< OutputIterator1 > dvKeysOutput( ctl, keys_output, sz, true );
+	auto device_iterator_keyout  = dvKeysOutput.begin( );
 	auto device_iterator_valout  = bolt::cl::create_device_itr(
                                         typename bolt::cl::iterator_traits< OutputIterator2 >::iterator_category( ), 
                                         values_output, dvvalOutput.begin());
 
-    return cl::reduce_by_key(ctl, device_iterator_keyfirst,device_iterator_keylast, device_iterator_valfirst,
+    unsigned int numSegments = cl::reduce_by_key(ctl, device_iterator_keyfirst,device_iterator_keylast, device_iterator_valfirst,
 		device_iterator_keyout, device_iterator_valout,  binary_pred, binary_op, user_code);
 
+    //  Read the results back into the host ranges
+    dvKeysOutput.sync( );
+    dvvalOutput.data( );
+    return numSegments;
+
 }
 
 
@@ -904,6 +905,9 @@ reduce_by_key(
     BinaryFunction binary_op,
     const std::string& user_code)
 {
+    static_assert( !is_zip_iterator< InputIterator1 >::value && !is_zip_iterator< InputIterator2 >::value &&
+                   !is_zip_iterator< OutputIterator1 >::value && !is_zip_iterator< OutputIterator2 >::value,
+                   "reduce_by_key does not take zip_iterator ranges" );
 
     typename std::iterator_traits<InputIterator1>::difference_type numElements = bolt::cl::distance(keys_first, keys_last);
 
@@ -922,7 +926,7 @@ reduce_by_key(
             #if defined(BOLT_DEBUG_LOG)
             dblog->CodePathTaken(BOLTLOG::BOLT_REDUCEBYKEY,BOLTLOG::BOLT_SERIAL_CPU,"::Reduce_By_Key::SERIAL_CPU");
             #endif
-            int sizeOfOut = serial::reduce_by_key(ctl, keys_first, keys_last, values_first,keys_output, values_output, binary_pred, binary_op);
+            size_t sizeOfOut = serial::reduce_by_key(ctl, keys_first, keys_last, values_first,keys_output, values_output, binary_pred, binary_op);
 			return bolt::cl::make_pair(keys_output+sizeOfOut, values_output+sizeOfOut);
 		
     } 
@@ -932,7 +936,7 @@ reduce_by_key(
 		    #if defined(BOLT_DEBUG_LOG)
             dblog->CodePathTaken(BOLTLOG::BOLT_REDUCEBYKEY,BOLTLOG::BOLT_MULTICORE_CPU,"::Reduce_By_Key::MULTICORE_CPU");
             #endif
-            unsigned int sizeOfOut = btbb::reduce_by_key(ctl, keys_first, keys_last, values_first,keys_output, values_output, binary_pred, binary_op);
+            size_t sizeOfOut = btbb::reduce_by_key(ctl, keys_first, keys_last, values_first,keys_output, values_output, binary_pred, binary_op);
 			return bolt::cl::make_pair(keys_output+sizeOfOut, values_output+sizeOfOut);
         #else
             throw std::runtime_error("MultiCoreCPU Version of ReduceByKey not Enabled! \n");
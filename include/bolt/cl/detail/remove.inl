@@ -0,0 +1,201 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_REMOVE_INL )
+#define BOLT_CL_REMOVE_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/copy.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/remove.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator remove_copy_if( bolt::cl::control &ctl, const InputIterator& first, const InputIterator& last,
+    const OutputIterator& result, const Predicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator >::value && !is_zip_iterator< OutputIterator >::value,
+                   "remove_copy_if does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return result;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_REMOVE,BOLTLOG::BOLT_SERIAL_CPU,"::Remove_Copy_If::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        host_view< OutputIterator > output( ctl, result, n, CL_MAP_WRITE );
+        return result + ( std::remove_copy_if( input.begin( ), input.begin( ) + n, output.begin( ), pred )
+            - output.begin( ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_REMOVE,BOLTLOG::BOLT_MULTICORE_CPU,"::Remove_Copy_If::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+            host_view< OutputIterator > output( ctl, result, n, CL_MAP_WRITE );
+            return result + ( bolt::btbb::remove_copy_if( input.begin( ), input.begin( ) + n, output.begin( ),
+                pred ) - output.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Remove_Copy_If is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_REMOVE,BOLTLOG::BOLT_OPENCL_GPU,"::Remove_Copy_If::OPENCL_GPU");
+        #endif
+
+        //  The compaction indexes in 32 bits, so a longer range is compacted a slice at a time, each slice
+        //  appending what it keeps to what the slices before it kept
+        size_t kept = 0;
+        for( size_t offset = 0; offset < n; offset += maxDeviceElements )
+        {
+            unsigned int length = static_cast< unsigned int >( std::min( maxDeviceElements, n - offset ) );
+            kept += compact( ctl, first + offset, length, first + offset, result + kept, make_discard_iterator( ),
+                false, first + offset, make_discard_iterator( ), pred, compact_keep_rejected, user_code );
+        }
+        return result + kept;
+    }
+}
+
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator remove_if( bolt::cl::control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+    const Predicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< ForwardIterator >::value,
+                   "remove_if does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return first;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_REMOVE,BOLTLOG::BOLT_SERIAL_CPU,"::Remove_If::SERIAL_CPU");
+        #endif
+
+        host_view< ForwardIterator > range( ctl, first, n, CL_MAP_READ | CL_MAP_WRITE );
+        return first + ( std::remove_if( range.begin( ), range.begin( ) + n, pred ) - range.begin( ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_REMOVE,BOLTLOG::BOLT_MULTICORE_CPU,"::Remove_If::MULTICORE_CPU");
+            #endif
+
+            host_view< ForwardIterator > range( ctl, first, n, CL_MAP_READ | CL_MAP_WRITE );
+            return first + ( bolt::btbb::remove_if( range.begin( ), range.begin( ) + n, pred ) - range.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Remove_If is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_REMOVE,BOLTLOG::BOLT_OPENCL_GPU,"::Remove_If::OPENCL_GPU");
+        #endif
+
+        //  Sliced as remove_copy_if is; a slice is read in full before what it keeps is written, and what the
+        //  slices before it kept ends no later than where it starts, so no write reaches an element not yet read
+        size_t kept = 0;
+        for( size_t offset = 0; offset < n; offset += maxDeviceElements )
+        {
+            unsigned int length = static_cast< unsigned int >( std::min( maxDeviceElements, n - offset ) );
+            compact_source< ForwardIterator > source( ctl, first + offset, length );
+            kept += compact( ctl, source.begin( ), length, source.begin( ), first + kept, make_discard_iterator( ),
+                false, source.begin( ), make_discard_iterator( ), pred, compact_keep_rejected, user_code );
+        }
+        return first + kept;
+    }
+}
+
+}//End OF detail namespace
+
+// user control
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator remove_if( bolt::cl::control &ctl, ForwardIterator first, ForwardIterator last, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::remove_if( ctl, first, last, pred, user_code );
+}
+
+// default control
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator remove_if( ForwardIterator first, ForwardIterator last, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::remove_if( control::getDefault( ), first, last, pred, user_code );
+}
+
+// user control
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator remove_copy_if( bolt::cl::control &ctl, InputIterator first, InputIterator last,
+            OutputIterator result, Predicate pred, const std::string& user_code )
+{
+    return detail::remove_copy_if( ctl, first, last, result, pred, user_code );
+}
+
+// default control
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator remove_copy_if( InputIterator first, InputIterator last, OutputIterator result, Predicate pred,
+            const std::string& user_code )
+{
+    return detail::remove_copy_if( control::getDefault( ), first, last, result, pred, user_code );
+}
+
+}//end of cl namespace
+};//end of bolt namespace
+
+#endif
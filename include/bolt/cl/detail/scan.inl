@@ -50,6 +50,10 @@
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
+#include "bolt/cl/iterator/constant_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/dispatch.h"
 
 #ifdef ENABLE_TBB
 //TBB Includes
@@ -134,7 +138,7 @@ namespace detail
 				   mapped_res_itr[0] = static_cast<oType>( init );
 				   sum = binary_op( mapped_res_itr[0], temp);
 				}
-				 for ( unsigned int index= 1; index<sz; index++)
+				 for ( size_t index= 1; index<sz; index++)
 				{
 					oType currentValue =  static_cast<oType>( *(mapped_fst_itr+index) ); 
 					if (inclusive)
@@ -197,7 +201,7 @@ namespace detail
 				  sum = binary_op( *result, temp);  
 				}
 
-				for ( unsigned int index= 1; index<sz; index++)
+				for ( size_t index= 1; index<sz; index++)
 				{
 				  oType currentValue =  static_cast<oType>( *(first + index) ); // convertible
 				  if (inclusive)
@@ -263,9 +267,9 @@ namespace detail
 
 				
 				if(inclusive)
-					bolt::btbb::inclusive_scan( mapped_fst_itr, mapped_fst_itr  + (int)sz,  mapped_res_itr, binary_op);
+					bolt::btbb::inclusive_scan( mapped_fst_itr, mapped_fst_itr  + sz,  mapped_res_itr, binary_op);
 				else
-					bolt::btbb::exclusive_scan( mapped_fst_itr,  mapped_fst_itr  + (int)sz , mapped_res_itr, init, binary_op);   
+					bolt::btbb::exclusive_scan( mapped_fst_itr,  mapped_fst_itr  + sz , mapped_res_itr, init, binary_op);   
 
 				::cl::Event unmap_event[2];
 				ctl.getCommandQueue().enqueueUnmapMemObject(firstBuffer, firstPtr, NULL, &unmap_event[0] );
@@ -294,7 +298,7 @@ namespace detail
 			const bool& inclusive,
 			const BinaryFunction& binary_op)
 			{
-				int sz = static_cast<int>( std::distance (first, last));
+				size_t sz = static_cast<size_t>( std::distance (first, last));
 				if (sz == 0)
 					return;
 				if(inclusive)
@@ -393,6 +397,114 @@ namespace detail
 					}
 		};
 
+		class ScanSinglePass_KernelTemplateSpecializer : public KernelTemplateSpecializer
+		{
+		public:
+			ScanSinglePass_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+			{
+				addKernelName("singlePassScan");
+			}
+
+			const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+			{
+				const std::string templateSpecializationString =
+					"// Template specialization\n"
+					"template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+					"__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+					"kernel void " + name(0) + "(\n"
+					"global " + typeNames[scan_oValueType] + "* output_ptr,\n"
+					""        + typeNames[scan_oIterType] + " output_iter,\n"
+					"global " + typeNames[scan_iValueType] + "* input_ptr,\n"
+					""        + typeNames[scan_iIterType] + " input_iter,\n"
+					""        + typeNames[scan_initType] + " init,\n"
+					"const uint vecSize,\n"
+					"local "  + typeNames[scan_oValueType] + "* ldsTile,\n"
+					"local "  + typeNames[scan_oValueType] + "* ldsSums,\n"
+					"global " + typeNames[scan_BinaryFunction] + "* binaryOp,\n"
+					"global uint* tileStatus,\n"
+					"global uint* tileAggregate,\n"
+					"global uint* tilePrefix\n"
+					");\n\n";
+
+				return templateSpecializationString;
+			}
+		};
+
+		//  One kernel that reads and writes every element once; scan( ) takes this path when
+		//  singlePassScanItems( ) says the device can run it
+		template< typename InputIterator,
+				typename OutputIterator,
+				typename T,
+				typename BinaryFunction >
+			void singlePassScan(
+			control &ctrl,
+			const InputIterator& first,
+			const InputIterator& last,
+			const OutputIterator& result,
+			const T& init_T,
+			const bool& inclusive,
+			const BinaryFunction& binary_op,
+			const std::vector< std::string >& typeNames,
+			const std::vector< std::string >& typeDefinitions,
+			const cl_uint scanItems )
+			{
+				typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+				const cl_uint wgSize = WAVESIZE*KERNEL02WAVES;
+
+				std::ostringstream oss;
+				oss << " -DKERNEL0WORKGROUPSIZE=" << wgSize;
+				oss << " -DSCAN_ITEMS=" << scanItems;
+				oss << " -DEXCLUSIVE=" << ( inclusive ? 0 : 1 );
+				oss << " -DUSE_AMD_HSA=" << USE_AMD_HSA;
+
+				ScanSinglePass_KernelTemplateSpecializer sp_kts;
+				bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+					ctrl,
+					typeNames,
+					&sp_kts,
+					typeDefinitions,
+					scan_kernels,
+					oss.str( ) );
+
+				cl_uint numElements = deviceElements( std::distance( first, last ) );
+				cl_uint tileSize = wgSize * scanItems;
+				cl_uint numTiles = numElements / tileSize + ( numElements % tileSize ? 1 : 0 );
+
+				ALIGNED( 256 ) BinaryFunction aligned_binary( binary_op );
+				control::buffPointer userFunctor = ctrl.acquireFunctorBuffer( aligned_binary );
+				control::buffPointer tileStatus = acquireScanTileStatus( ctrl, numTiles );
+				control::buffPointer tileAggregate = ctrl.acquireBuffer( numTiles * sizeof( oType ) );
+				control::buffPointer tilePrefix = ctrl.acquireBuffer( numTiles * sizeof( oType ) );
+
+				typename OutputIterator::Payload result_payload = result.gpuPayload( );
+				typename InputIterator::Payload first_payload = first.gpuPayload( );
+
+				V_OPENCL( kernels[ 0 ].setArg( 0, result.getContainer().getBuffer() ), "Error setting argument for singlePassScan" ); // Output buffer
+				V_OPENCL( kernels[ 0 ].setArg( 1, result.gpuPayloadSize( ), &result_payload ), "Error setting a kernel argument" );
+				V_OPENCL( kernels[ 0 ].setArg( 2, first.base().getContainer().getBuffer() ), "Error setting argument for singlePassScan" ); // Input buffer
+				V_OPENCL( kernels[ 0 ].setArg( 3, first.gpuPayloadSize( ), &first_payload ), "Error setting a kernel argument" );
+				V_OPENCL( kernels[ 0 ].setArg( 4, init_T ),                 "Error setting argument for singlePassScan" ); // Initial value used for exclusive scan
+				V_OPENCL( kernels[ 0 ].setArg( 5, numElements ),            "Error setting argument for singlePassScan" ); // Number of elements
+				V_OPENCL( kernels[ 0 ].setArg( 6, tileSize * sizeof( oType ), NULL ), "Error setting argument for singlePassScan" ); // Tile
+				V_OPENCL( kernels[ 0 ].setArg( 7, ( wgSize + 1 ) * sizeof( oType ), NULL ), "Error setting argument for singlePassScan" ); // Work item sums and carry
+				V_OPENCL( kernels[ 0 ].setArg( 8, *userFunctor ),           "Error setting argument for singlePassScan" ); // User provided functor class
+				V_OPENCL( kernels[ 0 ].setArg( 9, *tileStatus ),            "Error setting argument for singlePassScan" ); // Tile counter and status
+				V_OPENCL( kernels[ 0 ].setArg( 10, *tileAggregate ),        "Error setting argument for singlePassScan" ); // Tile sums
+				V_OPENCL( kernels[ 0 ].setArg( 11, *tilePrefix ),           "Error setting argument for singlePassScan" ); // Inclusive tile prefixes
+
+				::cl::Event kernelEvent;
+				cl_int l_Error = ctrl.getCommandQueue( ).enqueueNDRangeKernel(
+					kernels[ 0 ],
+					::cl::NullRange,
+					::cl::NDRange( numTiles * wgSize ),
+					::cl::NDRange( wgSize ),
+					NULL,
+					&kernelEvent );
+				V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for singlePassScan kernel" );
+
+				bolt::cl::wait( ctrl, kernelEvent );
+			}
+
 		//  All calls to inclusive_scan end up here, unless an exception was thrown
 //  This is the function that sets up the kernels to compile (once only) and execute
 	  template< typename InputIterator, 
@@ -446,6 +558,19 @@ namespace detail
 				PUSH_BACK_UNIQUE( typeDefinitions, ClCode< T >::get() )
 				PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction  >::get() )
 
+			#if !USE_AMD_HSA
+				/**********************************************************************************
+				 * Single pass scan, where the device supports it
+				 *********************************************************************************/
+				cl_uint scanItems = singlePassScanItems( ctrl, sizeof( oType ), sizeof( oType ), WAVESIZE*KERNEL02WAVES );
+				if( scanItems )
+				{
+					singlePassScan( ctrl, first, last, result, init_T, inclusive, binary_op, typeNames, typeDefinitions,
+						scanItems );
+					return;
+				}
+			#endif
+
 				/**********************************************************************************
 				 * Compile Options
 				 *********************************************************************************/
@@ -471,7 +596,7 @@ namespace detail
 				 * Request Compiled Kernels
 				 *********************************************************************************/
 				Scan_KernelTemplateSpecializer ts_kts;
-				std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+				bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
 					ctrl,
 					typeNames,
 					&ts_kts,
@@ -490,12 +615,11 @@ namespace detail
 				 * Round Up Number of Elements
 				 *********************************************************************************/
 				//  Ceiling function to bump the size of input to the next whole wavefront size
-				cl_uint numElements = static_cast< cl_uint >( std::distance( first, last ) );
+				cl_uint numElements = deviceElements( std::distance( first, last ) );
 
 				// Create buffer wrappers so we can access the host functors, for read or writing in the kernel
 				ALIGNED( 256 ) BinaryFunction aligned_binary( binary_op );
-				control::buffPointer userFunctor = ctrl.acquireBuffer( sizeof( aligned_binary ),
-					CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+				control::buffPointer userFunctor = ctrl.acquireFunctorBuffer( aligned_binary );
 				cl_uint ldsSize;
 
 
@@ -949,24 +1073,52 @@ namespace detail
 				typedef typename std::iterator_traits< InputIterator >::value_type iType;
 				typedef typename std::iterator_traits< OutputIterator >::value_type oType;	    
 		
-				int numElements = static_cast< int >( std::distance( first, last ) );
+				size_t numElements = static_cast< size_t >( std::distance( first, last ) );
 				if( numElements == 0 )
 					return;
 		
 				typedef typename bolt::cl::iterator_traits<InputIterator>::pointer pointer;
-			
-				pointer first_pointer = bolt::cl::addressof(first) ;
+
+				//  device_vector and the scan kernels index in 32 bits, so a longer range is scanned a slice at a
+				//  time.  Every slice after the first carries in the total of the slices before it: an exclusive scan
+				//  starts from it, and an inclusive scan combines it into each element on the device.
+				oType carry = oType( );
+				for( size_t offset = 0; offset < numElements; offset += maxDeviceElements )
+				{
+					int sliceElements = static_cast< int >( std::min( maxDeviceElements, numElements - offset ) );
+					InputIterator sliceFirst = first + offset;
+					InputIterator sliceLast = sliceFirst + sliceElements;
+					OutputIterator sliceResult = result + offset;
+
+					//  Read before the scan, which may write over it in place
+					iType lastInput = *( sliceLast - 1 );
+
+					pointer first_pointer = bolt::cl::addressof(sliceFirst) ;
 		
-				device_vector< iType > dvInput( first_pointer, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, true, ctrl );
-				device_vector< oType > dvOutput( result, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, false, ctrl );
-				auto device_iterator_first = bolt::cl::create_device_itr(
-													typename bolt::cl::iterator_traits< InputIterator >::iterator_category( ), 
-													first, dvInput.begin() );
-				auto device_iterator_last  = bolt::cl::create_device_itr(
-													typename bolt::cl::iterator_traits< InputIterator >::iterator_category( ), 
-													last, dvInput.end() );
-				cl::scan(ctrl, device_iterator_first, device_iterator_last, dvOutput.begin(), init, inclusive, binary_op, user_code);
-				dvOutput.data( );
+					device_vector< iType > dvInput( first_pointer, sliceElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, true, ctrl );
+					device_vector< oType > dvOutput( sliceResult, sliceElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, false, ctrl );
+					auto device_iterator_first = bolt::cl::create_device_itr(
+														typename bolt::cl::iterator_traits< InputIterator >::iterator_category( ), 
+														sliceFirst, dvInput.begin() );
+					auto device_iterator_last  = bolt::cl::create_device_itr(
+														typename bolt::cl::iterator_traits< InputIterator >::iterator_category( ), 
+														sliceLast, dvInput.end() );
+					if( offset == 0 )
+						cl::scan(ctrl, device_iterator_first, device_iterator_last, dvOutput.begin(), init, inclusive, binary_op, user_code);
+					else if( inclusive )
+					{
+						cl::scan(ctrl, device_iterator_first, device_iterator_last, dvOutput.begin(), carry, true, binary_op, user_code);
+						bolt::cl::constant_iterator< oType > carryIn( carry );
+						bolt::cl::transform( ctrl, carryIn, carryIn + sliceElements, dvOutput.begin( ), dvOutput.begin( ),
+							binary_op, user_code );
+					}
+					else
+						cl::scan(ctrl, device_iterator_first, device_iterator_last, dvOutput.begin(), carry, false, binary_op, user_code);
+					dvOutput.data( );
+
+					oType lastOutput = *( sliceResult + ( sliceElements - 1 ) );
+					carry = inclusive ? lastOutput : static_cast< oType >( binary_op( lastOutput, lastInput ) );
+				}
 		
 				return ;
 			}
@@ -997,19 +1149,20 @@ namespace detail
 	const BinaryFunction& binary_op,
 	const std::string& user_code)
 	  {
+		static_assert( !is_zip_iterator< InputIterator >::value && !is_zip_iterator< OutputIterator >::value,
+		               "scan does not take zip_iterator ranges" );
 		typedef typename std::iterator_traits< InputIterator >::value_type iType;
 		typedef typename std::iterator_traits< OutputIterator >::value_type oType;
 
-		unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
+		size_t numElements = static_cast< size_t >( std::distance( first, last ) );
 		if( numElements == 0 )
 			return result;
 
-		bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
-
-		if( runMode == bolt::cl::control::Automatic )
-		{
-			runMode = ctl.getDefaultPathToRun();
-		}
+		detail::AutomaticRunMode automatic( ctl,
+			detail::dispatchKey< iType >( "scan" ), numElements,
+			detail::hostBytes( first, numElements ) + detail::hostBytes( result, numElements ),
+			detail::deviceBytes( first, numElements ) + detail::deviceBytes( result, numElements ) );
+		bolt::cl::control::e_RunMode runMode = automatic.get( );
 		#if defined(BOLT_DEBUG_LOG)
 		BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
 		#endif
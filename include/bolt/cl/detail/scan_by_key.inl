@@ -29,6 +29,7 @@
 #include "bolt/cl/distance.h"
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
 
 
@@ -209,7 +210,7 @@ namespace detail
 					// do zeroeth element
 					*result = *first2; // assign value
 					// scan oneth element and beyond
-					for ( unsigned int i=1; i< sz;  i++)
+					for ( size_t i=1; i< sz;  i++)
 					{
 						// load value
 						oType currentValue = *(first2 + i); // convertible
@@ -235,7 +236,7 @@ namespace detail
 					oType temp = *first2;
 					*result = static_cast<oType>(init);
 					// scan oneth element and beyond
-					for ( unsigned int i= 1; i<sz; i++)
+					for ( size_t i= 1; i<sz; i++)
 					{
 						// load value
 						oType currentValue = temp; // convertible
@@ -445,6 +446,135 @@ namespace detail
 			}
 		};
 
+		class ScanByKeySinglePass_KernelTemplateSpecializer : public KernelTemplateSpecializer
+		{
+			public:
+
+			ScanByKeySinglePass_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+			{
+				addKernelName("singlePassScanByKey");
+			}
+
+			const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+			{
+				const std::string templateSpecializationString =
+					"// Dynamic specialization of generic template definition, using user supplied types\n"
+					"template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+					"__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+					"__kernel void " + name(0) + "(\n"
+					"global " + typeNames[scanByKey_kType] + "* keys,\n"
+					""        + typeNames[scanByKey_kIterType] + " keys_iter,\n"
+					"global " + typeNames[scanByKey_vType] + "* vals,\n"
+					""        + typeNames[scanByKey_iIterType] + " vals_iter,\n"
+					"global " + typeNames[scanByKey_oType] + "* output,\n"
+					""        + typeNames[scanByKey_oIterType] + " output_iter,\n"
+					""        + typeNames[scanByKey_initType] + " init,\n"
+					"const uint vecSize,\n"
+					"local "  + typeNames[scanByKey_kIterType] + "::value_type * ldsKeys,\n"
+					"local "  + typeNames[scanByKey_oType] + "* ldsVals,\n"
+					"local "  + typeNames[scanByKey_oType] + "* ldsSums,\n"
+					"local uint* ldsHeads,\n"
+					"global " + typeNames[scanByKey_BinaryPredicate] + "* binaryPred,\n"
+					"global " + typeNames[scanByKey_BinaryFunction]  + "* binaryFunct,\n"
+					"global uint* tileStatus,\n"
+					"global uint* tileAggregate,\n"
+					"global uint* tilePrefix,\n"
+					"int exclusive\n"
+					");\n\n";
+
+				return templateSpecializationString;
+			}
+		};
+
+		//  One kernel that reads and writes every element once; scan_by_key( ) takes this path when
+		//  singlePassScanItems( ) says the device can run it
+		template<
+		typename InputIterator1,
+		typename InputIterator2,
+		typename OutputIterator,
+		typename T,
+		typename BinaryPredicate,
+		typename BinaryFunction >
+		void singlePassScanByKey(
+		control& ctl,
+		const InputIterator1& firstKey,
+		const InputIterator1& lastKey,
+		const InputIterator2& firstValue,
+		const OutputIterator& result,
+		const T& init,
+		const BinaryPredicate& binary_pred,
+		const BinaryFunction& binary_funct,
+		const bool& inclusive,
+		const std::vector< std::string >& typeNames,
+		const std::vector< std::string >& typeDefs,
+		const cl_uint scanItems )
+		{
+				typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+				typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+				const cl_uint wgSize = WAVESIZE*KERNEL02WAVES;
+
+				std::ostringstream oss;
+				oss << " -DKERNEL0WORKGROUPSIZE=" << wgSize;
+				oss << " -DSCAN_ITEMS=" << scanItems;
+
+				ScanByKeySinglePass_KernelTemplateSpecializer sp_kts;
+				bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+					ctl,
+					typeNames,
+					&sp_kts,
+					typeDefs,
+					scan_by_key_kernels,
+					oss.str( ) );
+
+				cl_uint doExclusiveScan = inclusive ? 0 : 1;
+				cl_uint numElements = deviceElements( std::distance( firstKey, lastKey ) );
+				cl_uint tileSize = wgSize * scanItems;
+				cl_uint numTiles = numElements / tileSize + ( numElements % tileSize ? 1 : 0 );
+
+				ALIGNED( 256 ) BinaryPredicate aligned_binary_pred( binary_pred );
+				control::buffPointer binaryPredicateBuffer = ctl.acquireFunctorBuffer( aligned_binary_pred );
+				ALIGNED( 256 ) BinaryFunction aligned_binary_funct( binary_funct );
+				control::buffPointer binaryFunctionBuffer = ctl.acquireFunctorBuffer( aligned_binary_funct );
+				control::buffPointer tileStatus = acquireScanTileStatus( ctl, numTiles );
+				control::buffPointer tileAggregate = ctl.acquireBuffer( numTiles * sizeof( oType ) );
+				control::buffPointer tilePrefix = ctl.acquireBuffer( numTiles * sizeof( oType ) );
+
+				typename InputIterator1::Payload firstKey_payload = firstKey.gpuPayload( );
+				typename InputIterator2::Payload firstValue_payload = firstValue.gpuPayload( );
+				typename OutputIterator::Payload result_payload = result.gpuPayload( );
+
+				V_OPENCL( kernels[0].setArg( 0, firstKey.base().getContainer().getBuffer()), "Error setArg singlePassScanByKey" ); // Input keys
+				V_OPENCL( kernels[0].setArg( 1, firstKey.gpuPayloadSize( ), &firstKey_payload ), "Error setting a kernel argument" );
+				V_OPENCL( kernels[0].setArg( 2, firstValue.base().getContainer().getBuffer()),"Error setArg singlePassScanByKey" ); // Input buffer
+				V_OPENCL( kernels[0].setArg( 3, firstValue.gpuPayloadSize( ), &firstValue_payload ), "Error setting a kernel argument" );
+				V_OPENCL( kernels[0].setArg( 4, result.getContainer().getBuffer() ), "Error setArg singlePassScanByKey" ); // Output buffer
+				V_OPENCL( kernels[0].setArg( 5, result.gpuPayloadSize( ), &result_payload ), "Error setting a kernel argument" );
+				V_OPENCL( kernels[0].setArg( 6, init ),                 "Error setArg singlePassScanByKey" ); // Initial value exclusive
+				V_OPENCL( kernels[0].setArg( 7, numElements ),          "Error setArg singlePassScanByKey" ); // Number of elements
+				V_OPENCL( kernels[0].setArg( 8, tileSize * sizeof( kType ), NULL ), "Error setArg singlePassScanByKey" ); // Tile keys
+				V_OPENCL( kernels[0].setArg( 9, tileSize * sizeof( oType ), NULL ), "Error setArg singlePassScanByKey" ); // Tile values
+				V_OPENCL( kernels[0].setArg(10, ( wgSize + 1 ) * sizeof( oType ), NULL ), "Error setArg singlePassScanByKey" ); // Work item sums and carry
+				V_OPENCL( kernels[0].setArg(11, wgSize * sizeof( cl_uint ), NULL ), "Error setArg singlePassScanByKey" ); // Work item segment starts
+				V_OPENCL( kernels[0].setArg(12, *binaryPredicateBuffer),"Error setArg singlePassScanByKey" ); // User provided functor
+				V_OPENCL( kernels[0].setArg(13, *binaryFunctionBuffer ),"Error setArg singlePassScanByKey" ); // User provided functor
+				V_OPENCL( kernels[0].setArg(14, *tileStatus ),          "Error setArg singlePassScanByKey" ); // Tile counter and status
+				V_OPENCL( kernels[0].setArg(15, *tileAggregate ),       "Error setArg singlePassScanByKey" ); // Tile sums
+				V_OPENCL( kernels[0].setArg(16, *tilePrefix ),          "Error setArg singlePassScanByKey" ); // Inclusive tile prefixes
+				V_OPENCL( kernels[0].setArg(17, doExclusiveScan ),      "Error setArg singlePassScanByKey" ); // Exclusive scan?
+
+				::cl::Event kernelEvent;
+				cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+					kernels[0],
+					::cl::NullRange,
+					::cl::NDRange( numTiles * wgSize ),
+					::cl::NDRange( wgSize ),
+					NULL,
+					&kernelEvent );
+				V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for singlePassScanByKey" );
+
+				bolt::cl::wait( ctl, kernelEvent );
+		}
+
 		//  All calls to scan_by_key end up here, unless an exception was thrown
 		//  This is the function that sets up the kernels to compile (once only) and execute
 		
@@ -513,6 +643,21 @@ namespace detail
 				PUSH_BACK_UNIQUE( typeDefs, ClCode< BinaryPredicate >::get() )
 				PUSH_BACK_UNIQUE( typeDefs, ClCode< BinaryFunction  >::get() )
 
+				/**********************************************************************************
+				 * Single pass scan, where the device supports it
+				 *********************************************************************************/
+				cl_uint scanItems = singlePassScanItems( ctl, sizeof( oType ), sizeof( kType ) + sizeof( oType ),
+					WAVESIZE*KERNEL02WAVES );
+				if( scanItems )
+				{
+					singlePassScanByKey( ctl, firstKey, lastKey, firstValue, result, init, binary_pred, binary_funct,
+						inclusive, typeNames, typeDefs, scanItems );
+			#ifdef BOLT_ENABLE_PROFILING
+			aProfiler.stopTrial();
+			#endif
+					return;
+				}
+
 				/**********************************************************************************
 				 * Compile Options
 				 *********************************************************************************/
@@ -532,7 +677,7 @@ namespace detail
 				 * Request Compiled Kernels
 				 *********************************************************************************/
 				ScanByKey_KernelTemplateSpecializer ts_kts;
-				std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+				bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
 					ctl,
 					typeNames,
 					&ts_kts,
@@ -550,7 +695,7 @@ namespace detail
 				int resultCnt = computeUnits * wgPerComputeUnit;
 
 				//  Ceiling function to bump the size of input to the next whole wavefront size
-				cl_uint numElements = static_cast< cl_uint >( std::distance( firstKey, lastKey ) );
+				cl_uint numElements = deviceElements( std::distance( firstKey, lastKey ) );
 				typename device_vector< kType >::size_type sizeInputBuff = numElements;
 
 				int modWgSize = (sizeInputBuff & ((kernel0_WgSize*2)-1));
@@ -573,11 +718,9 @@ namespace detail
 				// Create buffer wrappers so we can access the host functors, for read or writing in the kernel
 
 				ALIGNED( 256 ) BinaryPredicate aligned_binary_pred( binary_pred );
-				control::buffPointer binaryPredicateBuffer = ctl.acquireBuffer( sizeof( aligned_binary_pred ),
-					CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_pred );
+				control::buffPointer binaryPredicateBuffer = ctl.acquireFunctorBuffer( aligned_binary_pred );
 				 ALIGNED( 256 ) BinaryFunction aligned_binary_funct( binary_funct );
-				control::buffPointer binaryFunctionBuffer = ctl.acquireBuffer( sizeof( aligned_binary_funct ),
-					CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_funct );
+				control::buffPointer binaryFunctionBuffer = ctl.acquireFunctorBuffer( aligned_binary_funct );
 
 				control::buffPointer keySumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( kType ) );
 				control::buffPointer preSumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( vType ) );
@@ -838,7 +981,7 @@ namespace detail
 				typedef typename std::iterator_traits< InputIterator2 >::value_type iType;
 				typedef typename std::iterator_traits< OutputIterator >::value_type oType;	    
 	    
-				int numElements = static_cast< int >( std::distance( first1, last1 ) );
+				int numElements = deviceElements( std::distance( first1, last1 ) );
 				if( numElements == 0 )
 					return;
 	    
@@ -901,7 +1044,10 @@ namespace detail
 			typedef typename std::iterator_traits< InputIterator2 >::value_type iType;
 			typedef typename std::iterator_traits< OutputIterator >::value_type oType;
 
-			unsigned int numElements = static_cast< unsigned int >( std::distance( first1, last1 ) );
+			static_assert( !is_zip_iterator< InputIterator1 >::value && !is_zip_iterator< InputIterator2 >::value &&
+			               !is_zip_iterator< OutputIterator >::value,
+			               "scan_by_key does not take zip_iterator ranges" );
+			size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
 			if( numElements == 0 )
 				return result;
 
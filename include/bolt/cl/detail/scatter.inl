@@ -34,6 +34,7 @@
 #include "bolt/cl/distance.h"
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
 
 
@@ -116,7 +117,7 @@ scatter (bolt::cl::control &ctl, InputIterator1 first1,
 
     size_t numElements = static_cast<  size_t >( std::distance( first1, last1 ) );
 
-	for (int iter = 0; iter<(int)numElements; iter++)
+	for (size_t iter = 0; iter<numElements; iter++)
                 *(result+*(map + iter)) = (oType) *(first1 + iter);
 }
 
@@ -213,7 +214,7 @@ scatter_if( bolt::cl::control &ctl,
             Predicate pred)
 {
     size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
-	for (int iter = 0; iter< (int)numElements; iter++)
+	for (size_t iter = 0; iter< numElements; iter++)
     {
           if(pred(stencil[iter]) != 0)
                result[*(map+(iter))] = first1[iter];
@@ -492,7 +493,7 @@ public:
         typedef typename std::iterator_traits<DVInputIterator3>::value_type iType3;
         typedef typename std::iterator_traits<DVOutputIterator>::value_type oType;
 
-        cl_uint distVec = static_cast< cl_uint >( std::distance( first1, last1 ) );
+        cl_uint distVec = deviceElements( std::distance( first1, last1 ) );
         if( distVec == 0 )
             return;
 
@@ -565,7 +566,7 @@ public:
           * Request Compiled Kernels
           *********************************************************************************/
          ScatterIf_KernelTemplateSpecializer s_if_kts;
-         std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+         bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
              ctl,
              scatterIfKernels,
              &s_if_kts,
@@ -575,9 +576,7 @@ public:
          // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
         ALIGNED( 256 ) Predicate aligned_binary( pred );
-        control::buffPointer userPredicate = ctl.acquireBuffer( sizeof( aligned_binary ),
-                                                                CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY,
-                                                                &aligned_binary );
+        control::buffPointer userPredicate = ctl.acquireFunctorBuffer( aligned_binary );
 
         typename DVInputIterator1::Payload first1_payload = first1.gpuPayload( );
         typename DVInputIterator2::Payload map_payload = map.gpuPayload( );
@@ -628,7 +627,7 @@ public:
         typedef typename std::iterator_traits<DVInputIterator2>::value_type iType2;
         typedef typename std::iterator_traits<DVOutputIterator>::value_type oType;
 
-		cl_uint distVec = static_cast< cl_uint >( std::distance( first1, last1 ) );
+		cl_uint distVec = deviceElements( std::distance( first1, last1 ) );
         if( distVec == 0 )
             return;
 
@@ -695,7 +694,7 @@ public:
           * Request Compiled Kernels
           *********************************************************************************/
          ScatterKernelTemplateSpecializer s_kts;
-         std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+         bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
              ctl,
              scatterKernels,
              &s_kts,
@@ -753,9 +752,10 @@ public:
 		typedef typename std::iterator_traits<InputIterator3>::value_type iType3;
         typedef typename std::iterator_traits<OutputIterator>::value_type oType;
 
-        int sz = static_cast<int>( std::distance( first1, last1 ) );
+        int sz = deviceElements( std::distance( first1, last1 ) );
 
-        device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, false, ctl );
+        //  Elements the map does not reach keep their values, so a staged range is copied in first
+        device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, true, ctl );
 
 		
 	    // Map the input iterator to a device_vector
@@ -819,9 +819,10 @@ public:
         typedef typename std::iterator_traits<MapIterator>::value_type iType2;
         typedef typename std::iterator_traits<OutputIterator>::value_type oType;
 
-        int sz = static_cast<int>( std::distance( first1, last1 ) );
+        int sz = deviceElements( std::distance( first1, last1 ) );
 
-        device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, false, ctl );
+        //  Elements the map does not reach keep their values, so a staged range is copied in first
+        device_vector< oType > dvResult( result, sz, CL_MEM_USE_HOST_PTR|CL_MEM_WRITE_ONLY, true, ctl );
 
 		
 	    // Map the input iterator to a device_vector
@@ -869,7 +870,8 @@ public:
                              std::input_iterator_tag 
                            >::value ||
                std::is_same< typename std::iterator_traits< OutputIterator>::iterator_category, 
-                             bolt::cl::fancy_iterator_tag >::value ),
+                             bolt::cl::fancy_iterator_tag >::value ||
+               is_zip_iterator< InputIterator1 >::value || is_zip_iterator< OutputIterator >::value ),
                void
                            >::type
     scatter_if( bolt::cl::control& ctl,
@@ -881,7 +883,7 @@ public:
                 const Predicate& pred,
                 const std::string& user_code )
     {   
-		int sz = static_cast<int>( std::distance( first1, last1 ) );
+		size_t sz = static_cast< size_t >( std::distance( first1, last1 ) );
         if (sz == 0)
             return;
 
@@ -972,7 +974,8 @@ public:
                              std::input_iterator_tag 
                            >::value ||
                std::is_same< typename std::iterator_traits< OutputIterator>::iterator_category, 
-                             bolt::cl::fancy_iterator_tag >::value ),
+                             bolt::cl::fancy_iterator_tag >::value ||
+               is_zip_iterator< InputIterator1 >::value || is_zip_iterator< OutputIterator >::value ),
                void
                            >::type
     scatter( bolt::cl::control& ctl,
@@ -983,7 +986,7 @@ public:
              const std::string& user_code )
     {
        	
-        int sz = static_cast<int>( std::distance( first1, last1 ) );
+        size_t sz = static_cast< size_t >( std::distance( first1, last1 ) );
         if (sz == 0)
             return;
 
@@ -1059,6 +1062,85 @@ public:
                        "Output vector should be a mutable vector. It cannot be of type fancy_iterator_tag" );
     }
 
+
+    //  A zipped input is scattered a column at a time into the matching column of the zipped result; every column
+    //  reads the same map, so the columns stay in step
+    template< typename InputColumn, typename InputIterator2, typename OutputColumn >
+    void scatter_zip_column( bolt::cl::control& ctl, const InputColumn& first1, const InputColumn& last1,
+        const InputIterator2& map, const OutputColumn& result, const std::string& user_code )
+    {
+        scatter( ctl, first1, last1, map, result, user_code );
+    }
+
+    template< typename InputIterator2 >
+    void scatter_zip_column( bolt::cl::control&, const null_type&, const null_type&, const InputIterator2&,
+        const null_type&, const std::string& )
+    {
+    }
+
+    template< typename InputColumn, typename InputIterator2, typename InputIterator3, typename OutputColumn,
+        typename Predicate >
+    void scatter_if_zip_column( bolt::cl::control& ctl, const InputColumn& first1, const InputColumn& last1,
+        const InputIterator2& map, const InputIterator3& stencil, const OutputColumn& result, const Predicate& pred,
+        const std::string& user_code )
+    {
+        scatter_if( ctl, first1, last1, map, stencil, result, pred, user_code );
+    }
+
+    template< typename InputIterator2, typename InputIterator3, typename Predicate >
+    void scatter_if_zip_column( bolt::cl::control&, const null_type&, const null_type&, const InputIterator2&,
+        const InputIterator3&, const null_type&, const Predicate&, const std::string& )
+    {
+    }
+
+    template< typename InputIterator1,
+              typename InputIterator2,
+              typename OutputIterator>
+    typename std::enable_if< is_zip_iterator< InputIterator1 >::value || is_zip_iterator< OutputIterator >::value
+                           >::type
+    scatter( bolt::cl::control& ctl,
+             const InputIterator1& first1,
+             const InputIterator1& last1,
+             const InputIterator2& map,
+             const OutputIterator& result,
+             const std::string& user_code )
+    {
+        static_assert( is_zip_iterator< InputIterator1 >::value && is_zip_iterator< OutputIterator >::value,
+                       "scatter takes a zip_iterator for both the input and the result, or for neither" );
+        scatter_zip_column( ctl, first1.column0( ), last1.column0( ), map, result.column0( ), user_code );
+        scatter_zip_column( ctl, first1.column1( ), last1.column1( ), map, result.column1( ), user_code );
+        scatter_zip_column( ctl, first1.column2( ), last1.column2( ), map, result.column2( ), user_code );
+        scatter_zip_column( ctl, first1.column3( ), last1.column3( ), map, result.column3( ), user_code );
+    }
+
+    template< typename InputIterator1,
+              typename InputIterator2,
+              typename InputIterator3,
+              typename OutputIterator,
+              typename Predicate>
+    typename std::enable_if< is_zip_iterator< InputIterator1 >::value || is_zip_iterator< OutputIterator >::value
+                           >::type
+    scatter_if( bolt::cl::control& ctl,
+                const InputIterator1& first1,
+                const InputIterator1& last1,
+                const InputIterator2& map,
+                const InputIterator3& stencil,
+                const OutputIterator& result,
+                const Predicate& pred,
+                const std::string& user_code )
+    {
+        static_assert( is_zip_iterator< InputIterator1 >::value && is_zip_iterator< OutputIterator >::value,
+                       "scatter_if takes a zip_iterator for both the input and the result, or for neither" );
+        scatter_if_zip_column( ctl, first1.column0( ), last1.column0( ), map, stencil, result.column0( ), pred,
+            user_code );
+        scatter_if_zip_column( ctl, first1.column1( ), last1.column1( ), map, stencil, result.column1( ), pred,
+            user_code );
+        scatter_if_zip_column( ctl, first1.column2( ), last1.column2( ), map, stencil, result.column2( ), pred,
+            user_code );
+        scatter_if_zip_column( ctl, first1.column3( ), last1.column3( ), map, stencil, result.column3( ), pred,
+            user_code );
+    }
+
 } //End of detail namespace
 
 ////////////////////////////////////////////////////////////////////
@@ -0,0 +1,479 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SET_OPERATIONS_INL )
+#define BOLT_CL_SET_OPERATIONS_INL
+#pragma once
+#define SET_OPERATIONS_WGSIZE 256
+#define SET_OPERATIONS_ITEMS_PER_THREAD 8
+
+#include <algorithm>
+
+#include "bolt/cl/copy.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/set_operations.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+    //  Which set operation to run; the values match the SET_ defines of merge_path_kernels.cl
+    enum SetOperation { set_union_op, set_intersection_op, set_difference_op, set_symmetric_difference_op };
+
+namespace cl {
+
+    enum SetOperationTypes { setop_iType1, setop_iIterType1,
+                             setop_iType2, setop_iIterType2,
+                             setop_oType, setop_oIterType,
+                             setop_Compare, setop_end };
+
+    class SetOperation_KernelTemplateSpecializer : public KernelTemplateSpecializer
+    {
+    public:
+        SetOperation_KernelTemplateSpecializer( ) : KernelTemplateSpecializer( )
+        {
+            addKernelName( "setOperationTemplate" );
+        }
+
+        const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+        {
+            const std::string templateSpecializationString =
+                "// Host generates this instantiation string with user-specified value type and functor\n"
+                "template __attribute__((mangled_name(" + name( 0 ) + "Instantiated)))\n"
+                "kernel void " + name( 0 ) + "(\n"
+                "global " + typeNames[ setop_iType1 ] + "* input1_ptr,\n"
+                + typeNames[ setop_iIterType1 ] + " input1,\n"
+                "const uint length1,\n"
+                "global " + typeNames[ setop_iType2 ] + "* input2_ptr,\n"
+                + typeNames[ setop_iIterType2 ] + " input2,\n"
+                "const uint length2,\n"
+                "global " + typeNames[ setop_oType ] + "* output_ptr,\n"
+                + typeNames[ setop_oIterType ] + " output,\n"
+                "const uint itemsPerThread,\n"
+                "const int operation,\n"
+                "const int writeOutput,\n"
+                "global " + typeNames[ setop_Compare ] + "* comp,\n"
+                "global uint* groupCounts,\n"
+                "local uint* scratch\n"
+                ");\n\n";
+
+            return templateSpecializationString;
+        }
+    };
+
+    //  Runs operation on two sorted device ranges.  Every iterator must be one the kernel can take: a
+    //  device_vector iterator or a fancy iterator.  The kernel runs twice over the same merge-path split, once to
+    //  count what every work group writes and once to write it.  Returns the number of elements written.
+    template< typename DVInputIterator1, typename DVInputIterator2, typename DVOutputIterator,
+              typename StrictWeakCompare >
+    unsigned int set_operation( control& ctl,
+                                const DVInputIterator1& first1,
+                                unsigned int length1,
+                                const DVInputIterator2& first2,
+                                unsigned int length2,
+                                const DVOutputIterator& result,
+                                const StrictWeakCompare& comp,
+                                SetOperation operation,
+                                const std::string& cl_code )
+    {
+        typedef typename std::iterator_traits< DVInputIterator1 >::value_type iType1;
+        typedef typename std::iterator_traits< DVInputIterator2 >::value_type iType2;
+        typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+        /**********************************************************************************
+         * Type Names - used in KernelTemplateSpecializer
+         *********************************************************************************/
+        std::vector< std::string > typeNames( setop_end );
+        typeNames[ setop_iType1 ] = TypeName< iType1 >::get( );
+        typeNames[ setop_iIterType1 ] = TypeName< DVInputIterator1 >::get( );
+        typeNames[ setop_iType2 ] = TypeName< iType2 >::get( );
+        typeNames[ setop_iIterType2 ] = TypeName< DVInputIterator2 >::get( );
+        typeNames[ setop_oType ] = TypeName< oType >::get( );
+        typeNames[ setop_oIterType ] = TypeName< DVOutputIterator >::get( );
+        typeNames[ setop_Compare ] = TypeName< StrictWeakCompare >::get( );
+
+        /**********************************************************************************
+         * Type Definitions - directly concatenated into kernel string
+         *********************************************************************************/
+        std::vector< std::string > typeDefinitions;
+        PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType1 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator1 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType2 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator2 >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< StrictWeakCompare >::get( ) )
+
+        SetOperation_KernelTemplateSpecializer s_kts;
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+            ctl,
+            typeNames,
+            &s_kts,
+            typeDefinitions,
+            merge_path_kernels,
+            "" );
+
+        /**********************************************************************************
+         * Merge-path split - itemsPerThread steps of the merge per work item
+         *********************************************************************************/
+        const unsigned int wgSize = SET_OPERATIONS_WGSIZE;
+        const unsigned int itemsPerThread = SET_OPERATIONS_ITEMS_PER_THREAD;
+        unsigned int total = length1 + length2;
+        unsigned int numItems = ( total + itemsPerThread - 1 ) / itemsPerThread;
+        unsigned int numGroups = ( numItems + wgSize - 1 ) / wgSize;
+
+        ALIGNED( 256 ) StrictWeakCompare aligned_comp( comp );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_comp );
+        control::buffPointer groupCounts = ctl.acquireBuffer( ( numGroups + 1 ) * sizeof( cl_uint ) );
+
+        ::cl::LocalSpaceArg scratch;
+        scratch.size_ = wgSize * sizeof( cl_uint );
+
+        typename DVInputIterator1::Payload first1_payload = first1.gpuPayload( );
+        typename DVInputIterator2::Payload first2_payload = first2.gpuPayload( );
+        typename DVOutputIterator::Payload result_payload = result.gpuPayload( );
+
+        V_OPENCL( kernels[ 0 ].setArg( 0, first1.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 1, first1.gpuPayloadSize( ), &first1_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 2, length1 ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 3, first2.base( ).getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 4, first2.gpuPayloadSize( ), &first2_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 5, length2 ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 6, result.getContainer( ).getBuffer( ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 7, result.gpuPayloadSize( ), &result_payload ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 8, itemsPerThread ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 9, static_cast< cl_int >( operation ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 10, static_cast< cl_int >( 0 ) ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 11, *userFunctor ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 12, *groupCounts ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[ 0 ].setArg( 13, scratch ), "Error setArg kernels[ 0 ]" );
+
+        cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 0 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numGroups * wgSize ),
+            ::cl::NDRange( wgSize ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for set operation count kernel" );
+
+        //  The arguments are copied when the kernel is enqueued, so the second launch only flips writeOutput
+        V_OPENCL( kernels[ 0 ].setArg( 10, static_cast< cl_int >( 1 ) ), "Error setArg kernels[ 0 ]" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 0 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numGroups * wgSize ),
+            ::cl::NDRange( wgSize ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for set operation write kernel" );
+
+        //  The write launch leaves the size of the output after the group counts
+        cl_uint* written = static_cast< cl_uint* >( ctl.getCommandQueue( ).enqueueMapBuffer( *groupCounts, true,
+            CL_MAP_READ, numGroups * sizeof( cl_uint ), sizeof( cl_uint ), NULL, NULL, &l_Error ) );
+        V_OPENCL( l_Error, "Error calling map on the set operation count buffer" );
+        unsigned int length = *written;
+
+        ::cl::Event unmapEvent;
+        V_OPENCL( ctl.getCommandQueue( ).enqueueUnmapMemObject( *groupCounts, written, NULL, &unmapEvent ),
+            "Error calling unmap on the set operation count buffer" );
+        V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+
+        return length;
+    }
+
+} // end of cl namespace
+
+    template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare >
+    OutputIterator serial_set_operation( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+        InputIterator2 last2, OutputIterator result, const StrictWeakCompare& comp, SetOperation operation )
+    {
+        switch( operation )
+        {
+        case set_union_op:
+            return std::set_union( first1, last1, first2, last2, result, comp );
+        case set_intersection_op:
+            return std::set_intersection( first1, last1, first2, last2, result, comp );
+        case set_difference_op:
+            return std::set_difference( first1, last1, first2, last2, result, comp );
+        default:
+            return std::set_symmetric_difference( first1, last1, first2, last2, result, comp );
+        }
+    }
+
+#ifdef ENABLE_TBB
+    template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare >
+    OutputIterator btbb_set_operation( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+        InputIterator2 last2, OutputIterator result, const StrictWeakCompare& comp, SetOperation operation )
+    {
+        switch( operation )
+        {
+        case set_union_op:
+            return bolt::btbb::set_union( first1, last1, first2, last2, result, comp );
+        case set_intersection_op:
+            return bolt::btbb::set_intersection( first1, last1, first2, last2, result, comp );
+        case set_difference_op:
+            return bolt::btbb::set_difference( first1, last1, first2, last2, result, comp );
+        default:
+            return bolt::btbb::set_symmetric_difference( first1, last1, first2, last2, result, comp );
+        }
+    }
+#endif
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_operation( bolt::cl::control &ctl, const InputIterator1& first1, const InputIterator1& last1,
+    const InputIterator2& first2, const InputIterator2& last2, const OutputIterator& result,
+    const StrictWeakCompare& comp, SetOperation operation, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator1 >::value && !is_zip_iterator< InputIterator2 >::value &&
+                   !is_zip_iterator< OutputIterator >::value,
+                   "The set operations do not take zip_iterator ranges" );
+    size_t n1 = static_cast< size_t >( std::distance( first1, last1 ) );
+    size_t n2 = static_cast< size_t >( std::distance( first2, last2 ) );
+    if( n1 + n2 == 0 )
+        return result;
+
+    //  With one range empty there is nothing to merge; copy the other one if the operation keeps it
+    if( n1 == 0 || n2 == 0 )
+    {
+        if( n1 > 0 && operation != set_intersection_op )
+            return bolt::cl::copy( ctl, first1, last1, result, user_code );
+        if( n2 > 0 && ( operation == set_union_op || operation == set_symmetric_difference_op ) )
+            return bolt::cl::copy( ctl, first2, last2, result, user_code );
+        return result;
+    }
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_SETOPERATIONS,BOLTLOG::BOLT_SERIAL_CPU,"::Set_Operations::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator1 > input1( ctl, first1, n1, CL_MAP_READ );
+        host_view< InputIterator2 > input2( ctl, first2, n2, CL_MAP_READ );
+        host_view< OutputIterator > output( ctl, result, n1 + n2, CL_MAP_WRITE );
+        return result + ( serial_set_operation( input1.begin( ), input1.begin( ) + n1, input2.begin( ),
+            input2.begin( ) + n2, output.begin( ), comp, operation ) - output.begin( ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_SETOPERATIONS,BOLTLOG::BOLT_MULTICORE_CPU,"::Set_Operations::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator1 > input1( ctl, first1, n1, CL_MAP_READ );
+            host_view< InputIterator2 > input2( ctl, first2, n2, CL_MAP_READ );
+            host_view< OutputIterator > output( ctl, result, n1 + n2, CL_MAP_WRITE );
+            return result + ( btbb_set_operation( input1.begin( ), input1.begin( ) + n1, input2.begin( ),
+                input2.begin( ) + n2, output.begin( ), comp, operation ) - output.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Set_Operations is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_SETOPERATIONS,BOLTLOG::BOLT_OPENCL_GPU,"::Set_Operations::OPENCL_GPU");
+        #endif
+
+        //  The merge path runs over both ranges at once, so they are not cut into slices
+        int length1 = deviceElements( n1 );
+        int length2 = deviceElements( n2 );
+        device_view< InputIterator1 > dvInput1( ctl, first1, length1, true );
+        device_view< InputIterator2 > dvInput2( ctl, first2, length2, true );
+        compact_output< OutputIterator > dvOutput( ctl, result, deviceElements( n1 + n2 ) );
+
+        unsigned int written = cl::set_operation( ctl, dvInput1.begin( ), length1, dvInput2.begin( ), length2,
+            dvOutput.begin( ), comp, operation, user_code );
+
+        dvOutput.copyBack( 0, written );
+        return result + written;
+    }
+}
+
+}//End OF detail namespace
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_union( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, bolt::cl::less<T>( ),
+        detail::set_union_op, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_union( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result,
+        bolt::cl::less<T>( ), detail::set_union_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_union( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, comp, detail::set_union_op,
+        user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_union( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result, comp,
+        detail::set_union_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_intersection( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, bolt::cl::less<T>( ),
+        detail::set_intersection_op, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_intersection( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result,
+        bolt::cl::less<T>( ), detail::set_intersection_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_intersection( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, comp, detail::set_intersection_op,
+        user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_intersection( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result, comp,
+        detail::set_intersection_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_difference( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, bolt::cl::less<T>( ),
+        detail::set_difference_op, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_difference( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result,
+        bolt::cl::less<T>( ), detail::set_difference_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_difference( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, comp, detail::set_difference_op,
+        user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_difference( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result, comp,
+        detail::set_difference_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_symmetric_difference( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, bolt::cl::less<T>( ),
+        detail::set_symmetric_difference_op, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator set_symmetric_difference( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result,
+        bolt::cl::less<T>( ), detail::set_symmetric_difference_op, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_symmetric_difference( bolt::cl::control &ctl, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+            InputIterator2 last2, OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( ctl, first1, last1, first2, last2, result, comp, detail::set_symmetric_difference_op,
+        user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakCompare>
+OutputIterator set_symmetric_difference( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+            OutputIterator result, StrictWeakCompare comp, const std::string& user_code )
+{
+    return detail::set_operation( control::getDefault( ), first1, last1, first2, last2, result, comp,
+        detail::set_symmetric_difference_op, user_code );
+}
+
+}//end of cl namespace
+};//end of bolt namespace
+
+#endif
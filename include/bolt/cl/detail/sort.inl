@@ -47,6 +47,8 @@
 #endif
 
 #include "bolt/cl/stablesort.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+#include "bolt/cl/dispatch.h"
 
 #define DISABLE_BITONIC_SORT
 #define SORT_ALG_BRANCH_POINT (1<<20)
@@ -201,7 +203,7 @@ void radix_sort_uint_enqueue(control &ctl,
 
     const int RADICES = (1 << RADIX); //Values handeled by each work-item?
 
-    int szElements = static_cast<int>(std::distance(first, last));
+    int szElements = deviceElements( std::distance(first, last) );
 
     int computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
     if (computeUnits > 32 )
@@ -227,7 +229,7 @@ void radix_sort_uint_enqueue(control &ctl,
     std::string compileOptions;
     //std::ostringstream oss;
     RadixSort_Common_KernelTemplateSpecializer radix_common_kts;
-    std::vector< ::cl::Kernel > commonKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels commonKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_common_kts,
@@ -236,7 +238,7 @@ void radix_sort_uint_enqueue(control &ctl,
         compileOptions);
 
     RadixSort_Uint_KernelTemplateSpecializer radix_uint_kts;
-    std::vector< ::cl::Kernel > uintKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels uintKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_uint_kts,
@@ -394,7 +396,7 @@ void radix_sort_uint_enqueue(control &ctl,
         swap = swap? 0: 1;
     }
 
-    V_OPENCL( ctl.getCommandQueue().finish(), "Error calling finish on the command queue" );
+    bolt::cl::wait( ctl );
     return;
 }
 
@@ -409,7 +411,7 @@ void radix_sort_float_enqueue(control &ctl,
 
     const int RADICES = (1 << RADIX); //Values handeled by each work-item?
 
-    int szElements = static_cast<int>(std::distance(first, last));
+    int szElements = deviceElements( std::distance(first, last) );
 
     int computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
     if (computeUnits > 32 )
@@ -435,7 +437,7 @@ void radix_sort_float_enqueue(control &ctl,
     std::string compileOptions;
     //std::ostringstream oss;
     RadixSort_Common_KernelTemplateSpecializer radix_common_kts;
-    std::vector< ::cl::Kernel > commonKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels commonKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_common_kts,
@@ -444,7 +446,7 @@ void radix_sort_float_enqueue(control &ctl,
         compileOptions);
 
     RadixSort_Uint_KernelTemplateSpecializer radix_uint_kts;
-    std::vector< ::cl::Kernel > uintKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels uintKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_uint_kts,
@@ -453,7 +455,7 @@ void radix_sort_float_enqueue(control &ctl,
         compileOptions);
 
     RadixSort_Float_KernelTemplateSpecializer radix_float_kts;
-    std::vector< ::cl::Kernel > floatKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels floatKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_float_kts,
@@ -640,7 +642,7 @@ void radix_sort_float_enqueue(control &ctl,
                         NULL,
                         NULL);
 
-    V_OPENCL( ctl.getCommandQueue().finish(), "Error calling finish on the command queue" );
+    bolt::cl::wait( ctl );
     return;
 }
 
@@ -658,7 +660,7 @@ void radix_sort_int_enqueue(control &ctl,
 
     const int RADICES = (1 << RADIX); //Values handeled by each work-item?
 
-    int szElements = static_cast<int>(std::distance(first, last));
+    int szElements = deviceElements( std::distance(first, last) );
 
     int computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
     if (computeUnits > 32 )
@@ -684,7 +686,7 @@ void radix_sort_int_enqueue(control &ctl,
     std::string compileOptions;
     //std::ostringstream oss;
     RadixSort_Common_KernelTemplateSpecializer radix_common_kts;
-    std::vector< ::cl::Kernel > commonKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels commonKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_common_kts,
@@ -693,7 +695,7 @@ void radix_sort_int_enqueue(control &ctl,
         compileOptions);
 
     RadixSort_Int_KernelTemplateSpecializer radix_int_kts;
-    std::vector< ::cl::Kernel > intKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels intKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_int_kts,
@@ -702,7 +704,7 @@ void radix_sort_int_enqueue(control &ctl,
         compileOptions);
 
     RadixSort_Uint_KernelTemplateSpecializer radix_uint_kts;
-    std::vector< ::cl::Kernel > uintKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels uintKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_uint_kts,
@@ -943,7 +945,7 @@ void radix_sort_int_enqueue(control &ctl,
 
     }//End of signed integer sorting
     
-    V_OPENCL( ctl.getCommandQueue().finish(), "Error calling finish on the command queue" );
+    bolt::cl::wait( ctl );
     return;
 }
 
@@ -1052,7 +1054,7 @@ sort_enqueue(control &ctl,
     size_t temp;
 
     BitonicSort_KernelTemplateSpecializer ts_kts;
-    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &ts_kts,
@@ -1077,8 +1079,7 @@ sort_enqueue(control &ctl,
 
     //::cl::Buffer A = first.getContainer().getBuffer();
     ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
-    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_comp ),
-                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_comp );
+    control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_comp );
    typename DVRandomAccessIterator::Payload first_payload = first.gpuPayload( );
 
     V_OPENCL( kernels[0].setArg(0, first.getContainer().getBuffer()), "Error setting 0th kernel argument" );
@@ -1119,7 +1120,7 @@ sort_enqueue(control &ctl,
                         "Error calling clEnqueueBarrierWithWaitList on the command queue" );
     l_Error = bitonicSortEvent.wait( );
     V_OPENCL( l_Error, "bitonicSortEvent failed to wait" );*/
-    V_OPENCL( ctl.getCommandQueue().finish(), "Error calling finish on the command queue" );
+    bolt::cl::wait( ctl );
     return;
 #endif
 }// END of sort_enqueue
@@ -1137,11 +1138,10 @@ void sort_pick_iterator( control &ctl,
     size_t szElements = static_cast< size_t >( std::distance( first, last ) );
     if( szElements < 2 )
         return;
-    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-    if(runMode == bolt::cl::control::Automatic)
-    {
-        runMode = ctl.getDefaultPathToRun();
-    }
+    detail::AutomaticRunMode automatic( ctl, detail::dispatchKey< T >( "sort" ), szElements,
+        0,
+        2 * detail::deviceBytes( first, szElements ) );
+    bolt::cl::control::e_RunMode runMode = automatic.get( );
     #if defined(BOLT_DEBUG_LOG)
     BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
     #endif
@@ -1192,11 +1192,10 @@ void sort_pick_iterator( control &ctl,
     if( szElements < 2 )
         return;
 
-    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-    if(runMode == bolt::cl::control::Automatic)
-    {
-        runMode = ctl.getDefaultPathToRun();
-    }
+    detail::AutomaticRunMode automatic( ctl, detail::dispatchKey< T >( "sort" ), szElements,
+        2 * detail::hostBytes( first, szElements ),
+        0 );
+    bolt::cl::control::e_RunMode runMode = automatic.get( );
     #if defined(BOLT_DEBUG_LOG)
     BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
     #endif
@@ -1221,6 +1220,7 @@ void sort_pick_iterator( control &ctl,
         dblog->CodePathTaken(BOLTLOG::BOLT_SORT,BOLTLOG::BOLT_OPENCL_GPU,"::Sort::OPENCL_GPU");
         #endif
         
+        //  A sort can not be cut into slices; the device_vector throws for a range its int can not count
         device_vector< T > dvInputOutput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
         //Now call the actual cl algorithm
         sort_enqueue(ctl,dvInputOutput.begin(),dvInputOutput.end(),comp,cl_code);
@@ -1237,6 +1237,8 @@ void sort_detect_random_access( control &ctl,
                                 const StrictWeakOrdering& comp, const std::string& cl_code,
                                 std::random_access_iterator_tag )
 {
+    static_assert( !is_zip_iterator< RandomAccessIterator >::value,
+                   "sort does not take zip_iterator ranges" );
     return sort_pick_iterator(ctl, first, last,
                               comp, cl_code,
                              typename std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
@@ -48,6 +48,12 @@
 #endif
 
 #include "bolt/cl/stablesort_by_key.h"
+#include "bolt/cl/sort.h"
+#include "bolt/cl/gather.h"
+#include "bolt/cl/copy.h"
+#include "bolt/cl/iterator/counting_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+#include "bolt/cl/iterator/discard_iterator.h"
 
 #include "bolt/BoltLog.h"
 
@@ -234,7 +240,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
 
     const int RADICES = (1 << RADIX); //Values handeled by each work-item?
 
-    int orig_szElements = static_cast<int>(std::distance(keys_first, keys_last));
+    int orig_szElements = deviceElements( std::distance(keys_first, keys_last) );
     int szElements = orig_szElements;
 
     int computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
@@ -260,7 +266,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
 
     std::string compileOptions;
     RadixSortByKey_Common_KernelTemplateSpecializer radix_common_kts;
-    std::vector< ::cl::Kernel > commonKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels commonKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_common_kts,
@@ -269,7 +275,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
         compileOptions);
 
     RadixSortByKey_Uint_KernelTemplateSpecializer radix_uint_kts;
-    std::vector< ::cl::Kernel > uintKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels uintKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_uint_kts,
@@ -435,7 +441,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
         swap = swap? 0: 1;
     }
 
-    V_OPENCL( ctl.getCommandQueue().finish(), "Error calling finish on the command queue" );
+    bolt::cl::wait( ctl );
     return;
 }
 
@@ -453,7 +459,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
 
     const int RADICES = (1 << RADIX); //Values handeled by each work-item?
 
-    int orig_szElements = static_cast<int>(std::distance(keys_first, keys_last));
+    int orig_szElements = deviceElements( std::distance(keys_first, keys_last) );
     int szElements = orig_szElements;
 
     int computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
@@ -479,7 +485,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
 
     std::string compileOptions;
     RadixSortByKey_Common_KernelTemplateSpecializer radix_common_kts;
-    std::vector< ::cl::Kernel > commonKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels commonKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_common_kts,
@@ -488,7 +494,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
         compileOptions);
 
     RadixSortByKey_Uint_KernelTemplateSpecializer radix_uint_kts;
-    std::vector< ::cl::Kernel > uintKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels uintKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_uint_kts,
@@ -497,7 +503,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
         compileOptions);
 
     RadixSortByKey_Int_KernelTemplateSpecializer radix_int_kts;
-    std::vector< ::cl::Kernel > intKernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels intKernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &radix_int_kts,
@@ -746,7 +752,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
                             NULL);
     }
 
-    V_OPENCL( ctl.getCommandQueue().finish(), "Error calling finish on the command queue" );
+    bolt::cl::wait( ctl );
     return;
 }
 
@@ -877,7 +883,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
 
         typedef typename std::iterator_traits<RandomAccessIterator1>::value_type T_keys;
         typedef typename std::iterator_traits<RandomAccessIterator2>::value_type T_values;
-        int szElements = static_cast<int>(keys_last - keys_first);
+        size_t szElements = static_cast< size_t >( keys_last - keys_first );
         if (szElements == 0)
             return;
 
@@ -901,7 +907,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
 			    #if defined(BOLT_DEBUG_LOG)
                 dblog->CodePathTaken(BOLTLOG::BOLT_SORTBYKEY,BOLTLOG::BOLT_MULTICORE_CPU,"::Sort_By_Key::MULTICORE_CPU");
                 #endif
-                serialCPU_sort_by_key(keys_first, keys_last, values_first, comp);
+                bolt::btbb::sort_by_key(keys_first, keys_last, values_first, comp);
                 return;
             #else
                 throw std::runtime_error("The MultiCoreCpu Version of Sort_by_key is not enabled to be built with TBB!\n");
@@ -911,7 +917,7 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
             dblog->CodePathTaken(BOLTLOG::BOLT_SORTBYKEY,BOLTLOG::BOLT_OPENCL_GPU,"::Sort_By_Key::OPENCL_GPU");
             #endif
 			
-            device_vector< T_values > dvInputValues( values_first, szElements,
+            device_vector< T_values > dvInputValues( values_first, deviceElements( szElements ),
                                                      CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, true, ctl );
             device_vector< T_keys > dvInputKeys( keys_first, keys_last,
                                                  CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
@@ -932,12 +938,131 @@ enum sortByKeyTypes {sort_by_key_keyValueType, sort_by_key_keyIterType,
                                     const StrictWeakOrdering& comp, const std::string& cl_code,
                                     std::random_access_iterator_tag, std::random_access_iterator_tag )
     {
+        static_assert( !is_zip_iterator< RandomAccessIterator1 >::value,
+                       "sort_by_key takes zip_iterator values, but not zip_iterator keys" );
         return sort_by_key_pick_iterator( ctl, keys_first, keys_last, values_first,
                                     comp, cl_code,
                                     typename std::iterator_traits< RandomAccessIterator1 >::iterator_category( ),
                                     typename std::iterator_traits< RandomAccessIterator2 >::iterator_category( ) );
     };
 
+    /*! \brief The permutation that sorts the keys, kept in the keys' memory
+    *   \details Zipped values are not sorted in place: the keys are sorted with an index 0..n-1 as the value, and
+    *   each column is then gathered through that index.
+    */
+    template< typename KeysIterator, typename KeysCategory = typename std::iterator_traits< KeysIterator >::iterator_category >
+    class sort_by_key_index
+    {
+    public:
+        typedef std::vector< int >::iterator iterator;
+
+        sort_by_key_index( control&, int n ): m_index( n )
+        {
+            for( int i = 0; i < n; ++i )
+                m_index[ i ] = i;
+        }
+
+        iterator begin( )
+        {
+            return m_index.begin( );
+        }
+
+    private:
+        std::vector< int > m_index;
+    };
+
+    template< typename KeysIterator >
+    class sort_by_key_index< KeysIterator, bolt::cl::device_vector_tag >
+    {
+    public:
+        typedef device_vector< int >::iterator iterator;
+
+        sort_by_key_index( control& ctl, int n ): m_index( n, 0, CL_MEM_READ_WRITE, false, ctl )
+        {
+            bolt::cl::copy( ctl, bolt::cl::make_counting_iterator( 0 ), bolt::cl::make_counting_iterator( n ),
+                            m_index.begin( ) );
+        }
+
+        iterator begin( )
+        {
+            return m_index.begin( );
+        }
+
+    private:
+        device_vector< int > m_index;
+    };
+
+    //  column[ i ] = column[ index[ i ] ] for a column in host memory
+    template< typename Column, typename IndexIterator >
+    void sort_by_key_permute_column( control &ctl, const Column& column, int n, const IndexIterator& index,
+                                     const std::string& cl_code, std::random_access_iterator_tag )
+    {
+        typedef typename std::iterator_traits< Column >::value_type valueType;
+
+        host_view< IndexIterator > hostIndex( ctl, index, n, CL_MAP_READ );
+        typename host_view< IndexIterator >::iterator map = hostIndex.begin( );
+        std::vector< valueType > gathered( n );
+        for( int i = 0; i < n; ++i )
+            gathered[ i ] = *( column + map[ i ] );
+        std::copy( gathered.begin( ), gathered.end( ), column );
+    }
+
+    //  column[ i ] = column[ index[ i ] ] for a column in a device_vector
+    template< typename Column, typename IndexIterator >
+    void sort_by_key_permute_column( control &ctl, const Column& column, int n, const IndexIterator& index,
+                                     const std::string& cl_code, bolt::cl::device_vector_tag )
+    {
+        typedef typename std::iterator_traits< Column >::value_type valueType;
+
+        device_view< IndexIterator > deviceIndex( ctl, index, n, true );
+        device_vector< valueType > gathered( n, valueType( ), CL_MEM_READ_WRITE, false, ctl );
+        bolt::cl::gather( ctl, deviceIndex.begin( ), deviceIndex.begin( ) + n, column, gathered.begin( ), cl_code );
+        bolt::cl::copy( ctl, gathered.begin( ), gathered.end( ), column, cl_code );
+    }
+
+    template< typename IndexIterator >
+    void sort_by_key_permute_column( control &, const null_type&, int, const IndexIterator&, const std::string&,
+                                     null_type )
+    {}
+
+    //Zip iterator values
+    template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+    void sort_by_key_detect_random_access( control &ctl,
+                                    const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last,
+                                    const RandomAccessIterator2 values_first,
+                                    const StrictWeakOrdering& comp, const std::string& cl_code,
+                                    std::random_access_iterator_tag, bolt::cl::zip_iterator_tag )
+    {
+        static_assert( !is_zip_iterator< RandomAccessIterator1 >::value,
+                       "sort_by_key takes zip_iterator values, but not zip_iterator keys" );
+        int szElements = deviceElements( keys_last - keys_first );
+        if( szElements == 0 )
+            return;
+
+        sort_by_key_index< RandomAccessIterator1 > index( ctl, szElements );
+        bolt::cl::sort_by_key( ctl, keys_first, keys_last, index.begin( ), comp, cl_code );
+
+        sort_by_key_permute_column( ctl, values_first.column0( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator0 >::category( ) );
+        sort_by_key_permute_column( ctl, values_first.column1( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator1 >::category( ) );
+        sort_by_key_permute_column( ctl, values_first.column2( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator2 >::category( ) );
+        sort_by_key_permute_column( ctl, values_first.column3( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator3 >::category( ) );
+    }
+
+    //Discarded values: only the keys are sorted, and no values are moved
+    template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+    void sort_by_key_detect_random_access( control &ctl,
+                                    const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last,
+                                    const RandomAccessIterator2 values_first,
+                                    const StrictWeakOrdering& comp, const std::string& cl_code,
+                                    std::random_access_iterator_tag, bolt::cl::discard_iterator_tag )
+    {
+        bolt::cl::sort( ctl, keys_first, keys_last, comp, cl_code );
+    }
+
     template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
     void sort_by_key_detect_random_access( control &ctl,
                                     const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last,
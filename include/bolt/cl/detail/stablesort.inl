@@ -24,6 +24,8 @@
 #include "bolt/btbb/stable_sort.h"
 #endif
 #include "bolt/cl/sort.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+#include "bolt/cl/dispatch.h"
 #define BOLT_CL_STABLESORT_CPU_THRESHOLD 256
 #define STABLESORT_ALG_BRANCH_POINT (1<<20)
 namespace bolt {
@@ -90,7 +92,7 @@ void merge_sort_enqueue(control &ctrl,
              StrictWeakOrdering comp, const std::string& cl_code)
 {
     cl_int l_Error;
-    cl_uint vecSize = static_cast< cl_uint >( std::distance( first, last ) );
+    cl_uint vecSize = deviceElements( std::distance( first, last ) );
 
     /**********************************************************************************
      * Type Names - used in KernelTemplateSpecializer
@@ -122,7 +124,7 @@ void merge_sort_enqueue(control &ctrl,
 
 
     StableSort_KernelTemplateSpecializer ss_kts;
-    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
         ctrl,
         typeNames,
         &ss_kts,
@@ -143,8 +145,7 @@ void merge_sort_enqueue(control &ctrl,
     }
 
     ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
-    control::buffPointer userFunctor = ctrl.acquireBuffer( sizeof( aligned_comp ),CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY,
-                                                           &aligned_comp );
+    control::buffPointer userFunctor = ctrl.acquireFunctorBuffer( aligned_comp );
 
     cl_uint ldsSize  = static_cast< cl_uint >( localRange * sizeof( iType ) );
 	//  Allocate a flipflop buffer because the merge passes are out of place
@@ -334,12 +335,10 @@ void stablesort_pick_iterator( control &ctl, const RandomAccessIterator& first,
     if( vecSize < 2 )
         return;
 
-    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
-
-    if( runMode == bolt::cl::control::Automatic )
-    {
-        runMode = ctl.getDefaultPathToRun();
-    }
+    detail::AutomaticRunMode automatic( ctl, detail::dispatchKey< Type >( "stable_sort" ), vecSize,
+        2 * detail::hostBytes( first, vecSize ),
+        0 );
+    bolt::cl::control::e_RunMode runMode = automatic.get( );
     #if defined(BOLT_DEBUG_LOG)
     BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
     #endif
@@ -394,12 +393,10 @@ void stablesort_pick_iterator( control &ctl,
     if( vecSize < 2 )
         return;
 
-    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
-
-    if( runMode == bolt::cl::control::Automatic )
-    {
-        runMode = ctl.getDefaultPathToRun();
-    }
+    detail::AutomaticRunMode automatic( ctl, detail::dispatchKey< Type >( "stable_sort" ), vecSize,
+        0,
+        2 * detail::deviceBytes( first, vecSize ) );
+    bolt::cl::control::e_RunMode runMode = automatic.get( );
     #if defined(BOLT_DEBUG_LOG)
     BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
     #endif
@@ -455,6 +452,8 @@ void stablesort_detect_random_access( control &ctl,
                                 const StrictWeakOrdering& comp, const std::string& cl_code,
                                 std::random_access_iterator_tag )
 {
+    static_assert( !is_zip_iterator< RandomAccessIterator >::value,
+                   "stable_sort does not take zip_iterator ranges" );
     return stablesort_pick_iterator(ctl, first, last,
                               comp, cl_code,
                               typename std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
@@ -24,6 +24,8 @@
 #include "bolt/btbb/stable_sort_by_key.h"
 #endif
 #include "bolt/cl/sort_by_key.h"
+#include "bolt/cl/stablesort.h"
+#include "bolt/cl/iterator/discard_iterator.h"
 
 #define BOLT_CL_STABLESORT_BY_KEY_CPU_THRESHOLD 256
 #define STABLESORT_BY_KEY_ALG_BRANCH_POINT (1<<20)
@@ -131,11 +133,11 @@ namespace detail
         typedef std_stable_sort<keyType, valType> KeyValuePair;
         typedef std_stable_sort_comp<keyType, valType, StrictWeakOrdering> KeyValuePairFunctor;
 
-        int vecSize = static_cast<int>( std::distance( keys_first, keys_last ) );
+        size_t vecSize = std::distance( keys_first, keys_last );
         std::vector<KeyValuePair> KeyValuePairVector(vecSize);
         KeyValuePairFunctor functor(comp);
         //Zip the key and values iterators into a std_stable_sort vector.
-        for (int i=0; i< vecSize; i++)
+        for (size_t i=0; i< vecSize; i++)
         {
             KeyValuePairVector[i].key   = *(keys_first + i);
             KeyValuePairVector[i].value = *(values_first + i);
@@ -143,7 +145,7 @@ namespace detail
         //Sort the std_stable_sort vector using std::stable_sort
         std::stable_sort(KeyValuePairVector.begin(), KeyValuePairVector.end(), functor);
         //Extract the keys and values from the KeyValuePair and fill the respective iterators.
-        for (int i=0; i< vecSize; i++)
+        for (size_t i=0; i< vecSize; i++)
         {
             *(keys_first + i)   = KeyValuePairVector[i].key;
             *(values_first + i) = KeyValuePairVector[i].value;
@@ -161,7 +163,7 @@ namespace detail
                                     const StrictWeakOrdering& comp, const std::string& cl_code )
     {
         cl_int l_Error;
-        cl_uint vecSize = static_cast< cl_uint >( std::distance( keys_first, keys_last ) );
+        cl_uint vecSize = deviceElements( std::distance( keys_first, keys_last ) );
 
         /**********************************************************************************
          * Type Names - used in KernelTemplateSpecializer
@@ -197,7 +199,7 @@ namespace detail
         std::string compileOptions;
 
         StableSort_by_key_KernelTemplateSpecializer ss_kts;
-        std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
             ctrl,
             typeNames,
             &ss_kts,
@@ -219,8 +221,7 @@ namespace detail
         }
 
 	    ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
-        control::buffPointer userFunctor = ctrl.acquireBuffer( sizeof( aligned_comp ),
-                                                              CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, &aligned_comp );
+        control::buffPointer userFunctor = ctrl.acquireFunctorBuffer( aligned_comp );
 
         //  kernels[ 0 ] sorts values within a workgroup, in parallel across the entire vector
         //  kernels[ 0 ] reads and writes to the same vector
@@ -465,7 +466,7 @@ namespace detail
         typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
         typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valType;
 
-        int vecSize = static_cast<int>( std::distance( keys_first, keys_last ) );
+        size_t vecSize = static_cast< size_t >( std::distance( keys_first, keys_last ) );
         if( vecSize < 2 )
             return;
 
@@ -508,7 +509,8 @@ namespace detail
             #endif
 			
             device_vector< keyType > dvKeys( keys_first, keys_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
-            device_vector< valType > dvValues( values_first, vecSize, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, false, ctl );
+            device_vector< valType > dvValues( values_first, deviceElements( vecSize ),
+                CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, true, ctl );
 
             //Now call the actual cl algorithm
             stablesort_by_key_enqueue( ctl, dvKeys.begin(), dvKeys.end(), dvValues.begin( ), comp, cl_code );
@@ -530,7 +532,7 @@ namespace detail
     {
         typedef typename std::iterator_traits< DVRandomAccessIterator1 >::value_type keyType;
         typedef typename std::iterator_traits< DVRandomAccessIterator2 >::value_type valueType;
-        int vecSize = static_cast<int>( std::distance( keys_first, keys_last ) );
+        int vecSize = deviceElements( std::distance( keys_first, keys_last ) );
         if( vecSize < 2 )
             return;
 
@@ -599,6 +601,8 @@ namespace detail
                                     const StrictWeakOrdering& comp, const std::string& cl_code,
                                     std::random_access_iterator_tag, std::random_access_iterator_tag )
     {
+        static_assert( !is_zip_iterator< RandomAccessIterator1 >::value,
+                       "stable_sort_by_key takes zip_iterator values, but not zip_iterator keys" );
         return stablesort_by_key_pick_iterator( ctl, keys_first, keys_last, values_first,
                                     comp, cl_code,
                                     typename std::iterator_traits< RandomAccessIterator1 >::iterator_category( ),
@@ -615,6 +619,45 @@ namespace detail
         static_assert(std::is_same< RandomAccessIterator1, bolt::cl::fancy_iterator_tag>::value, "It is not possible to sort fancy iterators. They are not mutable" );
         static_assert(std::is_same< RandomAccessIterator2,std::input_iterator_tag >::value  , "It is not possible to sort fancy iterators. They are not mutable" );
     }
+
+    //Discarded values: only the keys are sorted, and no values are moved
+    template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+    void stablesort_by_key_detect_random_access( control &ctl,
+                                    const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last,
+                                    const RandomAccessIterator2 values_first,
+                                    const StrictWeakOrdering& comp, const std::string& cl_code,
+                                    std::random_access_iterator_tag, bolt::cl::discard_iterator_tag )
+    {
+        bolt::cl::stable_sort( ctl, keys_first, keys_last, comp, cl_code );
+    }
+
+    //Zip iterator values: the index 0..n-1 is stably sorted with the keys, and each column is gathered through it
+    template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+    void stablesort_by_key_detect_random_access( control &ctl,
+                                    const RandomAccessIterator1 keys_first, const RandomAccessIterator1 keys_last,
+                                    const RandomAccessIterator2 values_first,
+                                    const StrictWeakOrdering& comp, const std::string& cl_code,
+                                    std::random_access_iterator_tag, bolt::cl::zip_iterator_tag )
+    {
+        static_assert( !is_zip_iterator< RandomAccessIterator1 >::value,
+                       "stable_sort_by_key takes zip_iterator values, but not zip_iterator keys" );
+        int szElements = deviceElements( keys_last - keys_first );
+        if( szElements == 0 )
+            return;
+
+        sort_by_key_index< RandomAccessIterator1 > index( ctl, szElements );
+        bolt::cl::stable_sort_by_key( ctl, keys_first, keys_last, index.begin( ), comp, cl_code );
+
+        sort_by_key_permute_column( ctl, values_first.column0( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator0 >::category( ) );
+        sort_by_key_permute_column( ctl, values_first.column1( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator1 >::category( ) );
+        sort_by_key_permute_column( ctl, values_first.column2( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator2 >::category( ) );
+        sort_by_key_permute_column( ctl, values_first.column3( ), szElements, index.begin( ), cl_code,
+            typename zip_column< typename RandomAccessIterator2::iterator3 >::category( ) );
+    }
+
     // Wrapper that uses default control class, iterator interface
     template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
     void stablesort_by_key_detect_random_access( control &ctl,
@@ -33,7 +33,9 @@
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
 #include "bolt/cl/iterator/permutation_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
+#include "bolt/cl/dispatch.h"
 
 namespace bolt {
 namespace cl {
@@ -103,7 +105,7 @@ namespace serial{
         size_t sz = (last1 - first1);
         if (sz == 0)
             return;
-        for(int index=0; index < (int)(sz); index++)
+        for(size_t index=0; index < sz; index++)
         {
             *(result + index) = f( *(first1+index), *(first2+index) );
         }
@@ -163,7 +165,7 @@ namespace serial{
         size_t sz = (last - first);
         if (sz == 0)
             return;
-        for(int index=0; index < (int)(sz); index++)
+        for(size_t index=0; index < sz; index++)
         {
             *(result + index) = f( *(first+index) );
         }
@@ -303,6 +305,56 @@ namespace cl{
 
 
 
+    /*! \brief The global pointers a kernel takes for an iterator, one per buffer it reads or writes
+        \detail Most iterators take one, named by their base_type; a permutation_iterator adds its index buffer and
+        a zip_iterator one buffer per column.
+    */
+    template< typename Iterator, typename Category = typename std::iterator_traits< Iterator >::iterator_category >
+    struct KernelPointers
+    {
+        static int size( )
+        {
+            return 1;
+        }
+
+        static std::string type( int )
+        {
+            return "base_type";
+        }
+    };
+
+    template< typename Iterator >
+    struct KernelPointers< Iterator, bolt::cl::permutation_iterator_tag >
+    {
+        static int size( )
+        {
+            return 2;
+        }
+
+        static std::string type( int ptr_num )
+        {
+            return ptr_num ? "index_type" : "base_type";
+        }
+    };
+
+    template< typename Iterator >
+    struct KernelPointers< Iterator, bolt::cl::zip_iterator_tag >
+    {
+        static int size( )
+        {
+            return Iterator::columns;
+        }
+
+        static std::string type( int ptr_num )
+        {
+            std::ostringstream oss;
+            oss << "base_type";
+            if( ptr_num )
+                oss << ptr_num;
+            return oss.str( );
+        }
+    };
+
     class KernelParameterStrings
     {
     private:
@@ -313,37 +365,39 @@ namespace cl{
             return oss.str();
         }
         public:
-            std::string getInputIteratorString(bolt::cl::permutation_iterator_tag, const ::std::string& itrStr, int itr_num ) const 
+            //  Declares the pointers of Iterator as kernel parameters prefix_ptr_0, prefix_ptr_1, ...
+            template< typename Iterator >
+            std::string getPointerParams( const ::std::string& itrStr, const ::std::string& prefix ) const
             {
-                return "global " + itrStr  + "::base_type* in" + toString(itr_num) + "_ptr_0,\n"
-                       "global " + itrStr  + "::index_type* in" + toString(itr_num) + "_ptr_1,\n"
-                       + itrStr + " input" + toString(itr_num) + "_iter,\n";
-            }
-            std::string getInputIteratorString(bolt::cl::counting_iterator_tag, const ::std::string& itrStr, int itr_num ) const 
-            {
-                return "global " + itrStr  + "::base_type* in" + toString(itr_num) + "_ptr_0,\n"
-                       + itrStr + " input" + toString(itr_num) + "_iter,\n";
+                std::string params;
+                for( int ptr_num = 0; ptr_num < KernelPointers< Iterator >::size( ); ++ptr_num )
+                    params += "global " + itrStr + "::" + KernelPointers< Iterator >::type( ptr_num ) + "* "
+                              + prefix + "_ptr_" + toString( ptr_num ) + ",\n";
+                return params;
             }
-            std::string getInputIteratorString(bolt::cl::constant_iterator_tag, const ::std::string& itrStr, int itr_num )       const  
+
+            //  Hands the pointers declared by getPointerParams to the iterator
+            template< typename Iterator >
+            std::string getInitCall( const ::std::string& iterName, const ::std::string& prefix ) const
             {
-                return "global " + itrStr  + "::base_type* in" + toString(itr_num) + "_ptr_0,\n"
-                       + itrStr + " input" + toString(itr_num) + "_iter,\n";
+                std::string call = "    " + iterName + ".init( ";
+                for( int ptr_num = 0; ptr_num < KernelPointers< Iterator >::size( ); ++ptr_num )
+                    call += ( ptr_num ? ", " : "" ) + prefix + "_ptr_" + toString( ptr_num );
+                return call + " );\n";
             }
-            std::string getInputIteratorString(bolt::cl::device_vector_tag, const ::std::string& itrStr, int itr_num ) const 
+
+            template< typename Iterator >
+            std::string getInputIteratorString( const ::std::string& itrStr, int itr_num ) const
             {
-                return "global " + itrStr  + "::base_type* in" + toString(itr_num) + "_ptr_0,\n"
+                return getPointerParams< Iterator >( itrStr, "in" + toString( itr_num ) )
                        + itrStr + " input" + toString(itr_num) + "_iter,\n";
             }
-            std::string getInputIteratorString(bolt::cl::transform_iterator_tag, const ::std::string& itrStr, int itr_num ) const 
-            {
-                return "global " + itrStr  + "::base_type* in" + toString(itr_num) + "_ptr_0,\n"
-                       + itrStr + " input" + toString(itr_num) + "_iter,\n";    
-            }
 
-            std::string getOutputIteratorString(bolt::cl::device_vector_tag, const ::std::string& itrStr ) const 
+            template< typename Iterator >
+            std::string getOutputIteratorString( const ::std::string& itrStr ) const
             {
-                return "global " + itrStr  + "::base_type* out_ptr_0,\n"
-                       + itrStr + " output_iter,\n";    
+                return getPointerParams< Iterator >( itrStr, "out" )
+                       + itrStr + " output_iter,\n";
             }
     };
 
@@ -365,24 +419,18 @@ namespace cl{
                 "// Host generates this instantiation string with user-specified value type and functor\n"
                 "template __attribute__((mangled_name("+name( 0 )+"Instantiated)))\n"
                 "kernel void "+name(0)+"(\n"
-                + kps.getInputIteratorString(typename std::iterator_traits<InputIterator1>::iterator_category(), 
-                                         binaryTransformKernels[transform_DVInputIterator1], 1 )
-                + kps.getInputIteratorString(typename std::iterator_traits<InputIterator2>::iterator_category(), 
-                                         binaryTransformKernels[transform_DVInputIterator2], 2 )
-                + kps.getOutputIteratorString(typename std::iterator_traits<OutputIterator>::iterator_category(), 
-                                          binaryTransformKernels[transform_DVOutputIteratorB] )
+                + kps.getInputIteratorString< InputIterator1 >( binaryTransformKernels[transform_DVInputIterator1], 1 )
+                + kps.getInputIteratorString< InputIterator2 >( binaryTransformKernels[transform_DVInputIterator2], 2 )
+                + kps.getOutputIteratorString< OutputIterator >( binaryTransformKernels[transform_DVOutputIteratorB] )
                 + "const uint length,\n"
                 "global " + binaryTransformKernels[transform_BinaryFunction] + "* userFunctor);\n\n"
 
                 "// Host generates this instantiation string with user-specified value type and functor\n"
                 "template __attribute__((mangled_name("+name(1)+"Instantiated)))\n"
                 "kernel void "+name(1)+"(\n"
-                + kps.getInputIteratorString(typename std::iterator_traits<InputIterator1>::iterator_category(), 
-                                         binaryTransformKernels[transform_DVInputIterator1], 1)
-                + kps.getInputIteratorString(typename std::iterator_traits<InputIterator2>::iterator_category(), 
-                                         binaryTransformKernels[transform_DVInputIterator2], 2)
-                + kps.getOutputIteratorString(typename std::iterator_traits<OutputIterator>::iterator_category(), 
-                                          binaryTransformKernels[transform_DVOutputIteratorB])
+                + kps.getInputIteratorString< InputIterator1 >( binaryTransformKernels[transform_DVInputIterator1], 1)
+                + kps.getInputIteratorString< InputIterator2 >( binaryTransformKernels[transform_DVInputIterator2], 2)
+                + kps.getOutputIteratorString< OutputIterator >( binaryTransformKernels[transform_DVOutputIteratorB])
                 + "const uint length,\n"
                 "global " + binaryTransformKernels[transform_BinaryFunction] + "* userFunctor);\n\n";
 
@@ -396,35 +444,19 @@ namespace cl{
                 "template <typename iIterType1, typename iIterType2, typename oIterType, typename unary_function > \n"
                 "kernel \n"
                 "void transformNoBoundsCheckTemplate( \n"
-                "    global typename iIterType1::base_type* in1_ptr_0, \n"; 
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator1>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "    global typename iIterType1::index_type* in1_ptr_1, \n";
-                return_string += 
+                + kps.getPointerParams< InputIterator1 >( "typename iIterType1", "in1" ) +
                 "    iIterType1 in1_iter,\n"
-                "    global typename iIterType2::base_type* in2_ptr_0, \n"; 
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator2>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "    global typename iIterType2::index_type* in2_ptr_1, \n";
-                return_string += 
+                + kps.getPointerParams< InputIterator2 >( "typename iIterType2", "in2" ) +
                 "    iIterType2 in2_iter,\n"
-                "    global typename oIterType::base_type* out_ptr_0,\n"
+                + kps.getPointerParams< OutputIterator >( "typename oIterType", "out" ) +
                 "    oIterType Z_iter,\n"
 			    "    const uint length,\n"
                 "    global unary_function* userFunctor)\n"
                 "{\n"
-                "\n";
-
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator1>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "in1_iter.init( in1_ptr_0, in1_ptr_1 );\n";
-                else
-                    return_string += "in1_iter.init( in1_ptr_0);\n";
-
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator2>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "in2_iter.init( in2_ptr_0, in2_ptr_1 );\n";
-                else
-                    return_string += "in2_iter.init( in2_ptr_0);\n";
-                return_string += 
-    
-                "    Z_iter.init( out_ptr_0 ); \n"
+                "\n"
+                + kps.getInitCall< InputIterator1 >( "in1_iter", "in1" )
+                + kps.getInitCall< InputIterator2 >( "in2_iter", "in2" )
+                + kps.getInitCall< OutputIterator >( "Z_iter", "out" ) +
                 "    int gx = get_global_id( 0 ); \n"
                 "    typename iIterType1::value_type aa = in1_iter[ gx ];\n"
                 "    typename iIterType2::value_type bb = in2_iter[ gx ];\n"
@@ -439,35 +471,19 @@ namespace cl{
                 "template <typename iIterType1, typename iIterType2, typename oIterType, typename unary_function > \n"
                 "kernel \n"
                 "void transformTemplate( \n"
-                "    global typename iIterType1::base_type* in1_ptr_0, \n"; 
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator1>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "    global typename iIterType1::index_type* in1_ptr_1, \n";
-                return_string += 
+                + kps.getPointerParams< InputIterator1 >( "typename iIterType1", "in1" ) +
                 "    iIterType1 in1_iter,\n"
-                "    global typename iIterType2::base_type* in2_ptr_0, \n"; 
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator2>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "    global typename iIterType2::index_type* in2_ptr_1, \n";
-                return_string += 
+                + kps.getPointerParams< InputIterator2 >( "typename iIterType2", "in2" ) +
                 "    iIterType2 in2_iter,\n"
-                "    global typename oIterType::base_type* out_ptr_0,\n"
+                + kps.getPointerParams< OutputIterator >( "typename oIterType", "out" ) +
                 "    oIterType Z_iter,\n"
 			    "    const uint length,\n"
                 "    global unary_function* userFunctor)\n"
                 "{\n"
-                "\n";
-
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator1>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "in1_iter.init( in1_ptr_0, in1_ptr_1 );\n";
-                else
-                    return_string += "in1_iter.init( in1_ptr_0);\n";
-
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator2>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "in2_iter.init( in2_ptr_0, in2_ptr_1 );\n";
-                else
-                    return_string += "in2_iter.init( in2_ptr_0);\n";
-                return_string += 
-    
-                "    Z_iter.init( out_ptr_0 ); \n"
+                "\n"
+                + kps.getInitCall< InputIterator1 >( "in1_iter", "in1" )
+                + kps.getInitCall< InputIterator2 >( "in2_iter", "in2" )
+                + kps.getInitCall< OutputIterator >( "Z_iter", "out" ) +
                 "    int gx = get_global_id( 0 ); \n"
                 "    if (gx >= length) \n"
                 "       return; \n"
@@ -497,20 +513,16 @@ namespace cl{
                 "// Host generates this instantiation string with user-specified value type and functor\n"
                 "template __attribute__((mangled_name("+name( 0 )+"Instantiated)))\n"
                 "kernel void unaryTransformTemplate(\n"
-                + kps.getInputIteratorString(typename std::iterator_traits<InputIterator>::iterator_category(), 
-                                         unaryTransformKernels[transform_DVInputIterator], 1 )
-                + kps.getOutputIteratorString(typename std::iterator_traits<OutputIterator>::iterator_category(), 
-                                          unaryTransformKernels[transform_DVOutputIteratorU] )
+                + kps.getInputIteratorString< InputIterator >( unaryTransformKernels[transform_DVInputIterator], 1 )
+                + kps.getOutputIteratorString< OutputIterator >( unaryTransformKernels[transform_DVOutputIteratorU] )
                 + "const uint length,\n"
                 "global " + unaryTransformKernels[transform_UnaryFunction] + "* userFunctor);\n\n"
 
                 "// Host generates this instantiation string with user-specified value type and functor\n"
                 "template __attribute__((mangled_name("+name(1)+"Instantiated)))\n"
                 "kernel void unaryTransformNoBoundsCheckTemplate(\n"
-                + kps.getInputIteratorString(typename std::iterator_traits<InputIterator>::iterator_category(), 
-                                         unaryTransformKernels[transform_DVInputIterator], 1)
-                + kps.getOutputIteratorString(typename std::iterator_traits<OutputIterator>::iterator_category(), 
-                                          unaryTransformKernels[transform_DVOutputIteratorU])
+                + kps.getInputIteratorString< InputIterator >( unaryTransformKernels[transform_DVInputIterator], 1)
+                + kps.getOutputIteratorString< OutputIterator >( unaryTransformKernels[transform_DVOutputIteratorU])
                 + "const uint length,\n"
                 "global " +unaryTransformKernels[transform_UnaryFunction] + "* userFunctor);\n\n";
 
@@ -523,25 +535,17 @@ namespace cl{
                 "template <typename iIterType, typename oIterType, typename unary_function > \n"
                 "kernel \n"
                 "void unaryTransformNoBoundsCheckTemplate( \n"
-                "    global typename iIterType::base_type* in0_ptr_0, \n"; 
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "    global typename iIterType::index_type* in0_ptr_1, \n";
-                return_string += 
+                + kps.getPointerParams< InputIterator >( "typename iIterType", "in0" ) +
                 "    iIterType A_iter,\n"
-                "    global typename oIterType::base_type* out_ptr_0,\n"
+                + kps.getPointerParams< OutputIterator >( "typename oIterType", "out" ) +
                 "    oIterType Z_iter,\n"
 			    "    const uint length,\n"
                 "    global unary_function* userFunctor)\n"
                 "{\n"
-                "\n";
-
-                if( std::is_same<typename bolt::cl::iterator_traits<InputIterator>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "A_iter.init( in0_ptr_0, in0_ptr_1 );\n";
-                else
-                    return_string += "A_iter.init( in0_ptr_0);\n";
-                return_string += 
-                "    Z_iter.init( out_ptr_0 ); \n"
-                "    int gx = get_global_id( 0 );   printf(\"%d , gx  \");\n"
+                "\n"
+                + kps.getInitCall< InputIterator >( "A_iter", "in0" )
+                + kps.getInitCall< OutputIterator >( "Z_iter", "out" ) +
+                "    int gx = get_global_id( 0 );\n"
                 "    typename iIterType::value_type aa = A_iter[ gx ];\n"
                 "    Z_iter[ gx ] = (*userFunctor)( aa );\n"
                 "}\n";
@@ -554,23 +558,16 @@ namespace cl{
                 "template <typename iIterType, typename oIterType, typename unary_function > \n"
                 "kernel \n"
                 "void unaryTransformTemplate( \n"
-                "    global typename iIterType::base_type* in0_ptr_0, \n"; 
-                if( std::is_same<typename std::iterator_traits<InputIterator>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "    global typename iIterType::index_type* in0_ptr_1, \n";
-                return_string += 
+                + kps.getPointerParams< InputIterator >( "typename iIterType", "in0" ) +
                 "    iIterType A_iter,\n"
-                "    global typename oIterType::base_type* out_ptr_0,\n"
+                + kps.getPointerParams< OutputIterator >( "typename oIterType", "out" ) +
                 "    oIterType Z_iter,\n"
 			    "    const uint length,\n"
                 "    global unary_function* userFunctor)\n"
                 "{\n"
-                "\n";
-                if(std::is_same<typename std::iterator_traits<InputIterator>::iterator_category, typename bolt::cl::permutation_iterator_tag>::value == true)
-                    return_string += "A_iter.init( in0_ptr_0, in0_ptr_1 );\n";
-                else
-                    return_string += "A_iter.init( in0_ptr_0);\n";
-                return_string += 
-                "    Z_iter.init( out_ptr_0 ); \n"
+                "\n"
+                + kps.getInitCall< InputIterator >( "A_iter", "in0" )
+                + kps.getInitCall< OutputIterator >( "Z_iter", "out" ) +
                 "    int gx = get_global_id( 0 );\n"
 	            "    if (gx >= length)\n"
 		        "        return;\n"
@@ -588,7 +585,8 @@ namespace cl{
     typename std::enable_if< 
                std::is_same< typename std::iterator_traits< OutputIterator >::iterator_category ,
                                        bolt::cl::device_vector_tag
-                           >::value
+                           >::value ||
+               is_device_zip_iterator< OutputIterator >::value
                            >::type
     binary_transform( ::bolt::cl::control &ctl, const InputIterator1& first1, const InputIterator1& last1,
                       const InputIterator2& first2, const OutputIterator& result, const BinaryFunction& f, 
@@ -673,7 +671,7 @@ namespace cl{
           * Request Compiled Kernels
           *********************************************************************************/
          Transform_KernelTemplateSpecializer<InputIterator1, InputIterator2, OutputIterator> ts_kts;
-         std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+         bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
              ctl,
              binaryTransformKernels,
              &ts_kts,
@@ -684,8 +682,7 @@ namespace cl{
 
 
         ALIGNED( 256 ) BinaryFunction aligned_binary( f );
-        control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
-        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_binary );
 
         typename InputIterator1::Payload first1_payload = first1.gpuPayload( );
         typename InputIterator2::Payload first2_payload = first2.gpuPayload( );
@@ -709,8 +706,7 @@ namespace cl{
         kernels[boundsCheck].setArg(arg_num, result.gpuPayloadSize( ),&result_payload);
         arg_num++;
 
-        //The type cast to int is required because sz is of type size_t
-        kernels[boundsCheck].setArg(arg_num, (int)distVec );
+        kernels[boundsCheck].setArg(arg_num, deviceElements( distVec ) );
         kernels[boundsCheck].setArg(arg_num+1, *userFunctor);
 
 
@@ -754,9 +750,22 @@ namespace cl{
                       const InputIterator2& first2, const OutputIterator& result, const BinaryFunction& f, 
                       const std::string& user_code )
     {
-        int sz = static_cast<int>(last1 - first1);
-        if (sz == 0)
+        size_t length = static_cast< size_t >( last1 - first1 );
+        if (length == 0)
+            return;
+
+        //  device_vector and the transform kernel index in 32 bits, so a longer range is transformed a slice at a time
+        if( length > maxDeviceElements )
+        {
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                size_t sliceLength = std::min( maxDeviceElements, length - offset );
+                cl::binary_transform( ctl, first1 + offset, first1 + ( offset + sliceLength ), first2 + offset,
+                    result + offset, f, user_code );
+            }
             return;
+        }
+        int sz = static_cast< int >( length );
         typedef typename std::iterator_traits<InputIterator1>::value_type  iType1;
         typedef typename std::iterator_traits<InputIterator2>::value_type  iType2;
         typedef typename std::iterator_traits<OutputIterator>::value_type  oType;
@@ -795,7 +804,8 @@ namespace cl{
     template<typename InputIterator, typename OutputIterator, typename UnaryFunction>
     typename std::enable_if< std::is_same< typename std::iterator_traits< OutputIterator >::iterator_category ,
                                        bolt::cl::device_vector_tag
-                                     >::value
+                                     >::value ||
+                             is_device_zip_iterator< OutputIterator >::value
                        >::type
     unary_transform( ::bolt::cl::control &ctl, const InputIterator& first, const InputIterator& last,
     const OutputIterator& result, const UnaryFunction& f, const std::string& user_code)
@@ -871,7 +881,7 @@ namespace cl{
          *********************************************************************************/
         TransformUnary_KernelTemplateSpecializer<InputIterator, OutputIterator> ts_kts;
         
-        std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
             ctl,
             unaryTransformKernels,
             &ts_kts,
@@ -882,8 +892,7 @@ namespace cl{
 
         // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
         ALIGNED( 256 ) UnaryFunction aligned_binary( f );
-        control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
-        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+        control::buffPointer userFunctor = ctl.acquireFunctorBuffer( aligned_binary );
 
         typename InputIterator::Payload  first_payload  = first.gpuPayload( );
         typename OutputIterator::Payload result_payload = result.gpuPayload( );
@@ -902,8 +911,7 @@ namespace cl{
         kernels[boundsCheck].setArg(arg_num, result.gpuPayloadSize( ),&result_payload);
         arg_num++;
 
-        //The type cast to int is required because sz is of type size_t
-        kernels[boundsCheck].setArg(arg_num, (int)sz );
+        kernels[boundsCheck].setArg(arg_num, deviceElements( sz ) );
         kernels[boundsCheck].setArg(arg_num+1, *userFunctor);
 
 
@@ -948,10 +956,22 @@ namespace cl{
     unary_transform( ::bolt::cl::control &ctl, const InputIterator& first, const InputIterator& last,
     const OutputIterator& result, const UnaryFunction& f, const std::string& user_code )
     {
-        //size_t sz = bolt::cl::distance(first, last);
-        int sz = static_cast<int>(last - first);
-        if (sz == 0)
+        size_t length = static_cast< size_t >( last - first );
+        if (length == 0)
+            return;
+
+        //  device_vector and the transform kernel index in 32 bits, so a longer range is transformed a slice at a time
+        if( length > maxDeviceElements )
+        {
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                size_t sliceLength = std::min( maxDeviceElements, length - offset );
+                cl::unary_transform( ctl, first + offset, first + ( offset + sliceLength ), result + offset, f,
+                    user_code );
+            }
             return;
+        }
+        int sz = static_cast< int >( length );
         typedef typename std::iterator_traits<InputIterator>::value_type  iType;
         typedef typename std::iterator_traits<OutputIterator>::value_type oType;
         
@@ -983,7 +1003,9 @@ namespace cl{
                              std::input_iterator_tag 
                            >::value ||
                std::is_same< typename std::iterator_traits< OutputIterator>::iterator_category, 
-                             bolt::cl::fancy_iterator_tag >::value) 
+                             bolt::cl::fancy_iterator_tag >::value ||
+               is_zip_iterator< InputIterator1 >::value || is_zip_iterator< InputIterator2 >::value ||
+               is_zip_iterator< OutputIterator >::value) 
                            >::type
     binary_transform(::bolt::cl::control& ctl, const InputIterator1& first1, const InputIterator1& last1, 
                      const InputIterator2& first2, const OutputIterator& result, const BinaryFunction& f,
@@ -993,11 +1015,11 @@ namespace cl{
         if (sz == 0)
             return;
 
-        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-        if(runMode == bolt::cl::control::Automatic)
-        {
-           runMode = ctl.getDefaultPathToRun();
-        }
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< typename std::iterator_traits< InputIterator1 >::value_type >( "binary_transform" ), sz,
+            detail::hostBytes( first1, sz ) + detail::hostBytes( first2, sz ) + detail::hostBytes( result, sz ),
+            detail::deviceBytes( first1, sz ) + detail::deviceBytes( first2, sz ) + detail::deviceBytes( result, sz ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
         #if defined(BOLT_DEBUG_LOG)
         BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
         #endif
@@ -1034,6 +1056,84 @@ namespace cl{
     }
     
 
+    /*! \brief This template function overload is used when any of the ranges is a zip_iterator.
+        \detail The columns are viewed in the memory of the chosen path: mapped to the host for the CPU paths,
+                and wrapped in device_vectors for the OpenCL path when they live in host memory.
+    */
+    template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename BinaryFunction>
+    typename std::enable_if< 
+               is_zip_iterator< InputIterator1 >::value || is_zip_iterator< InputIterator2 >::value ||
+               is_zip_iterator< OutputIterator >::value
+                           >::type
+    binary_transform(::bolt::cl::control& ctl, const InputIterator1& first1, const InputIterator1& last1, 
+                     const InputIterator2& first2, const OutputIterator& result, const BinaryFunction& f,
+                     const std::string& user_code)
+    {
+        size_t length = static_cast< size_t >( last1 - first1 );
+        if (length == 0)
+            return;
+
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< typename std::iterator_traits< InputIterator1 >::value_type >( "binary_transform" ),
+            length,
+            detail::hostBytes( first1, length ) + detail::hostBytes( first2, length )
+                + detail::hostBytes( result, length ),
+            detail::deviceBytes( first1, length ) + detail::deviceBytes( first2, length )
+                + detail::deviceBytes( result, length ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
+        #if defined(BOLT_DEBUG_LOG)
+        BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+        #endif
+
+        if( runMode == bolt::cl::control::SerialCpu )
+        {
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_TRANSFORM,BOLTLOG::BOLT_SERIAL_CPU,"::Transform::SERIAL_CPU");
+            #endif
+            host_view< InputIterator1 > in1( ctl, first1, length, CL_MAP_READ );
+            host_view< InputIterator2 > in2( ctl, first2, length, CL_MAP_READ );
+            host_view< OutputIterator > out( ctl, result, length, CL_MAP_WRITE );
+            typename host_view< InputIterator1 >::iterator hostFirst1 = in1.begin( );
+            typename host_view< InputIterator2 >::iterator hostFirst2 = in2.begin( );
+            typename host_view< OutputIterator >::iterator hostResult = out.begin( );
+            for( size_t index = 0; index < length; index++ )
+                *( hostResult + index ) = f( *( hostFirst1 + index ), *( hostFirst2 + index ) );
+            return;
+        }
+        else if( runMode == bolt::cl::control::MultiCoreCpu )
+        {
+#if defined( ENABLE_TBB )
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_TRANSFORM,BOLTLOG::BOLT_MULTICORE_CPU,"::Transform::MULTICORE_CPU");
+            #endif
+            host_view< InputIterator1 > in1( ctl, first1, length, CL_MAP_READ );
+            host_view< InputIterator2 > in2( ctl, first2, length, CL_MAP_READ );
+            host_view< OutputIterator > out( ctl, result, length, CL_MAP_WRITE );
+            bolt::btbb::transform( in1.begin( ), in1.begin( ) + length, in2.begin( ), out.begin( ), f );
+#else
+            throw std::runtime_error( "The MultiCoreCpu version of transform is not enabled to be built! \n" );
+#endif
+            return;
+        }
+        else
+        {
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_TRANSFORM,BOLTLOG::BOLT_OPENCL_GPU,"::Transform::OPENCL_GPU");
+            #endif
+            //  The columns are wrapped in device_vectors, which index in 32 bits, a slice at a time
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+                device_view< InputIterator1 > in1( ctl, first1 + offset, sz, true );
+                device_view< InputIterator2 > in2( ctl, first2 + offset, sz, true );
+                device_view< OutputIterator > out( ctl, result + offset, sz, false );
+                cl::binary_transform( ctl, in1.begin( ), in1.begin( ) + sz, in2.begin( ), out.begin( ), f, user_code );
+                out.sync( );
+            }
+            return;
+        }
+    }
+
     /*! \brief This template function overload is used to seperate input_iterator and fancy_iterator as 
                destination iterators from all other iterators
         \detail This template function overload is used to seperate input_iterator and fancy_iterator as 
@@ -1071,7 +1171,8 @@ namespace cl{
                              std::input_iterator_tag 
                            >::value ||
                std::is_same< typename std::iterator_traits< OutputIterator>::iterator_category, 
-                             bolt::cl::fancy_iterator_tag >::value) 
+                             bolt::cl::fancy_iterator_tag >::value ||
+               is_zip_iterator< InputIterator >::value || is_zip_iterator< OutputIterator >::value) 
                            >::type
     unary_transform(::bolt::cl::control& ctl, InputIterator& first,
          InputIterator& last,  OutputIterator& result,  UnaryFunction& f,
@@ -1081,11 +1182,11 @@ namespace cl{
         if (sz == 0)
             return;
 
-        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-        if(runMode == bolt::cl::control::Automatic)
-        {
-           runMode = ctl.getDefaultPathToRun();
-        }
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< typename std::iterator_traits< InputIterator >::value_type >( "unary_transform" ), sz,
+            detail::hostBytes( first, sz ) + detail::hostBytes( result, sz ),
+            detail::deviceBytes( first, sz ) + detail::deviceBytes( result, sz ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
         #if defined(BOLT_DEBUG_LOG)
         BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
         #endif
@@ -1122,6 +1223,74 @@ namespace cl{
     }
     
 
+    /*! \brief This template function overload is used when the input or the output is a zip_iterator.
+        \detail See the binary overload above.
+    */
+    template<typename InputIterator, typename OutputIterator, typename UnaryFunction>
+    typename std::enable_if< 
+               is_zip_iterator< InputIterator >::value || is_zip_iterator< OutputIterator >::value
+                           >::type
+    unary_transform(::bolt::cl::control& ctl, const InputIterator& first, const InputIterator& last,
+                    const OutputIterator& result, const UnaryFunction& f, const std::string& user_code)
+    {
+        size_t length = static_cast< size_t >( last - first );
+        if (length == 0)
+            return;
+
+        detail::AutomaticRunMode automatic( ctl,
+            detail::dispatchKey< typename std::iterator_traits< InputIterator >::value_type >( "unary_transform" ),
+            length, detail::hostBytes( first, length ) + detail::hostBytes( result, length ),
+            detail::deviceBytes( first, length ) + detail::deviceBytes( result, length ) );
+        bolt::cl::control::e_RunMode runMode = automatic.get( );
+        #if defined(BOLT_DEBUG_LOG)
+        BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+        #endif
+
+        if( runMode == bolt::cl::control::SerialCpu )
+        {
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_TRANSFORM,BOLTLOG::BOLT_SERIAL_CPU,"::Transform::SERIAL_CPU");
+            #endif
+            host_view< InputIterator > in( ctl, first, length, CL_MAP_READ );
+            host_view< OutputIterator > out( ctl, result, length, CL_MAP_WRITE );
+            typename host_view< InputIterator >::iterator hostFirst = in.begin( );
+            typename host_view< OutputIterator >::iterator hostResult = out.begin( );
+            for( size_t index = 0; index < length; index++ )
+                *( hostResult + index ) = f( *( hostFirst + index ) );
+            return;
+        }
+        else if( runMode == bolt::cl::control::MultiCoreCpu )
+        {
+#if defined( ENABLE_TBB )
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_TRANSFORM,BOLTLOG::BOLT_MULTICORE_CPU,"::Transform::MULTICORE_CPU");
+            #endif
+            host_view< InputIterator > in( ctl, first, length, CL_MAP_READ );
+            host_view< OutputIterator > out( ctl, result, length, CL_MAP_WRITE );
+            bolt::btbb::transform( in.begin( ), in.begin( ) + length, out.begin( ), f );
+#else
+            throw std::runtime_error( "The MultiCoreCpu version of transform is not enabled to be built! \n" );
+#endif
+            return;
+        }
+        else
+        {
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_TRANSFORM,BOLTLOG::BOLT_OPENCL_GPU,"::Transform::OPENCL_GPU");
+            #endif
+            //  See the binary overload above
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+                device_view< InputIterator > in( ctl, first + offset, sz, true );
+                device_view< OutputIterator > out( ctl, result + offset, sz, false );
+                cl::unary_transform( ctl, in.begin( ), in.begin( ) + sz, out.begin( ), f, user_code );
+                out.sync( );
+            }
+            return;
+        }
+    }
+
     /*! \brief This template function overload is used to seperate input_iterator and fancy_iterator as destination iterators from all other iterators
         \detail This template function overload is used to seperate input_iterator and fancy_iterator as destination iterators from all other iterators. 
                 We enable this overload and should result in a compilation failure.
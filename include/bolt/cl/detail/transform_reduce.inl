@@ -32,9 +32,12 @@
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/device_vector.h"
 #include "bolt/cl/transform.h"
 #include "bolt/cl/reduce.h"
+#include "bolt/cl/dispatch.h"
+#include "bolt/cl/tuning.h"
 
 namespace bolt {
 namespace cl {
@@ -98,10 +101,28 @@ namespace serial{
     {
 		          size_t szElements = (last - first);
 
-	              //Create a temporary array to store the transform result;
-                  std::vector<oType> output(szElements);
-                  std::transform(first, last, output.begin(),transform_op);
-                  return std::accumulate(output.begin(), output.end(), init, reduce_op);
+                  //  Each transformed element is folded in as it is formed, rather than staged in a vector as
+                  //  long as the range
+                  oType output = init;
+                  for( size_t index = 0; index < szElements; index++ )
+                      output = reduce_op( output, static_cast< oType >( transform_op( *( first + index ) ) ) );
+                  return output;
+    }
+
+	template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce(control& ctl,
+           const InputIterator& first,
+           const InputIterator& last,
+           const UnaryFunction& transform_op,
+           const oType& init,
+           const BinaryFunction& reduce_op,
+           const std::string& user_code,
+		   bolt::cl::zip_iterator_tag)
+    {
+        size_t n = static_cast< size_t >( last - first );
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        return serial::transform_reduce( ctl, input.begin( ), input.begin( ) + n, transform_op, init, reduce_op,
+            user_code, std::random_access_iterator_tag( ) );
     }
 
 } // end of serial
@@ -165,6 +186,21 @@ namespace btbb{
 		          return bolt::btbb::transform_reduce(first,last,transform_op,init,reduce_op);
     }
 
+	template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce(control& ctl,
+           const InputIterator& first,
+           const InputIterator& last,
+           const UnaryFunction& transform_op,
+           const oType& init,
+           const BinaryFunction& reduce_op,
+           const std::string& user_code,
+		   bolt::cl::zip_iterator_tag)
+    {
+        size_t n = static_cast< size_t >( last - first );
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        return bolt::btbb::transform_reduce( input.begin( ), input.begin( ) + n, transform_op, init, reduce_op );
+    }
+
 }//end of namespace btbb 
 #endif
 
@@ -173,23 +209,29 @@ namespace cl{
     enum transformReduceTypes {tr_iType, tr_iIterType, tr_oType, tr_UnaryFunction,
     tr_BinaryFunction, tr_end };
 
+    template< typename InputIterator >
     class TransformReduce_KernelTemplateSpecializer : public KernelTemplateSpecializer
     {
+        KernelParameterStrings kps;
     public:
        TransformReduce_KernelTemplateSpecializer() : KernelTemplateSpecializer()
         {
-            addKernelName("transform_reduceTemplate");
+            addKernelName( is_zip_iterator< InputIterator >::value ? "transform_reduceZipTemplate"
+                                                                   : "transform_reduceTemplate" );
         }
 
         const ::std::string operator() ( const ::std::vector< ::std::string>& typeNames ) const
         {
+            const std::string inputParams = is_zip_iterator< InputIterator >::value
+                ? kps.getPointerParams< InputIterator >( typeNames[tr_iIterType], "input" )
+                : "global " + typeNames[tr_iType] + "* input_ptr,\n";
 
             const std::string templateSpecializationString =
                 "// Host generates this instantiation string with user-specified value type and functor\n"
                 "template __attribute__((mangled_name("+name(0)+"Instantiated)))\n"
-                "__attribute__((reqd_work_group_size(256,1,1)))\n"
+                "__attribute__((reqd_work_group_size(REDUCE_WGSIZE,1,1)))\n"
                 "kernel void "+name(0)+"(\n"
-                "global " + typeNames[tr_iType] + "* input_ptr,\n"
+                + inputParams
                 + typeNames[tr_iIterType] + " iIter,\n"
                 "const int length,\n"
                 "global " + typeNames[tr_UnaryFunction] + "* transformFunctor,\n"
@@ -200,20 +242,43 @@ namespace cl{
                 ");\n\n";
                 return templateSpecializationString;
         }
+
+        //  A zip_iterator takes one buffer per column, so its kernel is generated here: it hands the column
+        //  pointers to the iterator and runs the transform_reduceRange of transform_reduce_kernels
+        const ::std::string getZipKernel( ) const
+        {
+            return
+                "template< typename iIterType, typename oNakedType, typename unary_function,\n"
+                "    typename binary_function >\n"
+                "kernel void transform_reduceZipTemplate(\n"
+                + kps.getPointerParams< InputIterator >( "typename iIterType", "input" ) +
+                "    iIterType input_iter,\n"
+                "    const int length,\n"
+                "    global unary_function* transformFunctor,\n"
+                "    const oNakedType init,\n"
+                "    global binary_function* reduceFunctor,\n"
+                "    global oNakedType* result_ptr,\n"
+                "    local oNakedType* scratch)\n"
+                "{\n"
+                + kps.getInitCall< InputIterator >( "input_iter", "input" ) +
+                "    transform_reduceRange< typename iIterType::value_type >( input_iter, length, transformFunctor,\n"
+                "        init, reduceFunctor, result_ptr, scratch );\n"
+                "}\n";
+        }
     };
 
+    /*! \brief Runs the transform_reduce kernel over a device range with one launch shape, finishing the reduction
+        on the host
+    */
 	template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
-    oType transform_reduce(control& ctl,
+    oType transform_reduce_enqueue(control& ctl,
         const InputIterator& first,
-        const InputIterator& last,
+        cl_uint szElements,
         const UnaryFunction& transform_op,
         const oType& init,
         const BinaryFunction& reduce_op,
-        const std::string& user_code,
-		bolt::cl::device_vector_tag)
+        const WorkShape& shape)
     {
-        unsigned debugMode = 0; //FIXME, use control
-
         typedef typename std::iterator_traits< InputIterator  >::value_type iType;
 
         /**********************************************************************************
@@ -241,37 +306,32 @@ namespace cl{
             *********************************************************************************/
 
         // Set up shape of launch grid and buffers:
-        // FIXME, read from device attributes.
-
         int computeUnits     = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();// round up if we don't know.
-        int wgPerComputeUnit =  64;//ctl.getWGPerComputeUnit();
-
-        int numWG = computeUnits * wgPerComputeUnit;
+        int numWG = computeUnits * static_cast< int >( shape.wgPerComputeUnit );
 
         cl_int l_Error = CL_SUCCESS;
-		const size_t wgSize = WAVEFRONT_SIZE_REDUCE;
-        V_OPENCL( l_Error, "Error querying kernel for CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE" );
+        const size_t wgSize = shape.wgSize;
 
         /**********************************************************************************
             * Compile Options
             *********************************************************************************/
-        bool cpuDevice = ctl.getDevice().getInfo<CL_DEVICE_TYPE>() == CL_DEVICE_TYPE_CPU;
-        const size_t kernel_WgSize = (cpuDevice) ? 1 : wgSize;
-        std::string compileOptions;
+        //  The shape is part of the compile options, so every shape gets its own program and kernel cache entry
         std::ostringstream oss;
-        oss << " -DKERNELWORKGROUPSIZE=" << kernel_WgSize;
-        compileOptions = oss.str();
+        oss << " -DREDUCE_WGSIZE=" << wgSize << " -DREDUCE_UNROLL=" << shape.unroll;
+        std::string compileOptions = oss.str();
 
         /**********************************************************************************
             * Request Compiled Kernels
             *********************************************************************************/
-        TransformReduce_KernelTemplateSpecializer ts_kts;
-        std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+        TransformReduce_KernelTemplateSpecializer< InputIterator > ts_kts;
+        const std::string zipKernels = is_zip_iterator< InputIterator >::value
+            ? transform_reduce_kernels + ts_kts.getZipKernel( ) : std::string( );
+        bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
             ctl,
             typeNames,
             &ts_kts,
             typeDefinitions,
-            transform_reduce_kernels,
+            is_zip_iterator< InputIterator >::value ? zipKernels : transform_reduce_kernels,
             compileOptions);
         // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
@@ -280,15 +340,11 @@ namespace cl{
         ALIGNED( 256 ) UnaryFunction aligned_unary( transform_op );
         ALIGNED( 256 ) BinaryFunction aligned_binary( reduce_op );
 
-        control::buffPointer transformFunctor = ctl.acquireBuffer( sizeof( aligned_unary ),
-                                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_unary );
-        control::buffPointer reduceFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
-                                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+        control::buffPointer transformFunctor = ctl.acquireFunctorBuffer( aligned_unary );
+        control::buffPointer reduceFunctor = ctl.acquireFunctorBuffer( aligned_binary );
         control::buffPointer result = ctl.acquireBuffer( sizeof( oType ) * numWG,
                                                 CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
 
-        cl_uint szElements = static_cast< cl_uint >( std::distance( first, last ) );
-
         /***** This is a temporaray fix *****/
 
         /*What if  requiredWorkGroups > numWG? Do you want to loop or increase the work group size
@@ -301,19 +357,19 @@ namespace cl{
 
         typename  InputIterator::Payload first_payload = first.gpuPayload( ) ;
 
-        V_OPENCL( kernels[0].setArg( 0, first.base().getContainer().getBuffer() ), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg( 1, first.gpuPayloadSize( ),&first_payload),
+        int arg_num = setRangeBuffers( kernels[0], 0, first );
+        V_OPENCL( kernels[0].setArg( arg_num++, first.gpuPayloadSize( ),&first_payload),
                                                         "Error setting kernel argument" );
 
-        V_OPENCL( kernels[0].setArg( 2, szElements), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg( 3, *transformFunctor), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg( 4, init), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg( 5, *reduceFunctor), "Error setting kernel argument" );
-        V_OPENCL( kernels[0].setArg( 6, *result), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( arg_num++, szElements), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( arg_num++, *transformFunctor), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( arg_num++, init), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( arg_num++, *reduceFunctor), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( arg_num++, *result), "Error setting kernel argument" );
 
         ::cl::LocalSpaceArg loc;
         loc.size_ = wgSize*sizeof(oType);
-        V_OPENCL( kernels[0].setArg( 7, loc ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( arg_num, loc ), "Error setting kernel argument" );
 
         l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
             kernels[0],
@@ -351,6 +407,34 @@ namespace cl{
         return acc;
     }
 
+    /*! \brief This template function overload is used strictly for device vectors and OpenCL implementations.
+        \detail The launch shape comes from the tuning database, or from a sweep under control::AutoTuneWorkShape;
+        untuned, it is 256 work items, 64 work groups per compute unit and the control's unroll factor.
+    */
+	template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce(control& ctl,
+        const InputIterator& first,
+        const InputIterator& last,
+        const UnaryFunction& transform_op,
+        const oType& init,
+        const BinaryFunction& reduce_op,
+        const std::string& user_code,
+		bolt::cl::device_vector_tag)
+    {
+        typedef typename std::iterator_traits< InputIterator  >::value_type iType;
+
+        cl_uint szElements = deviceElements( std::distance( first, last ) );
+        if( szElements == 0 )
+            return init;
+
+        WorkShape defaults = { WAVEFRONT_SIZE_REDUCE, 64, ctl.getUnroll( ) };
+        WorkShape shape = detail::tunedWorkShape( ctl, "transform_reduce", sizeof( iType ), defaults,
+            [ & ]( const WorkShape& candidate )
+            { transform_reduce_enqueue( ctl, first, szElements, transform_op, init, reduce_op, candidate ); } );
+
+        return transform_reduce_enqueue( ctl, first, szElements, transform_op, init, reduce_op, shape );
+    }
+
 
 
 	template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
@@ -363,9 +447,25 @@ namespace cl{
         const std::string& user_code,
 		std::random_access_iterator_tag)
     {
-        int sz = static_cast<int>(last - first);
-        if (sz == 0)
+        size_t length = static_cast< size_t >( last - first );
+        if (length == 0)
             return init;
+
+        //  device_vector and the kernel index in 32 bits, so a longer range is reduced a slice at a time, each
+        //  slice starting from the result of the ones before it
+        if( length > maxDeviceElements )
+        {
+            oType acc = init;
+            for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+            {
+                InputIterator sliceFirst = first + offset;
+                InputIterator sliceLast = sliceFirst + std::min( maxDeviceElements, length - offset );
+                acc = transform_reduce( ctl, sliceFirst, sliceLast, transform_op, acc, reduce_op, user_code,
+                    std::random_access_iterator_tag( ) );
+            }
+            return acc;
+        }
+        int sz = static_cast< int >( length );
         typedef typename std::iterator_traits<InputIterator>::value_type  iType;
        	          
         typedef typename bolt::cl::iterator_traits<InputIterator>::pointer pointer;
@@ -403,6 +503,34 @@ namespace cl{
                                 typename bolt::cl::memory_system<InputIterator>::type() );  
     }
 
+	/*! \brief This template function overload is used for zip_iterator and OpenCL implementations.
+        \detail The kernel takes each column as its own buffer and builds the tuples as it reads them; host columns
+        are wrapped in device buffers first.
+    */
+	template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce(control& ctl,
+        const InputIterator& first,
+        const InputIterator& last,
+        const UnaryFunction& transform_op,
+        const oType& init,
+        const BinaryFunction& reduce_op,
+        const std::string& user_code,
+		bolt::cl::zip_iterator_tag)
+    {
+        size_t length = static_cast< size_t >( last - first );
+
+        //  Sliced like the random access overload, each slice starting from the result of the ones before it
+        oType acc = init;
+        for( size_t offset = 0; offset < length; offset += maxDeviceElements )
+        {
+            int sz = static_cast< int >( std::min( maxDeviceElements, length - offset ) );
+            device_view< InputIterator > input( ctl, first + offset, sz, true );
+            acc = cl::transform_reduce( ctl, input.begin( ), input.begin( ) + sz, transform_op, acc, reduce_op,
+                user_code, typename bolt::cl::device_vector_tag( ) );
+        }
+        return acc;
+    }
+
 } // end of namespace cl
 
     // Wrapper that uses default control class, iterator interface
@@ -421,11 +549,11 @@ namespace cl{
                 if (szElements == 0)
                         return init;
 			      
-                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
-                if(runMode == bolt::cl::control::Automatic)
-                {
-                    runMode = ctl.getDefaultPathToRun();
-                }
+                detail::AutomaticRunMode automatic( ctl,
+                    detail::dispatchKey< iType >( "transform_reduce" ), szElements,
+                    detail::hostBytes( first, szElements ),
+                    detail::deviceBytes( first, szElements ) );
+                bolt::cl::control::e_RunMode runMode = automatic.get( );
 			    #if defined(BOLT_DEBUG_LOG)
                 BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
                 #endif
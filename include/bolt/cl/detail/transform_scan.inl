@@ -40,6 +40,7 @@
 #include "bolt/cl/distance.h"
 #include "bolt/cl/iterator/iterator_traits.h"
 #include "bolt/cl/iterator/transform_iterator.h"
+#include "bolt/cl/iterator/zip_iterator.h"
 #include "bolt/cl/iterator/addressof.h"
 
 
@@ -193,7 +194,7 @@ namespace serial{
           sum = binary_op( *result, temp);  
         }
 
-        for ( unsigned int index= 1; index<sz; index++)
+        for ( size_t index= 1; index<sz; index++)
         {
           oType currentValue =  static_cast<oType>(unary_op( *(first + index) ) ); // convertible
           if (inclusive)
@@ -304,7 +305,7 @@ namespace btbb{
     {
         // TODO - Add tbb host vector code.
         bolt::btbb::transform(first, last, result, unary_op);
-        int sz = static_cast<int>( std::distance (first, last));
+        size_t sz = std::distance( first, last );
         if (sz == 0)
             return;
 		if(inclusive)
@@ -384,6 +385,122 @@ namespace cl{
         }
     };
 
+    class TransformScanSinglePass_KernelTemplateSpecializer : public KernelTemplateSpecializer
+    {
+        public:
+        TransformScanSinglePass_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+        {
+            addKernelName("singlePassTransformScan");
+        }
+
+        const ::std::string operator() ( const ::std::vector< ::std::string>& typeNames ) const
+        {
+                const std::string templateSpecializationString =
+                "// Dynamic specialization of generic template definition, using user supplied types\n"
+                "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+                "__kernel void " + name(0) + "(\n"
+                "global " + typeNames[transformScan_oValueType] + "* output_ptr,\n"
+                ""        + typeNames[transformScan_oIterType] + " output_iter,\n"
+                "global " + typeNames[transformScan_iValueType] + "* input_ptr,\n"
+                ""        + typeNames[transformScan_iIterType] + " input_iter,\n"
+                ""        + typeNames[transformScan_initType] + " init,\n"
+                "const uint vecSize,\n"
+                "local "  + typeNames[transformScan_oValueType] + "* ldsTile,\n"
+                "local "  + typeNames[transformScan_oValueType] + "* ldsSums,\n"
+                "global " + typeNames[transformScan_UnaryFunction] + "* unaryOp,\n"
+                "global " + typeNames[transformScan_BinaryFunction] + "* binaryOp,\n"
+                "global uint* tileStatus,\n"
+                "global uint* tileAggregate,\n"
+                "global uint* tilePrefix\n"
+                ");\n\n";
+
+                return templateSpecializationString;
+        }
+    };
+
+//  One kernel that reads and writes every element once; transform_scan( ) takes this path when
+//  singlePassScanItems( ) says the device can run it
+    template
+	<
+    typename InputIterator,
+    typename OutputIterator,
+    typename UnaryFunction,
+    typename T,
+    typename BinaryFunction
+	>
+    void singlePassTransformScan(
+    control &ctl,
+    const InputIterator& first,
+    const InputIterator& last,
+    const OutputIterator& result,
+    const UnaryFunction& unary_op,
+    const T& init_T,
+    const bool& inclusive,
+    const BinaryFunction& binary_op,
+    const std::vector< std::string >& typeNames,
+    const std::vector< std::string >& typeDefinitions,
+    const cl_uint scanItems )
+    {
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    const cl_uint wgSize = WAVESIZE*KERNEL02WAVES;
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << wgSize;
+    oss << " -DSCAN_ITEMS=" << scanItems;
+    oss << " -DEXCLUSIVE=" << ( inclusive ? 0 : 1 );
+
+    TransformScanSinglePass_KernelTemplateSpecializer sp_kts;
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
+        ctl,
+        typeNames,
+        &sp_kts,
+        typeDefinitions,
+        transform_scan_kernels,
+        oss.str( ) );
+
+    cl_uint numElements = deviceElements( std::distance( first, last ) );
+    cl_uint tileSize = wgSize * scanItems;
+    cl_uint numTiles = numElements / tileSize + ( numElements % tileSize ? 1 : 0 );
+
+    ALIGNED( 256 ) UnaryFunction aligned_unary_op( unary_op );
+    control::buffPointer unaryBuffer = ctl.acquireFunctorBuffer( aligned_unary_op );
+    ALIGNED( 256 ) BinaryFunction aligned_binary_op( binary_op );
+    control::buffPointer binaryBuffer = ctl.acquireFunctorBuffer( aligned_binary_op );
+    control::buffPointer tileStatus = acquireScanTileStatus( ctl, numTiles );
+    control::buffPointer tileAggregate = ctl.acquireBuffer( numTiles * sizeof( oType ) );
+    control::buffPointer tilePrefix = ctl.acquireBuffer( numTiles * sizeof( oType ) );
+
+    typename OutputIterator::Payload result_payload = result.gpuPayload( );
+    typename InputIterator::Payload first_payload = first.gpuPayload( );
+
+    V_OPENCL( kernels[0].setArg( 0, result.getContainer().getBuffer()),      "Error setArg singlePassTransformScan" ); // Output buffer
+    V_OPENCL( kernels[0].setArg( 1, result.gpuPayloadSize( ), &result_payload ), "Error setting a kernel argument" );
+    V_OPENCL( kernels[0].setArg( 2, first.base().getContainer().getBuffer()), "Error setArg singlePassTransformScan" ); // Input buffer
+    V_OPENCL( kernels[0].setArg( 3, first.gpuPayloadSize( ), &first_payload ), "Error setting a kernel argument" );
+    V_OPENCL( kernels[0].setArg( 4, init_T ),                "Error setArg singlePassTransformScan" ); // Initial value for exclusive scan
+    V_OPENCL( kernels[0].setArg( 5, numElements ),           "Error setArg singlePassTransformScan" ); // Number of elements
+    V_OPENCL( kernels[0].setArg( 6, tileSize * sizeof( oType ), NULL ), "Error setArg singlePassTransformScan" ); // Tile
+    V_OPENCL( kernels[0].setArg( 7, ( wgSize + 1 ) * sizeof( oType ), NULL ), "Error setArg singlePassTransformScan" ); // Work item sums and carry
+    V_OPENCL( kernels[0].setArg( 8, *unaryBuffer ),          "Error setArg singlePassTransformScan" ); // Unary operator
+    V_OPENCL( kernels[0].setArg( 9, *binaryBuffer ),         "Error setArg singlePassTransformScan" ); // Binary operator
+    V_OPENCL( kernels[0].setArg( 10, *tileStatus ),          "Error setArg singlePassTransformScan" ); // Tile counter and status
+    V_OPENCL( kernels[0].setArg( 11, *tileAggregate ),       "Error setArg singlePassTransformScan" ); // Tile sums
+    V_OPENCL( kernels[0].setArg( 12, *tilePrefix ),          "Error setArg singlePassTransformScan" ); // Inclusive tile prefixes
+
+    ::cl::Event kernelEvent;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[0],
+        ::cl::NullRange,
+        ::cl::NDRange( numTiles * wgSize ),
+        ::cl::NDRange( wgSize ),
+        NULL,
+        &kernelEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for singlePassTransformScan" );
+
+    bolt::cl::wait( ctl, kernelEvent );
+    }
+
 //  All calls to transform_scan end up here, unless an exception was thrown
 //  This is the function that sets up the kernels to compile (once only) and execute
     template
@@ -446,6 +563,20 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     PUSH_BACK_UNIQUE( typeDefinitions, ClCode< UnaryFunction >::get() )
     PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction >::get() )
 
+    /**********************************************************************************
+     * Single pass scan, where the device supports it
+     *********************************************************************************/
+    cl_uint scanItems = singlePassScanItems( ctl, sizeof( oType ), sizeof( oType ), WAVESIZE*KERNEL02WAVES );
+    if( scanItems )
+    {
+        singlePassTransformScan( ctl, first, last, result, unary_op, init_T, inclusive, binary_op, typeNames,
+            typeDefinitions, scanItems );
+#ifdef BOLT_ENABLE_PROFILING
+aProfiler.stopTrial();
+#endif
+        return;
+    }
+
     /**********************************************************************************
      * Compile Options
      *********************************************************************************/
@@ -470,7 +601,7 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
      * Request Compiled Kernels
      *********************************************************************************/
     TransformScan_KernelTemplateSpecializer ts_kts;
-    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+    bolt::cl::PooledKernels kernels = bolt::cl::getKernels(
         ctl,
         typeNames,
         &ts_kts,
@@ -484,15 +615,13 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     // Set up shape of launch grid and buffers:
 
     //  Ceiling function to bump the size of input to the next whole wavefront size
-    cl_uint numElements = static_cast< cl_uint >( std::distance( first, last ) );
+    cl_uint numElements = deviceElements( std::distance( first, last ) );
     
     // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
     ALIGNED( 256 ) UnaryFunction aligned_unary_op( unary_op );
-    control::buffPointer unaryBuffer = ctl.acquireBuffer( sizeof( aligned_unary_op ),
-        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_unary_op);
+    control::buffPointer unaryBuffer = ctl.acquireFunctorBuffer( aligned_unary_op );
     ALIGNED( 256 ) BinaryFunction aligned_binary_op( binary_op );
-    control::buffPointer binaryBuffer = ctl.acquireBuffer( sizeof( aligned_binary_op ),
-        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_op );
+    control::buffPointer binaryBuffer = ctl.acquireFunctorBuffer( aligned_binary_op );
 
 	cl_uint computeUnits = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
 	unsigned int wgComputeUnit = (computeUnits*64); //64 boosts up the performance
@@ -735,7 +864,7 @@ aProfiler.setArchitecture(strDeviceName);
         typedef typename std::iterator_traits< OutputIterator >::value_type oType;
 	    
 	    
-        int numElements = static_cast< int >( std::distance( first, last ) );
+        int numElements = deviceElements( std::distance( first, last ) );
         if( numElements == 0 )
             return;
 	    
@@ -794,7 +923,9 @@ aProfiler.setArchitecture(strDeviceName);
         typedef typename std::iterator_traits< OutputIterator >::value_type oType;
 
 
-        unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
+        static_assert( !is_zip_iterator< InputIterator >::value && !is_zip_iterator< OutputIterator >::value,
+                       "transform_scan does not take zip_iterator ranges" );
+        size_t numElements = std::distance( first, last );
         if( numElements == 0 )
             return result;
 
@@ -0,0 +1,459 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_UNIQUE_INL )
+#define BOLT_CL_UNIQUE_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/copy.h"
+#include "bolt/cl/iterator/zip_iterator.h"
+
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/unique.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+//  Keeps the first key of every run of equal keys, and its value; the outputs may be the inputs
+template<typename KeysIterator, typename ValuesIterator, typename KeysOutputIterator, typename ValuesOutputIterator,
+         typename BinaryPredicate>
+size_t serial_unique_by_key( const KeysIterator& keys, const ValuesIterator& values, size_t n,
+    const KeysOutputIterator& keysOutput, const ValuesOutputIterator& valuesOutput, const BinaryPredicate& pred )
+{
+    size_t kept = 0;
+    for( size_t i = 0; i < n; ++i )
+    {
+        if( i == 0 || !pred( keys[ i - 1 ], keys[ i ] ) )
+        {
+            keysOutput[ kept ] = keys[ i ];
+            valuesOutput[ kept ] = values[ i ];
+            ++kept;
+        }
+    }
+    return kept;
+}
+
+template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+OutputIterator unique_copy( bolt::cl::control &ctl, const InputIterator& first, const InputIterator& last,
+    const OutputIterator& result, const BinaryPredicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator >::value && !is_zip_iterator< OutputIterator >::value,
+                   "unique_copy does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return result;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_SERIAL_CPU,"::Unique_Copy::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+        host_view< OutputIterator > output( ctl, result, n, CL_MAP_WRITE );
+        return result + ( std::unique_copy( input.begin( ), input.begin( ) + n, output.begin( ), pred )
+            - output.begin( ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_MULTICORE_CPU,"::Unique_Copy::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator > input( ctl, first, n, CL_MAP_READ );
+            host_view< OutputIterator > output( ctl, result, n, CL_MAP_WRITE );
+            return result + ( bolt::btbb::unique_copy( input.begin( ), input.begin( ) + n, output.begin( ), pred )
+                - output.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Unique_Copy is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_OPENCL_GPU,"::Unique_Copy::OPENCL_GPU");
+        #endif
+
+        //  Whether an element is kept depends on the one before it, so the range is not cut into slices
+        unsigned int length = deviceElements( n );
+        return result + compact( ctl, first, length, first, result, make_discard_iterator( ), false, first,
+            make_discard_iterator( ), pred, compact_keep_unique, user_code );
+    }
+}
+
+template<typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator unique( bolt::cl::control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+    const BinaryPredicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< ForwardIterator >::value,
+                   "unique does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( first, last ) );
+    if( n == 0 )
+        return first;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_SERIAL_CPU,"::Unique::SERIAL_CPU");
+        #endif
+
+        host_view< ForwardIterator > range( ctl, first, n, CL_MAP_READ | CL_MAP_WRITE );
+        return first + ( std::unique( range.begin( ), range.begin( ) + n, pred ) - range.begin( ) );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_MULTICORE_CPU,"::Unique::MULTICORE_CPU");
+            #endif
+
+            host_view< ForwardIterator > range( ctl, first, n, CL_MAP_READ | CL_MAP_WRITE );
+            return first + ( bolt::btbb::unique( range.begin( ), range.begin( ) + n, pred ) - range.begin( ) );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Unique is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_OPENCL_GPU,"::Unique::OPENCL_GPU");
+        #endif
+
+        unsigned int length = deviceElements( n );
+        compact_source< ForwardIterator > source( ctl, first, length );
+        return first + compact( ctl, source.begin( ), length, source.begin( ), first, make_discard_iterator( ),
+            false, source.begin( ), make_discard_iterator( ), pred, compact_keep_unique, user_code );
+    }
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+         typename BinaryPredicate>
+bolt::cl::pair<OutputIterator1, OutputIterator2> unique_by_key_copy( bolt::cl::control &ctl,
+    const InputIterator1& keys_first, const InputIterator1& keys_last, const InputIterator2& values_first,
+    const OutputIterator1& keys_result, const OutputIterator2& values_result, const BinaryPredicate& pred,
+    const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< InputIterator1 >::value && !is_zip_iterator< InputIterator2 >::value &&
+                   !is_zip_iterator< OutputIterator1 >::value && !is_zip_iterator< OutputIterator2 >::value,
+                   "unique_by_key_copy does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+    if( n == 0 )
+        return bolt::cl::make_pair( keys_result, values_result );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_SERIAL_CPU,"::Unique_By_Key_Copy::SERIAL_CPU");
+        #endif
+
+        host_view< InputIterator1 > keys( ctl, keys_first, n, CL_MAP_READ );
+        host_view< InputIterator2 > values( ctl, values_first, n, CL_MAP_READ );
+        host_view< OutputIterator1 > keysOutput( ctl, keys_result, n, CL_MAP_WRITE );
+        host_view< OutputIterator2 > valuesOutput( ctl, values_result, n, CL_MAP_WRITE );
+
+        size_t kept = serial_unique_by_key( keys.begin( ), values.begin( ), n, keysOutput.begin( ),
+            valuesOutput.begin( ), pred );
+        return bolt::cl::make_pair( keys_result + kept, values_result + kept );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_MULTICORE_CPU,"::Unique_By_Key_Copy::MULTICORE_CPU");
+            #endif
+
+            host_view< InputIterator1 > keys( ctl, keys_first, n, CL_MAP_READ );
+            host_view< InputIterator2 > values( ctl, values_first, n, CL_MAP_READ );
+            host_view< OutputIterator1 > keysOutput( ctl, keys_result, n, CL_MAP_WRITE );
+            host_view< OutputIterator2 > valuesOutput( ctl, values_result, n, CL_MAP_WRITE );
+
+            size_t kept = static_cast< size_t >( bolt::btbb::unique_by_key_copy( keys.begin( ), keys.begin( ) + n,
+                values.begin( ), keysOutput.begin( ), valuesOutput.begin( ), pred ).first - keysOutput.begin( ) );
+            return bolt::cl::make_pair( keys_result + kept, values_result + kept );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Unique_By_Key_Copy is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_OPENCL_GPU,"::Unique_By_Key_Copy::OPENCL_GPU");
+        #endif
+
+        unsigned int length = deviceElements( n );
+        unsigned int kept = compact( ctl, keys_first, length, keys_first, keys_result, make_discard_iterator( ),
+            false, values_first, values_result, pred, compact_keep_unique, user_code );
+        return bolt::cl::make_pair( keys_result + kept, values_result + kept );
+    }
+}
+
+template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+bolt::cl::pair<ForwardIterator1, ForwardIterator2> unique_by_key( bolt::cl::control &ctl,
+    const ForwardIterator1& keys_first, const ForwardIterator1& keys_last, const ForwardIterator2& values_first,
+    const BinaryPredicate& pred, const std::string& user_code )
+{
+    static_assert( !is_zip_iterator< ForwardIterator1 >::value && !is_zip_iterator< ForwardIterator2 >::value,
+                   "unique_by_key does not take zip_iterator ranges" );
+    size_t n = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+    if( n == 0 )
+        return bolt::cl::make_pair( keys_first, values_first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    #if defined(BOLT_DEBUG_LOG)
+    BOLTLOG::CaptureLog *dblog = BOLTLOG::CaptureLog::getInstance();
+    #endif
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_SERIAL_CPU,"::Unique_By_Key::SERIAL_CPU");
+        #endif
+
+        host_view< ForwardIterator1 > keys( ctl, keys_first, n, CL_MAP_READ | CL_MAP_WRITE );
+        host_view< ForwardIterator2 > values( ctl, values_first, n, CL_MAP_READ | CL_MAP_WRITE );
+
+        size_t kept = serial_unique_by_key( keys.begin( ), values.begin( ), n, keys.begin( ), values.begin( ),
+            pred );
+        return bolt::cl::make_pair( keys_first + kept, values_first + kept );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            #if defined(BOLT_DEBUG_LOG)
+            dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_MULTICORE_CPU,"::Unique_By_Key::MULTICORE_CPU");
+            #endif
+
+            host_view< ForwardIterator1 > keys( ctl, keys_first, n, CL_MAP_READ | CL_MAP_WRITE );
+            host_view< ForwardIterator2 > values( ctl, values_first, n, CL_MAP_READ | CL_MAP_WRITE );
+
+            size_t kept = static_cast< size_t >( bolt::btbb::unique_by_key( keys.begin( ), keys.begin( ) + n,
+                values.begin( ), pred ).first - keys.begin( ) );
+            return bolt::cl::make_pair( keys_first + kept, values_first + kept );
+        #else
+            throw std::runtime_error( "The MultiCoreCpu version of Unique_By_Key is not enabled to be built." );
+        #endif
+    }
+    else
+    {
+        #if defined(BOLT_DEBUG_LOG)
+        dblog->CodePathTaken(BOLTLOG::BOLT_UNIQUE,BOLTLOG::BOLT_OPENCL_GPU,"::Unique_By_Key::OPENCL_GPU");
+        #endif
+
+        unsigned int length = deviceElements( n );
+        compact_source< ForwardIterator1 > keys( ctl, keys_first, length );
+        compact_source< ForwardIterator2 > values( ctl, values_first, length );
+        unsigned int kept = compact( ctl, keys.begin( ), length, keys.begin( ), keys_first, make_discard_iterator( ),
+            false, values.begin( ), values_first, pred, compact_keep_unique, user_code );
+        return bolt::cl::make_pair( keys_first + kept, values_first + kept );
+    }
+}
+
+}//End OF detail namespace
+
+// user control
+template<typename ForwardIterator>
+ForwardIterator unique( bolt::cl::control &ctl, ForwardIterator first, ForwardIterator last,
+            const std::string& user_code )
+{
+    typedef typename std::iterator_traits<ForwardIterator>::value_type T;
+    return detail::unique( ctl, first, last, bolt::cl::equal_to<T>( ), user_code );
+}
+
+// default control
+template<typename ForwardIterator>
+ForwardIterator unique( ForwardIterator first, ForwardIterator last, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<ForwardIterator>::value_type T;
+    return detail::unique( control::getDefault( ), first, last, bolt::cl::equal_to<T>( ), user_code );
+}
+
+// user control
+template<typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator unique( bolt::cl::control &ctl, ForwardIterator first, ForwardIterator last, BinaryPredicate pred,
+            const std::string& user_code )
+{
+    return detail::unique( ctl, first, last, pred, user_code );
+}
+
+// default control
+template<typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator unique( ForwardIterator first, ForwardIterator last, BinaryPredicate pred,
+            const std::string& user_code )
+{
+    return detail::unique( control::getDefault( ), first, last, pred, user_code );
+}
+
+// user control
+template<typename InputIterator, typename OutputIterator>
+OutputIterator unique_copy( bolt::cl::control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+            const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type T;
+    return detail::unique_copy( ctl, first, last, result, bolt::cl::equal_to<T>( ), user_code );
+}
+
+// default control
+template<typename InputIterator, typename OutputIterator>
+OutputIterator unique_copy( InputIterator first, InputIterator last, OutputIterator result,
+            const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type T;
+    return detail::unique_copy( control::getDefault( ), first, last, result, bolt::cl::equal_to<T>( ), user_code );
+}
+
+// user control
+template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+OutputIterator unique_copy( bolt::cl::control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+            BinaryPredicate pred, const std::string& user_code )
+{
+    return detail::unique_copy( ctl, first, last, result, pred, user_code );
+}
+
+// default control
+template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+OutputIterator unique_copy( InputIterator first, InputIterator last, OutputIterator result, BinaryPredicate pred,
+            const std::string& user_code )
+{
+    return detail::unique_copy( control::getDefault( ), first, last, result, pred, user_code );
+}
+
+// user control
+template<typename ForwardIterator1, typename ForwardIterator2>
+pair<ForwardIterator1, ForwardIterator2> unique_by_key( bolt::cl::control &ctl, ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last, ForwardIterator2 values_first, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<ForwardIterator1>::value_type T;
+    return detail::unique_by_key( ctl, keys_first, keys_last, values_first, bolt::cl::equal_to<T>( ), user_code );
+}
+
+// default control
+template<typename ForwardIterator1, typename ForwardIterator2>
+pair<ForwardIterator1, ForwardIterator2> unique_by_key( ForwardIterator1 keys_first, ForwardIterator1 keys_last,
+            ForwardIterator2 values_first, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<ForwardIterator1>::value_type T;
+    return detail::unique_by_key( control::getDefault( ), keys_first, keys_last, values_first,
+        bolt::cl::equal_to<T>( ), user_code );
+}
+
+// user control
+template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+pair<ForwardIterator1, ForwardIterator2> unique_by_key( bolt::cl::control &ctl, ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last, ForwardIterator2 values_first, BinaryPredicate pred,
+            const std::string& user_code )
+{
+    return detail::unique_by_key( ctl, keys_first, keys_last, values_first, pred, user_code );
+}
+
+// default control
+template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+pair<ForwardIterator1, ForwardIterator2> unique_by_key( ForwardIterator1 keys_first, ForwardIterator1 keys_last,
+            ForwardIterator2 values_first, BinaryPredicate pred, const std::string& user_code )
+{
+    return detail::unique_by_key( control::getDefault( ), keys_first, keys_last, values_first, pred, user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2> unique_by_key_copy( bolt::cl::control &ctl, InputIterator1 keys_first,
+            InputIterator1 keys_last, InputIterator2 values_first, OutputIterator1 keys_result,
+            OutputIterator2 values_result, const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::unique_by_key_copy( ctl, keys_first, keys_last, values_first, keys_result, values_result,
+        bolt::cl::equal_to<T>( ), user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2> unique_by_key_copy( InputIterator1 keys_first, InputIterator1 keys_last,
+            InputIterator2 values_first, OutputIterator1 keys_result, OutputIterator2 values_result,
+            const std::string& user_code )
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type T;
+    return detail::unique_by_key_copy( control::getDefault( ), keys_first, keys_last, values_first, keys_result,
+        values_result, bolt::cl::equal_to<T>( ), user_code );
+}
+
+// user control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+         typename BinaryPredicate>
+pair<OutputIterator1, OutputIterator2> unique_by_key_copy( bolt::cl::control &ctl, InputIterator1 keys_first,
+            InputIterator1 keys_last, InputIterator2 values_first, OutputIterator1 keys_result,
+            OutputIterator2 values_result, BinaryPredicate pred, const std::string& user_code )
+{
+    return detail::unique_by_key_copy( ctl, keys_first, keys_last, values_first, keys_result, values_result,
+        pred, user_code );
+}
+
+// default control
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+         typename BinaryPredicate>
+pair<OutputIterator1, OutputIterator2> unique_by_key_copy( InputIterator1 keys_first, InputIterator1 keys_last,
+            InputIterator2 values_first, OutputIterator1 keys_result, OutputIterator2 values_result,
+            BinaryPredicate pred, const std::string& user_code )
+{
+    return detail::unique_by_key_copy( control::getDefault( ), keys_first, keys_last, values_first, keys_result,
+        values_result, pred, user_code );
+}
+
+}//end of cl namespace
+};//end of bolt namespace
+
+#endif
@@ -0,0 +1,240 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_DEVICE_SPAN_H )
+#define BOLT_CL_DEVICE_SPAN_H
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/device_vector.h"
+
+/*! \file bolt/cl/device_span.h
+    \brief A non-owning view of a contiguous range of device memory.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \brief A non-owning view of length elements of an OpenCL buffer, starting offset elements in
+        *   \ingroup CL-Device
+        *   \details A device_span never allocates or copies element memory.  When the byte offset of the range
+        *   is a multiple of the device's CL_DEVICE_MEM_BASE_ADDR_ALIGN, the span wraps an OpenCL sub-buffer of
+        *   exactly the range, so the algorithms see a buffer that starts at element 0.  Otherwise it wraps the
+        *   whole buffer and its iterators start at the offset.  Either way begin( ) and end( ) are
+        *   device_vector< T >::iterator, so every Bolt algorithm that takes device_vector iterators takes a span.
+        *
+        *   A span keeps the OpenCL buffer alive, like a ::cl::Buffer does, and copies of a span share the wrapper
+        *   their iterators refer to.  It can not grow or shrink; take a subspan( ) instead.
+        *
+        *   \code
+        *   bolt::cl::device_vector< int > dv( 1 << 20 );
+        *   bolt::cl::device_span< int > middle( dv, 1 << 18, 1 << 19 );
+        *   bolt::cl::sort( middle.begin( ), middle.end( ) );
+        *   \endcode
+        */
+        template< typename T >
+        class device_span
+        {
+            typedef device_vector< T > container;
+
+        public:
+            typedef T value_type;
+            typedef typename container::size_type size_type;
+            typedef typename container::difference_type difference_type;
+            typedef typename container::reference reference;
+            typedef typename container::const_reference const_reference;
+            typedef typename container::iterator iterator;
+            typedef typename container::const_iterator const_iterator;
+
+            /*! \brief A span of length elements of a device_vector, starting at element offset.
+            */
+            device_span( container& vec, size_type offset, size_type length, const control& ctl = control::getDefault( ) )
+            {
+                if( offset < 0 || length < 0 || offset + length > vec.size( ) )
+                    throw ::cl::Error( CL_INVALID_VALUE, "device_span range is outside of the device_vector" );
+
+                //  getBuffer( ) uploads a staged vector's host range before the device sees it
+                wrap( vec.getBuffer( ), offset, length, ctl );
+            }
+
+            /*! \brief A span of the elements between two iterators of the same device_vector.
+            */
+            device_span( iterator first, iterator last, const control& ctl = control::getDefault( ) )
+            {
+                if( &first.getContainer( ) != &last.getContainer( ) || last < first )
+                    throw ::cl::Error( CL_INVALID_VALUE, "device_span iterators do not form a range" );
+
+                wrap( first.getContainer( ).getBuffer( ), first.m_Index, last.m_Index - first.m_Index, ctl );
+            }
+
+            /*! \brief Interop constructor: a span of an OpenCL buffer created elsewhere; the buffer is not copied.
+            *   \param buffer The buffer, which may itself be a sub-buffer.
+            *   \param offset The first element of the span, counted in value_type elements from the start of buffer.
+            *   \param length The number of elements in the span.
+            */
+            device_span( const ::cl::Buffer& buffer, size_type offset, size_type length,
+                const control& ctl = control::getDefault( ) )
+            {
+                wrap( buffer, offset, length, ctl );
+            }
+
+            /*! \brief Interop constructor for a raw cl_mem handle; the span retains its own reference to it.
+            */
+            device_span( cl_mem mem, size_type offset, size_type length, const control& ctl = control::getDefault( ) )
+            {
+                V_OPENCL( ::clRetainMemObject( mem ), "device_span failed to retain the cl_mem object" );
+                wrap( ::cl::Buffer( mem ), offset, length, ctl );
+            }
+
+            /*! \brief A span of length elements of this span, starting at element offset of this span.
+            *   \note Sub-buffers of sub-buffers are not allowed, so the new span is cut from the original buffer.
+            */
+            device_span subspan( size_type offset, size_type length, const control& ctl = control::getDefault( ) ) const
+            {
+                if( offset < 0 || length < 0 || offset + length > m_Size )
+                    throw ::cl::Error( CL_INVALID_VALUE, "device_span subspan is outside of the span" );
+
+                return device_span( m_Parent, m_Offset + offset, length, ctl );
+            }
+
+            iterator begin( ) const
+            {
+                return m_Vector->begin( ) + m_First;
+            }
+
+            iterator end( ) const
+            {
+                return m_Vector->begin( ) + ( m_First + m_Size );
+            }
+
+            const_iterator cbegin( ) const
+            {
+                return static_cast< const container& >( *m_Vector ).cbegin( ) + m_First;
+            }
+
+            const_iterator cend( ) const
+            {
+                return static_cast< const container& >( *m_Vector ).cbegin( ) + ( m_First + m_Size );
+            }
+
+            reference operator[]( size_type n ) const
+            {
+                return ( *m_Vector )[ m_First + n ];
+            }
+
+            size_type size( ) const
+            {
+                return m_Size;
+            }
+
+            bool empty( ) const
+            {
+                return m_Size == 0;
+            }
+
+            /*! \brief The buffer the iterators of the span index, which is a sub-buffer of exactly the span when
+            *   isSubBuffer( ) is true, and the whole original buffer otherwise.
+            */
+            const ::cl::Buffer& getBuffer( ) const
+            {
+                return m_Vector->getBuffer( );
+            }
+
+            /*! \brief The offset of the first element of the span in the original buffer, in elements.
+            */
+            size_type getOffset( ) const
+            {
+                return m_Offset;
+            }
+
+            bool isSubBuffer( ) const
+            {
+                return m_First == 0 && m_Offset != 0;
+            }
+
+        private:
+            //  Cuts a sub-buffer of the range when the device allows it at that offset, else wraps the whole buffer
+            //  and starts the iterators at the offset
+            void wrap( const ::cl::Buffer& buffer, size_type offset, size_type length, const control& ctl )
+            {
+                cl_int l_Error = CL_SUCCESS;
+
+                size_t l_Bytes = buffer.getInfo< CL_MEM_SIZE >( &l_Error );
+                V_OPENCL( l_Error, "device_span failed to query for the size of the ::cl::Buffer object" );
+                if( offset < 0 || length < 0 || ( static_cast< size_t >( offset ) + length ) * sizeof( value_type ) > l_Bytes )
+                    throw ::cl::Error( CL_INVALID_VALUE, "device_span range is outside of the buffer" );
+
+                //  A sub-buffer can not be cut from a sub-buffer, so spans always refer to the original buffer
+                m_Parent = buffer;
+                size_t l_Origin = 0;
+                cl_mem l_Associated = NULL;
+                V_OPENCL( ::clGetMemObjectInfo( buffer( ), CL_MEM_ASSOCIATED_MEMOBJECT, sizeof( cl_mem ), &l_Associated, NULL ),
+                    "device_span failed to query for the parent of the ::cl::Buffer object" );
+                if( l_Associated != NULL )
+                {
+                    l_Origin = buffer.getInfo< CL_MEM_OFFSET >( &l_Error );
+                    V_OPENCL( l_Error, "device_span failed to query for the offset of the sub-buffer" );
+                    if( l_Origin % sizeof( value_type ) != 0 )
+                        throw ::cl::Error( CL_INVALID_VALUE, "device_span sub-buffer does not start at an element boundary" );
+
+                    V_OPENCL( ::clRetainMemObject( l_Associated ), "device_span failed to retain the parent buffer" );
+                    m_Parent = ::cl::Buffer( l_Associated );
+                }
+
+                m_Offset = static_cast< size_type >( l_Origin / sizeof( value_type ) ) + offset;
+                m_Size = length;
+
+                cl_uint l_AlignBits = ctl.getDevice( ).getInfo< CL_DEVICE_MEM_BASE_ADDR_ALIGN >( &l_Error );
+                V_OPENCL( l_Error, "device_span failed to query the device for its sub-buffer alignment" );
+
+                size_t l_ByteOffset = static_cast< size_t >( m_Offset ) * sizeof( value_type );
+                if( m_Offset != 0 && m_Size != 0 && l_ByteOffset % ( l_AlignBits / 8 ) == 0 )
+                {
+                    cl_mem_flags l_Flags = m_Parent.getInfo< CL_MEM_FLAGS >( &l_Error );
+                    V_OPENCL( l_Error, "device_span failed to query for the memory flags of the ::cl::Buffer object" );
+
+                    //  The host pointer flags are inherited from the parent and may not be given again
+                    l_Flags &= CL_MEM_READ_WRITE | CL_MEM_READ_ONLY | CL_MEM_WRITE_ONLY;
+
+                    cl_buffer_region l_Region = { l_ByteOffset, static_cast< size_t >( m_Size ) * sizeof( value_type ) };
+                    ::cl::Buffer l_Sub = m_Parent.createSubBuffer( l_Flags, CL_BUFFER_CREATE_TYPE_REGION, &l_Region, &l_Error );
+                    V_OPENCL( l_Error, "device_span failed to create a sub-buffer" );
+
+                    m_Vector.reset( new container( l_Sub, ctl ) );
+                    m_First = 0;
+                }
+                else
+                {
+                    m_Vector.reset( new container( m_Parent, ctl ) );
+                    m_First = m_Offset;
+                }
+            }
+
+            ::cl::Buffer m_Parent;                  // the original buffer, never a sub-buffer
+            boost::shared_ptr< container > m_Vector;  // what the iterators index: a sub-buffer, or m_Parent
+            size_type m_Offset;                     // first element of the span in m_Parent
+            size_type m_First;                      // first element of the span in m_Vector
+            size_type m_Size;
+        };
+
+    } // namespace cl
+} // namespace bolt
+
+#endif
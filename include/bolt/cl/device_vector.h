@@ -94,6 +94,26 @@ namespace cl
                 }
             };
 
+            /*! \brief Class used with shared_ptr<> as a custom deleter for the host memory that data() hands out for a
+            *   staged device_vector; memory handed out for writing is uploaded again before the device next uses it
+            */
+            template< typename Container >
+            class StagedDataFunctor
+            {
+                Container& m_Container;
+                bool m_Written;
+
+            public:
+                StagedDataFunctor( Container& rhs, bool written ): m_Container( rhs ), m_Written( written )
+                {}
+
+                void operator( )( const void* pBuff )
+                {
+                    if( m_Written )
+                        m_Container.m_hostNewer = true;
+                }
+            };
+
             typedef T* naked_pointer;
             typedef const T* const_naked_pointer;
 
@@ -127,9 +147,12 @@ namespace cl
                 //  Automatic type conversion operator to turn the reference object into a value_type
                 operator value_type( ) const
                 {
+                    if( m_Container.m_mappedHost != NULL )
+                        return m_Container.m_mappedHost[ m_Index ];
+
                     cl_int l_Error = CL_SUCCESS;
                     naked_pointer result = reinterpret_cast< naked_pointer >( m_Container.m_commQueue.enqueueMapBuffer(
-                    m_Container.m_devMemory, true, CL_MAP_READ, m_Index * sizeof( value_type ), sizeof( value_type ), NULL, NULL, &l_Error ) );
+                    m_Container.getBuffer( ), true, CL_MAP_READ, m_Index * sizeof( value_type ), sizeof( value_type ), NULL, NULL, &l_Error ) );
                     V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
 
                     value_type valTmp = *result;
@@ -143,9 +166,15 @@ namespace cl
 
                 reference_base< Container >& operator=( const value_type& rhs )
                 {
+                    if( m_Container.m_mappedHost != NULL )
+                    {
+                        m_Container.m_mappedHost[ m_Index ] = rhs;
+                        return *this;
+                    }
+
                     cl_int l_Error = CL_SUCCESS;
                     naked_pointer result = reinterpret_cast< naked_pointer >( m_Container.m_commQueue.enqueueMapBuffer(
-                    m_Container.m_devMemory, true, CL_MAP_WRITE_INVALIDATE_REGION, m_Index * sizeof( value_type ), sizeof( value_type ), NULL, NULL, &l_Error ) );
+                    m_Container.getBuffer( ), true, CL_MAP_WRITE_INVALIDATE_REGION, m_Index * sizeof( value_type ), sizeof( value_type ), NULL, NULL, &l_Error ) );
                     V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
 
                     *result = rhs;
@@ -164,8 +193,13 @@ namespace cl
 
                     cl_int l_Error = CL_SUCCESS;
                     value_type value = static_cast<value_type>(rhs);
+                    if( m_Container.m_mappedHost != NULL )
+                    {
+                        m_Container.m_mappedHost[ m_Index ] = value;
+                        return *this;
+                    }
                     naked_pointer result = reinterpret_cast< naked_pointer >( m_Container.m_commQueue.enqueueMapBuffer(
-                    m_Container.m_devMemory, true, CL_MAP_WRITE_INVALIDATE_REGION, m_Index * sizeof( value_type ), sizeof( value_type ), NULL, NULL, &l_Error ) );
+                    m_Container.getBuffer( ), true, CL_MAP_WRITE_INVALIDATE_REGION, m_Index * sizeof( value_type ), sizeof( value_type ), NULL, NULL, &l_Error ) );
                     V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
 
                     *result = value;
@@ -208,6 +242,109 @@ namespace cl
             //  Handy for the reference class to get at the wrapped ::cl objects
             //friend class reference;
 
+            /*! \brief A scoped host view of all the elements of the container.
+            *   The constructor maps the buffer once, with the flags given, and the destructor unmaps it.  In between,
+            *   begin( ) to end( ) is plain host memory, and operator[], references and iterators of the container read
+            *   and write through the view instead of mapping every element.
+            *   \note CL_MAP_WRITE_INVALIDATE_REGION skips the copy to the host; every element must then be written
+            *   before it is read.
+            *   \warning The container must not be resized, nor handed to a Bolt algorithm, while the view is open.
+            */
+            template< typename Container >
+            class mapped_view_base
+            {
+            public:
+                typedef typename std::conditional< std::is_const< Container >::value, const_naked_pointer,
+                    naked_pointer >::type iterator;
+
+                explicit mapped_view_base( Container& rhs, cl_map_flags flags = std::is_const< Container >::value ?
+                    CL_MAP_READ : CL_MAP_READ | CL_MAP_WRITE ): m_Container( rhs ), m_Flags( flags ), m_Owner( false )
+                {
+                    if( std::is_const< Container >::value )
+                        m_Flags = CL_MAP_READ;
+
+                    //  A view opened inside another one shares its mapping
+                    if( m_Container.m_mappedHost != NULL || m_Container.m_Size == 0 )
+                        return;
+
+                    if( m_Container.m_stagedHost != NULL )
+                    {
+                        if( ( m_Flags & CL_MAP_WRITE_INVALIDATE_REGION ) == 0 )
+                            m_Container.syncStaged( );
+                        m_Container.m_mappedHost = m_Container.m_stagedHost;
+                    }
+                    else
+                    {
+                        cl_int l_Error = CL_SUCCESS;
+                        m_Container.m_mappedHost = reinterpret_cast< naked_pointer >( m_Container.m_commQueue.enqueueMapBuffer(
+                            m_Container.m_devMemory, true, m_Flags, 0, m_Container.m_Size * sizeof( value_type ), NULL, NULL,
+                            &l_Error ) );
+                        V_OPENCL( l_Error, "device_vector failed map device memory to host memory for mapped_view" );
+                    }
+                    m_Owner = true;
+                }
+
+                ~mapped_view_base( )
+                {
+                    if( !m_Owner )
+                        return;
+
+                    naked_pointer host = m_Container.m_mappedHost;
+                    m_Container.m_mappedHost = NULL;
+
+                    if( host == m_Container.m_stagedHost )
+                    {
+                        if( m_Flags != CL_MAP_READ )
+                        {
+                            m_Container.m_hostNewer = true;
+                            m_Container.m_deviceNewer = false;
+                        }
+                        return;
+                    }
+
+                    //  Destructors must not throw; a failed unmap leaves the buffer mapped
+                    ::cl::Event unmapEvent;
+                    if( m_Container.m_commQueue.enqueueUnmapMemObject( m_Container.m_devMemory, host, NULL, &unmapEvent ) == CL_SUCCESS )
+                        unmapEvent.wait( );
+                }
+
+                iterator begin( ) const
+                {
+                    return m_Container.m_mappedHost;
+                }
+
+                iterator end( ) const
+                {
+                    return m_Container.m_mappedHost + m_Container.m_Size;
+                }
+
+                size_type size( ) const
+                {
+                    return m_Container.m_Size;
+                }
+
+                typename std::iterator_traits< iterator >::reference operator[]( size_type n ) const
+                {
+                    return m_Container.m_mappedHost[ n ];
+                }
+
+            private:
+                mapped_view_base( const mapped_view_base& );
+                mapped_view_base& operator=( const mapped_view_base& );
+
+                Container& m_Container;
+                cl_map_flags m_Flags;
+                bool m_Owner;
+            };
+
+            /*! \brief Typedef to create the host view that can write the container.
+            */
+            typedef mapped_view_base< device_vector< value_type > > mapped_view;
+
+            /*! \brief Typedef to create the read only host view.
+            */
+            typedef mapped_view_base< const device_vector< value_type > > const_mapped_view;
+
             /*! \brief Base class provided to encapsulate all the common functionality for constant
             *   and non-constant iterators.
             *   \sa http://www.sgi.com/tech/stl/Iterators.html
@@ -529,7 +666,8 @@ namespace cl
             *   \todo Find a way to be able to unambiguously specify memory flags for this constructor, that is not
             *   confused with the size constructor below.
             */
-            device_vector( /* cl_mem_flags flags = CL_MEM_READ_WRITE,*/ const control& ctl = control::getDefault( ) ): m_Size( 0 ), m_commQueue( ctl.getCommandQueue( ) ), m_Flags( CL_MEM_READ_WRITE )
+            device_vector( /* cl_mem_flags flags = CL_MEM_READ_WRITE,*/ const control& ctl = control::getDefault( ) ): m_Size( 0 ), m_commQueue( ctl.getCommandQueue( ) ), m_Flags( CL_MEM_READ_WRITE ),
+                m_stagedHost( NULL ), m_hostNewer( false ), m_deviceNewer( false ), m_mappedHost( NULL )
             {
                 static_assert( !std::is_polymorphic< value_type >::value, "AMD C++ template extensions do not support the virtual keyword yet" );
                 m_devMemory = NULL;
@@ -545,7 +683,8 @@ namespace cl
             *   \warning If the size of the value is a power of two, the buffer will be filled serially as opposed to using the OpenCL fill API. Refer section 5.2.3 in 'The OpenCL 1.2 Specification' (Khronos)
             */
             device_vector( size_type newSize, const value_type& value = value_type( ), cl_mem_flags flags = CL_MEM_READ_WRITE,
-                bool init = true, const control& ctl = control::getDefault( ) ): m_Size( newSize ), m_commQueue( ctl.getCommandQueue( ) ), m_Flags( flags )
+                bool init = true, const control& ctl = control::getDefault( ) ): m_Size( newSize ), m_commQueue( ctl.getCommandQueue( ) ), m_Flags( flags ),
+                m_stagedHost( NULL ), m_hostNewer( false ), m_deviceNewer( false ), m_mappedHost( NULL )
             {
                 static_assert( !std::is_polymorphic< value_type >::value, "AMD C++ template extensions do not support the virtual keyword yet" );
 
@@ -650,7 +789,8 @@ namespace cl
             device_vector( const InputIterator begin, size_type newSize, cl_mem_flags flags = CL_MEM_READ_WRITE|CL_MEM_USE_HOST_PTR,
                 bool init = true, const control& ctl = control::getDefault( ),
                 typename std::enable_if< !std::is_integral< InputIterator >::value >::type* = 0 ): m_Size( newSize ),
-                m_commQueue( ctl.getCommandQueue( ) ), m_Flags( flags )
+                m_commQueue( ctl.getCommandQueue( ) ), m_Flags( flags ), m_stagedHost( NULL ), m_hostNewer( false ),
+                m_deviceNewer( false ), m_mappedHost( NULL )
             {
                 static_assert( std::is_convertible< value_type, typename std::iterator_traits< InputIterator >::value_type >::value,
                     "iterator value_type does not convert to device_vector value_type" );
@@ -668,8 +808,14 @@ namespace cl
 
                 if( m_Flags & CL_MEM_USE_HOST_PTR )
                 {
-                    m_devMemory = ::cl::Buffer( l_Context, m_Flags, m_Size * sizeof( value_type ),
-                        reinterpret_cast< value_type* >( const_cast< value_type* >( &*begin ) ) );
+                    naked_pointer l_host = reinterpret_cast< value_type* >( const_cast< value_type* >( &*begin ) );
+                    if( ctl.zeroCopyHostRange( l_host ) )
+                    {
+                        m_devMemory = ::cl::Buffer( l_Context, m_Flags, m_Size * sizeof( value_type ), l_host );
+                        ctl.getHostStaging( )->mapped( m_Size * sizeof( value_type ) );
+                    }
+                    else
+                        stageHostRange( ctl, l_Context, l_host, init );
                 }
                 else
                 {
@@ -704,7 +850,8 @@ namespace cl
             */
             template< typename InputIterator >
             device_vector( const InputIterator begin, const InputIterator end, cl_mem_flags flags = CL_MEM_READ_WRITE|CL_MEM_USE_HOST_PTR, const control& ctl = control::getDefault( ),
-                typename std::enable_if< !std::is_integral< InputIterator >::value >::type* = 0 ): m_commQueue( ctl.getCommandQueue( ) ), m_Flags( flags )
+                typename std::enable_if< !std::is_integral< InputIterator >::value >::type* = 0 ): m_commQueue( ctl.getCommandQueue( ) ), m_Flags( flags ),
+                m_stagedHost( NULL ), m_hostNewer( false ), m_deviceNewer( false ), m_mappedHost( NULL )
             {
                 static_assert( std::is_convertible< value_type, typename std::iterator_traits< InputIterator >::value_type >::value,
                     "iterator value_type does not convert to device_vector value_type" );
@@ -715,7 +862,7 @@ namespace cl
                 ::cl::Context l_Context = m_commQueue.getInfo< CL_QUEUE_CONTEXT >( &l_Error );
                 V_OPENCL( l_Error, "device_vector failed to query for the context of the ::cl::CommandQueue object" );
 
-                m_Size = static_cast< size_type >( std::distance( begin, end ) );
+                m_Size = deviceElements( std::distance( begin, end ) );
                 if ( m_Size == 0 )
                 {
                     m_devMemory=NULL;
@@ -725,9 +872,14 @@ namespace cl
 
                 if( m_Flags & CL_MEM_USE_HOST_PTR )
                 {
-                        m_devMemory = ::cl::Buffer( l_Context, m_Flags, byteSize,
-                            reinterpret_cast< value_type* >( const_cast< value_type* >( std::addressof(*(begin) ) /*&*begin*/ ) ) );
-
+                    naked_pointer l_host = reinterpret_cast< value_type* >( const_cast< value_type* >( std::addressof(*(begin) ) /*&*begin*/ ) );
+                    if( ctl.zeroCopyHostRange( l_host ) )
+                    {
+                        m_devMemory = ::cl::Buffer( l_Context, m_Flags, byteSize, l_host );
+                        ctl.getHostStaging( )->mapped( byteSize );
+                    }
+                    else
+                        stageHostRange( ctl, l_Context, l_host, true );
                 }
                 else
                 {
@@ -754,7 +906,8 @@ namespace cl
             *   \param rhs A pre-existing ::cl::Buffer supplied by the user.
             *   \param ctl A Bolt control class for copy operations; a default is used if not supplied by the user.
             */
-            device_vector( const ::cl::Buffer& rhs, const control& ctl = control::getDefault( ) ): m_devMemory( rhs ), m_commQueue( ctl.getCommandQueue( ) )
+            device_vector( const ::cl::Buffer& rhs, const control& ctl = control::getDefault( ) ): m_devMemory( rhs ), m_commQueue( ctl.getCommandQueue( ) ),
+                m_stagedHost( NULL ), m_hostNewer( false ), m_deviceNewer( false ), m_mappedHost( NULL )
             {
                 static_assert( !std::is_polymorphic< value_type >::value, "AMD C++ template extensions do not support the virtual keyword yet" );
 
@@ -766,7 +919,8 @@ namespace cl
             };
 
             //  Copying methods
-            device_vector( const device_vector& rhs ): m_Flags( rhs.m_Flags ), m_Size( 0 ), m_commQueue( rhs.m_commQueue )
+            device_vector( const device_vector& rhs ): m_Flags( rhs.m_Flags ), m_Size( 0 ), m_commQueue( rhs.m_commQueue ),
+                m_stagedHost( NULL ), m_hostNewer( false ), m_deviceNewer( false ), m_mappedHost( NULL )
             {
                 //  This method will set the m_Size member variable upon successful completion
                 resize( rhs.m_Size );
@@ -778,7 +932,7 @@ namespace cl
                 ::cl::Event copyEvent;
 
                 cl_int l_Error = CL_SUCCESS;
-                l_Error = m_commQueue.enqueueCopyBuffer( rhs.m_devMemory, m_devMemory, 0, 0, l_srcSize, NULL, &copyEvent );
+                l_Error = m_commQueue.enqueueCopyBuffer( rhs.getBuffer( ), m_devMemory, 0, 0, l_srcSize, NULL, &copyEvent );
                 V_OPENCL( l_Error, "device_vector failed to copy data inside of operator=()" );
                 V_OPENCL( copyEvent.wait( ), "device_vector failed to wait for copy event" );
             }
@@ -802,7 +956,7 @@ namespace cl
                 ::cl::Event copyEvent;
 
                 cl_int l_Error = CL_SUCCESS;
-                l_Error = m_commQueue.enqueueCopyBuffer( rhs.m_devMemory, m_devMemory, 0, 0, l_srcSize, NULL, &copyEvent );
+                l_Error = m_commQueue.enqueueCopyBuffer( rhs.getBuffer( ), m_devMemory, 0, 0, l_srcSize, NULL, &copyEvent );
                 V_OPENCL( l_Error, "device_vector failed to copy data inside of operator=()" );
                 V_OPENCL( copyEvent.wait( ), "device_vector failed to wait for copy event" );
 
@@ -825,7 +979,7 @@ namespace cl
 
             void resize( size_type reqSize, const value_type& val = value_type( ) )
             {
-                if( (m_Flags & CL_MEM_USE_HOST_PTR) != 0 )
+                if( (m_Flags & CL_MEM_USE_HOST_PTR) != 0 || m_stagedHost != NULL )
                 {
                     throw ::cl::Error( CL_MEM_OBJECT_ALLOCATION_FAILURE ,
                         "A device_vector can not resize() memory not under its direct control" );
@@ -1026,6 +1180,9 @@ namespace cl
                 if( reqSize <= capacity( ) )
                     return;
 
+                if( m_stagedHost != NULL )
+                    throw ::cl::Error( CL_MEM_OBJECT_ALLOCATION_FAILURE , "A device_vector can not reserve() memory not under its direct control" );
+
                 if( reqSize > max_size( ) )
                     throw ::cl::Error( CL_MEM_OBJECT_ALLOCATION_FAILURE , "The amount of memory requested exceeds what is available" );
 
@@ -1135,9 +1292,12 @@ namespace cl
             */
             const_reference operator[]( size_type n ) const
             {
+                if( m_mappedHost != NULL )
+                    return m_mappedHost[ n ];
+
                 cl_int l_Error = CL_SUCCESS;
 
-                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ, n * sizeof( value_type), sizeof( value_type), NULL, NULL, &l_Error ) );
+                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( getBuffer( ), true, CL_MAP_READ, n * sizeof( value_type), sizeof( value_type), NULL, NULL, &l_Error ) );
                 V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
 
                 const_reference tmpRef = *ptrBuff;
@@ -1306,6 +1466,13 @@ namespace cl
                     pointer sp;
                     return sp;
                 }
+
+                //  A staged vector hands out its host range, brought up to date with the device
+                if( m_stagedHost != NULL )
+                {
+                    syncStaged( );
+                    return pointer( m_stagedHost, StagedDataFunctor< device_vector< value_type > >( *this, true ) );
+                }
                 cl_int l_Error = CL_SUCCESS;
 
                 naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ | CL_MAP_WRITE,
@@ -1320,6 +1487,11 @@ namespace cl
 
             const_pointer data( void ) const
             {
+                if( m_stagedHost != NULL )
+                {
+                    syncStaged( );
+                    return const_pointer( m_stagedHost, StagedDataFunctor< const device_vector< value_type > >( *this, false ) );
+                }
                 cl_int l_Error = CL_SUCCESS;
 
                 const_naked_pointer ptrBuff = reinterpret_cast< const_naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ,
@@ -1417,6 +1589,11 @@ namespace cl
                 cl_mem_flags flagsTmp = m_Flags;
                 m_Flags = vec.m_Flags;
                 vec.m_Flags = flagsTmp;
+
+                std::swap( m_stagedHost, vec.m_stagedHost );
+                m_staging.swap( vec.m_staging );
+                std::swap( m_hostNewer, vec.m_hostNewer );
+                std::swap( m_deviceNewer, vec.m_deviceNewer );
             }
 
             /*! \brief Removes an element.
@@ -1434,17 +1611,8 @@ namespace cl
 
             size_type sizeRegion = l_End.m_Index - index.m_Index;
 
-                cl_int l_Error = CL_SUCCESS;
-                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ | CL_MAP_WRITE,
-                    index.m_Index * sizeof( value_type ), sizeRegion * sizeof( value_type ), NULL, NULL, &l_Error ) );
-                V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
-
-                ::memmove( ptrBuff, ptrBuff + 1, (sizeRegion - 1)*sizeof( value_type ) );
-
-                ::cl::Event unmapEvent;
-                l_Error = m_commQueue.enqueueUnmapMemObject( m_devMemory, ptrBuff, NULL, &unmapEvent );
-                V_OPENCL( l_Error, "device_vector failed to unmap host memory back to device memory" );
-                V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+                //  Shuffle the old values 1 element up, on the device
+                moveRegion( index.m_Index + 1, index.m_Index, sizeRegion - 1 );
 
                 --m_Size;
 
@@ -1471,21 +1639,10 @@ namespace cl
                     return iterator( *this, static_cast< typename iterator::difference_type >( m_Size ) );
                 }
 
-                iterator l_End = end( );
-            size_type sizeMap = l_End.m_Index - first.m_Index;
-
-                cl_int l_Error = CL_SUCCESS;
-                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ | CL_MAP_WRITE,
-                    first.m_Index * sizeof( value_type ), sizeMap * sizeof( value_type ), NULL, NULL, &l_Error ) );
-                V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
-
             size_type sizeErase = last.m_Index - first.m_Index;
-                ::memmove( ptrBuff, ptrBuff + sizeErase, (sizeMap - sizeErase)*sizeof( value_type ) );
 
-                ::cl::Event unmapEvent;
-                l_Error = m_commQueue.enqueueUnmapMemObject( m_devMemory, ptrBuff, NULL, &unmapEvent );
-                V_OPENCL( l_Error, "device_vector failed to unmap host memory back to device memory" );
-                V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+                //  Shuffle the values after the range sizeErase elements up, on the device
+                moveRegion( last.m_Index, first.m_Index, m_Size - last.m_Index );
 
                 m_Size -= sizeErase;
 
@@ -1522,23 +1679,13 @@ namespace cl
                     reserve( m_Size + 10 );
                 }
 
-            size_type sizeMap = (m_Size - index.m_Index) + 1;
-
-                cl_int l_Error = CL_SUCCESS;
-                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ | CL_MAP_WRITE,
-                    index.m_Index * sizeof( value_type ), sizeMap * sizeof( value_type ), NULL, NULL, &l_Error ) );
-                V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
-
-                //  Shuffle the old values 1 element down
-                ::memmove( ptrBuff + 1, ptrBuff, (sizeMap - 1)*sizeof( value_type ) );
+                //  Shuffle the old values 1 element down, on the device
+                moveRegion( index.m_Index, index.m_Index + 1, m_Size - index.m_Index );
 
                 //  Write the new value in its place
-                *ptrBuff = value;
-
-                ::cl::Event unmapEvent;
-                l_Error = m_commQueue.enqueueUnmapMemObject( m_devMemory, ptrBuff, NULL, &unmapEvent );
-                V_OPENCL( l_Error, "device_vector failed to unmap host memory back to device memory" );
-                V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+                cl_int l_Error = m_commQueue.enqueueWriteBuffer( m_devMemory, CL_TRUE, index.m_Index * sizeof( value_type ),
+                    sizeof( value_type ), &value );
+                V_OPENCL( l_Error, "device_vector failed to write the inserted element" );
 
                 ++m_Size;
 
@@ -1568,26 +1715,14 @@ namespace cl
                     reserve( m_Size + n );
                 }
 
-            size_type sizeMap = (m_Size - index.m_Index) + n;
-
-                cl_int l_Error = CL_SUCCESS;
-                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ | CL_MAP_WRITE,
-                    index.m_Index * sizeof( value_type ), sizeMap * sizeof( value_type ), NULL, NULL, &l_Error ) );
-                V_OPENCL( l_Error, "device_vector failed map device memory to host memory for operator[]" );
+                if( n == 0 )
+                    return;
 
-                //  Shuffle the old values n element down.
-                ::memmove( ptrBuff + n, ptrBuff, (sizeMap - n)*sizeof( value_type ) );
+                //  Shuffle the old values n element down, on the device
+                moveRegion( index.m_Index, index.m_Index + n, m_Size - index.m_Index );
 
                 //  Copy the new value n times in the buffer.
-                for( size_type i = 0; i < n; ++i )
-                {
-                    ptrBuff[ i ] = value;
-                }
-
-                ::cl::Event unmapEvent;
-                l_Error = m_commQueue.enqueueUnmapMemObject( m_devMemory, ptrBuff, NULL, &unmapEvent );
-                V_OPENCL( l_Error, "device_vector failed to unmap host memory back to device memory" );
-                V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+                fillRegion( index.m_Index, n, value );
 
                 m_Size += n;
             }
@@ -1609,16 +1744,17 @@ namespace cl
                 {
                     reserve( m_Size + n );
                 }
-                size_type sizeMap = (m_Size - index.m_Index) + n;
+                if( n == 0 )
+                    return;
+
+                //  Shuffle the old values n element down, on the device; only the new values cross from the host
+                moveRegion( index.m_Index, index.m_Index + n, m_Size - index.m_Index );
 
                 cl_int l_Error = CL_SUCCESS;
-                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true, CL_MAP_READ | CL_MAP_WRITE,
-                    index.m_Index * sizeof( value_type ), sizeMap * sizeof( value_type ), NULL, NULL, &l_Error ) );
+                naked_pointer ptrBuff = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true,
+                    CL_MAP_WRITE_INVALIDATE_REGION, index.m_Index * sizeof( value_type ), n * sizeof( value_type ), NULL, NULL, &l_Error ) );
                 V_OPENCL( l_Error, "device_vector failed map device memory to host memory for iterator insert" );
 
-                //  Shuffle the old values n element down.
-                ::memmove( ptrBuff + n, ptrBuff, (sizeMap - n)*sizeof( value_type ) );
-
 #if( _WIN32 )
                 std::copy( begin, end, stdext::checked_array_iterator< naked_pointer >( ptrBuff, n )  );
 #else
@@ -1749,6 +1885,7 @@ namespace cl
             */
             const ::cl::Buffer& getBuffer( ) const
             {
+                flushStaged( );
                 return m_devMemory;
             }
 
@@ -1760,14 +1897,133 @@ namespace cl
             */
             ::cl::Buffer& getBuffer( )
             {
+                flushStaged( );
                 return m_devMemory;
             }
 
         private:
+            //  Gives a host range the control chose not to wrap in place a buffer of the vector's own, filled through
+            //  the control's staging ring when init is set
+            void stageHostRange( const control& ctl, const ::cl::Context& context, naked_pointer host, bool init )
+            {
+                m_Flags &= ~static_cast< cl_mem_flags >( CL_MEM_USE_HOST_PTR );
+                m_devMemory = ::cl::Buffer( context, m_Flags, m_Size * sizeof( value_type ) );
+                m_stagedHost = host;
+                m_staging = ctl.getHostStaging( );
+                if( init )
+                    m_staging->toDevice( m_commQueue, m_devMemory, 0, m_stagedHost, m_Size * sizeof( value_type ) );
+            }
+
+            //  Uploads host memory written through data( ) before the buffer is handed to the device, which may then
+            //  hold the newer copy
+            void flushStaged( ) const
+            {
+                if( m_stagedHost == NULL )
+                    return;
+
+                if( m_hostNewer )
+                {
+                    m_staging->toDevice( m_commQueue, m_devMemory, 0, m_stagedHost, m_Size * sizeof( value_type ) );
+                    m_hostNewer = false;
+                }
+                if( ( m_Flags & CL_MEM_READ_ONLY ) == 0 )
+                    m_deviceNewer = true;
+            }
+
+            //  Downloads the buffer into host memory if the device may have written it since the last download
+            void syncStaged( ) const
+            {
+                if( m_stagedHost == NULL || !m_deviceNewer )
+                    return;
+
+                m_staging->toHost( m_commQueue, m_devMemory, 0, m_stagedHost, m_Size * sizeof( value_type ) );
+                m_deviceNewer = false;
+            }
+
+            //  Moves count elements from index from to index to inside the buffer, without a round trip through the
+            //  host.  Overlapping regions can not be copied in one enqueueCopyBuffer, so those go through a scratch
+            //  buffer.
+            void moveRegion( size_type from, size_type to, size_type count )
+            {
+                if( count <= 0 || from == to )
+                    return;
+
+                flushStaged( );
+
+                cl_int l_Error = CL_SUCCESS;
+                size_t byteCount = count * sizeof( value_type );
+                std::vector< ::cl::Event > copyEvent( 1 );
+
+                if( ( from > to ? from - to : to - from ) >= count )
+                {
+                    l_Error = m_commQueue.enqueueCopyBuffer( m_devMemory, m_devMemory, from * sizeof( value_type ),
+                        to * sizeof( value_type ), byteCount, NULL, &copyEvent.front( ) );
+                    V_OPENCL( l_Error, "device_vector failed to move elements inside of its buffer" );
+                }
+                else
+                {
+                    ::cl::Context l_Context = m_commQueue.getInfo< CL_QUEUE_CONTEXT >( &l_Error );
+                    V_OPENCL( l_Error, "device_vector failed to query for the context of the ::cl::CommandQueue object" );
+
+                    ::cl::Buffer l_tmpBuffer( l_Context, CL_MEM_READ_WRITE, byteCount, NULL, &l_Error );
+                    V_OPENCL( l_Error, "device_vector failed to create a scratch buffer" );
+
+                    std::vector< ::cl::Event > scratchEvent( 1 );
+                    l_Error = m_commQueue.enqueueCopyBuffer( m_devMemory, l_tmpBuffer, from * sizeof( value_type ), 0,
+                        byteCount, NULL, &scratchEvent.front( ) );
+                    V_OPENCL( l_Error, "device_vector failed to copy elements to the scratch buffer" );
+
+                    l_Error = m_commQueue.enqueueCopyBuffer( l_tmpBuffer, m_devMemory, 0, to * sizeof( value_type ),
+                        byteCount, &scratchEvent, &copyEvent.front( ) );
+                    V_OPENCL( l_Error, "device_vector failed to copy elements back from the scratch buffer" );
+                }
+
+                //  Not allowed to return until the copy operation is finished
+                V_OPENCL( copyEvent.front( ).wait( ), "device_vector failed to wait for copy event" );
+            }
+
+            //  Writes count copies of value from index first
+            void fillRegion( size_type first, size_type count, const value_type& value )
+            {
+                cl_int l_Error = CL_SUCCESS;
+                ::cl::Event fillEvent;
+
+                size_t sizeDS = sizeof(value_type);
+                if( !( sizeDS & (sizeDS - 1 ) ) )  // 2^n data types
+                {
+                    l_Error = m_commQueue.enqueueFillBuffer< value_type >( m_devMemory, value, first * sizeof( value_type ),
+                        count * sizeof( value_type ), NULL, &fillEvent );
+                    V_OPENCL( l_Error, "device_vector failed to fill the new data with the provided pattern" );
+                }
+                else // non 2^n data types
+                {
+                    naked_pointer host_buffer = reinterpret_cast< naked_pointer >( m_commQueue.enqueueMapBuffer( m_devMemory, true,
+                        CL_MAP_WRITE_INVALIDATE_REGION, first * sizeof( value_type ), count * sizeof( value_type ), NULL, NULL, &l_Error ) );
+                    V_OPENCL( l_Error, "Error calling map on device_vector buffer. Fill device_vector" );
+
+#if( _WIN32 )
+                    std::fill_n( stdext::checked_array_iterator< naked_pointer >( host_buffer, count ), count, value );
+#else
+                    std::fill_n( host_buffer, count, value );
+#endif
+
+                    l_Error = m_commQueue.enqueueUnmapMemObject( m_devMemory, host_buffer, NULL, &fillEvent );
+                    V_OPENCL( l_Error, "Error calling map on device_vector buffer. Fill device_vector" );
+                }
+
+                //  Not allowed to return until the fill operation is finished
+                V_OPENCL( fillEvent.wait( ), "device_vector failed to wait for fill event" );
+            }
+
             ::cl::Buffer m_devMemory;
             ::cl::CommandQueue m_commQueue;
             size_type m_Size;
             cl_mem_flags m_Flags;
+            naked_pointer m_stagedHost;         // host range the buffer stages, NULL unless the control chose to stage it
+            control::stagingPointer m_staging;
+            mutable bool m_hostNewer;           // host range written through data( ) since the last upload
+            mutable bool m_deviceNewer;         // buffer handed to the device since the last download
+            mutable naked_pointer m_mappedHost; // host memory of the open mapped_view, NULL when none is open
         };
 
     //  This string represents the device side definition of the constant_iterator template
@@ -0,0 +1,208 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_DISPATCH_H )
+#define BOLT_CL_DISPATCH_H
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <exception>
+#include <type_traits>
+#include <iterator>
+
+#include "bolt/cl/control.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/iterator/iterator_traits.h"
+#include "bolt/BoltLog.h"
+
+/*! \file bolt/cl/dispatch.h
+    \brief Cost models that let control::Automatic choose between the SerialCpu, MultiCoreCpu and OpenCL paths.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \brief Chooses the path for one Automatic call
+        *   \details Every algorithm and value type has a linear cost model per path, fitted to the times of
+        *   earlier Automatic calls.  The predicted cost of moving data to where the path needs it is added,
+        *   using a transfer rate probed once per device.  Paths that have not been measured yet are tried first,
+        *   as long as the call has no more elements than the exploration limit; large calls with no model use
+        *   control::getDefaultPathToRun().  bolt-tune -m times every path ahead of deployment and writes models
+        *   that loadDispatchModel, or BOLT_DISPATCH_MODEL, picks up, so large calls have one from the start.
+        *   \param algorithm Name of the algorithm and its value type, as built by detail::dispatchKey
+        *   \param hostBytes Bytes the call reads or writes through host iterators, which the OpenCL path copies
+        *   \param deviceBytes Bytes the call reads or writes through device_vector iterators, which the CPU paths map
+        *   \param multiCoreAvailable Whether the MultiCoreCpu path was built in
+        */
+        control::e_RunMode selectRunMode( const control& ctl, const std::string& algorithm, size_t elements,
+            size_t hostBytes, size_t deviceBytes, bool multiCoreAvailable );
+
+        /*! \brief Feeds the measured time of a call back into the cost model of the path that ran it
+        */
+        void recordDispatchTime( const control& ctl, const std::string& algorithm, control::e_RunMode runMode,
+            size_t elements, size_t transferBytes, double seconds );
+
+        /*! \brief As recordDispatchTime, for a call that returned before its device work completed
+        *   \details The time is taken, from \p start, once everything enqueued on the control's queue so far has
+        *   run; returning early only measures the enqueues.
+        */
+        void recordDispatchTimeOnCompletion( const control& ctl, const std::string& algorithm,
+            control::e_RunMode runMode, size_t elements, size_t transferBytes, double start );
+
+        /*! \brief Predicted seconds for a call; negative while the path has no measurements
+        */
+        double predictDispatchTime( const control& ctl, const std::string& algorithm, control::e_RunMode runMode,
+            size_t elements, size_t transferBytes );
+
+        /*! \brief Seconds per byte to move data between host and device; probed on first use
+        */
+        double getTransferCost( const control& ctl );
+        void setTransferCost( const control& ctl, double secondsPerByte );
+
+        /*! \brief Calls larger than this are never used to try out a path that has no model.  Default 1M elements.
+        */
+        void setDispatchExplorationLimit( size_t elements );
+        size_t getDispatchExplorationLimit( );
+
+        /*! \brief Writes the fitted models to a text file, so that a later run, or bolt-tune, can start
+        *   from them.  If the BOLT_DISPATCH_MODEL environment variable names a file, it is loaded on first use
+        *   and written back at exit.
+        */
+        bool saveDispatchModel( const std::string& path );
+        bool loadDispatchModel( const std::string& path );
+
+        /*! \brief Forgets every model and probed transfer rate
+        */
+        void resetDispatchModel( );
+
+        //  Monotonic seconds, used to time Automatic calls
+        double dispatchClock( );
+
+        namespace detail {
+
+            template< typename Iterator >
+            struct is_device_iterator: std::is_base_of< bolt::cl::device_vector_tag,
+                typename std::iterator_traits< Iterator >::iterator_category >
+            {};
+
+            template< typename Iterator >
+            struct is_fancy_iterator: std::is_base_of< bolt::cl::fancy_iterator_tag,
+                typename std::iterator_traits< Iterator >::iterator_category >
+            {};
+
+            //  Bytes of a range that live in host memory; fancy iterators generate their values and live nowhere
+            template< typename Iterator >
+            size_t hostBytes( const Iterator&, size_t elements )
+            {
+                if( is_device_iterator< Iterator >::value || is_fancy_iterator< Iterator >::value )
+                    return 0;
+                return elements * sizeof( typename std::iterator_traits< Iterator >::value_type );
+            }
+
+            //  Bytes of a range that live in a device_vector
+            template< typename Iterator >
+            size_t deviceBytes( const Iterator&, size_t elements )
+            {
+                if( !is_device_iterator< Iterator >::value )
+                    return 0;
+                return elements * sizeof( typename std::iterator_traits< Iterator >::value_type );
+            }
+
+            template< typename T >
+            std::string dispatchKey( const char* algorithm )
+            {
+                return std::string( algorithm ) + "<" + typeid( T ).name( ) + ">";
+            }
+
+            /*! \brief Resolves control::Automatic for one call, and times the call so the cost model learns from it
+            *   \details Construct it where the run mode used to be read from the control; the destructor records
+            *   how long the chosen path took.  Forced run modes are passed through untouched and not timed, and
+            *   without control::AutoTuneDevice Automatic means control::getDefaultPathToRun().  An OpenCL call
+            *   made with control::NoWait returns before its kernels have run, so it is timed when they complete.
+            */
+            class AutomaticRunMode
+            {
+            public:
+                AutomaticRunMode( const control& ctl, const std::string& algorithm, size_t elements,
+                    size_t hostBytes, size_t deviceBytes ):
+                    m_control( ctl ), m_algorithm( algorithm ), m_elements( elements ), m_transferBytes( 0 ),
+                    m_measure( false ), m_start( 0.0 )
+                {
+                    m_runMode = ctl.getForceRunMode( );
+                    if( m_runMode != control::Automatic )
+                        return;
+
+                    if( ( ctl.getAutoTune( ) & control::AutoTuneDevice ) == 0 )
+                    {
+                        m_runMode = ctl.getDefaultPathToRun( );
+                        return;
+                    }
+
+#if defined( ENABLE_TBB )
+                    m_runMode = selectRunMode( ctl, algorithm, elements, hostBytes, deviceBytes, true );
+#else
+                    m_runMode = selectRunMode( ctl, algorithm, elements, hostBytes, deviceBytes, false );
+#endif
+                    m_transferBytes = ( m_runMode == control::OpenCL ) ? hostBytes : deviceBytes;
+                    m_measure = true;
+
+                    #if defined(BOLT_DEBUG_LOG)
+                    BOLTLOG::CodePaths path = ( m_runMode == control::SerialCpu ) ? BOLTLOG::BOLT_SERIAL_CPU :
+                        ( m_runMode == control::MultiCoreCpu ) ? BOLTLOG::BOLT_MULTICORE_CPU : BOLTLOG::BOLT_OPENCL_GPU;
+                    BOLTLOG::CaptureLog::getInstance( )->CodePathTaken( BOLTLOG::BOLT_AUTOMATIC, path,
+                        "::Automatic::" + algorithm );
+                    #endif
+
+                    m_start = dispatchClock( );
+                }
+
+                ~AutomaticRunMode( )
+                {
+                    //  A call that threw says nothing about how long its path takes
+                    if( !m_measure || std::uncaught_exception( ) )
+                        return;
+
+                    if( m_runMode == control::OpenCL && m_control.getWaitMode( ) == control::NoWait )
+                        recordDispatchTimeOnCompletion( m_control, m_algorithm, m_runMode, m_elements,
+                            m_transferBytes, m_start );
+                    else
+                        recordDispatchTime( m_control, m_algorithm, m_runMode, m_elements, m_transferBytes,
+                            dispatchClock( ) - m_start );
+                }
+
+                control::e_RunMode get( ) const { return m_runMode; }
+
+            private:
+                AutomaticRunMode( const AutomaticRunMode& );
+                AutomaticRunMode& operator=( const AutomaticRunMode& );
+
+                const control& m_control;
+                std::string m_algorithm;
+                size_t m_elements;
+                size_t m_transferBytes;
+                bool m_measure;
+                double m_start;
+                control::e_RunMode m_runMode;
+            };
+
+        } // namespace detail
+
+    };
+};
+
+#endif
@@ -0,0 +1,252 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+#pragma once
+#if !defined( BOLT_CL_DISCARD_ITERATOR_H )
+#define BOLT_CL_DISCARD_ITERATOR_H
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/iterator/iterator_traits.h"
+#include <boost/iterator/iterator_facade.hpp>
+
+/*! \file bolt/cl/iterator/discard_iterator.h
+    \brief An output iterator that drops everything written through it.
+*/
+
+
+namespace bolt {
+namespace cl {
+
+    struct discard_iterator_tag
+        : public fancy_iterator_tag
+        {   // identifying tag for outputs that are never stored
+
+        };
+
+        /*! \addtogroup fancy_iterators
+         */
+
+        /*! \addtogroup CL-DiscardIterator
+        *   \ingroup fancy_iterators
+        *   \{
+        */
+
+        /*! \brief The element type of a discard_iterator; any value can be assigned to it and is dropped
+        */
+        struct discard_value
+        {
+            discard_value( )
+            {}
+
+            template< typename T >
+            discard_value( const T& )
+            {}
+
+            template< typename T >
+            discard_value& operator= ( const T& )
+            {
+                return *this;
+            }
+        };
+
+        /*! discard_iterator stands in for an output range whose values the caller does not need.
+         *
+         *  \details Nothing is allocated for it, on the host or on the device.  The kernels are specialized for it
+         *  like for any other iterator, and its device side assignment is empty, so the compiler removes the stores
+         *  and the loads that only fed them.  The following drops the unique keys reduce_by_key would write.
+         *
+         *  \code
+         *  #include <bolt/cl/iterator/discard_iterator.h>
+         *  #include <bolt/cl/reduce_by_key.h>
+         *  ...
+         *
+         *  bolt::cl::device_vector< int > keys( ... ), values( ... ), sums( keys.size( ) );
+         *  bolt::cl::pair< bolt::cl::discard_iterator, bolt::cl::device_vector< int >::iterator > ends =
+         *      bolt::cl::reduce_by_key( keys.begin( ), keys.end( ), values.begin( ),
+         *                               bolt::cl::make_discard_iterator( ), sums.begin( ) );
+         *
+         *  // ends.second - sums.begin( ) is the number of segments
+         *  \endcode
+         *
+         */
+        class discard_iterator: public boost::iterator_facade< discard_iterator, discard_value,
+            discard_iterator_tag, discard_value&, int >
+        {
+        public:
+            typedef boost::iterator_facade< discard_iterator, discard_value, discard_iterator_tag,
+                                   discard_value&, int >::difference_type       difference_type;
+            typedef discard_iterator_tag                                        iterator_category;
+            typedef bolt::cl::device_vector_tag                                 memory_system;
+            typedef discard_value *                                             pointer;
+
+            struct Payload
+            {
+                int m_Index;
+            };
+
+            discard_iterator( difference_type index = 0 ): m_Index( index )
+            {}
+
+            discard_value& operator[ ]( difference_type ) const
+            {
+                return m_value;
+            }
+
+            //  There is no memory behind a discard_iterator; the kernels get a null buffer
+            const ::cl::Buffer& getBuffer( ) const
+            {
+                return m_devMemory;
+            }
+
+            const discard_iterator& getContainer( ) const
+            {
+                return *this;
+            }
+
+            const discard_iterator& base( ) const
+            {
+                return *this;
+            }
+
+            Payload gpuPayload( ) const
+            {
+                Payload payload = { m_Index };
+                return payload;
+            }
+
+            const difference_type gpuPayloadSize( ) const
+            {
+                return sizeof( Payload );
+            }
+
+            int setKernelBuffers( int arg_num, ::cl::Kernel &kernel ) const
+            {
+                kernel.setArg( arg_num, m_devMemory );
+                arg_num++;
+                return arg_num;
+            }
+
+            difference_type distance_to( const discard_iterator& rhs ) const
+            {
+                return rhs.m_Index - m_Index;
+            }
+
+            //  Public member variables
+            difference_type m_Index;
+
+        private:
+            //  Implementation detail of boost.iterator
+            friend class boost::iterator_core_access;
+
+            void advance( difference_type n )
+            {
+                m_Index += n;
+            }
+
+            void increment( )
+            {
+                advance( 1 );
+            }
+
+            void decrement( )
+            {
+                advance( -1 );
+            }
+
+            bool equal( const discard_iterator& rhs ) const
+            {
+                return m_Index == rhs.m_Index;
+            }
+
+            discard_value& dereference( ) const
+            {
+                return m_value;
+            }
+
+            ::cl::Buffer m_devMemory;
+            mutable discard_value m_value;
+        };
+
+    //  This string represents the device side definition of the discard_iterator
+    static std::string deviceDiscardIterator =
+        std::string("#if !defined(BOLT_CL_DISCARD_ITERATOR) \n#define BOLT_CL_DISCARD_ITERATOR \n") +
+        STRINGIFY_CODE(
+        namespace bolt { namespace cl { \n
+        struct discard_value \n
+        { \n
+            template< typename T > \n
+            discard_value& operator=( const T& ) \n
+            { \n
+                return *this; \n
+            } \n
+        }; \n
+
+        class discard_iterator \n
+        { \n
+        public: \n
+            typedef int iterator_category;      // device code does not understand std:: tags \n
+            typedef discard_value value_type; \n
+            typedef discard_value base_type; \n
+            typedef int difference_type; \n
+            typedef int size_type; \n
+            typedef discard_value* pointer; \n
+            typedef discard_value reference; \n
+
+            void init( global discard_value* ptr ) \n
+            { }; \n
+
+            discard_value operator[]( size_type threadID ) const \n
+            { \n
+                discard_value sink; \n
+                return sink; \n
+            } \n
+
+            discard_value operator*( ) const \n
+            { \n
+                discard_value sink; \n
+                return sink; \n
+            } \n
+
+            int m_Index; \n
+        }; \n
+    } } \n
+    )
+    +  std::string("#endif \n");
+
+    inline discard_iterator make_discard_iterator( discard_iterator::difference_type index = 0 )
+    {
+        return discard_iterator( index );
+    }
+
+    /*!   \}  */
+
+namespace detail {
+
+    template< typename Iterator >
+    struct is_discard_iterator: std::is_same< typename std::iterator_traits< Iterator >::iterator_category,
+        discard_iterator_tag >
+    {};
+
+}
+
+}
+}
+
+BOLT_CREATE_TYPENAME( bolt::cl::discard_value );
+BOLT_CREATE_CLCODE( bolt::cl::discard_value, bolt::cl::deviceDiscardIterator );
+BOLT_CREATE_TYPENAME( bolt::cl::discard_iterator );
+BOLT_CREATE_CLCODE( bolt::cl::discard_iterator, bolt::cl::deviceDiscardIterator );
+
+#endif
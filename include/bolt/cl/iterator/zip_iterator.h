@@ -0,0 +1,866 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+#pragma once
+#if !defined( BOLT_CL_ZIP_ITERATOR_H )
+#define BOLT_CL_ZIP_ITERATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/dispatch.h"
+#include "bolt/cl/tuple.h"
+#include "bolt/cl/iterator/iterator_traits.h"
+#include "bolt/cl/iterator/addressof.h"
+#include <boost/iterator/iterator_facade.hpp>
+
+/*! \file bolt/cl/iterator/zip_iterator.h
+    \brief Iterates several ranges in lockstep, dereferencing to a tuple of their elements.
+*/
+
+namespace bolt {
+namespace cl {
+
+    struct zip_iterator_tag
+        : public fancy_iterator_tag
+        {   // identifying tag for iterators over several ranges
+        };
+
+namespace detail {
+
+    //  What a zip_iterator needs to know about one of its columns; unused columns are null_type
+    template< typename Iterator >
+    struct zip_column
+    {
+        typedef typename std::iterator_traits< Iterator >::iterator_category category;
+        typedef typename std::iterator_traits< Iterator >::value_type value_type;
+        typedef typename std::iterator_traits< Iterator >::reference reference;
+        static const bool used = true;
+        static const bool on_device = std::is_same< category, device_vector_tag >::value;
+    };
+
+    template< >
+    struct zip_column< null_type >
+    {
+        typedef null_type category;
+        typedef null_type value_type;
+        typedef null_type reference;
+        static const bool used = false;
+        static const bool on_device = true;
+    };
+
+    template< typename Iterator >
+    void advanceColumn( Iterator& it, std::ptrdiff_t n )
+    {
+        it += n;
+    }
+
+    inline void advanceColumn( null_type&, std::ptrdiff_t )
+    {}
+
+    template< typename Iterator >
+    typename zip_column< Iterator >::reference dereferenceColumn( const Iterator& it )
+    {
+        return *it;
+    }
+
+    inline null_type dereferenceColumn( const null_type& )
+    {
+        return null_type( );
+    }
+
+    template< unsigned int N, typename Tuple, typename Reference >
+    void readColumn( Tuple& value, const Reference& ref )
+    {
+        bolt::cl::get< N >( value ) = ref;
+    }
+
+    template< unsigned int N, typename Tuple >
+    void readColumn( Tuple&, const null_type& )
+    {}
+
+    template< unsigned int N, typename Reference, typename Tuple >
+    void writeColumn( Reference& ref, const Tuple& value )
+    {
+        ref = bolt::cl::get< N >( value );
+    }
+
+    template< unsigned int N, typename Tuple >
+    void writeColumn( null_type&, const Tuple& )
+    {}
+
+    //  Appends the payload of a device column to the payload of its zip_iterator
+    template< typename Iterator >
+    void appendColumnPayload( char* payload, int& offset, const Iterator& it )
+    {
+        typename Iterator::Payload columnPayload = it.gpuPayload( );
+        int size = static_cast< int >( it.gpuPayloadSize( ) );
+        std::memcpy( payload + offset, &columnPayload, size );
+        offset += size;
+    }
+
+    inline void appendColumnPayload( char*, int&, const null_type& )
+    {}
+
+    template< typename Iterator >
+    int columnPayloadSize( const Iterator& it )
+    {
+        return static_cast< int >( it.gpuPayloadSize( ) );
+    }
+
+    inline int columnPayloadSize( const null_type& )
+    {
+        return 0;
+    }
+
+    template< typename Iterator >
+    int setColumnKernelBuffers( int arg_num, ::cl::Kernel& kernel, const Iterator& it )
+    {
+        return it.setKernelBuffers( arg_num, kernel );
+    }
+
+    inline int setColumnKernelBuffers( int arg_num, ::cl::Kernel&, const null_type& )
+    {
+        return arg_num;
+    }
+
+    /*! \brief The host reference of a zip_iterator: reads the columns into a tuple, and writes a tuple back into
+    *   the columns
+    */
+    template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+    class zip_reference
+    {
+    public:
+        typedef tuple< typename zip_column< Iterator0 >::value_type, typename zip_column< Iterator1 >::value_type,
+            typename zip_column< Iterator2 >::value_type, typename zip_column< Iterator3 >::value_type > value_type;
+
+        zip_reference( typename zip_column< Iterator0 >::reference r0, typename zip_column< Iterator1 >::reference r1,
+            typename zip_column< Iterator2 >::reference r2, typename zip_column< Iterator3 >::reference r3 ):
+            m_r0( r0 ), m_r1( r1 ), m_r2( r2 ), m_r3( r3 )
+        {}
+
+        operator value_type( ) const
+        {
+            value_type value;
+            readColumn< 0 >( value, m_r0 );
+            readColumn< 1 >( value, m_r1 );
+            readColumn< 2 >( value, m_r2 );
+            readColumn< 3 >( value, m_r3 );
+            return value;
+        }
+
+        zip_reference& operator=( const value_type& value )
+        {
+            writeColumn< 0 >( m_r0, value );
+            writeColumn< 1 >( m_r1, value );
+            writeColumn< 2 >( m_r2, value );
+            writeColumn< 3 >( m_r3, value );
+            return *this;
+        }
+
+        zip_reference& operator=( const zip_reference& rhs )
+        {
+            return *this = static_cast< value_type >( rhs );
+        }
+
+    private:
+        typename zip_column< Iterator0 >::reference m_r0;
+        typename zip_column< Iterator1 >::reference m_r1;
+        typename zip_column< Iterator2 >::reference m_r2;
+        typename zip_column< Iterator3 >::reference m_r3;
+    };
+
+    template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+    void swap( zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 > lhs,
+        zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 > rhs )
+    {
+        typename zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 >::value_type tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+}
+
+        /*! \addtogroup fancy_iterators
+         */
+
+        /*! \addtogroup CL-ZipIterator
+        *   \ingroup fancy_iterators
+        *   \{
+        */
+
+        /*! zip_iterator iterates two to four ranges in lockstep.  Dereferencing it yields a \p tuple of the elements
+         *  at the same position in each range, and assigning a \p tuple through it writes each element back into its
+         *  own range.  Data kept as a structure of arrays can so be handed to algorithms that expect an array of
+         *  structures, without packing it first.
+         *
+         *  The columns may be \p device_vector iterators or host random access iterators; on the OpenCL path host
+         *  columns are wrapped in device buffers, and on the CPU paths device columns are mapped once per call.
+         *  \p transform, \p copy and \p copy_n accept zip_iterators as inputs and output; \p fill, \p fill_n,
+         *  \p generate and \p generate_n as output; \p reduce, \p transform_reduce, \p count, \p count_if and
+         *  \p inner_product as input; the kernels of these take each column as a buffer of its own.  \p gather,
+         *  \p gather_if, \p scatter and \p scatter_if move a zipped input into a zipped result a column at a time,
+         *  and \p sort_by_key and \p stable_sort_by_key take zipped values.  The scans, sorts, merges, searches,
+         *  set operations and the by-key reductions, compactions and partitions reject zip_iterators at compile time.
+         *
+         *  \details The following demonstrates how to use a \p zip_iterator.
+         *
+         *  \code
+         *  #include <bolt/cl/iterator/zip_iterator.h>
+         *  #include <bolt/cl/sort_by_key.h>
+         *  ...
+         *
+         *  bolt::cl::device_vector< int > keys( n );
+         *  bolt::cl::device_vector< float > x( n ), y( n );
+         *  ...
+         *  // Reorders x and y together by key
+         *  bolt::cl::sort_by_key( keys.begin( ), keys.end( ), bolt::cl::make_zip_iterator( x.begin( ), y.begin( ) ) );
+         *  \endcode
+         *
+         */
+
+        template< typename Iterator0, typename Iterator1, typename Iterator2 = null_type,
+            typename Iterator3 = null_type >
+        class zip_iterator: public boost::iterator_facade< zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 >,
+            typename detail::zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 >::value_type, zip_iterator_tag,
+            detail::zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 >, std::ptrdiff_t >
+        {
+            typedef boost::iterator_facade< zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 >,
+                typename detail::zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 >::value_type,
+                zip_iterator_tag, detail::zip_reference< Iterator0, Iterator1, Iterator2, Iterator3 >,
+                std::ptrdiff_t > facade;
+
+        public:
+            typedef typename facade::difference_type                    difference_type;
+            typedef typename facade::value_type                         value_type;
+            typedef typename facade::reference                          reference;
+            typedef zip_iterator_tag                                    iterator_category;
+            typedef typename std::conditional< detail::zip_column< Iterator0 >::on_device &&
+                detail::zip_column< Iterator1 >::on_device && detail::zip_column< Iterator2 >::on_device &&
+                detail::zip_column< Iterator3 >::on_device, device_vector_tag,
+                std::random_access_iterator_tag >::type                 memory_system;
+
+            typedef Iterator0 iterator0;
+            typedef Iterator1 iterator1;
+            typedef Iterator2 iterator2;
+            typedef Iterator3 iterator3;
+
+            //  The number of columns
+            static const int columns = 2 + detail::zip_column< Iterator2 >::used + detail::zip_column< Iterator3 >::used;
+
+            //  The concatenated payloads of the columns, in the layout of the device side zip_iterator
+            struct Payload
+            {
+                char m_Columns[ 4 * sizeof( typename device_vector< int >::iterator::Payload ) ];
+            };
+
+            zip_iterator( const Iterator0& it0, const Iterator1& it1, const Iterator2& it2 = Iterator2( ),
+                const Iterator3& it3 = Iterator3( ) ): m_it0( it0 ), m_it1( it1 ), m_it2( it2 ), m_it3( it3 )
+            {}
+
+            const Iterator0& column0( ) const
+            {
+                return m_it0;
+            }
+
+            const Iterator1& column1( ) const
+            {
+                return m_it1;
+            }
+
+            const Iterator2& column2( ) const
+            {
+                return m_it2;
+            }
+
+            const Iterator3& column3( ) const
+            {
+                return m_it3;
+            }
+
+            Payload gpuPayload( ) const
+            {
+                Payload payload = { };
+                int offset = 0;
+                detail::appendColumnPayload( payload.m_Columns, offset, m_it0 );
+                detail::appendColumnPayload( payload.m_Columns, offset, m_it1 );
+                detail::appendColumnPayload( payload.m_Columns, offset, m_it2 );
+                detail::appendColumnPayload( payload.m_Columns, offset, m_it3 );
+                return payload;
+            }
+
+            const difference_type gpuPayloadSize( ) const
+            {
+                return detail::columnPayloadSize( m_it0 ) + detail::columnPayloadSize( m_it1 )
+                    + detail::columnPayloadSize( m_it2 ) + detail::columnPayloadSize( m_it3 );
+            }
+
+            //  Each column passes its own buffer, in column order
+            int setKernelBuffers( int arg_num, ::cl::Kernel& kernel ) const
+            {
+                arg_num = detail::setColumnKernelBuffers( arg_num, kernel, m_it0 );
+                arg_num = detail::setColumnKernelBuffers( arg_num, kernel, m_it1 );
+                arg_num = detail::setColumnKernelBuffers( arg_num, kernel, m_it2 );
+                return detail::setColumnKernelBuffers( arg_num, kernel, m_it3 );
+            }
+
+        private:
+            //  Implementation detail of boost.iterator
+            friend class boost::iterator_core_access;
+
+            void advance( difference_type n )
+            {
+                detail::advanceColumn( m_it0, n );
+                detail::advanceColumn( m_it1, n );
+                detail::advanceColumn( m_it2, n );
+                detail::advanceColumn( m_it3, n );
+            }
+
+            void increment( )
+            {
+                advance( 1 );
+            }
+
+            void decrement( )
+            {
+                advance( -1 );
+            }
+
+            //  The columns move together, so the first one stands for all of them
+            bool equal( const zip_iterator& rhs ) const
+            {
+                return m_it0 == rhs.m_it0;
+            }
+
+            difference_type distance_to( const zip_iterator& rhs ) const
+            {
+                return static_cast< difference_type >( rhs.m_it0 - m_it0 );
+            }
+
+            reference dereference( ) const
+            {
+                return reference( detail::dereferenceColumn( m_it0 ), detail::dereferenceColumn( m_it1 ),
+                    detail::dereferenceColumn( m_it2 ), detail::dereferenceColumn( m_it3 ) );
+            }
+
+            Iterator0 m_it0;
+            Iterator1 m_it1;
+            Iterator2 m_it2;
+            Iterator3 m_it3;
+        };
+
+    template< typename Iterator0, typename Iterator1 >
+    zip_iterator< Iterator0, Iterator1 > make_zip_iterator( const Iterator0& it0, const Iterator1& it1 )
+    {
+        return zip_iterator< Iterator0, Iterator1 >( it0, it1 );
+    }
+
+    template< typename Iterator0, typename Iterator1, typename Iterator2 >
+    zip_iterator< Iterator0, Iterator1, Iterator2 > make_zip_iterator( const Iterator0& it0, const Iterator1& it1,
+        const Iterator2& it2 )
+    {
+        return zip_iterator< Iterator0, Iterator1, Iterator2 >( it0, it1, it2 );
+    }
+
+    template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+    zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 > make_zip_iterator( const Iterator0& it0,
+        const Iterator1& it1, const Iterator2& it2, const Iterator3& it3 )
+    {
+        return zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 >( it0, it1, it2, it3 );
+    }
+
+    /*! \}
+    */
+
+    //  This string represents the device side definition of the zip_iterator template.  The columns are
+    //  device_vector iterators; the reference holds a pointer into each of them.
+    static std::string deviceZipIterator =
+        std::string("#if !defined(BOLT_CL_ZIP_ITERATOR) \n#define BOLT_CL_ZIP_ITERATOR \n") +
+        STRINGIFY_CODE(
+        namespace bolt { namespace cl { \n
+        template< typename I0, typename I1, typename I2 = null_type, typename I3 = null_type > \n
+        class zip_iterator \n
+        { \n
+        public: \n
+            typedef int iterator_category;      // device code does not understand std:: tags \n
+            typedef tuple< typename I0::value_type, typename I1::value_type, typename I2::value_type, \n
+                typename I3::value_type > value_type; \n
+            typedef typename I0::base_type base_type; \n
+            typedef typename I1::base_type base_type1; \n
+            typedef typename I2::base_type base_type2; \n
+            typedef typename I3::base_type base_type3; \n
+            typedef int size_type; \n
+
+            class reference \n
+            { \n
+            public: \n
+                reference( global base_type* p0, global base_type1* p1, global base_type2* p2, \n
+                    global base_type3* p3 ): m_p0( p0 ), m_p1( p1 ), m_p2( p2 ), m_p3( p3 ) \n
+                {} \n
+
+                operator value_type( ) const \n
+                { \n
+                    return value_type( *m_p0, *m_p1, *m_p2, *m_p3 ); \n
+                } \n
+
+                reference& operator=( const value_type& value ) \n
+                { \n
+                    *m_p0 = value.first; *m_p1 = value.second; *m_p2 = value.third; *m_p3 = value.fourth; \n
+                    return *this; \n
+                } \n
+
+                global base_type* m_p0; \n
+                global base_type1* m_p1; \n
+                global base_type2* m_p2; \n
+                global base_type3* m_p3; \n
+            }; \n
+
+            void init( global base_type* p0, global base_type1* p1, global base_type2* p2, global base_type3* p3 ) \n
+            { \n
+                m_it0.init( p0 ); m_it1.init( p1 ); m_it2.init( p2 ); m_it3.init( p3 ); \n
+            } \n
+
+            reference operator[]( size_type threadID ) const \n
+            { \n
+                return reference( &m_it0[ threadID ], &m_it1[ threadID ], &m_it2[ threadID ], &m_it3[ threadID ] ); \n
+            } \n
+
+            I0 m_it0; \n
+            I1 m_it1; \n
+            I2 m_it2; \n
+            I3 m_it3; \n
+        }; \n
+
+        template< typename I0, typename I1, typename I2 > \n
+        class zip_iterator< I0, I1, I2, null_type > \n
+        { \n
+        public: \n
+            typedef int iterator_category; \n
+            typedef tuple< typename I0::value_type, typename I1::value_type, typename I2::value_type > value_type; \n
+            typedef typename I0::base_type base_type; \n
+            typedef typename I1::base_type base_type1; \n
+            typedef typename I2::base_type base_type2; \n
+            typedef int size_type; \n
+
+            class reference \n
+            { \n
+            public: \n
+                reference( global base_type* p0, global base_type1* p1, global base_type2* p2 ): \n
+                    m_p0( p0 ), m_p1( p1 ), m_p2( p2 ) \n
+                {} \n
+
+                operator value_type( ) const \n
+                { \n
+                    return value_type( *m_p0, *m_p1, *m_p2 ); \n
+                } \n
+
+                reference& operator=( const value_type& value ) \n
+                { \n
+                    *m_p0 = value.first; *m_p1 = value.second; *m_p2 = value.third; \n
+                    return *this; \n
+                } \n
+
+                global base_type* m_p0; \n
+                global base_type1* m_p1; \n
+                global base_type2* m_p2; \n
+            }; \n
+
+            void init( global base_type* p0, global base_type1* p1, global base_type2* p2 ) \n
+            { \n
+                m_it0.init( p0 ); m_it1.init( p1 ); m_it2.init( p2 ); \n
+            } \n
+
+            reference operator[]( size_type threadID ) const \n
+            { \n
+                return reference( &m_it0[ threadID ], &m_it1[ threadID ], &m_it2[ threadID ] ); \n
+            } \n
+
+            I0 m_it0; \n
+            I1 m_it1; \n
+            I2 m_it2; \n
+        }; \n
+
+        template< typename I0, typename I1 > \n
+        class zip_iterator< I0, I1, null_type, null_type > \n
+        { \n
+        public: \n
+            typedef int iterator_category; \n
+            typedef tuple< typename I0::value_type, typename I1::value_type > value_type; \n
+            typedef typename I0::base_type base_type; \n
+            typedef typename I1::base_type base_type1; \n
+            typedef int size_type; \n
+
+            class reference \n
+            { \n
+            public: \n
+                reference( global base_type* p0, global base_type1* p1 ): m_p0( p0 ), m_p1( p1 ) \n
+                {} \n
+
+                operator value_type( ) const \n
+                { \n
+                    return value_type( *m_p0, *m_p1 ); \n
+                } \n
+
+                reference& operator=( const value_type& value ) \n
+                { \n
+                    *m_p0 = value.first; *m_p1 = value.second; \n
+                    return *this; \n
+                } \n
+
+                global base_type* m_p0; \n
+                global base_type1* m_p1; \n
+            }; \n
+
+            void init( global base_type* p0, global base_type1* p1 ) \n
+            { \n
+                m_it0.init( p0 ); m_it1.init( p1 ); \n
+            } \n
+
+            reference operator[]( size_type threadID ) const \n
+            { \n
+                return reference( &m_it0[ threadID ], &m_it1[ threadID ] ); \n
+            } \n
+
+            I0 m_it0; \n
+            I1 m_it1; \n
+        }; \n
+    } } \n
+    )
+    +  std::string("#endif \n");
+
+namespace detail {
+
+    template< typename Iterator >
+    struct is_zip_iterator: std::is_same< typename zip_column< Iterator >::category, zip_iterator_tag >
+    {};
+
+    //  A zip_iterator the OpenCL kernels can take as it is: every column lives in a device_vector
+    template< typename Iterator, bool Zip = is_zip_iterator< Iterator >::value >
+    struct is_device_zip_iterator: std::is_same< typename Iterator::memory_system, device_vector_tag >
+    {};
+
+    template< typename Iterator >
+    struct is_device_zip_iterator< Iterator, false >: std::false_type
+    {};
+
+    //  Binds the buffers a kernel takes for a device range from argument arg_num on, and returns the next argument:
+    //  the buffer of its container, or one per column for a zip_iterator
+    template< typename Iterator, typename Category >
+    int setRangeBuffers( ::cl::Kernel& kernel, int arg_num, const Iterator& it, Category )
+    {
+        V_OPENCL( kernel.setArg( arg_num, it.base( ).getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        return arg_num + 1;
+    }
+
+    template< typename Iterator >
+    int setRangeBuffers( ::cl::Kernel& kernel, int arg_num, const Iterator& it, zip_iterator_tag )
+    {
+        return it.setKernelBuffers( arg_num, kernel );
+    }
+
+    template< typename Iterator >
+    int setRangeBuffers( ::cl::Kernel& kernel, int arg_num, const Iterator& it )
+    {
+        return setRangeBuffers( kernel, arg_num, it, typename std::iterator_traits< Iterator >::iterator_category( ) );
+    }
+
+    /*! \brief A host iterator over n elements of a range, for the CPU paths
+    *   \details Host iterators and fancy iterators are used as they are; device_vector ranges are mapped once for the
+    *   lifetime of the view rather than once per element; a zip_iterator gets a view of each column.
+    */
+    template< typename Iterator, typename Category = typename zip_column< Iterator >::category >
+    class host_view
+    {
+    public:
+        typedef Iterator iterator;
+
+        host_view( control&, const Iterator& it, size_t, cl_map_flags ): m_it( it )
+        {}
+
+        iterator begin( )
+        {
+            return m_it;
+        }
+
+    private:
+        Iterator m_it;
+    };
+
+    template< typename Iterator >
+    class host_view< Iterator, null_type >
+    {
+    public:
+        typedef null_type iterator;
+
+        host_view( control&, const null_type&, size_t, cl_map_flags )
+        {}
+
+        iterator begin( )
+        {
+            return null_type( );
+        }
+    };
+
+    template< typename Iterator >
+    class host_view< Iterator, device_vector_tag >
+    {
+    public:
+        typedef typename std::iterator_traits< Iterator >::value_type value_type;
+        typedef value_type* iterator;
+
+        host_view( control& ctl, const Iterator& it, size_t n, cl_map_flags flags ): m_queue( ctl.getCommandQueue( ) ),
+            m_buffer( it.getContainer( ).getBuffer( ) )
+        {
+            //  Outputs may hold fewer elements than the input range that fills them
+            size_t available = m_buffer.getInfo< CL_MEM_SIZE >( ) / sizeof( value_type ) - it.m_Index;
+            n = std::min( n, available );
+
+            cl_int l_Error = CL_SUCCESS;
+            m_ptr = static_cast< value_type* >( m_queue.enqueueMapBuffer( m_buffer, true, flags,
+                it.m_Index * sizeof( value_type ), n * sizeof( value_type ), NULL, NULL, &l_Error ) );
+            V_OPENCL( l_Error, "host_view failed to map device memory to host memory" );
+        }
+
+        ~host_view( )
+        {
+            ::cl::Event unmapEvent;
+            m_queue.enqueueUnmapMemObject( m_buffer, m_ptr, NULL, &unmapEvent );
+            unmapEvent.wait( );
+        }
+
+        iterator begin( )
+        {
+            return m_ptr;
+        }
+
+    private:
+        host_view( const host_view& );
+        host_view& operator=( const host_view& );
+
+        ::cl::CommandQueue m_queue;
+        ::cl::Buffer m_buffer;
+        value_type* m_ptr;
+    };
+
+    template< typename Iterator >
+    class host_view< Iterator, zip_iterator_tag >
+    {
+    public:
+        typedef zip_iterator< typename host_view< typename Iterator::iterator0 >::iterator,
+            typename host_view< typename Iterator::iterator1 >::iterator,
+            typename host_view< typename Iterator::iterator2 >::iterator,
+            typename host_view< typename Iterator::iterator3 >::iterator > iterator;
+
+        host_view( control& ctl, const Iterator& it, size_t n, cl_map_flags flags ):
+            m_view0( ctl, it.column0( ), n, flags ), m_view1( ctl, it.column1( ), n, flags ),
+            m_view2( ctl, it.column2( ), n, flags ), m_view3( ctl, it.column3( ), n, flags )
+        {}
+
+        iterator begin( )
+        {
+            return iterator( m_view0.begin( ), m_view1.begin( ), m_view2.begin( ), m_view3.begin( ) );
+        }
+
+    private:
+        host_view< typename Iterator::iterator0 > m_view0;
+        host_view< typename Iterator::iterator1 > m_view1;
+        host_view< typename Iterator::iterator2 > m_view2;
+        host_view< typename Iterator::iterator3 > m_view3;
+    };
+
+    /*! \brief An iterator over n elements of a range that the OpenCL kernels can take, for the OpenCL path
+    *   \details Device and fancy iterators are used as they are; host ranges are wrapped in a device_vector over the
+    *   host memory, and sync( ) makes what the device wrote visible there; a zip_iterator gets a view of each column.
+    */
+    template< typename Iterator, typename Category = typename zip_column< Iterator >::category >
+    class device_view
+    {
+    public:
+        typedef Iterator iterator;
+
+        device_view( control&, const Iterator& it, int, bool ): m_it( it )
+        {}
+
+        iterator begin( )
+        {
+            return m_it;
+        }
+
+        void sync( )
+        {}
+
+    private:
+        Iterator m_it;
+    };
+
+    template< typename Iterator >
+    class device_view< Iterator, null_type >
+    {
+    public:
+        typedef null_type iterator;
+
+        device_view( control&, const null_type&, int, bool )
+        {}
+
+        iterator begin( )
+        {
+            return null_type( );
+        }
+
+        void sync( )
+        {}
+    };
+
+    template< typename Iterator >
+    class device_view< Iterator, std::random_access_iterator_tag >
+    {
+    public:
+        typedef typename std::iterator_traits< Iterator >::value_type value_type;
+        typedef typename device_vector< value_type >::iterator iterator;
+
+        //  copyIn is false for ranges the device only writes
+        device_view( control& ctl, const Iterator& it, int n, bool copyIn ):
+            m_vector( bolt::cl::addressof( it ), n, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, copyIn, ctl )
+        {}
+
+        iterator begin( )
+        {
+            return m_vector.begin( );
+        }
+
+        void sync( )
+        {
+            m_vector.data( );
+        }
+
+    private:
+        device_vector< value_type > m_vector;
+    };
+
+    template< typename Iterator >
+    class device_view< Iterator, zip_iterator_tag >
+    {
+    public:
+        typedef zip_iterator< typename device_view< typename Iterator::iterator0 >::iterator,
+            typename device_view< typename Iterator::iterator1 >::iterator,
+            typename device_view< typename Iterator::iterator2 >::iterator,
+            typename device_view< typename Iterator::iterator3 >::iterator > iterator;
+
+        device_view( control& ctl, const Iterator& it, int n, bool copyIn ):
+            m_view0( ctl, it.column0( ), n, copyIn ), m_view1( ctl, it.column1( ), n, copyIn ),
+            m_view2( ctl, it.column2( ), n, copyIn ), m_view3( ctl, it.column3( ), n, copyIn )
+        {}
+
+        iterator begin( )
+        {
+            return iterator( m_view0.begin( ), m_view1.begin( ), m_view2.begin( ), m_view3.begin( ) );
+        }
+
+        void sync( )
+        {
+            m_view0.sync( );
+            m_view1.sync( );
+            m_view2.sync( );
+            m_view3.sync( );
+        }
+
+    private:
+        device_view< typename Iterator::iterator0 > m_view0;
+        device_view< typename Iterator::iterator1 > m_view1;
+        device_view< typename Iterator::iterator2 > m_view2;
+        device_view< typename Iterator::iterator3 > m_view3;
+    };
+
+    //  Bytes a zip_iterator moves are the bytes its columns move
+    template< typename Iterator >
+    size_t columnHostBytes( const Iterator& it, size_t elements )
+    {
+        return hostBytes( it, elements );
+    }
+
+    inline size_t columnHostBytes( const null_type&, size_t )
+    {
+        return 0;
+    }
+
+    template< typename Iterator >
+    size_t columnDeviceBytes( const Iterator& it, size_t elements )
+    {
+        return deviceBytes( it, elements );
+    }
+
+    inline size_t columnDeviceBytes( const null_type&, size_t )
+    {
+        return 0;
+    }
+
+    template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+    size_t hostBytes( const zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 >& it, size_t elements )
+    {
+        return columnHostBytes( it.column0( ), elements ) + columnHostBytes( it.column1( ), elements )
+            + columnHostBytes( it.column2( ), elements ) + columnHostBytes( it.column3( ), elements );
+    }
+
+    template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+    size_t deviceBytes( const zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 >& it, size_t elements )
+    {
+        return columnDeviceBytes( it.column0( ), elements ) + columnDeviceBytes( it.column1( ), elements )
+            + columnDeviceBytes( it.column2( ), elements ) + columnDeviceBytes( it.column3( ), elements );
+    }
+
+}
+
+}
+}
+
+//  The name of a zip_iterator lists its columns; the null_type columns are the defaults and are left out
+template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+struct TypeName< bolt::cl::zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 > >
+{
+    static std::string get( )
+    {
+        std::string name = "bolt::cl::zip_iterator< " + TypeName< Iterator0 >::get( ) + ", "
+            + TypeName< Iterator1 >::get( );
+        if( !std::is_same< Iterator2, bolt::cl::null_type >::value )
+            name += ", " + TypeName< Iterator2 >::get( );
+        if( !std::is_same< Iterator3, bolt::cl::null_type >::value )
+            name += ", " + TypeName< Iterator3 >::get( );
+        return name + " >";
+    }
+};
+
+//  The code of a zip_iterator is the code of its columns and of its value type, then the zip_iterator template
+template< typename Iterator0, typename Iterator1, typename Iterator2, typename Iterator3 >
+struct ClCode< bolt::cl::zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 > >
+{
+    static std::string get( )
+    {
+        typedef typename bolt::cl::zip_iterator< Iterator0, Iterator1, Iterator2, Iterator3 >::value_type value_type;
+
+        return bolt::cl::guardCode( ClCode< Iterator0 >::get( ) )
+            + bolt::cl::guardCode( ClCode< Iterator1 >::get( ) )
+            + bolt::cl::guardCode( ClCode< Iterator2 >::get( ) )
+            + bolt::cl::guardCode( ClCode< Iterator3 >::get( ) )
+            + bolt::cl::guardCode( ClCode< value_type >::get( ) )
+            + bolt::cl::deviceZipIterator;
+    }
+};
+
+#endif
@@ -0,0 +1,152 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MERGE_BY_KEY_H )
+#define BOLT_CL_MERGE_BY_KEY_H
+#pragma once
+
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/pair.h"
+
+#include <string>
+
+/*! \file bolt/cl/merge_by_key.h
+    \brief Merges two ranges sorted by key, carrying a value along with every key.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup CL-merge_by_key
+        *   \ingroup sorting
+        *   \{
+        */
+
+        /*! merge_by_key merges the sorted keys [keys_first1, keys_last1) and [keys_first2, keys_last2) to the
+         *  sequence beginning at keys_result, and moves the value of every key to the same place in the sequence
+         *  beginning at values_result.  Equal keys keep their order, those of the first range first.
+         *
+         *  \details The OpenCL path splits the merge into equal pieces with merge-path partitioning, so every work
+         *  item writes the same number of elements whatever the keys look like.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param keys_first1 Beginning of the first sorted key sequence.
+         * \param keys_last1  End of the first sorted key sequence.
+         * \param keys_first2 Beginning of the second sorted key sequence.
+         * \param keys_last2  End of the second sorted key sequence.
+         * \param values_first1 Beginning of the values of the first key sequence.
+         * \param values_first2 Beginning of the values of the second key sequence.
+         * \param keys_result Beginning of the destination key sequence.
+         * \param values_result Beginning of the destination value sequence.
+         * \param comp \b Optional Strict weak ordering the keys are sorted by; bolt::cl::less by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return A pair of the ends of the destination key and value sequences.
+         *
+         * \tparam InputIterator1 is a model of InputIterator
+         * \tparam InputIterator2 is a model of InputIterator
+         * \tparam InputIterator3 is a model of InputIterator
+         * \tparam InputIterator4 is a model of InputIterator
+         * \tparam OutputIterator1 is a model of OutputIterator
+         * \tparam OutputIterator2 is a model of OutputIterator
+         * \tparam StrictWeakCompare is a model of Strict Weak Ordering
+         *
+         *  \code
+         *  #include <bolt/cl/merge_by_key.h>
+         *  ...
+         *
+         *  int keys1[ 3 ] = { 1, 3, 5 };
+         *  int keys2[ 3 ] = { 2, 3, 4 };
+         *  char values1[ 3 ] = { 'a', 'b', 'c' };
+         *  char values2[ 3 ] = { 'x', 'y', 'z' };
+         *  int keys[ 6 ];
+         *  char values[ 6 ];
+         *
+         *  bolt::cl::merge_by_key( keys1, keys1 + 3, keys2, keys2 + 3, values1, values2, keys, values );
+         *
+         *  // keys is { 1, 2, 3, 3, 4, 5 } and values is { 'a', 'x', 'b', 'y', 'z', 'c' }
+         *  \endcode
+         *
+         *  \sa bolt::cl::merge
+         */
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2> merge_by_key(
+            bolt::cl::control &ctl,
+            InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2> merge_by_key(
+            InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2,
+                 typename StrictWeakCompare>
+        pair<OutputIterator1, OutputIterator2> merge_by_key(
+            bolt::cl::control &ctl,
+            InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2,
+                 typename StrictWeakCompare>
+        pair<OutputIterator1, OutputIterator2> merge_by_key(
+            InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        /*!   \}  */
+    };
+};
+
+#include <bolt/cl/detail/merge_by_key.inl>
+#endif
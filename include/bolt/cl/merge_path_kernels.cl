@@ -0,0 +1,296 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+***************************************************************************/                                                                                     
+
+
+//  Merge-path partitioning for the set operations and merge_by_key.  The merge of two sorted ranges is a monotone
+//  path through the a/b grid; every work item owns itemsPerThread steps of it, found by a binary search along its
+//  diagonal, so the work splits evenly whatever the keys look like.  Ties are taken from a first, as std::merge
+//  does.
+
+#define SET_UNION                   0
+#define SET_INTERSECTION            1
+#define SET_DIFFERENCE              2
+#define SET_SYMMETRIC_DIFFERENCE    3
+
+//  Returns how many elements of a come before the diag'th element of the merge
+template< typename iIterType1, typename iIterType2, typename Compare >
+uint mergePath( iIterType1 a, uint aCount, iIterType2 b, uint bCount, uint diag, global Compare* comp )
+{
+    uint begin = ( diag > bCount ) ? diag - bCount : 0;
+    uint end = min( diag, aCount );
+
+    while( begin < end )
+    {
+        uint mid = ( begin + end ) / 2;
+        if( ( *comp )( b[ diag - 1 - mid ], a[ mid ] ) )
+            end = mid;
+        else
+            begin = mid + 1;
+    }
+    return begin;
+}
+
+template< typename vType, typename iIterType, typename Compare >
+uint mergePathLowerBound( iIterType a, uint begin, uint end, vType value, global Compare* comp )
+{
+    while( begin < end )
+    {
+        uint mid = ( begin + end ) / 2;
+        if( ( *comp )( a[ mid ], value ) )
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+    return begin;
+}
+
+template< typename vType, typename iIterType, typename Compare >
+uint mergePathUpperBound( iIterType a, uint begin, uint end, vType value, global Compare* comp )
+{
+    while( begin < end )
+    {
+        uint mid = ( begin + end ) / 2;
+        if( ( *comp )( value, a[ mid ] ) )
+            end = mid;
+        else
+            begin = mid + 1;
+    }
+    return begin;
+}
+
+//  Walks count steps of the merge from (i, j) and returns how many elements operation keeps, writing them from
+//  result[ position ] when write is set.  An element of a with rank r among its equals in a, which has n equals
+//  in b, belongs to the intersection when r < n and to the difference when r >= n; an element of b with rank s
+//  among its equals, which has m equals in a, belongs to the union when s >= m.  The ranks carry over inside the
+//  walk, so searching is only needed at its start and at the start of each new key.
+template< typename iType1, typename iType2, typename iIterType1, typename iIterType2, typename oIterType,
+          typename Compare >
+uint setOperationWalk( iIterType1 a, uint aCount, iIterType2 b, uint bCount, uint i, uint j, uint count,
+    int operation, global Compare* comp, oIterType result, uint position, bool write )
+{
+    uint written = 0;
+    uint aRank = 0, aOther = 0, bRank = 0, bOther = 0;
+    bool aStarted = false, bStarted = false;
+
+    for( uint step = 0; step < count; ++step )
+    {
+        if( j >= bCount || ( i < aCount && !( *comp )( b[ j ], a[ i ] ) ) )
+        {
+            iType1 x = a[ i ];
+            if( aStarted && !( *comp )( a[ i - 1 ], x ) )
+                ++aRank;
+            else
+            {
+                aRank = i - mergePathLowerBound( a, 0, i, x, comp );
+                aOther = mergePathUpperBound( b, j, bCount, x, comp ) - j;
+                aStarted = true;
+            }
+
+            bool keep = ( operation == SET_UNION ) ||
+                ( ( operation == SET_INTERSECTION ) ? ( aRank < aOther ) : ( aRank >= aOther ) );
+            if( keep )
+            {
+                if( write )
+                    result[ position + written ] = x;
+                ++written;
+            }
+            ++i;
+        }
+        else
+        {
+            iType2 y = b[ j ];
+            if( bStarted && !( *comp )( b[ j - 1 ], y ) )
+                ++bRank;
+            else
+            {
+                bRank = j - mergePathLowerBound( b, 0, j, y, comp );
+                bOther = i - mergePathLowerBound( a, 0, i, y, comp );
+                bStarted = true;
+            }
+
+            bool keep = ( operation == SET_UNION || operation == SET_SYMMETRIC_DIFFERENCE ) && ( bRank >= bOther );
+            if( keep )
+            {
+                if( write )
+                    result[ position + written ] = y;
+                ++written;
+            }
+            ++j;
+        }
+    }
+    return written;
+}
+
+//  Launched twice.  The first launch leaves the number of elements every work group keeps in groupCounts; the
+//  second adds up the counts of the groups before its own, scans the counts of its work items and writes.
+template< typename iType1, typename iIterType1,
+          typename iType2, typename iIterType2,
+          typename oType, typename oIterType,
+          typename Compare >
+kernel void setOperationTemplate(
+    global iType1* input1_ptr,
+    iIterType1 input1,
+    const uint length1,
+    global iType2* input2_ptr,
+    iIterType2 input2,
+    const uint length2,
+    global oType* output_ptr,
+    oIterType output,
+    const uint itemsPerThread,
+    const int operation,
+    const int writeOutput,
+    global Compare* comp,
+    global uint* groupCounts,
+    local uint* scratch )
+{
+    input1.init( input1_ptr );
+    input2.init( input2_ptr );
+    output.init( output_ptr );
+
+    uint lid = get_local_id( 0 );
+    uint wgSize = get_local_size( 0 );
+    uint group = get_group_id( 0 );
+    uint numGroups = get_num_groups( 0 );
+
+    uint total = length1 + length2;
+    uint diag = min( ( uint )get_global_id( 0 ) * itemsPerThread, total );
+    uint count = min( itemsPerThread, total - diag );
+    uint i = mergePath( input1, length1, input2, length2, diag, comp );
+
+    uint kept = setOperationWalk< iType1, iType2 >( input1, length1, input2, length2, i, diag - i, count,
+        operation, comp, output, 0, false );
+
+    scratch[ lid ] = kept;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    if( !writeOutput )
+    {
+        for( uint offset = wgSize / 2; offset > 0; offset >>= 1 )
+        {
+            if( lid < offset )
+                scratch[ lid ] += scratch[ lid + offset ];
+            barrier( CLK_LOCAL_MEM_FENCE );
+        }
+        if( lid == 0 )
+            groupCounts[ group ] = scratch[ 0 ];
+        return;
+    }
+
+    //  Inclusive scan of the counts over the work group
+    for( uint offset = 1; offset < wgSize; offset <<= 1 )
+    {
+        uint add = ( lid >= offset ) ? scratch[ lid - offset ] : 0;
+        barrier( CLK_LOCAL_MEM_FENCE );
+        scratch[ lid ] += add;
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+    uint position = scratch[ lid ] - kept;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Where this work group starts in the output
+    uint before = 0;
+    uint all = 0;
+    for( uint g = lid; g < numGroups; g += wgSize )
+    {
+        uint groupCount = groupCounts[ g ];
+        before += ( g < group ) ? groupCount : 0;
+        all += groupCount;
+    }
+    scratch[ lid ] = before;
+    barrier( CLK_LOCAL_MEM_FENCE );
+    for( uint offset = wgSize / 2; offset > 0; offset >>= 1 )
+    {
+        if( lid < offset )
+            scratch[ lid ] += scratch[ lid + offset ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+    position += scratch[ 0 ];
+
+    //  The host reads the size of the output back from the slot after the group counts
+    if( group == 0 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        scratch[ lid ] = all;
+        barrier( CLK_LOCAL_MEM_FENCE );
+        for( uint offset = wgSize / 2; offset > 0; offset >>= 1 )
+        {
+            if( lid < offset )
+                scratch[ lid ] += scratch[ lid + offset ];
+            barrier( CLK_LOCAL_MEM_FENCE );
+        }
+        if( lid == 0 )
+            groupCounts[ numGroups ] = scratch[ 0 ];
+    }
+
+    setOperationWalk< iType1, iType2 >( input1, length1, input2, length2, i, diag - i, count, operation, comp,
+        output, position, true );
+}
+
+//  Every work item merges its itemsPerThread steps straight to their places in the output
+template< typename kType1, typename kIterType1,
+          typename kType2, typename kIterType2,
+          typename vType1, typename vIterType1,
+          typename vType2, typename vIterType2,
+          typename koType, typename koIterType,
+          typename voType, typename voIterType,
+          typename Compare >
+kernel void mergeByKeyTemplate(
+    global kType1* keys1_ptr,
+    kIterType1 keys1,
+    const uint length1,
+    global kType2* keys2_ptr,
+    kIterType2 keys2,
+    const uint length2,
+    global vType1* values1_ptr,
+    vIterType1 values1,
+    global vType2* values2_ptr,
+    vIterType2 values2,
+    global koType* keysOutput_ptr,
+    koIterType keysOutput,
+    global voType* valuesOutput_ptr,
+    voIterType valuesOutput,
+    const uint itemsPerThread,
+    global Compare* comp )
+{
+    keys1.init( keys1_ptr );
+    keys2.init( keys2_ptr );
+    values1.init( values1_ptr );
+    values2.init( values2_ptr );
+    keysOutput.init( keysOutput_ptr );
+    valuesOutput.init( valuesOutput_ptr );
+
+    uint total = length1 + length2;
+    uint diag = min( ( uint )get_global_id( 0 ) * itemsPerThread, total );
+    uint end = min( diag + itemsPerThread, total );
+    uint i = mergePath( keys1, length1, keys2, length2, diag, comp );
+    uint j = diag - i;
+
+    for( uint out = diag; out < end; ++out )
+    {
+        if( j >= length2 || ( i < length1 && !( *comp )( keys2[ j ], keys1[ i ] ) ) )
+        {
+            keysOutput[ out ] = keys1[ i ];
+            valuesOutput[ out ] = values1[ i ];
+            ++i;
+        }
+        else
+        {
+            keysOutput[ out ] = keys2[ j ];
+            valuesOutput[ out ] = values2[ j ];
+            ++j;
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PARTITION_H )
+#define BOLT_CL_PARTITION_H
+#pragma once
+
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/pair.h"
+
+#include <string>
+
+/*! \file bolt/cl/partition.h
+    \brief Reorders a sequence so that the elements satisfying a predicate come first.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup CL-partition
+        *   \ingroup copying
+        *   \{
+        */
+
+        /*! stable_partition moves the elements of [first, last) for which pred is true before the elements for which
+         *  it is false.  Both groups keep their order.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the sequence.
+         * \param last  End of the sequence.
+         * \param pred Unary predicate deciding which elements go first.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The beginning of the elements for which pred is false.
+         *
+         * \tparam ForwardIterator is a model of ForwardIterator
+         * \tparam Predicate is a model of Predicate
+         *
+         *  \code
+         *  #include <bolt/cl/partition.h>
+         *  ...
+         *
+         *  int input[ 8 ] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+         *
+         *  int *middle = bolt::cl::stable_partition( input, input + 8, is_odd( ) );
+         *
+         *  // input is now { 1, 3, 5, 7, 2, 4, 6, 8 } and middle - input is 4
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/stable_partition.html
+         */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(
+            bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& user_code="");
+
+        /*! partition moves the elements of [first, last) for which pred is true before the elements for which it
+         *  is false.  Every backend keeps the order of both groups, as stable_partition does, since compacting the
+         *  two groups costs no more than an unstable split.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the sequence.
+         * \param last  End of the sequence.
+         * \param pred Unary predicate deciding which elements go first.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The beginning of the elements for which pred is false.
+         *
+         *  \sa http://www.sgi.com/tech/stl/partition.html
+         */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(
+            bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& user_code="");
+
+        /*! partition_copy copies the elements of [first, last) for which pred is true to the sequence beginning at
+         *  out_true, and the others to the sequence beginning at out_false, keeping their order.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the source sequence.
+         * \param last  End of the source sequence.
+         * \param out_true Beginning of the sequence receiving the elements for which pred is true.
+         * \param out_false Beginning of the sequence receiving the elements for which pred is false.
+         * \param pred Unary predicate deciding where each element goes.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return pair(end of out_true, end of out_false)
+         *
+         *  \sa http://en.cppreference.com/w/cpp/algorithm/partition_copy
+         */
+        template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+        pair<OutputIterator1, OutputIterator2> partition_copy(
+            bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator1 out_true,
+            OutputIterator2 out_false,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename InputIterator, typename OutputIterator1, typename OutputIterator2, typename Predicate>
+        pair<OutputIterator1, OutputIterator2> partition_copy(
+            InputIterator first,
+            InputIterator last,
+            OutputIterator1 out_true,
+            OutputIterator2 out_false,
+            Predicate pred,
+            const std::string& user_code="");
+
+        /*!   \}  */
+    };
+};
+
+#include <bolt/cl/detail/partition.inl>
+#endif
@@ -0,0 +1,280 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PIPELINE_H )
+#define BOLT_CL_PIPELINE_H
+#pragma once
+
+#include <string>
+#include <iterator>
+#include <type_traits>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/transform_reduce.h"
+#include "bolt/cl/transform_scan.h"
+
+/*! \file bolt/cl/pipeline.h
+    \brief A lazy chain of transforms over a range, run as one kernel by the algorithm that ends the chain.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup pipeline
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! \brief Applies \c Inner and then \c Outer to its argument
+        *   \details The same definition is compiled for the host and for the device, so the composed functor runs
+        *   in the OpenCL kernel, the TBB loop and the serial loop of an algorithm alike.  The TypeName and ClCode
+        *   traits of a composition are built from those of its parts.
+        *   \tparam Outer The functor applied last.
+        *   \tparam Inner The functor applied first.
+        *   \tparam Argument The argument type of \c Inner.
+        *   \tparam Result The type \c Outer returns.
+        */
+        static const std::string unaryComposeFunctor = BOLT_HOST_DEVICE_DEFINITION(
+        template< typename Outer, typename Inner, typename Argument, typename Result >
+        struct unary_compose
+        {
+            typedef Result result_type;
+
+            unary_compose( )
+            {}
+
+            unary_compose( const Outer& o, const Inner& i ): outer( o ), inner( i )
+            {}
+
+            Result operator( )( const Argument& x ) const
+            {
+                return outer( inner( x ) );
+            }
+
+            Outer outer;
+            Inner inner;
+        };
+        );
+
+        namespace detail
+        {
+            //  The type a unary functor returns for an argument of type Argument, without references or cv
+            template< typename UnaryFunction, typename Argument >
+            struct unaryResult
+            {
+                typedef typename std::decay<
+                    typename std::result_of< const UnaryFunction( const Argument& ) >::type >::type type;
+            };
+
+            //  Appends F to a chain whose functor so far is Current; the first transform replaces the identity
+            template< typename F, typename Current, typename Argument >
+            struct appendStage
+            {
+                typedef bolt::cl::unary_compose< F, Current, Argument,
+                    typename unaryResult< F, typename unaryResult< Current, Argument >::type >::type > type;
+
+                static type make( const F& f, const Current& current )
+                {
+                    return type( f, current );
+                }
+            };
+
+            template< typename F, typename Argument >
+            struct appendStage< F, bolt::cl::identity< Argument >, Argument >
+            {
+                typedef F type;
+
+                static type make( const F& f, const bolt::cl::identity< Argument >& )
+                {
+                    return f;
+                }
+            };
+        };
+
+        /*! \brief A range and the chain of unary functors to apply to its elements
+        *   \details Building the chain runs nothing.  The algorithm that ends it (copy, reduce, inclusive_scan or
+        *   exclusive_scan) passes the composed functor to the transform variant of that algorithm, so the whole
+        *   chain runs inside one kernel, or one TBB loop on the multicore CPU path.  Each element is read from
+        *   the range once and no intermediate results are stored.
+        *
+        *   The functors follow the usual rules: each needs TypeName and ClCode traits for the OpenCL path, and
+        *   the range, the functors and the control must stay valid until the final call returns.
+        *   \tparam InputIterator The iterator type of the source range.
+        *   \tparam UnaryFunction The composition of the transforms so far.
+        *   \code
+        *   #include <bolt/cl/pipeline.h>
+        *
+        *   bolt::cl::device_vector< int > v( 1024, 3 );
+        *
+        *   // One kernel, that squares, negates and sums; no temporary vectors
+        *   int sum = bolt::cl::make_pipeline( v.begin( ), v.end( ) )
+        *       .transform( bolt::cl::square< int >( ) )
+        *       .transform( bolt::cl::negate< int >( ) )
+        *       .reduce( 0, bolt::cl::plus< int >( ) );
+        *
+        *   // sum is -9216
+        *   \endcode
+        */
+        template< typename InputIterator, typename UnaryFunction >
+        class pipeline
+        {
+        public:
+            typedef typename std::iterator_traits< InputIterator >::value_type argument_type;
+            typedef typename detail::unaryResult< UnaryFunction, argument_type >::type result_type;
+            typedef UnaryFunction functor_type;
+
+            pipeline( InputIterator first, InputIterator last, const UnaryFunction& f ):
+                m_first( first ), m_last( last ), m_functor( f )
+            {}
+
+            InputIterator first( ) const { return m_first; };
+            InputIterator last( ) const { return m_last; };
+
+            //! The composition of every transform in the chain
+            const UnaryFunction& functor( ) const { return m_functor; };
+
+            /*! \brief Appends a transform to the chain
+            *   \return A new pipeline over the same range; this one is unchanged.
+            */
+            template< typename F >
+            pipeline< InputIterator, typename detail::appendStage< F, UnaryFunction, argument_type >::type >
+            transform( const F& f ) const
+            {
+                typedef detail::appendStage< F, UnaryFunction, argument_type > stage;
+                return pipeline< InputIterator, typename stage::type >( m_first, m_last,
+                    stage::make( f, m_functor ) );
+            }
+
+            /*! \brief Writes the transformed elements to \c result with a single bolt::cl::transform
+            *   \return The end of the output range.
+            */
+            template< typename OutputIterator >
+            OutputIterator copy( control& ctl, OutputIterator result, const std::string& user_code = "" ) const
+            {
+                bolt::cl::transform( ctl, m_first, m_last, result, m_functor, user_code );
+                return result + ( m_last - m_first );
+            }
+
+            template< typename OutputIterator >
+            OutputIterator copy( OutputIterator result, const std::string& user_code = "" ) const
+            {
+                return copy( control::getDefault( ), result, user_code );
+            }
+
+            //! \brief Reduces the transformed elements with a single bolt::cl::transform_reduce
+            template< typename T, typename BinaryFunction >
+            T reduce( control& ctl, T init, BinaryFunction op, const std::string& user_code = "" ) const
+            {
+                return bolt::cl::transform_reduce( ctl, m_first, m_last, m_functor, init, op, user_code );
+            }
+
+            template< typename T, typename BinaryFunction >
+            T reduce( T init, BinaryFunction op, const std::string& user_code = "" ) const
+            {
+                return reduce( control::getDefault( ), init, op, user_code );
+            }
+
+            //! \brief Scans the transformed elements with a single bolt::cl::transform_inclusive_scan
+            template< typename OutputIterator, typename BinaryFunction >
+            OutputIterator inclusive_scan( control& ctl, OutputIterator result, BinaryFunction op,
+                const std::string& user_code = "" ) const
+            {
+                return bolt::cl::transform_inclusive_scan( ctl, m_first, m_last, result, m_functor, op, user_code );
+            }
+
+            template< typename OutputIterator, typename BinaryFunction >
+            OutputIterator inclusive_scan( OutputIterator result, BinaryFunction op,
+                const std::string& user_code = "" ) const
+            {
+                return inclusive_scan( control::getDefault( ), result, op, user_code );
+            }
+
+            //! \brief Scans the transformed elements with a single bolt::cl::transform_exclusive_scan
+            template< typename OutputIterator, typename T, typename BinaryFunction >
+            OutputIterator exclusive_scan( control& ctl, OutputIterator result, T init, BinaryFunction op,
+                const std::string& user_code = "" ) const
+            {
+                return bolt::cl::transform_exclusive_scan( ctl, m_first, m_last, result, m_functor, init, op,
+                    user_code );
+            }
+
+            template< typename OutputIterator, typename T, typename BinaryFunction >
+            OutputIterator exclusive_scan( OutputIterator result, T init, BinaryFunction op,
+                const std::string& user_code = "" ) const
+            {
+                return exclusive_scan( control::getDefault( ), result, init, op, user_code );
+            }
+
+        private:
+            InputIterator m_first;
+            InputIterator m_last;
+            UnaryFunction m_functor;
+        };
+
+        /*! \brief Starts a pipeline over [first, last) with no transforms
+        */
+        template< typename InputIterator >
+        pipeline< InputIterator, bolt::cl::identity< typename std::iterator_traits< InputIterator >::value_type > >
+        make_pipeline( InputIterator first, InputIterator last )
+        {
+            typedef bolt::cl::identity< typename std::iterator_traits< InputIterator >::value_type > identityType;
+            return pipeline< InputIterator, identityType >( first, last, identityType( ) );
+        }
+
+        /*!   \}  */
+
+    };
+};
+
+//  The name of a composition spells out the names of its parts
+template< typename Outer, typename Inner, typename Argument, typename Result >
+struct TypeName< bolt::cl::unary_compose< Outer, Inner, Argument, Result > >
+{
+    static std::string get( )
+    {
+        return "bolt::cl::unary_compose< " + TypeName< Outer >::get( ) + ", " + TypeName< Inner >::get( ) + ", "
+            + TypeName< Argument >::get( ) + ", " + TypeName< Result >::get( ) + " >";
+    }
+};
+
+//  The code of a composition is the code of its parts, each guarded so that it is defined once.  The type between
+//  the two functors comes first, as both use it.  Argument and Result are left out: the algorithm adds them as its
+//  input and output types.
+template< typename Outer, typename Inner, typename Argument, typename Result >
+struct ClCode< bolt::cl::unary_compose< Outer, Inner, Argument, Result > >
+{
+    static std::string get( )
+    {
+        typedef typename bolt::cl::detail::unaryResult< Inner, Argument >::type middleType;
+
+        std::string middle;
+        if( !std::is_same< middleType, Argument >::value && !std::is_same< middleType, Result >::value )
+            middle = bolt::cl::guardCode( ClCode< middleType >::get( ) );
+
+        return middle
+            + bolt::cl::guardCode( ClCode< Inner >::get( ) )
+            + bolt::cl::guardCode( ClCode< Outer >::get( ) )
+            + bolt::cl::guardCode( bolt::cl::unaryComposeFunctor );
+    }
+};
+
+#endif
@@ -17,6 +17,15 @@
 
 //#pragma OPENCL EXTENSION cl_amd_printf : enable
 
+//  The host passes the tuned work group size and unroll factor with -D; these are the untuned defaults
+#ifndef REDUCE_WGSIZE
+#define REDUCE_WGSIZE 256
+#endif
+
+#ifndef REDUCE_UNROLL
+#define REDUCE_UNROLL 1
+#endif
+
 #define _REDUCE_STEP(_LENGTH, _IDX, _W) \
     if ((_IDX < _W) && ((_IDX + _W) < _LENGTH)) {\
       T mine = scratch[_IDX];\
@@ -25,9 +34,10 @@
     }\
     barrier(CLK_LOCAL_MEM_FENCE);
 
-template< typename iTypePtr, typename iTypeIter, typename binary_function,typename T >
-kernel void reduceTemplate(
-    global iTypePtr*    input_ptr, 
+//  The reduction of an initialized input iterator; reduceTemplate and the zip_iterator kernel that the host
+//  generates share it
+template< typename iTypeIter, typename binary_function, typename T >
+void reduceRange(
     iTypeIter input_iter,
     const int length,
     global binary_function* userFunctor,
@@ -37,7 +47,6 @@ kernel void reduceTemplate(
 {
     int gx = get_global_id (0);
     int gloId = gx;
-    input_iter.init( input_ptr );
 
     //  Initialize the accumulator private variable with data from the input array
     //  This essentially unrolls the loop below at least once
@@ -49,11 +58,24 @@ kernel void reduceTemplate(
 
     // Loop sequentially over chunks of input vector, reducing an arbitrary size input
     // length into a length related to the number of workgroups
+    int stride = get_global_size(0);
+#if REDUCE_UNROLL > 1
+    // Unrolled trips keep the order of the combinations, so non-commutative functors see the same sequence
+    while (gx + (REDUCE_UNROLL - 1) * stride < length)
+    {
+        for (int u = 0; u < REDUCE_UNROLL; ++u)
+        {
+            typename iTypeIter::value_type element = input_iter[gx];
+            accumulator = (*userFunctor)(accumulator, element);
+            gx += stride;
+        }
+    }
+#endif
     while (gx < length)
     {
         typename iTypeIter::value_type element = input_iter[gx];
         accumulator = (*userFunctor)(accumulator, element);
-        gx += get_global_size(0);
+        gx += stride;
     }
 
     //  Initialize local data store
@@ -65,15 +87,11 @@ kernel void reduceTemplate(
     uint tail = length - (get_group_id(0) * get_local_size(0));
 
     // Parallel reduction within a given workgroup using local data store
-    // to share values between workitems - 256 is good to achieve high occupancy
-    _REDUCE_STEP(tail, local_index, 128);
-    _REDUCE_STEP(tail, local_index, 64);
-    _REDUCE_STEP(tail, local_index, 32);
-    _REDUCE_STEP(tail, local_index, 16);
-    _REDUCE_STEP(tail, local_index,  8);
-    _REDUCE_STEP(tail, local_index,  4);
-    _REDUCE_STEP(tail, local_index,  2);
-    _REDUCE_STEP(tail, local_index,  1);
+    // to share values between workitems; the trip count is a compile time constant, so this unrolls
+    for (int w = REDUCE_WGSIZE / 2; w > 0; w >>= 1)
+    {
+        _REDUCE_STEP(tail, local_index, w);
+    }
  
      //  Abort threads that are passed the end of the input vector
     if( gloId >= length )
@@ -83,4 +101,18 @@ kernel void reduceTemplate(
     if (local_index == 0) {
         result[get_group_id(0)] = scratch[0];
     }
+}
+
+template< typename iTypePtr, typename iTypeIter, typename binary_function,typename T >
+kernel void reduceTemplate(
+    global iTypePtr*    input_ptr, 
+    iTypeIter input_iter,
+    const int length,
+    global binary_function* userFunctor,
+    global T*    result,
+    local T*     scratch
+)
+{
+    input_iter.init( input_ptr );
+    reduceRange( input_iter, length, userFunctor, result, scratch );
 };
@@ -0,0 +1,121 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_REMOVE_H )
+#define BOLT_CL_REMOVE_H
+#pragma once
+
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/remove.h
+    \brief Removes the elements of a sequence that satisfy a predicate.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup CL-remove
+        *   \ingroup copying
+        *   \{
+        */
+
+        /*! remove_if removes the elements of [first, last) for which pred is true.  The remaining elements keep
+         *  their order and are moved to the front of the range; the elements past the returned iterator are left in
+         *  an unspecified state.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the sequence.
+         * \param last  End of the sequence.
+         * \param pred Unary predicate deciding which elements are removed.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The new end of the sequence.
+         *
+         * \tparam ForwardIterator is a model of ForwardIterator
+         * \tparam Predicate is a model of Predicate
+         *
+         *  \details On the OpenCL path a device range is compacted from a copy of itself, since the work groups
+         *  that write the front of the range could overwrite elements other work groups have not read yet.
+         *
+         *  \code
+         *  #include <bolt/cl/remove.h>
+         *  ...
+         *
+         *  int input[ 8 ] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+         *
+         *  int *end = bolt::cl::remove_if( input, input + 8, is_odd( ) );
+         *
+         *  // input now begins with { 2, 4, 6, 8 } and end - input is 4
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/remove_if.html
+         */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(
+            bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& user_code="");
+
+        /*! remove_copy_if copies the elements of [first, last) for which pred is false to the sequence beginning
+         *  at result, keeping their order.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the source sequence.
+         * \param last  End of the source sequence.
+         * \param result Beginning of the destination sequence.
+         * \param pred Unary predicate deciding which elements are left out.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         *  \sa http://www.sgi.com/tech/stl/remove_copy_if.html
+         */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(
+            bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& user_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& user_code="");
+
+        /*!   \}  */
+    };
+};
+
+#include <bolt/cl/detail/remove.inl>
+#endif
@@ -392,3 +392,191 @@ __kernel void perBlockAdditionByKey(
     output_iter[ gloId ] = sum;
     
 }
+
+/******************************************************************************
+ *  Single pass scan by key
+ *
+ *  The single pass scan of scan_kernels.cl, segmented: a tile that contains the
+ *  start of a segment publishes its prefix straight away, since nothing before
+ *  it reaches past that segment start, and only looks back for the elements in
+ *  front of its first segment start.
+ *****************************************************************************/
+//  The single pass compiles pass the items per work item; the multi pass kernels of this file are compiled
+//  without it
+#ifndef SCAN_ITEMS
+#define SCAN_ITEMS 1
+#endif
+template<
+    typename kType,
+    typename kIterType,
+    typename vType,
+    typename iIterType,
+    typename oType,
+    typename oIterType,
+    typename initType,
+    typename BinaryPredicate,
+    typename BinaryFunction >
+__kernel void singlePassScanByKey(
+    global kType *keys,
+    kIterType    keys_iter,
+    global vType *vals,
+    iIterType    vals_iter,
+    global oType *output,
+    oIterType    output_iter,
+    initType init,
+    const uint vecSize,
+    local typename kIterType::value_type *ldsKeys,
+    local oType *ldsVals,
+    local oType *ldsSums,
+    local uint *ldsHeads,
+    global BinaryPredicate *binaryPred,
+    global BinaryFunction *binaryFunct,
+    global uint *tileStatus,
+    global uint *tileAggregate,
+    global uint *tilePrefix,
+    int exclusive) // do exclusive scan ?
+{
+    local uint tileId;
+    local uint tileHead;    // the first element of the tile starts a segment
+    const uint locId = get_local_id( 0 );
+    const uint wgSize = get_local_size( 0 );
+    const uint tileSize = wgSize * SCAN_ITEMS;
+
+    keys_iter.init( keys );
+    vals_iter.init( vals );
+    output_iter.init( output );
+
+    if( locId == 0 )
+        tileId = atomic_inc( &tileStatus[ 0 ] );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    const uint tile = tileId;
+    const uint tileStart = tile * tileSize;
+    const uint tileCount = min( tileSize, vecSize - tileStart );
+
+    //  Coalesced load of the tile
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        ldsKeys[ i ] = keys_iter[ tileStart + i ];
+        ldsVals[ i ] = vals_iter[ tileStart + i ];
+    }
+    if( locId == 0 )
+    {
+        tileHead = 1;
+        if( tile > 0 )
+        {
+            typename kIterType::value_type key1 = keys_iter[ tileStart ];
+            typename kIterType::value_type key2 = keys_iter[ tileStart - 1 ];
+            tileHead = (*binaryPred)( key1, key2 ) ? 0 : 1;
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Each work item scans SCAN_ITEMS consecutive elements serially, restarting at every segment start
+    const uint runStart = locId * SCAN_ITEMS;
+    oType sum;
+    uint head = 0;
+    if( runStart < tileCount )
+    {
+        head = ( runStart == 0 ) ? tileHead : !(*binaryPred)( ldsKeys[ runStart ], ldsKeys[ runStart - 1 ] );
+        sum = ldsVals[ runStart ];
+        for( uint k = 1; k < SCAN_ITEMS && runStart + k < tileCount; ++k )
+        {
+            oType y = ldsVals[ runStart + k ];
+            if( (*binaryPred)( ldsKeys[ runStart + k ], ldsKeys[ runStart + k - 1 ] ) )
+                sum = (*binaryFunct)( sum, y );
+            else
+            {
+                sum = y;
+                head = 1;
+            }
+            ldsVals[ runStart + k ] = sum;
+        }
+    }
+    ldsSums[ locId ] = sum;
+    ldsHeads[ locId ] = head;
+
+    //  Segmented scan of the run totals
+    for( uint offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        oType y;
+        uint yHead;
+        if( locId >= offset )
+        {
+            y = ldsSums[ locId - offset ];
+            yHead = ldsHeads[ locId - offset ];
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset )
+        {
+            if( !head )
+                sum = (*binaryFunct)( y, sum );
+            head |= yHead;
+            ldsSums[ locId ] = sum;
+            ldsHeads[ locId ] = head;
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  ldsSums[ wgSize ] holds the sum of the segment running into this tile
+    const uint lastRun = ( tileCount - 1 ) / SCAN_ITEMS;
+    if( locId == 0 )
+    {
+        oType aggregate = ldsSums[ lastRun ];
+        oType carry;
+        if( ldsHeads[ lastRun ] )
+            scanTilePublish( tile, SCAN_TILE_PREFIX, aggregate, tileStatus, tilePrefix );
+        else
+            scanTilePublish( tile, SCAN_TILE_AGGREGATE, aggregate, tileStatus, tileAggregate );
+
+        if( !tileHead )
+        {
+            carry = scanTileLookBack< oType >( tile, tileStatus, tileAggregate, tilePrefix, binaryFunct );
+            if( !ldsHeads[ lastRun ] )
+                scanTilePublish( tile, SCAN_TILE_PREFIX, (*binaryFunct)( carry, aggregate ), tileStatus, tilePrefix );
+        }
+        ldsSums[ wgSize ] = carry;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Add what comes before each run to its elements up to the first segment start: the earlier runs back to
+    //  their last segment start, and the carry if none of them starts a segment
+    if( runStart < tileCount )
+    {
+        uint hasPrefix = !tileHead;
+        oType prefix = ldsSums[ wgSize ];
+        if( locId > 0 )
+        {
+            oType y = ldsSums[ locId - 1 ];
+            prefix = ldsHeads[ locId - 1 ] ? y : (*binaryFunct)( prefix, y );
+            hasPrefix = 1;
+        }
+        for( uint k = 0; hasPrefix && k < SCAN_ITEMS && runStart + k < tileCount; ++k )
+        {
+            const uint i = runStart + k;
+            if( ( i == 0 ) ? tileHead : !(*binaryPred)( ldsKeys[ i ], ldsKeys[ i - 1 ] ) )
+                break;
+            oType y = ldsVals[ i ];
+            ldsVals[ i ] = (*binaryFunct)( prefix, y );
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        if( exclusive )
+        {
+            //  init at each segment start, otherwise init combined with the inclusive scan of the element before
+            uint start = ( i == 0 ) ? tileHead : !(*binaryPred)( ldsKeys[ i ], ldsKeys[ i - 1 ] );
+            oType value = init;
+            if( !start )
+            {
+                oType y = ( i == 0 ) ? ldsSums[ wgSize ] : ldsVals[ i - 1 ];
+                value = (*binaryFunct)( value, y );
+            }
+            output_iter[ tileStart + i ] = value;
+        }
+        else
+            output_iter[ tileStart + i ] = ldsVals[ i ];
+    }
+}
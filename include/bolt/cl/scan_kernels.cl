@@ -317,5 +317,193 @@ kernel void perBlockInclusiveScan(
 	}
 }
 
+/******************************************************************************
+ *  Single pass scan
+ *
+ *  Every work group takes the next tile off a global counter, scans it in local
+ *  memory and then finds the sum of everything before it by looking back over
+ *  the tiles handed out earlier: a tile that is done publishes its inclusive
+ *  prefix, a tile that is still looking back publishes its own aggregate, and
+ *  the look-back stops at the first prefix it finds.  Each element is read and
+ *  written exactly once.
+ *
+ *  tileStatus[ 0 ] is the tile counter and tileStatus[ 1 + t ] the status of
+ *  tile t; sums are copied a word at a time with atomics so that they are
+ *  coherent between work groups on any OpenCL 1.2 device.
+ *****************************************************************************/
+//  The single pass compiles pass the items per work item; the multi pass kernels of this file are compiled
+//  without it
+#ifndef SCAN_ITEMS
+#define SCAN_ITEMS 1
+#endif
+#define SCAN_TILE_AGGREGATE 1
+#define SCAN_TILE_PREFIX 2
+
+template< typename T >
+void scanTileStore( global uint* words, uint tile, T value )
+{
+	const uint count = sizeof( T ) / sizeof( uint );
+	uint* src = (uint*)&value;
+	for( uint w = 0; w < count; ++w )
+		atomic_xchg( &words[ tile * count + w ], src[ w ] );
+}
+
+template< typename T >
+T scanTileLoad( global uint* words, uint tile )
+{
+	const uint count = sizeof( T ) / sizeof( uint );
+	T value;
+	uint* dst = (uint*)&value;
+	for( uint w = 0; w < count; ++w )
+		dst[ w ] = atomic_or( &words[ tile * count + w ], 0u );
+	return value;
+}
+
+template< typename T >
+void scanTilePublish( uint tile, uint status, T value, global uint* tileStatus, global uint* tileSums )
+{
+	scanTileStore( tileSums, tile, value );
+	write_mem_fence( CLK_GLOBAL_MEM_FENCE );
+	atomic_xchg( &tileStatus[ 1 + tile ], status );
+}
+
+//  Sum of all tiles before this one; only work item 0 of a tile after the first calls this
+template< typename T, typename BinaryFunction >
+T scanTileLookBack( uint tile, global uint* tileStatus, global uint* tileAggregate, global uint* tilePrefix,
+					global BinaryFunction* binaryOp )
+{
+	T carry;
+	uint j = tile - 1;
+	for( bool first = true; ; first = false, --j )
+	{
+		//  Tile j was handed out before this one, so it is running and will publish
+		uint status;
+		do
+		{
+			status = atomic_or( &tileStatus[ 1 + j ], 0u );
+		} while( status == 0 );
+		read_mem_fence( CLK_GLOBAL_MEM_FENCE );
+
+		T y = ( status == SCAN_TILE_PREFIX ) ? scanTileLoad< T >( tilePrefix, j ) : scanTileLoad< T >( tileAggregate, j );
+		carry = first ? y : (*binaryOp)( y, carry );
+		if( status == SCAN_TILE_PREFIX )
+			break;
+	}
+	return carry;
+}
+
+template< typename iPtrType, typename iIterType, typename oPtrType, typename oIterType, typename BinaryFunction, typename initType >
+kernel void singlePassScan(
+				global oPtrType* output_ptr,
+				oIterType    output_iter,
+				global iPtrType* input_ptr,
+				iIterType    input_iter,
+				initType init,
+				const uint vecSize,
+				local oPtrType* ldsTile,
+				local oPtrType* ldsSums,
+				global BinaryFunction* binaryOp,
+				global uint* tileStatus,
+				global uint* tileAggregate,
+				global uint* tilePrefix )
+{
+	local uint tileId;
+	const uint locId = get_local_id( 0 );
+	const uint wgSize = get_local_size( 0 );
+	const uint tileSize = wgSize * SCAN_ITEMS;
+
+	if( locId == 0 )
+		tileId = atomic_inc( &tileStatus[ 0 ] );
+	barrier( CLK_LOCAL_MEM_FENCE );
+	const uint tile = tileId;
+	const uint tileStart = tile * tileSize;
+	const uint tileCount = min( tileSize, vecSize - tileStart );
+	input_iter.init( input_ptr );
+	output_iter.init( output_ptr );
+
+	//  Coalesced load of the tile
+	for( uint i = locId; i < tileCount; i += wgSize )
+		ldsTile[ i ] = input_iter[ tileStart + i ];
+	barrier( CLK_LOCAL_MEM_FENCE );
+
+	//  Each work item scans SCAN_ITEMS consecutive elements serially
+	const uint runStart = locId * SCAN_ITEMS;
+	oPtrType sum;
+	if( runStart < tileCount )
+	{
+		sum = ldsTile[ runStart ];
+		for( uint k = 1; k < SCAN_ITEMS && runStart + k < tileCount; ++k )
+		{
+			oPtrType y = ldsTile[ runStart + k ];
+			sum = (*binaryOp)( sum, y );
+			ldsTile[ runStart + k ] = sum;
+		}
+	}
+	ldsSums[ locId ] = sum;
+
+	//  Scan the run totals; work items past the end of the tile compute values nobody reads
+	for( uint offset = 1; offset < wgSize; offset *= 2 )
+	{
+		barrier( CLK_LOCAL_MEM_FENCE );
+		oPtrType y;
+		if( locId >= offset )
+			y = ldsSums[ locId - offset ];
+		barrier( CLK_LOCAL_MEM_FENCE );
+		if( locId >= offset )
+		{
+			sum = (*binaryOp)( y, sum );
+			ldsSums[ locId ] = sum;
+		}
+	}
+	barrier( CLK_LOCAL_MEM_FENCE );
+
+	//  ldsSums[ wgSize ] holds the sum of everything before this tile, including init for an exclusive scan
+	if( locId == 0 )
+	{
+		oPtrType aggregate = ldsSums[ ( tileCount - 1 ) / SCAN_ITEMS ];
+		oPtrType carry;
+		if( tile > 0 )
+		{
+			scanTilePublish( tile, SCAN_TILE_AGGREGATE, aggregate, tileStatus, tileAggregate );
+			carry = scanTileLookBack< oPtrType >( tile, tileStatus, tileAggregate, tilePrefix, binaryOp );
+			scanTilePublish( tile, SCAN_TILE_PREFIX, (*binaryOp)( carry, aggregate ), tileStatus, tilePrefix );
+		}
+		else
+		{
+#if EXCLUSIVE
+			carry = init;
+			scanTilePublish( tile, SCAN_TILE_PREFIX, (*binaryOp)( carry, aggregate ), tileStatus, tilePrefix );
+#else
+			scanTilePublish( tile, SCAN_TILE_PREFIX, aggregate, tileStatus, tilePrefix );
+#endif
+		}
+		ldsSums[ wgSize ] = carry;
+	}
+	barrier( CLK_LOCAL_MEM_FENCE );
+
+	const bool hasCarry = EXCLUSIVE || tile > 0;
+	const oPtrType carry = ldsSums[ wgSize ];
+	for( uint i = locId; i < tileCount; i += wgSize )
+	{
+		oPtrType value;
+#if EXCLUSIVE
+		if( i == 0 )
+		{
+			output_iter[ tileStart ] = carry;
+			continue;
+		}
+		const uint p = i - 1;
+#else
+		const uint p = i;
+#endif
+		value = ldsTile[ p ];
+		if( p >= SCAN_ITEMS )
+			value = (*binaryOp)( ldsSums[ p / SCAN_ITEMS - 1 ], value );
+		if( hasCarry )
+			value = (*binaryOp)( carry, value );
+		output_iter[ tileStart + i ] = value;
+	}
+}
+
 // not using HSA
 #endif
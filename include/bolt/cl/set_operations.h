@@ -0,0 +1,363 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SET_OPERATIONS_H )
+#define BOLT_CL_SET_OPERATIONS_H
+#pragma once
+
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+
+#include <string>
+
+/*! \file bolt/cl/set_operations.h
+    \brief Union, intersection, difference and symmetric difference of sorted ranges.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup CL-set_operations
+        *   \ingroup algorithms
+        *   \{
+        */
+
+        /*! set_union copies the elements that are in either of two sorted ranges to the sequence beginning at result.
+         *  An element found m times in [first1, last1) and n times in [first2, last2) is copied max(m, n) times;
+         *  matching elements are copied from the first range.
+         *
+         *  \details The OpenCL path splits the merge of the two ranges into equal pieces with merge-path
+         *  partitioning, so every work item does the same amount of work whatever the keys look like.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first1 Beginning of the first sorted sequence.
+         * \param last1  End of the first sorted sequence.
+         * \param first2 Beginning of the second sorted sequence.
+         * \param last2  End of the second sorted sequence.
+         * \param result Beginning of the destination sequence.
+         * \param comp \b Optional Strict weak ordering both sequences are sorted by; bolt::cl::less by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         * \tparam InputIterator1 is a model of InputIterator
+         * \tparam InputIterator2 is a model of InputIterator
+         * \tparam OutputIterator is a model of OutputIterator
+         * \tparam StrictWeakCompare is a model of Strict Weak Ordering
+         *
+         *  \code
+         *  #include <bolt/cl/set_operations.h>
+         *  ...
+         *
+         *  int a[ 4 ] = { 1, 3, 5, 7 };
+         *  int b[ 4 ] = { 1, 2, 3, 4 };
+         *  int r[ 8 ];
+         *
+         *  int *end = bolt::cl::set_union( a, a + 4, b, b + 4, r );
+         *
+         *  // r begins with { 1, 2, 3, 4, 5, 7 } and end is r + 6
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/set_union.html
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_union(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_union(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_union(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_union(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        /*! set_intersection copies the elements of the sorted range [first1, last1) that are also in the sorted range
+         *  [first2, last2) to the sequence beginning at result.  An element found m times in the first range and n
+         *  times in the second is copied min(m, n) times.
+         *
+         *  \details The OpenCL path splits the merge of the two ranges into equal pieces with merge-path
+         *  partitioning, so every work item does the same amount of work whatever the keys look like.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first1 Beginning of the first sorted sequence.
+         * \param last1  End of the first sorted sequence.
+         * \param first2 Beginning of the second sorted sequence.
+         * \param last2  End of the second sorted sequence.
+         * \param result Beginning of the destination sequence.
+         * \param comp \b Optional Strict weak ordering both sequences are sorted by; bolt::cl::less by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         * \tparam InputIterator1 is a model of InputIterator
+         * \tparam InputIterator2 is a model of InputIterator
+         * \tparam OutputIterator is a model of OutputIterator
+         * \tparam StrictWeakCompare is a model of Strict Weak Ordering
+         *
+         *  \code
+         *  #include <bolt/cl/set_operations.h>
+         *  ...
+         *
+         *  int a[ 4 ] = { 1, 3, 5, 7 };
+         *  int b[ 4 ] = { 1, 2, 3, 4 };
+         *  int r[ 8 ];
+         *
+         *  int *end = bolt::cl::set_intersection( a, a + 4, b, b + 4, r );
+         *
+         *  // r begins with { 1, 3 } and end is r + 2
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/set_intersection.html
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_intersection(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_intersection(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_intersection(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_intersection(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        /*! set_difference copies the elements of the sorted range [first1, last1) that are not in the sorted range
+         *  [first2, last2) to the sequence beginning at result.  An element found m times in the first range and n
+         *  times in the second is copied max(m - n, 0) times.
+         *
+         *  \details The OpenCL path splits the merge of the two ranges into equal pieces with merge-path
+         *  partitioning, so every work item does the same amount of work whatever the keys look like.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first1 Beginning of the first sorted sequence.
+         * \param last1  End of the first sorted sequence.
+         * \param first2 Beginning of the second sorted sequence.
+         * \param last2  End of the second sorted sequence.
+         * \param result Beginning of the destination sequence.
+         * \param comp \b Optional Strict weak ordering both sequences are sorted by; bolt::cl::less by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         * \tparam InputIterator1 is a model of InputIterator
+         * \tparam InputIterator2 is a model of InputIterator
+         * \tparam OutputIterator is a model of OutputIterator
+         * \tparam StrictWeakCompare is a model of Strict Weak Ordering
+         *
+         *  \code
+         *  #include <bolt/cl/set_operations.h>
+         *  ...
+         *
+         *  int a[ 4 ] = { 1, 3, 5, 7 };
+         *  int b[ 4 ] = { 1, 2, 3, 4 };
+         *  int r[ 8 ];
+         *
+         *  int *end = bolt::cl::set_difference( a, a + 4, b, b + 4, r );
+         *
+         *  // r begins with { 5, 7 } and end is r + 2
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/set_difference.html
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_difference(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_difference(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_difference(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_difference(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        /*! set_symmetric_difference copies the elements that are in one of two sorted ranges but not in the other to the
+         *  sequence beginning at result, in order.  An element found m times in [first1, last1) and n times in
+         *  [first2, last2) is copied |m - n| times.
+         *
+         *  \details The OpenCL path splits the merge of the two ranges into equal pieces with merge-path
+         *  partitioning, so every work item does the same amount of work whatever the keys look like.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first1 Beginning of the first sorted sequence.
+         * \param last1  End of the first sorted sequence.
+         * \param first2 Beginning of the second sorted sequence.
+         * \param last2  End of the second sorted sequence.
+         * \param result Beginning of the destination sequence.
+         * \param comp \b Optional Strict weak ordering both sequences are sorted by; bolt::cl::less by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         * \tparam InputIterator1 is a model of InputIterator
+         * \tparam InputIterator2 is a model of InputIterator
+         * \tparam OutputIterator is a model of OutputIterator
+         * \tparam StrictWeakCompare is a model of Strict Weak Ordering
+         *
+         *  \code
+         *  #include <bolt/cl/set_operations.h>
+         *  ...
+         *
+         *  int a[ 4 ] = { 1, 3, 5, 7 };
+         *  int b[ 4 ] = { 1, 2, 3, 4 };
+         *  int r[ 8 ];
+         *
+         *  int *end = bolt::cl::set_symmetric_difference( a, a + 4, b, b + 4, r );
+         *
+         *  // r begins with { 2, 4, 5, 7 } and end is r + 4
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/set_symmetric_difference.html
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_symmetric_difference(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator set_symmetric_difference(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_symmetric_difference(
+            bolt::cl::control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakCompare>
+        OutputIterator set_symmetric_difference(
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakCompare comp,
+            const std::string& user_code="");
+
+        /*!   \}  */
+    };
+};
+
+#include <bolt/cl/detail/set_operations.inl>
+#endif
@@ -0,0 +1,596 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_STREAMING_H )
+#define BOLT_CL_STREAMING_H
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/iterator/addressof.h"
+#include "bolt/cl/iterator/constant_iterator.h"
+#include "bolt/cl/count.h"
+#include "bolt/cl/fill.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/scan.h"
+#include "bolt/cl/sort.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/transform_reduce.h"
+
+/*! \file bolt/cl/streaming.h
+    \brief Variants of the Bolt algorithms for host ranges larger than the device memory.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \brief Bolt algorithms that stream host ranges through the device in chunks
+        *   \details Every function here takes the complete argument list of the algorithm of the same name, with the
+        *   control and every functor spelled out.  The ranges must be contiguous host memory, such as a
+        *   std::vector or a memory mapped file, and may hold more elements than an int counts.
+        *
+        *   The range is cut into chunks that fit the device (see control::setStreamChunkSize), and streamingSlots
+        *   chunks are in flight at once, each on a command queue of its own in the control's context.  While one
+        *   chunk is computed, the next ones are uploaded and the previous ones downloaded.  A scan carries the total
+        *   of every chunk into the next; a sort sorts every chunk on the device and merges the sorted chunks on the
+        *   host.
+        *
+        *   When the control does not run on OpenCL, the call goes to the algorithm of the same name unchanged.
+        *   \code
+        *   bolt::cl::control ctl;
+        *   std::vector< float > data( size_t( 1 ) << 33 );
+        *
+        *   float total = bolt::cl::streaming::reduce( ctl, data.begin( ), data.end( ), 0.0f,
+        *       bolt::cl::plus< float >( ) );
+        *   \endcode
+        */
+        namespace streaming
+        {
+            //! Chunks in flight at once, each on a command queue of its own
+            static const size_t streamingSlots = 3;
+
+            namespace detail
+            {
+                //  Whether the call streams, or goes to the algorithm of the same name
+                inline bool streamed( const control& ctl )
+                {
+                    control::e_RunMode runMode = ctl.getForceRunMode( );
+                    if( runMode == control::Automatic )
+                        runMode = ctl.getDefaultPathToRun( );
+                    return runMode == control::OpenCL;
+                }
+
+                /*! \brief How a range is cut into chunks
+                *   \details A chunk is made of buffers whose elements take bytesPerElement bytes between them, the
+                *   largest largestElement bytes.
+                */
+                class chunking
+                {
+                public:
+                    chunking( const control& ctl, size_t length, size_t bytesPerElement, size_t largestElement ):
+                        m_length( length )
+                    {
+                        size_t elements = 0;
+                        if( ctl.getStreamChunkSize( ) != 0 )
+                            elements = ctl.getStreamChunkSize( ) / largestElement;
+                        else
+                        {
+                            ::cl::Device myDevice = ctl.getDevice( );
+                            size_t maxAlloc = static_cast< size_t >( myDevice.getInfo< CL_DEVICE_MAX_MEM_ALLOC_SIZE >( ) );
+                            size_t globalSize = static_cast< size_t >( myDevice.getInfo< CL_DEVICE_GLOBAL_MEM_SIZE >( ) );
+
+                            //  The other half of the memory is left to the algorithms' own scratch buffers
+                            elements = std::min( maxAlloc / largestElement,
+                                globalSize / ( 2 * streamingSlots * bytesPerElement ) );
+                        }
+
+                        //  The algorithms count the elements of a chunk in an int
+                        m_chunk = std::max< size_t >( 1, std::min< size_t >( elements,
+                            static_cast< size_t >( std::numeric_limits< int >::max( ) / 2 ) ) );
+                        m_count = ( length + m_chunk - 1 ) / m_chunk;
+                    }
+
+                    //! Number of chunks
+                    size_t count( ) const { return m_count; };
+                    //! Elements a slot's buffers have to hold
+                    int capacity( ) const { return static_cast< int >( std::min( m_chunk, m_length ) ); };
+                    //! Offset of chunk k in the range
+                    size_t offset( size_t k ) const { return k * m_chunk; };
+                    //! Elements in chunk k
+                    int size( size_t k ) const { return static_cast< int >( std::min( m_chunk, m_length - k * m_chunk ) ); };
+
+                private:
+                    size_t m_length;
+                    size_t m_chunk;
+                    size_t m_count;
+                };
+
+                /*! \brief The command queues chunks rotate over, each with a control of its own
+                *   \details The queues run in order, so the upload, the kernels and the download of a chunk, and the
+                *   chunk that next uses the slot, follow each other without the host waiting.  Algorithms that only
+                *   enqueue kernels run in control::NoWait; those that return a value wait as the control would.
+                */
+                class slots
+                {
+                public:
+                    slots( const control& ctl, bool enqueueOnly )
+                    {
+                        for( size_t s = 0; s < streamingSlots; ++s )
+                        {
+                            boost::shared_ptr< control > mySlot( new control( ctl ) );
+                            mySlot->setCommandQueue( ::cl::CommandQueue( ctl.getContext( ), ctl.getDevice( ) ) );
+                            mySlot->setForceRunMode( control::OpenCL );
+                            if( enqueueOnly )
+                                mySlot->setWaitMode( control::NoWait );
+                            else if( mySlot->getWaitMode( ) == control::NoWait )
+                                mySlot->setWaitMode( control::BalancedWait );
+                            m_controls.push_back( mySlot );
+                        }
+                    }
+
+                    //  Nothing may still read or write the caller's memory once the call has returned, or thrown
+                    ~slots( )
+                    {
+                        try
+                        {
+                            finish( );
+                        }
+                        catch( ... )
+                        {
+                        }
+                    }
+
+                    //! The control of the slot chunk k runs in
+                    control& operator[ ]( size_t k ) { return *m_controls[ k % streamingSlots ]; };
+
+                    void upload( size_t k, const ::cl::Buffer& buffer, const void* src, size_t bytes )
+                    {
+                        if( bytes != 0 )
+                            V_OPENCL( ( *this )[ k ].getCommandQueue( ).enqueueWriteBuffer( buffer, CL_FALSE, 0, bytes,
+                                src ), "enqueueWriteBuffer( ) failed to upload a chunk" );
+                    }
+
+                    void download( size_t k, const ::cl::Buffer& buffer, void* dst, size_t bytes )
+                    {
+                        if( bytes != 0 )
+                            V_OPENCL( ( *this )[ k ].getCommandQueue( ).enqueueReadBuffer( buffer, CL_FALSE, 0, bytes,
+                                dst ), "enqueueReadBuffer( ) failed to download a chunk" );
+                        V_OPENCL( ( *this )[ k ].getCommandQueue( ).flush( ), "clFlush call failed" );
+                    }
+
+                    //! Reads element index of buffer, once everything before it on chunk k's queue has run
+                    template< typename T >
+                    T read( size_t k, const ::cl::Buffer& buffer, size_t index )
+                    {
+                        T value;
+                        V_OPENCL( ( *this )[ k ].getCommandQueue( ).enqueueReadBuffer( buffer, CL_TRUE,
+                            index * sizeof( T ), sizeof( T ), &value ), "enqueueReadBuffer( ) failed to read a chunk total" );
+                        return value;
+                    }
+
+                    void finish( )
+                    {
+                        for( size_t s = 0; s < m_controls.size( ); ++s )
+                            V_OPENCL( m_controls[ s ]->getCommandQueue( ).finish( ), "clFinish call failed" );
+                    }
+
+                private:
+                    std::vector< boost::shared_ptr< control > > m_controls;
+                };
+
+                /*! \brief One device_vector per slot, created on the slot's control
+                */
+                template< typename T >
+                class slotBuffers
+                {
+                public:
+                    slotBuffers( slots& mySlots, int elements )
+                    {
+                        for( size_t s = 0; s < streamingSlots; ++s )
+                            m_vectors.push_back( boost::shared_ptr< device_vector< T > >( new device_vector< T >(
+                                elements, T( ), CL_MEM_READ_WRITE, false, mySlots[ s ] ) ) );
+                    }
+
+                    device_vector< T >& operator[ ]( size_t k ) { return *m_vectors[ k % streamingSlots ]; };
+
+                private:
+                    std::vector< boost::shared_ptr< device_vector< T > > > m_vectors;
+                };
+
+                //  Merges the sorted runs of [first, first + bounds.back( )) that start at bounds into result.  A heap
+                //  holds the run whose head comes next; ties go to the earlier run.
+                template< typename RandomAccessIterator, typename OutputIterator, typename StrictWeakOrdering >
+                void merge_runs( RandomAccessIterator first, const std::vector< size_t >& bounds, OutputIterator result,
+                    StrictWeakOrdering comp )
+                {
+                    std::vector< size_t > heads( bounds.begin( ), bounds.end( ) - 1 );
+                    std::vector< size_t > heap;
+                    for( size_t r = 0; r < heads.size( ); ++r )
+                    {
+                        if( heads[ r ] < bounds[ r + 1 ] )
+                            heap.push_back( r );
+                    }
+
+                    auto later = [ & ]( size_t a, size_t b ) -> bool
+                    {
+                        if( comp( *( first + heads[ b ] ), *( first + heads[ a ] ) ) )
+                            return true;
+                        if( comp( *( first + heads[ a ] ), *( first + heads[ b ] ) ) )
+                            return false;
+                        return a > b;
+                    };
+                    std::make_heap( heap.begin( ), heap.end( ), later );
+
+                    while( !heap.empty( ) )
+                    {
+                        std::pop_heap( heap.begin( ), heap.end( ), later );
+                        size_t r = heap.back( );
+
+                        *result = *( first + heads[ r ] );
+                        ++result;
+
+                        if( ++heads[ r ] < bounds[ r + 1 ] )
+                            std::push_heap( heap.begin( ), heap.end( ), later );
+                        else
+                            heap.pop_back( );
+                    }
+                }
+            };
+
+            /******************************************************************************
+             * Algorithms that return a value
+             *****************************************************************************/
+            template< typename InputIterator, typename T, typename BinaryFunction >
+            T reduce( control& ctl, InputIterator first, InputIterator last, T init, BinaryFunction binary_op,
+                const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+                if( !detail::streamed( ctl ) )
+                    return bolt::cl::reduce( ctl, first, last, init, binary_op, user_code );
+
+                detail::chunking myChunks( ctl, static_cast< size_t >( std::distance( first, last ) ), sizeof( iType ),
+                    sizeof( iType ) );
+                detail::slots mySlots( ctl, false );
+                detail::slotBuffers< iType > input( mySlots, myChunks.capacity( ) );
+                const iType* host = bolt::cl::addressof( first );
+
+                //  Every slot's upload is in flight before the first chunk is reduced, and a slot is refilled as soon
+                //  as its chunk has been reduced
+                for( size_t k = 0; k < std::min( streamingSlots, myChunks.count( ) ); ++k )
+                    mySlots.upload( k, input[ k ].getBuffer( ), host + myChunks.offset( k ),
+                        myChunks.size( k ) * sizeof( iType ) );
+
+                T result = init;
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                {
+                    result = bolt::cl::reduce( mySlots[ k ], input[ k ].begin( ), input[ k ].begin( ) + myChunks.size( k ),
+                        result, binary_op, user_code );
+
+                    size_t next = k + streamingSlots;
+                    if( next < myChunks.count( ) )
+                        mySlots.upload( next, input[ next ].getBuffer( ), host + myChunks.offset( next ),
+                            myChunks.size( next ) * sizeof( iType ) );
+                }
+                return result;
+            };
+
+            template< typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction >
+            T transform_reduce( control& ctl, InputIterator first, InputIterator last, UnaryFunction transform_op,
+                T init, BinaryFunction reduce_op, const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+                if( !detail::streamed( ctl ) )
+                    return bolt::cl::transform_reduce( ctl, first, last, transform_op, init, reduce_op, user_code );
+
+                detail::chunking myChunks( ctl, static_cast< size_t >( std::distance( first, last ) ), sizeof( iType ),
+                    sizeof( iType ) );
+                detail::slots mySlots( ctl, false );
+                detail::slotBuffers< iType > input( mySlots, myChunks.capacity( ) );
+                const iType* host = bolt::cl::addressof( first );
+
+                for( size_t k = 0; k < std::min( streamingSlots, myChunks.count( ) ); ++k )
+                    mySlots.upload( k, input[ k ].getBuffer( ), host + myChunks.offset( k ),
+                        myChunks.size( k ) * sizeof( iType ) );
+
+                T result = init;
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                {
+                    result = bolt::cl::transform_reduce( mySlots[ k ], input[ k ].begin( ),
+                        input[ k ].begin( ) + myChunks.size( k ), transform_op, result, reduce_op, user_code );
+
+                    size_t next = k + streamingSlots;
+                    if( next < myChunks.count( ) )
+                        mySlots.upload( next, input[ next ].getBuffer( ), host + myChunks.offset( next ),
+                            myChunks.size( next ) * sizeof( iType ) );
+                }
+                return result;
+            };
+
+            template< typename InputIterator, typename Predicate >
+            typename std::iterator_traits< InputIterator >::difference_type
+            count_if( control& ctl, InputIterator first, InputIterator last, Predicate predicate,
+                const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type iType;
+                typedef typename std::iterator_traits< InputIterator >::difference_type countType;
+
+                if( !detail::streamed( ctl ) )
+                    return bolt::cl::count_if( ctl, first, last, predicate, user_code );
+
+                detail::chunking myChunks( ctl, static_cast< size_t >( std::distance( first, last ) ), sizeof( iType ),
+                    sizeof( iType ) );
+                detail::slots mySlots( ctl, false );
+                detail::slotBuffers< iType > input( mySlots, myChunks.capacity( ) );
+                const iType* host = bolt::cl::addressof( first );
+
+                for( size_t k = 0; k < std::min( streamingSlots, myChunks.count( ) ); ++k )
+                    mySlots.upload( k, input[ k ].getBuffer( ), host + myChunks.offset( k ),
+                        myChunks.size( k ) * sizeof( iType ) );
+
+                countType result = 0;
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                {
+                    result += bolt::cl::count_if( mySlots[ k ], input[ k ].begin( ),
+                        input[ k ].begin( ) + myChunks.size( k ), predicate, user_code );
+
+                    size_t next = k + streamingSlots;
+                    if( next < myChunks.count( ) )
+                        mySlots.upload( next, input[ next ].getBuffer( ), host + myChunks.offset( next ),
+                            myChunks.size( next ) * sizeof( iType ) );
+                }
+                return result;
+            };
+
+            template< typename InputIterator, typename EqualityComparable >
+            typename std::iterator_traits< InputIterator >::difference_type
+            count( control& ctl, InputIterator first, InputIterator last, const EqualityComparable& value,
+                const std::string& user_code = "" )
+            {
+                return count_if( ctl, first, last, bolt::cl::detail::CountIfEqual< EqualityComparable >( value ),
+                    CountIfEqual_OclCode + user_code );
+            };
+
+            /******************************************************************************
+             * Algorithms that write a range
+             *****************************************************************************/
+            template< typename InputIterator, typename OutputIterator, typename UnaryFunction >
+            void transform( control& ctl, InputIterator first, InputIterator last, OutputIterator result,
+                UnaryFunction op, const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type iType;
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                if( !detail::streamed( ctl ) )
+                {
+                    bolt::cl::transform( ctl, first, last, result, op, user_code );
+                    return;
+                }
+
+                detail::chunking myChunks( ctl, static_cast< size_t >( std::distance( first, last ) ),
+                    sizeof( iType ) + sizeof( oType ), std::max( sizeof( iType ), sizeof( oType ) ) );
+                detail::slots mySlots( ctl, true );
+                detail::slotBuffers< iType > input( mySlots, myChunks.capacity( ) );
+                detail::slotBuffers< oType > output( mySlots, myChunks.capacity( ) );
+                const iType* hostInput = bolt::cl::addressof( first );
+                oType* hostOutput = bolt::cl::addressof( result );
+
+                //  Nothing here waits: the queues order each slot's chunks, and the slots run side by side
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                {
+                    int n = myChunks.size( k );
+                    mySlots.upload( k, input[ k ].getBuffer( ), hostInput + myChunks.offset( k ), n * sizeof( iType ) );
+                    bolt::cl::transform( mySlots[ k ], input[ k ].begin( ), input[ k ].begin( ) + n, output[ k ].begin( ),
+                        op, user_code );
+                    mySlots.download( k, output[ k ].getBuffer( ), hostOutput + myChunks.offset( k ), n * sizeof( oType ) );
+                }
+                mySlots.finish( );
+            };
+
+            /*! \brief Scans every chunk on the device as it arrives, and combines it with the total of the chunks
+            *   before it once that total is known.  Only the totals pass through the host, so the scans of later
+            *   chunks run while the earlier ones are being finished.
+            */
+            template< typename InputIterator, typename OutputIterator, typename BinaryFunction >
+            OutputIterator inclusive_scan( control& ctl, InputIterator first, InputIterator last, OutputIterator result,
+                BinaryFunction binary_op, const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type iType;
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                if( !detail::streamed( ctl ) )
+                    return bolt::cl::inclusive_scan( ctl, first, last, result, binary_op, user_code );
+
+                size_t length = static_cast< size_t >( std::distance( first, last ) );
+                detail::chunking myChunks( ctl, length, sizeof( iType ) + sizeof( oType ),
+                    std::max( sizeof( iType ), sizeof( oType ) ) );
+                detail::slots mySlots( ctl, true );
+                detail::slotBuffers< iType > input( mySlots, myChunks.capacity( ) );
+                detail::slotBuffers< oType > scanned( mySlots, myChunks.capacity( ) );
+                const iType* hostInput = bolt::cl::addressof( first );
+                oType* hostOutput = bolt::cl::addressof( result );
+
+                auto start = [ & ]( size_t k )
+                {
+                    int n = myChunks.size( k );
+                    mySlots.upload( k, input[ k ].getBuffer( ), hostInput + myChunks.offset( k ), n * sizeof( iType ) );
+                    bolt::cl::inclusive_scan( mySlots[ k ], input[ k ].begin( ), input[ k ].begin( ) + n,
+                        scanned[ k ].begin( ), binary_op, user_code );
+                    V_OPENCL( mySlots[ k ].getCommandQueue( ).flush( ), "clFlush call failed" );
+                };
+
+                for( size_t k = 0; k < std::min( streamingSlots, myChunks.count( ) ); ++k )
+                    start( k );
+
+                oType carry = oType( );
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                {
+                    int n = myChunks.size( k );
+                    oType total = mySlots.read< oType >( k, scanned[ k ].getBuffer( ), n - 1 );
+
+                    if( k > 0 )
+                    {
+                        bolt::cl::constant_iterator< oType > carryIn( carry );
+                        bolt::cl::transform( mySlots[ k ], carryIn, carryIn + n, scanned[ k ].begin( ),
+                            scanned[ k ].begin( ), binary_op, user_code );
+                        carry = binary_op( carry, total );
+                    }
+                    else
+                        carry = total;
+                    mySlots.download( k, scanned[ k ].getBuffer( ), hostOutput + myChunks.offset( k ), n * sizeof( oType ) );
+
+                    size_t next = k + streamingSlots;
+                    if( next < myChunks.count( ) )
+                        start( next );
+                }
+                mySlots.finish( );
+                return result + length;
+            };
+
+            template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+            OutputIterator exclusive_scan( control& ctl, InputIterator first, InputIterator last, OutputIterator result,
+                T init, BinaryFunction binary_op, const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< InputIterator >::value_type iType;
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                if( !detail::streamed( ctl ) )
+                    return bolt::cl::exclusive_scan( ctl, first, last, result, init, binary_op, user_code );
+
+                size_t length = static_cast< size_t >( std::distance( first, last ) );
+                detail::chunking myChunks( ctl, length, sizeof( iType ) + 2 * sizeof( oType ),
+                    std::max( sizeof( iType ), sizeof( oType ) ) );
+                detail::slots mySlots( ctl, true );
+                detail::slotBuffers< iType > input( mySlots, myChunks.capacity( ) );
+                detail::slotBuffers< oType > scanned( mySlots, myChunks.capacity( ) );
+                detail::slotBuffers< oType > output( mySlots, myChunks.capacity( ) );
+                const iType* hostInput = bolt::cl::addressof( first );
+                oType* hostOutput = bolt::cl::addressof( result );
+
+                auto start = [ & ]( size_t k )
+                {
+                    int n = myChunks.size( k );
+                    mySlots.upload( k, input[ k ].getBuffer( ), hostInput + myChunks.offset( k ), n * sizeof( iType ) );
+                    bolt::cl::inclusive_scan( mySlots[ k ], input[ k ].begin( ), input[ k ].begin( ) + n,
+                        scanned[ k ].begin( ), binary_op, user_code );
+                    V_OPENCL( mySlots[ k ].getCommandQueue( ).flush( ), "clFlush call failed" );
+                };
+
+                for( size_t k = 0; k < std::min( streamingSlots, myChunks.count( ) ); ++k )
+                    start( k );
+
+                //  Element i of a chunk is the carry combined with element i - 1 of the chunk's inclusive scan
+                oType carry = init;
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                {
+                    int n = myChunks.size( k );
+                    oType total = mySlots.read< oType >( k, scanned[ k ].getBuffer( ), n - 1 );
+
+                    bolt::cl::fill( mySlots[ k ], output[ k ].begin( ), output[ k ].begin( ) + 1, carry );
+                    if( n > 1 )
+                    {
+                        bolt::cl::constant_iterator< oType > carryIn( carry );
+                        bolt::cl::transform( mySlots[ k ], carryIn, carryIn + ( n - 1 ), scanned[ k ].begin( ),
+                            output[ k ].begin( ) + 1, binary_op, user_code );
+                    }
+                    carry = binary_op( carry, total );
+                    mySlots.download( k, output[ k ].getBuffer( ), hostOutput + myChunks.offset( k ), n * sizeof( oType ) );
+
+                    size_t next = k + streamingSlots;
+                    if( next < myChunks.count( ) )
+                        start( next );
+                }
+                mySlots.finish( );
+                return result + length;
+            };
+
+            /*! \brief Sorts every chunk on the device, back into its place in the range, then merges the sorted
+            *   chunks into scratch and copies the merged range back.  scratch is the start of a host range as long
+            *   as the input, which may be memory mapped as well.
+            */
+            template< typename RandomAccessIterator, typename ScratchIterator, typename StrictWeakOrdering >
+            void sort( control& ctl, RandomAccessIterator first, RandomAccessIterator last, ScratchIterator scratch,
+                StrictWeakOrdering comp, const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+
+                if( !detail::streamed( ctl ) )
+                {
+                    bolt::cl::sort( ctl, first, last, comp, user_code );
+                    return;
+                }
+
+                size_t length = static_cast< size_t >( std::distance( first, last ) );
+                detail::chunking myChunks( ctl, length, sizeof( T ), sizeof( T ) );
+                T* host = bolt::cl::addressof( first );
+                {
+                    detail::slots mySlots( ctl, true );
+                    detail::slotBuffers< T > keys( mySlots, myChunks.capacity( ) );
+
+                    for( size_t k = 0; k < myChunks.count( ); ++k )
+                    {
+                        int n = myChunks.size( k );
+                        mySlots.upload( k, keys[ k ].getBuffer( ), host + myChunks.offset( k ), n * sizeof( T ) );
+                        bolt::cl::sort( mySlots[ k ], keys[ k ].begin( ), keys[ k ].begin( ) + n, comp, user_code );
+                        mySlots.download( k, keys[ k ].getBuffer( ), host + myChunks.offset( k ), n * sizeof( T ) );
+                    }
+                    mySlots.finish( );
+                }
+
+                if( myChunks.count( ) < 2 )
+                    return;
+
+                std::vector< size_t > bounds;
+                for( size_t k = 0; k < myChunks.count( ); ++k )
+                    bounds.push_back( myChunks.offset( k ) );
+                bounds.push_back( length );
+
+                detail::merge_runs( first, bounds, scratch, comp );
+                std::copy( scratch, scratch + length, first );
+            };
+
+            //  As above, with a scratch range allocated on the heap
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            void sort( control& ctl, RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp,
+                const std::string& user_code = "" )
+            {
+                typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+
+                if( !detail::streamed( ctl ) )
+                {
+                    bolt::cl::sort( ctl, first, last, comp, user_code );
+                    return;
+                }
+
+                std::vector< T > scratch( std::distance( first, last ) );
+                sort( ctl, first, last, scratch.begin( ), comp, user_code );
+            };
+
+        };
+    };
+};
+
+#endif
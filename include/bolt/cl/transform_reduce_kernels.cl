@@ -15,6 +15,15 @@
 
 ***************************************************************************/                                                                                     
 
+//  The host passes the tuned work group size and unroll factor with -D; these are the untuned defaults
+#ifndef REDUCE_WGSIZE
+#define REDUCE_WGSIZE 256
+#endif
+
+#ifndef REDUCE_UNROLL
+#define REDUCE_UNROLL 1
+#endif
+
 #define _REDUCE_STEP(_LENGTH, _IDX, _W) \
     if ((_IDX < _W) && ((_IDX + _W) < _LENGTH)) {\
       oNakedType mine = scratch[_IDX];\
@@ -23,44 +32,56 @@
     }\
     barrier(CLK_LOCAL_MEM_FENCE);
 
+//  The transform and reduction of an initialized input iterator; transform_reduceTemplate and the zip_iterator
+//  kernel that the host generates share it
 template< typename iNakedType, typename iIterType, typename oNakedType, typename unary_function,
     typename binary_function>
-kernel void transform_reduceTemplate(
-    global iNakedType* input_ptr,
+void transform_reduceRange(
     iIterType input_iter,
     const int length,
     global unary_function* transformFunctor,
     const oNakedType init,
     global binary_function* reduceFunctor,
     global oNakedType* result_ptr,
-    // oIterType result_iter,
     local oNakedType* scratch
 )
 {
     int gx = get_global_id( 0 );
-
-    //  Abort threads that are passed the end of the input vector
-    if( gx >= length )
-        return;
-
-    input_iter.init( input_ptr );
-    // result_iter.init( result_ptr );
+    int gloId = gx;
 
     //  Initialize the accumulator private variable with data from the input array
-    //  This essentially unrolls the loop below at least once
-    iNakedType inputReg = input_iter[gx];
-    oNakedType accumulator = (*transformFunctor)( inputReg );
-    gx += get_global_size( 0 );
+    //  This essentially unrolls the loop below at least once; work items past the end still take part in the
+    //  barriers below, and tail keeps their accumulator out of the reduction
+    oNakedType accumulator;
+    if( gloId < length )
+    {
+        iNakedType inputReg = input_iter[gx];
+        accumulator = (*transformFunctor)( inputReg );
+        gx += get_global_size( 0 );
+    }
 
     // Loop sequentially over chunks of input vector, reducing an arbitrary size input
     // length into a length related to the number of workgroups
+    int stride = get_global_size( 0 );
+#if REDUCE_UNROLL > 1
+    // Unrolled trips keep the order of the combinations, so non-commutative functors see the same sequence
+    while( gx + ( REDUCE_UNROLL - 1 ) * stride < length )
+    {
+        for( int u = 0; u < REDUCE_UNROLL; ++u )
+        {
+            iNakedType element = input_iter[gx];
+            accumulator = (*reduceFunctor)( accumulator, (*transformFunctor)( element ) );
+            gx += stride;
+        }
+    }
+#endif
     while( gx < length )
     {
         iNakedType element = input_iter[gx];
         oNakedType transformedElement = (*transformFunctor)( element );
 
         accumulator = (*reduceFunctor)( accumulator, transformedElement );
-        gx += get_global_size(0);
+        gx += stride;
     }
 
     // Perform parallel reduction through shared memory:
@@ -83,18 +104,38 @@ kernel void transform_reduceTemplate(
     //    barrier(CLK_LOCAL_MEM_FENCE);
     //}
     // Parallel reduction within a given workgroup using local data store
-    // to share values between workitems
-    _REDUCE_STEP( tail, local_index, 128 );
-    _REDUCE_STEP( tail, local_index, 64 );
-    _REDUCE_STEP( tail, local_index, 32 );
-    _REDUCE_STEP( tail, local_index, 16 );
-    _REDUCE_STEP( tail, local_index,  8 );
-    _REDUCE_STEP( tail, local_index,  4 );
-    _REDUCE_STEP( tail, local_index,  2 );
-    _REDUCE_STEP( tail, local_index,  1 );
+    // to share values between workitems; the trip count is a compile time constant, so this unrolls
+    for( int w = REDUCE_WGSIZE / 2; w > 0; w >>= 1 )
+    {
+        _REDUCE_STEP( tail, local_index, w );
+    }
+
+    //  Abort threads that are passed the end of the input vector
+    if( gloId >= length )
+        return;
 
     if( local_index == 0 )
     {
         result_ptr[ get_group_id( 0 ) ] = scratch[ 0 ];
     }
+}
+
+template< typename iNakedType, typename iIterType, typename oNakedType, typename unary_function,
+    typename binary_function>
+kernel void transform_reduceTemplate(
+    global iNakedType* input_ptr,
+    iIterType input_iter,
+    const int length,
+    global unary_function* transformFunctor,
+    const oNakedType init,
+    global binary_function* reduceFunctor,
+    global oNakedType* result_ptr,
+    // oIterType result_iter,
+    local oNakedType* scratch
+)
+{
+    input_iter.init( input_ptr );
+    // result_iter.init( result_ptr );
+    transform_reduceRange< iNakedType >( input_iter, length, transformFunctor, init, reduceFunctor, result_ptr,
+        scratch );
 };
@@ -0,0 +1,134 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_TUNING_H )
+#define BOLT_CL_TUNING_H
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "bolt/cl/control.h"
+
+/*! \file bolt/cl/tuning.h
+    \brief Work-group shapes found by control::AutoTuneWorkShape, kept per device, algorithm and value size.
+
+    Only the single pass reductions, reduce, transform_reduce and count, are tuned.  Scan, sort, the by-key
+    algorithms and the rest run several kernels whose tile sizes, scratch buffers and host-side passes are all
+    derived from the one work-group size compiled into them, so they keep their fixed shapes.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \brief Launch shape of a reduction-style kernel
+        */
+        struct WorkShape
+        {
+            size_t  wgSize;             //!< Work items per work group
+            size_t  wgPerComputeUnit;   //!< Work groups launched per compute unit
+            int     unroll;             //!< Elements each work item reads per trip of its sequential loop
+        };
+
+        /*! \brief Looks up the tuned shape of an algorithm for the device of the control's queue
+        *   \details The first lookup reads the file named by the BOLT_TUNING_DB environment variable, if it is set.
+        *   \return false if the algorithm has not been tuned for this device and value size
+        */
+        bool findWorkShape( const control& ctl, const std::string& algorithm, size_t typeSize, WorkShape& shape );
+
+        /*! \brief Remembers a tuned shape; it is written to BOLT_TUNING_DB, if that is set, at exit
+        */
+        void storeWorkShape( const control& ctl, const std::string& algorithm, size_t typeSize,
+            const WorkShape& shape );
+
+        /*! \brief Writes every known shape to a text file, one "device|algorithm|typeSize" entry per line
+        */
+        bool saveTuningDatabase( const std::string& path );
+
+        /*! \brief Reads shapes from a file written by saveTuningDatabase or bolt-tune; they replace known entries
+        */
+        bool loadTuningDatabase( const std::string& path );
+
+        /*! \brief Forgets every shape, so that the next AutoTuneWorkShape call sweeps again
+        */
+        void clearTuningDatabase( );
+
+        //  Number of candidate shapes that were timed, summed over all sweeps in this process
+        size_t getTuningSweepCount( );
+
+        namespace detail {
+
+            //  Candidate shapes for a reduction-style kernel on the control's device
+            std::vector< WorkShape > reduceWorkShapes( const control& ctl );
+
+            void countSweep( );
+            double tuningClock( );
+
+            //  Times one launch per candidate, after a launch that pays for its compile
+            template< typename Launch >
+            WorkShape sweepWorkShape( const std::vector< WorkShape >& candidates, const WorkShape& defaults,
+                Launch& launch )
+            {
+                WorkShape best = defaults;
+                double bestTime = -1.0;
+
+                for( size_t c = 0; c < candidates.size( ); ++c )
+                {
+                    launch( candidates[ c ] );
+
+                    double start = tuningClock( );
+                    launch( candidates[ c ] );
+                    double elapsed = tuningClock( ) - start;
+                    countSweep( );
+
+                    if( bestTime < 0.0 || elapsed < bestTime )
+                    {
+                        best = candidates[ c ];
+                        bestTime = elapsed;
+                    }
+                }
+
+                return best;
+            }
+
+            /*! \brief Shape to launch an algorithm with
+            *   \details A tuned shape is used whenever there is one.  Otherwise, if the control asks for
+            *   AutoTuneWorkShape, every candidate is timed with \p launch, which must run the algorithm to
+            *   completion, and the fastest is stored; without it the defaults are used.
+            */
+            template< typename Launch >
+            WorkShape tunedWorkShape( const control& ctl, const std::string& algorithm, size_t typeSize,
+                const WorkShape& defaults, Launch launch )
+            {
+                WorkShape shape;
+                if( findWorkShape( ctl, algorithm, typeSize, shape ) )
+                    return shape;
+
+                if( ( ctl.getAutoTune( ) & control::AutoTuneWorkShape ) == 0 )
+                    return defaults;
+
+                shape = sweepWorkShape( reduceWorkShapes( ctl ), defaults, launch );
+                storeWorkShape( ctl, algorithm, typeSize, shape );
+                return shape;
+            }
+
+        } // namespace detail
+
+    };
+};
+
+#endif
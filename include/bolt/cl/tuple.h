@@ -0,0 +1,353 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+#pragma once
+#if !defined( BOLT_CL_TUPLE_H )
+#define BOLT_CL_TUPLE_H
+
+#include <string>
+#include <type_traits>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/pair.h"
+
+/*! \file bolt/cl/tuple.h
+ *  \brief A type encapsulating a heterogeneous group of two to four elements, usable on the host and the device
+ */
+
+namespace bolt
+{
+    namespace cl
+    {
+/*! \addtogroup Miscellaneous
+ *  \{
+ */
+
+/*! \addtogroup tuple
+ *  \{
+ */
+
+/*! \p tuple groups two to four values of possibly different types; unused slots are \p null_type.  The same
+ *  definition is compiled into kernels, so a \p tuple can be the value type of a \p zip_iterator, the argument of a
+ *  functor, or the element of a \p device_vector.  The elements are the members \p first, \p second, \p third and
+ *  \p fourth; \c operator< compares them lexicographically.
+ *
+ *  \code
+ *  #include <bolt/cl/tuple.h>
+ *
+ *  bolt::cl::tuple< int, float > t = bolt::cl::make_tuple( 1, 2.5f );
+ *
+ *  // t.first is 1, bolt::cl::get< 1 >( t ) is 2.5f
+ *  \endcode
+ */
+static const std::string tupleTemplate = BOLT_HOST_DEVICE_DEFINITION(
+struct null_type
+{
+    typedef null_type value_type;
+    typedef null_type base_type;
+
+    bool operator==( const null_type& rhs ) const { return true; }
+    bool operator<( const null_type& rhs ) const { return false; }
+};
+
+template< typename T0, typename T1, typename T2 = null_type, typename T3 = null_type >
+struct tuple
+{
+    typedef T0 first_type;
+    typedef T1 second_type;
+    typedef T2 third_type;
+    typedef T3 fourth_type;
+
+    tuple( ) {}
+    tuple( const T0& a, const T1& b, const T2& c, const T3& d ): first( a ), second( b ), third( c ), fourth( d ) {}
+
+    bool operator==( const tuple& rhs ) const
+    {
+        return first == rhs.first && second == rhs.second && third == rhs.third && fourth == rhs.fourth;
+    }
+
+    bool operator<( const tuple& rhs ) const
+    {
+        if( first < rhs.first ) return true;
+        if( rhs.first < first ) return false;
+        if( second < rhs.second ) return true;
+        if( rhs.second < second ) return false;
+        if( third < rhs.third ) return true;
+        if( rhs.third < third ) return false;
+        return fourth < rhs.fourth;
+    }
+
+    T0 first;
+    T1 second;
+    T2 third;
+    T3 fourth;
+};
+
+template< typename T0, typename T1, typename T2 >
+struct tuple< T0, T1, T2, null_type >
+{
+    typedef T0 first_type;
+    typedef T1 second_type;
+    typedef T2 third_type;
+    typedef null_type fourth_type;
+
+    tuple( ) {}
+    tuple( const T0& a, const T1& b, const T2& c ): first( a ), second( b ), third( c ) {}
+
+    bool operator==( const tuple& rhs ) const
+    {
+        return first == rhs.first && second == rhs.second && third == rhs.third;
+    }
+
+    bool operator<( const tuple& rhs ) const
+    {
+        if( first < rhs.first ) return true;
+        if( rhs.first < first ) return false;
+        if( second < rhs.second ) return true;
+        if( rhs.second < second ) return false;
+        return third < rhs.third;
+    }
+
+    T0 first;
+    T1 second;
+    T2 third;
+};
+
+template< typename T0, typename T1 >
+struct tuple< T0, T1, null_type, null_type >
+{
+    typedef T0 first_type;
+    typedef T1 second_type;
+    typedef null_type third_type;
+    typedef null_type fourth_type;
+
+    tuple( ) {}
+    tuple( const T0& a, const T1& b ): first( a ), second( b ) {}
+
+    bool operator==( const tuple& rhs ) const
+    {
+        return first == rhs.first && second == rhs.second;
+    }
+
+    bool operator<( const tuple& rhs ) const
+    {
+        if( first < rhs.first ) return true;
+        if( rhs.first < first ) return false;
+        return second < rhs.second;
+    }
+
+    T0 first;
+    T1 second;
+};
+);
+
+/*! This operator tests two \p tuples for inequality.
+ */
+template< typename T0, typename T1, typename T2, typename T3 >
+bool operator!=( const tuple< T0, T1, T2, T3 >& x, const tuple< T0, T1, T2, T3 >& y )
+{
+    return !( x == y );
+}
+
+/*! This operator tests two \p tuples for descending ordering.
+ */
+template< typename T0, typename T1, typename T2, typename T3 >
+bool operator>( const tuple< T0, T1, T2, T3 >& x, const tuple< T0, T1, T2, T3 >& y )
+{
+    return y < x;
+}
+
+/*! This operator tests two \p tuples for ascending ordering or equivalence.
+ */
+template< typename T0, typename T1, typename T2, typename T3 >
+bool operator<=( const tuple< T0, T1, T2, T3 >& x, const tuple< T0, T1, T2, T3 >& y )
+{
+    return !( y < x );
+}
+
+/*! This operator tests two \p tuples for descending ordering or equivalence.
+ */
+template< typename T0, typename T1, typename T2, typename T3 >
+bool operator>=( const tuple< T0, T1, T2, T3 >& x, const tuple< T0, T1, T2, T3 >& y )
+{
+    return !( x < y );
+}
+
+/*! This function creates a \p tuple of two elements.
+ */
+template< typename T0, typename T1 >
+tuple< T0, T1 > make_tuple( const T0& a, const T1& b )
+{
+    return tuple< T0, T1 >( a, b );
+}
+
+/*! This function creates a \p tuple of three elements.
+ */
+template< typename T0, typename T1, typename T2 >
+tuple< T0, T1, T2 > make_tuple( const T0& a, const T1& b, const T2& c )
+{
+    return tuple< T0, T1, T2 >( a, b, c );
+}
+
+/*! This function creates a \p tuple of four elements.
+ */
+template< typename T0, typename T1, typename T2, typename T3 >
+tuple< T0, T1, T2, T3 > make_tuple( const T0& a, const T1& b, const T2& c, const T3& d )
+{
+    return tuple< T0, T1, T2, T3 >( a, b, c, d );
+}
+
+template< typename T0, typename T1, typename T2, typename T3 >
+struct tuple_element< 0, tuple< T0, T1, T2, T3 > >
+{
+    typedef T0 type;
+};
+
+template< typename T0, typename T1, typename T2, typename T3 >
+struct tuple_element< 1, tuple< T0, T1, T2, T3 > >
+{
+    typedef T1 type;
+};
+
+template< typename T0, typename T1, typename T2, typename T3 >
+struct tuple_element< 2, tuple< T0, T1, T2, T3 > >
+{
+    typedef T2 type;
+};
+
+template< typename T0, typename T1, typename T2, typename T3 >
+struct tuple_element< 3, tuple< T0, T1, T2, T3 > >
+{
+    typedef T3 type;
+};
+
+//  The number of elements is the number of slots that are not null_type
+template< typename T0, typename T1, typename T2, typename T3 >
+struct tuple_size< tuple< T0, T1, T2, T3 > >
+{
+    static const unsigned int value = 2 + !std::is_same< T2, null_type >::value + !std::is_same< T3, null_type >::value;
+};
+
+namespace detail
+{
+    template< int N, typename Tuple > struct tuple_get {};
+
+    template< typename Tuple >
+    struct tuple_get< 0, Tuple >
+    {
+        static typename tuple_element< 0, Tuple >::type& get( Tuple& t ) { return t.first; }
+        static const typename tuple_element< 0, Tuple >::type& get( const Tuple& t ) { return t.first; }
+    };
+
+    template< typename Tuple >
+    struct tuple_get< 1, Tuple >
+    {
+        static typename tuple_element< 1, Tuple >::type& get( Tuple& t ) { return t.second; }
+        static const typename tuple_element< 1, Tuple >::type& get( const Tuple& t ) { return t.second; }
+    };
+
+    template< typename Tuple >
+    struct tuple_get< 2, Tuple >
+    {
+        static typename tuple_element< 2, Tuple >::type& get( Tuple& t ) { return t.third; }
+        static const typename tuple_element< 2, Tuple >::type& get( const Tuple& t ) { return t.third; }
+    };
+
+    template< typename Tuple >
+    struct tuple_get< 3, Tuple >
+    {
+        static typename tuple_element< 3, Tuple >::type& get( Tuple& t ) { return t.fourth; }
+        static const typename tuple_element< 3, Tuple >::type& get( const Tuple& t ) { return t.fourth; }
+    };
+}
+
+/*! This function returns a reference to the element \p N of a \p tuple.
+ */
+template< unsigned int N, typename T0, typename T1, typename T2, typename T3 >
+typename tuple_element< N, tuple< T0, T1, T2, T3 > >::type& get( tuple< T0, T1, T2, T3 >& t )
+{
+    return detail::tuple_get< N, tuple< T0, T1, T2, T3 > >::get( t );
+}
+
+/*! This function returns a const reference to the element \p N of a \p tuple.
+ */
+template< unsigned int N, typename T0, typename T1, typename T2, typename T3 >
+const typename tuple_element< N, tuple< T0, T1, T2, T3 > >::type& get( const tuple< T0, T1, T2, T3 >& t )
+{
+    return detail::tuple_get< N, tuple< T0, T1, T2, T3 > >::get( t );
+}
+
+/*! \} // tuple
+ */
+
+/*! \} // Miscellaneous
+ */
+    } //end cl
+} // end bolt
+
+BOLT_CREATE_TYPENAME( bolt::cl::null_type );
+
+//  The name of a tuple lists its element types; the null_type slots are the defaults and are left out
+template< typename T0, typename T1, typename T2, typename T3 >
+struct TypeName< bolt::cl::tuple< T0, T1, T2, T3 > >
+{
+    static std::string get( )
+    {
+        std::string name = "bolt::cl::tuple< " + TypeName< T0 >::get( ) + ", " + TypeName< T1 >::get( );
+        if( !std::is_same< T2, bolt::cl::null_type >::value )
+            name += ", " + TypeName< T2 >::get( );
+        if( !std::is_same< T3, bolt::cl::null_type >::value )
+            name += ", " + TypeName< T3 >::get( );
+        return name + " >";
+    }
+};
+
+//  The code of a tuple is the code of its element types followed by the tuple template, each guarded so that
+//  tuples sharing element types can be used in one kernel
+template< typename T0, typename T1, typename T2, typename T3 >
+struct ClCode< bolt::cl::tuple< T0, T1, T2, T3 > >
+{
+    static std::string get( )
+    {
+        return bolt::cl::guardCode( ClCode< T0 >::get( ) )
+            + bolt::cl::guardCode( ClCode< T1 >::get( ) )
+            + bolt::cl::guardCode( ClCode< T2 >::get( ) )
+            + bolt::cl::guardCode( ClCode< T3 >::get( ) )
+            + bolt::cl::guardCode( bolt::cl::tupleTemplate );
+    }
+};
+
+//  identity over a tuple moves whole elements, so transform can copy zipped columns on the device
+template< typename T0, typename T1, typename T2, typename T3 >
+struct TypeName< bolt::cl::identity< bolt::cl::tuple< T0, T1, T2, T3 > > >
+{
+    static std::string get( )
+    {
+        return "bolt::cl::identity< " + TypeName< bolt::cl::tuple< T0, T1, T2, T3 > >::get( ) + " >";
+    }
+};
+
+template< typename T0, typename T1, typename T2, typename T3 >
+struct ClCode< bolt::cl::identity< bolt::cl::tuple< T0, T1, T2, T3 > > >
+{
+    static std::string get( )
+    {
+        return ClCode< bolt::cl::tuple< T0, T1, T2, T3 > >::get( ) + bolt::cl::guardCode( bolt::cl::identityFunctor );
+    }
+};
+
+#endif
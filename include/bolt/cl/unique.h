@@ -0,0 +1,260 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_UNIQUE_H )
+#define BOLT_CL_UNIQUE_H
+#pragma once
+
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/pair.h"
+
+#include <string>
+
+/*! \file bolt/cl/unique.h
+    \brief Removes all but the first element of every run of equal elements.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup CL-unique
+        *   \ingroup copying
+        *   \{
+        */
+
+        /*! unique removes all but the first element of every run of consecutive elements of [first, last) that
+         *  pred finds equal, moving the elements it keeps to the front of the range in order.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the sequence.
+         * \param last  End of the sequence.
+         * \param pred \b Optional Binary predicate comparing an element with the one before it; bolt::cl::equal_to
+         *  by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The new end of the sequence.
+         *
+         * \tparam ForwardIterator is a model of ForwardIterator
+         * \tparam BinaryPredicate is a model of BinaryPredicate
+         *
+         *  \code
+         *  #include <bolt/cl/unique.h>
+         *  ...
+         *
+         *  int input[ 8 ] = { 1, 1, 2, 2, 2, 3, 1, 1 };
+         *
+         *  int *end = bolt::cl::unique( input, input + 8 );
+         *
+         *  // input now begins with { 1, 2, 3, 1 } and end - input is 4
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/unique.html
+         */
+        template<typename ForwardIterator>
+        ForwardIterator unique(
+            bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator>
+        ForwardIterator unique(
+            ForwardIterator first,
+            ForwardIterator last,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator, typename BinaryPredicate>
+        ForwardIterator unique(
+            bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator, typename BinaryPredicate>
+        ForwardIterator unique(
+            ForwardIterator first,
+            ForwardIterator last,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        /*! unique_copy copies the first element of every run of consecutive elements of [first, last) that pred
+         *  finds equal to the sequence beginning at result.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first Beginning of the source sequence.
+         * \param last  End of the source sequence.
+         * \param result Beginning of the destination sequence.
+         * \param pred \b Optional Binary predicate; bolt::cl::equal_to by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return The end of the destination sequence.
+         *
+         *  \sa http://www.sgi.com/tech/stl/unique_copy.html
+         */
+        template<typename InputIterator, typename OutputIterator>
+        OutputIterator unique_copy(
+            bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator, typename OutputIterator>
+        OutputIterator unique_copy(
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            const std::string& user_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+        OutputIterator unique_copy(
+            bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename BinaryPredicate>
+        OutputIterator unique_copy(
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        /*! unique_by_key keeps the first key of every run of consecutive keys that pred finds equal, with its value,
+         *  and moves them to the front of the keys and values ranges.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param keys_first Beginning of the key sequence.
+         * \param keys_last  End of the key sequence.
+         * \param values_first Beginning of the value sequence, as long as the keys.
+         * \param pred \b Optional Binary predicate comparing keys; bolt::cl::equal_to by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return pair(new end of the keys, new end of the values)
+         *
+         *  \code
+         *  #include <bolt/cl/unique.h>
+         *  ...
+         *
+         *  int keys[ 6 ] = { 1, 1, 2, 3, 3, 3 };
+         *  int values[ 6 ] = { 9, 8, 7, 6, 5, 4 };
+         *
+         *  bolt::cl::unique_by_key( keys, keys + 6, values );
+         *
+         *  // keys now begins with { 1, 2, 3 } and values with { 9, 7, 6 }
+         *  \endcode
+         */
+        template<typename ForwardIterator1, typename ForwardIterator2>
+        pair<ForwardIterator1, ForwardIterator2> unique_by_key(
+            bolt::cl::control &ctl,
+            ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last,
+            ForwardIterator2 values_first,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator1, typename ForwardIterator2>
+        pair<ForwardIterator1, ForwardIterator2> unique_by_key(
+            ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last,
+            ForwardIterator2 values_first,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+        pair<ForwardIterator1, ForwardIterator2> unique_by_key(
+            bolt::cl::control &ctl,
+            ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last,
+            ForwardIterator2 values_first,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        template<typename ForwardIterator1, typename ForwardIterator2, typename BinaryPredicate>
+        pair<ForwardIterator1, ForwardIterator2> unique_by_key(
+            ForwardIterator1 keys_first,
+            ForwardIterator1 keys_last,
+            ForwardIterator2 values_first,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        /*! unique_by_key_copy copies the first key of every run of consecutive keys that pred finds equal, and its
+         *  value, to the sequences beginning at keys_result and values_result.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param keys_first Beginning of the key sequence.
+         * \param keys_last  End of the key sequence.
+         * \param values_first Beginning of the value sequence, as long as the keys.
+         * \param keys_result Beginning of the key output sequence.
+         * \param values_result Beginning of the value output sequence.
+         * \param pred \b Optional Binary predicate comparing keys; bolt::cl::equal_to by default.
+         * \param user_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+         * \return pair(end of the key output, end of the value output)
+         */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2> unique_by_key_copy(
+            bolt::cl::control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2> unique_by_key_copy(
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename BinaryPredicate>
+        pair<OutputIterator1, OutputIterator2> unique_by_key_copy(
+            bolt::cl::control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename BinaryPredicate>
+        pair<OutputIterator1, OutputIterator2> unique_by_key_copy(
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            BinaryPredicate pred,
+            const std::string& user_code="");
+
+        /*!   \}  */
+    };
+};
+
+#include <bolt/cl/detail/unique.inl>
+#endif
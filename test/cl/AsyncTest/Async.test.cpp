@@ -0,0 +1,180 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "bolt/cl/async.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+class AsyncTest: public testing::Test
+{
+public:
+    AsyncTest( ): myControl( bolt::cl::control::getDefault( ) ), length( 1 << 16 )
+    {}
+
+    virtual void SetUp( )
+    {
+        myControl.setForceRunMode( bolt::cl::control::OpenCL );
+        myControl.setWaitMode( bolt::cl::control::BusyWait );
+
+        stdInput.resize( length );
+        for( int i = 0; i < length; ++i )
+            stdInput[ i ] = rand( ) % 1000 - 500;
+    };
+
+protected:
+    bolt::cl::control myControl;
+    int length;
+    std::vector< int > stdInput;
+};
+
+TEST_F( AsyncTest, TransformReturnsEvent )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+    bolt::cl::device_vector< int > output( length );
+
+    bolt::cl::async::future< void > done = bolt::cl::async::transform( myControl, input.begin( ), input.end( ),
+        output.begin( ), bolt::cl::negate< int >( ) );
+    EXPECT_TRUE( done.valid( ) );
+
+    //  The control keeps the wait mode it had before the call
+    EXPECT_EQ( bolt::cl::control::BusyWait, myControl.getWaitMode( ) );
+
+    done.wait( );
+    EXPECT_TRUE( done.ready( ) );
+
+    std::transform( stdInput.begin( ), stdInput.end( ), stdInput.begin( ), std::negate< int >( ) );
+    cmpArrays( stdInput, output );
+}
+
+TEST_F( AsyncTest, ChainWithoutHostWait )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+    bolt::cl::device_vector< int > scanned( length );
+
+    //  Neither call waits for the previous one; the queue orders them
+    bolt::cl::async::sort( myControl, input.begin( ), input.end( ), bolt::cl::less< int >( ) );
+    bolt::cl::async::future< bolt::cl::device_vector< int >::iterator > done = bolt::cl::async::inclusive_scan(
+        myControl, input.begin( ), input.end( ), scanned.begin( ), bolt::cl::plus< int >( ) );
+
+    EXPECT_EQ( scanned.end( ) - scanned.begin( ), done.get( ) - scanned.begin( ) );
+
+    std::sort( stdInput.begin( ), stdInput.end( ) );
+    std::partial_sum( stdInput.begin( ), stdInput.end( ), stdInput.begin( ) );
+    cmpArrays( stdInput, scanned );
+}
+
+TEST_F( AsyncTest, WaitListOrdersOtherQueues )
+{
+    bolt::cl::control otherControl( myControl );
+    otherControl.setCommandQueue( ::cl::CommandQueue( myControl.getContext( ), myControl.getDevice( ) ) );
+
+    bolt::cl::device_vector< int > input( length, 0 );
+    bolt::cl::device_vector< int > output( length );
+
+    bolt::cl::async::future< void > filled = bolt::cl::async::fill( myControl, input.begin( ), input.end( ), 3 );
+    bolt::cl::async::future< void > done = bolt::cl::async::transform( otherControl, input.begin( ), input.end( ),
+        output.begin( ), bolt::cl::square< int >( ), std::vector< ::cl::Event >( 1, filled.event( ) ) );
+    done.wait( );
+
+    std::vector< int > expected( length, 9 );
+    cmpArrays( expected, output );
+}
+
+TEST_F( AsyncTest, ScalarResults )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+
+    bolt::cl::async::future< int > sum = bolt::cl::async::reduce( myControl, input.begin( ), input.end( ), 0,
+        bolt::cl::plus< int >( ) );
+    bolt::cl::async::future< bolt::cl::iterator_traits< bolt::cl::device_vector< int >::iterator >::difference_type >
+        zeros = bolt::cl::async::count( myControl, input.begin( ), input.end( ), 0 );
+    bolt::cl::async::future< bolt::cl::device_vector< int >::iterator > smallest = bolt::cl::async::min_element(
+        myControl, input.begin( ), input.end( ), bolt::cl::less< int >( ) );
+
+    EXPECT_EQ( std::accumulate( stdInput.begin( ), stdInput.end( ), 0 ), sum.get( ) );
+    EXPECT_EQ( std::count( stdInput.begin( ), stdInput.end( ), 0 ), zeros.get( ) );
+    EXPECT_EQ( std::min_element( stdInput.begin( ), stdInput.end( ) ) - stdInput.begin( ),
+        smallest.get( ) - input.begin( ) );
+    EXPECT_TRUE( sum.ready( ) );
+}
+
+TEST_F( AsyncTest, ScalarResultChainsOnDevice )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+    bolt::cl::device_vector< int > output( length );
+
+    //  The reduce finishes on a worker thread; its event is a user event the next call can wait on
+    bolt::cl::async::future< int > sum = bolt::cl::async::reduce( myControl, input.begin( ), input.end( ), 0,
+        bolt::cl::plus< int >( ) );
+    bolt::cl::async::future< void > done = bolt::cl::async::transform( myControl, input.begin( ), input.end( ),
+        output.begin( ), bolt::cl::negate< int >( ), std::vector< ::cl::Event >( 1, sum.event( ) ) );
+    done.wait( );
+
+    EXPECT_TRUE( sum.ready( ) );
+    EXPECT_EQ( std::accumulate( stdInput.begin( ), stdInput.end( ), 0 ), sum.get( ) );
+
+    std::transform( stdInput.begin( ), stdInput.end( ), stdInput.begin( ), std::negate< int >( ) );
+    cmpArrays( stdInput, output );
+}
+
+TEST_F( AsyncTest, HostRangesCompleteBeforeReturn )
+{
+    std::vector< int > output( length );
+
+    bolt::cl::async::future< void > done = bolt::cl::async::transform( myControl, stdInput.begin( ),
+        stdInput.end( ), output.begin( ), bolt::cl::negate< int >( ) );
+
+    //  The result was mapped back to host memory inside the call
+    for( int i = 0; i < length; ++i )
+        EXPECT_EQ( -stdInput[ i ], output[ i ] );
+    done.wait( );
+}
+
+TEST_F( AsyncTest, NoWaitModeDefersSynchronousCalls )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+
+    myControl.setWaitMode( bolt::cl::control::NoWait );
+    bolt::cl::sort( myControl, input.begin( ), input.end( ) );
+    bolt::cl::wait( myControl );
+
+    //  Mapping the vector is ordered after the sort by the queue
+    std::sort( stdInput.begin( ), stdInput.end( ) );
+    cmpArrays( stdInput, input );
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
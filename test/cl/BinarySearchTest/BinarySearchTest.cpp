@@ -323,6 +323,88 @@ TEST(BSearch, MultiCore_DevclLong)
 
 }
 
+//  Batch searches: every value gets the answer std::lower_bound, std::upper_bound or std::binary_search gives it
+void checkSearchBatch( bolt::cl::control& ctl, int length, int valueCount )
+{
+        std::vector<int> source(length);
+        std::vector<int> values(valueCount);
+        for (int j = 0; j < length; j++)
+            source[j] = rand() % (length + 1);
+        for (int j = 0; j < valueCount; j++)
+            values[j] = rand() % (length + 3) - 1;
+        std::sort(source.begin(), source.end());
+
+        std::vector<int> lower(valueCount), upper(valueCount), found(valueCount);
+        bolt::cl::lower_bound(ctl, source.begin(), source.end(), values.begin(), values.end(), lower.begin());
+        bolt::cl::upper_bound(ctl, source.begin(), source.end(), values.begin(), values.end(), upper.begin());
+        std::vector<int>::iterator end = bolt::cl::binary_search(ctl, source.begin(), source.end(), values.begin(),
+            values.end(), found.begin(), bolt::cl::less<int>());
+        EXPECT_EQ( found.end(), end );
+
+        for (int j = 0; j < valueCount; j++)
+        {
+            EXPECT_EQ( std::lower_bound(source.begin(), source.end(), values[j]) - source.begin(), lower[j] );
+            EXPECT_EQ( std::upper_bound(source.begin(), source.end(), values[j]) - source.begin(), upper[j] );
+            EXPECT_EQ( std::binary_search(source.begin(), source.end(), values[j]) ? 1 : 0, found[j] );
+        }
+}
+
+TEST(BSearchBatch, RunModes)
+{
+        bolt::cl::control::e_RunMode modes[] = { bolt::cl::control::OpenCL, bolt::cl::control::SerialCpu,
+#if defined( ENABLE_TBB )
+            bolt::cl::control::MultiCoreCpu,
+#endif
+        };
+
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+        {
+            bolt::cl::control ctl = bolt::cl::control::getDefault( );
+            ctl.setForceRunMode(modes[m]);
+
+            checkSearchBatch(ctl, 0, 17);
+            checkSearchBatch(ctl, 1, 17);
+            checkSearchBatch(ctl, 1000, 3001);
+        }
+}
+
+#if defined( ENABLE_TBB )
+//  Enough values against a long enough haystack that the multicore path searches an Eytzinger copy of it
+TEST(BSearchBatch, MultiCoreEytzinger)
+{
+        bolt::cl::control ctl = bolt::cl::control::getDefault( );
+        ctl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
+
+        checkSearchBatch(ctl, 1<<17, 1<<15);
+}
+#endif
+
+TEST(BSearchBatch, DeviceVectorGreater)
+{
+        int length = 4096;
+        std::vector<float> std_source(length);
+        std::vector<float> std_values(length / 2);
+        for (int j = 0; j < length; j++)
+            std_source[j] = (float)(rand() % 1000);
+        for (int j = 0; j < length / 2; j++)
+            std_values[j] = (float)(rand() % 1100);
+        std::sort(std_source.begin(), std_source.end(), std::greater<float>());
+
+        bolt::cl::device_vector<float> source(std_source.begin(), std_source.end());
+        bolt::cl::device_vector<float> values(std_values.begin(), std_values.end());
+        bolt::cl::device_vector<cl_uint> result(length / 2);
+
+        bolt::cl::lower_bound(source.begin(), source.end(), values.begin(), values.end(), result.begin(),
+            bolt::cl::greater<float>());
+
+        for (int j = 0; j < length / 2; j++)
+        {
+            cl_uint expected = static_cast<cl_uint>(std::lower_bound(std_source.begin(), std_source.end(),
+                std_values[j], std::greater<float>()) - std_source.begin());
+            EXPECT_EQ( expected, result[j] );
+        }
+}
+
 TEST(BSearchUDD, AddDouble4)
 {
     //setup containers
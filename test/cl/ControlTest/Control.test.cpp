@@ -19,11 +19,17 @@
 
 #include <vector>
 #include <array>
+#include <numeric>
 
 #include "bolt/cl/control.h"
 #include "bolt/cl/functional.h"
 #include "bolt/cl/device_vector.h"
 #include "bolt/cl/scan.h"
+#include "bolt/cl/reduce.h"
+
+#if defined( ENABLE_TBB )
+#include "bolt/btbb/arena.h"
+#endif
 
 #include "bolt/unicode.h"
 #include "bolt/miniDump.h"
@@ -194,7 +200,7 @@ TEST_F( ReferenceControlTest, zeroMemory )
     myControl.acquireBuffer( 100 * sizeof( int ) );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 
     myControl.freeBuffers( );
     internalBuffSize = myControl.totalBufferSize( );
@@ -208,7 +214,7 @@ TEST_F( ReferenceControlTest, acquire1Buffer )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( ReferenceControlTest, acquire1BufferReleaseAcquireSame )
@@ -223,7 +229,7 @@ TEST_F( ReferenceControlTest, acquire1BufferReleaseAcquireSame )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( ReferenceControlTest, acquire1BufferReleaseAcquireSmaller )
@@ -238,7 +244,7 @@ TEST_F( ReferenceControlTest, acquire1BufferReleaseAcquireSmaller )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( ReferenceControlTest, acquire1BufferReleaseAcquireBigger )
@@ -253,7 +259,7 @@ TEST_F( ReferenceControlTest, acquire1BufferReleaseAcquireBigger )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 404, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 101 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( ReferenceControlTest, acquire2BufferEqual )
@@ -267,7 +273,7 @@ TEST_F( ReferenceControlTest, acquire2BufferEqual )
     EXPECT_EQ( 1, myRefCount2 );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 800, internalBuffSize );
+    EXPECT_EQ( 2 * bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( ReferenceControlTest, acquire2BufferBigger )
@@ -281,7 +287,8 @@ TEST_F( ReferenceControlTest, acquire2BufferBigger )
     EXPECT_EQ( 1, myRefCount2 );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 804, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ) + bolt::cl::control::bufferSizeClass( 101 * sizeof( int ) ),
+        internalBuffSize );
 }
 
 TEST_F( ReferenceControlTest, acquire2BufferSmaller )
@@ -295,7 +302,8 @@ TEST_F( ReferenceControlTest, acquire2BufferSmaller )
     EXPECT_EQ( 1, myRefCount2 );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 796, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ) + bolt::cl::control::bufferSizeClass( 99 * sizeof( int ) ),
+        internalBuffSize );
 }
 
 TEST_F( CopyControlTest, init )
@@ -310,7 +318,7 @@ TEST_F( CopyControlTest, zeroMemory )
     myControl.acquireBuffer( 100 * sizeof( int ) );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 
     myControl.freeBuffers( );
     internalBuffSize = myControl.totalBufferSize( );
@@ -324,7 +332,7 @@ TEST_F( CopyControlTest, acquire1Buffer )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( CopyControlTest, acquire1BufferReleaseAcquireSame )
@@ -339,7 +347,7 @@ TEST_F( CopyControlTest, acquire1BufferReleaseAcquireSame )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( CopyControlTest, acquire1BufferReleaseAcquireSmaller )
@@ -354,7 +362,7 @@ TEST_F( CopyControlTest, acquire1BufferReleaseAcquireSmaller )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 400, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( CopyControlTest, acquire1BufferReleaseAcquireBigger )
@@ -369,7 +377,7 @@ TEST_F( CopyControlTest, acquire1BufferReleaseAcquireBigger )
     EXPECT_EQ( 1, myRefCount );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 404, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 101 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( CopyControlTest, acquire2BufferEqual )
@@ -383,7 +391,7 @@ TEST_F( CopyControlTest, acquire2BufferEqual )
     EXPECT_EQ( 1, myRefCount2 );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 800, internalBuffSize );
+    EXPECT_EQ( 2 * bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), internalBuffSize );
 }
 
 TEST_F( CopyControlTest, acquire2BufferBigger )
@@ -397,7 +405,8 @@ TEST_F( CopyControlTest, acquire2BufferBigger )
     EXPECT_EQ( 1, myRefCount2 );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 804, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ) + bolt::cl::control::bufferSizeClass( 101 * sizeof( int ) ),
+        internalBuffSize );
 }
 
 TEST_F( CopyControlTest, acquire2BufferSmaller )
@@ -411,7 +420,8 @@ TEST_F( CopyControlTest, acquire2BufferSmaller )
     EXPECT_EQ( 1, myRefCount2 );
 
     size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 796, internalBuffSize );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ) + bolt::cl::control::bufferSizeClass( 99 * sizeof( int ) ),
+        internalBuffSize );
 }
 
 TEST_F( CopyControlTest, ScanIntegerVector )
@@ -424,13 +434,295 @@ TEST_F( CopyControlTest, ScanIntegerVector )
 
     bolt::cl::inclusive_scan( myControl, boltInput1.begin( ), boltInput1.end( ), boltInput1.begin( ) );
     cmpArrays( stdInput, boltInput1 );
+    size_t internalBuffSize = myControl.totalBufferSize( );
 
+    //  The second scan of the same size must be served entirely from the pool
     bolt::cl::inclusive_scan( myControl, boltInput2.begin( ), boltInput2.end( ), boltInput2.begin( ) );
     cmpArrays( stdInput, boltInput2 );
 
-    size_t internalBuffSize = myControl.totalBufferSize( );
-    EXPECT_EQ( 2049, internalBuffSize );
+    EXPECT_EQ( internalBuffSize, myControl.totalBufferSize( ) );
+}
+
+TEST( BufferPool, sizeClasses )
+{
+    EXPECT_EQ( 256, bolt::cl::control::bufferSizeClass( 1 ) );
+    EXPECT_EQ( 256, bolt::cl::control::bufferSizeClass( 256 ) );
+    EXPECT_EQ( 320, bolt::cl::control::bufferSizeClass( 257 ) );
+    EXPECT_EQ( 448, bolt::cl::control::bufferSizeClass( 400 ) );
+    EXPECT_EQ( 1024, bolt::cl::control::bufferSizeClass( 1024 ) );
+    EXPECT_EQ( 1280, bolt::cl::control::bufferSizeClass( 1025 ) );
+}
+
+TEST_F( CopyControlTest, poolStatistics )
+{
+    bolt::cl::control::buffPointer myBuff = myControl.acquireBuffer( 100 * sizeof( int ) );
+    myBuff.reset( );
+    myBuff = myControl.acquireBuffer( 99 * sizeof( int ) );
+
+    bolt::cl::control::bufferPoolStats stats = myControl.getBufferPoolStats( );
+    EXPECT_EQ( 1, stats.hits );
+    EXPECT_EQ( 1, stats.misses );
+    EXPECT_EQ( 0, stats.evictions );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), stats.peakSize );
+}
+
+TEST_F( CopyControlTest, bestFitSkipsOversizedBuffer )
+{
+    bolt::cl::control::buffPointer myBuff = myControl.acquireBuffer( 1024 * sizeof( int ) );
+    myBuff.reset( );
+
+    //  An idle buffer sixteen times too big is left for a larger request
+    myBuff = myControl.acquireBuffer( 64 * sizeof( int ) );
+
+    bolt::cl::control::bufferPoolStats stats = myControl.getBufferPoolStats( );
+    EXPECT_EQ( 0, stats.hits );
+    EXPECT_EQ( 2, stats.misses );
+}
+
+TEST_F( CopyControlTest, highWaterMarkTrimsIdleBuffers )
+{
+    size_t classSize = bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) );
+    myControl.setBufferHighWaterMark( classSize );
+
+    bolt::cl::control::buffPointer myBuff1 = myControl.acquireBuffer( 100 * sizeof( int ) );
+    bolt::cl::control::buffPointer myBuff2 = myControl.acquireBuffer( 100 * sizeof( int ) );
+
+    //  Both buffers are in use, so the pool has to go over the mark
+    EXPECT_EQ( 2 * classSize, myControl.totalBufferSize( ) );
+
+    myBuff1.reset( );
+    EXPECT_EQ( classSize, myControl.totalBufferSize( ) );
+    EXPECT_EQ( 1, myControl.getBufferPoolStats( ).evictions );
+}
+
+TEST_F( CopyControlTest, trimBuffers )
+{
+    bolt::cl::control::buffPointer myBuff1 = myControl.acquireBuffer( 100 * sizeof( int ) );
+    bolt::cl::control::buffPointer myBuff2 = myControl.acquireBuffer( 1000 * sizeof( int ) );
+    myBuff2.reset( );
+
+    myControl.trimBuffers( );
+    EXPECT_EQ( bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), myControl.totalBufferSize( ) );
+}
+
+TEST_F( CopyControlTest, prewarmBuffers )
+{
+    myControl.prewarmBuffers( 100 * sizeof( int ), 2 );
+    EXPECT_EQ( 2 * bolt::cl::control::bufferSizeClass( 100 * sizeof( int ) ), myControl.totalBufferSize( ) );
+
+    bolt::cl::control::buffPointer myBuff1 = myControl.acquireBuffer( 100 * sizeof( int ) );
+    bolt::cl::control::buffPointer myBuff2 = myControl.acquireBuffer( 100 * sizeof( int ) );
+
+    bolt::cl::control::bufferPoolStats stats = myControl.getBufferPoolStats( );
+    EXPECT_EQ( 2, stats.hits );
+    EXPECT_EQ( 2, stats.misses );
+}
+
+TEST_F( CopyControlTest, hostPointerBuffersAreNotPooled )
+{
+    std::vector< int > hostData( 100, 1 );
+    bolt::cl::control::buffPointer myBuff = myControl.acquireBuffer( 100 * sizeof( int ),
+        CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, &hostData[ 0 ] );
+    myBuff.reset( );
+
+    EXPECT_EQ( 0, myControl.totalBufferSize( ) );
+}
+
+TEST_F( CopyControlTest, copyHostPointerFillsPooledBuffer )
+{
+    std::vector< int > hostData( 100, 7 );
+    bolt::cl::control::buffPointer myBuff = myControl.acquireBuffer( 100 * sizeof( int ),
+        CL_MEM_COPY_HOST_PTR | CL_MEM_READ_WRITE, &hostData[ 0 ] );
+
+    std::vector< int > readBack( 100, 0 );
+    myControl.getCommandQueue( ).enqueueReadBuffer( *myBuff, CL_TRUE, 0, 100 * sizeof( int ), &readBack[ 0 ] );
+    EXPECT_EQ( hostData, readBack );
+}
+
+struct functorState
+{
+    int scale;
+    int offset;
+};
+
+TEST_F( CopyControlTest, statelessFunctorsShareOneBuffer )
+{
+    bolt::cl::control::buffPointer myFunctor1 = myControl.acquireFunctorBuffer( bolt::cl::plus< int >( ) );
+    bolt::cl::control::buffPointer myFunctor2 = myControl.acquireFunctorBuffer( bolt::cl::plus< int >( ) );
+
+    EXPECT_EQ( (*myFunctor1)( ), (*myFunctor2)( ) );
+    EXPECT_EQ( 0, myControl.totalBufferSize( ) );
+}
+
+TEST_F( CopyControlTest, statefulFunctorIsUploaded )
+{
+    functorState myState = { 3, 7 };
+    bolt::cl::control::buffPointer myFunctor = myControl.acquireFunctorBuffer( myState );
+
+    functorState readBack = { 0, 0 };
+    myControl.getCommandQueue( ).enqueueReadBuffer( *myFunctor, CL_TRUE, 0, sizeof( readBack ), &readBack );
+    EXPECT_EQ( 3, readBack.scale );
+    EXPECT_EQ( 7, readBack.offset );
+}
+
+TEST_F( CopyControlTest, functorRingIsReused )
+{
+    std::vector< cl_mem > seen;
+    for( size_t i = 0; i < 2 * bolt::cl::control::functorSlotCount; ++i )
+    {
+        functorState myState = { static_cast< int >( i ), 0 };
+        bolt::cl::control::buffPointer myFunctor = myControl.acquireFunctorBuffer( myState );
+        seen.push_back( (*myFunctor)( ) );
+    }
+
+    //  Once round the ring, the same memory objects come back; nothing was added to the buffer pool
+    for( size_t i = 0; i < bolt::cl::control::functorSlotCount; ++i )
+        EXPECT_EQ( seen[ i ], seen[ i + bolt::cl::control::functorSlotCount ] );
+    EXPECT_EQ( 0, myControl.totalBufferSize( ) );
+}
+
+TEST_F( CopyControlTest, heldFunctorSlotIsSkipped )
+{
+    functorState myState = { 1, 2 };
+    bolt::cl::control::buffPointer myHeld = myControl.acquireFunctorBuffer( myState );
+
+    for( size_t i = 0; i < 2 * bolt::cl::control::functorSlotCount; ++i )
+    {
+        bolt::cl::control::buffPointer myFunctor = myControl.acquireFunctorBuffer( myState );
+        EXPECT_NE( (*myHeld)( ), (*myFunctor)( ) );
+    }
+}
+
+TEST_F( CopyControlTest, sharingControlUsesTheSamePool )
+{
+    bolt::cl::control::buffPointer myBuff = myControl.acquireBuffer( 100 * sizeof( int ) );
+    myBuff.reset( );
+
+    {
+        bolt::cl::control myShared( myControl, bolt::cl::control::NoWait );
+        EXPECT_EQ( bolt::cl::control::NoWait, myShared.getWaitMode( ) );
+        EXPECT_NE( bolt::cl::control::NoWait, myControl.getWaitMode( ) );
+
+        myBuff = myShared.acquireBuffer( 100 * sizeof( int ) );
+    }
+
+    //  The buffer came from myControl's pool, and is still good after the control that acquired it is gone
+    EXPECT_EQ( 1, myControl.getBufferPoolStats( ).hits );
+    std::vector< int > hostData( 100, 5 ), readBack( 100, 0 );
+    myControl.getCommandQueue( ).enqueueWriteBuffer( *myBuff, CL_TRUE, 0, 100 * sizeof( int ), &hostData[ 0 ] );
+    myControl.getCommandQueue( ).enqueueReadBuffer( *myBuff, CL_TRUE, 0, 100 * sizeof( int ), &readBack[ 0 ] );
+    EXPECT_EQ( hostData, readBack );
+}
+
+TEST_F( CopyControlTest, zeroCopyTransferMapsHostRange )
+{
+    myControl.setForceRunMode( bolt::cl::control::OpenCL );
+    myControl.setHostTransfer( bolt::cl::control::ZeroCopyTransfer );
+
+    std::vector< int > input( 10000, 1 );
+    EXPECT_EQ( 10000, bolt::cl::reduce( myControl, input.begin( ), input.end( ), 0, bolt::cl::plus< int >( ) ) );
+
+    bolt::cl::control::hostTransferStats stats = myControl.getHostTransferStats( );
+    EXPECT_EQ( input.size( ) * sizeof( int ), stats.bytesMapped );
+    EXPECT_EQ( 0, stats.bytesCopied );
+}
+
+TEST_F( CopyControlTest, stagedTransferRoundTrips )
+{
+    myControl.setForceRunMode( bolt::cl::control::OpenCL );
+    myControl.setHostTransfer( bolt::cl::control::StagedTransfer );
+    myControl.setStagingChunkSize( 4096 );
+
+    //  Spans several chunks, so the ring wraps in both directions
+    std::vector< int > input( 10000 ), expected( 10000 );
+    for( size_t i = 0; i < input.size( ); ++i )
+        input[ i ] = rand( ) % 100;
+    std::partial_sum( input.begin( ), input.end( ), expected.begin( ) );
+
+    bolt::cl::inclusive_scan( myControl, input.begin( ), input.end( ), input.begin( ), bolt::cl::plus< int >( ) );
+    EXPECT_EQ( expected, input );
+
+    bolt::cl::control::hostTransferStats stats = myControl.getHostTransferStats( );
+    EXPECT_EQ( 0, stats.bytesMapped );
+    EXPECT_LE( 2 * input.size( ) * sizeof( int ), stats.bytesCopied );
+    EXPECT_LE( 2 * ( ( input.size( ) * sizeof( int ) + 4095 ) / 4096 ), stats.stagedChunks );
+
+    myControl.resetHostTransferStats( );
+    EXPECT_EQ( 0, myControl.getHostTransferStats( ).bytesCopied );
+}
+
+TEST_F( CopyControlTest, stagedDataIsUploadedAgain )
+{
+    myControl.setHostTransfer( bolt::cl::control::StagedTransfer );
+
+    std::vector< int > host( 1000, 1 );
+    bolt::cl::device_vector< int > staged( host.begin( ), host.size( ), CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE,
+        true, myControl );
+    {
+        bolt::cl::device_vector< int >::pointer myData = staged.data( );
+        myData[ 0 ] = 5;
+    }
+
+    //  The write went to the host range, and reaches the device before the next read
+    EXPECT_EQ( 5, host[ 0 ] );
+    EXPECT_EQ( 5, staged[ 0 ] );
+}
+
+TEST_F( CopyControlTest, autoTransferStagesUnalignedRange )
+{
+    myControl.setHostTransfer( bolt::cl::control::AutoTransfer );
+
+    std::vector< char > host( 3 * 4096 );
+    char* aligned = &host[ 0 ] + ( 4096 - reinterpret_cast< size_t >( &host[ 0 ] ) % 4096 ) % 4096;
+    EXPECT_TRUE( myControl.zeroCopyHostRange( aligned ) );
+    EXPECT_FALSE( myControl.zeroCopyHostRange( aligned + 4 ) );
+
+    myControl.setHostTransfer( bolt::cl::control::ZeroCopyTransfer );
+    EXPECT_TRUE( myControl.zeroCopyHostRange( aligned + 4 ) );
+}
+
+TEST( MultiCore, settingsRevision )
+{
+    size_t revision = bolt::cl::control::getMultiCoreRevision( );
+
+    bolt::cl::control::setMultiCoreThreads( 2 );
+    EXPECT_EQ( revision + 1, bolt::cl::control::getMultiCoreRevision( ) );
+
+    //  Setting the same value again leaves the arena alone
+    bolt::cl::control::setMultiCoreThreads( 2 );
+    EXPECT_EQ( revision + 1, bolt::cl::control::getMultiCoreRevision( ) );
+
+    std::vector< int > processors( 1, 0 );
+    bolt::cl::control::setMultiCoreAffinity( processors );
+    bolt::cl::control::multiCoreSettings settings = bolt::cl::control::getMultiCoreSettings( );
+    EXPECT_EQ( 2, settings.threads );
+    EXPECT_EQ( processors, settings.affinity );
+    EXPECT_EQ( revision + 2, settings.revision );
+
+    bolt::cl::control::setMultiCoreThreads( 0 );
+    bolt::cl::control::setMultiCoreAffinity( std::vector< int >( ) );
+}
+
+#if defined( ENABLE_TBB )
+TEST( MultiCore, arenaHonorsThreadCount )
+{
+    bolt::cl::control::setMultiCoreThreads( 2 );
+
+    int concurrency = 0;
+    bolt::btbb::execute( [ & ]( ) { concurrency = tbb::this_task_arena::max_concurrency( ); } );
+    EXPECT_EQ( 2, concurrency );
+
+    //  Calls on the MultiCoreCpu path run in the smaller arena and still get the right answer
+    bolt::cl::control myControl( bolt::cl::control::getDefault( ) );
+    myControl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+    std::vector< int > input( 100000, 1 );
+    EXPECT_EQ( 100000, bolt::cl::reduce( myControl, input.begin( ), input.end( ), 0, bolt::cl::plus< int >( ) ) );
+
+    bolt::cl::control::setMultiCoreThreads( 0 );
+    bolt::btbb::execute( [ & ]( ) { concurrency = tbb::this_task_arena::max_concurrency( ); } );
+    EXPECT_LE( 1, concurrency );
 }
+#endif
 
 int _tmain(int argc, _TCHAR* argv[])
 {
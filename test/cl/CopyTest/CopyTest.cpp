@@ -3256,6 +3256,49 @@ TEST (copyStructOdd, BufferTestHostToDevice)
 
 }
 
+//  The element count is taken in full, not as a 32 bit int, on every run mode
+static void copyLargeRange( size_t length, bolt::cl::control::e_RunMode runMode )
+{
+    std::vector< cl_char > input( length, 0 );
+    std::vector< cl_char > output( length, 0 );
+    size_t marks[ ] = { 0, ( size_t( 1 ) << 31 ) - 1, size_t( 1 ) << 31, ( size_t( 1 ) << 32 ) - 1, size_t( 1 ) << 32,
+        length - 1 };
+    for( size_t m = 0; m < sizeof( marks ) / sizeof( marks[ 0 ] ); ++m )
+    {
+        if( marks[ m ] < length )
+            input[ marks[ m ] ] = 1;
+    }
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( runMode );
+    bolt::cl::copy( ctl, input.begin( ), input.end( ), output.begin( ) );
+
+    for( size_t m = 0; m < sizeof( marks ) / sizeof( marks[ 0 ] ); ++m )
+    {
+        if( marks[ m ] < length )
+            EXPECT_EQ( 1, output[ marks[ m ] ] ) << "at " << marks[ m ];
+    }
+    EXPECT_EQ( 0, output[ 1 ] );
+}
+
+TEST( CopyLargeRange, PastInt32 )
+{
+    copyLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    copyLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    copyLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::OpenCL );
+}
+
+TEST( CopyLargeRange, PastUInt32 )
+{
+    copyLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    copyLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    copyLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::OpenCL );
+}
+
 int main(int argc, char* argv[])
 {
     //  Register our minidump generating logic
@@ -1160,6 +1160,45 @@ TEST (sanity_count_if_testCountIfIntWithStdVector3, EPR400650_400651){
 	EXPECT_EQ (stdCount, boltCount);
 }
 
+//  The OpenCL path counts a host range this long a slice at a time
+static void countLargeRange( size_t length, bolt::cl::control::e_RunMode runMode )
+{
+    std::vector< cl_char > input( length, 0 );
+    size_t marks[ ] = { 0, ( size_t( 1 ) << 31 ) - 1, size_t( 1 ) << 31, ( size_t( 1 ) << 32 ) - 1, size_t( 1 ) << 32,
+        length - 1 };
+    int expected = 0;
+    for( size_t m = 0; m < sizeof( marks ) / sizeof( marks[ 0 ] ); ++m )
+    {
+        if( marks[ m ] < length && input[ marks[ m ] ] == 0 )
+        {
+            input[ marks[ m ] ] = 1;
+            ++expected;
+        }
+    }
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( runMode );
+    EXPECT_EQ( expected, bolt::cl::count( ctl, input.begin( ), input.end( ), 1 ) );
+}
+
+TEST( CountLargeRange, PastInt32 )
+{
+    countLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    countLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    countLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::OpenCL );
+}
+
+TEST( CountLargeRange, PastUInt32 )
+{
+    countLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    countLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    countLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::OpenCL );
+}
+
 int main(int argc, char* argv[])
 {
     ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
@@ -38,6 +38,8 @@
     #include "bolt/cl/functional.h"
     #include "bolt/cl/device_vector.h"
     #include "bolt/cl/fill.h"
+    #include "bolt/cl/sort.h"
+    #include "bolt/cl/device_span.h"
     #include "common/test_common.h"
     #define BCKND cl
 
@@ -712,6 +714,103 @@ TEST( Vector, DataWrite )
     EXPECT_EQ( 5, mySP[ 4 ] );
 }
 
+TEST( Vector, MappedViewReadWrite )
+{
+    bolt::cl::device_vector< int > dV( 1024ul, 0 );
+
+    {
+        bolt::cl::device_vector< int >::mapped_view view( dV, CL_MAP_WRITE_INVALIDATE_REGION );
+        EXPECT_EQ( 1024, view.size( ) );
+        std::iota( view.begin( ), view.end( ), 0 );
+
+        //  References of the container go through the open view
+        dV[ 3 ] = 42;
+        EXPECT_EQ( 42, view[ 3 ] );
+        EXPECT_EQ( 5, dV[ 5 ] );
+    }
+
+    const bolt::cl::device_vector< int >& cdV = dV;
+    bolt::cl::device_vector< int >::const_mapped_view view( cdV );
+    EXPECT_EQ( 42, view[ 3 ] );
+    EXPECT_EQ( 1023, *( view.end( ) - 1 ) );
+    EXPECT_EQ( 7, cdV[ 7 ] );
+}
+
+TEST( Vector, InsertEraseMiddle )
+{
+    std::vector< int > stdV( 1000 );
+    std::iota( stdV.begin( ), stdV.end( ), 0 );
+    bolt::cl::device_vector< int > dV( stdV.begin( ), stdV.end( ), CL_MEM_READ_WRITE );
+
+    //  Shifts that overlap the old tail and shifts that do not
+    stdV.insert( stdV.begin( ) + 10, 3, -1 );
+    dV.insert( dV.cbegin( ) + 10, 3, -1 );
+    stdV.insert( stdV.begin( ) + 1, 2000, 7 );
+    dV.insert( dV.cbegin( ) + 1, 2000, 7 );
+    stdV.insert( stdV.begin( ) + 500, -2 );
+    dV.insert( dV.cbegin( ) + 500, -2 );
+    stdV.erase( stdV.begin( ) + 20, stdV.begin( ) + 25 );
+    dV.erase( dV.cbegin( ) + 20, dV.cbegin( ) + 25 );
+    stdV.erase( stdV.begin( ) + 2, stdV.begin( ) + 2002 );
+    dV.erase( dV.cbegin( ) + 2, dV.cbegin( ) + 2002 );
+    stdV.erase( stdV.begin( ) );
+    dV.erase( dV.cbegin( ) );
+
+    cmpArrays( stdV, dV );
+}
+
+TEST( DeviceSpan, SortAlignedSubRange )
+{
+    std::vector< int > stdV( 8192 );
+    for( size_t i = 0; i < stdV.size( ); ++i )
+        stdV[ i ] = rand( );
+    bolt::cl::device_vector< int > dV( stdV.begin( ), stdV.end( ), CL_MEM_READ_WRITE );
+
+    //  4096 bytes in, which every device accepts as a sub-buffer origin
+    bolt::cl::device_span< int > span( dV, 1024, 4096 );
+    EXPECT_TRUE( span.isSubBuffer( ) );
+    EXPECT_EQ( 4096, span.size( ) );
+
+    bolt::cl::sort( span.begin( ), span.end( ) );
+    std::sort( stdV.begin( ) + 1024, stdV.begin( ) + 5120 );
+
+    cmpArrays( stdV, dV );
+}
+
+TEST( DeviceSpan, FillUnalignedSubRange )
+{
+    bolt::cl::device_vector< int > dV( 1000ul, 1 );
+    std::vector< int > stdV( 1000, 1 );
+
+    bolt::cl::device_span< int > span( dV.begin( ) + 3, dV.end( ) - 5 );
+    EXPECT_FALSE( span.isSubBuffer( ) );
+    EXPECT_EQ( 992, span.size( ) );
+
+    bolt::cl::fill( span.begin( ), span.end( ), 7 );
+    std::fill( stdV.begin( ) + 3, stdV.end( ) - 5, 7 );
+
+    cmpArrays( stdV, dV );
+}
+
+TEST( DeviceSpan, InteropSubspan )
+{
+    std::vector< int > stdV( 2048 );
+    std::iota( stdV.begin( ), stdV.end( ), 0 );
+    bolt::cl::device_vector< int > dV( stdV.begin( ), stdV.end( ), CL_MEM_READ_WRITE );
+
+    bolt::cl::device_span< int > span( dV.getBuffer( )( ), 1024, 1024 );
+    bolt::cl::device_span< int > inner = span.subspan( 10, 20 );
+    EXPECT_EQ( 1034, inner.getOffset( ) );
+    EXPECT_EQ( 20, inner.size( ) );
+    EXPECT_EQ( 1034, inner[ 0 ] );
+    EXPECT_EQ( 1053, *( inner.end( ) - 1 ) );
+
+    //  A span of a sub-buffer counts its offset from the sub-buffer
+    bolt::cl::device_span< int > nested( span.getBuffer( ), 10, 20 );
+    EXPECT_EQ( 1034, nested.getOffset( ) );
+    EXPECT_EQ( 1034, nested[ 0 ] );
+}
+
 TEST( Vector, wdSpecifyingSize )
 {
     size_t mySize = 10;
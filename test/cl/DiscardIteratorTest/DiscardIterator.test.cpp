@@ -0,0 +1,164 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "bolt/cl/iterator/discard_iterator.h"
+#include "bolt/cl/reduce_by_key.h"
+#include "bolt/cl/sort_by_key.h"
+#include "bolt/cl/stablesort_by_key.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+class DiscardIteratorTest: public testing::TestWithParam< bolt::cl::control::e_RunMode >
+{
+public:
+    DiscardIteratorTest( ): myControl( bolt::cl::control::getDefault( ) ), length( 1 << 16 )
+    {}
+
+    virtual void SetUp( )
+    {
+        myControl.setForceRunMode( GetParam( ) );
+
+        stdKeys.resize( length );
+        stdValues.resize( length );
+        for( int i = 0; i < length; ++i )
+        {
+            stdKeys[ i ] = i / 7;
+            stdValues[ i ] = rand( ) % 100 - 50;
+        }
+
+        //  Sum of every run of equal keys
+        for( int i = 0; i < length; ++i )
+        {
+            if( i == 0 || stdKeys[ i ] != stdKeys[ i - 1 ] )
+                stdSums.push_back( 0 );
+            stdSums.back( ) += stdValues[ i ];
+        }
+    };
+
+protected:
+    bolt::cl::control myControl;
+    int length;
+    std::vector< int > stdKeys;
+    std::vector< int > stdValues;
+    std::vector< int > stdSums;
+};
+
+TEST( DiscardIteratorTypes, HostOperations )
+{
+    bolt::cl::discard_iterator first = bolt::cl::make_discard_iterator( );
+    bolt::cl::discard_iterator last = first + 10;
+
+    *first = 5;
+    first[ 3 ] = 2.5f;
+    EXPECT_EQ( 10, last - first );
+    EXPECT_TRUE( ++first != last );
+    EXPECT_EQ( "bolt::cl::discard_iterator", TypeName< bolt::cl::discard_iterator >::get( ) );
+}
+
+TEST_P( DiscardIteratorTest, ReduceByKeyDeviceValues )
+{
+    bolt::cl::device_vector< int > keys( stdKeys.begin( ), stdKeys.end( ) );
+    bolt::cl::device_vector< int > values( stdValues.begin( ), stdValues.end( ) );
+    bolt::cl::device_vector< int > sums( length );
+
+    bolt::cl::pair< bolt::cl::discard_iterator, bolt::cl::device_vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key( myControl, keys.begin( ), keys.end( ), values.begin( ),
+            bolt::cl::make_discard_iterator( ), sums.begin( ) );
+
+    int segments = static_cast< int >( stdSums.size( ) );
+    EXPECT_EQ( segments, ends.first - bolt::cl::make_discard_iterator( ) );
+    EXPECT_EQ( segments, ends.second - sums.begin( ) );
+    for( int i = 0; i < segments; ++i )
+    {
+        int sum = sums[ i ];
+        EXPECT_EQ( stdSums[ i ], sum );
+    }
+}
+
+TEST_P( DiscardIteratorTest, ReduceByKeyHostValues )
+{
+    std::vector< int > sums( length );
+
+    bolt::cl::pair< bolt::cl::discard_iterator, std::vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key( myControl, stdKeys.begin( ), stdKeys.end( ), stdValues.begin( ),
+            bolt::cl::make_discard_iterator( ), sums.begin( ) );
+
+    int segments = static_cast< int >( stdSums.size( ) );
+    EXPECT_EQ( segments, ends.second - sums.begin( ) );
+    sums.resize( segments );
+    cmpArrays( stdSums, sums );
+}
+
+TEST_P( DiscardIteratorTest, SortByKeyDiscardedValues )
+{
+    std::random_shuffle( stdValues.begin( ), stdValues.end( ) );
+    bolt::cl::device_vector< int > keys( stdValues.begin( ), stdValues.end( ) );
+
+    bolt::cl::sort_by_key( myControl, keys.begin( ), keys.end( ), bolt::cl::make_discard_iterator( ) );
+
+    std::sort( stdValues.begin( ), stdValues.end( ) );
+    cmpArrays( stdValues, keys );
+}
+
+TEST_P( DiscardIteratorTest, SortByKeyHostKeysDiscardedValues )
+{
+    std::vector< int > keys( stdValues.begin( ), stdValues.end( ) );
+    std::random_shuffle( keys.begin( ), keys.end( ) );
+
+    bolt::cl::sort_by_key( myControl, keys.begin( ), keys.end( ), bolt::cl::make_discard_iterator( ),
+        bolt::cl::greater< int >( ) );
+
+    std::sort( stdValues.begin( ), stdValues.end( ), std::greater< int >( ) );
+    cmpArrays( stdValues, keys );
+}
+
+TEST_P( DiscardIteratorTest, StableSortByKeyDiscardedValues )
+{
+    std::random_shuffle( stdValues.begin( ), stdValues.end( ) );
+    bolt::cl::device_vector< int > keys( stdValues.begin( ), stdValues.end( ) );
+
+    bolt::cl::stable_sort_by_key( myControl, keys.begin( ), keys.end( ), bolt::cl::make_discard_iterator( ) );
+
+    std::sort( stdValues.begin( ), stdValues.end( ) );
+    cmpArrays( stdValues, keys );
+}
+
+INSTANTIATE_TEST_CASE_P( RunModes, DiscardIteratorTest, ::testing::Values( bolt::cl::control::OpenCL,
+    bolt::cl::control::MultiCoreCpu, bolt::cl::control::SerialCpu ) );
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
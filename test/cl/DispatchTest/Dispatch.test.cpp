@@ -0,0 +1,212 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <cstdio>
+
+#include <boost/thread.hpp>
+
+#include "bolt/cl/dispatch.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+
+#include "bolt/unicode.h"
+
+#include <gtest/gtest.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  The models are fed by hand so that every test knows exactly what the dispatcher has seen
+
+class DispatchTest: public testing::Test
+{
+public:
+    DispatchTest( ): myControl( bolt::cl::control::getDefault( ) )
+    {}
+
+    virtual void SetUp( )
+    {
+        bolt::cl::resetDispatchModel( );
+        bolt::cl::setTransferCost( myControl, 0.0 );
+        myControl.setForceRunMode( bolt::cl::control::Automatic );
+    };
+
+    virtual void TearDown( )
+    {
+        bolt::cl::resetDispatchModel( );
+        bolt::cl::setDispatchExplorationLimit( 1 << 20 );
+    };
+
+    //  The first sample of every path is treated as warm-up and dropped
+    void record( const std::string& key, bolt::cl::control::e_RunMode mode, double fixed, double perElement )
+    {
+        bolt::cl::recordDispatchTime( myControl, key, mode, 1000, 0, 1.0 );
+        bolt::cl::recordDispatchTime( myControl, key, mode, 1000, 0, fixed + perElement * 1000 );
+        bolt::cl::recordDispatchTime( myControl, key, mode, 100000, 0, fixed + perElement * 100000 );
+    }
+
+    //  Serial wins small calls, the CPU cores win medium calls, and the device wins large calls
+    void recordThreePaths( const std::string& key )
+    {
+        record( key, bolt::cl::control::SerialCpu, 0.0, 1.0e-8 );
+        record( key, bolt::cl::control::MultiCoreCpu, 1.0e-5, 2.5e-9 );
+        record( key, bolt::cl::control::OpenCL, 1.0e-4, 1.0e-10 );
+    }
+
+protected:
+    bolt::cl::control myControl;
+};
+
+TEST_F( DispatchTest, ForcedModeIsNotOverridden )
+{
+    myControl.setForceRunMode( bolt::cl::control::SerialCpu );
+    bolt::cl::detail::AutomaticRunMode automatic( myControl, "forced", 1000, 0, 0 );
+
+    EXPECT_EQ( bolt::cl::control::SerialCpu, automatic.get( ) );
+}
+
+TEST_F( DispatchTest, UnmeasuredPathsAreExploredFirst )
+{
+    std::vector< int > chosen( 4, 0 );
+    for( int i = 0; i < 9; ++i )
+    {
+        bolt::cl::control::e_RunMode mode = bolt::cl::selectRunMode( myControl, "explore", 1000, 0, 0, true );
+        ++chosen[ mode ];
+        bolt::cl::recordDispatchTime( myControl, "explore", mode, 1000 + i, 0, 1.0e-3 );
+    }
+
+    //  One warm-up and two measured calls per path
+    EXPECT_EQ( 3, chosen[ bolt::cl::control::SerialCpu ] );
+    EXPECT_EQ( 3, chosen[ bolt::cl::control::MultiCoreCpu ] );
+    EXPECT_EQ( 3, chosen[ bolt::cl::control::OpenCL ] );
+}
+
+TEST_F( DispatchTest, MultiCoreIsSkippedWhenNotBuilt )
+{
+    for( int i = 0; i < 6; ++i )
+    {
+        bolt::cl::control::e_RunMode mode = bolt::cl::selectRunMode( myControl, "noTbb", 1000, 0, 0, false );
+        EXPECT_NE( bolt::cl::control::MultiCoreCpu, mode );
+        bolt::cl::recordDispatchTime( myControl, "noTbb", mode, 1000 + i, 0, 1.0e-3 );
+    }
+}
+
+TEST_F( DispatchTest, LargeUnmeasuredCallUsesDefaultPath )
+{
+    bolt::cl::setDispatchExplorationLimit( 1000 );
+
+    EXPECT_EQ( myControl.getDefaultPathToRun( ),
+        bolt::cl::selectRunMode( myControl, "large", 1000000, 0, 0, true ) );
+}
+
+TEST_F( DispatchTest, PicksCheapestPath )
+{
+    recordThreePaths( "cheapest" );
+
+    EXPECT_EQ( bolt::cl::control::SerialCpu, bolt::cl::selectRunMode( myControl, "cheapest", 100, 0, 0, true ) );
+    EXPECT_EQ( bolt::cl::control::MultiCoreCpu,
+        bolt::cl::selectRunMode( myControl, "cheapest", 10000, 0, 0, true ) );
+    EXPECT_EQ( bolt::cl::control::OpenCL,
+        bolt::cl::selectRunMode( myControl, "cheapest", 10000000, 0, 0, true ) );
+}
+
+TEST_F( DispatchTest, HostDataCountsAgainstOpenCL )
+{
+    recordThreePaths( "transfer" );
+    bolt::cl::setTransferCost( myControl, 1.0e-9 );
+
+    //  Copying 40MB each way costs more than the device saves
+    EXPECT_EQ( bolt::cl::control::MultiCoreCpu,
+        bolt::cl::selectRunMode( myControl, "transfer", 10000000, 80000000, 0, true ) );
+
+    //  The same call on a device_vector stays on the device
+    EXPECT_EQ( bolt::cl::control::OpenCL,
+        bolt::cl::selectRunMode( myControl, "transfer", 10000000, 0, 80000000, true ) );
+}
+
+TEST_F( DispatchTest, SaveAndLoadRoundTrip )
+{
+    recordThreePaths( "roundTrip" );
+    double predicted = bolt::cl::predictDispatchTime( myControl, "roundTrip", bolt::cl::control::OpenCL, 5000, 0 );
+    ASSERT_LT( 0.0, predicted );
+
+    const std::string fileName = "boltDispatchTest.model";
+    ASSERT_TRUE( bolt::cl::saveDispatchModel( fileName ) );
+
+    bolt::cl::resetDispatchModel( );
+    EXPECT_GT( 0.0, bolt::cl::predictDispatchTime( myControl, "roundTrip", bolt::cl::control::OpenCL, 5000, 0 ) );
+
+    ASSERT_TRUE( bolt::cl::loadDispatchModel( fileName ) );
+    EXPECT_DOUBLE_EQ( predicted,
+        bolt::cl::predictDispatchTime( myControl, "roundTrip", bolt::cl::control::OpenCL, 5000, 0 ) );
+
+    std::remove( fileName.c_str( ) );
+}
+
+TEST_F( DispatchTest, AutomaticReduceLearns )
+{
+    std::vector< int > input( 4096, 1 );
+    for( int i = 0; i < 12; ++i )
+        EXPECT_EQ( 4096, bolt::cl::reduce( myControl, input.begin( ), input.end( ), 0, bolt::cl::plus< int >( ) ) );
+
+    //  Every path has been tried and measured by now
+    std::string key = bolt::cl::detail::dispatchKey< int >( "reduce" );
+    EXPECT_LE( 0.0, bolt::cl::predictDispatchTime( myControl, key, bolt::cl::control::SerialCpu, 4096, 0 ) );
+    EXPECT_LE( 0.0, bolt::cl::predictDispatchTime( myControl, key, bolt::cl::control::OpenCL, 4096, 0 ) );
+}
+
+TEST_F( DispatchTest, NoWaitCallIsTimedOnCompletion )
+{
+    //  Holds the queue up, standing in for kernels that are still running when a NoWait call returns
+    cl_int l_Error = CL_SUCCESS;
+    ::cl::UserEvent gate( myControl.getContext( ), &l_Error );
+    ASSERT_EQ( CL_SUCCESS, l_Error );
+    std::vector< ::cl::Event > gateList( 1, gate );
+    myControl.getCommandQueue( ).enqueueBarrierWithWaitList( &gateList );
+
+    double start = bolt::cl::dispatchClock( );
+    bolt::cl::recordDispatchTimeOnCompletion( myControl, "noWait", bolt::cl::control::OpenCL, 1000, 0, start );
+    bolt::cl::recordDispatchTimeOnCompletion( myControl, "noWait", bolt::cl::control::OpenCL, 1000, 0, start );
+    EXPECT_GT( 0.0, bolt::cl::predictDispatchTime( myControl, "noWait", bolt::cl::control::OpenCL, 1000, 0 ) );
+
+    boost::this_thread::sleep( boost::posix_time::milliseconds( 50 ) );
+    gate.setStatus( CL_COMPLETE );
+    myControl.getCommandQueue( ).finish( );
+
+    //  The callbacks may run a little after the queue drains
+    double predicted = -1.0;
+    for( int i = 0; i < 100 && predicted < 0.0; ++i )
+    {
+        boost::this_thread::sleep( boost::posix_time::milliseconds( 10 ) );
+        predicted = bolt::cl::predictDispatchTime( myControl, "noWait", bolt::cl::control::OpenCL, 1000, 0 );
+    }
+    EXPECT_LE( 0.05, predicted );
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
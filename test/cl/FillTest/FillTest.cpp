@@ -2479,6 +2479,42 @@ TEST(Fill, AllRunModes)
 
 }
 
+//  Past 2^31 elements the OpenCL path fills a slice at a time; the marks sit on either side of each boundary
+static void fillLargeRange( size_t length, bolt::cl::control::e_RunMode runMode )
+{
+    std::vector< cl_char > output( length, 0 );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( runMode );
+    bolt::cl::fill( ctl, output.begin( ), output.end( ), 1 );
+
+    size_t marks[ ] = { 0, ( size_t( 1 ) << 31 ) - 1, size_t( 1 ) << 31, ( size_t( 1 ) << 32 ) - 1, size_t( 1 ) << 32,
+        length - 1 };
+    for( size_t m = 0; m < sizeof( marks ) / sizeof( marks[ 0 ] ); ++m )
+    {
+        if( marks[ m ] < length )
+            EXPECT_EQ( 1, output[ marks[ m ] ] ) << "at " << marks[ m ];
+    }
+}
+
+TEST( FillLargeRange, PastInt32 )
+{
+    fillLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    fillLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    fillLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::OpenCL );
+}
+
+TEST( FillLargeRange, PastUInt32 )
+{
+    fillLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    fillLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    fillLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::OpenCL );
+}
+
 
 int main(int argc, char **argv)
 {
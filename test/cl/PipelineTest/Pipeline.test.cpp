@@ -0,0 +1,197 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "bolt/cl/pipeline.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+BOLT_FUNCTOR( halfOf,
+struct halfOf
+{
+    float operator( )( const int& x ) const
+    {
+        return x * 0.5f;
+    }
+};
+);
+
+BOLT_FUNCTOR( plusOne,
+struct plusOne
+{
+    float operator( )( const float& x ) const
+    {
+        return x + 1.0f;
+    }
+};
+);
+
+class PipelineTest: public testing::TestWithParam< bolt::cl::control::e_RunMode >
+{
+public:
+    PipelineTest( ): myControl( bolt::cl::control::getDefault( ) ), length( 1 << 16 )
+    {}
+
+    virtual void SetUp( )
+    {
+        myControl.setForceRunMode( GetParam( ) );
+
+        stdInput.resize( length );
+        for( int i = 0; i < length; ++i )
+            stdInput[ i ] = rand( ) % 100 - 50;
+    };
+
+protected:
+    bolt::cl::control myControl;
+    int length;
+    std::vector< int > stdInput;
+};
+
+TEST( PipelineTypes, CompositionNamesItsParts )
+{
+    typedef bolt::cl::unary_compose< bolt::cl::negate< int >, bolt::cl::square< int >, int, int > composed;
+
+    EXPECT_EQ( "bolt::cl::unary_compose< bolt::cl::negate< cl_int >, bolt::cl::square< cl_int >, cl_int, cl_int >",
+        TypeName< composed >::get( ) );
+    EXPECT_NE( std::string::npos, ClCode< composed >::get( ).find( "struct unary_compose" ) );
+}
+
+TEST( PipelineTypes, SharedCodeIsGuarded )
+{
+    typedef bolt::cl::unary_compose< bolt::cl::negate< int >, bolt::cl::negate< int >, int, int > twice;
+
+    //  Both parts bring the same template string; the guard defines it once
+    std::string code = ClCode< twice >::get( );
+    std::string guard = code.substr( code.find( "BOLT_CODE_" ), code.find( " )" ) - code.find( "BOLT_CODE_" ) );
+    size_t first = code.find( "#define " + guard );
+    EXPECT_NE( std::string::npos, first );
+    EXPECT_EQ( std::string::npos, code.find( "#define " + guard, first + 1 ) );
+    EXPECT_NE( std::string::npos, code.find( "#if !defined( " + guard, first ) );
+}
+
+TEST( PipelineTypes, FirstTransformReplacesIdentity )
+{
+    std::vector< int > input( 4, 2 );
+    bolt::cl::pipeline< std::vector< int >::iterator, bolt::cl::square< int > > squared =
+        bolt::cl::make_pipeline( input.begin( ), input.end( ) ).transform( bolt::cl::square< int >( ) );
+
+    EXPECT_EQ( 4, squared.functor( )( 2 ) );
+    EXPECT_EQ( -4, squared.transform( bolt::cl::negate< int >( ) ).functor( )( 2 ) );
+}
+
+TEST_P( PipelineTest, TransformTransformReduce )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+
+    int sum = bolt::cl::make_pipeline( input.begin( ), input.end( ) )
+        .transform( bolt::cl::square< int >( ) )
+        .transform( bolt::cl::negate< int >( ) )
+        .reduce( myControl, 0, bolt::cl::plus< int >( ) );
+
+    int expected = 0;
+    for( int i = 0; i < length; ++i )
+        expected -= stdInput[ i ] * stdInput[ i ];
+    EXPECT_EQ( expected, sum );
+}
+
+TEST_P( PipelineTest, ChangesTypeAlongTheChain )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+    bolt::cl::device_vector< float > output( length );
+
+    bolt::cl::device_vector< float >::iterator end = bolt::cl::make_pipeline( input.begin( ), input.end( ) )
+        .transform( halfOf( ) )
+        .transform( plusOne( ) )
+        .transform( bolt::cl::negate< float >( ) )
+        .copy( myControl, output.begin( ) );
+    EXPECT_EQ( length, end - output.begin( ) );
+
+    std::vector< float > expected( length );
+    for( int i = 0; i < length; ++i )
+        expected[ i ] = -( stdInput[ i ] * 0.5f + 1.0f );
+    cmpArrays( expected, output );
+}
+
+TEST_P( PipelineTest, InclusiveScan )
+{
+    std::vector< int > output( length );
+
+    bolt::cl::make_pipeline( stdInput.begin( ), stdInput.end( ) )
+        .transform( bolt::cl::negate< int >( ) )
+        .transform( bolt::cl::square< int >( ) )
+        .inclusive_scan( myControl, output.begin( ), bolt::cl::plus< int >( ) );
+
+    std::vector< int > expected( length );
+    std::transform( stdInput.begin( ), stdInput.end( ), expected.begin( ), std::negate< int >( ) );
+    std::transform( expected.begin( ), expected.end( ), expected.begin( ), expected.begin( ), std::multiplies< int >( ) );
+    std::partial_sum( expected.begin( ), expected.end( ), expected.begin( ) );
+    cmpArrays( expected, output );
+}
+
+TEST_P( PipelineTest, ExclusiveScan )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+    bolt::cl::device_vector< int > output( length );
+
+    bolt::cl::make_pipeline( input.begin( ), input.end( ) )
+        .transform( bolt::cl::square< int >( ) )
+        .transform( bolt::cl::negate< int >( ) )
+        .exclusive_scan( myControl, output.begin( ), 5, bolt::cl::plus< int >( ) );
+
+    std::vector< int > expected( length );
+    int running = 5;
+    for( int i = 0; i < length; ++i )
+    {
+        expected[ i ] = running;
+        running -= stdInput[ i ] * stdInput[ i ];
+    }
+    cmpArrays( expected, output );
+}
+
+TEST_P( PipelineTest, WithoutTransformsCopies )
+{
+    bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+    bolt::cl::device_vector< int > output( length );
+
+    bolt::cl::make_pipeline( input.begin( ), input.end( ) ).copy( myControl, output.begin( ) );
+    cmpArrays( stdInput, output );
+}
+
+INSTANTIATE_TEST_CASE_P( RunModes, PipelineTest, ::testing::Values( bolt::cl::control::OpenCL,
+    bolt::cl::control::MultiCoreCpu, bolt::cl::control::SerialCpu ) );
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
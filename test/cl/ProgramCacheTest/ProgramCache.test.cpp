@@ -0,0 +1,247 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <sstream>
+#include <ctime>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+
+#include "bolt/unicode.h"
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Every test compiles with a private -D so that it never finds its program in the in-memory map, or on
+//  disk, left behind by an earlier test or an earlier run
+
+class ProgramCacheTest: public testing::Test
+{
+public:
+    ProgramCacheTest( ): myControl( bolt::cl::control::getDefault( ) ), input( 1024, 1 )
+    {}
+
+    virtual void SetUp( )
+    {
+        static int testId = 0;
+        std::ostringstream options;
+        options << " -DBOLT_PROGRAM_CACHE_TEST=" << std::time( NULL ) << ++testId;
+        std::string compileOptions = options.str( );
+        myControl.setCompileOptions( compileOptions );
+        myControl.setForceRunMode( bolt::cl::control::OpenCL );
+
+        bolt::cl::setProgramCacheDirectory( "boltProgramCacheTest" );
+        bolt::cl::setProgramCacheMaxSize( 256 * 1024 * 1024 );
+        bolt::cl::resetProgramCacheStats( );
+    };
+
+    virtual void TearDown( )
+    {
+        bolt::cl::setProgramCacheDirectory( "" );
+    };
+
+    //  Drops every program compiled in this process, so the next lookup has to go to disk
+    void forgetPrograms( )
+    {
+        bolt::cl::clearProgramMap( );
+    }
+
+    int runReduce( )
+    {
+        return bolt::cl::reduce( myControl, input.begin( ), input.end( ), 0, bolt::cl::plus< int >( ) );
+    }
+
+protected:
+    bolt::cl::control myControl;
+    std::vector< int > input;
+};
+
+//  A kernel with no template to specialize, for tests that take kernels from the pool directly
+class AddOne_KernelTemplateSpecializer: public bolt::cl::KernelTemplateSpecializer
+{
+public:
+    AddOne_KernelTemplateSpecializer( )
+    {
+        addKernelName( "addOne" );
+    }
+
+    const std::string operator( )( const std::vector< std::string >& ) const
+    {
+        return "";
+    }
+};
+
+const std::string addOneKernels =
+    "__kernel void addOneInstantiated( __global int* data )\n"
+    "{\n"
+    "    data[ get_global_id( 0 ) ] += 1;\n"
+    "}\n";
+
+TEST_F( ProgramCacheTest, DisabledWithoutDirectory )
+{
+    bolt::cl::setProgramCacheDirectory( "" );
+
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 0, stats.hits );
+    EXPECT_EQ( 0, stats.misses );
+    EXPECT_EQ( 0, stats.stores );
+}
+
+TEST_F( ProgramCacheTest, MissStoresBinary )
+{
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 0, stats.hits );
+    EXPECT_EQ( 1, stats.misses );
+    EXPECT_EQ( 1, stats.stores );
+}
+
+TEST_F( ProgramCacheTest, HitAfterProgramMapCleared )
+{
+    EXPECT_EQ( 1024, runReduce( ) );
+    forgetPrograms( );
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 1, stats.hits );
+    EXPECT_EQ( 1, stats.misses );
+    EXPECT_EQ( 1, stats.stores );
+    EXPECT_EQ( 0, stats.rejects );
+}
+
+TEST_F( ProgramCacheTest, InMemoryHitSkipsDisk )
+{
+    EXPECT_EQ( 1024, runReduce( ) );
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 0, stats.hits );
+    EXPECT_EQ( 1, stats.misses );
+}
+
+TEST_F( ProgramCacheTest, SizeLimitEvicts )
+{
+    bolt::cl::setProgramCacheMaxSize( 1 );
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 1, stats.stores );
+    EXPECT_LE( 1, stats.evictions );
+
+    //  The binary we just wrote is gone, so a fresh lookup has to compile again
+    forgetPrograms( );
+    EXPECT_EQ( 1024, runReduce( ) );
+    stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 0, stats.hits );
+    EXPECT_EQ( 2, stats.misses );
+}
+
+TEST_F( ProgramCacheTest, FastPathSeesCompileOptions )
+{
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    //  Same call site, different options; the kernel lookup fast path must not hand back the first program
+    std::string compileOptions = myControl.getCompileOptions( ) + " -DBOLT_PROGRAM_CACHE_SECOND";
+    myControl.setCompileOptions( compileOptions );
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 2, stats.misses );
+}
+
+TEST_F( ProgramCacheTest, FullLookupMatchesFastPath )
+{
+    EXPECT_EQ( 1024, runReduce( ) );
+
+    myControl.setDebugMode( bolt::cl::control::debug::NoKernelCache );
+    EXPECT_EQ( 1024, runReduce( ) );
+    myControl.setDebugMode( bolt::cl::control::debug::None );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 1, stats.misses );
+}
+
+TEST_F( ProgramCacheTest, SteadyStateCreatesNoKernels )
+{
+    EXPECT_EQ( 1024, runReduce( ) );
+    size_t created = bolt::cl::getKernelCreationCount( );
+
+    for( int i = 0; i < 10; ++i )
+        EXPECT_EQ( 1024, runReduce( ) );
+
+    EXPECT_EQ( created, bolt::cl::getKernelCreationCount( ) );
+}
+
+TEST_F( ProgramCacheTest, HeldKernelsAreNotHandedOut )
+{
+    AddOne_KernelTemplateSpecializer kts;
+    std::vector< std::string > none;
+
+    bolt::cl::PooledKernels held = bolt::cl::getKernels( myControl, none, &kts, none, addOneKernels );
+    {
+        bolt::cl::PooledKernels nested = bolt::cl::getKernels( myControl, none, &kts, none, addOneKernels );
+        EXPECT_NE( held[ 0 ]( ), nested[ 0 ]( ) );
+    }
+
+    //  The nested instance is idle again and is handed out next; the held one is not
+    size_t created = bolt::cl::getKernelCreationCount( );
+    bolt::cl::PooledKernels again = bolt::cl::getKernels( myControl, none, &kts, none, addOneKernels );
+    EXPECT_NE( held[ 0 ]( ), again[ 0 ]( ) );
+    EXPECT_EQ( created, bolt::cl::getKernelCreationCount( ) );
+}
+
+TEST_F( ProgramCacheTest, ConcurrentCallersShareOneBuild )
+{
+    const int threadCount = 8;
+    std::vector< int > results( threadCount, 0 );
+
+    boost::thread_group threads;
+    for( int i = 0; i < threadCount; ++i )
+    {
+        threads.create_thread( [ &, i ]( ) { results[ i ] = runReduce( ); } );
+    }
+    threads.join_all( );
+
+    for( int i = 0; i < threadCount; ++i )
+        EXPECT_EQ( 1024, results[ i ] );
+
+    bolt::cl::ProgramCacheStats stats = bolt::cl::getProgramCacheStats( );
+    EXPECT_EQ( 1, stats.misses + stats.hits );
+    EXPECT_EQ( 0, bolt::cl::programBuildsInProgress( ) );
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
@@ -1733,6 +1733,46 @@ TEST(ReduceAuto, Reduce386717)
   EXPECT_EQ(stlAccumulate, boltClReduce);
 }
 
+//  Ranges just past 2^31 and 2^32 elements, where a 32 bit count goes wrong; a char per element keeps them at 2 and
+//  4 GB.  A few ones sit on either side of each boundary.
+static void reduceLargeRange( size_t length, bolt::cl::control::e_RunMode runMode )
+{
+    std::vector< cl_char > input( length, 0 );
+    size_t marks[ ] = { 0, ( size_t( 1 ) << 31 ) - 1, size_t( 1 ) << 31, ( size_t( 1 ) << 32 ) - 1, size_t( 1 ) << 32,
+        length - 1 };
+    int expected = 0;
+    for( size_t m = 0; m < sizeof( marks ) / sizeof( marks[ 0 ] ); ++m )
+    {
+        if( marks[ m ] < length && input[ marks[ m ] ] == 0 )
+        {
+            input[ marks[ m ] ] = 1;
+            ++expected;
+        }
+    }
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( runMode );
+    EXPECT_EQ( expected, bolt::cl::reduce( ctl, input.begin( ), input.end( ), 0, bolt::cl::plus< int >( ) ) );
+}
+
+TEST( ReduceLargeRange, PastInt32 )
+{
+    reduceLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    reduceLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    reduceLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::OpenCL );
+}
+
+TEST( ReduceLargeRange, PastUInt32 )
+{
+    reduceLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    reduceLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    reduceLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::OpenCL );
+}
+
 
 
 #if 0
@@ -2818,6 +2818,52 @@ TEST(InclusiveScanByKey, IncMixedM3each)
 
 #endif
 
+//  Segments of random length, some shorter and some longer than a single pass tile, so that the look-back
+//  has to both stop at a segment start and reach across tiles
+TEST(ScanByKey, SinglePassMatchesMultiPass)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control multiPassCtl = bolt::cl::control::getDefault( );
+    multiPassCtl.setDebugMode( bolt::cl::control::debug::MultiPassScan );
+
+    int length = ( 1 << 20 ) + 7;
+    std::vector< int > keys( length );
+    std::vector< int > vals( length );
+    int key = 0;
+    for( int i = 0; i < length; )
+    {
+        int segmentLength = ( rand( ) % 4 == 0 ) ? rand( ) % 10000 + 1 : rand( ) % 20 + 1;
+        for( int j = 0; j < segmentLength && i < length; ++j, ++i )
+        {
+            keys[ i ] = key;
+            vals[ i ] = rand( ) % 10;
+        }
+        ++key;
+    }
+
+    bolt::cl::device_vector< int > dvKeys( keys.begin( ), keys.end( ) );
+    bolt::cl::device_vector< int > dvVals( vals.begin( ), vals.end( ) );
+    bolt::cl::device_vector< int > output( length );
+    bolt::cl::device_vector< int > multiPassOutput( length );
+    std::vector< int > refOutput( length );
+    bolt::cl::equal_to< int > eq;
+    bolt::cl::plus< int > plus;
+
+    bolt::cl::inclusive_scan_by_key( ctl, dvKeys.begin( ), dvKeys.end( ), dvVals.begin( ), output.begin( ), eq, plus );
+    bolt::cl::inclusive_scan_by_key( multiPassCtl, dvKeys.begin( ), dvKeys.end( ), dvVals.begin( ),
+        multiPassOutput.begin( ), eq, plus );
+    gold_scan_by_key( keys.begin( ), keys.end( ), vals.begin( ), refOutput.begin( ), plus );
+    cmpArrays( refOutput, output );
+    cmpArrays( refOutput, multiPassOutput );
+
+    bolt::cl::exclusive_scan_by_key( ctl, dvKeys.begin( ), dvKeys.end( ), dvVals.begin( ), output.begin( ), 3, eq, plus );
+    bolt::cl::exclusive_scan_by_key( multiPassCtl, dvKeys.begin( ), dvKeys.end( ), dvVals.begin( ),
+        multiPassOutput.begin( ), 3, eq, plus );
+    gold_scan_by_key_exclusive( keys.begin( ), keys.end( ), vals.begin( ), refOutput.begin( ), plus, 3 );
+    cmpArrays( refOutput, output );
+    cmpArrays( refOutput, multiPassOutput );
+}
+
 TEST( equalValMult, iValues )
 {
     int keys[11] = { 7, 0, 0, 3, 3, 3, -5, -5, -5, -5, 3 }; 
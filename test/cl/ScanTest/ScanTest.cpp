@@ -794,6 +794,89 @@ TEST(InclusiveScan, MulticoreInclUdd)
 } 
 
 
+/******************************************************************************
+ *  Single pass scan; sizes straddle the tile boundaries, and every result is
+ *  checked against the three kernel path as well as std::partial_sum
+ *****************************************************************************/
+static const int singlePassLengths[ ] = { 1, 255, 256, 2047, 2048, 2049, 6007, ( 1 << 20 ) + 7 };
+
+TEST(InclusiveScan, SinglePassMatchesMultiPass)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control multiPassCtl = bolt::cl::control::getDefault( );
+    multiPassCtl.setDebugMode( bolt::cl::control::debug::MultiPassScan );
+
+    for( size_t l = 0; l < sizeof( singlePassLengths ) / sizeof( singlePassLengths[ 0 ] ); ++l )
+    {
+        int length = singlePassLengths[ l ];
+        std::vector< int > refInput( length );
+        for( int i = 0; i < length; i++ )
+            refInput[ i ] = rand( ) % 10;
+
+        bolt::cl::device_vector< int > input( refInput.begin( ), refInput.end( ) );
+        bolt::cl::device_vector< int > output( length );
+        bolt::cl::device_vector< int > multiPassOutput( length );
+
+        bolt::cl::inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ) );
+        bolt::cl::inclusive_scan( multiPassCtl, input.begin( ), input.end( ), multiPassOutput.begin( ) );
+        ::std::partial_sum( refInput.begin( ), refInput.end( ), refInput.begin( ) );
+
+        cmpArrays( refInput, output );
+        cmpArrays( refInput, multiPassOutput );
+    }
+}
+
+TEST(ExclusiveScan, SinglePassMatchesMultiPass)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control multiPassCtl = bolt::cl::control::getDefault( );
+    multiPassCtl.setDebugMode( bolt::cl::control::debug::MultiPassScan );
+
+    for( size_t l = 0; l < sizeof( singlePassLengths ) / sizeof( singlePassLengths[ 0 ] ); ++l )
+    {
+        int length = singlePassLengths[ l ];
+        std::vector< int > stdInput( length );
+        std::vector< int > refOutput( length );
+        for( int i = 0; i < length; i++ )
+            stdInput[ i ] = rand( ) % 10;
+
+        //  init followed by the running sum, excluding the current element
+        refOutput[ 0 ] = 7;
+        for( int i = 1; i < length; i++ )
+            refOutput[ i ] = refOutput[ i - 1 ] + stdInput[ i - 1 ];
+
+        bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+        bolt::cl::device_vector< int > output( length );
+        bolt::cl::device_vector< int > multiPassOutput( length );
+
+        bolt::cl::exclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ), 7 );
+        bolt::cl::exclusive_scan( multiPassCtl, input.begin( ), input.end( ), multiPassOutput.begin( ), 7 );
+
+        cmpArrays( refOutput, output );
+        cmpArrays( refOutput, multiPassOutput );
+    }
+}
+
+TEST(InclusiveScan, SinglePassUdd)
+{
+    //  An 8 byte type, so tile sums cross between work groups as two words
+    bolt::cl::control multiPassCtl = bolt::cl::control::getDefault( );
+    multiPassCtl.setDebugMode( bolt::cl::control::debug::MultiPassScan );
+
+    int length = ( 1 << 18 ) + 3;
+    std::vector< uddtI2 > refInput( length, initialAddI2 );
+    bolt::cl::device_vector< uddtI2 > input( refInput.begin( ), refInput.end( ) );
+    bolt::cl::device_vector< uddtI2 > multiPassInput( refInput.begin( ), refInput.end( ) );
+
+    AddI2 ai2;
+    bolt::cl::inclusive_scan( input.begin( ), input.end( ), input.begin( ), ai2 );
+    bolt::cl::inclusive_scan( multiPassCtl, multiPassInput.begin( ), multiPassInput.end( ), multiPassInput.begin( ), ai2 );
+    ::std::partial_sum( refInput.begin( ), refInput.end( ), refInput.begin( ), ai2 );
+
+    cmpArrays( refInput, input );
+    cmpArrays( refInput, multiPassInput );
+}
+
 TEST(InclusiveScan, InclFloat)
 {
     //setup containers
@@ -3220,6 +3303,69 @@ TEST (sanity_exclusive_scan__simple_epr377210, withIntWiCtrl)
 } */
 
 
+//  Ranges just past 2^31 and 2^32 elements, where a 32 bit count goes wrong; a char per element keeps them at 2 and
+//  4 GB.  The scan counts the ones placed on either side of each boundary, and is checked around them.
+static void scanLargeRange( size_t length, bool inclusive, bolt::cl::control::e_RunMode runMode )
+{
+    std::vector< cl_char > input( length, 0 );
+    size_t marks[ ] = { 0, ( size_t( 1 ) << 30 ), ( size_t( 1 ) << 31 ) - 1, size_t( 1 ) << 31,
+        ( size_t( 1 ) << 32 ) - 1, size_t( 1 ) << 32, length - 1 };
+    const size_t markCount = sizeof( marks ) / sizeof( marks[ 0 ] );
+    for( size_t m = 0; m < markCount; ++m )
+    {
+        if( marks[ m ] < length )
+            input[ marks[ m ] ] = 1;
+    }
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( runMode );
+    std::vector< cl_char > output( length );
+    std::vector< cl_char >::iterator end;
+    if( inclusive )
+        end = bolt::cl::inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ),
+            bolt::cl::plus< cl_char >( ) );
+    else
+        end = bolt::cl::exclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ), cl_char( 0 ),
+            bolt::cl::plus< cl_char >( ) );
+    EXPECT_EQ( length, static_cast< size_t >( end - output.begin( ) ) );
+
+    for( size_t m = 0; m < markCount; ++m )
+    {
+        for( size_t i = ( marks[ m ] > 0 ) ? marks[ m ] - 1 : 0; i <= marks[ m ] + 1 && i < length; ++i )
+        {
+            int expected = 0;
+            for( size_t n = 0; n < markCount; ++n )
+            {
+                if( marks[ n ] < length && ( inclusive ? marks[ n ] <= i : marks[ n ] < i ) )
+                    ++expected;
+            }
+            EXPECT_EQ( expected, output[ i ] ) << "at element " << i;
+        }
+    }
+}
+
+TEST( ScanLargeRange, PastInt32 )
+{
+    scanLargeRange( ( size_t( 1 ) << 31 ) + 16, true, bolt::cl::control::SerialCpu );
+    scanLargeRange( ( size_t( 1 ) << 31 ) + 16, false, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    scanLargeRange( ( size_t( 1 ) << 31 ) + 16, true, bolt::cl::control::MultiCoreCpu );
+    scanLargeRange( ( size_t( 1 ) << 31 ) + 16, false, bolt::cl::control::MultiCoreCpu );
+#endif
+    scanLargeRange( ( size_t( 1 ) << 31 ) + 16, true, bolt::cl::control::OpenCL );
+    scanLargeRange( ( size_t( 1 ) << 31 ) + 16, false, bolt::cl::control::OpenCL );
+}
+
+TEST( ScanLargeRange, PastUInt32 )
+{
+    scanLargeRange( ( size_t( 1 ) << 32 ) + 16, true, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    scanLargeRange( ( size_t( 1 ) << 32 ) + 16, true, bolt::cl::control::MultiCoreCpu );
+#endif
+    scanLargeRange( ( size_t( 1 ) << 32 ) + 16, true, bolt::cl::control::OpenCL );
+    scanLargeRange( ( size_t( 1 ) << 32 ) + 16, false, bolt::cl::control::OpenCL );
+}
+
 /*
 // std::deque's iteartor is not allowed in the bolt'routines because 
 // unlike vectors, deques are not guaranteed to store all its elements in contiguous storage locations
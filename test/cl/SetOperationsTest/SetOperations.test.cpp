@@ -0,0 +1,259 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "bolt/cl/set_operations.h"
+#include "bolt/cl/merge_by_key.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+//  Lengths of both ranges around the work group and tile sizes, with the number of distinct keys; few keys make
+//  long runs of equal keys that cross the merge-path splits
+static const int lengths1[ ] = { 1, 0, 255, 2049, 1 << 16, ( 1 << 20 ) + 3 };
+static const int lengths2[ ] = { 1, 17, 257, 3, 1 << 16, 1 << 19 };
+static const int keyRanges[ ] = { 2, 10, 1000, 50, 4, 1 << 20 };
+static const int numLengths = sizeof( lengths1 ) / sizeof( lengths1[ 0 ] );
+
+class SetOperationsTest: public testing::TestWithParam< bolt::cl::control::e_RunMode >
+{
+public:
+    SetOperationsTest( ): myControl( bolt::cl::control::getDefault( ) )
+    {}
+
+    virtual void SetUp( )
+    {
+        myControl.setForceRunMode( GetParam( ) );
+    };
+
+    void fill( int test )
+    {
+        stdInput1.resize( lengths1[ test ] );
+        for( size_t i = 0; i < stdInput1.size( ); ++i )
+            stdInput1[ i ] = rand( ) % keyRanges[ test ];
+        std::sort( stdInput1.begin( ), stdInput1.end( ) );
+
+        stdInput2.resize( lengths2[ test ] );
+        for( size_t i = 0; i < stdInput2.size( ); ++i )
+            stdInput2[ i ] = rand( ) % keyRanges[ test ];
+        std::sort( stdInput2.begin( ), stdInput2.end( ) );
+    }
+
+protected:
+    bolt::cl::control myControl;
+    std::vector< int > stdInput1;
+    std::vector< int > stdInput2;
+};
+
+TEST_P( SetOperationsTest, UnionDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        bolt::cl::device_vector< int > input1( stdInput1.begin( ), stdInput1.end( ) );
+        bolt::cl::device_vector< int > input2( stdInput2.begin( ), stdInput2.end( ) );
+        bolt::cl::device_vector< int > output( stdInput1.size( ) + stdInput2.size( ) );
+
+        bolt::cl::device_vector< int >::iterator end = bolt::cl::set_union( myControl, input1.begin( ),
+            input1.end( ), input2.begin( ), input2.end( ), output.begin( ) );
+
+        std::vector< int > expected( output.size( ) );
+        expected.resize( std::set_union( stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ),
+            stdInput2.end( ), expected.begin( ) ) - expected.begin( ) );
+        EXPECT_EQ( expected.size( ), static_cast< size_t >( end - output.begin( ) ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( SetOperationsTest, IntersectionDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        bolt::cl::device_vector< int > input1( stdInput1.begin( ), stdInput1.end( ) );
+        bolt::cl::device_vector< int > input2( stdInput2.begin( ), stdInput2.end( ) );
+        bolt::cl::device_vector< int > output( stdInput1.size( ) + stdInput2.size( ) );
+
+        bolt::cl::device_vector< int >::iterator end = bolt::cl::set_intersection( myControl, input1.begin( ),
+            input1.end( ), input2.begin( ), input2.end( ), output.begin( ), bolt::cl::less< int >( ) );
+
+        std::vector< int > expected( output.size( ) );
+        expected.resize( std::set_intersection( stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ),
+            stdInput2.end( ), expected.begin( ) ) - expected.begin( ) );
+        EXPECT_EQ( expected.size( ), static_cast< size_t >( end - output.begin( ) ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( SetOperationsTest, DifferenceHost )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        std::vector< int > output( stdInput1.size( ) );
+
+        std::vector< int >::iterator end = bolt::cl::set_difference( myControl, stdInput1.begin( ),
+            stdInput1.end( ), stdInput2.begin( ), stdInput2.end( ), output.begin( ) );
+
+        std::vector< int > expected( output.size( ) );
+        expected.resize( std::set_difference( stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ),
+            stdInput2.end( ), expected.begin( ) ) - expected.begin( ) );
+        output.resize( end - output.begin( ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( SetOperationsTest, SymmetricDifferenceDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        bolt::cl::device_vector< int > input1( stdInput1.begin( ), stdInput1.end( ) );
+        bolt::cl::device_vector< int > input2( stdInput2.begin( ), stdInput2.end( ) );
+        bolt::cl::device_vector< int > output( stdInput1.size( ) + stdInput2.size( ) );
+
+        bolt::cl::device_vector< int >::iterator end = bolt::cl::set_symmetric_difference( myControl,
+            input1.begin( ), input1.end( ), input2.begin( ), input2.end( ), output.begin( ) );
+
+        std::vector< int > expected( output.size( ) );
+        expected.resize( std::set_symmetric_difference( stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ),
+            stdInput2.end( ), expected.begin( ) ) - expected.begin( ) );
+        EXPECT_EQ( expected.size( ), static_cast< size_t >( end - output.begin( ) ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( SetOperationsTest, UnionDescending )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+        std::reverse( stdInput1.begin( ), stdInput1.end( ) );
+        std::reverse( stdInput2.begin( ), stdInput2.end( ) );
+
+        std::vector< int > output( stdInput1.size( ) + stdInput2.size( ) );
+
+        std::vector< int >::iterator end = bolt::cl::set_union( myControl, stdInput1.begin( ), stdInput1.end( ),
+            stdInput2.begin( ), stdInput2.end( ), output.begin( ), bolt::cl::greater< int >( ) );
+
+        std::vector< int > expected( output.size( ) );
+        expected.resize( std::set_union( stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ),
+            stdInput2.end( ), expected.begin( ), std::greater< int >( ) ) - expected.begin( ) );
+        output.resize( end - output.begin( ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( SetOperationsTest, MergeByKeyDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+        size_t length = stdInput1.size( ) + stdInput2.size( );
+
+        //  Values tell which range and which position every key came from
+        std::vector< int > stdValues1( stdInput1.size( ) );
+        std::vector< int > stdValues2( stdInput2.size( ) );
+        for( size_t i = 0; i < stdValues1.size( ); ++i )
+            stdValues1[ i ] = static_cast< int >( i );
+        for( size_t i = 0; i < stdValues2.size( ); ++i )
+            stdValues2[ i ] = -1 - static_cast< int >( i );
+
+        bolt::cl::device_vector< int > keys1( stdInput1.begin( ), stdInput1.end( ) );
+        bolt::cl::device_vector< int > keys2( stdInput2.begin( ), stdInput2.end( ) );
+        bolt::cl::device_vector< int > values1( stdValues1.begin( ), stdValues1.end( ) );
+        bolt::cl::device_vector< int > values2( stdValues2.begin( ), stdValues2.end( ) );
+        bolt::cl::device_vector< int > keys( length );
+        bolt::cl::device_vector< int > values( length );
+
+        bolt::cl::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > ends =
+            bolt::cl::merge_by_key( myControl, keys1.begin( ), keys1.end( ), keys2.begin( ), keys2.end( ),
+                values1.begin( ), values2.begin( ), keys.begin( ), values.begin( ) );
+        EXPECT_EQ( length, static_cast< size_t >( ends.first - keys.begin( ) ) );
+        EXPECT_EQ( length, static_cast< size_t >( ends.second - values.begin( ) ) );
+
+        std::vector< int > expectedKeys( length );
+        std::vector< int > expectedValues( length );
+        size_t i = 0, j = 0;
+        for( size_t out = 0; out < length; ++out )
+        {
+            if( j == stdInput2.size( ) || ( i < stdInput1.size( ) && !( stdInput2[ j ] < stdInput1[ i ] ) ) )
+            {
+                expectedKeys[ out ] = stdInput1[ i ];
+                expectedValues[ out ] = stdValues1[ i++ ];
+            }
+            else
+            {
+                expectedKeys[ out ] = stdInput2[ j ];
+                expectedValues[ out ] = stdValues2[ j++ ];
+            }
+        }
+        cmpArrays( expectedKeys, keys );
+        cmpArrays( expectedValues, values );
+    }
+}
+
+TEST_P( SetOperationsTest, MergeByKeyHost )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+        size_t length = stdInput1.size( ) + stdInput2.size( );
+
+        std::vector< float > stdValues1( stdInput1.begin( ), stdInput1.end( ) );
+        std::vector< float > stdValues2( stdInput2.begin( ), stdInput2.end( ) );
+        std::vector< int > keys( length );
+        std::vector< float > values( length );
+
+        bolt::cl::merge_by_key( myControl, stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ),
+            stdInput2.end( ), stdValues1.begin( ), stdValues2.begin( ), keys.begin( ), values.begin( ),
+            bolt::cl::less< int >( ) );
+
+        std::vector< int > expected( length );
+        std::merge( stdInput1.begin( ), stdInput1.end( ), stdInput2.begin( ), stdInput2.end( ), expected.begin( ) );
+        cmpArrays( expected, keys );
+        for( size_t i = 0; i < length; ++i )
+            EXPECT_FLOAT_EQ( static_cast< float >( keys[ i ] ), values[ i ] );
+    }
+}
+
+INSTANTIATE_TEST_CASE_P( RunModes, SetOperationsTest, ::testing::Values( bolt::cl::control::OpenCL,
+    bolt::cl::control::MultiCoreCpu, bolt::cl::control::SerialCpu ) );
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
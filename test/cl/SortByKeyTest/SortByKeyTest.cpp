@@ -33,6 +33,9 @@
 #include "bolt/cl/iterator/counting_iterator.h"
 
 #include <bolt/cl/sort_by_key.h>
+#if defined( ENABLE_TBB )
+#include <bolt/btbb/scratch.h>
+#endif
 #include <bolt/miniDump.h>
 #include <bolt/unicode.h>
 
@@ -818,6 +821,47 @@ TEST( SortbyUDDKeyVectorTest2, Normal )
     }
 }
 
+#if defined( ENABLE_TBB )
+//  The MultiCoreCpu sort_by_key sorts keys and values where they lie, keeps equal keys in order, and holds no more
+//  scratch than one buffer of keys and one of values while it runs
+TEST( MultiCoreSortByKey, StableInPlace )
+{
+    const int length = 1 << 18;
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< int > keys( length );
+    std::vector< int > values( length );
+    for( int i = 0; i < length; ++i )
+    {
+        keys[ i ] = rand( ) % 1000 - 500;
+        values[ i ] = i;
+    }
+    std::vector< int > fallbackKeys( keys );
+    std::vector< int > fallbackValues( values );
+
+    bolt::btbb::resetScratchHighWater( );
+    bolt::cl::sort_by_key( ctl, keys.begin( ), keys.end( ), values.begin( ) );
+    EXPECT_GE( 2 * length * sizeof( int ), bolt::btbb::getScratchMemory( ).highWater );
+    EXPECT_EQ( 0u, bolt::btbb::getScratchMemory( ).current );
+
+    //  A comparator the radix sort cannot stand in for goes through sorted positions instead
+    bolt::cl::sort_by_key( ctl, fallbackKeys.begin( ), fallbackKeys.end( ), fallbackValues.begin( ),
+        bolt::cl::greater< int >( ) );
+
+    for( int i = 1; i < length; ++i )
+    {
+        EXPECT_LE( keys[ i - 1 ], keys[ i ] );
+        if( keys[ i - 1 ] == keys[ i ] )
+            EXPECT_LT( values[ i - 1 ], values[ i ] );
+
+        EXPECT_GE( fallbackKeys[ i - 1 ], fallbackKeys[ i ] );
+        if( fallbackKeys[ i - 1 ] == fallbackKeys[ i ] )
+            EXPECT_LT( fallbackValues[ i - 1 ], fallbackValues[ i ] );
+    }
+}
+#endif
+
 TEST_P( SortbyUDDDeviceKeyVector, Normal )
 {
 	AddD4 ad4gt;
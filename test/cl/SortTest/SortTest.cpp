@@ -2685,6 +2685,34 @@ TEST (rawArrayTest, floatarray){
 }
 
 
+//  The MultiCoreCpu path radix sorts arithmetic keys; the order must match less<> for signed, wide and floating keys
+TEST (MultiCoreRadixSort, signedAndFloatKeys){
+    const int sizeOfInputBuffer = 1 << 18;
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
+
+    std::vector<double> stdDouble(sizeOfInputBuffer);
+    std::vector<cl_long> stdLong(sizeOfInputBuffer);
+    for (int i = 0 ; i < sizeOfInputBuffer; i++){
+        stdDouble[i] = (double)(rand() - RAND_MAX/2) / (rand() + 1);
+        stdLong[i] = ((cl_long)(rand() - RAND_MAX/2) << 32) + rand();
+    }
+    stdDouble[7] = -0.0;
+    stdDouble[11] = 0.0;
+    std::vector<double> boltDouble(stdDouble);
+    std::vector<cl_long> boltLong(stdLong);
+
+    std::SORT_FUNC(stdDouble.begin(), stdDouble.end());
+    bolt::BKND::SORT_FUNC(ctl, boltDouble.begin(), boltDouble.end());
+    std::SORT_FUNC(stdLong.begin(), stdLong.end());
+    bolt::BKND::SORT_FUNC(ctl, boltLong.begin(), boltLong.end());
+
+    for (int i = 0 ; i < sizeOfInputBuffer; i++){
+        EXPECT_DOUBLE_EQ(stdDouble[i], boltDouble[i]);
+        EXPECT_EQ(stdLong[i], boltLong[i]);
+    }
+}
+
 class sort_withStdVectFloat_2: public ::testing::TestWithParam<int>{
 protected:
     int sizeOfInputBuffer;
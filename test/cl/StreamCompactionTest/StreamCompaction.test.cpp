@@ -0,0 +1,273 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "bolt/cl/copy.h"
+#include "bolt/cl/remove.h"
+#include "bolt/cl/unique.h"
+#include "bolt/cl/partition.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+BOLT_FUNCTOR( is_below,
+struct is_below
+{
+    is_below( int limit = 0 ): limit( limit )
+    {}
+
+    bool operator( )( const int &x ) const
+    {
+        return x < limit;
+    }
+
+    int limit;
+};
+);
+
+//  Lengths around the tile and chunk sizes, with the percentage of the elements the predicate selects
+static const int lengths[ ] = { 1, 255, 257, 1 << 16, ( 1 << 20 ) + 3 };
+static const int selectivities[ ] = { 50, 1, 99, 50, 10 };
+static const int numLengths = sizeof( lengths ) / sizeof( lengths[ 0 ] );
+
+class StreamCompactionTest: public testing::TestWithParam< bolt::cl::control::e_RunMode >
+{
+public:
+    StreamCompactionTest( ): myControl( bolt::cl::control::getDefault( ) )
+    {}
+
+    virtual void SetUp( )
+    {
+        myControl.setForceRunMode( GetParam( ) );
+    };
+
+    void fill( int test )
+    {
+        length = lengths[ test ];
+        pred = is_below( selectivities[ test ] );
+
+        stdInput.resize( length );
+        for( int i = 0; i < length; ++i )
+            stdInput[ i ] = rand( ) % 100;
+    }
+
+protected:
+    bolt::cl::control myControl;
+    int length;
+    is_below pred;
+    std::vector< int > stdInput;
+};
+
+TEST_P( StreamCompactionTest, CopyIfDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+        bolt::cl::device_vector< int > output( length );
+
+        bolt::cl::device_vector< int >::iterator end = bolt::cl::copy_if( myControl, input.begin( ), input.end( ),
+            output.begin( ), pred );
+
+        std::vector< int > expected( length );
+        expected.resize( std::copy_if( stdInput.begin( ), stdInput.end( ), expected.begin( ), pred )
+            - expected.begin( ) );
+        EXPECT_EQ( expected.size( ), static_cast< size_t >( end - output.begin( ) ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( StreamCompactionTest, CopyIfStencilHost )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        std::vector< int > stencil( stdInput.rbegin( ), stdInput.rend( ) );
+        std::vector< int > output( length );
+
+        std::vector< int >::iterator end = bolt::cl::copy_if( myControl, stdInput.begin( ), stdInput.end( ),
+            stencil.begin( ), output.begin( ), pred );
+
+        std::vector< int > expected;
+        for( int i = 0; i < length; ++i )
+        {
+            if( pred( stencil[ i ] ) )
+                expected.push_back( stdInput[ i ] );
+        }
+        output.resize( end - output.begin( ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( StreamCompactionTest, RemoveIfDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+
+        bolt::cl::device_vector< int >::iterator end = bolt::cl::remove_if( myControl, input.begin( ), input.end( ),
+            pred );
+
+        stdInput.resize( std::remove_if( stdInput.begin( ), stdInput.end( ), pred ) - stdInput.begin( ) );
+        EXPECT_EQ( stdInput.size( ), static_cast< size_t >( end - input.begin( ) ) );
+        cmpArrays( stdInput, input );
+    }
+}
+
+TEST_P( StreamCompactionTest, RemoveCopyIfHost )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        std::vector< int > output( length );
+
+        std::vector< int >::iterator end = bolt::cl::remove_copy_if( myControl, stdInput.begin( ), stdInput.end( ),
+            output.begin( ), pred );
+
+        std::vector< int > expected( length );
+        expected.resize( std::remove_copy_if( stdInput.begin( ), stdInput.end( ), expected.begin( ), pred )
+            - expected.begin( ) );
+        output.resize( end - output.begin( ) );
+        cmpArrays( expected, output );
+    }
+}
+
+TEST_P( StreamCompactionTest, UniqueHost )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        //  Runs of equal values, longer the more the predicate would select
+        for( int i = 0; i < length; ++i )
+            stdInput[ i ] = ( stdInput[ i ] < pred.limit ) ? i / 3 : i;
+        std::vector< int > input( stdInput );
+
+        std::vector< int >::iterator end = bolt::cl::unique( myControl, input.begin( ), input.end( ) );
+
+        stdInput.resize( std::unique( stdInput.begin( ), stdInput.end( ) ) - stdInput.begin( ) );
+        input.resize( end - input.begin( ) );
+        cmpArrays( stdInput, input );
+    }
+}
+
+TEST_P( StreamCompactionTest, UniqueByKeyDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        std::vector< int > stdKeys( length );
+        for( int i = 0; i < length; ++i )
+            stdKeys[ i ] = stdInput[ i ] / 10;
+
+        bolt::cl::device_vector< int > keys( stdKeys.begin( ), stdKeys.end( ) );
+        bolt::cl::device_vector< int > values( stdInput.begin( ), stdInput.end( ) );
+        bolt::cl::device_vector< int > keysOutput( length );
+        bolt::cl::device_vector< int > valuesOutput( length );
+
+        bolt::cl::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > ends =
+            bolt::cl::unique_by_key_copy( myControl, keys.begin( ), keys.end( ), values.begin( ), keysOutput.begin( ),
+                valuesOutput.begin( ) );
+
+        std::vector< int > expectedKeys, expectedValues;
+        for( int i = 0; i < length; ++i )
+        {
+            if( i == 0 || stdKeys[ i ] != stdKeys[ i - 1 ] )
+            {
+                expectedKeys.push_back( stdKeys[ i ] );
+                expectedValues.push_back( stdInput[ i ] );
+            }
+        }
+        EXPECT_EQ( expectedKeys.size( ), static_cast< size_t >( ends.first - keysOutput.begin( ) ) );
+        EXPECT_EQ( expectedKeys.size( ), static_cast< size_t >( ends.second - valuesOutput.begin( ) ) );
+        cmpArrays( expectedKeys, keysOutput );
+        cmpArrays( expectedValues, valuesOutput );
+
+        //  In place gives the same result
+        ends = bolt::cl::unique_by_key( myControl, keys.begin( ), keys.end( ), values.begin( ) );
+        EXPECT_EQ( expectedKeys.size( ), static_cast< size_t >( ends.first - keys.begin( ) ) );
+        cmpArrays( expectedKeys, keys );
+        cmpArrays( expectedValues, values );
+    }
+}
+
+TEST_P( StreamCompactionTest, StablePartitionDevice )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        bolt::cl::device_vector< int > input( stdInput.begin( ), stdInput.end( ) );
+
+        bolt::cl::device_vector< int >::iterator middle = bolt::cl::stable_partition( myControl, input.begin( ),
+            input.end( ), pred );
+
+        std::vector< int >::iterator stdMiddle = std::stable_partition( stdInput.begin( ), stdInput.end( ), pred );
+        EXPECT_EQ( stdMiddle - stdInput.begin( ), middle - input.begin( ) );
+        cmpArrays( stdInput, input );
+    }
+}
+
+TEST_P( StreamCompactionTest, PartitionCopyHost )
+{
+    for( int test = 0; test < numLengths; ++test )
+    {
+        fill( test );
+
+        std::vector< int > selected( length );
+        std::vector< int > rejected( length );
+
+        bolt::cl::pair< std::vector< int >::iterator, std::vector< int >::iterator > ends = bolt::cl::partition_copy(
+            myControl, stdInput.begin( ), stdInput.end( ), selected.begin( ), rejected.begin( ), pred );
+
+        std::vector< int > expected( stdInput );
+        size_t middle = std::stable_partition( expected.begin( ), expected.end( ), pred ) - expected.begin( );
+        ASSERT_EQ( middle, static_cast< size_t >( ends.first - selected.begin( ) ) );
+        ASSERT_EQ( length - middle, static_cast< size_t >( ends.second - rejected.begin( ) ) );
+        std::copy( rejected.begin( ), ends.second, selected.begin( ) + middle );
+        cmpArrays( expected, selected );
+    }
+}
+
+INSTANTIATE_TEST_CASE_P( RunModes, StreamCompactionTest, ::testing::Values( bolt::cl::control::OpenCL,
+    bolt::cl::control::MultiCoreCpu, bolt::cl::control::SerialCpu ) );
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
@@ -0,0 +1,141 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+#include "bolt/cl/streaming.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+class StreamingTest: public testing::Test
+{
+public:
+    StreamingTest( ): myControl( bolt::cl::control::getDefault( ) ), length( 100003 )
+    {}
+
+    virtual void SetUp( )
+    {
+        //  Chunks of 4096 bytes cut the range into many more chunks than there are slots, and the length leaves a
+        //  short chunk at the end
+        myControl.setForceRunMode( bolt::cl::control::OpenCL );
+        myControl.setStreamChunkSize( 4096 );
+
+        stdInput.resize( length );
+        for( int i = 0; i < length; ++i )
+            stdInput[ i ] = rand( ) % 1000 - 500;
+    };
+
+protected:
+    bolt::cl::control myControl;
+    int length;
+    std::vector< int > stdInput;
+};
+
+TEST_F( StreamingTest, Reduce )
+{
+    int sum = bolt::cl::streaming::reduce( myControl, stdInput.begin( ), stdInput.end( ), 7,
+        bolt::cl::plus< int >( ) );
+    EXPECT_EQ( std::accumulate( stdInput.begin( ), stdInput.end( ), 7 ), sum );
+}
+
+TEST_F( StreamingTest, TransformReduceAndCount )
+{
+    int sumOfSquares = bolt::cl::streaming::transform_reduce( myControl, stdInput.begin( ), stdInput.end( ),
+        bolt::cl::square< int >( ), 0, bolt::cl::plus< int >( ) );
+    int expected = 0;
+    for( int i = 0; i < length; ++i )
+        expected += stdInput[ i ] * stdInput[ i ];
+    EXPECT_EQ( expected, sumOfSquares );
+
+    EXPECT_EQ( std::count( stdInput.begin( ), stdInput.end( ), 0 ),
+        bolt::cl::streaming::count( myControl, stdInput.begin( ), stdInput.end( ), 0 ) );
+}
+
+TEST_F( StreamingTest, Transform )
+{
+    std::vector< int > output( length );
+    bolt::cl::streaming::transform( myControl, stdInput.begin( ), stdInput.end( ), output.begin( ),
+        bolt::cl::negate< int >( ) );
+
+    std::transform( stdInput.begin( ), stdInput.end( ), stdInput.begin( ), std::negate< int >( ) );
+    cmpArrays( stdInput, output );
+}
+
+TEST_F( StreamingTest, InclusiveScanCarriesAcrossChunks )
+{
+    std::vector< int > output( length );
+    std::vector< int >::iterator end = bolt::cl::streaming::inclusive_scan( myControl, stdInput.begin( ),
+        stdInput.end( ), output.begin( ), bolt::cl::plus< int >( ) );
+    EXPECT_EQ( output.end( ) - output.begin( ), end - output.begin( ) );
+
+    std::partial_sum( stdInput.begin( ), stdInput.end( ), stdInput.begin( ) );
+    cmpArrays( stdInput, output );
+}
+
+TEST_F( StreamingTest, ExclusiveScanInPlace )
+{
+    std::vector< int > expected( length );
+    expected[ 0 ] = 3;
+    for( int i = 1; i < length; ++i )
+        expected[ i ] = expected[ i - 1 ] + stdInput[ i - 1 ];
+
+    bolt::cl::streaming::exclusive_scan( myControl, stdInput.begin( ), stdInput.end( ), stdInput.begin( ), 3,
+        bolt::cl::plus< int >( ) );
+    cmpArrays( expected, stdInput );
+}
+
+TEST_F( StreamingTest, SortMergesChunks )
+{
+    std::vector< int > output( stdInput );
+    bolt::cl::streaming::sort( myControl, output.begin( ), output.end( ), bolt::cl::greater< int >( ) );
+
+    std::sort( stdInput.begin( ), stdInput.end( ), std::greater< int >( ) );
+    cmpArrays( stdInput, output );
+}
+
+TEST_F( StreamingTest, SerialCpuFallsBack )
+{
+    myControl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::vector< int > output( length );
+    bolt::cl::streaming::inclusive_scan( myControl, stdInput.begin( ), stdInput.end( ), output.begin( ),
+        bolt::cl::plus< int >( ) );
+
+    std::partial_sum( stdInput.begin( ), stdInput.end( ), stdInput.begin( ) );
+    cmpArrays( stdInput, output );
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
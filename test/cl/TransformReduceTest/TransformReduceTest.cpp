@@ -2676,6 +2676,46 @@ TEST( TransformReduceStdVectWithInit, OffsetTestSerialCpu)
     EXPECT_EQ( stlTransformReduce, boltTransformReduce );
 }
 
+//  Past 2^31 elements the OpenCL path reduces a slice at a time; the CPU paths take the whole range
+static void transformReduceLargeRange( size_t length, bolt::cl::control::e_RunMode runMode )
+{
+    std::vector< cl_char > input( length, 0 );
+    size_t marks[ ] = { 0, ( size_t( 1 ) << 31 ) - 1, size_t( 1 ) << 31, ( size_t( 1 ) << 32 ) - 1, size_t( 1 ) << 32,
+        length - 1 };
+    int expected = 0;
+    for( size_t m = 0; m < sizeof( marks ) / sizeof( marks[ 0 ] ); ++m )
+    {
+        if( marks[ m ] < length && input[ marks[ m ] ] == 0 )
+        {
+            input[ marks[ m ] ] = 1;
+            --expected;
+        }
+    }
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( runMode );
+    EXPECT_EQ( expected, bolt::cl::transform_reduce( ctl, input.begin( ), input.end( ), bolt::cl::negate< int >( ),
+                                                     0, bolt::cl::plus< int >( ) ) );
+}
+
+TEST( TransformReduceLargeRange, PastInt32 )
+{
+    transformReduceLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    transformReduceLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    transformReduceLargeRange( ( size_t( 1 ) << 31 ) + 16, bolt::cl::control::OpenCL );
+}
+
+TEST( TransformReduceLargeRange, PastUInt32 )
+{
+    transformReduceLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    transformReduceLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::MultiCoreCpu );
+#endif
+    transformReduceLargeRange( ( size_t( 1 ) << 32 ) + 16, bolt::cl::control::OpenCL );
+}
+
 int main(int argc, char* argv[])
 {
  
@@ -1734,6 +1734,34 @@ TEST(SwitchDevices, IncAddInt2)
 
 /* Failing Test case - Random Access Iterator with Default Path!
 
+TEST(SinglePass, NegPlusInt)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control multiPassCtl = bolt::cl::control::getDefault( );
+    multiPassCtl.setDebugMode( bolt::cl::control::debug::MultiPassScan );
+
+    bolt::cl::negate< int > unary_op;
+    bolt::cl::plus< int > binary_op;
+    int length = ( 1 << 20 ) + 7;
+
+    std::vector< int > refInput( length );
+    for( int i = 0; i < length; i++ )
+        refInput[ i ] = rand( ) % 10;
+    bolt::cl::device_vector< int > input( refInput.begin( ), refInput.end( ) );
+    bolt::cl::device_vector< int > output( length );
+    bolt::cl::device_vector< int > multiPassOutput( length );
+
+    std::vector< int > refOutput( length );
+    ::std::transform( refInput.begin( ), refInput.end( ), refOutput.begin( ), unary_op );
+    ::std::partial_sum( refOutput.begin( ), refOutput.end( ), refOutput.begin( ), binary_op );
+
+    bolt::cl::transform_inclusive_scan( ctl, input.begin( ), input.end( ), output.begin( ), unary_op, binary_op );
+    bolt::cl::transform_inclusive_scan( multiPassCtl, input.begin( ), input.end( ), multiPassOutput.begin( ),
+        unary_op, binary_op );
+    cmpArrays( refOutput, output );
+    cmpArrays( refOutput, multiPassOutput );
+}
+
 TEST(DefaultGPU, NegPlusInt)
 {
     //bolt::cl::control ctrl = bolt::cl::control::getDefault();
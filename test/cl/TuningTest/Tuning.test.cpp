@@ -0,0 +1,218 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cstdio>
+
+#include "bolt/cl/tuning.h"
+#include "bolt/cl/control.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/transform_reduce.h"
+#include "bolt/cl/count.h"
+
+#include "bolt/unicode.h"
+
+#include <gtest/gtest.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Every test starts from an empty tuning database, so no shape survives from an earlier test
+
+class TuningTest: public testing::Test
+{
+public:
+    TuningTest( ): myControl( bolt::cl::control::getDefault( ) ), input( 1024 * 1024 + 7 )
+    {}
+
+    virtual void SetUp( )
+    {
+        bolt::cl::clearTuningDatabase( );
+        myControl.setForceRunMode( bolt::cl::control::OpenCL );
+
+        for( size_t i = 0; i < input.size( ); ++i )
+            input[ i ] = static_cast< int >( i % 97 ) - 48;
+    };
+
+    virtual void TearDown( )
+    {
+        bolt::cl::clearTuningDatabase( );
+    };
+
+    int expected( ) const
+    {
+        return std::accumulate( input.begin( ), input.end( ), 3 );
+    }
+
+    int runReduce( )
+    {
+        bolt::cl::device_vector< int > dv( input.begin( ), input.end( ), CL_MEM_READ_WRITE, myControl );
+        return bolt::cl::reduce( myControl, dv.begin( ), dv.end( ), 3, bolt::cl::plus< int >( ) );
+    }
+
+    int runTransformReduce( )
+    {
+        bolt::cl::device_vector< int > dv( input.begin( ), input.end( ), CL_MEM_READ_WRITE, myControl );
+        return bolt::cl::transform_reduce( myControl, dv.begin( ), dv.end( ), bolt::cl::negate< int >( ), 3,
+            bolt::cl::plus< int >( ) );
+    }
+
+    int expectedCount( ) const
+    {
+        return static_cast< int >( std::count( input.begin( ), input.end( ), 7 ) );
+    }
+
+    int runCount( )
+    {
+        bolt::cl::device_vector< int > dv( input.begin( ), input.end( ), CL_MEM_READ_WRITE, myControl );
+        return static_cast< int >( bolt::cl::count( myControl, dv.begin( ), dv.end( ), 7 ) );
+    }
+
+protected:
+    bolt::cl::control myControl;
+    std::vector< int > input;
+};
+
+TEST_F( TuningTest, DefaultDoesNotSweep )
+{
+    EXPECT_EQ( bolt::cl::control::AutoTuneDevice, bolt::cl::control::getDefault( ).getAutoTune( ) );
+
+    size_t sweeps = bolt::cl::getTuningSweepCount( );
+    EXPECT_EQ( expected( ), runReduce( ) );
+    EXPECT_EQ( sweeps, bolt::cl::getTuningSweepCount( ) );
+
+    bolt::cl::WorkShape shape;
+    EXPECT_FALSE( bolt::cl::findWorkShape( myControl, "reduce", sizeof( int ), shape ) );
+}
+
+TEST_F( TuningTest, SweepStoresWinner )
+{
+    myControl.setAutoTune( bolt::cl::control::AutoTuneWorkShape );
+
+    size_t sweeps = bolt::cl::getTuningSweepCount( );
+    EXPECT_EQ( expected( ), runReduce( ) );
+    EXPECT_EQ( sweeps + bolt::cl::detail::reduceWorkShapes( myControl ).size( ), bolt::cl::getTuningSweepCount( ) );
+
+    bolt::cl::WorkShape shape;
+    EXPECT_TRUE( bolt::cl::findWorkShape( myControl, "reduce", sizeof( int ), shape ) );
+
+    //  The winner is used from now on, without sweeping again
+    sweeps = bolt::cl::getTuningSweepCount( );
+    EXPECT_EQ( expected( ), runReduce( ) );
+    EXPECT_EQ( sweeps, bolt::cl::getTuningSweepCount( ) );
+}
+
+TEST_F( TuningTest, StoredShapeUsedWithoutAutoTune )
+{
+    bolt::cl::WorkShape stored = { 64, 4, 2 };
+    bolt::cl::storeWorkShape( myControl, "reduce", sizeof( int ), stored );
+
+    myControl.setAutoTune( bolt::cl::control::NoAutoTune );
+    size_t sweeps = bolt::cl::getTuningSweepCount( );
+    EXPECT_EQ( expected( ), runReduce( ) );
+    EXPECT_EQ( sweeps, bolt::cl::getTuningSweepCount( ) );
+}
+
+TEST_F( TuningTest, EveryCandidateReducesCorrectly )
+{
+    std::vector< bolt::cl::WorkShape > candidates = bolt::cl::detail::reduceWorkShapes( myControl );
+    EXPECT_LT( 0u, candidates.size( ) );
+
+    for( size_t c = 0; c < candidates.size( ); ++c )
+    {
+        bolt::cl::storeWorkShape( myControl, "reduce", sizeof( int ), candidates[ c ] );
+        EXPECT_EQ( expected( ), runReduce( ) ) << "wgSize " << candidates[ c ].wgSize << ", wgPerComputeUnit "
+            << candidates[ c ].wgPerComputeUnit << ", unroll " << candidates[ c ].unroll;
+    }
+}
+
+TEST_F( TuningTest, TransformReduceAndCountSweep )
+{
+    myControl.setAutoTune( bolt::cl::control::AutoTuneWorkShape );
+
+    int negated = 6 - expected( );
+    EXPECT_EQ( negated, runTransformReduce( ) );
+    EXPECT_EQ( expectedCount( ), runCount( ) );
+
+    bolt::cl::WorkShape shape;
+    EXPECT_TRUE( bolt::cl::findWorkShape( myControl, "transform_reduce", sizeof( int ), shape ) );
+    EXPECT_TRUE( bolt::cl::findWorkShape( myControl, "count", sizeof( int ), shape ) );
+}
+
+TEST_F( TuningTest, TransformReduceAndCountEveryCandidate )
+{
+    std::vector< bolt::cl::WorkShape > candidates = bolt::cl::detail::reduceWorkShapes( myControl );
+    int negated = 6 - expected( );
+
+    for( size_t c = 0; c < candidates.size( ); ++c )
+    {
+        bolt::cl::storeWorkShape( myControl, "transform_reduce", sizeof( int ), candidates[ c ] );
+        bolt::cl::storeWorkShape( myControl, "count", sizeof( int ), candidates[ c ] );
+        EXPECT_EQ( negated, runTransformReduce( ) ) << "wgSize " << candidates[ c ].wgSize << ", unroll "
+            << candidates[ c ].unroll;
+        EXPECT_EQ( expectedCount( ), runCount( ) ) << "wgSize " << candidates[ c ].wgSize << ", unroll "
+            << candidates[ c ].unroll;
+    }
+}
+
+TEST_F( TuningTest, ShortInputWithUnroll )
+{
+    bolt::cl::WorkShape stored = { 128, 64, 4 };
+    bolt::cl::storeWorkShape( myControl, "reduce", sizeof( int ), stored );
+
+    input.resize( 300 );
+    EXPECT_EQ( expected( ), runReduce( ) );
+}
+
+TEST_F( TuningTest, DatabaseRoundTrip )
+{
+    const char* path = "boltTuningTest.db";
+    bolt::cl::WorkShape stored = { 128, 16, 4 };
+    bolt::cl::storeWorkShape( myControl, "reduce", sizeof( double ), stored );
+    EXPECT_TRUE( bolt::cl::saveTuningDatabase( path ) );
+
+    bolt::cl::clearTuningDatabase( );
+    bolt::cl::WorkShape shape;
+    EXPECT_FALSE( bolt::cl::findWorkShape( myControl, "reduce", sizeof( double ), shape ) );
+
+    EXPECT_TRUE( bolt::cl::loadTuningDatabase( path ) );
+    EXPECT_TRUE( bolt::cl::findWorkShape( myControl, "reduce", sizeof( double ), shape ) );
+    EXPECT_EQ( stored.wgSize, shape.wgSize );
+    EXPECT_EQ( stored.wgPerComputeUnit, shape.wgPerComputeUnit );
+    EXPECT_EQ( stored.unroll, shape.unroll );
+
+    //  Value sizes are tuned separately
+    EXPECT_FALSE( bolt::cl::findWorkShape( myControl, "reduce", sizeof( char ), shape ) );
+
+    std::remove( path );
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
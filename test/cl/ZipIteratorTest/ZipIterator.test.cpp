@@ -0,0 +1,385 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "bolt/cl/iterator/zip_iterator.h"
+#include "bolt/cl/tuple.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/transform_reduce.h"
+#include "bolt/cl/sort_by_key.h"
+#include "bolt/cl/stablesort_by_key.h"
+#include "bolt/cl/copy.h"
+#include "bolt/cl/fill.h"
+#include "bolt/cl/generate.h"
+#include "bolt/cl/count.h"
+#include "bolt/cl/inner_product.h"
+#include "bolt/cl/gather.h"
+#include "bolt/cl/scatter.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/unicode.h"
+
+#include "common/test_common.h"
+
+#include <gtest/gtest.h>
+
+BOLT_FUNCTOR( sumAndDifference,
+struct sumAndDifference
+{
+    bolt::cl::tuple< int, int > operator( )( const bolt::cl::tuple< int, int >& p ) const
+    {
+        return bolt::cl::tuple< int, int >( p.first + p.second, p.first - p.second );
+    }
+};
+);
+
+BOLT_FUNCTOR( productOf,
+struct productOf
+{
+    int operator( )( const bolt::cl::tuple< int, int >& p ) const
+    {
+        return p.first * p.second;
+    }
+};
+);
+
+BOLT_FUNCTOR( tuplePlus,
+struct tuplePlus
+{
+    bolt::cl::tuple< int, int > operator( )( const bolt::cl::tuple< int, int >& a,
+        const bolt::cl::tuple< int, int >& b ) const
+    {
+        return bolt::cl::tuple< int, int >( a.first + b.first, a.second + b.second );
+    }
+};
+);
+
+BOLT_FUNCTOR( pairOfConstants,
+struct pairOfConstants
+{
+    bolt::cl::tuple< int, int > operator( )( ) const
+    {
+        return bolt::cl::tuple< int, int >( 3, -4 );
+    }
+};
+);
+
+BOLT_FUNCTOR( firstIsGreater,
+struct firstIsGreater
+{
+    bool operator( )( const bolt::cl::tuple< int, int >& p ) const
+    {
+        return p.first > p.second;
+    }
+};
+);
+
+BOLT_FUNCTOR( dotOfPairs,
+struct dotOfPairs
+{
+    int operator( )( const bolt::cl::tuple< int, int >& a, const bolt::cl::tuple< int, int >& b ) const
+    {
+        return a.first * b.first + a.second * b.second;
+    }
+};
+);
+
+class ZipIteratorTest: public testing::TestWithParam< bolt::cl::control::e_RunMode >
+{
+public:
+    ZipIteratorTest( ): myControl( bolt::cl::control::getDefault( ) ), length( 1 << 16 )
+    {}
+
+    virtual void SetUp( )
+    {
+        myControl.setForceRunMode( GetParam( ) );
+
+        stdX.resize( length );
+        stdY.resize( length );
+        for( int i = 0; i < length; ++i )
+        {
+            stdX[ i ] = rand( ) % 100 - 50;
+            stdY[ i ] = rand( ) % 100 - 50;
+        }
+    };
+
+protected:
+    bolt::cl::control myControl;
+    int length;
+    std::vector< int > stdX;
+    std::vector< int > stdY;
+};
+
+TEST( TupleTypes, HostOperations )
+{
+    bolt::cl::tuple< int, float, int > t = bolt::cl::make_tuple( 1, 2.5f, 3 );
+
+    EXPECT_EQ( 1, bolt::cl::get< 0 >( t ) );
+    EXPECT_EQ( 2.5f, bolt::cl::get< 1 >( t ) );
+    bolt::cl::get< 2 >( t ) = 7;
+    EXPECT_EQ( 7, t.third );
+    unsigned int size = bolt::cl::tuple_size< bolt::cl::tuple< int, float, int > >::value;
+    EXPECT_EQ( 3u, size );
+
+    //  Comparison is lexicographic
+    EXPECT_TRUE( bolt::cl::make_tuple( 1, 2 ) < bolt::cl::make_tuple( 1, 3 ) );
+    EXPECT_TRUE( bolt::cl::make_tuple( 0, 9 ) < bolt::cl::make_tuple( 1, 0 ) );
+    EXPECT_TRUE( bolt::cl::make_tuple( 1, 2 ) == bolt::cl::make_tuple( 1, 2 ) );
+    EXPECT_TRUE( bolt::cl::make_tuple( 1, 2 ) >= bolt::cl::make_tuple( 1, 2 ) );
+}
+
+TEST( TupleTypes, NamesForKernels )
+{
+    typedef bolt::cl::device_vector< int >::iterator intIterator;
+    typedef bolt::cl::device_vector< float >::iterator floatIterator;
+
+    EXPECT_EQ( "bolt::cl::tuple< cl_int, cl_float >", ( TypeName< bolt::cl::tuple< int, float > >::get( ) ) );
+    EXPECT_EQ( "bolt::cl::zip_iterator< " + TypeName< intIterator >::get( ) + ", " + TypeName< floatIterator >::get( )
+        + " >", ( TypeName< bolt::cl::zip_iterator< intIterator, floatIterator > >::get( ) ) );
+    EXPECT_NE( std::string::npos,
+        ( ClCode< bolt::cl::zip_iterator< intIterator, floatIterator > >::get( ).find( "struct tuple" ) ) );
+}
+
+TEST( ZipIteratorTypes, HostColumns )
+{
+    std::vector< int > x( 8 );
+    std::vector< float > y( 8, 2.0f );
+    std::iota( x.begin( ), x.end( ), 0 );
+
+    bolt::cl::zip_iterator< std::vector< int >::iterator, std::vector< float >::iterator > z =
+        bolt::cl::make_zip_iterator( x.begin( ), y.begin( ) );
+    EXPECT_EQ( 8, ( z + 8 ) - z );
+
+    bolt::cl::tuple< int, float > t = *( z + 3 );
+    EXPECT_EQ( 3, t.first );
+    EXPECT_EQ( 2.0f, t.second );
+
+    *( z + 3 ) = bolt::cl::make_tuple( 30, 5.0f );
+    EXPECT_EQ( 30, x[ 3 ] );
+    EXPECT_EQ( 5.0f, y[ 3 ] );
+}
+
+TEST_P( ZipIteratorTest, TransformSoAToSoA )
+{
+    std::vector< int > sums( length );
+    bolt::cl::device_vector< int > differences( length );
+
+    bolt::cl::transform( myControl, bolt::cl::make_zip_iterator( stdX.begin( ), stdY.begin( ) ),
+        bolt::cl::make_zip_iterator( stdX.end( ), stdY.end( ) ),
+        bolt::cl::make_zip_iterator( sums.begin( ), differences.begin( ) ), sumAndDifference( ) );
+
+    std::vector< int > expectedSums( length ), expectedDifferences( length );
+    std::transform( stdX.begin( ), stdX.end( ), stdY.begin( ), expectedSums.begin( ), std::plus< int >( ) );
+    std::transform( stdX.begin( ), stdX.end( ), stdY.begin( ), expectedDifferences.begin( ), std::minus< int >( ) );
+    cmpArrays( expectedSums, sums );
+    cmpArrays( expectedDifferences, differences );
+}
+
+TEST_P( ZipIteratorTest, TransformDeviceColumns )
+{
+    bolt::cl::device_vector< int > x( stdX.begin( ), stdX.end( ) );
+    bolt::cl::device_vector< int > y( stdY.begin( ), stdY.end( ) );
+    bolt::cl::device_vector< int > products( length );
+
+    bolt::cl::transform( myControl, bolt::cl::make_zip_iterator( x.begin( ), y.begin( ) ),
+        bolt::cl::make_zip_iterator( x.end( ), y.end( ) ), products.begin( ), productOf( ) );
+
+    std::vector< int > expected( length );
+    std::transform( stdX.begin( ), stdX.end( ), stdY.begin( ), expected.begin( ), std::multiplies< int >( ) );
+    cmpArrays( expected, products );
+}
+
+TEST_P( ZipIteratorTest, Reduce )
+{
+    bolt::cl::device_vector< int > y( stdY.begin( ), stdY.end( ) );
+
+    bolt::cl::tuple< int, int > sums = bolt::cl::reduce( myControl,
+        bolt::cl::make_zip_iterator( stdX.begin( ), y.begin( ) ), bolt::cl::make_zip_iterator( stdX.end( ), y.end( ) ),
+        bolt::cl::make_tuple( 0, 0 ), tuplePlus( ) );
+
+    EXPECT_EQ( std::accumulate( stdX.begin( ), stdX.end( ), 0 ), sums.first );
+    EXPECT_EQ( std::accumulate( stdY.begin( ), stdY.end( ), 0 ), sums.second );
+}
+
+TEST_P( ZipIteratorTest, TransformReduce )
+{
+    bolt::cl::device_vector< int > x( stdX.begin( ), stdX.end( ) );
+
+    int dot = bolt::cl::transform_reduce( myControl, bolt::cl::make_zip_iterator( x.begin( ), stdY.begin( ) ),
+        bolt::cl::make_zip_iterator( x.end( ), stdY.end( ) ), productOf( ), 0, bolt::cl::plus< int >( ) );
+
+    EXPECT_EQ( std::inner_product( stdX.begin( ), stdX.end( ), stdY.begin( ), 0 ), dot );
+}
+
+TEST_P( ZipIteratorTest, SortByKeyZippedValues )
+{
+    bolt::cl::device_vector< int > keys( stdX.begin( ), stdX.end( ) );
+    bolt::cl::device_vector< int > positions( length );
+    std::vector< int > negated( length );
+    for( int i = 0; i < length; ++i )
+    {
+        positions[ i ] = i;
+        negated[ i ] = -i;
+    }
+
+    bolt::cl::sort_by_key( myControl, keys.begin( ), keys.end( ),
+        bolt::cl::make_zip_iterator( positions.begin( ), negated.begin( ) ) );
+
+    //  Equal keys may come out in any order, but every column must follow its key
+    std::vector< int > expectedKeys( stdX );
+    std::sort( expectedKeys.begin( ), expectedKeys.end( ) );
+    cmpArrays( expectedKeys, keys );
+    for( int i = 0; i < length; ++i )
+    {
+        int position = positions[ i ];
+        int key = keys[ i ];
+        EXPECT_EQ( stdX[ position ], key );
+        EXPECT_EQ( -position, negated[ i ] );
+    }
+}
+
+TEST_P( ZipIteratorTest, StableSortByKeyZippedValues )
+{
+    std::vector< int > keys( stdX );
+    std::vector< int > positions( length );
+    bolt::cl::device_vector< int > negated( length );
+    for( int i = 0; i < length; ++i )
+    {
+        positions[ i ] = i;
+        negated[ i ] = -i;
+    }
+
+    bolt::cl::stable_sort_by_key( myControl, keys.begin( ), keys.end( ),
+        bolt::cl::make_zip_iterator( positions.begin( ), negated.begin( ) ) );
+
+    //  Equal keys keep their order, so the positions come out exactly as std::stable_sort leaves them
+    std::vector< int > expectedPositions( length );
+    std::iota( expectedPositions.begin( ), expectedPositions.end( ), 0 );
+    std::stable_sort( expectedPositions.begin( ), expectedPositions.end( ),
+        [ & ]( int a, int b ) { return stdX[ a ] < stdX[ b ]; } );
+    cmpArrays( expectedPositions, positions );
+    for( int i = 0; i < length; ++i )
+    {
+        EXPECT_EQ( stdX[ expectedPositions[ i ] ], keys[ i ] );
+        EXPECT_EQ( -expectedPositions[ i ], negated[ i ] );
+    }
+}
+
+TEST_P( ZipIteratorTest, Copy )
+{
+    bolt::cl::device_vector< int > y( stdY.begin( ), stdY.end( ) );
+    bolt::cl::device_vector< int > copiedX( length );
+    std::vector< int > copiedY( length );
+
+    bolt::cl::copy( myControl, bolt::cl::make_zip_iterator( stdX.begin( ), y.begin( ) ),
+        bolt::cl::make_zip_iterator( stdX.end( ), y.end( ) ),
+        bolt::cl::make_zip_iterator( copiedX.begin( ), copiedY.begin( ) ) );
+
+    cmpArrays( stdX, copiedX );
+    cmpArrays( stdY, copiedY );
+}
+
+TEST_P( ZipIteratorTest, FillAndGenerate )
+{
+    bolt::cl::device_vector< int > x( length );
+    std::vector< int > y( length );
+
+    bolt::cl::fill( myControl, bolt::cl::make_zip_iterator( x.begin( ), y.begin( ) ),
+        bolt::cl::make_zip_iterator( x.end( ), y.end( ) ), bolt::cl::make_tuple( 7, -7 ) );
+    cmpArrays( std::vector< int >( length, 7 ), x );
+    cmpArrays( std::vector< int >( length, -7 ), y );
+
+    bolt::cl::generate( myControl, bolt::cl::make_zip_iterator( x.begin( ), y.begin( ) ),
+        bolt::cl::make_zip_iterator( x.end( ), y.end( ) ), pairOfConstants( ) );
+    cmpArrays( std::vector< int >( length, 3 ), x );
+    cmpArrays( std::vector< int >( length, -4 ), y );
+}
+
+TEST_P( ZipIteratorTest, CountIf )
+{
+    bolt::cl::device_vector< int > x( stdX.begin( ), stdX.end( ) );
+
+    int greater = static_cast< int >( bolt::cl::count_if( myControl,
+        bolt::cl::make_zip_iterator( x.begin( ), stdY.begin( ) ), bolt::cl::make_zip_iterator( x.end( ), stdY.end( ) ),
+        firstIsGreater( ) ) );
+
+    int expected = 0;
+    for( int i = 0; i < length; ++i )
+        expected += stdX[ i ] > stdY[ i ] ? 1 : 0;
+    EXPECT_EQ( expected, greater );
+}
+
+TEST_P( ZipIteratorTest, InnerProduct )
+{
+    bolt::cl::device_vector< int > x( stdX.begin( ), stdX.end( ) );
+    bolt::cl::device_vector< int > y( stdY.begin( ), stdY.end( ) );
+
+    //  The dot product of (x, y) with (y, x) at every position, summed
+    int dot = bolt::cl::inner_product( myControl, bolt::cl::make_zip_iterator( x.begin( ), stdY.begin( ) ),
+        bolt::cl::make_zip_iterator( x.end( ), stdY.end( ) ), bolt::cl::make_zip_iterator( y.begin( ), stdX.begin( ) ),
+        0, bolt::cl::plus< int >( ), dotOfPairs( ) );
+
+    EXPECT_EQ( 2 * std::inner_product( stdX.begin( ), stdX.end( ), stdY.begin( ), 0 ), dot );
+}
+
+TEST_P( ZipIteratorTest, GatherAndScatter )
+{
+    //  Reversing the rows through a map, then putting them back
+    std::vector< int > map( length );
+    for( int i = 0; i < length; ++i )
+        map[ i ] = length - 1 - i;
+    bolt::cl::device_vector< int > y( stdY.begin( ), stdY.end( ) );
+    std::vector< int > reversedX( length );
+    bolt::cl::device_vector< int > reversedY( length );
+
+    bolt::cl::gather( myControl, map.begin( ), map.end( ), bolt::cl::make_zip_iterator( stdX.begin( ), y.begin( ) ),
+        bolt::cl::make_zip_iterator( reversedX.begin( ), reversedY.begin( ) ) );
+
+    std::vector< int > expectedX( stdX.rbegin( ), stdX.rend( ) ), expectedY( stdY.rbegin( ), stdY.rend( ) );
+    cmpArrays( expectedX, reversedX );
+    cmpArrays( expectedY, reversedY );
+
+    std::vector< int > restoredX( length );
+    bolt::cl::device_vector< int > restoredY( length );
+    bolt::cl::scatter( myControl, bolt::cl::make_zip_iterator( reversedX.begin( ), reversedY.begin( ) ),
+        bolt::cl::make_zip_iterator( reversedX.end( ), reversedY.end( ) ), map.begin( ),
+        bolt::cl::make_zip_iterator( restoredX.begin( ), restoredY.begin( ) ) );
+
+    cmpArrays( stdX, restoredX );
+    cmpArrays( stdY, restoredY );
+}
+
+INSTANTIATE_TEST_CASE_P( RunModes, ZipIteratorTest, ::testing::Values( bolt::cl::control::OpenCL,
+    bolt::cl::control::MultiCoreCpu, bolt::cl::control::SerialCpu ) );
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    std::cout << "Device under test : "
+        << bolt::cl::control::getDefault( ).getDevice( ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+    return retVal;
+}
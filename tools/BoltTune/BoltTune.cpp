@@ -0,0 +1,344 @@
+/***************************************************************************
+*    2012,2014 Advanced Micro Devices, Inc. All rights reserved.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+/* bolt-tune: fills the work shape tuning database and the Automatic dispatch model ahead of deployment
+ * Runs reduce, transform_reduce and count under control::AutoTuneWorkShape on the chosen device, for every value size,
+ * and writes the winning shapes to a file.  Point BOLT_TUNING_DB at that file when the application runs, or call
+ * bolt::cl::loadTuningDatabase, and the first call skips the sweep.
+ * It then times the algorithms that control::Automatic dispatches on every path, at several sizes, and writes the
+ * fitted cost models to a second file.  Point BOLT_DISPATCH_MODEL at it, or call bolt::cl::loadDispatchModel, so
+ * that Automatic can choose a path for calls too large to be explored at run time.
+ * Usage : bolt-tune -p <platform> -d <device> -o <database-file> -m <model-file> [-r]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/program_options.hpp>
+
+#include "bolt/cl/control.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/reduce.h"
+#include "bolt/cl/transform_reduce.h"
+#include "bolt/cl/count.h"
+#include "bolt/cl/scan.h"
+#include "bolt/cl/sort.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/dispatch.h"
+#include "bolt/cl/tuning.h"
+
+namespace po = boost::program_options;
+
+//  The paths Automatic chooses between
+std::vector< bolt::cl::control::e_RunMode > dispatchPaths( )
+{
+    std::vector< bolt::cl::control::e_RunMode > paths;
+    paths.push_back( bolt::cl::control::SerialCpu );
+#if defined( ENABLE_TBB )
+    paths.push_back( bolt::cl::control::MultiCoreCpu );
+#endif
+    paths.push_back( bolt::cl::control::OpenCL );
+    return paths;
+}
+
+const char* pathName( bolt::cl::control::e_RunMode runMode )
+{
+    switch( runMode )
+    {
+    case bolt::cl::control::SerialCpu:      return "SerialCpu";
+    case bolt::cl::control::MultiCoreCpu:   return "MultiCoreCpu";
+    default:                                return "OpenCL";
+    }
+}
+
+//  Times one algorithm on every path at several sizes, and feeds the times to the dispatch model the way an
+//  Automatic call would.  The inputs are host vectors, so the OpenCL path is charged for copying them.
+template< typename T, typename Run >
+void calibrateDispatch( bolt::cl::control& ctl, size_t length, const char* algorithm, const char* typeName,
+    Run run )
+{
+    std::cout << "Calibrating " << algorithm << "< " << typeName << " > ... " << std::flush;
+
+    std::vector< bolt::cl::control::e_RunMode > paths = dispatchPaths( );
+    std::string key = bolt::cl::detail::dispatchKey< T >( algorithm );
+
+    try
+    {
+        for( size_t p = 0; p < paths.size( ); ++p )
+        {
+            ctl.setForceRunMode( paths[ p ] );
+            size_t transferBytes = ( paths[ p ] == bolt::cl::control::OpenCL ) ? sizeof( T ) : 0;
+
+            //  The model drops the first sample of a path, which pays for compiles and thread start-up
+            for( size_t n = std::max< size_t >( length / 256, 1 ); n <= length; n *= 4 )
+            {
+                std::vector< T > input( n );
+                for( size_t i = 0; i < n; ++i )
+                    input[ i ] = static_cast< T >( ( i * 7919 ) % 100 );
+
+                double start = bolt::cl::dispatchClock( );
+                run( ctl, input );
+                bolt::cl::recordDispatchTime( ctl, key, paths[ p ], n, transferBytes * n,
+                    bolt::cl::dispatchClock( ) - start );
+            }
+        }
+
+        std::cout << length << " elements predicted at";
+        for( size_t p = 0; p < paths.size( ); ++p )
+        {
+            double predicted = bolt::cl::predictDispatchTime( ctl, key, paths[ p ], length,
+                ( paths[ p ] == bolt::cl::control::OpenCL ) ? sizeof( T ) * length : 0 );
+            std::cout << ( p ? ", " : " " ) << pathName( paths[ p ] ) << " " << predicted * 1000.0 << " ms";
+        }
+        std::cout << std::endl;
+    }
+    catch( ::cl::Error& e )
+    {
+        std::cout << "failed: " << e.what( ) << " (" << e.err( ) << ")" << std::endl;
+    }
+
+    ctl.setForceRunMode( bolt::cl::control::OpenCL );
+}
+
+template< typename T >
+struct runReduce
+{
+    template< typename Container >
+    void operator( )( bolt::cl::control& ctl, Container& input ) const
+    {
+        bolt::cl::reduce( ctl, input.begin( ), input.end( ), T( 0 ), bolt::cl::plus< T >( ) );
+    }
+};
+
+template< typename T >
+struct runScan
+{
+    template< typename Container >
+    void operator( )( bolt::cl::control& ctl, Container& input ) const
+    {
+        bolt::cl::inclusive_scan( ctl, input.begin( ), input.end( ), input.begin( ) );
+    }
+};
+
+template< typename T >
+struct runSort
+{
+    template< typename Container >
+    void operator( )( bolt::cl::control& ctl, Container& input ) const
+    {
+        bolt::cl::sort( ctl, input.begin( ), input.end( ) );
+    }
+};
+
+template< typename T >
+struct runTransform
+{
+    template< typename Container >
+    void operator( )( bolt::cl::control& ctl, Container& input ) const
+    {
+        bolt::cl::transform( ctl, input.begin( ), input.end( ), input.begin( ), bolt::cl::negate< T >( ) );
+    }
+};
+
+template< typename T >
+struct runTransformReduce
+{
+    template< typename Container >
+    void operator( )( bolt::cl::control& ctl, Container& input ) const
+    {
+        bolt::cl::transform_reduce( ctl, input.begin( ), input.end( ), bolt::cl::negate< T >( ), T( 0 ),
+            bolt::cl::plus< T >( ) );
+    }
+};
+
+template< typename T >
+struct runCount
+{
+    template< typename Container >
+    void operator( )( bolt::cl::control& ctl, Container& input ) const
+    {
+        bolt::cl::count( ctl, input.begin( ), input.end( ), T( 1 ) );
+    }
+};
+
+//  Sweeps one algorithm for one value type on a device resident input, which stores the winning shape
+template< typename T, typename Run >
+void tuneShape( bolt::cl::control& ctl, size_t length, const char* algorithm, const char* typeName, Run run )
+{
+    std::cout << "Tuning " << algorithm << "< " << typeName << " > ... " << std::flush;
+    try
+    {
+        bolt::cl::device_vector< T > input( length, T( 1 ), CL_MEM_READ_WRITE, true, ctl );
+        run( ctl, input );
+
+        bolt::cl::WorkShape shape;
+        if( bolt::cl::findWorkShape( ctl, algorithm, sizeof( T ), shape ) )
+            std::cout << "wgSize " << shape.wgSize << ", wgPerComputeUnit " << shape.wgPerComputeUnit
+                << ", unroll " << shape.unroll << std::endl;
+        else
+            std::cout << "not tuned" << std::endl;
+    }
+    catch( ::cl::Error& e )
+    {
+        std::cout << "failed: " << e.what( ) << " (" << e.err( ) << ")" << std::endl;
+    }
+}
+
+template< typename T >
+void tuneType( bolt::cl::control& ctl, size_t length, const char* typeName )
+{
+    tuneShape< T >( ctl, length, "reduce", typeName, runReduce< T >( ) );
+    tuneShape< T >( ctl, length, "transform_reduce", typeName, runTransformReduce< T >( ) );
+    tuneShape< T >( ctl, length, "count", typeName, runCount< T >( ) );
+}
+
+template< typename T >
+void calibrateType( bolt::cl::control& ctl, size_t length, const char* typeName )
+{
+    calibrateDispatch< T >( ctl, length, "reduce", typeName, runReduce< T >( ) );
+    calibrateDispatch< T >( ctl, length, "scan", typeName, runScan< T >( ) );
+    calibrateDispatch< T >( ctl, length, "sort", typeName, runSort< T >( ) );
+    calibrateDispatch< T >( ctl, length, "unary_transform", typeName, runTransform< T >( ) );
+}
+
+int main( int argc, char* argv[] )
+{
+    cl_uint userPlatform = 0;
+    cl_uint userDevice = 0;
+    size_t length = 0;
+    std::string databaseFile;
+    std::string modelFile;
+    bool retune = false;
+    cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
+
+    try
+    {
+        // Declare the supported options.
+        po::options_description desc( "bolt-tune command line options" );
+        desc.add_options()
+            ( "help,h",         "produces this help message" )
+            ( "gpu,g",          "Report only OpenCL GPU devices" )
+            ( "cpu,c",          "Report only OpenCL CPU devices" )
+            ( "all,a",          "Report all OpenCL devices" )
+            ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ),
+                                "Specify the platform to tune" )
+            ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ),
+                                "Specify the device to tune, relative to -g, -c or -a flags" )
+            ( "length,l",       po::value< size_t >( &length )->default_value( 16 * 1024 * 1024 ),
+                                "Specify the number of elements each sweep reduces" )
+            ( "output,o",       po::value< std::string >( &databaseFile )->default_value( "bolt_tuning.db" ),
+                                "Tuning database to write; entries already in it are kept" )
+            ( "model,m",        po::value< std::string >( &modelFile )->default_value( "bolt_dispatch.model" ),
+                                "Dispatch model to write; models already in it are kept, unless -r is given" )
+            ( "retune,r",       "Ignore the entries already in the database and sweep every value size again" )
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+        po::notify( vm );
+
+        if( vm.count( "help" ) )
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+
+        if( vm.count( "gpu" ) )
+            deviceType = CL_DEVICE_TYPE_GPU;
+
+        if( vm.count( "cpu" ) )
+            deviceType = CL_DEVICE_TYPE_CPU;
+
+        if( vm.count( "all" ) )
+            deviceType = CL_DEVICE_TYPE_ALL;
+
+        if( vm.count( "retune" ) )
+            retune = true;
+    }
+    catch( std::exception& e )
+    {
+        std::cerr << "bolt-tune error condition reported:" << std::endl << e.what( ) << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector< cl::Platform > platforms;
+        bolt::cl::V_OPENCL( cl::Platform::get( &platforms ), "Platform::get() failed" );
+
+        std::vector< cl::Device > devices;
+        bolt::cl::V_OPENCL( platforms.at( userPlatform ).getDevices( deviceType, &devices ),
+            "Platform::getDevices() failed" );
+
+        cl::Context myContext( devices.at( userDevice ) );
+        cl::CommandQueue myQueue( myContext, devices.at( userDevice ) );
+
+        bolt::cl::control ctl( myQueue );
+        ctl.setForceRunMode( bolt::cl::control::OpenCL );
+        ctl.setAutoTune( bolt::cl::control::AutoTuneWorkShape );
+
+        std::cout << "Device under test : " << devices.at( userDevice ).getInfo< CL_DEVICE_NAME >( ) << std::endl;
+
+        //  Entries already in the file are kept, and value sizes tuned by an earlier run are not swept again
+        if( !retune )
+            bolt::cl::loadTuningDatabase( databaseFile );
+
+        tuneType< cl_char >( ctl, length, "cl_char" );
+        tuneType< cl_short >( ctl, length, "cl_short" );
+        tuneType< cl_int >( ctl, length, "cl_int" );
+        tuneType< cl_long >( ctl, length, "cl_long" );
+
+        //  Without -r the models already in the file, of this device or others, are refined with the new times
+        bolt::cl::resetDispatchModel( );
+        if( !retune )
+            bolt::cl::loadDispatchModel( modelFile );
+
+        calibrateType< cl_int >( ctl, length, "cl_int" );
+        calibrateType< cl_float >( ctl, length, "cl_float" );
+    }
+    catch( ::cl::Error& e )
+    {
+        std::cerr << "bolt-tune OpenCL error: " << e.what( ) << " (" << e.err( ) << ")" << std::endl;
+        return 1;
+    }
+    catch( std::exception& e )
+    {
+        std::cerr << "bolt-tune error condition reported:" << std::endl << e.what( ) << std::endl;
+        return 1;
+    }
+
+    if( !bolt::cl::saveTuningDatabase( databaseFile ) )
+    {
+        std::cerr << "Could not write the tuning database to " << databaseFile << std::endl;
+        return 1;
+    }
+
+    std::cout << "Tuning database written to " << databaseFile << std::endl;
+
+    if( !bolt::cl::saveDispatchModel( modelFile ) )
+    {
+        std::cerr << "Could not write the dispatch model to " << modelFile << std::endl;
+        return 1;
+    }
+
+    std::cout << "Dispatch model written to " << modelFile << std::endl;
+    return 0;
+}